@@ -0,0 +1,20 @@
+#pragma once
+
+/**
+ * Enumeration describing the order in which the contents of a mapped file are read, which the operating system uses
+ * to decide how far ahead of each read to page the file in
+ * @author Nathaniel Rex
+ */
+enum class AccessPattern
+{
+
+	/**
+	 * Contents are read front to back, so the operating system reads ahead aggressively
+	 */
+	SEQUENTIAL,
+
+	/**
+	 * Contents are read in no particular order, so the operating system pages in only what is read
+	 */
+	RANDOM
+};
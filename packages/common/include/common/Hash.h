@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * Offset basis of the 64-bit FNV-1a hash, which incremental hashes start from
+ */
+extern const unsigned long long FNV_OFFSET_BASIS;
+
+/**
+ * Folds a block of bytes into a 64-bit FNV-1a hash. Suited to hashing small keys incrementally, one field at a time.
+ * @param hash Hash to fold the bytes into, starting from FNV_OFFSET_BASIS
+ * @param data Data to hash
+ * @param size Size of the data, in bytes
+ */
+void hashBytes(unsigned long long& hash, const void* data, size_t size);
+
+/**
+ * Computes a 64-bit hash of a block of data, such as the checksum used to detect corrupt files or the key of cached
+ * data. Four independent lanes of 64-bit words are hashed in parallel, so large blocks are hashed close to memory
+ * bandwidth.
+ * @param data Data to hash
+ * @param size Size of the data, in bytes
+ * @return A 64-bit hash of the data
+ */
+unsigned long long checksum(const void* data, size_t size);
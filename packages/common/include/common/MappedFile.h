@@ -0,0 +1,83 @@
+#pragma once
+#include <common/AccessPattern.h>
+#include <cstddef>
+#include <string>
+
+/**
+ * A read-only view of a file mapped into memory. The operating system pages the contents in on demand, so large files
+ * can be parsed in place without being copied into an intermediate buffer. The mapping is released on destruction.
+ * @author Nathaniel Rex
+ */
+class MappedFile
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param path Absolute path to the file to map
+	 * @param accessPattern (Optional) The order in which the contents will be read. Defaults to sequential.
+	 * @throws InstantiationException If the file could not be opened or mapped
+	 */
+	MappedFile(const std::string& path, AccessPattern accessPattern = AccessPattern::SEQUENTIAL);
+
+	/**
+	 * Constructor
+	 * @param file Mapped file to copy from
+	 */
+	MappedFile(const MappedFile& file) = delete;
+
+	/**
+	 * Destructor
+	 */
+	~MappedFile();
+
+	/**
+	 * Assignment operator
+	 * @param file Mapped file to assign from
+	 */
+	MappedFile& operator=(const MappedFile& file) = delete;
+
+	/**
+	 * @return The contents of the file. Is null if the file is empty.
+	 */
+	const char* data() const;
+
+	/**
+	 * @return The size of the file, in bytes
+	 */
+	size_t size() const;
+
+	/**
+	 * @return The order in which the contents are expected to be read
+	 */
+	AccessPattern getAccessPattern() const;
+
+private:
+
+	/**
+	 * Start of the mapped contents
+	 */
+	const char* _data;
+
+	/**
+	 * Size of the mapped contents, in bytes
+	 */
+	size_t _size;
+
+	/**
+	 * The order in which the contents are expected to be read
+	 */
+	AccessPattern _accessPattern;
+
+#ifdef _WIN32
+	/**
+	 * Handle of the open file
+	 */
+	void* _file;
+
+	/**
+	 * Handle of the file mapping object
+	 */
+	void* _mapping;
+#endif
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @return The number of threads the hardware can run concurrently, or 1 if it cannot be determined
+ */
+inline unsigned int getHardwareConcurrency()
+{
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	return numThreads > 0 ? numThreads : 1;
+}
+
+/**
+ * Invokes a function once for every index of a range, spreading the calls across worker threads. Indices are handed
+ * out one at a time, so tasks of uneven cost are balanced between threads. The calling thread takes part in the work,
+ * and the call returns once every index has been processed.
+ * @param <Function> Callable taking the index as its only argument
+ * @param count The number of indices, starting at 0
+ * @param numThreads The maximum number of threads to use, including the calling thread. Uses as many threads as the
+ * hardware can run concurrently when 0.
+ * @param func Function to invoke for every index
+ * @throws Rethrows the first exception thrown by any invocation, after all threads have finished. Indices not yet
+ * started when the exception was thrown are skipped.
+ */
+template <typename Function>
+void parallelFor(unsigned int count, unsigned int numThreads, const Function& func)
+{
+	if (numThreads == 0)
+	{
+		numThreads = getHardwareConcurrency();
+	}
+	numThreads = numThreads < count ? numThreads : count;
+
+	std::atomic<unsigned int> next(0);
+	std::atomic<bool> failed(false);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	auto work = [&]()
+	{
+		for (unsigned int i = next++; i < count && !failed; i = next++)
+		{
+			try
+			{
+				func(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+				failed = true;
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < numThreads; i++)
+	{
+		workers.emplace_back(work);
+	}
+	work();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
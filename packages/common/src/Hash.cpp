@@ -0,0 +1,73 @@
+#include <common/Hash.h>
+#include <cstdint>
+#include <cstring>
+
+const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+namespace
+{
+	const unsigned long long FNV_PRIME = 1099511628211ull;
+
+	const uint64_t PRIME_1 = 11400714785074694791ull;
+	const uint64_t PRIME_2 = 14029467366897019727ull;
+	const uint64_t PRIME_3 = 1609587929392839161ull;
+
+	uint64_t rotateLeft(uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	uint64_t mixWord(uint64_t hash, uint64_t word)
+	{
+		hash += word * PRIME_2;
+		hash = rotateLeft(hash, 31);
+		return hash * PRIME_1;
+	}
+}
+
+void hashBytes(unsigned long long& hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+}
+
+unsigned long long checksum(const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t lanes[4] = { PRIME_1 + PRIME_2, PRIME_2, 0, 0 - PRIME_1 };
+
+	// Hash blocks of 32 bytes, one word per lane
+	size_t numBlocks = size / 32;
+	for (size_t i = 0; i < numBlocks; i++, bytes += 32)
+	{
+		uint64_t words[4];
+		std::memcpy(words, bytes, 32);
+		lanes[0] = mixWord(lanes[0], words[0]);
+		lanes[1] = mixWord(lanes[1], words[1]);
+		lanes[2] = mixWord(lanes[2], words[2]);
+		lanes[3] = mixWord(lanes[3], words[3]);
+	}
+
+	uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) +
+		rotateLeft(lanes[3], 18);
+	hash += size;
+
+	// Fold in the remaining bytes
+	size_t remaining = size % 32;
+	for (size_t i = 0; i < remaining; i++)
+	{
+		hash = (hash ^ bytes[i]) * PRIME_1;
+	}
+
+	// Final avalanche, so that every input bit affects every output bit
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+	return hash;
+}
@@ -0,0 +1,128 @@
+#include <common/MappedFile.h>
+#include <common/exceptions/InstantiationException.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path, AccessPattern accessPattern) : _data(nullptr), _size(0),
+	_accessPattern(accessPattern), _file(INVALID_HANDLE_VALUE), _mapping(nullptr)
+{
+	DWORD flags = accessPattern == AccessPattern::RANDOM ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+	_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | flags, NULL);
+	if (_file == INVALID_HANDLE_VALUE)
+	{
+		throw InstantiationException("Failed to open file " + path);
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(_file, &size))
+	{
+		CloseHandle(_file);
+		throw InstantiationException("Failed to read size of file " + path);
+	}
+
+	_size = (size_t) size.QuadPart;
+	if (_size == 0)
+	{
+		return;
+	}
+
+	_mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (_mapping != nullptr)
+	{
+		_data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+
+	if (_data == nullptr)
+	{
+		if (_mapping != nullptr)
+		{
+			CloseHandle(_mapping);
+		}
+		CloseHandle(_file);
+		throw InstantiationException("Failed to map file " + path);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (_data != nullptr)
+	{
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping != nullptr)
+	{
+		CloseHandle(_mapping);
+	}
+	CloseHandle(_file);
+}
+#else
+MappedFile::MappedFile(const std::string& path, AccessPattern accessPattern) : _data(nullptr), _size(0),
+	_accessPattern(accessPattern)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		throw InstantiationException("Failed to open file " + path);
+	}
+
+	struct stat status;
+	if (fstat(fd, &status) == -1)
+	{
+		close(fd);
+		throw InstantiationException("Failed to read size of file " + path);
+	}
+
+	_size = (size_t) status.st_size;
+	if (_size == 0)
+	{
+		close(fd);
+		return;
+	}
+
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping keeps its own reference to the file
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		throw InstantiationException("Failed to map file " + path);
+	}
+
+	// Let the kernel read ahead aggressively when contents are parsed front to back, and not at all when they are
+	// read at random, where reading ahead would evict pages still in use
+	madvise(data, _size, accessPattern == AccessPattern::RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+	_data = static_cast<const char*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+	if (_data != nullptr)
+	{
+		munmap(const_cast<char*>(_data), _size);
+	}
+}
+#endif
+
+const char* MappedFile::data() const
+{
+	return _data;
+}
+
+size_t MappedFile::size() const
+{
+	return _size;
+}
+
+AccessPattern MappedFile::getAccessPattern() const
+{
+	return _accessPattern;
+}
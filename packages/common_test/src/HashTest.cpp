@@ -0,0 +1,49 @@
+#include <boost/test/unit_test.hpp>
+#include <common/Hash.h>
+#include <vector>
+
+/**
+ * Tests that incremental hashes depend on every byte and on the order bytes are folded in
+ */
+BOOST_AUTO_TEST_CASE(Hash_hashBytes)
+{
+	unsigned long long empty = FNV_OFFSET_BASIS;
+	hashBytes(empty, nullptr, 0);
+	BOOST_TEST(empty == FNV_OFFSET_BASIS);
+
+	// Known FNV-1a value of "a"
+	unsigned long long hash = FNV_OFFSET_BASIS;
+	hashBytes(hash, "a", 1);
+	BOOST_TEST(hash == 0xaf63dc4c8601ec8cull);
+
+	unsigned long long ab = FNV_OFFSET_BASIS;
+	hashBytes(ab, "a", 1);
+	hashBytes(ab, "b", 1);
+	unsigned long long ba = FNV_OFFSET_BASIS;
+	hashBytes(ba, "b", 1);
+	hashBytes(ba, "a", 1);
+	BOOST_TEST(ab != ba);
+}
+
+/**
+ * Tests that the checksum depends on every byte
+ */
+BOOST_AUTO_TEST_CASE(Hash_checksum)
+{
+	std::vector<unsigned char> data(100);
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		data[i] = (unsigned char) (i * 37);
+	}
+
+	unsigned long long hash = checksum(data.data(), data.size());
+	BOOST_TEST(checksum(data.data(), data.size()) == hash);
+	BOOST_TEST(checksum(data.data(), data.size() - 1) != hash);
+
+	for (size_t i : { 0, 31, 32, 99 })
+	{
+		data[i] ^= 0x80;
+		BOOST_TEST(checksum(data.data(), data.size()) != hash);
+		data[i] ^= 0x80;
+	}
+}
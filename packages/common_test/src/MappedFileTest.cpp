@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+#include <common/MappedFile.h>
+#include <common/exceptions/InstantiationException.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * Tests mapping the contents of a file into memory
+ */
+BOOST_AUTO_TEST_CASE(MappedFile_basics)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "MappedFileTest.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "mapped contents";
+    }
+
+    {
+        MappedFile file(path.string());
+        BOOST_TEST(file.size() == 15);
+        BOOST_TEST(std::memcmp(file.data(), "mapped contents", 15) == 0);
+        BOOST_TEST((file.getAccessPattern() == AccessPattern::SEQUENTIAL));
+    }
+
+    // Files read at random map the same contents
+    {
+        MappedFile file(path.string(), AccessPattern::RANDOM);
+        BOOST_TEST(file.size() == 15);
+        BOOST_TEST(std::memcmp(file.data(), "mapped contents", 15) == 0);
+        BOOST_TEST((file.getAccessPattern() == AccessPattern::RANDOM));
+    }
+
+    // Empty files map to no data
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    }
+    {
+        MappedFile file(path.string());
+        BOOST_TEST(file.size() == 0);
+        BOOST_TEST(file.data() == nullptr);
+    }
+
+    std::filesystem::remove(path);
+    BOOST_REQUIRE_THROW(MappedFile file(path.string()), InstantiationException);
+}
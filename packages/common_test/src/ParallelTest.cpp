@@ -0,0 +1,42 @@
+#include <boost/test/unit_test.hpp>
+#include <common/Parallel.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Tests that every index is processed exactly once
+ */
+BOOST_AUTO_TEST_CASE(Parallel_parallelFor)
+{
+    std::vector<std::atomic<int>> visits(1000);
+    parallelFor(1000, 4, [&visits](unsigned int i)
+    {
+        visits[i]++;
+    });
+
+    bool once = true;
+    for (const std::atomic<int>& count : visits)
+    {
+        once = once && count == 1;
+    }
+    BOOST_TEST(once);
+
+    // Empty ranges and the default thread count are supported
+    BOOST_REQUIRE_NO_THROW(parallelFor(0, 0, [](unsigned int) {}));
+    BOOST_TEST(getHardwareConcurrency() >= 1);
+}
+
+/**
+ * Tests that exceptions thrown by workers reach the calling thread
+ */
+BOOST_AUTO_TEST_CASE(Parallel_exceptions)
+{
+    BOOST_REQUIRE_THROW(parallelFor(100, 4, [](unsigned int i)
+    {
+        if (i == 42)
+        {
+            throw IllegalArgumentException("Failed");
+        }
+    }), IllegalArgumentException);
+}
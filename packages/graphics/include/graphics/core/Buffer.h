@@ -1,15 +1,29 @@
 #pragma once
+#include <graphics/core/GeometryAllocation.h>
+#include <graphics/core/BufferUsage.h>
 
 class GeometryAttributes;
 
 /**
- * A buffer capable of being loaded with vertex array data to be sent to the GPU
+ * A buffer capable of being loaded with vertex array data to be sent to the GPU. The data is sub-allocated from the
+ * shared buffers of the GeometryArena, so buffers must be drawn using their base vertex and index offset.
  * @author Nathaniel Rex
  */
 class Buffer
 {
 public:
 
+	/**
+	 * The number of regions stream buffers rotate through, so that the GPU can read up to two previous frames
+	 * while the next is written
+	 */
+	static const unsigned int NUM_STREAM_REGIONS = 3;
+
+	/**
+	 * The maximum number of vertices for which indices are stored as 16-bit values
+	 */
+	static const unsigned int MAX_SHORT_INDEX_VERTICES = 65536;
+
 	/**
 	 * The number of indices held inside this buffer
 	 */
@@ -22,34 +36,121 @@ public:
 	 * @param numValues The number of values in the vertex data array
 	 * @param indices Array containing the vertex indices of this buffer
 	 * @param numIndices The number of indices
+	 * @param usage Expected update frequency of the vertex data
 	 */
 	Buffer(const GeometryAttributes& attributes, const float* vertexData, unsigned int numValues,
-		const unsigned int* indices, unsigned int numIndices);
+		const unsigned int* indices, unsigned int numIndices, BufferUsage usage = BufferUsage::STATIC);
 
 	/**
 	 * Destructor
 	 */
 	~Buffer();
 
+	/**
+	 * Constructor
+	 * @param other Buffer to copy from
+	 */
+	Buffer(const Buffer& other) = delete;
+
+	/**
+	 * @return Expected update frequency of the vertex data
+	 */
+	BufferUsage getUsage() const;
+
+	/**
+	 * @return The number of vertices held inside this buffer
+	 */
+	unsigned int getNumVertices() const;
+
+	/**
+	 * Overwrites a range of vertices without reallocating the buffer. Stream buffers must be updated in full, and
+	 * write each update to the next of their regions, waiting only if the GPU is still reading that region.
+	 * @param vertexData Interleaved vertex data for the range
+	 * @param firstVertex Position of the first vertex to overwrite
+	 * @param numVertices The number of vertices to overwrite
+	 * @throws OutOfBoundsException If the range lies outside of the buffer
+	 * @throws IllegalArgumentException If a stream buffer is only partially updated
+	 */
+	void updateVertices(const float* vertexData, unsigned int firstVertex, unsigned int numVertices);
+
+	/**
+	 * Overwrites a range of indices without reallocating the buffer
+	 * @param indices Vertex indices for the range
+	 * @param firstIndex Position of the first index to overwrite
+	 * @param numIndices The number of indices to overwrite
+	 * @throws OutOfBoundsException If the range lies outside of the buffer
+	 */
+	void updateIndices(const unsigned int* indices, unsigned int firstIndex, unsigned int numIndices);
+
+	/**
+	 * Marks the point in the GL command stream after which the current region of a stream buffer is no longer read.
+	 * Should be called after every draw call using this buffer. Does nothing for other buffers.
+	 */
+	void fence();
+
 	/**
 	 * Binds this buffer for drawing
 	 */
 	void bind() const;
 
+	/**
+	 * @return The position of the first vertex of this buffer within the shared vertex buffer, to be used as the
+	 * base vertex when drawing
+	 */
+	int getBaseVertex() const;
+
+	/**
+	 * @return The position of the first index of this buffer within the shared index buffer
+	 */
+	unsigned int getIndexOffset() const;
+
+	/**
+	 * @return The byte offset of the first index of this buffer within the shared index buffer, to be passed to draw
+	 * calls
+	 */
+	const void* getIndexPointer() const;
+
+	/**
+	 * @return The GL type of the indices of this buffer (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT), to be passed to draw
+	 * calls
+	 */
+	unsigned int getIndexType() const;
+
+	/**
+	 * @return The size of a single index of this buffer, in bytes
+	 */
+	unsigned int getIndexSize() const;
+
 private:
 
 	/**
-	 * ID of the GLFW vertex buffer object (VBO) that holds the vertex data for this buffer.
+	 * Range of the shared geometry buffers held by this buffer
+	 */
+	GeometryAllocation _allocation;
+
+	/**
+	 * Expected update frequency of the vertex data
+	 */
+	BufferUsage _usage;
+
+	/**
+	 * The number of vertices held inside this buffer (per region, for stream buffers)
+	 */
+	unsigned int _numVertices;
+
+	/**
+	 * Boolean flag that, when true, indicates that indices are stored as 16-bit values
 	 */
-	unsigned int _vboId = 0;
+	bool _shortIndices;
 
 	/**
-	 * ID of the GLFW element buffer object (EBO) that holds the index data for this buffer.
+	 * Region of a stream buffer holding the most recent vertex data
 	 */
-	unsigned int _eboId = 0;
+	unsigned int _region = 0;
 
 	/**
-	 * ID of the GLFW vertex array object (VAO) used to bind and unbind this buffer for rendering.
+	 * GL sync objects marking when the GPU has finished reading each region of a stream buffer. Stored as opaque
+	 * pointers to keep GL types out of this header.
 	 */
-	unsigned int _vaoId = 0;
+	void* _fences[NUM_STREAM_REGIONS] = {};
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * Enumeration describing how often the vertex data of a buffer is expected to change
+ * @author Nathaniel Rex
+ */
+enum class BufferUsage
+{
+
+	/**
+	 * Vertex data is uploaded once and rarely, if ever, modified
+	 */
+	STATIC,
+
+	/**
+	 * Vertex data is modified occasionally, often in small ranges. Updates are written in place.
+	 */
+	DYNAMIC,
+
+	/**
+	 * Vertex data is rewritten every frame, such as for CPU-deformed meshes. Updates rotate through several regions
+	 * of the buffer so that writing a new frame never waits on the GPU to finish reading a previous one.
+	 */
+	STREAM
+};
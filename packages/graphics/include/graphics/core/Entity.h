@@ -148,6 +148,17 @@ public:
 	 */
 	unsigned int getNumberOfChildren() const;
 
+	/**
+	 * @return The children of this entity
+	 */
+	const std::vector<EntityPtr>& getChildren() const;
+
+	/**
+	 * @return A counter that is incremented every time the transformation or the set of children of this entity
+	 * changes. Can be used to detect when data derived from this entity is out-of-date.
+	 */
+	unsigned int getVersion() const;
+
 	/**
 	 * Adds a child to this entity.
 	 * @param child The child entity
@@ -189,6 +200,11 @@ protected:
 	 */
 	bool _transformNeedsUpdate = true;
 
+	/**
+	 * Counter incremented every time the transformation or the set of children of this entity changes
+	 */
+	unsigned int _version = 0;
+
 	/**
 	 * Parent entity. Is null by default.
 	 */
@@ -1,5 +1,6 @@
 #pragma once
 #include <graphics/core/pointers/EntityGroupPtr.h>
+#include <graphics/core/pointers/StaticBatchPtr.h>
 #include <graphics/core/Entity.h>
 
 /**
@@ -15,10 +16,47 @@ public:
 	 */
 	static EntityGroupPtr create();
 
+	/**
+	 * @return True if this group has been marked as static. Returns false otherwise.
+	 */
+	bool isStatic() const;
+
+	/**
+	 * Marks this group as static (or dynamic). The meshes within a static group are merged by the renderer into a
+	 * small number of combined buffers, drastically reducing the number of draw calls. The merged buffers are
+	 * rebuilt automatically whenever a mesh within the group changes, so static groups should be reserved for
+	 * content that rarely moves.
+	 * @param isStatic True if this group should be marked as static. False otherwise.
+	 */
+	void setStatic(bool isStatic);
+
+	/**
+	 * @return The merged buffers built for the meshes of this group. Is null if this group is not static, or if it
+	 * has not yet been rendered or batched via the StaticBatcher.
+	 */
+	StaticBatchPtr getStaticBatch() const;
+
+	/**
+	 * Sets the merged buffers built for the meshes of this group. This method should typically only be called by
+	 * the StaticBatcher.
+	 * @param batch The merged buffers
+	 */
+	void setStaticBatch(StaticBatchPtr batch);
+
 protected:
 
+	/**
+	 * Boolean flag that, when true, indicates that this group is static
+	 */
+	bool _static = false;
+
+	/**
+	 * The merged buffers built for the meshes of this group. Can be null.
+	 */
+	StaticBatchPtr _batch = nullptr;
+
 	/**
 	 * Constructor
 	 */
 	EntityGroup();
-};
\ No newline at end of file
+};
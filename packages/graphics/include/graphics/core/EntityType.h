@@ -23,6 +23,17 @@ enum class EntityType
 	 */
 	MESH,
 
+	/**
+	 * A mesh entity that draws a single geometry and material many times, at per-instance transformations
+	 */
+	INSTANCED_MESH,
+
+	/**
+	 * A mesh entity whose geometry is paged in and out of GPU memory in clusters, for meshes too large to be held
+	 * in memory at once
+	 */
+	STREAMED_MESH,
+
 	/**
 	 * A light, which takes up no physical space, but affects the shading of other entities
 	 */
@@ -0,0 +1,88 @@
+#pragma once
+#include <map>
+
+/**
+ * Manages the free space within a linear address range (such as a GPU buffer), handing out contiguous blocks using
+ * best-fit allocation. Freed blocks are coalesced with their free neighbors to limit fragmentation. The allocator
+ * performs bookkeeping only, and never touches the memory it describes.
+ * @author Nathaniel Rex
+ */
+class FreeListAllocator
+{
+public:
+
+	/**
+	 * Offset returned when an allocation cannot be satisfied
+	 */
+	static const unsigned int INVALID_OFFSET;
+
+	/**
+	 * Constructor
+	 * @param capacity Total size of the address range
+	 */
+	FreeListAllocator(unsigned int capacity);
+
+	/**
+	 * @return Total size of the address range
+	 */
+	unsigned int getCapacity() const;
+
+	/**
+	 * @return The amount of space currently allocated
+	 */
+	unsigned int getUsed() const;
+
+	/**
+	 * @return The number of separate free blocks. A value greater than one indicates fragmentation.
+	 */
+	unsigned int getNumFreeBlocks() const;
+
+	/**
+	 * @return The size of the largest free block, which is the largest allocation that can currently be satisfied
+	 */
+	unsigned int getLargestFreeBlock() const;
+
+	/**
+	 * Allocates a contiguous block, using the smallest free block that can hold it
+	 * @param size Size of the block
+	 * @return The offset of the block, or INVALID_OFFSET if no free block is large enough
+	 */
+	unsigned int allocate(unsigned int size);
+
+	/**
+	 * Returns a previously allocated block to the free list
+	 * @param offset Offset of the block
+	 * @param size Size of the block
+	 * @throws IllegalArgumentException If the block lies outside the address range or overlaps free space
+	 */
+	void free(unsigned int offset, unsigned int size);
+
+	/**
+	 * Extends the address range. The new space is appended to the end of the range.
+	 * @param capacity New total size of the address range
+	 * @throws IllegalArgumentException If the new capacity is smaller than the current capacity
+	 */
+	void grow(unsigned int capacity);
+
+	/**
+	 * Marks the entire address range as free
+	 */
+	void reset();
+
+private:
+
+	/**
+	 * Total size of the address range
+	 */
+	unsigned int _capacity;
+
+	/**
+	 * The amount of space currently allocated
+	 */
+	unsigned int _used = 0;
+
+	/**
+	 * Free blocks, mapping from offset to size
+	 */
+	std::map<unsigned int, unsigned int> _free;
+};
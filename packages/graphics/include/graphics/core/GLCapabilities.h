@@ -0,0 +1,88 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+/**
+ * Capabilities of the current GL context. Extensions are enumerated once, when first queried, rather than on every
+ * query, and are enumerated again after a reset.
+ * @author Nathaniel Rex
+ */
+class GLCapabilities
+{
+public:
+
+	/**
+	 * Destructor
+	 */
+	~GLCapabilities();
+
+	/**
+	 * @param name Name of the extension
+	 * @return True if the current GL context exposes the given extension. Returns false otherwise.
+	 */
+	static bool hasExtension(const std::string& name);
+
+	/**
+	 * @param major Major version number
+	 * @param minor Minor version number
+	 * @return True if the version of the current GL context is at least the given version. Returns false otherwise.
+	 */
+	static bool hasVersion(int major, int minor);
+
+	/**
+	 * Discards the capabilities queried so far, so that they are queried again from the current GL context. Must be
+	 * called whenever another GL context is made current.
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * Global capabilities instance
+	 */
+	static std::unique_ptr<GLCapabilities> _INSTANCE;
+
+	/**
+	 * Names of the extensions exposed by the GL context
+	 */
+	std::unordered_set<std::string> _extensions;
+
+	/**
+	 * Major version of the GL context
+	 */
+	int _major = 0;
+
+	/**
+	 * Minor version of the GL context
+	 */
+	int _minor = 0;
+
+	/**
+	 * Constructor, querying the capabilities of the current GL context
+	 */
+	GLCapabilities();
+
+	/**
+	 * Constructor
+	 * @param capabilities Capabilities to copy from
+	 */
+	GLCapabilities(const GLCapabilities& capabilities) = delete;
+
+	/**
+	 * Constructor
+	 * @param capabilities Capabilities to copy from
+	 */
+	GLCapabilities(GLCapabilities&& capabilities) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param capabilities Capabilities to assign from
+	 */
+	GLCapabilities& operator=(const GLCapabilities& capabilities) = delete;
+
+	/**
+	 * @return The global GLCapabilities instance
+	 */
+	static GLCapabilities* getInstance();
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+class GeometryPool;
+
+/**
+ * Describes the range of a shared vertex and index buffer held by a single buffer. Allocations are kept up-to-date
+ * by the owning pool as it grows or is defragmented.
+ * @author Nathaniel Rex
+ */
+struct GeometryAllocation {
+
+	/**
+	 * Pool the range was allocated from. Is null if the allocation has been released, or if the pool was destroyed.
+	 */
+	GeometryPool* pool = nullptr;
+
+	/**
+	 * Position of the first vertex within the shared vertex buffer, passed as the base vertex when drawing
+	 */
+	unsigned int vertexOffset = 0;
+
+	/**
+	 * The number of vertices in the range
+	 */
+	unsigned int numVertices = 0;
+
+	/**
+	 * Position of the first index within the shared index buffer
+	 */
+	unsigned int indexOffset = 0;
+
+	/**
+	 * The number of indices in the range
+	 */
+	unsigned int numIndices = 0;
+};
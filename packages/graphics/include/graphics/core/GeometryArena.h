@@ -0,0 +1,163 @@
+#pragma once
+#include <graphics/core/BufferUsage.h>
+#include <memory>
+#include <unordered_map>
+
+class GeometryAttributes;
+class GeometryPool;
+struct GeometryAllocation;
+
+/**
+ * Statistics describing the memory held by the geometry arena
+ * @author Nathaniel Rex
+ */
+struct GeometryArenaStats {
+
+	/**
+	 * The number of pools (one per unique combination of vertex layout, usage and index size)
+	 */
+	unsigned int numPools = 0;
+
+	/**
+	 * The number of live allocations across all pools
+	 */
+	unsigned int numAllocations = 0;
+
+	/**
+	 * The number of free blocks across all pools. Higher values indicate fragmentation.
+	 */
+	unsigned int numFreeBlocks = 0;
+
+	/**
+	 * Total size of all vertex buffers, in bytes
+	 */
+	unsigned long long vertexBytes = 0;
+
+	/**
+	 * Size of all allocated vertex ranges, in bytes
+	 */
+	unsigned long long vertexBytesUsed = 0;
+
+	/**
+	 * Total size of all index buffers, in bytes
+	 */
+	unsigned long long indexBytes = 0;
+
+	/**
+	 * Size of all allocated index ranges, in bytes
+	 */
+	unsigned long long indexBytesUsed = 0;
+};
+
+
+/**
+ * The geometry arena is a singleton that sub-allocates the vertex and index data of all buffers from a small number
+ * of large, shared GPU buffers, with one pool per vertex layout and usage. This avoids creating separate GL objects for every
+ * geometry, and allows geometry sharing a layout to be drawn without switching vertex array objects.
+ * @author Nathaniel Rex
+ */
+class GeometryArena
+{
+public:
+
+	/**
+	 * The number of vertices a pool can hold when first created
+	 */
+	static const unsigned int DEFAULT_VERTEX_CAPACITY;
+
+	/**
+	 * The number of indices a pool can hold when first created
+	 */
+	static const unsigned int DEFAULT_INDEX_CAPACITY;
+
+	/**
+	 * Destructor
+	 */
+	~GeometryArena();
+
+	/**
+	 * Allocates and uploads a range of vertices and indices from the pool matching the given vertex attributes
+	 * and usage
+	 * @param allocation Allocation to populate. Must remain at the same address until it is released.
+	 * @param attributes Vertex attributes
+	 * @param vertexData Interleaved float vertex data, converted to the storage formats of the attributes on upload
+	 * @param numValues The number of values in the vertex data array
+	 * @param indices Vertex indices
+	 * @param numIndices The number of indices
+	 * @param usage Expected update frequency
+	 * @param numRegions The number of copies of the vertex range to reserve. Only the first is initialized.
+	 * @param shortIndices True if indices should be stored as 16-bit values. All indices must be less than 65536.
+	 */
+	static void allocate(GeometryAllocation* allocation, const GeometryAttributes& attributes, const float* vertexData,
+		unsigned int numValues, const unsigned int* indices, unsigned int numIndices,
+		BufferUsage usage = BufferUsage::STATIC, unsigned int numRegions = 1, bool shortIndices = false);
+
+	/**
+	 * Releases a previously allocated range. Does nothing if the allocation's pool no longer exists.
+	 * @param allocation Allocation to release
+	 */
+	static void release(GeometryAllocation* allocation);
+
+	/**
+	 * Compacts the live ranges of every pool. Should be called between frames, such as after unloading a level.
+	 */
+	static void defragment();
+
+	/**
+	 * @return Statistics describing the memory held by the arena
+	 */
+	static GeometryArenaStats getStats();
+
+	/**
+	 * Resets the global geometry arena instance to its initial state, prior to graphics initialization
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * Global geometry arena instance
+	 */
+	static std::unique_ptr<GeometryArena> _INSTANCE;
+
+	/**
+	 * Mapping from pool keys to pools
+	 */
+	std::unordered_map<int, std::unique_ptr<GeometryPool>> _pools;
+
+	/**
+	 * Constructor
+	 */
+	GeometryArena();
+
+	/**
+	 * Constructor
+	 * @param arena Geometry arena to copy from
+	 */
+	GeometryArena(const GeometryArena& arena) = delete;
+
+	/**
+	 * Constructor
+	 * @param arena Geometry arena to copy from
+	 */
+	GeometryArena(GeometryArena&& arena) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param arena Geometry arena to assign from
+	 */
+	GeometryArena& operator=(const GeometryArena& arena) = delete;
+
+	/**
+	 * @return The global GeometryArena instance
+	 */
+	static GeometryArena* getInstance();
+
+	/**
+	 * @param attributes Vertex attributes
+	 * @param usage Expected update frequency
+	 * @param shortIndices True if indices are stored as 16-bit values
+	 * @return A key uniquely identifying the pool for the vertex layout, usage and index size
+	 */
+	static int getPoolKey(const GeometryAttributes& attributes, BufferUsage usage, bool shortIndices);
+};
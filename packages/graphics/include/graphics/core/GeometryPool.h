@@ -0,0 +1,229 @@
+#pragma once
+#include <graphics/core/FreeListAllocator.h>
+#include <graphics/core/BufferUsage.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <unordered_set>
+
+struct GeometryAllocation;
+
+/**
+ * A pair of large vertex and index buffers shared by all geometry with the same vertex attributes and usage. Vertex and index
+ * ranges are sub-allocated from the buffers, which grow on demand. All ranges are drawn through a single vertex
+ * array object (VAO), using the vertex offset of each range as its base vertex. Pools are managed by the
+ * GeometryArena.
+ * @author Nathaniel Rex
+ */
+class GeometryPool
+{
+public:
+
+	/**
+	 * Vertex attributes shared by all geometry in this pool
+	 */
+	const GeometryAttributes attributes;
+
+	/**
+	 * Expected update frequency of all geometry in this pool
+	 */
+	const BufferUsage usage;
+
+	/**
+	 * Boolean flag that, when true, indicates that indices are stored as 16-bit values rather than 32-bit values
+	 */
+	const bool shortIndices;
+
+	/**
+	 * Constructor
+	 * @param attributes Vertex attributes
+	 * @param usage Expected update frequency
+	 * @param shortIndices True if indices should be stored as 16-bit values
+	 * @param vertexCapacity Initial number of vertices the pool can hold
+	 * @param indexCapacity Initial number of indices the pool can hold
+	 */
+	GeometryPool(const GeometryAttributes& attributes, BufferUsage usage, bool shortIndices,
+		unsigned int vertexCapacity, unsigned int indexCapacity);
+
+	/**
+	 * Destructor. Any remaining allocations are detached from the pool.
+	 */
+	~GeometryPool();
+
+	/**
+	 * @return Bookkeeping for the vertex buffer, in units of vertices
+	 */
+	const FreeListAllocator& getVertexAllocator() const;
+
+	/**
+	 * @return Bookkeeping for the index buffer, in units of indices
+	 */
+	const FreeListAllocator& getIndexAllocator() const;
+
+	/**
+	 * @return The number of live allocations
+	 */
+	unsigned int getNumAllocations() const;
+
+	/**
+	 * Allocates and uploads a range of vertices and indices, growing the shared buffers if needed
+	 * @param allocation Allocation to populate. Must remain at the same address until it is released.
+	 * @param vertexData Interleaved float vertex data, converted to the storage formats of the pool on upload
+	 * @param numVertices The number of vertices
+	 * @param indices Vertex indices, relative to the first vertex of the range
+	 * @param numIndices The number of indices
+	 * @param numRegions The number of copies of the vertex range to reserve. Only the first is initialized.
+	 */
+	void allocate(GeometryAllocation* allocation, const float* vertexData, unsigned int numVertices,
+		const unsigned int* indices, unsigned int numIndices, unsigned int numRegions = 1);
+
+	/**
+	 * Overwrites part of an allocated vertex range in place
+	 * @param allocation Allocation to update
+	 * @param vertexData Interleaved vertex data
+	 * @param firstVertex Position of the first vertex to overwrite, relative to the start of the range
+	 * @param numVertices The number of vertices to overwrite
+	 */
+	void updateVertices(const GeometryAllocation* allocation, const float* vertexData, unsigned int firstVertex,
+		unsigned int numVertices);
+
+	/**
+	 * Overwrites part of an allocated index range in place
+	 * @param allocation Allocation to update
+	 * @param indices Vertex indices
+	 * @param firstIndex Position of the first index to overwrite, relative to the start of the range
+	 * @param numIndices The number of indices to overwrite
+	 */
+	void updateIndices(const GeometryAllocation* allocation, const unsigned int* indices, unsigned int firstIndex,
+		unsigned int numIndices);
+
+	/**
+	 * Maps part of an allocated vertex range for writing, without synchronizing with the GPU. The caller is
+	 * responsible for ensuring the GPU is no longer reading the range. Must be followed by a call to unmapVertices.
+	 * @param allocation Allocation to map
+	 * @param firstVertex Position of the first vertex to map, relative to the start of the range
+	 * @param numVertices The number of vertices to map
+	 * @return Pointer to the mapped vertex data, in the storage formats of the pool
+	 */
+	void* mapVertices(const GeometryAllocation* allocation, unsigned int firstVertex, unsigned int numVertices);
+
+	/**
+	 * Unmaps the vertex range previously mapped via mapVertices
+	 */
+	void unmapVertices();
+
+	/**
+	 * Releases a range previously allocated from this pool
+	 * @param allocation Allocation to release
+	 */
+	void release(GeometryAllocation* allocation);
+
+	/**
+	 * Compacts all live ranges to the front of the shared buffers, merging the free space into a single block.
+	 * Allocations are updated in place.
+	 */
+	void defragment();
+
+	/**
+	 * Binds the shared vertex array object for drawing
+	 */
+	void bind() const;
+
+	/**
+	 * @return The size of a single vertex on the GPU, in bytes
+	 */
+	unsigned int getVertexSize() const;
+
+	/**
+	 * @return The size of a single index on the GPU, in bytes
+	 */
+	unsigned int getIndexSize() const;
+
+private:
+
+	/**
+	 * ID of the GLFW vertex buffer object (VBO) shared by all geometry in this pool.
+	 */
+	unsigned int _vboId = 0;
+
+	/**
+	 * ID of the GLFW element buffer object (EBO) shared by all geometry in this pool.
+	 */
+	unsigned int _eboId = 0;
+
+	/**
+	 * ID of the GLFW vertex array object (VAO) shared by all geometry in this pool.
+	 */
+	unsigned int _vaoId = 0;
+
+	/**
+	 * Bookkeeping for the vertex buffer, in units of vertices
+	 */
+	FreeListAllocator _vertices;
+
+	/**
+	 * Bookkeeping for the index buffer, in units of indices
+	 */
+	FreeListAllocator _indices;
+
+	/**
+	 * GL usage hint matching the usage of this pool
+	 */
+	unsigned int _glUsage;
+
+	/**
+	 * Live allocations
+	 */
+	std::unordered_set<GeometryAllocation*> _allocations;
+
+	/**
+	 * Converts vertex data to the storage formats of this pool, and writes it to the vertex buffer
+	 * @param vertexOffset Position of the first vertex to write
+	 * @param vertexData Interleaved float vertex data
+	 * @param numVertices The number of vertices to write
+	 */
+	void writeVertices(unsigned int vertexOffset, const float* vertexData, unsigned int numVertices);
+
+	/**
+	 * Converts indices to the index size of this pool, and writes them to the index buffer
+	 * @param indexOffset Position of the first index to write
+	 * @param indices Vertex indices
+	 * @param numIndices The number of indices to write
+	 */
+	void writeIndices(unsigned int indexOffset, const unsigned int* indices, unsigned int numIndices);
+
+	/**
+	 * Grows the vertex buffer until it has a free block of at least the given number of vertices
+	 * @param numVertices Required number of contiguous vertices
+	 */
+	void growVertices(unsigned int numVertices);
+
+	/**
+	 * Grows the index buffer until it has a free block of at least the given number of indices
+	 * @param numIndices Required number of contiguous indices
+	 */
+	void growIndices(unsigned int numIndices);
+
+	/**
+	 * Replaces a buffer with a larger copy of itself
+	 * @param bufferId ID of the buffer, which is updated to the new buffer
+	 * @param oldSize Size of the existing buffer, in bytes
+	 * @param newSize Size of the new buffer, in bytes
+	 */
+	void resizeBuffer(unsigned int& bufferId, unsigned long long oldSize, unsigned long long newSize) const;
+
+	/**
+	 * Binds the shared buffers to the vertex array object and describes the vertex layout
+	 */
+	void attachBuffers();
+
+	/**
+	 * Describes a single vertex attribute of the bound vertex array object
+	 * @param location Shader input location
+	 * @param numComponents The number of components of the attribute
+	 * @param format Storage format of the attribute
+	 * @param vertexSize The size of a single vertex, in bytes
+	 * @param offset Offset of the attribute within each vertex, in bytes
+	 * @return The number of bytes the attribute occupies within each vertex
+	 */
+	static unsigned int attachAttribute(unsigned int location, int numComponents, AttributeFormat format,
+		int vertexSize, long long offset);
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Buffer;
+class GeometryAttributes;
+
+/**
+ * Statistics describing the buffers shared through the geometry registry
+ * @author Nathaniel Rex
+ */
+struct GeometryRegistryStats {
+
+	/**
+	 * The number of unique buffers currently registered
+	 */
+	unsigned int numBuffers = 0;
+
+	/**
+	 * The number of geometries referencing a registered buffer
+	 */
+	unsigned int numReferences = 0;
+
+	/**
+	 * GPU memory held by the registered buffers, in bytes
+	 */
+	unsigned long long bytesUsed = 0;
+
+	/**
+	 * GPU memory that would have been used by duplicate buffers had they not been shared, in bytes
+	 */
+	unsigned long long bytesSaved = 0;
+};
+
+
+/**
+ * The geometry registry is a singleton that allows geometries with identical content to share a single buffer.
+ * Buffers are identified by a hash of their vertex attributes, vertex data, and indices, and are released once the
+ * last geometry referencing them lets go. A copy of the content of every registered buffer is kept on the CPU, and
+ * buffers are shared only when their content is identical. Registered buffers must never be modified in place.
+ * @author Nathaniel Rex
+ */
+class GeometryRegistry
+{
+public:
+
+	/**
+	 * Destructor
+	 */
+	~GeometryRegistry();
+
+	/**
+	 * Returns the registered buffer holding the given content, creating and registering it if it does not yet exist
+	 * @param attributes Vertex attributes
+	 * @param vertexData Interleaved vertex data
+	 * @param numValues The number of values in the vertex data array
+	 * @param indices Vertex indices
+	 * @param numIndices The number of indices
+	 * @return A static buffer holding the content
+	 */
+	static std::shared_ptr<Buffer> acquire(const GeometryAttributes& attributes, const float* vertexData,
+		unsigned int numValues, const unsigned int* indices, unsigned int numIndices);
+
+	/**
+	 * Computes the hash identifying buffer content
+	 * @param attributes Vertex attributes
+	 * @param vertexData Interleaved vertex data
+	 * @param numValues The number of values in the vertex data array
+	 * @param indices Vertex indices
+	 * @param numIndices The number of indices
+	 * @return A 64-bit hash of the content
+	 */
+	static unsigned long long hash(const GeometryAttributes& attributes, const float* vertexData, unsigned int numValues,
+		const unsigned int* indices, unsigned int numIndices);
+
+	/**
+	 * @return Statistics describing the registered buffers
+	 */
+	static GeometryRegistryStats getStats();
+
+	/**
+	 * Resets the global geometry registry instance to its initial state, prior to graphics initialization.
+	 * Buffers still referenced by geometries remain valid, but are no longer shared with new geometries.
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * A registered buffer
+	 */
+	struct Entry {
+
+		/**
+		 * The registered buffer. Expires once no geometry references it.
+		 */
+		std::weak_ptr<Buffer> buffer;
+
+		/**
+		 * Copy of the content of the buffer, compared against new content whose hash matches so that hash collisions
+		 * never share a buffer
+		 */
+		std::array<int, 6> layout;
+		std::vector<float> vertexData;
+		std::vector<unsigned int> indices;
+
+		/**
+		 * GPU memory held by the buffer, in bytes
+		 */
+		unsigned long long numBytes;
+	};
+
+	/**
+	 * Global geometry registry instance
+	 */
+	static std::unique_ptr<GeometryRegistry> _INSTANCE;
+
+	/**
+	 * Mapping from content hashes to registered buffers
+	 */
+	std::unordered_map<unsigned long long, Entry> _entries;
+
+	/**
+	 * The number of entries at which expired entries are next pruned
+	 */
+	size_t _pruneSize;
+
+	/**
+	 * Constructor
+	 */
+	GeometryRegistry();
+
+	/**
+	 * Constructor
+	 * @param registry Geometry registry to copy from
+	 */
+	GeometryRegistry(const GeometryRegistry& registry) = delete;
+
+	/**
+	 * Constructor
+	 * @param registry Geometry registry to copy from
+	 */
+	GeometryRegistry(GeometryRegistry&& registry) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param registry Geometry registry to assign from
+	 */
+	GeometryRegistry& operator=(const GeometryRegistry& registry) = delete;
+
+	/**
+	 * @return The global GeometryRegistry instance
+	 */
+	static GeometryRegistry* getInstance();
+
+	/**
+	 * Removes the entries of buffers no longer referenced by any geometry
+	 */
+	void prune();
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+struct InstanceData;
+
+/**
+ * A buffer holding per-instance attributes, which are attached to the vertex array of a geometry buffer in order
+ * to draw that geometry many times with a single draw call.
+ * @author Nathaniel Rex
+ */
+class InstanceBuffer
+{
+public:
+
+	/**
+	 * The number of instances that this buffer can hold
+	 */
+	const unsigned int capacity;
+
+	/**
+	 * Constructor
+	 * @param instances Array of per-instance data to initialize this buffer with
+	 * @param count The number of instances in the array. This becomes the capacity of the buffer.
+	 */
+	InstanceBuffer(const InstanceData* instances, unsigned int count);
+
+	/**
+	 * Destructor
+	 */
+	~InstanceBuffer();
+
+	/**
+	 * Re-uploads a contiguous range of instances, leaving the rest of the buffer untouched
+	 * @param instances Array containing the data of all instances
+	 * @param first Index of the first instance to upload
+	 * @param count The number of instances to upload
+	 */
+	void update(const InstanceData* instances, unsigned int first, unsigned int count);
+
+	/**
+	 * Gathers a subset of instances (for example, the ones that survived culling) and uploads them, in order, to
+	 * a secondary streaming buffer. The streaming buffer is orphaned on every call, so that uploads never wait
+	 * for previous draws to complete.
+	 * @param instances Array containing the data of all instances
+	 * @param indices Indices of the instances to upload
+	 * @param count The number of indices
+	 */
+	void stream(const InstanceData* instances, const unsigned int* indices, unsigned int count);
+
+	/**
+	 * Attaches the per-instance attributes of this buffer to the vertex array that is currently bound
+	 * @param streamed True if the instances last uploaded via stream() should be used. False if all instances,
+	 * in their original order, should be used.
+	 */
+	void attach(bool streamed) const;
+
+	/**
+	 * Detaches the per-instance attributes from the vertex array that is currently bound, so that the vertex array
+	 * can be used for non-instanced drawing again
+	 */
+	void detach() const;
+
+private:
+
+	/**
+	 * ID of the GLFW vertex buffer object (VBO) that holds the data of all instances
+	 */
+	unsigned int _vboId = 0;
+
+	/**
+	 * ID of the GLFW vertex buffer object (VBO) that holds the subset of instances last uploaded via stream().
+	 * Will not be created until the first call to stream().
+	 */
+	unsigned int _streamVboId = 0;
+};
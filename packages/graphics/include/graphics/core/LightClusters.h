@@ -0,0 +1,217 @@
+#pragma once
+#include <graphics/cameras/pointers/CameraPtr.h>
+#include <graphics/lights/pointers/PointLightPtr.h>
+#include <vector>
+
+/**
+ * Statistics describing the last build of light clusters
+ * @author Nathaniel Rex
+ */
+struct LightClustersStats {
+
+	/**
+	 * The number of point lights binned
+	 */
+	unsigned int numLights = 0;
+
+	/**
+	 * The number of point lights lying entirely outside of the view frustum
+	 */
+	unsigned int numCulled = 0;
+
+	/**
+	 * The total number of light references across all clusters
+	 */
+	unsigned int numReferences = 0;
+
+	/**
+	 * The largest number of lights referenced by a single cluster
+	 */
+	unsigned int maxLightsPerCluster = 0;
+
+	/**
+	 * Time spent binning lights on the CPU, in milliseconds
+	 */
+	float buildTime = 0.f;
+};
+
+/**
+ * Bins point lights into a 3D grid of clusters (froxels) dividing the view frustum of a camera, for clustered forward
+ * shading. The screen is divided into tiles, and depth into slices spaced exponentially between the near and far
+ * planes, so that clusters stay roughly cubic. Every light is referenced by the clusters its sphere of influence
+ * overlaps, and every fragment only shades the lights of the cluster it falls in.
+ *
+ * Lights are binned on the CPU, spreading depth slices across threads when there are many lights, then uploaded to
+ * three buffer textures: the light data, the offset and count of every cluster into the light index list, and the
+ * light index list itself. Lights without a range reach every cluster. Cameras without a perspective projection use a
+ * single cluster holding every light.
+ * @author Nathaniel Rex
+ */
+class LightClusters
+{
+public:
+
+	/**
+	 * The number of clusters along the width of the screen
+	 */
+	static const unsigned int GRID_X;
+
+	/**
+	 * The number of clusters along the height of the screen
+	 */
+	static const unsigned int GRID_Y;
+
+	/**
+	 * The number of depth slices
+	 */
+	static const unsigned int GRID_Z;
+
+	/**
+	 * The number of lights above which depth slices are binned in parallel
+	 */
+	static const unsigned int PARALLEL_THRESHOLD;
+
+	/**
+	 * Constructor
+	 */
+	LightClusters();
+
+	/**
+	 * Destructor
+	 */
+	~LightClusters();
+
+	/**
+	 * Bins lights into the clusters of a camera. Performs no GL calls.
+	 * @param lights Point lights, in world space
+	 * @param camera Camera
+	 */
+	void build(const std::vector<PointLightPtr>& lights, const CameraPtr camera);
+
+	/**
+	 * Uploads the result of the last build to the buffer textures, orphaning their previous contents
+	 */
+	void upload();
+
+	/**
+	 * Binds the light data, clusters and light indices buffer textures to three consecutive texture units, and
+	 * activates the first texture unit again
+	 * @param unit Index of the first texture unit
+	 */
+	void bind(unsigned int unit) const;
+
+	/**
+	 * @return The number of clusters along the width, height and depth of the view frustum, as an array of 3
+	 * elements. Is 1 x 1 x 1 for cameras without a perspective projection.
+	 */
+	const unsigned int* getDimensions() const;
+
+	/**
+	 * @return The scale and bias mapping the natural logarithm of a view space depth to a depth slice, as an array of
+	 * 2 elements
+	 */
+	const float* getDepthTransform() const;
+
+	/**
+	 * @param x Cluster index along the width of the screen, from left to right
+	 * @param y Cluster index along the height of the screen, from bottom to top
+	 * @param z Depth slice, from near to far
+	 * @return The indices of the lights referenced by the cluster, in ascending order
+	 * @throws OutOfBoundsException If the cluster lies outside of the grid
+	 */
+	std::vector<unsigned int> getLights(unsigned int x, unsigned int y, unsigned int z) const;
+
+	/**
+	 * @return Statistics describing the last build
+	 */
+	const LightClustersStats& getStats() const;
+
+private:
+
+	/**
+	 * A light transformed into view space, along with the depth slices it overlaps
+	 */
+	struct ViewLight {
+		float x;
+		float y;
+		float depth;
+		float range;
+		unsigned int firstSlice;
+		unsigned int lastSlice;
+	};
+
+	/**
+	 * Cluster counts of the last build
+	 */
+	unsigned int _dimensions[3];
+
+	/**
+	 * Depth slice scale and bias of the last build
+	 */
+	float _depthTransform[2];
+
+	/**
+	 * Light data, two RGBA texels per light: position and range, then color and intensity
+	 */
+	std::vector<float> _lightData;
+
+	/**
+	 * Offset into the light index list and number of lights of every cluster, as pairs
+	 */
+	std::vector<unsigned int> _clusters;
+
+	/**
+	 * Indices of the lights referenced by every cluster, concatenated in cluster order
+	 */
+	std::vector<unsigned int> _indices;
+
+	/**
+	 * Lights of the last build, transformed into view space
+	 */
+	std::vector<ViewLight> _viewLights;
+
+	/**
+	 * Light indices referenced by the clusters of every depth slice, and their offset and count within each slice
+	 */
+	std::vector<std::vector<unsigned int>> _sliceIndices;
+	std::vector<std::vector<unsigned int>> _sliceClusters;
+
+	/**
+	 * GL buffers and the buffer textures viewing them: light data, clusters and light indices
+	 */
+	unsigned int _bufferIds[3];
+	unsigned int _textureIds[3];
+
+	/**
+	 * Statistics of the last build
+	 */
+	LightClustersStats _stats;
+
+	/**
+	 * Bins the lights overlapping a depth slice into its clusters
+	 * @param slice Depth slice
+	 * @param tanX Tangent of half the horizontal field of view
+	 * @param tanY Tangent of half the vertical field of view
+	 * @param near Near plane distance
+	 * @param far Far plane distance
+	 */
+	void binSlice(unsigned int slice, float tanX, float tanY, float near, float far);
+
+	/**
+	 * @param depth View space depth, within the near and far planes
+	 * @return The depth slice holding the depth
+	 */
+	unsigned int getSlice(float depth) const;
+
+	/**
+	 * Constructor
+	 * @param clusters Light clusters to copy from
+	 */
+	LightClusters(const LightClusters& clusters) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param clusters Light clusters to assign from
+	 */
+	LightClusters& operator=(const LightClusters& clusters) = delete;
+};
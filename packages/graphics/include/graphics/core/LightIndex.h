@@ -0,0 +1,154 @@
+#pragma once
+#include <graphics/lights/pointers/PointLightPtr.h>
+#include <map>
+#include <tuple>
+#include <vector>
+
+class PointLight;
+class Sphere;
+
+/**
+ * Statistics describing the use of a light index since it was last built
+ * @author Nathaniel Rex
+ */
+struct LightIndexStats {
+
+	/**
+	 * The number of point lights indexed
+	 */
+	unsigned int numLights = 0;
+
+	/**
+	 * The number of lights without a range, or whose range spans too many cells, which are candidates for every query
+	 */
+	unsigned int numGlobal = 0;
+
+	/**
+	 * The number of non-empty cells
+	 */
+	unsigned int numCells = 0;
+
+	/**
+	 * The number of selections made
+	 */
+	unsigned int numQueries = 0;
+
+	/**
+	 * The total number of candidate lights ranked across all selections
+	 */
+	unsigned long long numCandidates = 0;
+};
+
+/**
+ * Spatial index of point lights, used to select the lights most influencing an object. Lights with a range are hashed
+ * into the cells of a uniform grid overlapped by their sphere of influence, so that a selection only ranks the lights
+ * of the cells its bounds overlap. Selection therefore scales with the number of nearby lights rather than with the
+ * total number of lights.
+ * @author Nathaniel Rex
+ */
+class LightIndex
+{
+public:
+
+	/**
+	 * Cell edge length used when none is given, in which case it is derived from the average range of the lights
+	 */
+	static const float DEFAULT_CELL_SIZE;
+
+	/**
+	 * The largest number of cells a single light is hashed into. Lights spanning more cells are candidates for every
+	 * selection instead.
+	 */
+	static const unsigned int MAX_CELLS_PER_LIGHT;
+
+	/**
+	 * Constructor
+	 * @param cellSize (Optional) Edge length of the cubic cells. Defaults to DEFAULT_CELL_SIZE.
+	 */
+	LightIndex(float cellSize = DEFAULT_CELL_SIZE);
+
+	/**
+	 * Rebuilds the index from a set of lights, and resets statistics
+	 * @param lights Point lights, in world space
+	 */
+	void build(const std::vector<PointLightPtr>& lights);
+
+	/**
+	 * Selects the lights most influencing an object, ranked by their attenuated intensity at the point of its bounds
+	 * closest to them. Lights that do not reach the bounds are never selected.
+	 * @param bounds Bounds of the object, in world space
+	 * @param maxLights The maximum number of lights to select
+	 * @param result Receives the indices of the selected lights, in order of decreasing influence
+	 */
+	void select(const Sphere& bounds, unsigned int maxLights, std::vector<unsigned int>& result);
+
+	/**
+	 * Computes the influence of a light on an object, which falls off towards the range of the light the same way
+	 * it does in shaders
+	 * @param light Point light
+	 * @param bounds Bounds of the object, in world space
+	 * @return The attenuated intensity of the light at the point of the bounds closest to it
+	 */
+	static float computeInfluence(const PointLight& light, const Sphere& bounds);
+
+	/**
+	 * @return The edge length of the cells of the last build
+	 */
+	float getCellSize() const;
+
+	/**
+	 * @return Statistics describing the use of this index since it was last built
+	 */
+	const LightIndexStats& getStats() const;
+
+private:
+
+	typedef std::tuple<int, int, int> CellKey;
+
+	/**
+	 * Requested edge length of the cells, or DEFAULT_CELL_SIZE
+	 */
+	float _requestedCellSize;
+
+	/**
+	 * Edge length of the cells of the last build
+	 */
+	float _cellSize;
+
+	/**
+	 * Lights of the last build
+	 */
+	std::vector<PointLightPtr> _lights;
+
+	/**
+	 * Indices of the lights overlapping every non-empty cell
+	 */
+	std::map<CellKey, std::vector<unsigned int>> _cells;
+
+	/**
+	 * Indices of the lights that are candidates for every selection
+	 */
+	std::vector<unsigned int> _global;
+
+	/**
+	 * Selection during which every light was last ranked, used to rank lights spanning several cells only once
+	 */
+	std::vector<unsigned int> _stamps;
+
+	/**
+	 * Candidates of the current selection, paired with their influence
+	 */
+	std::vector<std::pair<float, unsigned int>> _candidates;
+
+	/**
+	 * Statistics
+	 */
+	LightIndexStats _stats;
+
+	/**
+	 * Ranks a light as a candidate of the current selection, unless it was already ranked
+	 * @param light Index of the light
+	 * @param bounds Bounds of the object
+	 */
+	void addCandidate(unsigned int light, const Sphere& bounds);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * Enumeration describing how meshes find the point lights that shade them
+ * @author Nathaniel Rex
+ */
+enum class LightingMode
+{
+
+	/**
+	 * Point lights are binned into clusters dividing the view frustum, and every fragment shades the lights of its
+	 * cluster. Scales to thousands of lights.
+	 */
+	CLUSTERED,
+
+	/**
+	 * Every mesh is shaded by a bounded number of the most influential point lights at its bounds, passed as uniforms.
+	 * Cheaper on low-end hardware and software GL, at the cost of ignoring lights beyond that number. Instanced,
+	 * batched and streamed meshes, which have no single bounds, still use clusters.
+	 */
+	PER_OBJECT
+};
@@ -0,0 +1,359 @@
+#pragma once
+#include <graphics/core/pointers/MeshStreamerPtr.h>
+#include <math/Matrix4.h>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Buffer;
+class ClusterFile;
+class Frustum;
+class Vector3;
+
+/**
+ * Pages the clusters of a cluster file in and out of GPU memory, so that meshes far larger than memory can be drawn.
+ * Clusters are held in a fixed pool of equally sized buffer slots, whose combined size never exceeds the memory
+ * budget, and are read from disk on background threads.
+ *
+ * Every update ranks the clusters by their screen coverage, which is the screen-space error of leaving a cluster out
+ * and falls with its distance to the camera. The highest ranked clusters are requested in order, evicting the lowest
+ * ranked resident clusters once every slot is taken, and clusters covering less of the screen than the minimum
+ * coverage are never requested. Loaded clusters are uploaded on the calling thread during the next update, so all
+ * GL calls remain on the rendering thread.
+ * @author Nathaniel Rex
+ */
+class MeshStreamer
+{
+public:
+
+	/**
+	 * Default screen coverage below which clusters are not requested
+	 */
+	static const float DEFAULT_MIN_COVERAGE;
+
+	/**
+	 * Default maximum number of clusters uploaded by a single update
+	 */
+	static const unsigned int DEFAULT_MAX_UPLOADS;
+
+	/**
+	 * Screen coverage below which clusters are not requested, and resident clusters are evicted
+	 */
+	float minCoverage = DEFAULT_MIN_COVERAGE;
+
+	/**
+	 * Maximum number of clusters uploaded by a single update, bounding the time an update spends on uploads
+	 */
+	unsigned int maxUploads = DEFAULT_MAX_UPLOADS;
+
+	/**
+	 * Destructor. Waits for the loads in progress to finish.
+	 */
+	~MeshStreamer();
+
+	/**
+	 * Constructor
+	 * @param other Mesh streamer to copy from
+	 */
+	MeshStreamer(const MeshStreamer& other) = delete;
+
+	/**
+	 * Opens a cluster file for streaming. No clusters are loaded until the first update.
+	 * @param path Absolute path to a cluster file, as written by ClusterFile::write
+	 * @param budget GPU memory that resident clusters may occupy, in bytes
+	 * @param numThreads (Optional) The number of background threads reading clusters. Uses as many threads as the
+	 * hardware can run concurrently when 0.
+	 * @return The new mesh streamer
+	 * @throws InstantiationException If the file could not be opened or is not a valid cluster file
+	 * @throws IllegalArgumentException If the budget cannot hold a single cluster
+	 */
+	static MeshStreamerPtr create(const std::string& path, unsigned long long budget, unsigned int numThreads = 0);
+
+	/**
+	 * @return The streamed cluster file
+	 */
+	const ClusterFile& getFile() const;
+
+	/**
+	 * @return GPU memory that resident clusters may occupy, in bytes
+	 */
+	unsigned long long getBudget() const;
+
+	/**
+	 * @return The size of a single buffer slot, which can hold the largest cluster of the file, in bytes
+	 */
+	unsigned long long getSlotSize() const;
+
+	/**
+	 * @return The number of buffer slots, which is the largest number of clusters that can be resident at once
+	 */
+	unsigned int getNumSlots() const;
+
+	/**
+	 * @return The number of clusters uploaded to their slots, and ready to be drawn
+	 */
+	unsigned int getNumResident() const;
+
+	/**
+	 * @return The number of clusters holding a slot while they are read or wait to be uploaded
+	 */
+	unsigned int getNumPending() const;
+
+	/**
+	 * @return The memory held by the slots of resident and pending clusters, in bytes. Never exceeds the budget.
+	 */
+	unsigned long long getUsedBytes() const;
+
+	/**
+	 * @param cluster Cluster index
+	 * @return True if the cluster is uploaded to its slot. Returns false otherwise.
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	bool isResident(unsigned int cluster) const;
+
+	/**
+	 * @param cluster Cluster index
+	 * @return Screen coverage of the cluster computed by the last update
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	float getCoverage(unsigned int cluster) const;
+
+	/**
+	 * Uploads the clusters loaded since the last update, then ranks every cluster for the given view and requests
+	 * or evicts clusters to match. Must be called from the thread owning the GL context.
+	 * @param cameraPosition Position of the camera, in world space
+	 * @param fov Vertical field of view angle of the camera, in degrees
+	 * @param modelTransform (Optional) Local-to-world transformation of the mesh
+	 * @param bias (Optional) Level of detail bias. Every unit halves the coverage of every cluster.
+	 * @throws IllegalArgumentException If the field of view is not positive
+	 * @throws InstantiationException If a cluster requested by a previous update was found to be corrupt
+	 */
+	void update(const Vector3& cameraPosition, float fov, const Matrix4& modelTransform = Matrix4::IDENTITY,
+		float bias = 0.f);
+
+	/**
+	 * Waits until every requested cluster has been read, and uploads them all regardless of the upload limit. Must
+	 * be called from the thread owning the GL context.
+	 * @throws InstantiationException If a requested cluster was found to be corrupt
+	 */
+	void flush();
+
+	/**
+	 * Collects the resident clusters intersecting a view frustum, ready for a multi-draw call
+	 * @param frustum View frustum, in world space
+	 * @param modelTransform Local-to-world transformation of the mesh
+	 * @return The number of visible clusters
+	 */
+	unsigned int cull(const Frustum& frustum, const Matrix4& modelTransform);
+
+	/**
+	 * @return Index counts of the clusters found to be visible by the last cull
+	 */
+	const std::vector<int>& getVisibleCounts() const;
+
+	/**
+	 * @return Byte offsets into the shared index buffer of the clusters found to be visible by the last cull
+	 */
+	const std::vector<const void*>& getVisibleOffsets() const;
+
+	/**
+	 * @return Base vertices of the clusters found to be visible by the last cull
+	 */
+	const std::vector<int>& getVisibleBaseVertices() const;
+
+	/**
+	 * Binds the shared buffers holding every slot for drawing. Does nothing if no cluster was ever uploaded.
+	 */
+	void bind() const;
+
+	/**
+	 * @return The GL type of the indices of every slot, to be passed to draw calls
+	 */
+	unsigned int getIndexType() const;
+
+private:
+
+	/**
+	 * Stages of a cluster on its way into GPU memory
+	 */
+	enum class ClusterState
+	{
+		UNLOADED,
+		QUEUED,
+		LOADING,
+		LOADED,
+		RESIDENT
+	};
+
+	/**
+	 * Residency of a single cluster
+	 */
+	struct ClusterResidency {
+		ClusterState state = ClusterState::UNLOADED;
+
+		/**
+		 * Slot held by the cluster, or -1 if it holds none
+		 */
+		int slot = -1;
+
+		/**
+		 * Incremented whenever the cluster is released, so that loads finishing afterwards are discarded
+		 */
+		unsigned int ticket = 0;
+
+		/**
+		 * Screen coverage computed by the last update
+		 */
+		float coverage = 0.f;
+	};
+
+	/**
+	 * Data of a cluster read by a background thread
+	 */
+	struct ClusterLoad {
+		unsigned int cluster = 0;
+		unsigned int ticket = 0;
+		std::vector<float> vertexData;
+		std::vector<unsigned int> indices;
+		std::exception_ptr error;
+	};
+
+	/**
+	 * A buffer large enough to hold any cluster of the file
+	 */
+	struct Slot {
+		std::unique_ptr<Buffer> buffer;
+
+		/**
+		 * Cluster held by the slot, or -1 if it is free
+		 */
+		int cluster = -1;
+	};
+
+	/**
+	 * Streamed cluster file
+	 */
+	std::unique_ptr<ClusterFile> _file;
+
+	/**
+	 * GPU memory that resident clusters may occupy, in bytes
+	 */
+	unsigned long long _budget;
+
+	/**
+	 * The size of a single slot, in bytes
+	 */
+	unsigned long long _slotSize;
+
+	/**
+	 * Buffer slots, created the first time they are used
+	 */
+	std::vector<Slot> _slots;
+
+	/**
+	 * Slots held by no cluster
+	 */
+	std::vector<unsigned int> _freeSlots;
+
+	/**
+	 * Residency of every cluster
+	 */
+	std::vector<ClusterResidency> _clusters;
+
+	/**
+	 * Clusters waiting to be read, in increasing order of coverage so that the most important is at the back
+	 */
+	std::vector<unsigned int> _queue;
+
+	/**
+	 * Clusters read by background threads since the last update
+	 */
+	std::vector<ClusterLoad> _completed;
+
+	/**
+	 * Loaded clusters left over by the upload limit
+	 */
+	std::vector<ClusterLoad> _staged;
+
+	/**
+	 * The number of clusters being read by background threads
+	 */
+	unsigned int _numLoading = 0;
+
+	/**
+	 * The number of clusters uploaded to their slots
+	 */
+	unsigned int _numResident = 0;
+
+	/**
+	 * Boolean flag that, when true, tells the background threads to exit
+	 */
+	bool _stopping = false;
+
+	/**
+	 * Guards the queue, the completed loads, and the states of queued and loading clusters
+	 */
+	mutable std::mutex _mutex;
+
+	/**
+	 * Signalled when clusters are queued, or the background threads should exit
+	 */
+	std::condition_variable _queued;
+
+	/**
+	 * Signalled when a background thread finishes reading a cluster
+	 */
+	std::condition_variable _loaded;
+
+	/**
+	 * Background threads reading clusters
+	 */
+	std::vector<std::thread> _workers;
+
+	/**
+	 * Index counts of the visible clusters
+	 */
+	std::vector<int> _visibleCounts;
+
+	/**
+	 * Byte offsets of the visible clusters
+	 */
+	std::vector<const void*> _visibleOffsets;
+
+	/**
+	 * Base vertices of the visible clusters
+	 */
+	std::vector<int> _visibleBaseVertices;
+
+	/**
+	 * Constructor
+	 * @param file Cluster file to stream
+	 * @param budget GPU memory that resident clusters may occupy, in bytes
+	 * @param numThreads The number of background threads
+	 */
+	MeshStreamer(std::unique_ptr<ClusterFile> file, unsigned long long budget, unsigned int numThreads);
+
+	/**
+	 * Body of every background thread, reading queued clusters until the streamer is destroyed
+	 */
+	void work();
+
+	/**
+	 * Uploads loaded clusters to their slots
+	 * @param loads Loaded clusters. Those left over by the upload limit are moved to the staged clusters.
+	 * @param limit Maximum number of clusters to upload
+	 * @return The number of clusters uploaded
+	 * @throws InstantiationException If a cluster was found to be corrupt, after every other cluster was handled
+	 */
+	unsigned int upload(std::vector<ClusterLoad>& loads, unsigned int limit);
+
+	/**
+	 * Releases the slot held by a cluster, discarding any load in progress. Must be called while holding the mutex.
+	 * @param cluster Cluster index
+	 */
+	void release(unsigned int cluster);
+};
@@ -2,11 +2,21 @@
 #include <graphics/cameras/pointers/CameraPtr.h>
 #include <graphics/lights/pointers/AmbientLightPtr.h>
 #include <graphics/lights/pointers/LightPtr.h>
+#include <graphics/lights/pointers/PointLightPtr.h>
 #include <graphics/objects/pointers/MeshPtr.h>
+#include <graphics/objects/pointers/InstancedMeshPtr.h>
+#include <graphics/objects/pointers/StreamedMeshPtr.h>
+#include <graphics/core/pointers/StaticBatchPtr.h>
+#include <graphics/core/LightingMode.h>
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <graphics/materials/pointers/MaterialPtr.h>
+#include <math/Frustum.h>
 #include <math/Matrix3.h>
 #include <math/Matrix4.h>
 #include <vector>
 
+class LightClusters;
+
 /**
  * A flattened, render-ready description of a single mesh instance obtained during scene traversal
  * @author Nathaniel Rex
@@ -18,6 +28,114 @@ struct RenderItem {
 	 */
 	MeshPtr mesh = nullptr;
 
+	/**
+	 * Geometry to draw. Is the mesh geometry, unless the mesh has several levels of detail.
+	 */
+	GeometryPtr geometry = nullptr;
+
+	/**
+	 * Fraction of pixels drawn, selected by an ordered dither pattern. Is less than 1 while levels of detail
+	 * cross-fade.
+	 */
+	float fade = 1.f;
+
+	/**
+	 * Flag that, when true, indicates that this item is the level of detail fading out, and draws the pixels
+	 * complementary to those of the level fading in
+	 */
+	bool fadeOut = false;
+
+	/**
+	 * Local-to-world transformation for vertices, accounting for all parent entities of the mesh.
+	 */
+	Matrix4 modelTransform = Matrix4::IDENTITY;
+
+	/**
+	 * Local-to-world transformation for vertex normals, accounting for all parent entities of the mesh.
+	 */
+	Matrix3 normalTransform = Matrix3::IDENTITY;
+
+	/**
+	 * The point lights most influencing the mesh, in order of decreasing influence. Only selected when lighting per
+	 * object.
+	 */
+	std::vector<PointLightPtr> lights;
+};
+
+
+/**
+ * A flattened, render-ready description of an instanced mesh obtained during scene traversal
+ * @author Nathaniel Rex
+ */
+struct InstancedRenderItem {
+
+	/**
+	 * Instanced mesh object
+	 */
+	InstancedMeshPtr mesh = nullptr;
+
+	/**
+	 * Local-to-world transformation for vertices, accounting for all parent entities of the mesh. Per-instance
+	 * transformations are applied on top of this.
+	 */
+	Matrix4 modelTransform = Matrix4::IDENTITY;
+
+	/**
+	 * Local-to-world transformation for vertex normals, accounting for all parent entities of the mesh.
+	 */
+	Matrix3 normalTransform = Matrix3::IDENTITY;
+
+	/**
+	 * The number of instances that survived frustum culling. Their indices are held by the mesh.
+	 */
+	unsigned int numVisible = 0;
+};
+
+
+/**
+ * A flattened, render-ready description of a single bucket of a static batch obtained during scene traversal
+ * @author Nathaniel Rex
+ */
+struct BatchRenderItem {
+
+	/**
+	 * Static batch
+	 */
+	StaticBatchPtr batch = nullptr;
+
+	/**
+	 * Index of the bucket within the batch. Its visible chunks are held by the batch.
+	 */
+	unsigned int bucket = 0;
+
+	/**
+	 * Material shared by all meshes in the bucket
+	 */
+	MaterialPtr material = nullptr;
+
+	/**
+	 * Local-to-world transformation of the batched group, accounting for all of its parent entities.
+	 */
+	Matrix4 modelTransform = Matrix4::IDENTITY;
+
+	/**
+	 * Local-to-world transformation for vertex normals of the batched group, accounting for all of its parent entities.
+	 */
+	Matrix3 normalTransform = Matrix3::IDENTITY;
+};
+
+
+/**
+ * A flattened, render-ready description of a streamed mesh obtained during scene traversal
+ * @author Nathaniel Rex
+ */
+struct StreamedRenderItem {
+
+	/**
+	 * Streamed mesh object. Its visible resident clusters are held by its streamer.
+	 */
+	StreamedMeshPtr mesh = nullptr;
+
 	/**
 	 * Local-to-world transformation for vertices, accounting for all parent entities of the mesh.
 	 */
@@ -42,9 +160,20 @@ struct Lighting {
 	AmbientLightPtr ambient = nullptr;
 
 	/**
-	 * Positional lighting
+	 * Point lights
+	 */
+	std::vector<PointLightPtr> points;
+
+	/**
+	 * How meshes find the point lights that shade them
+	 */
+	LightingMode mode = LightingMode::CLUSTERED;
+
+	/**
+	 * Clusters the point lights were binned into for the camera. Can be null, in which case only ambient lighting
+	 * applies.
 	 */
-	LightPtr positional = nullptr;
+	const LightClusters* clusters = nullptr;
 };
 
 
@@ -59,6 +188,37 @@ struct RenderState {
 	 */
 	CameraPtr camera = nullptr;
 
+	/**
+	 * View frustum of the camera, in world space
+	 */
+	Frustum frustum;
+
+	/**
+	 * Vertical field of view angle of the camera, in degrees, used to select levels of detail. Is 0 for cameras
+	 * without a perspective projection, which always draw the finest level.
+	 */
+	float fov = 0.f;
+
+	/**
+	 * Global level of detail bias
+	 */
+	float lodBias = 0.f;
+
+	/**
+	 * Width of the viewport, in pixels, used to find the light cluster of every fragment
+	 */
+	float viewportWidth = 0.f;
+
+	/**
+	 * Height of the viewport, in pixels, used to request the mip levels of streamed textures
+	 */
+	float viewportHeight = 0.f;
+
+	/**
+	 * Time of this frame, in seconds
+	 */
+	float time = 0.f;
+
 	/**
 	 * Ambient lighting
 	 */
@@ -68,4 +228,19 @@ struct RenderState {
 	 * The items to be drawn this frame
 	 */
 	std::vector<RenderItem> items;
+
+	/**
+	 * The instanced meshes to be drawn this frame
+	 */
+	std::vector<InstancedRenderItem> instancedItems;
+
+	/**
+	 * The static batch buckets to be drawn this frame
+	 */
+	std::vector<BatchRenderItem> batchItems;
+
+	/**
+	 * The streamed meshes to be drawn this frame
+	 */
+	std::vector<StreamedRenderItem> streamedItems;
 };
\ No newline at end of file
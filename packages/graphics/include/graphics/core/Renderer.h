@@ -5,9 +5,13 @@
 #include <graphics/cameras/pointers/CameraPtr.h>
 #include <graphics/objects/Mesh.h>
 #include <graphics/core/Color.h>
+#include <graphics/core/LightingMode.h>
+#include <memory>
 #include <mutex>
 
 struct RenderState;
+class LightClusters;
+class LightIndex;
 
 /**
  * The renderer is responsible for managing the current render context target and drawing the scene
@@ -62,6 +66,30 @@ public:
 	 */
 	void setBackgroundColor(const Color& color);
 
+	/**
+	 * @return The global level of detail bias. Defaults to 0.
+	 */
+	float getLODBias() const;
+
+	/**
+	 * Sets the global level of detail bias, applied to every mesh with several levels of detail. Every unit halves
+	 * the screen coverage used to select levels, so positive values trade detail for speed, while negative values
+	 * keep finer levels for longer.
+	 * @param bias Level of detail bias
+	 */
+	void setLODBias(float bias);
+
+	/**
+	 * @return How meshes find the point lights that shade them. Defaults to LightingMode::CLUSTERED.
+	 */
+	LightingMode getLightingMode() const;
+
+	/**
+	 * Sets how meshes find the point lights that shade them
+	 * @param mode Lighting mode
+	 */
+	void setLightingMode(LightingMode mode);
+
 	/**
 	 * Renders a scene
 	 * @param scene Scene
@@ -104,6 +132,27 @@ private:
 	 */
 	float _timeOfLastFrame = 0.f;
 
+	/**
+	 * Global level of detail bias
+	 */
+	float _lodBias = 0.f;
+
+	/**
+	 * Clusters the point lights of the last rendered scene were binned into. Created on the first render.
+	 */
+	std::unique_ptr<LightClusters> _lightClusters;
+
+	/**
+	 * How meshes find the point lights that shade them
+	 */
+	LightingMode _lightingMode = LightingMode::CLUSTERED;
+
+	/**
+	 * Spatial index of the point lights of the last traversed scene, used to select lights per object. Created on the
+	 * first traversal lighting per object.
+	 */
+	std::unique_ptr<LightIndex> _lightIndex;
+
 	/**
 	 * Increments the global renderer count
 	 */
@@ -121,6 +170,13 @@ private:
 	 */
 	static void applyGlobalSettings();
 
+	/**
+	 * Submits the shader variants this renderer can draw with in its lighting mode, so that they compile while the
+	 * first frames draw with fallbacks. Light lists are only used by meshes that are neither instanced, batched nor
+	 * streamed, and only when lighting per object.
+	 */
+	void prewarm() const;
+
 	/**
 	 * Constructs a new renderer instance
 	 * @param window Starting window target
@@ -144,8 +200,10 @@ private:
 	 * @param parent Parent entity
 	 * @param state The render state being populated for this frame and render pass. Meshes, lights, and other renderable
 	 * are appended here.
+	 * @param batched True if the entity lies within a static group whose meshes have already been merged into a static
+	 * batch, in which case its meshes are not drawn individually.
 	 */
-	void traverseScene(const EntityPtr entity, const EntityPtr parent, RenderState& state);
+	void traverseScene(const EntityPtr entity, const EntityPtr parent, RenderState& state, bool batched = false);
 
 	/**
 	 * Consumes a prepared render state and submits draw calls for all items
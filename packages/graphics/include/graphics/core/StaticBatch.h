@@ -0,0 +1,272 @@
+#pragma once
+#include <graphics/core/pointers/StaticBatchPtr.h>
+#include <graphics/core/pointers/EntityPtr.h>
+#include <graphics/objects/pointers/MeshPtr.h>
+#include <graphics/materials/pointers/MaterialPtr.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <math/Sphere.h>
+#include <math/Vector2.h>
+#include <vector>
+
+class Buffer;
+class Entity;
+class Frustum;
+class Matrix4;
+class Geometry;
+class Material;
+
+/**
+ * Statistics describing the cost and result of building a static batch
+ * @author Nathaniel Rex
+ */
+struct StaticBatchStats {
+
+	/**
+	 * The number of meshes that were merged
+	 */
+	unsigned int numMeshes = 0;
+
+	/**
+	 * The number of spatial chunks the merged meshes were divided into
+	 */
+	unsigned int numChunks = 0;
+
+	/**
+	 * The number of merged buffers (one per unique combination of batchable material and vertex attributes). This is
+	 * the number of draw calls needed to render the whole batch.
+	 */
+	unsigned int numBuckets = 0;
+
+	/**
+	 * The total number of vertices held by the merged buffers
+	 */
+	unsigned int numVertices = 0;
+
+	/**
+	 * The total number of indices held by the merged buffers
+	 */
+	unsigned int numIndices = 0;
+
+	/**
+	 * The total amount of GPU memory (in bytes) held by the merged buffers. This memory is in addition to any
+	 * buffers already created for the individual geometries.
+	 */
+	unsigned long long numBytes = 0;
+
+	/**
+	 * The time (in milliseconds) it took to build the batch
+	 */
+	float buildTime = 0.f;
+};
+
+
+/**
+ * A spatially-coherent group of triangles within a merged buffer, which is culled as a whole
+ * @author Nathaniel Rex
+ */
+struct StaticBatchChunk {
+
+	/**
+	 * Sphere bounding the triangles of the chunk, in the local space of the batched group
+	 */
+	Sphere bounds;
+
+	/**
+	 * Position of the first index of the chunk within the merged index buffer
+	 */
+	unsigned int indexOffset = 0;
+
+	/**
+	 * The number of indices in the chunk
+	 */
+	unsigned int numIndices = 0;
+
+	/**
+	 * Value added to every index of the chunk to obtain a position within the merged vertex buffer
+	 */
+	int baseVertex = 0;
+};
+
+
+/**
+ * A merged buffer holding all batched meshes that share a batchable material and a set of vertex attributes
+ * @author Nathaniel Rex
+ */
+struct StaticBatchBucket {
+
+	/**
+	 * Material of the first mesh in the bucket, which the materials of all other meshes can be batched with. Texture
+	 * coordinate transformations of every material are baked into the merged vertices.
+	 */
+	MaterialPtr material = nullptr;
+
+	/**
+	 * Vertex attributes shared by every mesh in the bucket
+	 */
+	GeometryAttributes attributes;
+
+	/**
+	 * Merged vertex and index data
+	 */
+	Buffer* buffer = nullptr;
+
+	/**
+	 * Spatial chunks within the merged buffer
+	 */
+	std::vector<StaticBatchChunk> chunks;
+
+	/**
+	 * Index counts of the chunks found to be visible by the last cull, ready for a multi-draw call
+	 */
+	std::vector<int> visibleCounts;
+
+	/**
+	 * Byte offsets into the index buffer of the chunks found to be visible by the last cull
+	 */
+	std::vector<const void*> visibleOffsets;
+
+	/**
+	 * Base vertices of the chunks found to be visible by the last cull
+	 */
+	std::vector<int> visibleBaseVertices;
+};
+
+
+/**
+ * The state of a single entity at the time a static batch was built, used to detect changes
+ * @author Nathaniel Rex
+ */
+struct StaticBatchMember {
+
+	/**
+	 * Entity
+	 */
+	EntityPtr entity = nullptr;
+
+	/**
+	 * Version of the entity
+	 */
+	unsigned int version = 0;
+
+	/**
+	 * The entity as a mesh. Is null if the entity is not a mesh.
+	 */
+	MeshPtr mesh = nullptr;
+
+	/**
+	 * Geometry of the mesh
+	 */
+	Geometry* geometry = nullptr;
+
+	/**
+	 * Version of the geometry of the mesh
+	 */
+	unsigned int geometryVersion = 0;
+
+	/**
+	 * Material of the mesh
+	 */
+	Material* material = nullptr;
+
+	/**
+	 * Material of the bucket the mesh was merged into. Is null if the mesh was not merged.
+	 */
+	Material* bucketMaterial = nullptr;
+
+	/**
+	 * Texture coordinate offset of the material, baked into the merged vertices
+	 */
+	Vector2 uvOffset;
+
+	/**
+	 * Texture coordinate scale of the material, baked into the merged vertices
+	 */
+	Vector2 uvScale;
+};
+
+
+/**
+ * The result of merging all meshes of a static entity group into a small number of combined buffers. Vertices are
+ * pre-transformed into the local space of the group, and divided into spatial chunks so that parts of the batch
+ * outside of the camera view can still be culled. Static batches are created via the StaticBatcher.
+ * @author Nathaniel Rex
+ */
+class StaticBatch
+{
+public:
+
+	friend class StaticBatcher;
+
+	/**
+	 * Destructor
+	 */
+	~StaticBatch();
+
+	/**
+	 * @return Statistics describing the cost and result of building this batch
+	 */
+	const StaticBatchStats& getStats() const;
+
+	/**
+	 * @return The edge length of the cubic cells used to divide meshes into spatial chunks
+	 */
+	float getChunkSize() const;
+
+	/**
+	 * @return The merged buffers of this batch
+	 */
+	const std::vector<StaticBatchBucket>& getBuckets() const;
+
+	/**
+	 * Determines whether any entity within the batched group has changed since this batch was built, in which case
+	 * the batch must be rebuilt. Changes to the transformation of the group itself do not make a batch stale.
+	 * @return True if this batch is out-of-date. Returns false otherwise.
+	 */
+	bool isStale() const;
+
+	/**
+	 * Determines which chunks lie within a frustum, and prepares the draw ranges of each bucket accordingly
+	 * @param frustum Frustum, in world space
+	 * @param modelTransform Local-to-world transformation of the batched group
+	 * @return The total number of visible chunks
+	 */
+	unsigned int cull(const Frustum& frustum, const Matrix4& modelTransform);
+
+private:
+
+	/**
+	 * Edge length of the cubic cells used to divide meshes into spatial chunks
+	 */
+	float _chunkSize;
+
+	/**
+	 * Statistics
+	 */
+	StaticBatchStats _stats;
+
+	/**
+	 * Merged buffers
+	 */
+	std::vector<StaticBatchBucket> _buckets;
+
+	/**
+	 * The batched group. Not owned, as the group holds the batch.
+	 */
+	const Entity* _group = nullptr;
+
+	/**
+	 * The direct children of the batched group, at the time this batch was built
+	 */
+	std::vector<EntityPtr> _roots;
+
+	/**
+	 * The state of all entities within the batched group, at the time this batch was built
+	 */
+	std::vector<StaticBatchMember> _members;
+
+	/**
+	 * Constructor
+	 * @param chunkSize Edge length of the cubic cells used to divide meshes into spatial chunks
+	 */
+	StaticBatch(float chunkSize);
+};
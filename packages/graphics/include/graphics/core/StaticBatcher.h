@@ -0,0 +1,33 @@
+#pragma once
+#include <graphics/core/pointers/StaticBatchPtr.h>
+#include <graphics/core/pointers/EntityGroupPtr.h>
+
+/**
+ * Merges the meshes of a static entity group into a small number of combined buffers, so that the whole group can
+ * be drawn with one draw call per unique material. Meshes are grouped by material and vertex attributes, and then
+ * divided into cubic cells of a fixed size so that each cell can be frustum culled independently.
+ * @author Nathaniel Rex
+ */
+class StaticBatcher
+{
+public:
+
+	/**
+	 * Default edge length of the cubic cells used to divide meshes into spatial chunks
+	 */
+	static const float DEFAULT_CHUNK_SIZE;
+
+	/**
+	 * Merges all meshes within a static group and assigns the result to the group, replacing any previous batch.
+	 * Meshes without a geometry or a material, and geometries without vertex positions or indices, are skipped.
+	 * @param group The static group to batch
+	 * @param chunkSize Edge length of the cubic cells used to divide meshes into spatial chunks
+	 * @return The new batch
+	 */
+	static StaticBatchPtr build(EntityGroupPtr group, float chunkSize = DEFAULT_CHUNK_SIZE);
+
+	/**
+	 * Deleted constructor
+	 */
+	StaticBatcher() = delete;
+};
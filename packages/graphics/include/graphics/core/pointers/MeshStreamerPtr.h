@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * Shared pointer to a MeshStreamer instance
+ */
+using MeshStreamerPtr = std::shared_ptr<class MeshStreamer>;
@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * Shared pointer to a StaticBatch instance
+ */
+using StaticBatchPtr = std::shared_ptr<class StaticBatch>;
@@ -4,7 +4,8 @@
 #include <graphics/core/shaders/pointers/BasicShaderPtr.h>
 
 /**
- * Source code for the vertex shader used to handle 'basic' materials
+ * Source code for the vertex shader used to handle 'basic' materials. Variants are selected by the defines of
+ * ShaderFeatures.
  */
 constexpr const char* BASIC_VERTEX = R"(
 		#version 330 core
@@ -18,11 +19,16 @@ constexpr const char* BASIC_VERTEX = R"(
 
 		struct Material {
 			vec4 color;
-			int hasVertexColor;
 			float reflectivity;
 			float shine;
-			int hasTexture;
+		#ifdef HAS_TEXTURE
 			sampler2D texture;
+		#endif
+		#ifdef HAS_TEXTURE_ARRAY
+			sampler2DArray textureArray;
+			float textureLayer;
+		#endif
+			vec4 uvTransform;
 		};
 
 		// Inputs
@@ -31,6 +37,15 @@ constexpr const char* BASIC_VERTEX = R"(
 		layout (location = 2) in vec4 vert_Color;
 		layout (location = 3) in vec2 vert_TexCoord;
 
+		// Per-instance inputs
+		#ifdef INSTANCED
+		layout (location = 4) in vec4 inst_Row0;
+		layout (location = 5) in vec4 inst_Row1;
+		layout (location = 6) in vec4 inst_Row2;
+		layout (location = 7) in vec4 inst_Color;
+		layout (location = 8) in float inst_Layer;
+		#endif
+
 		// Uniforms
 		uniform Material uMaterial;
 		uniform Transforms uTransforms;
@@ -39,20 +54,55 @@ constexpr const char* BASIC_VERTEX = R"(
 		out vec4 frag_Color;
 		out vec3 frag_Pos;
 		out vec3 frag_Normal;
+		out float frag_Depth;
+		#if defined(HAS_TEXTURE) || defined(HAS_TEXTURE_ARRAY)
 		out vec2 frag_TexCoord;
+		#endif
+		#ifdef HAS_TEXTURE_ARRAY
+		flat out float frag_Layer;
+		#endif
 
 		void main()
 		{
-			frag_Color = uMaterial.hasVertexColor == 1 ? vert_Color : uMaterial.color;
-			frag_Pos = vec3(uTransforms.model * vec4(vert_Pos, 1.0f));
-			frag_Normal = uTransforms.normal * vert_Normal;
-			frag_TexCoord = vert_TexCoord;
-			gl_Position = uTransforms.proj * uTransforms.view * uTransforms.model * vec4(vert_Pos, 1.0f);
+			mat4 model = uTransforms.model;
+			mat3 normal = uTransforms.normal;
+
+		#ifdef HAS_VERTEX_COLORS
+			frag_Color = vert_Color;
+		#else
+			frag_Color = uMaterial.color;
+		#endif
+
+		#ifdef INSTANCED
+			mat4 instance = transpose(mat4(inst_Row0, inst_Row1, inst_Row2, vec4(0.0, 0.0, 0.0, 1.0)));
+			model = model * instance;
+			normal = normal * transpose(inverse(mat3(instance)));
+			frag_Color *= inst_Color;
+		#endif
+
+			vec4 worldPos = model * vec4(vert_Pos, 1.0f);
+			vec4 viewPos = uTransforms.view * worldPos;
+			frag_Pos = vec3(worldPos);
+			frag_Normal = normal * vert_Normal;
+			frag_Depth = -viewPos.z;
+
+		#if defined(HAS_TEXTURE) || defined(HAS_TEXTURE_ARRAY)
+			frag_TexCoord = vert_TexCoord * uMaterial.uvTransform.zw + uMaterial.uvTransform.xy;
+		#endif
+		#ifdef HAS_TEXTURE_ARRAY
+			frag_Layer = uMaterial.textureLayer;
+		#ifdef INSTANCED
+			frag_Layer += inst_Layer;
+		#endif
+		#endif
+
+			gl_Position = uTransforms.proj * viewPos;
 		}
 )";
 
 /**
- * Source code for the fragment shader used to handle 'basic' materials
+ * Source code for the fragment shader used to handle 'basic' materials. Variants are selected by the defines of
+ * ShaderFeatures.
  */
 constexpr const char* BASIC_FRAGMENT = R"(
 		#version 330 core
@@ -63,51 +113,133 @@ constexpr const char* BASIC_FRAGMENT = R"(
 			float intensity;
 		};
 
+		// Point lights binned into a grid of clusters dividing the view frustum
+		struct Clusters {
+			samplerBuffer lightData;
+			usamplerBuffer clusters;
+			usamplerBuffer indices;
+			ivec3 dimensions;
+			vec2 depthTransform;
+			vec2 viewport;
+		};
+
 		struct Material {
 			vec4 color;
-			int hasVertexColor;
 			float reflectivity;
 			float shine;
-			int hasTexture;
+		#ifdef HAS_TEXTURE
 			sampler2D texture;
+		#endif
+		#ifdef HAS_TEXTURE_ARRAY
+			sampler2DArray textureArray;
+			float textureLayer;
+		#endif
+			vec4 uvTransform;
 		};
 
 		// Inputs
 		in vec4 frag_Color;
 		in vec3 frag_Pos;
 		in vec3 frag_Normal;
+		in float frag_Depth;
+		#if defined(HAS_TEXTURE) || defined(HAS_TEXTURE_ARRAY)
 		in vec2 frag_TexCoord;
+		#endif
+		#ifdef HAS_TEXTURE_ARRAY
+		flat in float frag_Layer;
+		#endif
 
 		// Uniforms
 		uniform vec3 uCameraPos;
 		uniform Light uAmbient;
-		uniform Light uLight;
+		#ifdef HAS_LIGHT_LIST
+		uniform vec4 uLights[MAX_LIGHTS * 2];
+		uniform int uNumLights;
+		#else
+		uniform Clusters uClusters;
+		#endif
 		uniform Material uMaterial;
+		uniform float uFade;
+		uniform int uFadeOut;
+
+		// 4x4 ordered dither matrix
+		const int DITHER[16] = int[16](0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5);
 
 		// Outputs
 		out vec4 FragColor;
 
-		void main()
+		// Diffuse and specular contribution of a point light. Lights with a range fade out smoothly towards it.
+		vec4 shadePointLight(vec4 positionRange, vec4 colorIntensity, vec3 norm, vec3 viewDir, float specExp)
 		{
-			vec4 ambient = vec4(uAmbient.color * uAmbient.intensity, 1.0);
-			
-			vec4 diffuse = vec4(uLight.color * uLight.intensity, 1.0);
-			vec3 norm = normalize(frag_Normal);
-			vec3 lightDir = normalize(uLight.position - frag_Pos);
+			vec3 toLight = positionRange.xyz - frag_Pos;
+			float attenuation = 1.0;
+			if (positionRange.w > 0.0)
+			{
+				float ratio = length(toLight) / positionRange.w;
+				attenuation = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+				attenuation *= attenuation;
+			}
+
+			vec3 lightDir = normalize(toLight);
 			float diff = max(dot(norm, lightDir), 0.0);
-			diffuse = diff * diffuse;
+			vec3 diffuse = diff * colorIntensity.rgb * colorIntensity.a;
 
-			vec3 viewDir = normalize(uCameraPos - frag_Pos);
 			vec3 reflectDir = reflect(-lightDir, norm);
-			float specExp = exp2(round(mix(0.0, 8.0, uMaterial.shine)));
 			float spec = pow(max(dot(viewDir, reflectDir), 0.0), specExp);
-			vec4 specular = vec4(uMaterial.reflectivity * spec * uLight.color, 1.0);  
+			vec3 specular = uMaterial.reflectivity * spec * colorIntensity.rgb;
+			return vec4(attenuation * (diffuse + specular), 0.0);
+		}
+
+		void main()
+		{
+			// Levels of detail cross-fade by drawing complementary fractions of the pixels
+			if (uFade < 1.0)
+			{
+				ivec2 cell = ivec2(gl_FragCoord.xy) & 3;
+				float threshold = (float(DITHER[cell.y * 4 + cell.x]) + 0.5) / 16.0;
+				if ((uFadeOut == 1 ? 1.0 - threshold : threshold) >= uFade)
+				{
+					discard;
+				}
+			}
 
-			vec4 color = (ambient + diffuse + specular) * frag_Color;
-			if (uMaterial.hasTexture == 1)
+			vec4 light = vec4(uAmbient.color * uAmbient.intensity, 1.0);
+			vec3 norm = normalize(frag_Normal);
+			vec3 viewDir = normalize(uCameraPos - frag_Pos);
+			float specExp = exp2(round(mix(0.0, 8.0, uMaterial.shine)));
+
+		#ifdef HAS_LIGHT_LIST
+			// Shade the point lights selected for this object
+			for (int i = 0; i < uNumLights; i++)
 			{
-				color *= texture(uMaterial.texture, frag_TexCoord);
+				light += shadePointLight(uLights[i * 2], uLights[i * 2 + 1], norm, viewDir, specExp);
 			}
+		#else
+			// Only shade the point lights of the cluster holding this fragment
+			if (uClusters.dimensions.x > 0)
+			{
+				ivec2 tile = ivec2(gl_FragCoord.xy / uClusters.viewport * vec2(uClusters.dimensions.xy));
+				tile = clamp(tile, ivec2(0), uClusters.dimensions.xy - 1);
+				float depth = log(max(frag_Depth, 1e-4)) * uClusters.depthTransform.x + uClusters.depthTransform.y;
+				int slice = clamp(int(depth), 0, uClusters.dimensions.z - 1);
+				int index = (slice * uClusters.dimensions.y + tile.y) * uClusters.dimensions.x + tile.x;
+				uvec2 cluster = texelFetch(uClusters.clusters, index).xy;
+				for (uint i = 0u; i < cluster.y; i++)
+				{
+					int lightIndex = int(texelFetch(uClusters.indices, int(cluster.x + i)).x);
+					light += shadePointLight(texelFetch(uClusters.lightData, lightIndex * 2),
+						texelFetch(uClusters.lightData, lightIndex * 2 + 1), norm, viewDir, specExp);
+				}
+			}
+		#endif
+
+			vec4 color = light * frag_Color;
+		#ifdef HAS_TEXTURE
+			color *= texture(uMaterial.texture, frag_TexCoord);
+		#endif
+		#ifdef HAS_TEXTURE_ARRAY
+			color *= texture(uMaterial.textureArray, vec3(frag_TexCoord, frag_Layer));
+		#endif
 			FragColor = color;
 		} 
 )";
@@ -121,10 +253,13 @@ class BasicShader : public Shader
 public:
 
 	/**
-	 * Constructs a new BasicShader instance. This should typically only be done once, by the shader manager.
+	 * Constructs a new BasicShader variant. This should typically only be done once per variant, by the shader
+	 * manager.
+	 * @param features (Optional) Bit flags of ShaderFeatures selecting the variant. Defaults to none.
 	 * @return The new BasicShader instance
+	 * @throws InstantiationException On failure to compile or link the variant
 	 */
-	static BasicShaderPtr create();
+	static BasicShaderPtr create(unsigned int features = 0);
 
 protected:
 
@@ -138,6 +273,7 @@ private:
 
 	/**
 	 * Constructor
+	 * @param features Bit flags of ShaderFeatures selecting the variant
 	 */
-	BasicShader();
+	BasicShader(unsigned int features);
 };
\ No newline at end of file
@@ -2,15 +2,28 @@
 #include <graphics/cameras/pointers/CameraPtr.h>
 #include <graphics/lights/pointers/LightPtr.h>
 #include <graphics/lights/pointers/AmbientLightPtr.h>
+#include <graphics/lights/pointers/PointLightPtr.h>
 #include <graphics/materials/pointers/MaterialPtr.h>
+#include <chrono>
+#include <string>
+#include <vector>
 
 class Matrix3;
 class Matrix4;
+class LightClusters;
 struct RenderState;
 struct RenderItem;
+struct InstancedRenderItem;
+struct BatchRenderItem;
+struct StreamedRenderItem;
 
 /**
- * Parent class to all shared programs, managed by the shader manager
+ * Parent class to all shared programs, managed by the shader manager.
+ *
+ * Programs are compiled and linked asynchronously: construction only submits the sources to the driver, and their
+ * status is checked once the program is ready. With GL_KHR_parallel_shader_compile, readiness is polled without
+ * blocking, letting the driver compile many programs on its own threads. Otherwise the first check blocks until the
+ * driver is done, which still lets it overlap the compilation of every program submitted before.
  * @author Nathaniel Rex
  */
 class Shader {
@@ -33,35 +46,143 @@ public:
      */
     virtual void setItem(const RenderItem& item) final;
 
+    /**
+     * Updates this shader's uniforms given a specific instanced mesh being rendered
+     * @param item Instanced item being rendered
+     */
+    virtual void setInstancedItem(const InstancedRenderItem& item) final;
+
+    /**
+     * Updates this shader's uniforms given a specific static batch bucket being rendered
+     * @param item Batched item being rendered
+     */
+    virtual void setBatchItem(const BatchRenderItem& item) final;
+
+    /**
+     * Updates this shader's uniforms given a specific streamed mesh being rendered
+     * @param item Streamed item being rendered
+     */
+    virtual void setStreamedItem(const StreamedRenderItem& item) final;
+
     /**
      * Activates this shader as the current shader program used for rendering
      */
     void activate() const;
 
+    /**
+     * @return Bit flags of ShaderFeatures this shader variant was compiled with
+     */
+    unsigned int getFeatures() const;
+
+    /**
+     * Determines whether this program has finished compiling and linking, without blocking if the driver supports
+     * parallel compilation. Programs must be ready before being used for rendering.
+     * @return True if the program is ready for use. Returns false otherwise.
+     * @throws InstantiationException On failure to compile or link the program
+     */
+    bool isReady();
+
+    /**
+     * Blocks until this program has finished compiling and linking
+     * @throws InstantiationException On failure to compile or link the program
+     */
+    void wait();
+
+    /**
+     * @return True if the current GL context can compile programs in parallel and report their completion without
+     * blocking. Returns false otherwise.
+     */
+    static bool isParallelSupported();
+
 protected:
 
+    /**
+     * First of the three texture units the light cluster buffer textures are bound to. Units below are reserved for
+     * material textures.
+     */
+    static const unsigned int LIGHT_UNIT;
+
     /**
 	 * GLFW id
 	 */
 	unsigned int _id;
 
     /**
-     * Constructor
+     * Bit flags of ShaderFeatures this shader variant was compiled with
+     */
+    unsigned int _features;
+
+    /**
+     * Program name, used in error messages on failure to compile or link
+     */
+    std::string _name;
+
+    /**
+     * GLFW ids of the vertex and fragment shaders while the program is being linked, or 0 once it is ready
+     */
+    unsigned int _vertexId;
+    unsigned int _fragmentId;
+
+    /**
+     * Key of the program in the ShaderCache
+     */
+    unsigned long long _key;
+
+    /**
+     * Time the sources were submitted, used to measure the time spent compiling
+     */
+    std::chrono::steady_clock::time_point _start;
+
+    /**
+     * True if the driver reports completion without blocking
+     */
+    bool _parallel;
+
+    /**
+     * True once the program has been compiled, linked and checked
+     */
+    bool _ready;
+
+    /**
+     * Light list last uploaded to the uniforms of variants with a light list, followed by the number of lights
+     */
+    std::vector<float> _lightList;
+
+    /**
+     * Constructor. Loads the program from the ShaderCache if its binary is cached, and submits it for compilation
+     * otherwise.
      * @param prgmName Program name. Used in error messages on failure to compile or link.
      * @param vertexShader Vertex shader source code
      * @param fragmentShader Fragment shader source code
-     * @throws InstantiationException On failure to compile or link the shader
+     * @param features (Optional) Bit flags of ShaderFeatures, whose defines are injected into both sources. Defaults
+     * to none.
+     * @throws InstantiationException On failure to create the shader objects
      */
-    Shader(const char* prgmName, const char* vertexShader, const char* fragmentShader);
+    Shader(const char* prgmName, const char* vertexShader, const char* fragmentShader, unsigned int features = 0);
 
     /**
-     * Compiles shader code for use in linking.
-     * @param prgmName Program name. Used in error messages on failure to compile.
+     * Submits shader code for compilation, without waiting for the result
      * @param type The shader type
      * @param source Shader source code
-     * @return The ID of the compiled shader. Must be destroyed via glDeleteShader when no longer needed.
+     * @return The ID of the shader. Must be destroyed via glDeleteShader when no longer needed.
+     * @throws InstantiationException On failure to create the shader
+     */
+    unsigned int compileSource(int type, const char* source);
+
+    /**
+     * Checks that shader code compiled successfully
+     * @param id The ID of the shader
+     * @param type The shader type
+     * @throws InstantiationException If the shader failed to compile
      */
-    unsigned int compileSource(const char* prgmName, int type, const char* source);
+    void checkSource(unsigned int id, int type) const;
+
+    /**
+     * Checks the compile and link status of the program, releases its shaders and caches its binary. Blocks until the
+     * driver is done if it has not finished yet.
+     * @throws InstantiationException On failure to compile or link the program
+     */
+    void finish();
 
     /**
      * Helper method that obtains the location of a uniform variable in this shader program (assuming it's bound),
@@ -94,11 +215,22 @@ protected:
     virtual void setAmbientLighting(const AmbientLightPtr light);
 
     /**
-     * Updates the uniforms for this shader using the given light present in the scene. This method assumes that this
-     * shader is currently in-use.
-     * @param light Light entity
+     * Updates the uniforms for this shader using the clusters the point lights of the scene were binned into. This
+     * method assumes that this shader is currently in-use.
+     * @param clusters Light clusters. Can be null, in which case point lights are skipped.
+     * @param width Width of the viewport, in pixels
+     * @param height Height of the viewport, in pixels
+     */
+    virtual void setLightClusters(const LightClusters* clusters, float width, float height);
+
+    /**
+     * Updates the uniforms of variants with a light list using the lights selected for an item. Uniforms are only
+     * uploaded if the lights differ from the ones last uploaded. This method assumes that this shader is currently
+     * in-use.
+     * @param lights Point lights, in order of decreasing influence. Lights beyond ShaderFeatures::MAX_LIGHTS are
+     * ignored.
      */
-    virtual void setPositionalLight(const LightPtr light);
+    virtual void setLightList(const std::vector<PointLightPtr>& lights);
 
     /**
      * Updates uniforms for this shader using the given camera. This method assumes that this shader is currently in-use.
@@ -0,0 +1,171 @@
+#pragma once
+#include <memory>
+#include <string>
+
+/**
+ * Statistics describing the shader programs created through the shader cache
+ * @author Nathaniel Rex
+ */
+struct ShaderCacheStats {
+
+	/**
+	 * The number of programs loaded from cached binaries
+	 */
+	unsigned long long numHits = 0;
+
+	/**
+	 * The number of programs compiled and linked from source
+	 */
+	unsigned long long numMisses = 0;
+
+	/**
+	 * The number of cached binaries rejected by the driver, whose programs were compiled from source instead
+	 */
+	unsigned long long numRejected = 0;
+
+	/**
+	 * Time spent compiling and linking programs from source, from their submission until they were found ready, in
+	 * milliseconds. Programs compiling in parallel overlap, so this can exceed the time startup actually took.
+	 */
+	float compileTime = 0.f;
+
+	/**
+	 * Time spent loading programs from cached binaries, in milliseconds
+	 */
+	float loadTime = 0.f;
+};
+
+/**
+ * The shader cache stores the binaries of linked shader programs on disk (.tfprogram), retrieved with
+ * glGetProgramBinary, so that later runs can load them with glProgramBinary rather than compiling and linking their
+ * sources again.
+ *
+ * Binaries are keyed by a hash of the program sources, including any defines injected into them, and of the vendor,
+ * renderer and version strings of the driver, since binaries are only valid for the driver that produced them.
+ * Binaries that fail to read, or that the driver rejects, are treated as misses: the program is compiled from source
+ * and its binary written again. Caching is skipped entirely if the GL context supports no binary formats. Compile and
+ * load times are reported by the statistics, so startup with and without the cache can be compared.
+ * @author Nathaniel Rex
+ */
+class ShaderCache
+{
+public:
+
+	/**
+	 * File extension of shader cache files
+	 */
+	static const std::string EXTENSION;
+
+	/**
+	 * Version of the format written by this class. Files of other versions are rejected.
+	 */
+	static const unsigned int VERSION;
+
+	/**
+	 * Destructor
+	 */
+	~ShaderCache();
+
+	/**
+	 * @return True if the current GL context can retrieve and load program binaries. Returns false otherwise.
+	 */
+	static bool isSupported();
+
+	/**
+	 * Computes the key identifying the binary of a program for the driver of the current GL context
+	 * @param vertexShader Vertex shader source code
+	 * @param fragmentShader Fragment shader source code
+	 * @return Key of the program
+	 */
+	static unsigned long long computeKey(const char* vertexShader, const char* fragmentShader);
+
+	/**
+	 * Creates a program from its cached binary. Must be called from the thread owning the GL context.
+	 * @param key Key of the program
+	 * @return GLFW id of the linked program, or 0 if caching is disabled or unsupported, no binary is cached, or the
+	 * driver rejected the binary
+	 */
+	static unsigned int load(unsigned long long key);
+
+	/**
+	 * Records a program compiled and linked from source, and caches its binary if possible. Failures to write the
+	 * binary are ignored. Must be called from the thread owning the GL context.
+	 * @param key Key of the program
+	 * @param program GLFW id of the linked program, which should have been linked with
+	 * GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+	 * @param compileTime Time spent compiling and linking the program, in milliseconds
+	 */
+	static void save(unsigned long long key, unsigned int program, float compileTime);
+
+	/**
+	 * @return Absolute path to the directory holding the cache files, or an empty string if caching is disabled
+	 */
+	static std::string getDirectory();
+
+	/**
+	 * Sets the directory holding the cache files, which is created when the first file is written
+	 * @param directory Absolute path to the directory, or an empty string to disable caching
+	 */
+	static void setDirectory(const std::string& directory);
+
+	/**
+	 * @return Statistics describing the programs created so far
+	 */
+	static ShaderCacheStats getStats();
+
+	/**
+	 * Resets the global shader cache instance to its initial state
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * Global shader cache instance
+	 */
+	static std::unique_ptr<ShaderCache> _INSTANCE;
+
+	/**
+	 * Absolute path to the directory holding the cache files, or an empty string if caching is disabled
+	 */
+	std::string _directory;
+
+	/**
+	 * Statistics describing the programs created so far
+	 */
+	ShaderCacheStats _stats;
+
+	/**
+	 * Constructor
+	 */
+	ShaderCache();
+
+	/**
+	 * Constructor
+	 * @param cache Shader cache to copy from
+	 */
+	ShaderCache(const ShaderCache& cache) = delete;
+
+	/**
+	 * Constructor
+	 * @param cache Shader cache to copy from
+	 */
+	ShaderCache(ShaderCache&& cache) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param cache Shader cache to assign from
+	 */
+	ShaderCache& operator=(const ShaderCache& cache) = delete;
+
+	/**
+	 * @return The global shader cache instance
+	 */
+	static ShaderCache* getInstance();
+
+	/**
+	 * @param key Key of a program
+	 * @return Absolute path to the cache file of the program
+	 */
+	std::string getPath(unsigned long long key) const;
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <string>
+
+class Material;
+class GeometryAttributes;
+
+/**
+ * Bit flags describing the features a shader variant is compiled with. Every feature injects a #define into the
+ * shader sources, so that variants only declare the inputs and samplers they use, and branch at compile time rather
+ * than on uniforms. Together with the material type, the features form a compact key identifying a variant, which
+ * the shader manager uses to look variants up, and which can serve as a component of draw sort keys.
+ * @author Nathaniel Rex
+ */
+class ShaderFeatures
+{
+public:
+
+	/**
+	 * The material samples a texture. Defines HAS_TEXTURE.
+	 */
+	static const unsigned int TEXTURE;
+
+	/**
+	 * The material samples a layer of a texture array. Defines HAS_TEXTURE_ARRAY. Cannot be combined with TEXTURE.
+	 */
+	static const unsigned int TEXTURE_ARRAY;
+
+	/**
+	 * The geometry holds vertex colors, which replace the color of the material. Defines HAS_VERTEX_COLORS.
+	 */
+	static const unsigned int VERTEX_COLORS;
+
+	/**
+	 * Instances are drawn with per-instance transformations, colors and layers. Defines INSTANCED.
+	 */
+	static const unsigned int INSTANCED;
+
+	/**
+	 * Point lights are passed as a fixed-size array of uniforms selected per object, rather than read from light
+	 * clusters. Defines HAS_LIGHT_LIST and MAX_LIGHTS. Set by the renderer when lighting per object, rather than
+	 * computed from materials.
+	 */
+	static const unsigned int LIGHT_LIST;
+
+	/**
+	 * The number of combinations of feature bits, including those of features that cannot be combined
+	 */
+	static const unsigned int NUM_VARIANTS;
+
+	/**
+	 * The maximum number of point lights shading an object with a light list
+	 */
+	static const unsigned int MAX_LIGHTS;
+
+	/**
+	 * Computes the features needed to draw a geometry with a material. Textures are only sampled if the geometry
+	 * holds texture coordinates, and vertex colors only used if the geometry holds them. The texture array of a
+	 * material is sampled instead of its texture.
+	 * @param material Material
+	 * @param attributes Vertex attributes of the geometry
+	 * @param instanced True if the geometry is drawn as instances
+	 * @return The features
+	 */
+	static unsigned int compute(const Material& material, const GeometryAttributes& attributes, bool instanced);
+
+	/**
+	 * @param features The features
+	 * @return True if the features only hold known bits, and do not combine features that exclude each other.
+	 * Returns false otherwise.
+	 */
+	static bool isValid(unsigned int features);
+
+	/**
+	 * @param features The features
+	 * @return The #define directives of the features, one per line
+	 */
+	static std::string getDefines(unsigned int features);
+
+	/**
+	 * Injects the #define directives of features into shader source code, right after its #version directive
+	 * @param source Shader source code
+	 * @param features The features
+	 * @return The source code of the variant
+	 */
+	static std::string inject(const char* source, unsigned int features);
+
+	/**
+	 * Deleted constructor
+	 */
+	ShaderFeatures() = delete;
+};
@@ -1,11 +1,21 @@
 #pragma once
 #include <graphics/core/shaders/pointers/ShaderPtr.h>
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 enum class MaterialType;
 
 /**
- * The shader manager is a singleton, responsible for tracking all shaders that have been registered for use
+ * The shader manager is a singleton, responsible for tracking all shaders that have been registered for use.
+ *
+ * Every material type has a variant per valid combination of ShaderFeatures, compiled the first time it is requested
+ * or ahead of time by prewarming. Variants are held in a flat array indexed by their key, which combines the material
+ * type and the features.
+ *
+ * Variants compile asynchronously. Prewarming submits the variants a caller expects to draw with up front without
+ * waiting, and the renderer draws with a fallback variant, which only keeps the instancing and light list features,
+ * until the variant it asked for is ready. Only fallback variants are ever waited for, so startup does not grow with
+ * the number of variants.
  * @author Nathaniel Rex
  */
 class ShaderManager
@@ -18,12 +28,54 @@ public:
 	~ShaderManager();
 
 	/**
-	 * Fetches a shader program for use against a given material type
+	 * Fetches a shader program for use against a given material type, compiling it and waiting for it if needed
 	 * @param matType Material type
+	 * @param features (Optional) Bit flags of ShaderFeatures selecting the variant. Defaults to none.
 	 * @return The shader program capable of handling that material
+	 * @throws IllegalArgumentException If the features are not valid
 	 * @throws NullPointerException If a shader for that material type could not be found
 	 */
-	static ShaderPtr getShader(MaterialType matType);
+	static ShaderPtr getShader(MaterialType matType, unsigned int features = 0);
+
+	/**
+	 * Fetches a shader program for use against a given material type without waiting for it to compile. If the
+	 * variant is not ready yet, the fallback variant with no features other than instancing and the light list is
+	 * returned instead, which is waited for if needed.
+	 * @param matType Material type
+	 * @param features Bit flags of ShaderFeatures selecting the variant
+	 * @return The variant if it is ready, or the fallback variant otherwise
+	 * @throws IllegalArgumentException If the features are not valid
+	 * @throws NullPointerException If a shader for that material type could not be found
+	 */
+	static ShaderPtr getReadyShader(MaterialType matType, unsigned int features);
+
+	/**
+	 * Submits variants of the shader of a material type that have not been compiled yet, without waiting for them to
+	 * compile
+	 * @param matType Material type
+	 * @param variants Bit flags of ShaderFeatures selecting every variant to submit
+	 * @throws IllegalArgumentException If the features of a variant are not valid
+	 * @throws NullPointerException If a shader for that material type could not be found
+	 */
+	static void prewarm(MaterialType matType, const std::vector<unsigned int>& variants);
+
+	/**
+	 * Computes the key identifying a shader variant, which is also its index in the flat array of variants
+	 * @param matType Material type
+	 * @param features Bit flags of ShaderFeatures selecting the variant
+	 * @return The key
+	 */
+	static unsigned int getKey(MaterialType matType, unsigned int features);
+
+	/**
+	 * @return The number of shader variants compiled so far
+	 */
+	static unsigned int getNumShaders();
+
+	/**
+	 * @return The number of shader variants submitted but not ready yet
+	 */
+	static unsigned int getNumPending();
 
 	/**
 	 * Resets the global shader manager instance to its initial state, prior to graphics initialization
@@ -38,9 +90,9 @@ private:
 	static std::unique_ptr<ShaderManager> _INSTANCE;
 
 	/**
-	 * Mapping from material types to shaders
+	 * Shader variants indexed by their key, or null if they have not been compiled yet
 	 */
-	std::unordered_map<MaterialType, ShaderPtr> _shaders;
+	std::vector<ShaderPtr> _shaders;
 
 	/**
 	 * Constructor
@@ -69,4 +121,12 @@ private:
 	 * @return The global ShaderManager instance
 	 */
 	static ShaderManager* getInstance();
+
+	/**
+	 * Fetches a shader variant, submitting it for compilation if needed but without waiting for it
+	 * @param matType Material type
+	 * @param features Bit flags of ShaderFeatures selecting the variant
+	 * @return The shader variant, which may not be ready yet
+	 */
+	static ShaderPtr submit(MaterialType matType, unsigned int features);
 };
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * Enumeration describing how the components of a vertex attribute are stored on the GPU. Vertex data is always
+ * supplied as 32-bit floats, and converted to the storage format when uploaded.
+ * @author Nathaniel Rex
+ */
+enum class AttributeFormat
+{
+
+	/**
+	 * 32-bit floating point components. Supported by all attributes.
+	 */
+	FLOAT,
+
+	/**
+	 * 16-bit floating point components. Supported by all attributes.
+	 */
+	HALF_FLOAT,
+
+	/**
+	 * 8-bit unsigned components, normalized to the range 0 to 1. Supported by colors only.
+	 */
+	UNSIGNED_BYTE,
+
+	/**
+	 * Three signed 10-bit components and an unused 2-bit component packed into 32 bits, normalized to the range
+	 * -1 to 1. Supported by normals only.
+	 */
+	INT_2_10_10_10_REV
+};
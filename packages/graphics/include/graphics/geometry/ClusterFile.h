@@ -0,0 +1,236 @@
+#pragma once
+#include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <math/Box.h>
+#include <math/Sphere.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+/**
+ * Description of a single cluster of a cluster file
+ * @author Nathaniel Rex
+ */
+struct ClusterInfo {
+
+	/**
+	 * Sphere bounding the vertices of the cluster
+	 */
+	Sphere bounds;
+
+	/**
+	 * Axis-aligned box bounding the vertices of the cluster
+	 */
+	Box box;
+
+	/**
+	 * The number of vertices of the cluster
+	 */
+	unsigned int numVertices = 0;
+
+	/**
+	 * The number of indices of the cluster
+	 */
+	unsigned int numIndices = 0;
+};
+
+
+/**
+ * Reads and writes the chunked mesh format (.tfclusters), which stores a mesh too large to be held in memory as a
+ * series of spatially coherent clusters that can be loaded independently. Every cluster holds its own interleaved
+ * vertices and a triangle list indexing them, and is described in a table at the end of the file by its bounding
+ * sphere and box, so that clusters can be selected by their distance to the camera without touching their data.
+ *
+ * Files are memory-mapped for random access, so only the clusters that are read are ever paged in. Every cluster
+ * carries its own checksum, which is verified when the cluster is read rather than when the file is opened, so that
+ * opening a file costs the same no matter how large it is. Cluster files are typically paged in by the MeshStreamer.
+ * @author Nathaniel Rex
+ */
+class ClusterFile
+{
+public:
+
+	/**
+	 * Generates the vertices and indices of a single cluster while writing a cluster file
+	 * @param index Index of the cluster to generate
+	 * @param vertexData Vector to fill with interleaved vertex data. Is empty when called.
+	 * @param indices Vector to fill with a triangle list indexing the vertices of the cluster. Is empty when called.
+	 */
+	using ClusterGenerator = std::function<void(unsigned int index, std::vector<float>& vertexData,
+		std::vector<unsigned int>& indices)>;
+
+	/**
+	 * File extension of cluster files
+	 */
+	static const std::string EXTENSION;
+
+	/**
+	 * Version of the format written by this class. Files of other versions are rejected.
+	 */
+	static const unsigned int VERSION;
+
+	/**
+	 * Alignment of every block in the file, in bytes
+	 */
+	static const size_t ALIGNMENT;
+
+	/**
+	 * Default maximum number of triangles per cluster when partitioning a geometry
+	 */
+	static const unsigned int DEFAULT_MAX_TRIANGLES;
+
+	/**
+	 * Opens a cluster file, reading its cluster table
+	 * @param path Absolute path to the file to open
+	 * @param verify (Optional) True if the checksum and indices of every cluster should be verified when it is read.
+	 * Defaults to true.
+	 * @throws InstantiationException If the file could not be read, is of another version or byte order, or its
+	 * cluster table is corrupt
+	 */
+	ClusterFile(const std::string& path, bool verify = true);
+
+	/**
+	 * Constructor
+	 * @param file Cluster file to copy from
+	 */
+	ClusterFile(const ClusterFile& file) = delete;
+
+	/**
+	 * Destructor
+	 */
+	~ClusterFile();
+
+	/**
+	 * Assignment operator
+	 * @param file Cluster file to assign from
+	 */
+	ClusterFile& operator=(const ClusterFile& file) = delete;
+
+	/**
+	 * @return The vertex attributes shared by all clusters
+	 */
+	const GeometryAttributes& getAttributes() const;
+
+	/**
+	 * @return The number of clusters
+	 */
+	unsigned int getNumClusters() const;
+
+	/**
+	 * @param index Cluster index
+	 * @return Description of the cluster
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	const ClusterInfo& getCluster(unsigned int index) const;
+
+	/**
+	 * @return The largest number of vertices held by any cluster
+	 */
+	unsigned int getMaxClusterVertices() const;
+
+	/**
+	 * @return The largest number of indices held by any cluster
+	 */
+	unsigned int getMaxClusterIndices() const;
+
+	/**
+	 * @return The box bounding every cluster
+	 */
+	const Box& getBounds() const;
+
+	/**
+	 * Reads the data of a single cluster. Safe to call from several threads at once.
+	 * @param index Cluster index
+	 * @param vertexData Vector in which to store the interleaved vertex data of the cluster
+	 * @param indices Vector in which to store the triangle list of the cluster, indexing its own vertices
+	 * @throws OutOfBoundsException If the index is out of range
+	 * @throws InstantiationException If the cluster is corrupt
+	 */
+	void readCluster(unsigned int index, std::vector<float>& vertexData, std::vector<unsigned int>& indices) const;
+
+	/**
+	 * Writes a cluster file, generating one cluster at a time, so that meshes far larger than memory can be written
+	 * as long as each cluster fits. Clusters should be spatially coherent, and are stored in the order they are
+	 * generated.
+	 * @param path Absolute path to the file to write
+	 * @param attributes Vertex attributes of every cluster
+	 * @param numClusters The number of clusters to write
+	 * @param generator Function generating the data of each cluster
+	 * @throws IllegalArgumentException If a generated cluster holds no triangles, its vertex data does not hold whole
+	 * vertices, or its indices do not form whole triangles
+	 * @throws OutOfBoundsException If a generated index references a vertex outside of its cluster
+	 * @throws InstantiationException If the file could not be written
+	 */
+	static void write(const std::string& path, const GeometryAttributes& attributes, unsigned int numClusters,
+		const ClusterGenerator& generator);
+
+	/**
+	 * Partitions a geometry into spatially coherent clusters and writes them to a cluster file. Triangles are split
+	 * recursively at the median of their centroids along the longest axis, until no cluster holds more than the
+	 * given number of triangles.
+	 * @param path Absolute path to the file to write
+	 * @param geometry Geometry to partition. Must hold vertex positions and a triangle list.
+	 * @param maxTriangles (Optional) Maximum number of triangles per cluster
+	 * @throws NullPointerException If the geometry is null
+	 * @throws IllegalArgumentException If the geometry holds no vertex positions or indices, or the maximum number
+	 * of triangles is 0
+	 * @throws InstantiationException If the file could not be written
+	 */
+	static void write(const std::string& path, const GeometryPtr& geometry,
+		unsigned int maxTriangles = DEFAULT_MAX_TRIANGLES);
+
+private:
+
+	/**
+	 * Mapped contents of the file
+	 */
+	std::unique_ptr<MappedFile> _file;
+
+	/**
+	 * Path of the file, used in error messages
+	 */
+	std::string _path;
+
+	/**
+	 * Boolean flag that, when true, indicates that clusters are verified when read
+	 */
+	bool _verify;
+
+	/**
+	 * Vertex attributes shared by all clusters
+	 */
+	GeometryAttributes _attributes;
+
+	/**
+	 * Descriptions of every cluster
+	 */
+	std::vector<ClusterInfo> _clusters;
+
+	/**
+	 * Byte offsets of the data of every cluster within the file
+	 */
+	std::vector<unsigned long long> _offsets;
+
+	/**
+	 * Checksums of the data of every cluster
+	 */
+	std::vector<unsigned long long> _checksums;
+
+	/**
+	 * The largest number of vertices held by any cluster
+	 */
+	unsigned int _maxVertices = 0;
+
+	/**
+	 * The largest number of indices held by any cluster
+	 */
+	unsigned int _maxIndices = 0;
+
+	/**
+	 * Box bounding every cluster
+	 */
+	Box _bounds;
+};
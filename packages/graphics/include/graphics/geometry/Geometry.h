@@ -1,10 +1,16 @@
 #pragma once
 #include <graphics/geometry/pointers/GeometryPtr.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/geometry/NormalWeighting.h>
+#include <graphics/core/BufferUsage.h>
+#include <math/Box.h>
+#include <math/Sphere.h>
+#include <memory>
+#include <vector>
 
 class Vector2;
 class Vector3;
 class Color;
-class GeometryAttributes;
 class Buffer;
 
 /**
@@ -16,6 +22,10 @@ class Geometry
 {
 public:
 
+	friend class ClusterFile;
+	friend class MeshFile;
+	friend class MeshSimplifier;
+
 	/**
 	 * Destructor
 	 */
@@ -35,6 +45,21 @@ public:
 	 */
 	void setVertices(const float* vertices, unsigned int numVertices);
 
+	/**
+	 * Sets all vertex attributes of this geometry from a single block of pre-interleaved vertex data, replacing any
+	 * attributes previously set. The data is uploaded to the GPU as-is, so no intermediate copies are made when the
+	 * vector is moved in. If the indices of this geometry have not yet been set, they will be initialized to match
+	 * the number of vertices.
+	 * @param layout Attributes present in the vertex data. Each vertex holds a position, followed by the normal,
+	 * color, and texture coordinates when present.
+	 * @param vertexData Interleaved vertex data. Its size must be a multiple of the stride of the layout.
+	 * @param retainAttributes True if the per-attribute arrays (vertices, normals, colors, and texture coordinates)
+	 * should also be unpacked, so that they can be queried. When false, they remain null and only the interleaved
+	 * data is kept in memory.
+	 */
+	void setInterleavedVertices(const GeometryAttributes& layout, std::vector<float> vertexData,
+		bool retainAttributes = false);
+
 	/**
 	 * Sets the vertex indices of this geometry.
 	 * @param indices An array whose values represent the index order of vertex positions, normals, and texture coordinates.
@@ -42,11 +67,62 @@ public:
 	 */
 	void setIndices(const unsigned int* indices, unsigned int numIndices);
 
+	/**
+	 * Moves the vertices of this geometry to new positions, updating the indices to match. Several vertices may be
+	 * moved to the same position, in which case the first of them is kept.
+	 * @param remap Array holding the new position of each vertex, with one entry per vertex of this geometry
+	 * @param numVertices The number of vertices after remapping
+	 * @throws OutOfBoundsException If a vertex is moved outside of the new range of vertices
+	 */
+	void remapVertices(const unsigned int* remap, unsigned int numVertices);
+
 	/**
 	 * @return The total number of indices in this geometry
 	 */
 	unsigned int size() const;
 
+	/**
+	 * @return The number of vertices in this geometry
+	 */
+	unsigned int getNumVertices() const;
+
+	/**
+	 * @return The vertex positions of this geometry. Can be null.
+	 */
+	const Vector3* getVertices() const;
+
+	/**
+	 * @return The interleaved vertex data of this geometry. Is null unless the vertex data was set via
+	 * setInterleavedVertices, and no individual attribute has been modified since.
+	 */
+	const float* getInterleavedVertices() const;
+
+	/**
+	 * @return The vertex indices of this geometry. Can be null.
+	 */
+	const unsigned int* getIndices() const;
+
+	/**
+	 * @return The vertex normals of this geometry. Can be null.
+	 */
+	const Vector3* getNormals() const;
+
+	/**
+	 * @return The vertex colors of this geometry. Can be null.
+	 */
+	const Color* getColors() const;
+
+	/**
+	 * @return The vertex texture coordinates of this geometry. Can be null.
+	 */
+	const Vector2* getTextureCoords() const;
+
+	/**
+	 * @return A counter that is incremented every time the vertex data of this geometry changes. Can be used by
+	 * consumers of this geometry to detect when their derived data is out-of-date.
+	 */
+	unsigned int getVersion() const;
+
 	/**
 	 * Sets the normal vectors for vertices in this geometry.
 	 * @param normals An array where every 3 values represent the x, y, and z components of a vector.
@@ -89,12 +165,169 @@ public:
 	void removeTextureCoords();
 
 	/**
-	 * @return An object describing the attributes that make up this geometry
+	 * Overwrites a range of vertex positions. Unlike setVertices, the GPU buffer is updated in place by uploading
+	 * only the modified range the next time this geometry is rendered.
+	 * @param first Index of the first vertex to overwrite
+	 * @param vertices An array where every 3 values represents the x, y, and z components of a vertex.
+	 * @param count The number of vertices in the array
+	 * @throws OutOfBoundsException If the range lies outside of this geometry
+	 */
+	void updateVertices(unsigned int first, const float* vertices, unsigned int count);
+
+	/**
+	 * Overwrites a range of vertex normals, updating the GPU buffer in place
+	 * @param first Index of the first vertex to overwrite
+	 * @param normals An array where every 3 values represent the x, y, and z components of a vector.
+	 * @param count The number of normals in the array
+	 * @throws OutOfBoundsException If the range lies outside of this geometry
+	 * @throws IllegalArgumentException If this geometry has no vertex normals
+	 */
+	void updateNormals(unsigned int first, const float* normals, unsigned int count);
+
+	/**
+	 * Overwrites a range of vertex colors, updating the GPU buffer in place
+	 * @param first Index of the first vertex to overwrite
+	 * @param colors An array where every 4 values represent the r, g, b, and a components of a color.
+	 * @param count The number of colors in the array
+	 * @throws OutOfBoundsException If the range lies outside of this geometry
+	 * @throws IllegalArgumentException If this geometry has no vertex colors
+	 */
+	void updateColors(unsigned int first, const float* colors, unsigned int count);
+
+	/**
+	 * Overwrites a range of texture coordinates, updating the GPU buffer in place
+	 * @param first Index of the first vertex to overwrite
+	 * @param uvs An array where every 2 values represents the u and v components of a texture coordinate.
+	 * @param count The number of texture coordinates in the array
+	 * @throws OutOfBoundsException If the range lies outside of this geometry
+	 * @throws IllegalArgumentException If this geometry has no texture coordinates
+	 */
+	void updateTextureCoords(unsigned int first, const float* uvs, unsigned int count);
+
+	/**
+	 * Overwrites a range of interleaved vertex data, updating the GPU buffer in place
+	 * @param first Index of the first vertex to overwrite
+	 * @param vertexData Interleaved vertex data, in the layout given to setInterleavedVertices
+	 * @param count The number of vertices in the array
+	 * @throws OutOfBoundsException If the range lies outside of this geometry
+	 * @throws IllegalArgumentException If this geometry does not hold interleaved vertex data
+	 */
+	void updateInterleavedVertices(unsigned int first, const float* vertexData, unsigned int count);
+
+	/**
+	 * @return True if this geometry shares its GPU buffer with other geometries holding identical content, via the
+	 * GeometryRegistry. Defaults to false, except for procedural primitives.
+	 */
+	bool isBufferSharing() const;
+
+	/**
+	 * Sets whether this geometry shares its GPU buffer with other geometries holding identical content. Only
+	 * static geometry is shared. Shared buffers are never modified in place, so any change to the vertex data or
+	 * indices of this geometry acquires a new buffer on the next render.
+	 * @param sharing True if the GPU buffer should be shared
+	 */
+	void setBufferSharing(bool sharing);
+
+	/**
+	 * @return True if the current GPU buffer of this geometry was acquired from the GeometryRegistry, and may be
+	 * referenced by other geometries
+	 */
+	bool isBufferShared() const;
+
+	/**
+	 * @return Expected update frequency of the vertex data of this geometry. Defaults to static.
+	 */
+	BufferUsage getUsage() const;
+
+	/**
+	 * Sets the expected update frequency of the vertex data of this geometry. Geometry that is modified every frame,
+	 * such as CPU-deformed meshes, should use stream usage so that updates never stall on the GPU.
+	 * @param usage Expected update frequency
+	 */
+	void setUsage(BufferUsage usage);
+
+	/**
+	 * @return GPU storage format of the vertex normals. Defaults to 32-bit floats.
+	 */
+	AttributeFormat getNormalFormat() const;
+
+	/**
+	 * Sets the GPU storage format of the vertex normals. Packed 10-bit normals use a third of the memory of floats,
+	 * with an angular error well below what is visible in lighting.
+	 * @param format Storage format
+	 * @throws IllegalArgumentException If normals do not support the format
+	 */
+	void setNormalFormat(AttributeFormat format);
+
+	/**
+	 * @return GPU storage format of the vertex colors. Defaults to 32-bit floats.
+	 */
+	AttributeFormat getColorFormat() const;
+
+	/**
+	 * Sets the GPU storage format of the vertex colors. Unsigned bytes use a quarter of the memory of floats, but
+	 * high dynamic range colors should use floats or half floats.
+	 * @param format Storage format
+	 * @throws IllegalArgumentException If colors do not support the format
+	 */
+	void setColorFormat(AttributeFormat format);
+
+	/**
+	 * @return GPU storage format of the texture coordinates. Defaults to 32-bit floats.
+	 */
+	AttributeFormat getTextureCoordFormat() const;
+
+	/**
+	 * Sets the GPU storage format of the texture coordinates. Half floats use half the memory of floats, but
+	 * coordinates that repeat far outside of the range 0 to 1 should keep floats, as half floats lose precision as
+	 * values grow.
+	 * @param format Storage format
+	 * @throws IllegalArgumentException If texture coordinates do not support the format
+	 */
+	void setTextureCoordFormat(AttributeFormat format);
+
+	/**
+	 * @return An object describing the attributes that make up this geometry, and their storage formats
 	 */
 	const GeometryAttributes getAttributes() const;
 
 	/**
-	 * @return The GPU buffer for this geometry, creating it if it does not yet exist. This method should typically only
+	 * @return A sphere bounding the vertex positions of this geometry, in local space. The sphere is computed the first
+	 * time it is requested and cached until the vertex positions change. Is empty if this geometry has no vertices.
+	 */
+	const Sphere& getBoundingSphere();
+
+	/**
+	 * @return An axis-aligned box bounding the vertex positions of this geometry, in local space. The box is computed
+	 * the first time it is requested and cached until the vertex positions change. Is empty if this geometry has no
+	 * vertices.
+	 */
+	const Box& getBounds();
+
+	/**
+	 * Computes smooth vertex normals from the vertex positions and indices, replacing any normals previously set.
+	 * Vertices shared by several triangles blend the normals of all of them, so hard edges must be split into
+	 * separate vertices first. Interleaved vertex data remains interleaved. Does nothing if the normals were already
+	 * computed with the same weighting and the vertex data has not changed since.
+	 * @param weighting (Optional) How the normals of triangles are weighted. Defaults to angle weighting.
+	 * @throws IllegalArgumentException If this geometry holds no vertex positions
+	 * @throws OutOfBoundsException If an index references a vertex outside of this geometry
+	 */
+	void computeVertexNormals(NormalWeighting weighting = NormalWeighting::ANGLE);
+
+	/**
+	 * @return Per-vertex tangents for normal mapping, compatible with MikkTSpace, as 4 floats per vertex: the unit
+	 * tangent followed by the sign of the bitangent, such that bitangent = sign * cross(normal, tangent). Tangents
+	 * are computed the first time they are requested and cached until the vertex data changes.
+	 * @throws IllegalArgumentException If this geometry holds no vertex normals or texture coordinates
+	 * @throws OutOfBoundsException If an index references a vertex outside of this geometry
+	 */
+	const float* getTangents();
+
+	/**
+	 * @return The GPU buffer for this geometry, creating it if it does not yet exist. Pending changes are uploaded
+	 * first; ranges modified in place are written into the existing buffer, while changes to the vertex layout or
+	 * the number of vertices or indices recreate it. This method should typically only
 	 * be called by the renderer.
 	 */
 	Buffer* getBuffer();
@@ -155,17 +388,209 @@ protected:
 	unsigned int _numUVs = 0;
 
 	/**
-	 * The GPU buffer for this geometry. Will not be constructed until the first time this geometry is rendered.
+	 * Pre-interleaved vertex data, laid out as described by _layout. Empty unless set via setInterleavedVertices.
 	 */
-	Buffer* _buffer = nullptr;
+	std::vector<float> _interleaved;
+
+	/**
+	 * Attributes present in the interleaved vertex data
+	 */
+	GeometryAttributes _layout;
+
+	/**
+	 * The GPU buffer for this geometry. Will not be constructed until the first time this geometry is rendered. May
+	 * be shared with other geometries holding identical content.
+	 */
+	std::shared_ptr<Buffer> _buffer;
+
+	/**
+	 * Boolean flag that, when true, indicates that the GPU buffer should be acquired from the GeometryRegistry
+	 */
+	bool _bufferSharing = false;
+
+	/**
+	 * Boolean flag that, when true, indicates that the current GPU buffer was acquired from the GeometryRegistry
+	 */
+	bool _bufferShared = false;
+
+	/**
+	 * Expected update frequency of the vertex data
+	 */
+	BufferUsage _usage = BufferUsage::STATIC;
+
+	/**
+	 * GPU storage format of the vertex normals
+	 */
+	AttributeFormat _normalFormat = AttributeFormat::FLOAT;
+
+	/**
+	 * GPU storage format of the vertex colors
+	 */
+	AttributeFormat _colorFormat = AttributeFormat::FLOAT;
+
+	/**
+	 * GPU storage format of the texture coordinates
+	 */
+	AttributeFormat _uvFormat = AttributeFormat::FLOAT;
+
+	/**
+	 * Index of the first vertex modified since the last upload
+	 */
+	unsigned int _dirtyBegin = 0;
+
+	/**
+	 * Index one past the last vertex modified since the last upload. No vertices are modified if this is not
+	 * greater than _dirtyBegin.
+	 */
+	unsigned int _dirtyEnd = 0;
+
+	/**
+	 * Boolean flag that, when true, indicates that the indices have been modified since the last upload
+	 */
+	bool _indicesDirty = false;
+
+	/**
+	 * Boolean flag that, when true, indicates that the GPU buffer must be recreated, as its layout, size, or usage
+	 * no longer match this geometry
+	 */
+	bool _bufferNeedsRebuild = false;
+
+	/**
+	 * Cached bounding sphere of the vertex positions
+	 */
+	Sphere _boundingSphere;
+
+	/**
+	 * Boolean flag that, when true, indicates that the vertex positions have changed since the bounding sphere
+	 * was last computed
+	 */
+	bool _boundingSphereNeedsUpdate = true;
+
+	/**
+	 * Cached bounding box of the vertex positions
+	 */
+	Box _bounds;
+
+	/**
+	 * Boolean flag that, when true, indicates that the vertex positions have changed since the bounding box was last
+	 * computed
+	 */
+	bool _boundsNeedUpdate = true;
+
+	/**
+	 * Version of the vertex data for which normals were last computed by computeVertexNormals
+	 */
+	unsigned int _normalsVersion = 0;
+
+	/**
+	 * Weighting with which normals were last computed
+	 */
+	NormalWeighting _normalWeighting = NormalWeighting::ANGLE;
+
+	/**
+	 * Cached tangents, holding 4 floats per vertex. Empty until requested.
+	 */
+	std::vector<float> _tangents;
+
+	/**
+	 * Version of the vertex data for which the tangents were computed
+	 */
+	unsigned int _tangentsVersion = 0;
+
+	/**
+	 * Counter incremented every time the vertex data of this geometry changes
+	 */
+	unsigned int _version = 0;
 
 	/**
 	 * Constructor
 	 */
 	Geometry();
 
+	/**
+	 * @param index Vertex index
+	 * @return The position of the vertex, read from either the vertex array or the interleaved vertex data
+	 */
+	Vector3 getPosition(unsigned int index) const;
+
+	/**
+	 * Locates the values of an attribute, in either its per-attribute array or the interleaved vertex data
+	 * @param values Per-attribute array, or null if the attribute is only held in the interleaved vertex data
+	 * @param numComponents The number of values making up the attribute
+	 * @param offset Position of the attribute within each interleaved vertex, in floats
+	 * @param stride Set to the number of floats between the values of consecutive vertices
+	 * @return The values of the first vertex
+	 */
+	const float* getAttributeData(const float* values, unsigned int numComponents, unsigned int offset,
+		unsigned int& stride) const;
+
+	/**
+	 * Unpacks the interleaved vertex data into the per-attribute arrays that have not yet been set
+	 */
+	void unpackInterleaved();
+
+	/**
+	 * Discards the interleaved vertex data, first unpacking it so that no attributes are lost. Called before any
+	 * individual attribute is modified.
+	 */
+	void releaseInterleaved();
+
+	/**
+	 * Ensures a range of vertices lies within this geometry
+	 * @param first Index of the first vertex
+	 * @param count The number of vertices
+	 * @throws OutOfBoundsException If the range lies outside of this geometry
+	 */
+	void assertRange(unsigned int first, unsigned int count) const;
+
+	/**
+	 * Writes the values of a single attribute for a range of vertices into the interleaved vertex data, if present
+	 * @param first Index of the first vertex
+	 * @param count The number of vertices
+	 * @param offset Position of the attribute within each vertex, in floats
+	 * @param numComponents The number of values making up the attribute
+	 * @param values Attribute values
+	 */
+	void writeInterleaved(unsigned int first, unsigned int count, unsigned int offset, unsigned int numComponents,
+		const float* values);
+
+	/**
+	 * Extends the range of vertices to upload on the next render
+	 * @param first Index of the first modified vertex
+	 * @param count The number of modified vertices
+	 */
+	void markVerticesDirty(unsigned int first, unsigned int count);
+
+	/**
+	 * Determines how the GPU buffer must be updated after an attribute has been replaced in full
+	 * @param previousAttributes Attributes of this geometry before the change
+	 * @param previousNumVertices The number of vertices before the change
+	 */
+	void onVerticesReplaced(const GeometryAttributes& previousAttributes, unsigned int previousNumVertices);
+
+	/**
+	 * Uploads the modified range of vertices into the existing GPU buffer
+	 */
+	void uploadVertices();
+
 	/**
 	 * Constructs and stores the GPU buffer for this geometry using the attributes currently set on this geometry
 	 */
 	void createBuffer();
+
+	/**
+	 * Replaces the GPU buffer of this geometry, acquiring it from the GeometryRegistry if sharing is enabled
+	 * @param attribs Vertex attributes
+	 * @param vData Interleaved vertex data
+	 * @param vSize The number of values in the vertex data array
+	 */
+	void setBuffer(const GeometryAttributes& attribs, const float* vData, unsigned int vSize);
+
+	/**
+	 * Interleaves the per-attribute arrays of a range of vertices
+	 * @param first Index of the first vertex
+	 * @param count The number of vertices
+	 * @param vData Destination array, large enough to hold the interleaved data
+	 */
+	void interleave(unsigned int first, unsigned int count, float* vData) const;
 };
\ No newline at end of file
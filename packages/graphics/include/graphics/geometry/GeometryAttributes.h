@@ -1,4 +1,5 @@
 #pragma once
+#include <graphics/geometry/AttributeFormat.h>
 
 /**
  * A class describing all of the attributes that are present on a geometry
@@ -23,12 +24,39 @@ public:
 	 */
 	bool uvs = false;
 
+	/**
+	 * GPU storage format of vertex normals. Defaults to 32-bit floats.
+	 */
+	AttributeFormat normalFormat = AttributeFormat::FLOAT;
+
+	/**
+	 * GPU storage format of vertex colors. Defaults to 32-bit floats.
+	 */
+	AttributeFormat colorFormat = AttributeFormat::FLOAT;
+
+	/**
+	 * GPU storage format of vertex texture coordinates. Defaults to 32-bit floats.
+	 */
+	AttributeFormat uvFormat = AttributeFormat::FLOAT;
+
 	/**
 	 * @return The number of floating point values used to represent a single vertex in the geometry, taking into account
 	 * all attributes.
 	 */
 	int getStride() const;
 
+	/**
+	 * @return The number of bytes used to store a single vertex on the GPU, taking into account the storage format
+	 * of each attribute. Each attribute is padded to a multiple of 4 bytes.
+	 */
+	int getVertexSize() const;
+
+	/**
+	 * @return True if every attribute is stored as 32-bit floats, in which case vertex data can be uploaded as-is.
+	 * Returns false otherwise.
+	 */
+	bool isFloatOnly() const;
+
 	/**
 	 * Operator that compares this set of attributes to another and tests for equality
 	 * @param other The set of attributes to compare to
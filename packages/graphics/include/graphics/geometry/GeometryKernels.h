@@ -0,0 +1,87 @@
+#pragma once
+#include <graphics/geometry/NormalWeighting.h>
+#include <math/Box.h>
+#include <math/Sphere.h>
+
+/**
+ * Data-parallel kernels computing derived data of indexed triangle lists: bounding volumes, smooth vertex normals,
+ * and tangent frames. Kernels process four vertices or triangles at a time using SSE when the target supports it,
+ * and split inputs larger than PARALLEL_THRESHOLD across worker threads. Results do not depend on the number of
+ * threads. Attribute arrays are read with a stride, so kernels can run on both per-attribute arrays and interleaved
+ * vertex data.
+ * @author Nathaniel Rex
+ */
+class GeometryKernels
+{
+public:
+
+	/**
+	 * The number of vertices or triangles above which a kernel is split across worker threads
+	 */
+	static const unsigned int PARALLEL_THRESHOLD;
+
+	/**
+	 * Computes the axis-aligned box bounding a set of positions
+	 * @param positions Vertex positions, where every vertex starts with its x, y, and z components
+	 * @param numVertices The number of vertices
+	 * @param stride The number of floats between consecutive vertex positions
+	 * @return The bounding box. Is empty if there are no vertices.
+	 */
+	static Box computeBounds(const float* positions, unsigned int numVertices, unsigned int stride);
+
+	/**
+	 * Computes a sphere bounding a set of positions, centered on their bounding box
+	 * @param positions Vertex positions, where every vertex starts with its x, y, and z components
+	 * @param numVertices The number of vertices
+	 * @param stride The number of floats between consecutive vertex positions
+	 * @param bounds Bounding box of the positions, as returned by computeBounds
+	 * @return The bounding sphere, whose radius reaches the position furthest from the center of the box. Is empty if
+	 * there are no vertices.
+	 */
+	static Sphere computeBoundingSphere(const float* positions, unsigned int numVertices, unsigned int stride,
+		const Box& bounds);
+
+	/**
+	 * Computes smooth vertex normals by accumulating the weighted normals of the triangles sharing each vertex.
+	 * Vertices that are not referenced by any non-degenerate triangle receive a zero normal.
+	 * @param positions Vertex positions, where every vertex starts with its x, y, and z components
+	 * @param numVertices The number of vertices
+	 * @param stride The number of floats between consecutive vertex positions
+	 * @param indices Triangle list. Indices beyond the last whole triangle are ignored.
+	 * @param numIndices The number of indices
+	 * @param weighting How the normals of triangles are weighted
+	 * @param normals Destination array of 3 floats per vertex
+	 * @throws OutOfBoundsException If an index references a vertex outside of the given range
+	 */
+	static void computeVertexNormals(const float* positions, unsigned int numVertices, unsigned int stride,
+		const unsigned int* indices, unsigned int numIndices, NormalWeighting weighting, float* normals);
+
+	/**
+	 * Computes per-vertex tangents for normal mapping, following MikkTSpace: the texture space u direction of each
+	 * triangle is projected onto the tangent plane of each vertex normal and accumulated weighted by the corner angle
+	 * within that plane, and the handedness of the bitangent follows the orientation of the triangles in texture
+	 * space. Results match MikkTSpace for meshes whose vertices are already split along texture seams and mirrored
+	 * regions, as shared vertices hold a single tangent frame. Vertices without a valid texture space receive an
+	 * arbitrary tangent perpendicular to their normal.
+	 * @param positions Vertex positions, where every vertex starts with its x, y, and z components
+	 * @param positionStride The number of floats between consecutive vertex positions
+	 * @param normals Unit vertex normals, where every vertex starts with its x, y, and z components
+	 * @param normalStride The number of floats between consecutive vertex normals
+	 * @param uvs Texture coordinates, where every vertex starts with its u and v components
+	 * @param uvStride The number of floats between consecutive texture coordinates
+	 * @param numVertices The number of vertices
+	 * @param indices Triangle list. Indices beyond the last whole triangle are ignored.
+	 * @param numIndices The number of indices
+	 * @param tangents Destination array of 4 floats per vertex: the unit tangent, followed by the sign of the
+	 * bitangent, such that bitangent = sign * cross(normal, tangent)
+	 * @throws OutOfBoundsException If an index references a vertex outside of the given range
+	 */
+	static void computeTangents(const float* positions, unsigned int positionStride, const float* normals,
+		unsigned int normalStride, const float* uvs, unsigned int uvStride, unsigned int numVertices,
+		const unsigned int* indices, unsigned int numIndices, float* tangents);
+
+	/**
+	 * Deleted constructor
+	 */
+	GeometryKernels() = delete;
+};
@@ -0,0 +1,176 @@
+#pragma once
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <vector>
+
+/**
+ * Vertex cache metrics of a triangle list, measured before and after an optimization pass
+ * @author Nathaniel Rex
+ */
+struct GeometryOptimizerStats {
+
+	/**
+	 * Average cache miss ratio (vertex shader invocations per triangle) before optimization. Ranges from 0.5 for
+	 * an ideal mesh to 3 for a mesh that shares no vertices between consecutive triangles.
+	 */
+	float acmrBefore = 0.f;
+
+	/**
+	 * Average cache miss ratio after optimization
+	 */
+	float acmrAfter = 0.f;
+
+	/**
+	 * Average transform to vertex ratio (vertex shader invocations per referenced vertex) before optimization. An
+	 * ideal mesh transforms every vertex exactly once, for a ratio of 1.
+	 */
+	float atvrBefore = 0.f;
+
+	/**
+	 * Average transform to vertex ratio after optimization
+	 */
+	float atvrAfter = 0.f;
+
+	/**
+	 * The number of clusters the triangles were split into for overdraw ordering
+	 */
+	unsigned int numClusters = 0;
+};
+
+/**
+ * Reorders the triangles and vertices of indexed triangle lists for faster rendering. Triangles are first reordered
+ * to reuse the post-transform vertex cache (Tipsify), then grouped into clusters which are sorted so that outward
+ * facing clusters are drawn first to reduce overdraw, and finally vertices are remapped into the order they are first
+ * used to improve vertex fetch locality. A separate weld pass merges duplicate vertices. All passes are
+ * deterministic, so the same input always produces the same output, and can be run when geometry is loaded or ahead
+ * of time.
+ * @author Nathaniel Rex
+ */
+class GeometryOptimizer
+{
+public:
+
+	/**
+	 * Number of entries of the simulated post-transform vertex cache
+	 */
+	static const unsigned int DEFAULT_CACHE_SIZE;
+
+	/**
+	 * Maximum cache miss ratio, relative to the ratio after vertex cache optimization, that overdraw ordering may
+	 * trade for smaller clusters
+	 */
+	static const float DEFAULT_OVERDRAW_THRESHOLD;
+
+	/**
+	 * Maximum difference between the attribute values of vertices merged by welding
+	 */
+	static const float DEFAULT_WELD_TOLERANCE;
+
+	/**
+	 * Runs all passes on the given geometry, replacing its indices and vertex order
+	 * @param geometry Geometry to optimize. Must hold vertex positions and a triangle list.
+	 * @param cacheSize Number of entries of the simulated vertex cache
+	 * @param overdrawThreshold Maximum relative cache miss ratio overdraw ordering may trade for smaller clusters
+	 * @return Vertex cache metrics before and after optimization
+	 * @throws IllegalArgumentException If the geometry holds no indices, or the indices do not form whole triangles
+	 */
+	static GeometryOptimizerStats optimize(const GeometryPtr& geometry, unsigned int cacheSize = DEFAULT_CACHE_SIZE,
+		float overdrawThreshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+	/**
+	 * Merges the vertices of the given geometry whose attributes all match within a tolerance, updating its indices
+	 * to reference the merged vertices
+	 * @param geometry Geometry to weld. Must hold vertex positions.
+	 * @param tolerance Maximum difference between any attribute value of merged vertices
+	 * @return The number of vertices removed
+	 * @throws IllegalArgumentException If the tolerance is negative
+	 */
+	static unsigned int weld(const GeometryPtr& geometry, float tolerance = DEFAULT_WELD_TOLERANCE);
+
+	/**
+	 * Computes a vertex remapping that merges vertices whose attributes all match within a tolerance. Candidates
+	 * are found through a spatial hash of the vertex positions, and every vertex is compared against the first
+	 * vertex of each group, so the output is independent of hashing order.
+	 * @param vertexData Interleaved vertex data, where every vertex starts with its x, y, and z components
+	 * @param numVertices The number of vertices
+	 * @param stride The number of floats per vertex
+	 * @param tolerance Maximum difference between any attribute value of merged vertices
+	 * @param numUnique (Optional) Pointer in which to store the number of vertices after merging
+	 * @return Mapping from the position of each vertex to its merged position. Merged vertices are numbered in order
+	 * of first appearance.
+	 * @throws IllegalArgumentException If the tolerance is negative
+	 */
+	static std::vector<unsigned int> generateWeldRemap(const float* vertexData, unsigned int numVertices,
+		unsigned int stride, float tolerance = DEFAULT_WELD_TOLERANCE, unsigned int* numUnique = nullptr);
+
+	/**
+	 * Reorders triangles to maximize reuse of the post-transform vertex cache, using the Tipsify algorithm
+	 * @param indices Triangle list
+	 * @param numIndices The number of indices
+	 * @param numVertices The number of vertices referenced by the indices
+	 * @param cacheSize Number of entries of the simulated vertex cache
+	 * @return Reordered triangle list
+	 * @throws IllegalArgumentException If the indices do not form whole triangles
+	 * @throws OutOfBoundsException If an index references a vertex outside of the given range
+	 */
+	static std::vector<unsigned int> optimizeVertexCache(const unsigned int* indices, unsigned int numIndices,
+		unsigned int numVertices, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+	/**
+	 * Splits a triangle list into clusters at cache boundaries, and reorders the clusters so that those facing away
+	 * from the center of the mesh are drawn first. Should be run on output of optimizeVertexCache.
+	 * @param indices Triangle list
+	 * @param numIndices The number of indices
+	 * @param positions Vertex positions, where every vertex starts with its x, y, and z components
+	 * @param numVertices The number of vertices
+	 * @param stride The number of floats between consecutive vertex positions
+	 * @param cacheSize Number of entries of the simulated vertex cache
+	 * @param threshold Maximum relative cache miss ratio that may be traded for smaller clusters. A value of 1 keeps
+	 * the cache efficiency of the input, while larger values allow more clusters.
+	 * @param numClusters (Optional) Pointer in which to store the number of clusters
+	 * @return Reordered triangle list
+	 * @throws IllegalArgumentException If the indices do not form whole triangles
+	 * @throws OutOfBoundsException If an index references a vertex outside of the given range
+	 */
+	static std::vector<unsigned int> optimizeOverdraw(const unsigned int* indices, unsigned int numIndices,
+		const float* positions, unsigned int numVertices, unsigned int stride, unsigned int cacheSize = DEFAULT_CACHE_SIZE,
+		float threshold = DEFAULT_OVERDRAW_THRESHOLD, unsigned int* numClusters = nullptr);
+
+	/**
+	 * Computes a vertex remapping that places vertices in the order they are first referenced by a triangle list.
+	 * Unreferenced vertices are moved to the end, keeping their relative order.
+	 * @param indices Triangle list
+	 * @param numIndices The number of indices
+	 * @param numVertices The number of vertices
+	 * @return Mapping from the position of each vertex to its new position
+	 * @throws OutOfBoundsException If an index references a vertex outside of the given range
+	 */
+	static std::vector<unsigned int> optimizeVertexFetch(const unsigned int* indices, unsigned int numIndices,
+		unsigned int numVertices);
+
+	/**
+	 * Computes the average cache miss ratio of a triangle list, simulating a FIFO vertex cache
+	 * @param indices Triangle list
+	 * @param numIndices The number of indices
+	 * @param numVertices The number of vertices referenced by the indices
+	 * @param cacheSize Number of entries of the simulated vertex cache
+	 * @return Vertex shader invocations per triangle. Is 0 if there are no triangles.
+	 */
+	static float getACMR(const unsigned int* indices, unsigned int numIndices, unsigned int numVertices,
+		unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+	/**
+	 * Computes the average transform to vertex ratio of a triangle list, simulating a FIFO vertex cache
+	 * @param indices Triangle list
+	 * @param numIndices The number of indices
+	 * @param numVertices The number of vertices referenced by the indices
+	 * @param cacheSize Number of entries of the simulated vertex cache
+	 * @return Vertex shader invocations per referenced vertex. Is 0 if there are no triangles.
+	 */
+	static float getATVR(const unsigned int* indices, unsigned int numIndices, unsigned int numVertices,
+		unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+	/**
+	 * Deleted constructor
+	 */
+	GeometryOptimizer() = delete;
+};
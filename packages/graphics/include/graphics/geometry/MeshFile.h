@@ -0,0 +1,60 @@
+#pragma once
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Reads and writes the binary mesh cache format (.tfmesh), which stores geometry exactly as it is held in memory so
+ * that it can be loaded without parsing. A file starts with a header and a table describing every geometry (vertex
+ * layout and storage formats, vertex and index counts, and bounding sphere), followed by the interleaved vertex data
+ * and indices of each geometry. Every block is aligned to 64 bytes, so the file can be memory-mapped and its blocks
+ * handed to the GPU as they are. A version number guards against format changes, an endianness tag against files
+ * written on a host with a different byte order, and a checksum over everything following the header against
+ * corruption.
+ * @author Nathaniel Rex
+ */
+class MeshFile
+{
+public:
+
+	/**
+	 * File extension of mesh cache files
+	 */
+	static const std::string EXTENSION;
+
+	/**
+	 * Version of the format written by this class. Files of other versions are rejected.
+	 */
+	static const unsigned int VERSION;
+
+	/**
+	 * Alignment of every block in the file, in bytes
+	 */
+	static const size_t ALIGNMENT;
+
+	/**
+	 * Writes geometries to a mesh cache file. Geometries are stored as they are, so they should already be optimized.
+	 * @param path Absolute path to the file to write
+	 * @param geometries Geometries to store. Each must hold vertex positions and indices.
+	 * @throws IllegalArgumentException If a geometry is null or holds no vertex positions
+	 * @throws InstantiationException If the file could not be written
+	 */
+	static void write(const std::string& path, const std::vector<GeometryPtr>& geometries);
+
+	/**
+	 * Reads the geometries stored in a mesh cache file
+	 * @param path Absolute path to the file to read
+	 * @param verify (Optional) True if the checksum should be verified. Defaults to true.
+	 * @return The stored geometries, in the order they were written. Their bounding spheres are restored from the
+	 * file rather than recomputed.
+	 * @throws InstantiationException If the file could not be read, is of another version or byte order, or is
+	 * corrupt
+	 */
+	static std::vector<GeometryPtr> read(const std::string& path, bool verify = true);
+
+	/**
+	 * Deleted constructor
+	 */
+	MeshFile() = delete;
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <vector>
+
+/**
+ * Reduces the number of triangles of indexed triangle lists for level of detail rendering, by collapsing edges in
+ * order of their quadric error. Edges are only collapsed onto existing vertices, so the simplified triangles index a
+ * subset of the original vertices and every vertex attribute remains valid. Vertices on the border of the mesh may
+ * only slide along the border, and vertices on attribute seams (vertices sharing a position but holding different
+ * normals, colors, or texture coordinates) only along the seam, moving every copy of the vertex together, so that
+ * texture charts and hard edges stay intact. Vertices where borders or seams meet are never moved.
+ *
+ * Errors are estimated from the quadrics as distances relative to the largest extent of the mesh, so an error of 0.01
+ * keeps the surface within roughly 1% of the mesh size. Simplification is deterministic, so the same input always
+ * produces the same output.
+ * @author Nathaniel Rex
+ */
+class MeshSimplifier
+{
+public:
+
+	/**
+	 * Maximum error, relative to the extent of the mesh, of a single simplification
+	 */
+	static const float DEFAULT_TARGET_ERROR;
+
+	/**
+	 * Number of levels of detail generated for a geometry, including the geometry itself
+	 */
+	static const unsigned int DEFAULT_NUM_LEVELS;
+
+	/**
+	 * Fraction of the triangles of a level of detail kept by the next level
+	 */
+	static const float DEFAULT_LEVEL_RATIO;
+
+	/**
+	 * Maximum accumulated error, relative to the extent of the mesh, of the coarsest level of detail
+	 */
+	static const float DEFAULT_MAX_LOD_ERROR;
+
+	/**
+	 * Simplifies a triangle list until it holds no more than the target number of indices, or until any further
+	 * collapse would exceed the target error
+	 * @param indices Triangle list
+	 * @param numIndices The number of indices
+	 * @param positions Vertex positions, where every vertex starts with its x, y, and z components
+	 * @param numVertices The number of vertices
+	 * @param stride The number of floats between consecutive vertex positions
+	 * @param targetIndexCount The number of indices to reduce the triangle list to. When 0, the triangle list is
+	 * simplified as far as the target error allows.
+	 * @param targetError Maximum error of the simplified triangle list, relative to the extent of the mesh
+	 * @param resultError (Optional) Pointer in which to store the error of the simplified triangle list, relative to
+	 * the extent of the mesh
+	 * @return Simplified triangle list, indexing the same vertices as the input
+	 * @throws IllegalArgumentException If the indices do not form whole triangles, or the target error is negative
+	 * @throws OutOfBoundsException If an index references a vertex outside of the given range
+	 */
+	static std::vector<unsigned int> simplify(const unsigned int* indices, unsigned int numIndices,
+		const float* positions, unsigned int numVertices, unsigned int stride, unsigned int targetIndexCount,
+		float targetError = DEFAULT_TARGET_ERROR, float* resultError = nullptr);
+
+	/**
+	 * Creates a simplified copy of a geometry, holding only the vertices referenced by the simplified triangles in
+	 * the order they are first used. The copy keeps the vertex layout, storage formats, and buffer usage of the
+	 * original.
+	 * @param geometry Geometry to simplify. Must hold vertex positions and a triangle list.
+	 * @param targetIndexCount The number of indices to reduce the geometry to. When 0, the geometry is simplified
+	 * as far as the target error allows.
+	 * @param targetError Maximum error of the simplified geometry, relative to its extent
+	 * @param resultError (Optional) Pointer in which to store the error of the simplified geometry, relative to its
+	 * extent
+	 * @return The simplified geometry
+	 * @throws NullPointerException If the geometry is null
+	 * @throws IllegalArgumentException If the geometry holds no vertex positions or indices, or the indices do not
+	 * form whole triangles
+	 */
+	static GeometryPtr simplify(const GeometryPtr& geometry, unsigned int targetIndexCount,
+		float targetError = DEFAULT_TARGET_ERROR, float* resultError = nullptr);
+
+	/**
+	 * Generates a chain of levels of detail for a geometry. Every level is simplified from the previous one,
+	 * keeping the given fraction of its triangles, and optimized for the vertex cache. The chain ends early once
+	 * the accumulated error would exceed the maximum error, or once a level no longer reduces the triangle count
+	 * meaningfully.
+	 * @param geometry Geometry to generate levels of detail for. Must hold vertex positions and a triangle list.
+	 * @param numLevels Maximum number of levels, including the geometry itself
+	 * @param ratio Fraction of the triangles of each level kept by the next level, between 0 and 1
+	 * @param maxError Maximum accumulated error of the coarsest level, relative to the extent of the geometry
+	 * @param errors (Optional) Pointer to a vector in which to store the accumulated error of each level, relative
+	 * to the extent of the geometry. The error of the first level is 0.
+	 * @return The levels of detail from finest to coarsest, starting with the geometry itself
+	 * @throws NullPointerException If the geometry is null
+	 * @throws IllegalArgumentException If the geometry holds no vertex positions or indices, or the ratio is not
+	 * between 0 and 1
+	 */
+	static std::vector<GeometryPtr> generateLODs(const GeometryPtr& geometry, unsigned int numLevels = DEFAULT_NUM_LEVELS,
+		float ratio = DEFAULT_LEVEL_RATIO, float maxError = DEFAULT_MAX_LOD_ERROR, std::vector<float>* errors = nullptr);
+
+	/**
+	 * Generates chains of levels of detail for several geometries, spreading the geometries across worker threads.
+	 * The result matches generating each chain on its own.
+	 * @param geometries Geometries to generate levels of detail for
+	 * @param numLevels Maximum number of levels per geometry, including the geometry itself
+	 * @param ratio Fraction of the triangles of each level kept by the next level, between 0 and 1
+	 * @param maxError Maximum accumulated error of the coarsest level, relative to the extent of each geometry
+	 * @param errors (Optional) Pointer to a vector in which to store the accumulated errors of each chain
+	 * @return The levels of detail of each geometry, in the order the geometries were given
+	 * @throws NullPointerException If a geometry is null
+	 * @throws IllegalArgumentException If a geometry holds no vertex positions or indices, or the ratio is not
+	 * between 0 and 1
+	 */
+	static std::vector<std::vector<GeometryPtr>> generateLODs(const std::vector<GeometryPtr>& geometries,
+		unsigned int numLevels = DEFAULT_NUM_LEVELS, float ratio = DEFAULT_LEVEL_RATIO,
+		float maxError = DEFAULT_MAX_LOD_ERROR, std::vector<std::vector<float>>* errors = nullptr);
+
+	/**
+	 * Deleted constructor
+	 */
+	MeshSimplifier() = delete;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * Enumeration describing how the normals of the triangles sharing a vertex are weighted when computing the normal of
+ * that vertex
+ * @author Nathaniel Rex
+ */
+enum class NormalWeighting
+{
+
+	/**
+	 * Triangles are weighted by their area, so that large triangles dominate. Cheapest to compute.
+	 */
+	AREA,
+
+	/**
+	 * Triangles are weighted by their angle at the vertex, so that the result does not depend on how the surface
+	 * around the vertex is tessellated
+	 */
+	ANGLE
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+class GeometryAttributes;
+
+/**
+ * Converts interleaved 32-bit float vertex data to and from the compact GPU storage formats described by a set of
+ * geometry attributes
+ * @author Nathaniel Rex
+ */
+class VertexPacker
+{
+public:
+
+	/**
+	 * Converts interleaved float vertex data to its GPU storage format
+	 * @param attributes Vertex attributes, including the storage format of each
+	 * @param vertexData Interleaved float vertex data, with a stride of attributes.getStride() floats
+	 * @param numVertices The number of vertices
+	 * @param dst Destination, large enough to hold numVertices * attributes.getVertexSize() bytes
+	 * @throws IllegalArgumentException If an attribute uses a storage format it does not support
+	 */
+	static void pack(const GeometryAttributes& attributes, const float* vertexData, unsigned int numVertices, void* dst);
+
+	/**
+	 * Converts vertex data in its GPU storage format back to interleaved floats
+	 * @param attributes Vertex attributes, including the storage format of each
+	 * @param src Packed vertex data, with a stride of attributes.getVertexSize() bytes
+	 * @param numVertices The number of vertices
+	 * @param vertexData Destination, large enough to hold numVertices * attributes.getStride() floats
+	 * @throws IllegalArgumentException If an attribute uses a storage format it does not support
+	 */
+	static void unpack(const GeometryAttributes& attributes, const void* src, unsigned int numVertices, float* vertexData);
+
+	/**
+	 * Converts a 32-bit float to a 16-bit float, rounding to the nearest representable value
+	 * @param value Value to convert
+	 * @return The bits of the 16-bit float
+	 */
+	static unsigned short toHalf(float value);
+
+	/**
+	 * Converts a 16-bit float to a 32-bit float
+	 * @param bits The bits of the 16-bit float
+	 * @return The converted value
+	 */
+	static float fromHalf(unsigned short bits);
+
+	/**
+	 * Packs a unit vector into three signed, normalized 10-bit components
+	 * @param x X component
+	 * @param y Y component
+	 * @param z Z component
+	 * @return The packed vector, in GL_INT_2_10_10_10_REV layout
+	 */
+	static unsigned int packNormal(float x, float y, float z);
+
+	/**
+	 * Unpacks a vector previously packed via packNormal
+	 * @param packed The packed vector
+	 * @param normal Destination for the x, y, and z components
+	 */
+	static void unpackNormal(unsigned int packed, float* normal);
+
+	/**
+	 * Deleted constructor
+	 */
+	VertexPacker() = delete;
+};
@@ -15,10 +15,16 @@ public:
 	 */
 	static PointLightPtr create();
 
+	/**
+	 * Distance beyond which the light has no effect. Its contribution fades smoothly to 0 at that distance. A range
+	 * of 0 lets the light reach everything without falling off. Defaults to 0.
+	 */
+	float range;
+
 private:
 
 	/**
 	 * Constructor
 	 */
-	PointLight() : Light(LightType::POINT) {}
+	PointLight() : Light(LightType::POINT), range(0.f) {}
 };
\ No newline at end of file
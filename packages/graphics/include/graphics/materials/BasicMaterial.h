@@ -23,6 +23,13 @@ public:
 	 */
 	static BasicMaterialPtr create();
 
+	/**
+	 * @override
+	 * @return True if both materials can be drawn together, and agree on the use of vertex colors. Returns false
+	 * otherwise.
+	 */
+	bool canBatchWith(const Material& other) const override;
+
 private:
 
 	/**
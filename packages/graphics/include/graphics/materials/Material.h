@@ -1,7 +1,9 @@
 #pragma once
 #include <graphics/materials/MaterialType.h>
 #include <graphics/textures/pointers/TexturePtr.h>
+#include <graphics/textures/pointers/TextureArrayPtr.h>
 #include <graphics/core/Color.h>
+#include <math/Vector2.h>
 
 /**
  * Base class for all materials that define the appearance of objects in a scene.
@@ -38,11 +40,41 @@ public:
 	 */
 	TexturePtr texture = nullptr;
 
+	/**
+	 * Texture array, sampled instead of the texture. Can be null.
+	 */
+	TextureArrayPtr textureArray = nullptr;
+
+	/**
+	 * Layer of the texture array to sample. Instanced meshes add the layer of every instance to this layer.
+	 */
+	unsigned int textureLayer = 0;
+
+	/**
+	 * Offset added to texture coordinates after scaling them, which selects the region of a texture atlas to sample.
+	 * Defaults to (0, 0).
+	 */
+	Vector2 uvOffset = Vector2(0.f, 0.f);
+
+	/**
+	 * Scale applied to texture coordinates. Defaults to (1, 1).
+	 */
+	Vector2 uvScale = Vector2(1.f, 1.f);
+
 	/**
 	 * Destructor
 	 */
 	virtual ~Material() = default;
 
+	/**
+	 * Determines whether meshes using this material and meshes using another material can be merged into a single
+	 * draw call. This is the case if both materials look the same once their texture coordinate transformations are
+	 * baked into vertices.
+	 * @param other Material
+	 * @return True if both materials can be drawn together. Returns false otherwise.
+	 */
+	virtual bool canBatchWith(const Material& other) const;
+
 protected:
 
 	/**
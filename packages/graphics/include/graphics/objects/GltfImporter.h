@@ -0,0 +1,31 @@
+#pragma once
+#include <graphics/core/pointers/EntityGroupPtr.h>
+#include <graphics/objects/MeshLoaderOptions.h>
+#include <string>
+
+/**
+ * Imports glTF 2.0 files, in either the JSON (.gltf) or binary (.glb) container. Buffers may be embedded as base64
+ * data URIs, stored in the binary chunk, or stored in external files next to the imported file, which are
+ * memory-mapped. The node hierarchy of the default scene is rebuilt from entity groups and meshes, and the geometry of
+ * every triangle primitive is built in parallel by reading accessors directly into interleaved vertex data. Materials
+ * keep their base color factor, while textures are not loaded.
+ * @author Nathaniel Rex
+ */
+class GltfImporter
+{
+public:
+
+	/**
+	 * Loads a glTF file into a new entity group
+	 * @param path Absolute path to the .gltf or .glb file
+	 * @param options Import options
+	 * @return An entity group holding the root nodes of the default scene
+	 * @throws InstantiationException If the file or one of its buffers could not be read, or is malformed
+	 */
+	static EntityGroupPtr load(const std::string& path, const MeshLoaderOptions& options);
+
+	/**
+	 * Deleted constructor
+	 */
+	GltfImporter() = delete;
+};
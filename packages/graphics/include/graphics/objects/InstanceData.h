@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * Per-instance attributes of an instanced mesh, laid out exactly as they are uploaded to the GPU. Each instance
+ * occupies 56 bytes.
+ * @author Nathaniel Rex
+ */
+struct InstanceData {
+
+	/**
+	 * Transformation of the instance relative to its instanced mesh, stored as the first three rows of a row-major
+	 * 4x4 matrix. The last row is implicitly (0, 0, 0, 1).
+	 */
+	float transform[12];
+
+	/**
+	 * RGBA color of the instance, multiplied with the color of the material. Each value is in the range 0 to 255, and
+	 * normalized to the range 0 to 1 by the GPU.
+	 */
+	unsigned char color[4];
+
+	/**
+	 * Texture array layer sampled by the instance, added to the layer of the material
+	 */
+	float layer;
+};
+
+static_assert(sizeof(InstanceData) == 56, "InstanceData is expected to occupy exactly 56 bytes");
@@ -0,0 +1,195 @@
+#pragma once
+#include <graphics/objects/pointers/InstancedMeshPtr.h>
+#include <graphics/objects/InstanceData.h>
+#include <graphics/core/Entity.h>
+#include <graphics/core/Color.h>
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <graphics/materials/pointers/MaterialPtr.h>
+#include <vector>
+
+class Frustum;
+class InstanceBuffer;
+
+/**
+ * A triangulated polyface mesh that is drawn many times in a single draw call, once per instance. Every instance
+ * shares the same geometry and material, but has its own transformation and color. This is far cheaper than creating
+ * a separate mesh entity for each placement of the same geometry.
+ * @author Nathaniel Rex
+ */
+class InstancedMesh : public Entity
+{
+public:
+
+	/**
+	 * Geometry shared by all instances. The points of this geometry are assumed to form a series of triangles.
+	 */
+	GeometryPtr geometry;
+
+	/**
+	 * Material shared by all instances
+	 */
+	MaterialPtr material;
+
+	/**
+	 * Flag that, when true, causes instances lying outside of the camera view to be skipped when rendering.
+	 * Defaults to true.
+	 */
+	bool frustumCulled = true;
+
+	/**
+	 * Destructor
+	 */
+	~InstancedMesh();
+
+	/**
+	 * Constructs a new instanced mesh. All instances start with an identity transformation, a white color, and
+	 * layer 0.
+	 * @param geometry Geometry whose points are expected to form a series of triangles
+	 * @param material Material
+	 * @param count Number of instances
+	 * @return The new instanced mesh
+	 */
+	static InstancedMeshPtr create(GeometryPtr geometry, MaterialPtr material, unsigned int count);
+
+	/**
+	 * @return The number of instances
+	 */
+	unsigned int getCount() const;
+
+	/**
+	 * @return The per-instance data of all instances, as a contiguous array
+	 */
+	const InstanceData* getInstances() const;
+
+	/**
+	 * Gets the transformation of an instance
+	 * @param index Instance index
+	 * @return The transformation of the instance relative to this mesh
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	Matrix4 getTransform(unsigned int index) const;
+
+	/**
+	 * Sets the transformation of an instance
+	 * @param index Instance index
+	 * @param transform Transformation of the instance relative to this mesh. The last row of the matrix is assumed
+	 * to be (0, 0, 0, 1).
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	void setTransform(unsigned int index, const Matrix4& transform);
+
+	/**
+	 * Gets the color of an instance
+	 * @param index Instance index
+	 * @return The color of the instance
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	Color getColor(unsigned int index) const;
+
+	/**
+	 * Sets the color of an instance. This color is multiplied with the color of the material. Each channel is stored
+	 * with 8 bits of precision.
+	 * @param index Instance index
+	 * @param color Instance color
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	void setColor(unsigned int index, const Color& color);
+
+	/**
+	 * Gets the texture array layer of an instance
+	 * @param index Instance index
+	 * @return The layer of the instance
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	unsigned int getLayer(unsigned int index) const;
+
+	/**
+	 * Sets the texture array layer of an instance. This layer is added to the layer of the material, so that instances
+	 * differing only in their texture can be drawn together.
+	 * @param index Instance index
+	 * @param layer Instance layer
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	void setLayer(unsigned int index, unsigned int layer);
+
+	/**
+	 * Overwrites a contiguous range of instances at once. Only this range will be re-uploaded to the GPU.
+	 * @param first Index of the first instance to overwrite
+	 * @param data Array of per-instance data
+	 * @param count The number of instances in the array
+	 * @throws OutOfBoundsException If the range extends past the last instance
+	 */
+	void setInstances(unsigned int first, const InstanceData* data, unsigned int count);
+
+	/**
+	 * Determines which instances lie within a frustum. The indices of the visible instances can then be obtained
+	 * via getVisibleInstances(). If frustum culling is disabled for this mesh, all instances are considered visible.
+	 * @param frustum Frustum, in world space
+	 * @param modelTransform Local-to-world transformation of this mesh
+	 * @return The number of visible instances
+	 */
+	unsigned int cull(const Frustum& frustum, const Matrix4& modelTransform);
+
+	/**
+	 * @return The indices of the instances found to be visible by the last call to cull()
+	 */
+	const std::vector<unsigned int>& getVisibleInstances() const;
+
+	/**
+	 * @return The GPU buffer holding the per-instance data, creating it if it does not yet exist. Any instances
+	 * modified since the last call are uploaded before returning. This method should typically only be called by
+	 * the renderer.
+	 */
+	InstanceBuffer* getBuffer();
+
+private:
+
+	/**
+	 * Per-instance data
+	 */
+	std::vector<InstanceData> _instances;
+
+	/**
+	 * Indices of the instances found to be visible by the last call to cull()
+	 */
+	std::vector<unsigned int> _visible;
+
+	/**
+	 * Index of the first instance modified since the last upload to the GPU
+	 */
+	unsigned int _dirtyBegin = 0;
+
+	/**
+	 * One past the index of the last instance modified since the last upload to the GPU. Equal to the dirty
+	 * beginning index if nothing has been modified.
+	 */
+	unsigned int _dirtyEnd = 0;
+
+	/**
+	 * The GPU buffer holding the per-instance data. Will not be constructed until the first time this mesh
+	 * is rendered.
+	 */
+	InstanceBuffer* _buffer = nullptr;
+
+	/**
+	 * Constructor
+	 * @param geometry Geometry whose points are expected to form a series of triangles
+	 * @param material Material
+	 * @param count Number of instances
+	 */
+	InstancedMesh(GeometryPtr geometry, MaterialPtr material, unsigned int count);
+
+	/**
+	 * Extends the range of instances that must be re-uploaded to the GPU
+	 * @param first Index of the first modified instance
+	 * @param count The number of modified instances
+	 */
+	void markDirty(unsigned int first, unsigned int count);
+
+	/**
+	 * Asserts that an instance index is in range
+	 * @param index Instance index
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	void assertIndex(unsigned int index) const;
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include <graphics/objects/pointers/LODMeshPtr.h>
+#include <graphics/objects/Mesh.h>
+#include <vector>
+
+class Matrix4;
+class Sphere;
+class Vector3;
+
+/**
+ * A mesh holding several levels of detail of the same object, from finest to coarsest. The renderer draws the level
+ * matching the screen coverage of the mesh, which is the fraction of the viewport height covered by its projected
+ * bounding sphere, so that distant meshes are drawn with far fewer triangles. The mesh geometry is the finest level,
+ * and is used whenever the level cannot be selected, such as within static batches.
+ *
+ * Levels switch with hysteresis, so that meshes near a threshold do not flicker between levels, and can optionally
+ * cross-fade, drawing both levels with complementary dither patterns for a short time to hide the switch.
+ * @author Nathaniel Rex
+ */
+class LODMesh : public Mesh
+{
+public:
+
+	/**
+	 * Default fraction by which the screen coverage must pass a threshold before the level switches
+	 */
+	static const float DEFAULT_HYSTERESIS;
+
+	/**
+	 * Default duration of cross-fades, in seconds
+	 */
+	static const float DEFAULT_FADE_DURATION;
+
+	/**
+	 * Fraction by which the screen coverage must pass a threshold before the level switches. A value of 0.1 switches
+	 * to a coarser level at 90% of the threshold, and back to the finer level at 110% of it.
+	 */
+	float hysteresis = DEFAULT_HYSTERESIS;
+
+	/**
+	 * Flag that, when true, causes levels to cross-fade when they switch. Defaults to false.
+	 */
+	bool crossFade = false;
+
+	/**
+	 * Duration of cross-fades, in seconds
+	 */
+	float fadeDuration = DEFAULT_FADE_DURATION;
+
+	/**
+	 * Constructs a new mesh with several levels of detail
+	 * @param levels Geometries of every level, from finest to coarsest, such as those generated by
+	 * MeshSimplifier::generateLODs. The first level becomes the mesh geometry.
+	 * @param thresholds Screen coverage below which each level is replaced by the next coarser one, with one entry
+	 * fewer than there are levels. Must be strictly decreasing.
+	 * @param material Material shared by all levels
+	 * @return The new mesh
+	 * @throws IllegalArgumentException If there are no levels, the number of thresholds does not match, or the
+	 * thresholds are not strictly decreasing
+	 * @throws NullPointerException If any level is null
+	 */
+	static LODMeshPtr create(const std::vector<GeometryPtr>& levels, const std::vector<float>& thresholds,
+		MaterialPtr material);
+
+	/**
+	 * @return The number of levels of detail
+	 */
+	unsigned int getNumLevels() const;
+
+	/**
+	 * @param index Level index, where 0 is the finest level
+	 * @return The geometry of the level
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	GeometryPtr getLevel(unsigned int index) const;
+
+	/**
+	 * @param index Level index, where 0 is the finest level
+	 * @return Screen coverage below which the level is replaced by the next coarser one
+	 * @throws OutOfBoundsException If the index does not refer to a level with a coarser level after it
+	 */
+	float getThreshold(unsigned int index) const;
+
+	/**
+	 * @return The level selected by the last update
+	 */
+	unsigned int getCurrentLevel() const;
+
+	/**
+	 * @return The level fading out during a cross-fade. Is the current level when no cross-fade is in progress.
+	 */
+	unsigned int getFadingLevel() const;
+
+	/**
+	 * @param time Current time, in seconds
+	 * @return Progress of the current cross-fade between 0 and 1, or 1 when no cross-fade is in progress
+	 */
+	float getFadeProgress(float time) const;
+
+	/**
+	 * Selects the level for a screen coverage, applying hysteresis around the current level, and starts or ends
+	 * cross-fades. Called by the renderer during traversal.
+	 * @param coverage Screen coverage of the mesh
+	 * @param time Current time, in seconds
+	 * @return The selected level
+	 */
+	unsigned int update(float coverage, float time);
+
+	/**
+	 * Computes the fraction of the viewport height covered by a bounding sphere under a perspective projection
+	 * @param bounds Bounding sphere, in local space
+	 * @param modelTransform Local-to-world transformation
+	 * @param cameraPosition Position of the camera, in world space
+	 * @param fov Vertical field of view angle of the camera, in degrees
+	 * @param bias (Optional) Level of detail bias. Every unit halves the coverage, selecting coarser levels sooner,
+	 * while negative values select finer levels. Defaults to 0.
+	 * @return The screen coverage. Is the largest float value if the camera lies within the sphere, and 0 if the
+	 * sphere is empty.
+	 */
+	static float computeScreenCoverage(const Sphere& bounds, const Matrix4& modelTransform,
+		const Vector3& cameraPosition, float fov, float bias = 0.f);
+
+private:
+
+	/**
+	 * Geometries of every level, from finest to coarsest
+	 */
+	std::vector<GeometryPtr> _levels;
+
+	/**
+	 * Screen coverage below which each level is replaced by the next coarser one
+	 */
+	std::vector<float> _thresholds;
+
+	/**
+	 * The level selected by the last update
+	 */
+	unsigned int _currentLevel = 0;
+
+	/**
+	 * The level fading out, or the current level when no cross-fade is in progress
+	 */
+	unsigned int _fadingLevel = 0;
+
+	/**
+	 * Time at which the current cross-fade started, in seconds
+	 */
+	float _fadeStart = 0.f;
+
+	/**
+	 * Flag that, when true, indicates that a level has been selected at least once
+	 */
+	bool _updated = false;
+
+	/**
+	 * Constructor
+	 * @param levels Geometries of every level, from finest to coarsest
+	 * @param thresholds Screen coverage below which each level is replaced by the next coarser one
+	 * @param material Material
+	 */
+	LODMesh(const std::vector<GeometryPtr>& levels, const std::vector<float>& thresholds, MaterialPtr material);
+};
@@ -30,7 +30,7 @@ public:
 	 */
 	static MeshPtr create(GeometryPtr geometry, MaterialPtr material);
 
-private:
+protected:
 
 	/**
 	 * Constructor
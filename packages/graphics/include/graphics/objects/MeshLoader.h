@@ -0,0 +1,30 @@
+#pragma once
+#include <graphics/core/pointers/EntityGroupPtr.h>
+#include <graphics/objects/MeshLoaderOptions.h>
+#include <string>
+
+/**
+ * The mesh loader imports meshes from files, choosing the importer from the file extension. Wavefront OBJ (.obj),
+ * glTF 2.0 (.gltf and .glb), and binary mesh cache (.tfmesh) files are supported.
+ * @author Nathaniel Rex
+ */
+class MeshLoader
+{
+public:
+
+	/**
+	 * Loads the meshes stored in a file into a new entity group
+	 * @param path Relative path to the mesh file. This path is relative to the directory containing the currently
+	 * running executable.
+	 * @param options (Optional) Import options
+	 * @return An entity group holding the imported meshes
+	 * @throws IllegalArgumentException If the file extension is not supported
+	 * @throws InstantiationException If the file could not be read, or is malformed
+	 */
+	static EntityGroupPtr load(const std::string& path, const MeshLoaderOptions& options = MeshLoaderOptions());
+
+	/**
+	 * Deleted constructor
+	 */
+	MeshLoader() = delete;
+};
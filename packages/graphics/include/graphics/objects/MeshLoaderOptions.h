@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * Options controlling how mesh files are imported
+ * @author Nathaniel Rex
+ */
+struct MeshLoaderOptions {
+
+	/**
+	 * The maximum number of threads used for parsing and building geometry, including the calling thread. Uses as
+	 * many threads as the hardware can run concurrently when 0.
+	 */
+	unsigned int numThreads = 0;
+
+	/**
+	 * True if normals, colors, and texture coordinates should be stored in compact formats on the GPU (packed
+	 * normals, 8-bit colors, and half-precision texture coordinates). When false, all attributes are stored as floats.
+	 */
+	bool compactFormats = true;
+
+	/**
+	 * True if every imported geometry should be run through the GeometryOptimizer, reordering its triangles and
+	 * vertices for faster rendering
+	 */
+	bool optimize = false;
+};
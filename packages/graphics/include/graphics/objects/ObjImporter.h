@@ -0,0 +1,58 @@
+#pragma once
+#include <graphics/core/pointers/EntityGroupPtr.h>
+#include <graphics/objects/MeshLoaderOptions.h>
+#include <cstddef>
+#include <string>
+
+/**
+ * Imports Wavefront OBJ files. The file is memory-mapped and split into chunks at line boundaries, which are parsed
+ * in parallel. Every object, group, or material section of the file becomes a mesh whose vertex data is written
+ * directly into an interleaved buffer. Polygons are triangulated as fans, and vertices with the same position, texture
+ * coordinates, and normal are shared. Material libraries are not read, so all meshes share a single basic material.
+ * @author Nathaniel Rex
+ */
+class ObjImporter
+{
+public:
+
+	/**
+	 * Target size of the chunks parsed in parallel, in bytes
+	 */
+	static const size_t DEFAULT_CHUNK_SIZE;
+
+	/**
+	 * Loads an OBJ file into a new entity group
+	 * @param path Absolute path to the OBJ file
+	 * @param options Import options
+	 * @return An entity group holding one mesh per object, group, or material section of the file
+	 * @throws InstantiationException If the file could not be read, or is malformed
+	 */
+	static EntityGroupPtr load(const std::string& path, const MeshLoaderOptions& options);
+
+	/**
+	 * Imports OBJ data held in memory into a new entity group
+	 * @param data OBJ file contents
+	 * @param size Size of the contents, in bytes
+	 * @param options Import options
+	 * @param chunkSize (Optional) Target size of the chunks parsed in parallel, in bytes
+	 * @return An entity group holding one mesh per object, group, or material section of the data
+	 * @throws InstantiationException If the data is malformed, or a face references a missing vertex attribute
+	 */
+	static EntityGroupPtr parse(const char* data, size_t size, const MeshLoaderOptions& options,
+		size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+	/**
+	 * Parses a decimal floating point number, with an optional sign, fraction, and exponent. Runs of eight digits
+	 * are converted at once within a 64-bit register.
+	 * @param str Start of the number
+	 * @param end End of the readable data
+	 * @param value Reference in which to store the parsed value
+	 * @return Pointer to the first character following the number, or null if no number starts at the given position
+	 */
+	static const char* parseFloat(const char* str, const char* end, float& value);
+
+	/**
+	 * Deleted constructor
+	 */
+	ObjImporter() = delete;
+};
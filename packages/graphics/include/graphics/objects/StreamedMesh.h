@@ -0,0 +1,49 @@
+#pragma once
+#include <graphics/objects/pointers/StreamedMeshPtr.h>
+#include <graphics/core/Entity.h>
+#include <graphics/core/pointers/MeshStreamerPtr.h>
+#include <graphics/materials/pointers/MaterialPtr.h>
+
+/**
+ * A triangulated mesh too large to be held in memory, whose clusters are paged in and out of GPU memory by a mesh
+ * streamer. The renderer updates the streamer for the camera of every frame, and draws the visible resident clusters
+ * with a single call. Clusters that are not yet resident are simply left out.
+ * @author Nathaniel Rex
+ */
+class StreamedMesh : public Entity
+{
+public:
+
+	/**
+	 * Material shared by all clusters
+	 */
+	MaterialPtr material;
+
+	/**
+	 * Constructs a new streamed mesh
+	 * @param streamer Mesh streamer paging in the clusters of the mesh
+	 * @param material Material
+	 * @return The new streamed mesh
+	 * @throws NullPointerException If the streamer is null
+	 */
+	static StreamedMeshPtr create(MeshStreamerPtr streamer, MaterialPtr material);
+
+	/**
+	 * @return Mesh streamer paging in the clusters of the mesh
+	 */
+	MeshStreamerPtr getStreamer() const;
+
+private:
+
+	/**
+	 * Mesh streamer paging in the clusters of the mesh
+	 */
+	MeshStreamerPtr _streamer;
+
+	/**
+	 * Constructor
+	 * @param streamer Mesh streamer
+	 * @param material Material
+	 */
+	StreamedMesh(MeshStreamerPtr streamer, MaterialPtr material);
+};
@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * A shared pointer to an InstancedMesh instance
+ */
+using InstancedMeshPtr = std::shared_ptr<class InstancedMesh>;
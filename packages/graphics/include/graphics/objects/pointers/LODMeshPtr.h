@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * A shared pointer to an LODMesh instance
+ */
+using LODMeshPtr = std::shared_ptr<class LODMesh>;
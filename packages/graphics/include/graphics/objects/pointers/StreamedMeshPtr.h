@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * A shared pointer to a StreamedMesh instance
+ */
+using StreamedMeshPtr = std::shared_ptr<class StreamedMesh>;
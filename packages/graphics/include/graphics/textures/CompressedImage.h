@@ -0,0 +1,235 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+/**
+ * Block compression formats of GPU textures
+ * @author Nathaniel Rex
+ */
+enum class CompressedFormat
+{
+
+	/**
+	 * S3TC DXT1, holding opaque colors
+	 */
+	BC1_RGB,
+
+	/**
+	 * S3TC DXT1, holding colors with a single bit of alpha
+	 */
+	BC1_RGBA,
+
+	/**
+	 * S3TC DXT3, holding colors with explicit alpha
+	 */
+	BC2,
+
+	/**
+	 * S3TC DXT5, holding colors with interpolated alpha
+	 */
+	BC3,
+
+	/**
+	 * RGTC, holding a single channel
+	 */
+	BC4,
+
+	/**
+	 * RGTC, holding two channels
+	 */
+	BC5,
+
+	/**
+	 * BPTC, holding high quality colors with alpha
+	 */
+	BC7,
+
+	/**
+	 * ETC2, holding opaque colors
+	 */
+	ETC2_RGB,
+
+	/**
+	 * ETC2 with EAC alpha
+	 */
+	ETC2_RGBA
+};
+
+/**
+ * A single level of the mip chain of a compressed image
+ */
+struct CompressedLevel {
+	unsigned int width;
+	unsigned int height;
+
+	/**
+	 * Offset of the compressed blocks within the file, in bytes
+	 */
+	size_t offset;
+	size_t size;
+};
+
+/**
+ * A block compressed image read from a KTX2 or DDS container, holding a prebuilt mip chain that is uploaded to the GPU
+ * as is. Only two-dimensional images without supercompression are supported. The file is mapped into memory, so
+ * levels are read in place.
+ *
+ * Images whose format the GL context cannot sample can be decoded to 8-bit RGBA on the CPU instead, which is supported
+ * for every format the context is not required to support, BC1 to BC5.
+ * @author Nathaniel Rex
+ */
+class CompressedImage
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param path Absolute path to a file ending in .ktx2 or .dds
+	 * @throws InstantiationException If the file could not be opened, is not a valid container, or holds an
+	 * unsupported format
+	 */
+	CompressedImage(const std::string& path);
+
+	/**
+	 * Constructor
+	 * @param image Compressed image to copy from
+	 */
+	CompressedImage(const CompressedImage& image) = delete;
+
+	/**
+	 * Destructor
+	 */
+	~CompressedImage();
+
+	/**
+	 * Assignment operator
+	 * @param image Compressed image to assign from
+	 */
+	CompressedImage& operator=(const CompressedImage& image) = delete;
+
+	/**
+	 * @param path File path
+	 * @return True if the path names a container read by compressed images. Returns false otherwise.
+	 */
+	static bool isCompressedPath(const std::string& path);
+
+	/**
+	 * @param format Compression format
+	 * @return The size of a single block of 4x4 pixels, in bytes
+	 */
+	static unsigned int getBlockSize(CompressedFormat format);
+
+	/**
+	 * @param format Compression format
+	 * @return The GL internal format of the compression format
+	 */
+	static unsigned int getGLFormat(CompressedFormat format);
+
+	/**
+	 * Determines if the current GL context can sample a compression format. Must be called from the thread owning the
+	 * GL context.
+	 * @param format Compression format
+	 * @return True if the format is supported. Returns false otherwise.
+	 */
+	static bool isSupported(CompressedFormat format);
+
+	/**
+	 * @param format Compression format
+	 * @return True if compressed images of the format can be decoded on the CPU. Returns false otherwise.
+	 */
+	static bool isDecodable(CompressedFormat format);
+
+	/**
+	 * @return The compression format
+	 */
+	CompressedFormat getFormat() const;
+
+	/**
+	 * @return The width of the largest level, in pixels
+	 */
+	unsigned int getWidth() const;
+
+	/**
+	 * @return The height of the largest level, in pixels
+	 */
+	unsigned int getHeight() const;
+
+	/**
+	 * @return The number of levels in the mip chain
+	 */
+	unsigned int getNumLevels() const;
+
+	/**
+	 * @param level Level index, where level 0 is the largest
+	 * @return The level
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	const CompressedLevel& getLevel(unsigned int level) const;
+
+	/**
+	 * @param level Level index, where level 0 is the largest
+	 * @return The compressed blocks of the level
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	const unsigned char* getLevelData(unsigned int level) const;
+
+	/**
+	 * @return The combined size of the compressed blocks of every level, in bytes
+	 */
+	size_t getDataSize() const;
+
+	/**
+	 * Decodes a level to 8-bit RGBA pixels. Single channel images are decoded to red, and two channel images to red
+	 * and green, with the other color channels set to 0 and alpha set to 255.
+	 * @param level Level index, where level 0 is the largest
+	 * @param pixels Receives the pixels of the level, row by row starting from the top
+	 * @throws OutOfBoundsException If the index is out of range
+	 * @throws IllegalArgumentException If the format cannot be decoded on the CPU
+	 */
+	void decode(unsigned int level, std::vector<unsigned char>& pixels) const;
+
+private:
+
+	/**
+	 * Mapped container file
+	 */
+	std::unique_ptr<MappedFile> _file;
+
+	/**
+	 * Compression format
+	 */
+	CompressedFormat _format;
+
+	/**
+	 * Levels of the mip chain, largest first
+	 */
+	std::vector<CompressedLevel> _levels;
+
+	/**
+	 * Reads the header of a KTX2 container
+	 * @param path File path, for error messages
+	 * @throws InstantiationException If the container is invalid or unsupported
+	 */
+	void readKTX2(const std::string& path);
+
+	/**
+	 * Reads the header of a DDS container
+	 * @param path File path, for error messages
+	 * @throws InstantiationException If the container is invalid or unsupported
+	 */
+	void readDDS(const std::string& path);
+
+	/**
+	 * Adds the levels of a mip chain, checking that they lie within the file
+	 * @param width The width of the largest level, in pixels
+	 * @param height The height of the largest level, in pixels
+	 * @param offsets Offset of every level within the file, in bytes
+	 * @param path File path, for error messages
+	 * @throws InstantiationException If a level lies outside of the file
+	 */
+	void addLevels(unsigned int width, unsigned int height, const std::vector<size_t>& offsets,
+		const std::string& path);
+};
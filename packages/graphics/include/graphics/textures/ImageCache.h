@@ -0,0 +1,174 @@
+#pragma once
+#include <graphics/textures/ImageOptions.h>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class MipmappedImage;
+
+/**
+ * Statistics describing the images loaded through the image cache
+ * @author Nathaniel Rex
+ */
+struct ImageCacheStats {
+
+	/**
+	 * The number of loads that mapped their image from a cache file
+	 */
+	unsigned long long numHits = 0;
+
+	/**
+	 * The number of loads that had to decode their image
+	 */
+	unsigned long long numMisses = 0;
+
+	/**
+	 * Time spent decoding images and generating their mip chains on misses, in milliseconds
+	 */
+	float decodeTime = 0.f;
+
+	/**
+	 * Time spent mapping images from cache files on hits, in milliseconds
+	 */
+	float loadTime = 0.f;
+};
+
+/**
+ * The image cache stores decoded images along with their mip chains on disk (.tfimage), so that later loads of the
+ * same image map the cached pixels rather than decoding the image and filtering its levels again.
+ *
+ * Cache files are named after a hash of the contents of the image and the options it was loaded with, so editing an
+ * image invalidates its cache file without any timestamps being compared. A file starts with a 64 byte header
+ * followed by the levels of the chain, as laid out by MipmappedImage::computeLevels, which are mapped into memory and
+ * handed to the GPU as they are. A version number guards against format changes, and an endianness tag against files
+ * written on a host with a different byte order. Cache files that cannot be read are treated as misses, and cache
+ * files that cannot be written are skipped, so the cache never causes a load to fail.
+ *
+ * Images are loaded with 3 channels, or 4 if they have an alpha channel. Loads are thread-safe.
+ * @author Nathaniel Rex
+ */
+class ImageCache
+{
+public:
+
+	/**
+	 * File extension of image cache files
+	 */
+	static const std::string EXTENSION;
+
+	/**
+	 * Version of the format written by this class. Files of other versions are rejected.
+	 */
+	static const unsigned int VERSION;
+
+	/**
+	 * Destructor
+	 */
+	~ImageCache();
+
+	/**
+	 * Loads an image along with its mip chain, from its cache file if one exists, or by decoding the image and
+	 * writing a cache file otherwise
+	 * @param path Relative path to the image file. This path is relative to the directory containing the currently
+	 * running executable.
+	 * @param options (Optional) Options controlling how the image is decoded and filtered
+	 * @return The image
+	 * @throws InstantiationException If the image file could not be read or decoded
+	 */
+	static std::unique_ptr<MipmappedImage> load(const std::string& path, const ImageOptions& options = ImageOptions());
+
+	/**
+	 * @return Absolute path to the directory holding the cache files, or an empty string if caching is disabled
+	 */
+	static std::string getDirectory();
+
+	/**
+	 * Sets the directory holding the cache files, which is created when the first file is written
+	 * @param directory Absolute path to the directory, or an empty string to disable caching
+	 */
+	static void setDirectory(const std::string& directory);
+
+	/**
+	 * @return Statistics describing the images loaded so far
+	 */
+	static ImageCacheStats getStats();
+
+	/**
+	 * Resets the global image cache instance to its initial state. Must not be called while images are loading.
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * Global image cache instance
+	 */
+	static std::unique_ptr<ImageCache> _INSTANCE;
+
+	/**
+	 * Guards the global instance and its state, since images are loaded from background threads
+	 */
+	static std::mutex _MUTEX;
+
+	/**
+	 * Absolute path to the directory holding the cache files, or an empty string if caching is disabled
+	 */
+	std::string _directory;
+
+	/**
+	 * Statistics describing the images loaded so far
+	 */
+	ImageCacheStats _stats;
+
+	/**
+	 * The number of cache files written, used to name their temporary files
+	 */
+	unsigned long long _numWrites = 0;
+
+	/**
+	 * Constructor
+	 */
+	ImageCache();
+
+	/**
+	 * Constructor
+	 * @param cache Image cache to copy from
+	 */
+	ImageCache(const ImageCache& cache) = delete;
+
+	/**
+	 * Constructor
+	 * @param cache Image cache to copy from
+	 */
+	ImageCache(ImageCache&& cache) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param cache Image cache to assign from
+	 */
+	ImageCache& operator=(const ImageCache& cache) = delete;
+
+	/**
+	 * @return The global image cache instance. Must be called with the mutex locked.
+	 */
+	static ImageCache* getInstance();
+
+	/**
+	 * Maps the image stored in a cache file
+	 * @param path Absolute path to the cache file
+	 * @param key Key the file must have been written with
+	 * @return The image, or null if the file does not exist, or is of another version, byte order, or key
+	 */
+	static std::unique_ptr<MipmappedImage> read(const std::string& path, unsigned long long key);
+
+	/**
+	 * Writes an image to a cache file. A temporary file is written first and then renamed, so that other processes
+	 * never map a partially written file. Failures are ignored.
+	 * @param path Absolute path to the cache file
+	 * @param temporaryPath Absolute path to the temporary file
+	 * @param key Key of the image
+	 * @param image The image
+	 */
+	static void write(const std::string& path, const std::string& temporaryPath, unsigned long long key,
+		const MipmappedImage& image);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * Options controlling how images are decoded and filtered into mip chains
+ * @author Nathaniel Rex
+ */
+struct ImageOptions {
+
+	/**
+	 * True if the rows of the image should be flipped, so that the first row is the bottom of the image
+	 */
+	bool flip = false;
+
+	/**
+	 * True if the color channels of images with an alpha channel should be premultiplied by their alpha. Has no
+	 * effect on images without an alpha channel.
+	 */
+	bool premultiply = false;
+
+	/**
+	 * True if the color channels are sRGB encoded, and should be filtered in linear space. Should be false for data
+	 * such as normal maps. Alpha channels are always filtered as they are.
+	 */
+	bool srgb = true;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+/**
+ * Generates the mip chains of decoded images on the CPU with a box filter, so that they can be cached along with the
+ * image rather than regenerated on the GPU every time it is loaded. Filtering is gamma correct: sRGB encoded color
+ * channels are converted to 16-bit linear values, averaged, and encoded again, so that a checkerboard of black and
+ * white fades to the gray of the same brightness rather than a darker one. Every level is filtered from the linear
+ * values of the previous level, rows are summed four or eight values at a time using SSE when the target supports it,
+ * and levels larger than PARALLEL_THRESHOLD pixels are split across worker threads. Results do not depend on the
+ * number of threads.
+ * @author Nathaniel Rex
+ */
+class MipGenerator
+{
+public:
+
+	/**
+	 * The number of pixels of a level above which its rows are split across worker threads
+	 */
+	static const unsigned int PARALLEL_THRESHOLD;
+
+	/**
+	 * Fills every level of a mip chain from its largest level
+	 * @param pixels Pixels of every level, laid out as described by MipmappedImage::computeLevels. The largest level
+	 * must be filled, and is premultiplied in place if requested.
+	 * @param width The width of the largest level, in pixels
+	 * @param height The height of the largest level, in pixels
+	 * @param channels The number of channels of every pixel, between 1 and 4. The last channel of 2 and 4 channel
+	 * images is alpha.
+	 * @param srgb True if the color channels are sRGB encoded, and should be filtered in linear space
+	 * @param premultiply True if the color channels should be premultiplied by alpha. Has no effect on images without
+	 * an alpha channel.
+	 * @param numThreads (Optional) The maximum number of threads to use, including the calling thread. Uses as many
+	 * threads as the hardware can run concurrently when 0.
+	 * @throws IllegalArgumentException If the image is empty, or has an unsupported number of channels
+	 */
+	static void generate(unsigned char* pixels, unsigned int width, unsigned int height, unsigned int channels,
+		bool srgb, bool premultiply, unsigned int numThreads = 0);
+
+	/**
+	 * Converts an 8-bit sRGB encoded value to a 16-bit linear value
+	 * @param value sRGB encoded value
+	 * @return Linear value, between 0 and 65535
+	 */
+	static unsigned int toLinear(unsigned char value);
+
+	/**
+	 * Converts a 16-bit linear value to the nearest 8-bit sRGB encoded value
+	 * @param value Linear value, between 0 and 65535
+	 * @return sRGB encoded value
+	 */
+	static unsigned char fromLinear(unsigned int value);
+
+	/**
+	 * Deleted constructor
+	 */
+	MipGenerator() = delete;
+};
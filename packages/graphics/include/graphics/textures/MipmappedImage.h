@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class MappedFile;
+
+/**
+ * Description of a single level of a mip chain
+ * @author Nathaniel Rex
+ */
+struct MipLevel {
+	unsigned int width = 0;
+	unsigned int height = 0;
+
+	/**
+	 * Offset of the level from the start of the chain, in bytes
+	 */
+	size_t offset = 0;
+
+	/**
+	 * Size of the level, in bytes
+	 */
+	size_t size = 0;
+};
+
+
+/**
+ * A decoded image along with its full mip chain, down to a single pixel. Levels are stored one after the other with
+ * tightly packed rows of 8-bit channels, either in memory or in a memory-mapped image cache file.
+ * @author Nathaniel Rex
+ */
+class MipmappedImage
+{
+public:
+
+	friend class ImageCache;
+
+	/**
+	 * Constructor
+	 * @param width The width of the largest level, in pixels
+	 * @param height The height of the largest level, in pixels
+	 * @param channels The number of channels of every pixel
+	 * @param pixels Pixels of every level, laid out as described by computeLevels
+	 * @param premultiplied (Optional) True if the color channels are premultiplied by alpha. Defaults to false.
+	 * @throws IllegalArgumentException If the image is empty, has no channels, or the pixels do not hold the full
+	 * chain
+	 */
+	MipmappedImage(unsigned int width, unsigned int height, unsigned int channels, std::vector<unsigned char> pixels,
+		bool premultiplied = false);
+
+	/**
+	 * Constructor
+	 * @param image Image to copy from
+	 */
+	MipmappedImage(const MipmappedImage& image) = delete;
+
+	/**
+	 * Destructor
+	 */
+	~MipmappedImage();
+
+	/**
+	 * Assignment operator
+	 * @param image Image to assign from
+	 */
+	MipmappedImage& operator=(const MipmappedImage& image) = delete;
+
+	/**
+	 * Computes the layout of a full mip chain, from the largest level down to a single pixel
+	 * @param width The width of the largest level, in pixels
+	 * @param height The height of the largest level, in pixels
+	 * @param channels The number of channels of every pixel
+	 * @return Every level of the chain, from the largest to the smallest
+	 */
+	static std::vector<MipLevel> computeLevels(unsigned int width, unsigned int height, unsigned int channels);
+
+	/**
+	 * @return The width of the largest level, in pixels
+	 */
+	unsigned int getWidth() const;
+
+	/**
+	 * @return The height of the largest level, in pixels
+	 */
+	unsigned int getHeight() const;
+
+	/**
+	 * @return The number of channels of every pixel
+	 */
+	unsigned int getChannels() const;
+
+	/**
+	 * @return True if the color channels are premultiplied by alpha. Returns false otherwise.
+	 */
+	bool isPremultiplied() const;
+
+	/**
+	 * @return The number of levels of the chain
+	 */
+	unsigned int getNumLevels() const;
+
+	/**
+	 * @param index Level index, where 0 is the largest level
+	 * @return Description of the level
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	const MipLevel& getLevel(unsigned int index) const;
+
+	/**
+	 * @param index Level index, where 0 is the largest level
+	 * @return Pixels of the level
+	 * @throws OutOfBoundsException If the index is out of range
+	 */
+	const unsigned char* getLevelData(unsigned int index) const;
+
+	/**
+	 * @return Pixels of every level
+	 */
+	const unsigned char* getData() const;
+
+	/**
+	 * @return The size of every level combined, in bytes
+	 */
+	size_t getDataSize() const;
+
+private:
+
+	unsigned int _width;
+	unsigned int _height;
+	unsigned int _channels;
+	bool _premultiplied;
+
+	/**
+	 * Levels of the chain
+	 */
+	std::vector<MipLevel> _levels;
+
+	/**
+	 * Pixels held in memory. Is empty if the pixels are mapped from a file.
+	 */
+	std::vector<unsigned char> _pixels;
+
+	/**
+	 * Image cache file holding the pixels, or null if they are held in memory
+	 */
+	std::unique_ptr<MappedFile> _file;
+
+	/**
+	 * Start of the pixels of every level
+	 */
+	const unsigned char* _data;
+
+	/**
+	 * Constructs an image whose pixels are mapped from an image cache file
+	 * @param width The width of the largest level, in pixels
+	 * @param height The height of the largest level, in pixels
+	 * @param channels The number of channels of every pixel
+	 * @param premultiplied True if the color channels are premultiplied by alpha
+	 * @param file Mapped file
+	 * @param offset Offset of the pixels within the file, in bytes
+	 */
+	MipmappedImage(unsigned int width, unsigned int height, unsigned int channels, bool premultiplied,
+		std::unique_ptr<MappedFile> file, size_t offset);
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+
+/**
+ * Packs rectangles into a fixed size area using the skyline bottom-left heuristic. The packer tracks the top edge of
+ * the rectangles placed so far as a skyline of horizontal segments, and places every new rectangle where its top edge
+ * ends up lowest, which keeps the packed area compact without tracking every free rectangle.
+ * @author Nathaniel Rex
+ */
+class SkylinePacker
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param width The width of the area
+	 * @param height The height of the area
+	 * @throws IllegalArgumentException If the area is empty
+	 */
+	SkylinePacker(unsigned int width, unsigned int height);
+
+	/**
+	 * Places a rectangle within the area
+	 * @param width The width of the rectangle
+	 * @param height The height of the rectangle
+	 * @param x Receives the horizontal position of the rectangle, if it was placed
+	 * @param y Receives the vertical position of the rectangle, if it was placed
+	 * @return True if the rectangle was placed. Returns false if it does not fit in the space left.
+	 * @throws IllegalArgumentException If the rectangle is empty
+	 */
+	bool pack(unsigned int width, unsigned int height, unsigned int& x, unsigned int& y);
+
+	/**
+	 * Removes every rectangle placed so far
+	 */
+	void clear();
+
+	/**
+	 * @return The width of the area
+	 */
+	unsigned int getWidth() const;
+
+	/**
+	 * @return The height of the area
+	 */
+	unsigned int getHeight() const;
+
+	/**
+	 * @return The combined area of the rectangles placed so far
+	 */
+	unsigned long long getUsedArea() const;
+
+	/**
+	 * @return The fraction of the area covered by the rectangles placed so far, between 0 and 1
+	 */
+	float getOccupancy() const;
+
+private:
+
+	/**
+	 * A horizontal segment of the skyline
+	 */
+	struct Segment {
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+	};
+
+	/**
+	 * The width of the area
+	 */
+	unsigned int _width;
+
+	/**
+	 * The height of the area
+	 */
+	unsigned int _height;
+
+	/**
+	 * Segments of the skyline, from left to right, covering the whole width of the area
+	 */
+	std::vector<Segment> _skyline;
+
+	/**
+	 * The combined area of the rectangles placed so far
+	 */
+	unsigned long long _usedArea = 0;
+
+	/**
+	 * Determines the height at which a rectangle starting at a segment would be placed
+	 * @param index Index of the segment the rectangle starts at
+	 * @param width The width of the rectangle
+	 * @param height The height of the rectangle
+	 * @param y Receives the vertical position of the rectangle, resting on the highest segment below it
+	 * @return True if the rectangle fits within the area. Returns false otherwise.
+	 */
+	bool fit(unsigned int index, unsigned int width, unsigned int height, unsigned int& y) const;
+};
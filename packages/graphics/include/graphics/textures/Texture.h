@@ -1,7 +1,10 @@
 #pragma once
 #include <graphics/textures/pointers/TexturePtr.h>
+#include <graphics/textures/TextureStatus.h>
 #include <string>
 
+class CompressedImage;
+
 /**
  * A texture capable of being loaded and mapped to vertices by the GPU.
  * @author Nathaniel Rex
@@ -10,6 +13,10 @@ class Texture
 {
 public:
 
+	friend class TextureLoader;
+	friend class TextureAtlas;
+	friend class TextureStreamer;
+
 	/**
 	 * Destructor
 	 */
@@ -18,19 +25,67 @@ public:
 	/**
 	 * Constructs a new texture instance. In order to ensure textures are cached for future use, it is typically
 	 * encouraged that callers use the TextureLoader for creating textures, rather than creating them directly.
+	 *
+	 * Images in KTX2 and DDS containers are uploaded in their block compressed format along with their prebuilt mip
+	 * chain, or decoded on the CPU if the GL context does not support their format. Other images are loaded through
+	 * the ImageCache, which decodes them and builds their mip chain on the CPU with the MipGenerator unless it cached
+	 * them earlier. Every level of the chain is then uploaded explicitly.
 	 * @param path Relative path to the image file that will be used to generate the texture.
 	 * This path is relative to the directory containing the currently running executable.
 	 * @param flip (Optional) Boolean flag that, when true, will cause the imagery to be flipped when loading.
-	 * Defaults to false
+	 * Defaults to false. Compressed images cannot be flipped.
 	 * @return The new texture
+	 * @throws InstantiationException If the image could not be loaded, or its compression format is neither supported
+	 * by the GL context nor decodable on the CPU
+	 * @throws IllegalArgumentException If a compressed image is flipped
 	 */
 	static TexturePtr create(const std::string& path, bool flip = false);
 
 	/**
-	 * @return The GLFW id of this texture
+	 * @return The GLFW id of this texture. Is the id of a placeholder texture while the image is loading, or if it
+	 * failed to load.
 	 */
 	unsigned int id() const;
 
+	/**
+	 * @return The loading state of this texture
+	 */
+	TextureStatus getStatus() const;
+
+	/**
+	 * @return The reason the image failed to load in the background. Is empty unless the status is FAILED.
+	 */
+	const std::string& getError() const;
+
+	/**
+	 * @return The width of the image, in pixels. Is 0 until the image is loaded.
+	 */
+	unsigned int getWidth() const;
+
+	/**
+	 * @return The height of the image, in pixels. Is 0 until the image is loaded.
+	 */
+	unsigned int getHeight() const;
+
+	/**
+	 * @return True if the texture is stored in a block compressed format on the GPU. Returns false otherwise.
+	 */
+	bool isCompressed() const;
+
+	/**
+	 * @return The GPU memory held by the texture, including its mip chain, in bytes. Is 0 until the image is loaded.
+	 */
+	unsigned long long getMemorySize() const;
+
+	/**
+	 * Computes the GPU memory held by an uncompressed texture along with its full mip chain
+	 * @param width The width of the largest level, in pixels
+	 * @param height The height of the largest level, in pixels
+	 * @param pixelSize The size of a single pixel, in bytes
+	 * @return The memory size, in bytes
+	 */
+	static unsigned long long computeMemorySize(unsigned int width, unsigned int height, unsigned int pixelSize);
+
 private:
 
 	/**
@@ -38,6 +93,36 @@ private:
 	 */
 	unsigned int _id;
 
+	/**
+	 * Loading state of this texture. The id of a texture that is not ready belongs to the placeholder texture.
+	 */
+	TextureStatus _status = TextureStatus::READY;
+
+	/**
+	 * Reason the image failed to load in the background
+	 */
+	std::string _error;
+
+	/**
+	 * Width of the image, in pixels
+	 */
+	unsigned int _width = 0;
+
+	/**
+	 * Height of the image, in pixels
+	 */
+	unsigned int _height = 0;
+
+	/**
+	 * Boolean flag that, when true, indicates that the texture is stored in a block compressed format
+	 */
+	bool _compressed = false;
+
+	/**
+	 * GPU memory held by the texture, in bytes
+	 */
+	unsigned long long _memorySize = 0;
+
 	/**
 	 * Constructor
 	 * @param path Relative path to the image file that will be used to generate the texture.
@@ -45,4 +130,27 @@ private:
 	 * @param flip Boolean flag that, when true, will cause the imagery to be flipped when loading
 	 */
 	Texture(const std::string& path, bool flip);
+
+	/**
+	 * Constructs a texture whose image is loaded asynchronously by the TextureLoader
+	 * @param placeholderId GLFW id of the placeholder texture bound until the image is loaded
+	 */
+	Texture(unsigned int placeholderId);
+
+	/**
+	 * Constructs a texture taking ownership of an existing GL texture
+	 * @param id GLFW id of the texture
+	 * @param width The width of the texture, in pixels
+	 * @param height The height of the texture, in pixels
+	 * @param memorySize GPU memory held by the texture, in bytes
+	 */
+	Texture(unsigned int id, unsigned int width, unsigned int height, unsigned long long memorySize);
+
+	/**
+	 * Creates the GL texture of a compressed image, uploading every level of its mip chain
+	 * @param image Compressed image
+	 * @throws InstantiationException If the compression format is neither supported by the GL context nor decodable
+	 * on the CPU
+	 */
+	void uploadCompressed(const CompressedImage& image);
 };
\ No newline at end of file
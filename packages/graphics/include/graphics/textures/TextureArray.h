@@ -0,0 +1,103 @@
+#pragma once
+#include <graphics/textures/pointers/TextureArrayPtr.h>
+#include <string>
+#include <vector>
+
+/**
+ * Images of the same size stored as the layers of a single GL array texture. Materials select a layer to sample, so
+ * that meshes differing only in their texture can share a material and be drawn together, with instances of an
+ * instanced mesh each selecting their own layer.
+ * @author Nathaniel Rex
+ */
+class TextureArray
+{
+public:
+
+	/**
+	 * Destructor
+	 */
+	~TextureArray();
+
+	/**
+	 * Constructor
+	 * @param array Texture array to copy from
+	 */
+	TextureArray(const TextureArray& array) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param array Texture array to assign from
+	 */
+	TextureArray& operator=(const TextureArray& array) = delete;
+
+	/**
+	 * Creates a texture array holding one layer per image, in order, along with their mip chains
+	 * @param paths Relative paths to the image files. These paths are relative to the directory containing the
+	 * currently running executable.
+	 * @param flip (Optional) Boolean flag that, when true, will cause the imagery to be flipped when loading.
+	 * Defaults to false.
+	 * @return The new texture array
+	 * @throws IllegalArgumentException If no paths are given, or the images are not all the same size
+	 * @throws InstantiationException If an image could not be loaded
+	 */
+	static TextureArrayPtr create(const std::vector<std::string>& paths, bool flip = false);
+
+	/**
+	 * @return The GLFW id of this texture array
+	 */
+	unsigned int id() const;
+
+	/**
+	 * @return The width of every layer, in pixels
+	 */
+	unsigned int getWidth() const;
+
+	/**
+	 * @return The height of every layer, in pixels
+	 */
+	unsigned int getHeight() const;
+
+	/**
+	 * @return The number of layers
+	 */
+	unsigned int getNumLayers() const;
+
+	/**
+	 * @return The GPU memory held by the texture array, including the mip chains of every layer, in bytes
+	 */
+	unsigned long long getMemorySize() const;
+
+private:
+
+	/**
+	 * GLFW id of this texture array
+	 */
+	unsigned int _id = 0;
+
+	/**
+	 * The width of every layer, in pixels
+	 */
+	unsigned int _width = 0;
+
+	/**
+	 * The height of every layer, in pixels
+	 */
+	unsigned int _height = 0;
+
+	/**
+	 * The number of layers
+	 */
+	unsigned int _numLayers = 0;
+
+	/**
+	 * Constructor
+	 * @param paths Relative paths to the image files
+	 * @param flip Boolean flag that, when true, will cause the imagery to be flipped when loading
+	 */
+	TextureArray(const std::vector<std::string>& paths, bool flip);
+
+	/**
+	 * Deletes the GL texture array
+	 */
+	void destroy();
+};
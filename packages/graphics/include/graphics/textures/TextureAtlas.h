@@ -0,0 +1,171 @@
+#pragma once
+#include <graphics/textures/pointers/TextureAtlasPtr.h>
+#include <graphics/textures/pointers/TexturePtr.h>
+#include <graphics/textures/SkylinePacker.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <graphics/materials/pointers/MaterialPtr.h>
+#include <math/Vector2.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * The region of a texture atlas holding a single image
+ * @author Nathaniel Rex
+ */
+struct AtlasRegion {
+
+	/**
+	 * Position of the image within the atlas, in pixels
+	 */
+	unsigned int x = 0;
+	unsigned int y = 0;
+
+	/**
+	 * Size of the image, in pixels
+	 */
+	unsigned int width = 0;
+	unsigned int height = 0;
+
+	/**
+	 * Offset mapping the texture coordinates of the image into the atlas, after scaling them
+	 */
+	Vector2 uvOffset;
+
+	/**
+	 * Scale mapping the texture coordinates of the image into the atlas
+	 */
+	Vector2 uvScale;
+};
+
+/**
+ * Packs small images into a single texture, so that meshes differing only in their texture can share it. Materials
+ * sample the region of their image by offsetting and scaling their texture coordinates, which static batches bake
+ * into vertices, merging such meshes into a single draw call.
+ *
+ * Images are placed by a skyline packer, and surrounded by a border repeating their edge pixels so that filtering
+ * does not bleed neighbouring images into them. Texture coordinates outside of the range 0 to 1 do not repeat the
+ * image, and sample its border instead.
+ *
+ * A copy of the atlas is kept on the CPU. Adding an image uploads only the largest level, and the mip chain is
+ * filtered on the CPU and uploaded when generateMips is called, once every image has been added. Until then, only
+ * the largest level is sampled.
+ * @author Nathaniel Rex
+ */
+class TextureAtlas
+{
+public:
+
+	/**
+	 * Default width of the border surrounding every image, in pixels
+	 */
+	static const unsigned int DEFAULT_PADDING;
+
+	/**
+	 * Creates an empty texture atlas
+	 * @param width The width of the atlas, in pixels
+	 * @param height The height of the atlas, in pixels
+	 * @param padding (Optional) The width of the border surrounding every image, in pixels
+	 * @return The new texture atlas
+	 * @throws IllegalArgumentException If the atlas is empty
+	 */
+	static TextureAtlasPtr create(unsigned int width, unsigned int height, unsigned int padding = DEFAULT_PADDING);
+
+	/**
+	 * Adds an image to the atlas, unless it was already added with the same flip. The mip chain of the atlas is not
+	 * sampled until it is generated again.
+	 * @param path Relative path to the image file. This path is relative to the directory containing the currently
+	 * running executable.
+	 * @param flip (Optional) Boolean flag that, when true, will cause the imagery to be flipped when loading.
+	 * Defaults to false.
+	 * @return The region of the image
+	 * @throws InstantiationException If the image could not be loaded
+	 * @throws IllegalStateException If the space left in the atlas cannot hold the image
+	 */
+	AtlasRegion add(const std::string& path, bool flip = false);
+
+	/**
+	 * Filters the mip chain of the atlas from its largest level and uploads it, unless no image was added since it
+	 * was last generated. Should be called once the atlas is packed rather than after every image.
+	 */
+	void generateMips();
+
+	/**
+	 * @return True if the mip chain of the atlas holds every image added to it
+	 */
+	bool isMipsGenerated() const;
+
+	/**
+	 * Makes a material sample a region of the atlas
+	 * @param material Material
+	 * @param region Region of the atlas
+	 * @throws NullPointerException If the material is null
+	 */
+	void apply(MaterialPtr material, const AtlasRegion& region) const;
+
+	/**
+	 * @return The texture holding the atlas
+	 */
+	TexturePtr getTexture() const;
+
+	/**
+	 * @return The packer placing the images of the atlas
+	 */
+	const SkylinePacker& getPacker() const;
+
+	/**
+	 * @return The regions of the images added to the atlas, in the order they were added
+	 */
+	const std::vector<AtlasRegion>& getRegions() const;
+
+private:
+
+	/**
+	 * Packer placing images along with their borders
+	 */
+	SkylinePacker _packer;
+
+	/**
+	 * The width of the border surrounding every image, in pixels
+	 */
+	unsigned int _padding;
+
+	/**
+	 * The texture holding the atlas
+	 */
+	TexturePtr _texture;
+
+	/**
+	 * Layout of the mip chain of the atlas
+	 */
+	std::vector<MipLevel> _levels;
+
+	/**
+	 * RGBA pixels of every level of the atlas
+	 */
+	std::vector<unsigned char> _pixels;
+
+	/**
+	 * True if the mip chain of the atlas holds every image added to it
+	 */
+	bool _mipsGenerated;
+
+	/**
+	 * Regions of the images added to the atlas
+	 */
+	std::vector<AtlasRegion> _regions;
+
+	/**
+	 * Mapping from image filepaths and whether they were flipped to the index of their region
+	 */
+	std::map<std::pair<std::string, bool>, unsigned int> _indices;
+
+	/**
+	 * Constructor
+	 * @param width The width of the atlas, in pixels
+	 * @param height The height of the atlas, in pixels
+	 * @param padding The width of the border surrounding every image, in pixels
+	 */
+	TextureAtlas(unsigned int width, unsigned int height, unsigned int padding);
+};
@@ -1,10 +1,72 @@
 #pragma once
 #include <graphics/textures/pointers/TexturePtr.h>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+class CompressedImage;
+class MipmappedImage;
+
+/**
+ * Statistics describing the textures cached by the texture loader
+ * @author Nathaniel Rex
+ */
+struct TextureLoaderStats {
+
+	/**
+	 * The number of textures currently cached
+	 */
+	unsigned int numTextures = 0;
+
+	/**
+	 * The number of loads that found their texture in the cache
+	 */
+	unsigned long long numHits = 0;
+
+	/**
+	 * The number of loads that had to create their texture
+	 */
+	unsigned long long numMisses = 0;
+
+	/**
+	 * The fraction of loads that found their texture in the cache, or 0 if nothing was loaded
+	 */
+	float hitRate = 0.f;
+
+	/**
+	 * The fraction of loads that had to create their texture, or 0 if nothing was loaded
+	 */
+	float missRate = 0.f;
+
+	/**
+	 * The number of textures evicted from the cache to stay within the memory budget
+	 */
+	unsigned long long numEvictions = 0;
+
+	/**
+	 * GPU memory held by the cached textures, including their mip chains, in bytes
+	 */
+	unsigned long long bytesResident = 0;
+};
 
 /**
- * The texture loader is responsible for creating and caching textures
+ * The texture loader is responsible for creating and caching textures.
+ *
+ * Textures are cached by their path and load options. Once the cached textures hold more memory than the memory
+ * budget, the least recently loaded textures no longer referenced outside the cache are evicted until the budget is
+ * met again. Textures still in use are never evicted, so the budget may be exceeded while they remain referenced.
+ *
+ * Textures can be loaded synchronously, blocking until the image is decoded and uploaded, or asynchronously. Images
+ * loaded asynchronously are decoded, or mapped from the ImageCache, on background threads, and every level of their
+ * mip chain, from the largest down, is uploaded through a ring of pixel buffer objects a few rows at a time by every
+ * update, so that no update uploads more than the upload budget. Until then, textures are bound to a shared
+ * placeholder texture. Compressed images are read on background threads too, and uploaded whole.
  * @author Nathaniel Rex
  */
 class TextureLoader
@@ -12,7 +74,17 @@ class TextureLoader
 public:
 
 	/**
-	 * Destructor
+	 * Default number of bytes uploaded by a single update
+	 */
+	static const unsigned int DEFAULT_UPLOAD_BUDGET;
+
+	/**
+	 * Default GPU memory the cached textures may hold before they are evicted, in bytes
+	 */
+	static const unsigned long long DEFAULT_MEMORY_BUDGET;
+
+	/**
+	 * Destructor. Waits for the decodes in progress to finish.
 	 */
 	~TextureLoader();
 
@@ -25,6 +97,62 @@ public:
 	 */
 	static TexturePtr load(const std::string& path, bool flip = false);
 
+	/**
+	 * Starts loading a texture in the background, unless it already exists. The returned texture is bound to a
+	 * placeholder until later updates have uploaded the image, and ends up failed without throwing if the image
+	 * cannot be loaded. Must be called from the thread owning the GL context.
+	 * @param path Relative path to the image file that will be used to generate the texture. This path is relative
+	 * to the directory containing the currently running executable.
+	 * @param flip (Optional) Boolean flag that, when true, will cause the imagery to be flipped. Defaults to false.
+	 * @return The texture
+	 */
+	static TexturePtr loadAsync(const std::string& path, bool flip = false);
+
+	/**
+	 * Uploads the images decoded since the last update, without exceeding the upload budget. Called by the renderer
+	 * once per frame. Must be called from the thread owning the GL context.
+	 */
+	static void update();
+
+	/**
+	 * Waits until every image loading asynchronously has been decoded, and uploads them all regardless of the upload
+	 * budget. Must be called from the thread owning the GL context.
+	 */
+	static void flush();
+
+	/**
+	 * @return The number of textures loading asynchronously, which are either being decoded or uploaded
+	 */
+	static unsigned int getNumPending();
+
+	/**
+	 * @return The number of bytes uploaded by a single update
+	 */
+	static unsigned int getUploadBudget();
+
+	/**
+	 * Sets the number of bytes uploaded by a single update. Every update uploads at least a single row of an image.
+	 * @param budget The number of bytes
+	 */
+	static void setUploadBudget(unsigned int budget);
+
+	/**
+	 * @return GPU memory the cached textures may hold before they are evicted, in bytes
+	 */
+	static unsigned long long getMemoryBudget();
+
+	/**
+	 * Sets the GPU memory the cached textures may hold before they are evicted, evicting textures right away if they
+	 * exceed the new budget
+	 * @param budget The number of bytes
+	 */
+	static void setMemoryBudget(unsigned long long budget);
+
+	/**
+	 * @return Statistics describing the cached textures
+	 */
+	static TextureLoaderStats getStats();
+
 	/**
 	 * Resets the global texture loader instance to its initial state, prior to graphics initialization
 	 */
@@ -32,15 +160,194 @@ public:
 
 private:
 
+	/**
+	 * The number of pixel buffer objects uploads cycle through
+	 */
+	static const unsigned int NUM_PIXEL_BUFFERS;
+
+	/**
+	 * Identifies a cached texture by its path and load options
+	 */
+	struct TextureKey {
+		std::string path;
+		bool flip = false;
+
+		/**
+		 * @param key Key to compare to
+		 * @return True if both keys identify the same texture. Returns false otherwise.
+		 */
+		bool operator==(const TextureKey& key) const;
+
+		/**
+		 * Hash structure for TextureKey
+		 */
+		struct Hash {
+
+			/**
+			 * Hash function
+			 * @param key Key
+			 * @return Hash result
+			 */
+			std::size_t operator()(const TextureKey& key) const noexcept;
+		};
+	};
+
+	/**
+	 * A cached texture
+	 */
+	struct CacheEntry {
+		TextureKey key;
+		TexturePtr texture;
+
+		/**
+		 * GPU memory held by the texture when it was last accounted for, in bytes
+		 */
+		unsigned long long memorySize = 0;
+	};
+
+	/**
+	 * A texture loading asynchronously
+	 */
+	struct PendingTexture {
+		TexturePtr texture;
+		std::string path;
+		bool flip = false;
+
+		/**
+		 * The image along with every level of its mip chain
+		 */
+		std::unique_ptr<MipmappedImage> image;
+
+		/**
+		 * Compressed image read in place of the image, for KTX2 and DDS containers
+		 */
+		std::unique_ptr<CompressedImage> compressed;
+
+		/**
+		 * Reason the image failed to decode, if it did
+		 */
+		std::string error;
+
+		/**
+		 * GLFW id of the texture being uploaded, or 0 if the upload has not started
+		 */
+		unsigned int id = 0;
+
+		/**
+		 * The level of the mip chain being uploaded
+		 */
+		unsigned int nextLevel = 0;
+
+		/**
+		 * The first row of the level being uploaded that is not uploaded yet
+		 */
+		unsigned int nextRow = 0;
+	};
+
 	/**
 	 * Global texture loader instance
 	 */
 	static std::unique_ptr<TextureLoader> _INSTANCE;
 
 	/**
-	 * Mapping from image filepaths to textures that have been created
+	 * Cached textures, from the most to the least recently loaded
+	 */
+	std::list<CacheEntry> _entries;
+
+	/**
+	 * Mapping from texture keys to cached textures
+	 */
+	std::unordered_map<TextureKey, std::list<CacheEntry>::iterator, TextureKey::Hash> _index;
+
+	/**
+	 * GPU memory the cached textures may hold before they are evicted, in bytes
+	 */
+	unsigned long long _memoryBudget;
+
+	/**
+	 * GPU memory held by the cached textures, in bytes
+	 */
+	unsigned long long _bytesResident = 0;
+
+	/**
+	 * The number of loads that found their texture in the cache
+	 */
+	unsigned long long _numHits = 0;
+
+	/**
+	 * The number of loads that had to create their texture
+	 */
+	unsigned long long _numMisses = 0;
+
+	/**
+	 * The number of textures evicted from the cache
+	 */
+	unsigned long long _numEvictions = 0;
+
+	/**
+	 * The number of bytes uploaded by a single update
+	 */
+	unsigned int _uploadBudget;
+
+	/**
+	 * GLFW id of the placeholder texture, or 0 if it has not been created
+	 */
+	unsigned int _placeholderId = 0;
+
+	/**
+	 * Pixel buffer objects uploads cycle through, created the first time they are used
+	 */
+	std::vector<unsigned int> _pixelBuffers;
+
+	/**
+	 * Index of the pixel buffer object used by the next upload
 	 */
-	std::unordered_map<std::string, TexturePtr> _textures;
+	unsigned int _nextPixelBuffer = 0;
+
+	/**
+	 * Textures waiting to be decoded, in the order they were requested
+	 */
+	std::deque<PendingTexture> _requests;
+
+	/**
+	 * Textures decoded by background threads since the last update
+	 */
+	std::vector<PendingTexture> _decoded;
+
+	/**
+	 * Decoded textures waiting to be uploaded, in the order they were decoded
+	 */
+	std::deque<PendingTexture> _uploads;
+
+	/**
+	 * The number of textures being decoded by background threads
+	 */
+	unsigned int _numDecoding = 0;
+
+	/**
+	 * Boolean flag that, when true, tells the background threads to exit
+	 */
+	bool _stopping = false;
+
+	/**
+	 * Guards the requests, the decoded textures, and the number of textures being decoded
+	 */
+	mutable std::mutex _mutex;
+
+	/**
+	 * Signalled when textures are requested, or the background threads should exit
+	 */
+	std::condition_variable _requested;
+
+	/**
+	 * Signalled when a background thread finishes decoding a texture
+	 */
+	std::condition_variable _finished;
+
+	/**
+	 * Background threads decoding images, started the first time a texture is loaded asynchronously
+	 */
+	std::vector<std::thread> _workers;
 
 	/**
 	 * Constructor
@@ -69,4 +376,54 @@ private:
 	 * @return The global texture loader instance
 	 */
 	static TextureLoader* getInstance();
-};
\ No newline at end of file
+
+	/**
+	 * Finds a cached texture, marking it as the most recently loaded and counting the hit or miss
+	 * @param key Texture key
+	 * @return The texture, or null if it is not cached
+	 */
+	TexturePtr find(const TextureKey& key);
+
+	/**
+	 * Adds a texture to the cache as the most recently loaded, then evicts textures exceeding the memory budget
+	 * @param key Texture key
+	 * @param texture The texture
+	 */
+	void insert(const TextureKey& key, const TexturePtr& texture);
+
+	/**
+	 * Accounts for the memory held by a cached texture once its asynchronous upload has finished
+	 * @param pending Texture loaded asynchronously
+	 */
+	void account(const PendingTexture& pending);
+
+	/**
+	 * Evicts the least recently loaded textures that are no longer referenced outside the cache, until the cached
+	 * textures fit within the memory budget
+	 */
+	void evict();
+
+	/**
+	 * Body of every background thread, decoding requested images until the loader is destroyed
+	 */
+	void work();
+
+	/**
+	 * Moves the textures decoded by background threads to the uploads, marking those that failed to decode
+	 */
+	void collectDecoded();
+
+	/**
+	 * Uploads decoded textures in order
+	 * @param budget Maximum number of bytes to upload
+	 */
+	void upload(unsigned long long budget);
+
+	/**
+	 * Uploads rows of the level being uploaded of a decoded texture, creating the texture when its upload starts, and
+	 * moves on to the next level once every row of the level is uploaded
+	 * @param pending Decoded texture
+	 * @param numRows The number of rows to upload
+	 */
+	void uploadRows(PendingTexture& pending, unsigned int numRows);
+};
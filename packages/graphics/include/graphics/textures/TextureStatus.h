@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * Enumeration describing the loading state of a texture
+ * @author Nathaniel Rex
+ */
+enum class TextureStatus
+{
+
+	/**
+	 * The image is still being decoded or uploaded. A placeholder is bound in its place.
+	 */
+	LOADING,
+
+	/**
+	 * The image has been uploaded and can be sampled
+	 */
+	READY,
+
+	/**
+	 * The image could not be loaded. The placeholder remains bound in its place.
+	 */
+	FAILED
+};
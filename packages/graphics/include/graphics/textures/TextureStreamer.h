@@ -0,0 +1,303 @@
+#pragma once
+#include <graphics/textures/pointers/TexturePtr.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MipmappedImage;
+class Texture;
+
+/**
+ * Statistics describing the textures whose mip levels are streamed
+ * @author Nathaniel Rex
+ */
+struct TextureStreamerStats {
+
+	/**
+	 * The number of streamed textures
+	 */
+	unsigned int numTextures = 0;
+
+	/**
+	 * The number of streamed textures whose finest resident level is coarser than the level requested by the last
+	 * update
+	 */
+	unsigned int numRefining = 0;
+
+	/**
+	 * GPU memory held by the resident levels of every streamed texture, in bytes
+	 */
+	unsigned long long bytesResident = 0;
+
+	/**
+	 * The number of levels uploaded since the streamer was created, excluding the tails uploaded on load
+	 */
+	unsigned long long numUploads = 0;
+
+	/**
+	 * The number of levels dropped to stay within the memory budget
+	 */
+	unsigned long long numDrops = 0;
+};
+
+
+/**
+ * The texture streamer is a singleton that keeps only the mip levels of large textures that are needed on screen in
+ * GPU memory.
+ *
+ * Streamed textures are created with the levels no larger than the tail size, so they can be drawn at a low
+ * resolution almost immediately. The renderer then requests every texture it draws with the size of its mesh on
+ * screen, and every update uploads the next finer level of the textures needing more detail, largest on screen
+ * first, without uploading more than the upload budget. Levels finer than requested are dropped, coarsest demand
+ * first, only once the resident levels exceed the memory budget. The sampled levels are clamped with
+ * GL_TEXTURE_BASE_LEVEL, and the full mip chain is kept in system memory, or mapped from the image cache, so that
+ * dropped levels can be uploaded again.
+ * @author Nathaniel Rex
+ */
+class TextureStreamer
+{
+public:
+
+	/**
+	 * Largest width or height of the levels uploaded when a texture is created, which are never dropped
+	 */
+	static const unsigned int TAIL_SIZE;
+
+	/**
+	 * Default GPU memory that the resident levels of streamed textures may hold, in bytes
+	 */
+	static const unsigned long long DEFAULT_MEMORY_BUDGET;
+
+	/**
+	 * Default number of bytes uploaded by a single update
+	 */
+	static const unsigned int DEFAULT_UPLOAD_BUDGET;
+
+	/**
+	 * Destructor
+	 */
+	~TextureStreamer();
+
+	/**
+	 * Loads a streamed texture from an image located at the given file path, creating it if it does not yet exist.
+	 * Only the tail of its mip chain is resident until the texture is requested. Compressed images, which hold
+	 * prebuilt mip chains, are loaded whole instead.
+	 * @param path Relative path to the image file that will be used to generate the texture. This path is relative
+	 * to the directory containing the currently running executable.
+	 * @param flip (Optional) Boolean flag that, when true, will cause the imagery to be flipped. Defaults to false.
+	 * @return The texture
+	 * @throws InstantiationException If the image could not be loaded
+	 */
+	static TexturePtr load(const std::string& path, bool flip = false);
+
+	/**
+	 * Requests the levels of a texture needed to draw it at a given size on screen until the next update. Several
+	 * requests for the same texture keep the largest size. Does nothing if the texture is not streamed.
+	 * @param texture The texture. Can be null.
+	 * @param screenSize Size of the texture on screen, in pixels
+	 */
+	static void request(const TexturePtr& texture, float screenSize);
+
+	/**
+	 * Drops levels exceeding the memory budget, then uploads the levels requested since the last update without
+	 * exceeding the upload budget. Called by the renderer once per frame. Must be called from the thread owning the
+	 * GL context.
+	 */
+	static void update();
+
+	/**
+	 * @param texture The texture
+	 * @return True if the levels of the texture are streamed. Returns false otherwise.
+	 */
+	static bool isStreamed(const TexturePtr& texture);
+
+	/**
+	 * @param texture Streamed texture
+	 * @return The finest level of the texture that is resident in GPU memory
+	 * @throws IllegalArgumentException If the texture is not streamed
+	 */
+	static unsigned int getResidentLevel(const TexturePtr& texture);
+
+	/**
+	 * Computes the coarsest level holding at least a texel for every pixel of a texture drawn at a given size on
+	 * screen
+	 * @param width The width of the texture, in pixels
+	 * @param height The height of the texture, in pixels
+	 * @param screenSize Size of the texture on screen, in pixels
+	 * @return The level, between 0 and the coarsest level of the texture
+	 */
+	static unsigned int computeLevel(unsigned int width, unsigned int height, float screenSize);
+
+	/**
+	 * @return GPU memory that the resident levels of streamed textures may hold, in bytes
+	 */
+	static unsigned long long getMemoryBudget();
+
+	/**
+	 * Sets the GPU memory that the resident levels of streamed textures may hold. Levels beyond the tail of every
+	 * texture are dropped by the next update until the budget is met.
+	 * @param budget The number of bytes
+	 */
+	static void setMemoryBudget(unsigned long long budget);
+
+	/**
+	 * @return The number of bytes uploaded by a single update
+	 */
+	static unsigned int getUploadBudget();
+
+	/**
+	 * Sets the number of bytes uploaded by a single update. Every update uploads at least a single level, provided
+	 * it fits within the memory budget.
+	 * @param budget The number of bytes
+	 */
+	static void setUploadBudget(unsigned int budget);
+
+	/**
+	 * @return Statistics describing the streamed textures
+	 */
+	static TextureStreamerStats getStats();
+
+	/**
+	 * Resets the global texture streamer instance to its initial state, prior to graphics initialization. Streamed
+	 * textures remain valid, but keep their resident levels from then on.
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * A texture whose levels are streamed
+	 */
+	struct StreamedTexture {
+
+		/**
+		 * The texture. Expires once no one references it, upon which its GL texture is deleted.
+		 */
+		std::weak_ptr<Texture> texture;
+		std::string path;
+		bool flip = false;
+
+		/**
+		 * The image along with every level of its mip chain
+		 */
+		std::unique_ptr<MipmappedImage> image;
+
+		/**
+		 * The finest resident level
+		 */
+		unsigned int residentLevel = 0;
+
+		/**
+		 * The finest level of the tail, which is uploaded on load and never dropped
+		 */
+		unsigned int tailLevel = 0;
+
+		/**
+		 * The largest size on screen requested since the last update, in pixels, or 0 if the texture was not
+		 * requested
+		 */
+		float screenSize = 0.f;
+
+		/**
+		 * The finest level requested by the last update
+		 */
+		unsigned int requestedLevel = 0;
+	};
+
+	/**
+	 * Global texture streamer instance
+	 */
+	static std::unique_ptr<TextureStreamer> _INSTANCE;
+
+	/**
+	 * Streamed textures
+	 */
+	std::vector<StreamedTexture> _textures;
+
+	/**
+	 * Mapping from textures to their index within the streamed textures
+	 */
+	std::unordered_map<const Texture*, unsigned int> _indices;
+
+	/**
+	 * GPU memory that the resident levels may hold, in bytes
+	 */
+	unsigned long long _memoryBudget;
+
+	/**
+	 * The number of bytes uploaded by a single update
+	 */
+	unsigned int _uploadBudget;
+
+	/**
+	 * GPU memory held by the resident levels, in bytes
+	 */
+	unsigned long long _bytesResident = 0;
+
+	/**
+	 * The number of levels uploaded by updates
+	 */
+	unsigned long long _numUploads = 0;
+
+	/**
+	 * The number of levels dropped by updates
+	 */
+	unsigned long long _numDrops = 0;
+
+	/**
+	 * Constructor
+	 */
+	TextureStreamer();
+
+	/**
+	 * Constructor
+	 * @param streamer Texture streamer to copy from
+	 */
+	TextureStreamer(const TextureStreamer& streamer) = delete;
+
+	/**
+	 * Constructor
+	 * @param streamer Texture streamer to copy from
+	 */
+	TextureStreamer(TextureStreamer&& streamer) = delete;
+
+	/**
+	 * Assignment operator
+	 * @param streamer Texture streamer to assign from
+	 */
+	TextureStreamer& operator=(const TextureStreamer& streamer) = delete;
+
+	/**
+	 * @return The global texture streamer instance
+	 */
+	static TextureStreamer* getInstance();
+
+	/**
+	 * Removes the textures no longer referenced by anyone
+	 */
+	void prune();
+
+	/**
+	 * Drops the finest resident level of a texture, clamping its sampled levels first
+	 * @param streamed Streamed texture
+	 * @param texture The texture
+	 */
+	void drop(StreamedTexture& streamed, Texture& texture);
+
+	/**
+	 * Uploads the level of a texture just finer than its finest resident level, then samples it
+	 * @param streamed Streamed texture
+	 * @param texture The texture
+	 */
+	void refine(StreamedTexture& streamed, Texture& texture);
+
+	/**
+	 * Drops levels finer than requested from textures other than the given one, least requested first, until a
+	 * number of bytes fits within the memory budget
+	 * @param size The number of bytes
+	 * @param exclude Index of the texture whose levels are kept
+	 * @return True if the bytes fit. Returns false otherwise.
+	 */
+	bool makeRoom(unsigned long long size, unsigned int exclude);
+};
@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * Shared pointer to a TextureArray instance
+ */
+using TextureArrayPtr = std::shared_ptr<class TextureArray>;
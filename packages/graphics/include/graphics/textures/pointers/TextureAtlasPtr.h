@@ -0,0 +1,7 @@
+#pragma once
+#include <memory>
+
+/**
+ * Shared pointer to a TextureAtlas instance
+ */
+using TextureAtlasPtr = std::shared_ptr<class TextureAtlas>;
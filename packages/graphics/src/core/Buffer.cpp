@@ -1,79 +1,139 @@
 #include <graphics/core/Buffer.h>
+#include <graphics/core/GeometryArena.h>
+#include <graphics/core/GeometryPool.h>
 #include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/geometry/VertexPacker.h>
+#include <common/Assertions.h>
+#include <common/exceptions/OutOfBoundsException.h>
 #include <glad/glad.h>
 
 Buffer::Buffer(const GeometryAttributes& attributes, const float* vertices, unsigned int numValues,
-	const unsigned int* indices, unsigned int numIndices): size(numIndices)
+	const unsigned int* indices, unsigned int numIndices, BufferUsage usage): size(numIndices), _usage(usage),
+	_numVertices(numValues / attributes.getStride()), _shortIndices(_numVertices <= MAX_SHORT_INDEX_VERTICES)
 {
-	// Create buffers
-	glGenVertexArrays(1, &_vaoId);
-	glGenBuffers(1, &_vboId);
-	glGenBuffers(1, &_eboId);
-	glBindVertexArray(_vaoId);
-
-	// Load vertex data
-	glBindBuffer(GL_ARRAY_BUFFER, _vboId);
-	glBufferData(GL_ARRAY_BUFFER, numValues * sizeof(float), vertices, GL_STATIC_DRAW);
-
-	// Load index data
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _eboId);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(unsigned int), indices, GL_STATIC_DRAW);
-
-	int stride = attributes.getStride();
-	long long offset = 0;
-
-	// Position attribute
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride * sizeof(float), (void*)offset);
-	glEnableVertexAttribArray(0);
-	offset += 3;
-
-	// Normal attribute (if present)
-	if (attributes.normals)
+	unsigned int numRegions = usage == BufferUsage::STREAM ? NUM_STREAM_REGIONS : 1;
+	GeometryArena::allocate(&_allocation, attributes, vertices, numValues, indices, numIndices, usage, numRegions,
+		_shortIndices);
+}
+
+Buffer::~Buffer()
+{
+	for (void*& fence : _fences)
 	{
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride * sizeof(float), (void*)(offset * sizeof(float)));
-		glEnableVertexAttribArray(1);
-		offset += 3;
+		if (fence)
+		{
+			glDeleteSync(static_cast<GLsync>(fence));
+			fence = nullptr;
+		}
 	}
 
-	// Color attribute (if present)
-	if (attributes.colors)
+	GeometryArena::release(&_allocation);
+}
+
+BufferUsage Buffer::getUsage() const
+{
+	return _usage;
+}
+
+unsigned int Buffer::getNumVertices() const
+{
+	return _numVertices;
+}
+
+void Buffer::updateVertices(const float* vertexData, unsigned int firstVertex, unsigned int numVertices)
+{
+	if (firstVertex + numVertices > _numVertices)
 	{
-		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride * sizeof(float), (void*)(offset * sizeof(float)));
-		glEnableVertexAttribArray(2);
-		offset += 4;
+		throw OutOfBoundsException("Vertex range lies outside of the buffer");
 	}
 
-	// Texture attribute (if present)
-	if (attributes.uvs)
+	if (!_allocation.pool || numVertices == 0)
 	{
-		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride * sizeof(float), (void*)(offset * sizeof(float)));
-		glEnableVertexAttribArray(3);
-		offset += 2;
+		return;
 	}
+
+	if (_usage != BufferUsage::STREAM)
+	{
+		_allocation.pool->updateVertices(&_allocation, vertexData, firstVertex, numVertices);
+		return;
+	}
+
+	assertTrue(firstVertex == 0 && numVertices == _numVertices, "Stream buffers must be updated in full");
+
+	// Move on to the next region, waiting for the GPU to finish any draw that is still reading it
+	_region = (_region + 1) % NUM_STREAM_REGIONS;
+	GLsync sync = static_cast<GLsync>(_fences[_region]);
+	if (sync)
+	{
+		glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(sync);
+		_fences[_region] = nullptr;
+	}
+
+	void* mapped = _allocation.pool->mapVertices(&_allocation, _region * _numVertices, _numVertices);
+	if (mapped)
+	{
+		VertexPacker::pack(_allocation.pool->attributes, vertexData, _numVertices, mapped);
+	}
+	_allocation.pool->unmapVertices();
 }
 
-Buffer::~Buffer()
+void Buffer::updateIndices(const unsigned int* indices, unsigned int firstIndex, unsigned int numIndices)
 {
-	GLint boundVAO = 0;
-	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &boundVAO);
-	if (boundVAO == _vaoId)
+	if (firstIndex + numIndices > size)
+	{
+		throw OutOfBoundsException("Index range lies outside of the buffer");
+	}
+
+	if (_allocation.pool && numIndices > 0)
 	{
-		// Buffer is currently bound. Make sure to unbind it first.
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		_allocation.pool->updateIndices(&_allocation, indices, firstIndex, numIndices);
 	}
+}
 
-	glDeleteVertexArrays(1, &_vaoId);
-	glDeleteBuffers(1, &_vboId);
-	glDeleteBuffers(1, &_eboId);
+void Buffer::fence()
+{
+	if (_usage != BufferUsage::STREAM)
+	{
+		return;
+	}
 
-	_vaoId = 0;
-	_vboId = 0;
-	_eboId = 0;
+	if (_fences[_region])
+	{
+		glDeleteSync(static_cast<GLsync>(_fences[_region]));
+	}
+	_fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
 void Buffer::bind() const
 {
-	glBindVertexArray(_vaoId);
+	if (_allocation.pool)
+	{
+		_allocation.pool->bind();
+	}
+}
+
+int Buffer::getBaseVertex() const
+{
+	return (int)(_allocation.vertexOffset + _region * _numVertices);
+}
+
+unsigned int Buffer::getIndexOffset() const
+{
+	return _allocation.indexOffset;
+}
+
+const void* Buffer::getIndexPointer() const
+{
+	return (const void*)((unsigned long long) _allocation.indexOffset * getIndexSize());
+}
+
+unsigned int Buffer::getIndexType() const
+{
+	return _shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+unsigned int Buffer::getIndexSize() const
+{
+	return _shortIndices ? sizeof(unsigned short) : sizeof(unsigned int);
 }
\ No newline at end of file
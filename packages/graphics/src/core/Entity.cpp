@@ -105,12 +105,14 @@ void Entity::updatePosition(float x, float y, float z)
 	_position.y = y;
 	_position.z = z;
 	_transformNeedsUpdate = true;
+	_version++;
 }
 
 void Entity::updateRotation(float m00, float m01, float m02, float m10, float m11, float m12, float m20, float m21, float m22)
 {
 	_rotation.setValues(m00, m01, m02, m10, m11, m12, m20, m21, m22);
 	_transformNeedsUpdate = true;
+	_version++;
 }
 
 void Entity::updateScaling(float x, float y, float z)
@@ -119,6 +121,7 @@ void Entity::updateScaling(float x, float y, float z)
 	_scale.y = y;
 	_scale.z = z;
 	_transformNeedsUpdate = true;
+	_version++;
 }
 
 void Entity::updateTransform()
@@ -145,6 +148,16 @@ unsigned int Entity::getNumberOfChildren() const
 	return _children.size();
 }
 
+const std::vector<EntityPtr>& Entity::getChildren() const
+{
+	return _children;
+}
+
+unsigned int Entity::getVersion() const
+{
+	return _version;
+}
+
 void Entity::add(EntityPtr child)
 {
 	if (child->_parent != nullptr)
@@ -154,6 +167,7 @@ void Entity::add(EntityPtr child)
 
 	_children.push_back(child);
 	child->_parent = this;
+	_version++;
 }
 
 void Entity::remove(EntityPtr child)
@@ -164,4 +178,6 @@ void Entity::remove(EntityPtr child)
 	{
 		child->_parent = nullptr;
 	}
+
+	_version++;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <graphics/core/EntityGroup.h>
+#include <graphics/core/StaticBatch.h>
 
 EntityGroup::EntityGroup() : Entity(EntityType::GROUP)
 {
@@ -8,4 +9,28 @@ EntityGroup::EntityGroup() : Entity(EntityType::GROUP)
 EntityGroupPtr EntityGroup::create()
 {
 	return std::shared_ptr<EntityGroup>(new EntityGroup());
-}
\ No newline at end of file
+}
+
+bool EntityGroup::isStatic() const
+{
+	return _static;
+}
+
+void EntityGroup::setStatic(bool isStatic)
+{
+	_static = isStatic;
+	if (!isStatic)
+	{
+		_batch = nullptr;
+	}
+}
+
+StaticBatchPtr EntityGroup::getStaticBatch() const
+{
+	return _batch;
+}
+
+void EntityGroup::setStaticBatch(StaticBatchPtr batch)
+{
+	_batch = batch;
+}
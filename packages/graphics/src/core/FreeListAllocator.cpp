@@ -0,0 +1,136 @@
+#include <graphics/core/FreeListAllocator.h>
+#include <common/Assertions.h>
+#include <algorithm>
+#include <climits>
+#include <iterator>
+
+const unsigned int FreeListAllocator::INVALID_OFFSET = UINT_MAX;
+
+FreeListAllocator::FreeListAllocator(unsigned int capacity) : _capacity(capacity)
+{
+	reset();
+}
+
+unsigned int FreeListAllocator::getCapacity() const
+{
+	return _capacity;
+}
+
+unsigned int FreeListAllocator::getUsed() const
+{
+	return _used;
+}
+
+unsigned int FreeListAllocator::getNumFreeBlocks() const
+{
+	return (unsigned int) _free.size();
+}
+
+unsigned int FreeListAllocator::getLargestFreeBlock() const
+{
+	unsigned int largest = 0;
+	for (const auto& block : _free)
+	{
+		largest = std::max(largest, block.second);
+	}
+
+	return largest;
+}
+
+unsigned int FreeListAllocator::allocate(unsigned int size)
+{
+	if (size == 0)
+	{
+		return INVALID_OFFSET;
+	}
+
+	auto best = _free.end();
+	for (auto it = _free.begin(); it != _free.end(); it++)
+	{
+		if (it->second >= size && (best == _free.end() || it->second < best->second))
+		{
+			best = it;
+			if (it->second == size)
+			{
+				break;
+			}
+		}
+	}
+
+	if (best == _free.end())
+	{
+		return INVALID_OFFSET;
+	}
+
+	// Carve the block from the front of the free block
+	unsigned int offset = best->first;
+	unsigned int remaining = best->second - size;
+	_free.erase(best);
+	if (remaining > 0)
+	{
+		_free.emplace(offset + size, remaining);
+	}
+
+	_used += size;
+	return offset;
+}
+
+void FreeListAllocator::free(unsigned int offset, unsigned int size)
+{
+	assertTrue(size > 0 && offset + size <= _capacity, "Block lies outside of the address range");
+
+	auto next = _free.lower_bound(offset);
+	assertTrue(next == _free.end() || offset + size <= next->first, "Block overlaps free space");
+
+	unsigned int start = offset;
+	unsigned int end = offset + size;
+
+	// Coalesce with the preceding free block
+	if (next != _free.begin())
+	{
+		auto prev = std::prev(next);
+		assertTrue(prev->first + prev->second <= offset, "Block overlaps free space");
+		if (prev->first + prev->second == offset)
+		{
+			start = prev->first;
+			_free.erase(prev);
+		}
+	}
+
+	// Coalesce with the following free block
+	if (next != _free.end() && next->first == end)
+	{
+		end += next->second;
+		_free.erase(next);
+	}
+
+	_free[start] = end - start;
+	_used -= size;
+}
+
+void FreeListAllocator::grow(unsigned int capacity)
+{
+	assertTrue(capacity >= _capacity, "Allocator capacity cannot shrink");
+	if (capacity == _capacity)
+	{
+		return;
+	}
+
+	unsigned int offset = _capacity;
+	unsigned int size = capacity - _capacity;
+	_capacity = capacity;
+
+	// Register the new space as a free block, coalescing with a free block at the end of the old range
+	_used += size;
+	free(offset, size);
+}
+
+void FreeListAllocator::reset()
+{
+	_free.clear();
+	_used = 0;
+	if (_capacity > 0)
+	{
+		_free.emplace(0, _capacity);
+	}
+}
@@ -0,0 +1,60 @@
+#include <graphics/core/GLCapabilities.h>
+#include <glad/glad.h>
+
+std::unique_ptr<GLCapabilities> GLCapabilities::_INSTANCE = nullptr;
+
+GLCapabilities::GLCapabilities()
+{
+	GLint numExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+	for (GLint i = 0; i < numExtensions; i++)
+	{
+		const char* extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+		if (extension)
+		{
+			_extensions.insert(extension);
+		}
+	}
+
+	GLint major = 0;
+	GLint minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	_major = major;
+	_minor = minor;
+}
+
+GLCapabilities::~GLCapabilities()
+{
+
+}
+
+GLCapabilities* GLCapabilities::getInstance()
+{
+	if (!_INSTANCE)
+	{
+		_INSTANCE = std::unique_ptr<GLCapabilities>(new GLCapabilities());
+	}
+
+	return _INSTANCE.get();
+}
+
+bool GLCapabilities::hasExtension(const std::string& name)
+{
+	const std::unordered_set<std::string>& extensions = getInstance()->_extensions;
+	return extensions.find(name) != extensions.end();
+}
+
+bool GLCapabilities::hasVersion(int major, int minor)
+{
+	GLCapabilities* capabilities = getInstance();
+	return capabilities->_major > major || (capabilities->_major == major && capabilities->_minor >= minor);
+}
+
+void GLCapabilities::reset()
+{
+	if (_INSTANCE)
+	{
+		_INSTANCE.reset();
+	}
+}
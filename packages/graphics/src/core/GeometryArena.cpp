@@ -0,0 +1,127 @@
+#include <graphics/core/GeometryArena.h>
+#include <graphics/core/GeometryPool.h>
+#include <graphics/core/GeometryAllocation.h>
+#include <graphics/geometry/GeometryAttributes.h>
+
+std::unique_ptr<GeometryArena> GeometryArena::_INSTANCE = nullptr;
+
+const unsigned int GeometryArena::DEFAULT_VERTEX_CAPACITY = 1 << 16;
+const unsigned int GeometryArena::DEFAULT_INDEX_CAPACITY = 1 << 18;
+
+GeometryArena::GeometryArena()
+{
+
+}
+
+GeometryArena::~GeometryArena()
+{
+	_pools.clear();
+}
+
+GeometryArena* GeometryArena::getInstance()
+{
+	if (!_INSTANCE)
+	{
+		_INSTANCE = std::unique_ptr<GeometryArena>(new GeometryArena());
+	}
+
+	return _INSTANCE.get();
+}
+
+int GeometryArena::getPoolKey(const GeometryAttributes& attributes, BufferUsage usage, bool shortIndices)
+{
+	int layout = (attributes.normals ? 1 : 0) | (attributes.colors ? 2 : 0) | (attributes.uvs ? 4 : 0);
+
+	// Storage formats only distinguish pools for attributes that are present
+	int formats = 0;
+	if (attributes.normals)
+	{
+		formats |= static_cast<int>(attributes.normalFormat);
+	}
+	if (attributes.colors)
+	{
+		formats |= static_cast<int>(attributes.colorFormat) << 2;
+	}
+	if (attributes.uvs)
+	{
+		formats |= static_cast<int>(attributes.uvFormat) << 4;
+	}
+
+	return layout | (static_cast<int>(usage) << 3) | ((shortIndices ? 1 : 0) << 5) | (formats << 6);
+}
+
+void GeometryArena::allocate(GeometryAllocation* allocation, const GeometryAttributes& attributes,
+	const float* vertexData, unsigned int numValues, const unsigned int* indices, unsigned int numIndices,
+	BufferUsage usage, unsigned int numRegions, bool shortIndices)
+{
+	GeometryArena* arena = getInstance();
+
+	int key = getPoolKey(attributes, usage, shortIndices);
+	auto it = arena->_pools.find(key);
+	if (it == arena->_pools.end())
+	{
+		GeometryPool* pool = new GeometryPool(attributes, usage, shortIndices, DEFAULT_VERTEX_CAPACITY,
+			DEFAULT_INDEX_CAPACITY);
+		it = arena->_pools.emplace(key, std::unique_ptr<GeometryPool>(pool)).first;
+	}
+
+	unsigned int numVertices = numValues / attributes.getStride();
+	it->second->allocate(allocation, vertexData, numVertices, indices, numIndices, numRegions);
+}
+
+void GeometryArena::release(GeometryAllocation* allocation)
+{
+	if (allocation->pool)
+	{
+		allocation->pool->release(allocation);
+	}
+}
+
+void GeometryArena::defragment()
+{
+	if (!_INSTANCE)
+	{
+		return;
+	}
+
+	for (auto& pair : _INSTANCE->_pools)
+	{
+		pair.second->defragment();
+	}
+}
+
+GeometryArenaStats GeometryArena::getStats()
+{
+	GeometryArenaStats stats;
+	if (!_INSTANCE)
+	{
+		return stats;
+	}
+
+	for (const auto& pair : _INSTANCE->_pools)
+	{
+		const GeometryPool* pool = pair.second.get();
+		const FreeListAllocator& vertices = pool->getVertexAllocator();
+		const FreeListAllocator& indices = pool->getIndexAllocator();
+		unsigned long long vertexSize = pool->getVertexSize();
+		unsigned long long indexSize = pool->getIndexSize();
+
+		stats.numPools++;
+		stats.numAllocations += pool->getNumAllocations();
+		stats.numFreeBlocks += vertices.getNumFreeBlocks() + indices.getNumFreeBlocks();
+		stats.vertexBytes += vertices.getCapacity() * vertexSize;
+		stats.vertexBytesUsed += vertices.getUsed() * vertexSize;
+		stats.indexBytes += indices.getCapacity() * indexSize;
+		stats.indexBytesUsed += indices.getUsed() * indexSize;
+	}
+
+	return stats;
+}
+
+void GeometryArena::reset()
+{
+	if (_INSTANCE)
+	{
+		_INSTANCE.reset();
+	}
+}
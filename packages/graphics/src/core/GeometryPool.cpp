@@ -0,0 +1,423 @@
+#include <graphics/core/GeometryPool.h>
+#include <graphics/core/GeometryAllocation.h>
+#include <graphics/geometry/VertexPacker.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <vector>
+
+GeometryPool::GeometryPool(const GeometryAttributes& attributes, BufferUsage usage, bool shortIndices,
+	unsigned int vertexCapacity, unsigned int indexCapacity) : attributes(attributes), usage(usage),
+	shortIndices(shortIndices), _vertices(vertexCapacity), _indices(indexCapacity)
+{
+	switch (usage)
+	{
+		case BufferUsage::DYNAMIC:
+		{
+			_glUsage = GL_DYNAMIC_DRAW;
+			break;
+		}
+		case BufferUsage::STREAM:
+		{
+			_glUsage = GL_STREAM_DRAW;
+			break;
+		}
+		default:
+		{
+			_glUsage = GL_STATIC_DRAW;
+		}
+	}
+
+	glGenVertexArrays(1, &_vaoId);
+	glGenBuffers(1, &_vboId);
+	glGenBuffers(1, &_eboId);
+
+	// Reserve storage for both buffers without uploading any data
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _vboId);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) vertexCapacity * getVertexSize(), nullptr, _glUsage);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _eboId);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) indexCapacity * getIndexSize(), nullptr, _glUsage);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	attachBuffers();
+}
+
+GeometryPool::~GeometryPool()
+{
+	for (GeometryAllocation* allocation : _allocations)
+	{
+		allocation->pool = nullptr;
+	}
+	_allocations.clear();
+
+	GLint boundVAO = 0;
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &boundVAO);
+	if ((GLuint) boundVAO == _vaoId)
+	{
+		// Pool is currently bound. Make sure to unbind it first.
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	glDeleteVertexArrays(1, &_vaoId);
+	glDeleteBuffers(1, &_vboId);
+	glDeleteBuffers(1, &_eboId);
+
+	_vaoId = 0;
+	_vboId = 0;
+	_eboId = 0;
+}
+
+const FreeListAllocator& GeometryPool::getVertexAllocator() const
+{
+	return _vertices;
+}
+
+const FreeListAllocator& GeometryPool::getIndexAllocator() const
+{
+	return _indices;
+}
+
+unsigned int GeometryPool::getNumAllocations() const
+{
+	return (unsigned int) _allocations.size();
+}
+
+void GeometryPool::allocate(GeometryAllocation* allocation, const float* vertexData, unsigned int numVertices,
+	const unsigned int* indices, unsigned int numIndices, unsigned int numRegions)
+{
+	unsigned int vertexOffset = 0;
+	unsigned int numReserved = numVertices * numRegions;
+	if (numVertices > 0)
+	{
+		vertexOffset = _vertices.allocate(numReserved);
+		if (vertexOffset == FreeListAllocator::INVALID_OFFSET)
+		{
+			growVertices(numReserved);
+			vertexOffset = _vertices.allocate(numReserved);
+		}
+
+		writeVertices(vertexOffset, vertexData, numVertices);
+	}
+
+	unsigned int indexOffset = 0;
+	if (numIndices > 0)
+	{
+		indexOffset = _indices.allocate(numIndices);
+		if (indexOffset == FreeListAllocator::INVALID_OFFSET)
+		{
+			growIndices(numIndices);
+			indexOffset = _indices.allocate(numIndices);
+		}
+
+		writeIndices(indexOffset, indices, numIndices);
+	}
+
+	allocation->pool = this;
+	allocation->vertexOffset = vertexOffset;
+	allocation->numVertices = numReserved;
+	allocation->indexOffset = indexOffset;
+	allocation->numIndices = numIndices;
+	_allocations.insert(allocation);
+}
+
+void GeometryPool::updateVertices(const GeometryAllocation* allocation, const float* vertexData,
+	unsigned int firstVertex, unsigned int numVertices)
+{
+	writeVertices(allocation->vertexOffset + firstVertex, vertexData, numVertices);
+}
+
+void GeometryPool::updateIndices(const GeometryAllocation* allocation, const unsigned int* indices,
+	unsigned int firstIndex, unsigned int numIndices)
+{
+	writeIndices(allocation->indexOffset + firstIndex, indices, numIndices);
+}
+
+void GeometryPool::writeVertices(unsigned int vertexOffset, const float* vertexData, unsigned int numVertices)
+{
+	unsigned int vertexSize = getVertexSize();
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _vboId);
+
+	if (attributes.isFloatOnly())
+	{
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) vertexOffset * vertexSize, (GLsizeiptr) numVertices * vertexSize,
+			vertexData);
+	}
+	else
+	{
+		std::vector<unsigned char> packed((size_t) numVertices * vertexSize);
+		VertexPacker::pack(attributes, vertexData, numVertices, packed.data());
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) vertexOffset * vertexSize, (GLsizeiptr) packed.size(),
+			packed.data());
+	}
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GeometryPool::writeIndices(unsigned int indexOffset, const unsigned int* indices, unsigned int numIndices)
+{
+	unsigned int indexSize = getIndexSize();
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _eboId);
+
+	if (shortIndices)
+	{
+		std::vector<unsigned short> narrowed(indices, indices + numIndices);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) indexOffset * indexSize, (GLsizeiptr) numIndices * indexSize,
+			narrowed.data());
+	}
+	else
+	{
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) indexOffset * indexSize, (GLsizeiptr) numIndices * indexSize,
+			indices);
+	}
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void* GeometryPool::mapVertices(const GeometryAllocation* allocation, unsigned int firstVertex,
+	unsigned int numVertices)
+{
+	unsigned int vertexSize = getVertexSize();
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _vboId);
+	void* mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, (GLintptr)(allocation->vertexOffset + firstVertex) * vertexSize,
+		(GLsizeiptr) numVertices * vertexSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	return mapped;
+}
+
+void GeometryPool::unmapVertices()
+{
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _vboId);
+	glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GeometryPool::release(GeometryAllocation* allocation)
+{
+	if (_allocations.erase(allocation) == 0)
+	{
+		return;
+	}
+
+	if (allocation->numVertices > 0)
+	{
+		_vertices.free(allocation->vertexOffset, allocation->numVertices);
+	}
+
+	if (allocation->numIndices > 0)
+	{
+		_indices.free(allocation->indexOffset, allocation->numIndices);
+	}
+
+	allocation->pool = nullptr;
+}
+
+void GeometryPool::defragment()
+{
+	std::vector<GeometryAllocation*> allocations(_allocations.begin(), _allocations.end());
+
+	if (_vertices.getNumFreeBlocks() > 1)
+	{
+		std::sort(allocations.begin(), allocations.end(), [](const GeometryAllocation* a, const GeometryAllocation* b) {
+			return a->vertexOffset < b->vertexOffset;
+		});
+
+		// Copy each live range to the front of a new buffer of the same size
+		unsigned int vertexSize = getVertexSize();
+		unsigned int newVboId = 0;
+		glGenBuffers(1, &newVboId);
+		glBindBuffer(GL_COPY_READ_BUFFER, _vboId);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newVboId);
+		glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) _vertices.getCapacity() * vertexSize, nullptr, _glUsage);
+
+		unsigned int packed = 0;
+		for (GeometryAllocation* allocation : allocations)
+		{
+			if (allocation->numVertices == 0)
+			{
+				continue;
+			}
+
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr) allocation->vertexOffset * vertexSize,
+				(GLintptr) packed * vertexSize, (GLsizeiptr) allocation->numVertices * vertexSize);
+			allocation->vertexOffset = packed;
+			packed += allocation->numVertices;
+		}
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &_vboId);
+		_vboId = newVboId;
+
+		_vertices.reset();
+		_vertices.allocate(packed);
+	}
+
+	if (_indices.getNumFreeBlocks() > 1)
+	{
+		std::sort(allocations.begin(), allocations.end(), [](const GeometryAllocation* a, const GeometryAllocation* b) {
+			return a->indexOffset < b->indexOffset;
+		});
+
+		unsigned int indexSize = getIndexSize();
+		unsigned int newEboId = 0;
+		glGenBuffers(1, &newEboId);
+		glBindBuffer(GL_COPY_READ_BUFFER, _eboId);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newEboId);
+		glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) _indices.getCapacity() * indexSize, nullptr, _glUsage);
+
+		// Indices are relative to the base vertex of each range, so they can be moved without modification
+		unsigned int packed = 0;
+		for (GeometryAllocation* allocation : allocations)
+		{
+			if (allocation->numIndices == 0)
+			{
+				continue;
+			}
+
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+				(GLintptr) allocation->indexOffset * indexSize, (GLintptr) packed * indexSize,
+				(GLsizeiptr) allocation->numIndices * indexSize);
+			allocation->indexOffset = packed;
+			packed += allocation->numIndices;
+		}
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &_eboId);
+		_eboId = newEboId;
+
+		_indices.reset();
+		_indices.allocate(packed);
+	}
+
+	attachBuffers();
+}
+
+void GeometryPool::bind() const
+{
+	glBindVertexArray(_vaoId);
+}
+
+unsigned int GeometryPool::getVertexSize() const
+{
+	return attributes.getVertexSize();
+}
+
+unsigned int GeometryPool::getIndexSize() const
+{
+	return shortIndices ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
+void GeometryPool::growVertices(unsigned int numVertices)
+{
+	unsigned int capacity = _vertices.getCapacity();
+	unsigned int newCapacity = std::max(capacity * 2, capacity + numVertices);
+
+	unsigned int vertexSize = getVertexSize();
+	resizeBuffer(_vboId, (unsigned long long) capacity * vertexSize, (unsigned long long) newCapacity * vertexSize);
+	_vertices.grow(newCapacity);
+	attachBuffers();
+}
+
+void GeometryPool::growIndices(unsigned int numIndices)
+{
+	unsigned int capacity = _indices.getCapacity();
+	unsigned int newCapacity = std::max(capacity * 2, capacity + numIndices);
+
+	unsigned int indexSize = getIndexSize();
+	resizeBuffer(_eboId, (unsigned long long) capacity * indexSize, (unsigned long long) newCapacity * indexSize);
+	_indices.grow(newCapacity);
+	attachBuffers();
+}
+
+void GeometryPool::resizeBuffer(unsigned int& bufferId, unsigned long long oldSize, unsigned long long newSize) const
+{
+	unsigned int newBufferId = 0;
+	glGenBuffers(1, &newBufferId);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, newBufferId);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) newSize, nullptr, _glUsage);
+
+	// Copy existing contents on the GPU, so that live ranges keep their offsets
+	if (oldSize > 0)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, bufferId);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr) oldSize);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glDeleteBuffers(1, &bufferId);
+	bufferId = newBufferId;
+}
+
+void GeometryPool::attachBuffers()
+{
+	glBindVertexArray(_vaoId);
+	glBindBuffer(GL_ARRAY_BUFFER, _vboId);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _eboId);
+
+	int vertexSize = getVertexSize();
+	long long offset = 0;
+
+	// Position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexSize, (void*)offset);
+	glEnableVertexAttribArray(0);
+	offset += 3 * sizeof(float);
+
+	// Normal attribute (if present)
+	if (attributes.normals)
+	{
+		offset += attachAttribute(1, 3, attributes.normalFormat, vertexSize, offset);
+	}
+
+	// Color attribute (if present)
+	if (attributes.colors)
+	{
+		offset += attachAttribute(2, 4, attributes.colorFormat, vertexSize, offset);
+	}
+
+	// Texture attribute (if present)
+	if (attributes.uvs)
+	{
+		offset += attachAttribute(3, 2, attributes.uvFormat, vertexSize, offset);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+unsigned int GeometryPool::attachAttribute(unsigned int location, int numComponents, AttributeFormat format,
+	int vertexSize, long long offset)
+{
+	unsigned int size;
+	switch (format)
+	{
+		case AttributeFormat::HALF_FLOAT:
+		{
+			glVertexAttribPointer(location, numComponents, GL_HALF_FLOAT, GL_FALSE, vertexSize, (void*)offset);
+			size = ((numComponents + 1) / 2) * 4;
+			break;
+		}
+		case AttributeFormat::UNSIGNED_BYTE:
+		{
+			glVertexAttribPointer(location, numComponents, GL_UNSIGNED_BYTE, GL_TRUE, vertexSize, (void*)offset);
+			size = 4;
+			break;
+		}
+		case AttributeFormat::INT_2_10_10_10_REV:
+		{
+			// Packed formats always hold 4 components. The unused fourth is ignored by the vec3 shader input.
+			glVertexAttribPointer(location, 4, GL_INT_2_10_10_10_REV, GL_TRUE, vertexSize, (void*)offset);
+			size = 4;
+			break;
+		}
+		default:
+		{
+			glVertexAttribPointer(location, numComponents, GL_FLOAT, GL_FALSE, vertexSize, (void*)offset);
+			size = numComponents * sizeof(float);
+		}
+	}
+
+	glEnableVertexAttribArray(location);
+	return size;
+}
@@ -0,0 +1,162 @@
+#include <graphics/core/GeometryRegistry.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <common/Hash.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+std::unique_ptr<GeometryRegistry> GeometryRegistry::_INSTANCE = nullptr;
+
+namespace
+{
+	/**
+	 * The number of entries below which expired entries are not pruned
+	 */
+	const size_t MIN_PRUNE_SIZE = 64;
+
+	/**
+	 * Computes the part of the vertex attributes affecting the buffer. Only the formats of attributes that are present
+	 * affect it.
+	 * @param attributes Vertex attributes
+	 * @return The layout of the buffer
+	 */
+	std::array<int, 6> computeLayout(const GeometryAttributes& attributes)
+	{
+		return {
+			attributes.normals ? 1 : 0,
+			attributes.colors ? 1 : 0,
+			attributes.uvs ? 1 : 0,
+			attributes.normals ? static_cast<int>(attributes.normalFormat) : 0,
+			attributes.colors ? static_cast<int>(attributes.colorFormat) : 0,
+			attributes.uvs ? static_cast<int>(attributes.uvFormat) : 0
+		};
+	}
+}
+
+GeometryRegistry::GeometryRegistry() : _pruneSize(MIN_PRUNE_SIZE)
+{
+
+}
+
+GeometryRegistry::~GeometryRegistry()
+{
+	_entries.clear();
+}
+
+GeometryRegistry* GeometryRegistry::getInstance()
+{
+	if (!_INSTANCE)
+	{
+		_INSTANCE = std::unique_ptr<GeometryRegistry>(new GeometryRegistry());
+	}
+
+	return _INSTANCE.get();
+}
+
+unsigned long long GeometryRegistry::hash(const GeometryAttributes& attributes, const float* vertexData,
+	unsigned int numValues, const unsigned int* indices, unsigned int numIndices)
+{
+	std::array<int, 6> layout = computeLayout(attributes);
+
+	unsigned long long hash = FNV_OFFSET_BASIS;
+	hashBytes(hash, layout.data(), sizeof(int) * layout.size());
+	hashBytes(hash, &numValues, sizeof(numValues));
+	hashBytes(hash, vertexData, (size_t) numValues * sizeof(float));
+	hashBytes(hash, &numIndices, sizeof(numIndices));
+	hashBytes(hash, indices, (size_t) numIndices * sizeof(unsigned int));
+	return hash;
+}
+
+std::shared_ptr<Buffer> GeometryRegistry::acquire(const GeometryAttributes& attributes, const float* vertexData,
+	unsigned int numValues, const unsigned int* indices, unsigned int numIndices)
+{
+	GeometryRegistry* registry = getInstance();
+	unsigned long long key = hash(attributes, vertexData, numValues, indices, numIndices);
+	std::array<int, 6> layout = computeLayout(attributes);
+
+	auto it = registry->_entries.find(key);
+	if (it != registry->_entries.end())
+	{
+		std::shared_ptr<Buffer> buffer = it->second.buffer.lock();
+		if (buffer)
+		{
+			// Share the buffer only if its content is identical, rather than merely hashing to the same value
+			const Entry& entry = it->second;
+			if (entry.layout == layout && entry.vertexData.size() == numValues && entry.indices.size() == numIndices &&
+				std::equal(entry.vertexData.begin(), entry.vertexData.end(), vertexData,
+					[](float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; }) &&
+				std::equal(entry.indices.begin(), entry.indices.end(), indices))
+			{
+				return buffer;
+			}
+
+			// The hash collides with a live buffer holding other content, which keeps its entry
+			return std::shared_ptr<Buffer>(new Buffer(attributes, vertexData, numValues, indices, numIndices));
+		}
+	}
+
+	// Drop expired entries whenever the number of entries doubles, keeping the cost amortized
+	if (registry->_entries.size() >= registry->_pruneSize)
+	{
+		registry->prune();
+		registry->_pruneSize = std::max(MIN_PRUNE_SIZE, registry->_entries.size() * 2);
+	}
+
+	std::shared_ptr<Buffer> buffer(new Buffer(attributes, vertexData, numValues, indices, numIndices));
+
+	Entry entry;
+	entry.buffer = buffer;
+	entry.layout = layout;
+	entry.vertexData.assign(vertexData, vertexData + numValues);
+	entry.indices.assign(indices, indices + numIndices);
+	entry.numBytes = (unsigned long long) buffer->getNumVertices() * attributes.getVertexSize() +
+		(unsigned long long) numIndices * buffer->getIndexSize();
+	registry->_entries[key] = std::move(entry);
+
+	return buffer;
+}
+
+void GeometryRegistry::prune()
+{
+	for (auto it = _entries.begin(); it != _entries.end();)
+	{
+		if (it->second.buffer.expired())
+		{
+			it = _entries.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+GeometryRegistryStats GeometryRegistry::getStats()
+{
+	GeometryRegistryStats stats;
+	if (!_INSTANCE)
+	{
+		return stats;
+	}
+
+	_INSTANCE->prune();
+	for (const auto& pair : _INSTANCE->_entries)
+	{
+		unsigned int numReferences = (unsigned int) pair.second.buffer.use_count();
+		stats.numBuffers++;
+		stats.numReferences += numReferences;
+		stats.bytesUsed += pair.second.numBytes;
+		stats.bytesSaved += (numReferences - 1) * pair.second.numBytes;
+	}
+
+	return stats;
+}
+
+void GeometryRegistry::reset()
+{
+	if (_INSTANCE)
+	{
+		_INSTANCE.reset();
+	}
+}
@@ -0,0 +1,92 @@
+#include <graphics/core/InstanceBuffer.h>
+#include <graphics/objects/InstanceData.h>
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstring>
+
+InstanceBuffer::InstanceBuffer(const InstanceData* instances, unsigned int count): capacity(count)
+{
+	glGenBuffers(1, &_vboId);
+	glBindBuffer(GL_ARRAY_BUFFER, _vboId);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(InstanceData), instances, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	glDeleteBuffers(1, &_vboId);
+	if (_streamVboId != 0)
+	{
+		glDeleteBuffers(1, &_streamVboId);
+	}
+
+	_vboId = 0;
+	_streamVboId = 0;
+}
+
+void InstanceBuffer::update(const InstanceData* instances, unsigned int first, unsigned int count)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, _vboId);
+	glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(InstanceData), count * sizeof(InstanceData), instances + first);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::stream(const InstanceData* instances, const unsigned int* indices, unsigned int count)
+{
+	if (_streamVboId == 0)
+	{
+		glGenBuffers(1, &_streamVboId);
+	}
+
+	// Orphan the previous contents, then write the gathered instances directly into mapped memory
+	glBindBuffer(GL_ARRAY_BUFFER, _streamVboId);
+	glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+	if (count > 0)
+	{
+		void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData),
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		InstanceData* dst = static_cast<InstanceData*>(mapped);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			std::memcpy(&dst[i], &instances[indices[i]], sizeof(InstanceData));
+		}
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::attach(bool streamed) const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, streamed ? _streamVboId : _vboId);
+
+	// Transformation rows (locations 4 to 6)
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		unsigned int location = 4 + i;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(i * 4 * sizeof(float)));
+		glVertexAttribDivisor(location, 1);
+		glEnableVertexAttribArray(location);
+	}
+
+	// Normalized color (location 7)
+	glVertexAttribPointer(7, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(InstanceData), (void*) offsetof(InstanceData, color));
+	glVertexAttribDivisor(7, 1);
+	glEnableVertexAttribArray(7);
+
+	// Texture array layer (location 8)
+	glVertexAttribPointer(8, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*) offsetof(InstanceData, layer));
+	glVertexAttribDivisor(8, 1);
+	glEnableVertexAttribArray(8);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::detach() const
+{
+	for (unsigned int i = 0; i < 5; i++)
+	{
+		unsigned int location = 4 + i;
+		glDisableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 0);
+	}
+}
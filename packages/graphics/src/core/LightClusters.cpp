@@ -0,0 +1,344 @@
+#include <graphics/core/LightClusters.h>
+#include <graphics/cameras/Camera.h>
+#include <graphics/cameras/PerspectiveCamera.h>
+#include <graphics/lights/PointLight.h>
+#include <math/Matrix4.h>
+#include <math/Vector3.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/Parallel.h>
+#include <common/Utils.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const unsigned int LightClusters::GRID_X = 16;
+const unsigned int LightClusters::GRID_Y = 9;
+const unsigned int LightClusters::GRID_Z = 24;
+const unsigned int LightClusters::PARALLEL_THRESHOLD = 256;
+
+namespace
+{
+	/**
+	 * Bounds of the clusters overlapped by a light within a depth slice, inclusive
+	 */
+	struct TileRect {
+		unsigned int x0;
+		unsigned int x1;
+		unsigned int y0;
+		unsigned int y1;
+	};
+
+	/**
+	 * @param ndc Normalized device coordinate, between -1 and 1
+	 * @param count The number of tiles
+	 * @return Index of the tile holding the coordinate
+	 */
+	unsigned int getTile(float ndc, unsigned int count)
+	{
+		int tile = (int) std::floor((ndc * 0.5f + 0.5f) * count);
+		return (unsigned int) std::min(std::max(tile, 0), (int) count - 1);
+	}
+
+	/**
+	 * Computes the range of projected coordinates covered by an interval of view space coordinates, over an interval
+	 * of depths. The extremes of x / z always lie at corners of the box.
+	 * @param lo Lower view space coordinate
+	 * @param hi Upper view space coordinate
+	 * @param near Smallest depth, greater than 0
+	 * @param far Largest depth
+	 * @param tan Tangent of half the field of view along the axis
+	 * @param min Receives the smallest normalized device coordinate
+	 * @param max Receives the largest normalized device coordinate
+	 */
+	void project(float lo, float hi, float near, float far, float tan, float& min, float& max)
+	{
+		min = (lo >= 0.f ? lo / far : lo / near) / tan;
+		max = (hi >= 0.f ? hi / near : hi / far) / tan;
+	}
+}
+
+LightClusters::LightClusters() : _dimensions{ 1, 1, 1 }, _depthTransform{ 0.f, 0.f }, _bufferIds{ 0, 0, 0 },
+	_textureIds{ 0, 0, 0 }
+{
+
+}
+
+LightClusters::~LightClusters()
+{
+	if (_bufferIds[0] != 0)
+	{
+		glDeleteTextures(3, _textureIds);
+		glDeleteBuffers(3, _bufferIds);
+	}
+}
+
+void LightClusters::build(const std::vector<PointLightPtr>& lights, const CameraPtr camera)
+{
+	auto start = std::chrono::steady_clock::now();
+	unsigned int numLights = (unsigned int) lights.size();
+	_stats = LightClustersStats();
+	_stats.numLights = numLights;
+
+	// Pack light data
+	_lightData.resize(numLights * 8);
+	for (unsigned int i = 0; i < numLights; i++)
+	{
+		Vector3 pos = lights[i]->getPosition();
+		float* data = &_lightData[i * 8];
+		data[0] = pos.x;
+		data[1] = pos.y;
+		data[2] = pos.z;
+		data[3] = std::max(lights[i]->range, 0.f);
+		data[4] = lights[i]->color.red();
+		data[5] = lights[i]->color.green();
+		data[6] = lights[i]->color.blue();
+		data[7] = clamp(lights[i]->intensity, 0.f, 1.f);
+	}
+
+	// Without a perspective projection, every light lands in a single cluster
+	PerspectiveCameraPtr perspective = std::dynamic_pointer_cast<PerspectiveCamera>(camera);
+	if (!perspective)
+	{
+		_dimensions[0] = _dimensions[1] = _dimensions[2] = 1;
+		_depthTransform[0] = _depthTransform[1] = 0.f;
+		_clusters = { 0, numLights };
+		_indices.resize(numLights);
+		for (unsigned int i = 0; i < numLights; i++)
+		{
+			_indices[i] = i;
+		}
+
+		_stats.numReferences = numLights;
+		_stats.maxLightsPerCluster = numLights;
+		_stats.buildTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return;
+	}
+
+	float near = perspective->getNearDistance();
+	float far = perspective->getFarDistance();
+	float tanY = std::tan(deg2Rad(perspective->getFOV() * 0.5f));
+	float tanX = tanY * perspective->getAspectRatio();
+	_dimensions[0] = GRID_X;
+	_dimensions[1] = GRID_Y;
+	_dimensions[2] = GRID_Z;
+	_depthTransform[0] = GRID_Z / std::log(far / near);
+	_depthTransform[1] = -std::log(near) * _depthTransform[0];
+
+	// Transform lights into view space, and find the depth slices they overlap
+	Matrix4 view = camera->getViewMatrix();
+	_viewLights.resize(numLights);
+	for (unsigned int i = 0; i < numLights; i++)
+	{
+		Vector3 pos = view.transformPosition(Vector3(_lightData[i * 8], _lightData[i * 8 + 1], _lightData[i * 8 + 2]));
+		ViewLight& light = _viewLights[i];
+		light.x = pos.x;
+		light.y = pos.y;
+		light.depth = -pos.z;
+		light.range = _lightData[i * 8 + 3];
+		if (light.range <= 0.f)
+		{
+			light.firstSlice = 0;
+			light.lastSlice = GRID_Z - 1;
+		}
+		else if (light.depth + light.range < near || light.depth - light.range > far)
+		{
+			light.firstSlice = 1;
+			light.lastSlice = 0;
+			_stats.numCulled++;
+		}
+		else
+		{
+			light.firstSlice = getSlice(std::max(light.depth - light.range, near));
+			light.lastSlice = getSlice(std::min(light.depth + light.range, far));
+		}
+	}
+
+	// Bin every depth slice independently
+	_sliceIndices.resize(GRID_Z);
+	_sliceClusters.resize(GRID_Z);
+	parallelFor(GRID_Z, numLights >= PARALLEL_THRESHOLD ? 0 : 1, [&](unsigned int slice)
+	{
+		binSlice(slice, tanX, tanY, near, far);
+	});
+
+	// Concatenate the slices
+	unsigned int numSliceClusters = GRID_X * GRID_Y;
+	_clusters.resize(numSliceClusters * GRID_Z * 2);
+	_indices.clear();
+	for (unsigned int z = 0; z < GRID_Z; z++)
+	{
+		unsigned int base = (unsigned int) _indices.size();
+		const std::vector<unsigned int>& sliceClusters = _sliceClusters[z];
+		for (unsigned int c = 0; c < numSliceClusters; c++)
+		{
+			unsigned int count = sliceClusters[c * 2 + 1];
+			_clusters[(z * numSliceClusters + c) * 2] = base + sliceClusters[c * 2];
+			_clusters[(z * numSliceClusters + c) * 2 + 1] = count;
+			_stats.maxLightsPerCluster = std::max(_stats.maxLightsPerCluster, count);
+		}
+		_indices.insert(_indices.end(), _sliceIndices[z].begin(), _sliceIndices[z].end());
+	}
+
+	_stats.numReferences = (unsigned int) _indices.size();
+	_stats.buildTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LightClusters::binSlice(unsigned int slice, float tanX, float tanY, float near, float far)
+{
+	float sliceNear = near * std::pow(far / near, (float) slice / GRID_Z);
+	float sliceFar = near * std::pow(far / near, (float) (slice + 1) / GRID_Z);
+
+	// Finds the clusters of this slice overlapped by the bounding box of a light
+	auto overlap = [&](const ViewLight& light, TileRect& rect)
+	{
+		if (slice < light.firstSlice || slice > light.lastSlice)
+		{
+			return false;
+		}
+		if (light.range <= 0.f)
+		{
+			rect = { 0, GRID_X - 1, 0, GRID_Y - 1 };
+			return true;
+		}
+
+		float minDepth = std::max(light.depth - light.range, sliceNear);
+		float maxDepth = std::min(light.depth + light.range, sliceFar);
+		if (minDepth > maxDepth)
+		{
+			return false;
+		}
+
+		float minX, maxX, minY, maxY;
+		project(light.x - light.range, light.x + light.range, minDepth, maxDepth, tanX, minX, maxX);
+		project(light.y - light.range, light.y + light.range, minDepth, maxDepth, tanY, minY, maxY);
+		if (maxX < -1.f || minX > 1.f || maxY < -1.f || minY > 1.f)
+		{
+			return false;
+		}
+
+		rect = { getTile(minX, GRID_X), getTile(maxX, GRID_X), getTile(minY, GRID_Y), getTile(maxY, GRID_Y) };
+		return true;
+	};
+
+	// Count the lights of every cluster, then compute offsets, then fill in the indices
+	std::vector<unsigned int>& clusters = _sliceClusters[slice];
+	std::vector<unsigned int>& indices = _sliceIndices[slice];
+	clusters.assign(GRID_X * GRID_Y * 2, 0);
+	TileRect rect;
+	for (const ViewLight& light : _viewLights)
+	{
+		if (overlap(light, rect))
+		{
+			for (unsigned int y = rect.y0; y <= rect.y1; y++)
+			{
+				for (unsigned int x = rect.x0; x <= rect.x1; x++)
+				{
+					clusters[(y * GRID_X + x) * 2 + 1]++;
+				}
+			}
+		}
+	}
+
+	unsigned int offset = 0;
+	for (unsigned int c = 0; c < GRID_X * GRID_Y; c++)
+	{
+		clusters[c * 2] = offset;
+		offset += clusters[c * 2 + 1];
+		clusters[c * 2 + 1] = 0;
+	}
+
+	indices.resize(offset);
+	for (unsigned int i = 0; i < _viewLights.size(); i++)
+	{
+		if (overlap(_viewLights[i], rect))
+		{
+			for (unsigned int y = rect.y0; y <= rect.y1; y++)
+			{
+				for (unsigned int x = rect.x0; x <= rect.x1; x++)
+				{
+					unsigned int* cluster = &clusters[(y * GRID_X + x) * 2];
+					indices[cluster[0] + cluster[1]++] = i;
+				}
+			}
+		}
+	}
+}
+
+unsigned int LightClusters::getSlice(float depth) const
+{
+	int slice = (int) std::floor(std::log(depth) * _depthTransform[0] + _depthTransform[1]);
+	return (unsigned int) std::min(std::max(slice, 0), (int) GRID_Z - 1);
+}
+
+void LightClusters::upload()
+{
+	if (_bufferIds[0] == 0)
+	{
+		glGenBuffers(3, _bufferIds);
+		glGenTextures(3, _textureIds);
+	}
+
+	// Buffer textures cannot be empty, so every buffer holds at least one element
+	const void* data[] = { _lightData.data(), _clusters.data(), _indices.data() };
+	size_t sizes[] = { _lightData.size() * sizeof(float), _clusters.size() * sizeof(unsigned int),
+		_indices.size() * sizeof(unsigned int) };
+	GLenum formats[] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, _bufferIds[i]);
+		glBufferData(GL_TEXTURE_BUFFER, std::max(sizes[i], (size_t) 4 * sizeof(float)), nullptr, GL_STREAM_DRAW);
+		if (sizes[i] > 0)
+		{
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, sizes[i], data[i]);
+		}
+
+		glBindTexture(GL_TEXTURE_BUFFER, _textureIds[i]);
+		glTexBuffer(GL_TEXTURE_BUFFER, formats[i], _bufferIds[i]);
+	}
+
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::bind(unsigned int unit) const
+{
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit + i);
+		glBindTexture(GL_TEXTURE_BUFFER, _textureIds[i]);
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+const unsigned int* LightClusters::getDimensions() const
+{
+	return _dimensions;
+}
+
+const float* LightClusters::getDepthTransform() const
+{
+	return _depthTransform;
+}
+
+std::vector<unsigned int> LightClusters::getLights(unsigned int x, unsigned int y, unsigned int z) const
+{
+	if (x >= _dimensions[0] || y >= _dimensions[1] || z >= _dimensions[2])
+	{
+		throw OutOfBoundsException("Cluster index out of range");
+	}
+
+	unsigned int cluster = (z * _dimensions[1] + y) * _dimensions[0] + x;
+	if (cluster * 2 >= _clusters.size())
+	{
+		return std::vector<unsigned int>();
+	}
+
+	const unsigned int* first = _indices.data() + _clusters[cluster * 2];
+	return std::vector<unsigned int>(first, first + _clusters[cluster * 2 + 1]);
+}
+
+const LightClustersStats& LightClusters::getStats() const
+{
+	return _stats;
+}
@@ -0,0 +1,207 @@
+#include <graphics/core/LightIndex.h>
+#include <graphics/lights/PointLight.h>
+#include <math/Sphere.h>
+#include <math/Vector3.h>
+#include <common/Utils.h>
+#include <algorithm>
+#include <cmath>
+
+const float LightIndex::DEFAULT_CELL_SIZE = 0.f;
+const unsigned int LightIndex::MAX_CELLS_PER_LIGHT = 64;
+
+namespace
+{
+	/**
+	 * @return Index of the cell holding a coordinate
+	 */
+	int getCell(float value, float cellSize)
+	{
+		return (int) std::floor(value / cellSize);
+	}
+}
+
+LightIndex::LightIndex(float cellSize) : _requestedCellSize(cellSize), _cellSize(1.f)
+{
+
+}
+
+void LightIndex::build(const std::vector<PointLightPtr>& lights)
+{
+	_lights = lights;
+	_cells.clear();
+	_global.clear();
+	_stamps.assign(lights.size(), 0);
+	_stats = LightIndexStats();
+	_stats.numLights = (unsigned int) lights.size();
+
+	// Unless given, cells are as wide as the average sphere of influence, so that most lights overlap few cells
+	_cellSize = _requestedCellSize;
+	if (_cellSize <= 0.f)
+	{
+		float totalRange = 0.f;
+		unsigned int numRanged = 0;
+		for (const PointLightPtr& light : lights)
+		{
+			if (light->range > 0.f)
+			{
+				totalRange += light->range;
+				numRanged++;
+			}
+		}
+		_cellSize = numRanged > 0 ? 2.f * totalRange / numRanged : 1.f;
+	}
+
+	for (unsigned int i = 0; i < lights.size(); i++)
+	{
+		float range = lights[i]->range;
+		if (range <= 0.f)
+		{
+			_global.push_back(i);
+			continue;
+		}
+
+		Vector3 pos = lights[i]->getPosition();
+		int x0 = getCell(pos.x - range, _cellSize), x1 = getCell(pos.x + range, _cellSize);
+		int y0 = getCell(pos.y - range, _cellSize), y1 = getCell(pos.y + range, _cellSize);
+		int z0 = getCell(pos.z - range, _cellSize), z1 = getCell(pos.z + range, _cellSize);
+		long long numCells = (long long) (x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+		if (numCells > MAX_CELLS_PER_LIGHT)
+		{
+			_global.push_back(i);
+			continue;
+		}
+
+		for (int z = z0; z <= z1; z++)
+		{
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					_cells[CellKey(x, y, z)].push_back(i);
+				}
+			}
+		}
+	}
+
+	_stats.numGlobal = (unsigned int) _global.size();
+	_stats.numCells = (unsigned int) _cells.size();
+}
+
+void LightIndex::select(const Sphere& bounds, unsigned int maxLights, std::vector<unsigned int>& result)
+{
+	result.clear();
+	_candidates.clear();
+	_stats.numQueries++;
+
+	for (unsigned int light : _global)
+	{
+		addCandidate(light, bounds);
+	}
+
+	if (!_cells.empty())
+	{
+		float radius = std::max(bounds.radius, 0.f);
+		const Vector3& center = bounds.center;
+		int x0 = getCell(center.x - radius, _cellSize), x1 = getCell(center.x + radius, _cellSize);
+		int y0 = getCell(center.y - radius, _cellSize), y1 = getCell(center.y + radius, _cellSize);
+		int z0 = getCell(center.z - radius, _cellSize), z1 = getCell(center.z + radius, _cellSize);
+		long long numCells = (long long) (x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+
+		// Large bounds visit the non-empty cells rather than every cell they overlap
+		if (numCells > (long long) _cells.size())
+		{
+			for (const auto& cell : _cells)
+			{
+				int x = std::get<0>(cell.first), y = std::get<1>(cell.first), z = std::get<2>(cell.first);
+				if (x >= x0 && x <= x1 && y >= y0 && y <= y1 && z >= z0 && z <= z1)
+				{
+					for (unsigned int light : cell.second)
+					{
+						addCandidate(light, bounds);
+					}
+				}
+			}
+		}
+		else
+		{
+			for (int z = z0; z <= z1; z++)
+			{
+				for (int y = y0; y <= y1; y++)
+				{
+					for (int x = x0; x <= x1; x++)
+					{
+						auto it = _cells.find(CellKey(x, y, z));
+						if (it == _cells.end())
+						{
+							continue;
+						}
+
+						for (unsigned int light : it->second)
+						{
+							addCandidate(light, bounds);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Keep the most influential lights, breaking ties by index so that selections are stable between frames
+	unsigned int count = std::min(maxLights, (unsigned int) _candidates.size());
+	std::partial_sort(_candidates.begin(), _candidates.begin() + count, _candidates.end(),
+		[](const std::pair<float, unsigned int>& a, const std::pair<float, unsigned int>& b)
+		{
+			return a.first > b.first || (a.first == b.first && a.second < b.second);
+		});
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		result.push_back(_candidates[i].second);
+	}
+}
+
+void LightIndex::addCandidate(unsigned int light, const Sphere& bounds)
+{
+	if (_stamps[light] == _stats.numQueries)
+	{
+		return;
+	}
+	_stamps[light] = _stats.numQueries;
+	_stats.numCandidates++;
+
+	float influence = computeInfluence(*_lights[light], bounds);
+	if (influence > 0.f)
+	{
+		_candidates.emplace_back(influence, light);
+	}
+}
+
+float LightIndex::computeInfluence(const PointLight& light, const Sphere& bounds)
+{
+	float intensity = clamp(light.intensity, 0.f, 1.f);
+	if (light.range <= 0.f)
+	{
+		return intensity;
+	}
+
+	// Matches the falloff of shaders at the point of the bounds closest to the light
+	float distance = light.getPosition().minus(bounds.center).getMagnitude() - std::max(bounds.radius, 0.f);
+	float ratio = std::max(distance, 0.f) / light.range;
+	if (ratio >= 1.f)
+	{
+		return 0.f;
+	}
+
+	float attenuation = 1.f - ratio * ratio * ratio * ratio;
+	return intensity * attenuation * attenuation;
+}
+
+float LightIndex::getCellSize() const
+{
+	return _cellSize;
+}
+
+const LightIndexStats& LightIndex::getStats() const
+{
+	return _stats;
+}
@@ -0,0 +1,433 @@
+#include <graphics/core/MeshStreamer.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/objects/LODMesh.h>
+#include <math/Frustum.h>
+#include <math/Vector3.h>
+#include <common/Assertions.h>
+#include <common/Parallel.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+const float MeshStreamer::DEFAULT_MIN_COVERAGE = 0.01f;
+const unsigned int MeshStreamer::DEFAULT_MAX_UPLOADS = 8;
+
+MeshStreamer::MeshStreamer(std::unique_ptr<ClusterFile> file, unsigned long long budget, unsigned int numThreads)
+	: _file(std::move(file)), _budget(budget)
+{
+	unsigned int maxVertices = _file->getMaxClusterVertices();
+	unsigned int indexSize = maxVertices <= Buffer::MAX_SHORT_INDEX_VERTICES ? sizeof(unsigned short) :
+		sizeof(unsigned int);
+	_slotSize = (unsigned long long) maxVertices * _file->getAttributes().getVertexSize() +
+		(unsigned long long) _file->getMaxClusterIndices() * indexSize;
+
+	unsigned int numClusters = _file->getNumClusters();
+	assertTrue(numClusters == 0 || budget >= _slotSize, "Memory budget must be able to hold at least one cluster");
+
+	unsigned long long numSlots = numClusters > 0 ? std::min<unsigned long long>(budget / _slotSize, numClusters) : 0;
+	_slots.resize((size_t) numSlots);
+	for (unsigned int i = (unsigned int) numSlots; i > 0; i--)
+	{
+		_freeSlots.push_back(i - 1);
+	}
+	_clusters.resize(numClusters);
+
+	if (numThreads == 0)
+	{
+		numThreads = getHardwareConcurrency();
+	}
+	for (unsigned int i = 0; i < numThreads; i++)
+	{
+		_workers.emplace_back(&MeshStreamer::work, this);
+	}
+}
+
+MeshStreamer::~MeshStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_queued.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+MeshStreamerPtr MeshStreamer::create(const std::string& path, unsigned long long budget, unsigned int numThreads)
+{
+	std::unique_ptr<ClusterFile> file(new ClusterFile(path));
+	return std::shared_ptr<MeshStreamer>(new MeshStreamer(std::move(file), budget, numThreads));
+}
+
+const ClusterFile& MeshStreamer::getFile() const
+{
+	return *_file;
+}
+
+unsigned long long MeshStreamer::getBudget() const
+{
+	return _budget;
+}
+
+unsigned long long MeshStreamer::getSlotSize() const
+{
+	return _slotSize;
+}
+
+unsigned int MeshStreamer::getNumSlots() const
+{
+	return (unsigned int) _slots.size();
+}
+
+unsigned int MeshStreamer::getNumResident() const
+{
+	return _numResident;
+}
+
+unsigned int MeshStreamer::getNumPending() const
+{
+	return getNumSlots() - (unsigned int) _freeSlots.size() - _numResident;
+}
+
+unsigned long long MeshStreamer::getUsedBytes() const
+{
+	return (unsigned long long) (getNumSlots() - _freeSlots.size()) * _slotSize;
+}
+
+bool MeshStreamer::isResident(unsigned int cluster) const
+{
+	if (cluster >= _clusters.size())
+	{
+		throw OutOfBoundsException("Cluster index out of range");
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _clusters[cluster].state == ClusterState::RESIDENT;
+}
+
+float MeshStreamer::getCoverage(unsigned int cluster) const
+{
+	if (cluster >= _clusters.size())
+	{
+		throw OutOfBoundsException("Cluster index out of range");
+	}
+
+	return _clusters[cluster].coverage;
+}
+
+void MeshStreamer::update(const Vector3& cameraPosition, float fov, const Matrix4& modelTransform, float bias)
+{
+	assertTrue(fov > 0.f, "Field of view must be positive");
+
+	// Upload the clusters loaded since the last update, starting with those left over by the upload limit
+	std::vector<ClusterLoad> loads = std::move(_staged);
+	_staged.clear();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::move(_completed.begin(), _completed.end(), std::back_inserter(loads));
+		_completed.clear();
+	}
+	upload(loads, maxUploads);
+
+	// Rank every cluster by the screen-space error of leaving it out
+	unsigned int numClusters = (unsigned int) _clusters.size();
+	std::vector<unsigned int> candidates;
+	for (unsigned int i = 0; i < numClusters; i++)
+	{
+		ClusterResidency& cluster = _clusters[i];
+		cluster.coverage = LODMesh::computeScreenCoverage(_file->getCluster(i).bounds, modelTransform, cameraPosition,
+			fov, bias);
+		if (cluster.coverage >= minCoverage)
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	auto moreImportant = [&](unsigned int a, unsigned int b)
+	{
+		float ca = _clusters[a].coverage;
+		float cb = _clusters[b].coverage;
+		return ca > cb || (ca == cb && a < b);
+	};
+	size_t numDesired = std::min(candidates.size(), _slots.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + numDesired, candidates.end(), moreImportant);
+	candidates.resize(numDesired);
+
+	std::vector<bool> desired(numClusters, false);
+	for (unsigned int cluster : candidates)
+	{
+		desired[cluster] = true;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// Clusters too small on screen, or not yet being read, are released at once, while other clusters keep their
+	// slots until needed
+	std::vector<unsigned int> evictable;
+	for (const Slot& slot : _slots)
+	{
+		if (slot.cluster < 0 || desired[slot.cluster])
+		{
+			continue;
+		}
+
+		const ClusterResidency& residency = _clusters[slot.cluster];
+		if (residency.coverage < minCoverage || residency.state == ClusterState::QUEUED)
+		{
+			release(slot.cluster);
+		}
+		else
+		{
+			evictable.push_back(slot.cluster);
+		}
+	}
+	std::sort(evictable.begin(), evictable.end(), [&](unsigned int a, unsigned int b)
+	{
+		return moreImportant(b, a);
+	});
+
+	// Request the most important clusters first, evicting the least important ones once every slot is taken
+	size_t nextEviction = 0;
+	for (unsigned int cluster : candidates)
+	{
+		ClusterResidency& residency = _clusters[cluster];
+		if (residency.slot >= 0)
+		{
+			continue;
+		}
+
+		if (_freeSlots.empty())
+		{
+			if (nextEviction == evictable.size())
+			{
+				break;
+			}
+			release(evictable[nextEviction++]);
+		}
+
+		residency.slot = (int) _freeSlots.back();
+		residency.state = ClusterState::QUEUED;
+		_slots[residency.slot].cluster = (int) cluster;
+		_freeSlots.pop_back();
+	}
+
+	// Background threads take the most important cluster from the back of the queue
+	_queue.clear();
+	for (unsigned int cluster : candidates)
+	{
+		if (_clusters[cluster].state == ClusterState::QUEUED)
+		{
+			_queue.push_back(cluster);
+		}
+	}
+	std::reverse(_queue.begin(), _queue.end());
+	_queued.notify_all();
+}
+
+void MeshStreamer::flush()
+{
+	std::vector<ClusterLoad> loads = std::move(_staged);
+	_staged.clear();
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_loaded.wait(lock, [&]()
+		{
+			return _queue.empty() && _numLoading == 0;
+		});
+		std::move(_completed.begin(), _completed.end(), std::back_inserter(loads));
+		_completed.clear();
+	}
+	upload(loads, std::numeric_limits<unsigned int>::max());
+}
+
+unsigned int MeshStreamer::cull(const Frustum& frustum, const Matrix4& modelTransform)
+{
+	_visibleCounts.clear();
+	_visibleOffsets.clear();
+	_visibleBaseVertices.clear();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const Slot& slot : _slots)
+	{
+		if (slot.cluster < 0 || _clusters[slot.cluster].state != ClusterState::RESIDENT)
+		{
+			continue;
+		}
+
+		const ClusterInfo& info = _file->getCluster(slot.cluster);
+		if (!frustum.intersectsBox(info.box.transform(modelTransform)))
+		{
+			continue;
+		}
+
+		_visibleCounts.push_back((int) info.numIndices);
+		_visibleOffsets.push_back(slot.buffer->getIndexPointer());
+		_visibleBaseVertices.push_back(slot.buffer->getBaseVertex());
+	}
+
+	return (unsigned int) _visibleCounts.size();
+}
+
+const std::vector<int>& MeshStreamer::getVisibleCounts() const
+{
+	return _visibleCounts;
+}
+
+const std::vector<const void*>& MeshStreamer::getVisibleOffsets() const
+{
+	return _visibleOffsets;
+}
+
+const std::vector<int>& MeshStreamer::getVisibleBaseVertices() const
+{
+	return _visibleBaseVertices;
+}
+
+void MeshStreamer::bind() const
+{
+	// Every slot shares a vertex layout and index size, so all slots are drawn from the same shared buffers
+	for (const Slot& slot : _slots)
+	{
+		if (slot.buffer)
+		{
+			slot.buffer->bind();
+			return;
+		}
+	}
+}
+
+unsigned int MeshStreamer::getIndexType() const
+{
+	return _file->getMaxClusterVertices() <= Buffer::MAX_SHORT_INDEX_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void MeshStreamer::work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_queued.wait(lock, [&]()
+		{
+			return _stopping || !_queue.empty();
+		});
+		if (_stopping)
+		{
+			return;
+		}
+
+		ClusterLoad load;
+		load.cluster = _queue.back();
+		load.ticket = _clusters[load.cluster].ticket;
+		_clusters[load.cluster].state = ClusterState::LOADING;
+		_queue.pop_back();
+		_numLoading++;
+
+		lock.unlock();
+		try
+		{
+			_file->readCluster(load.cluster, load.vertexData, load.indices);
+		}
+		catch (...)
+		{
+			load.error = std::current_exception();
+		}
+		lock.lock();
+
+		// Clusters released while they were read are discarded
+		_numLoading--;
+		ClusterResidency& residency = _clusters[load.cluster];
+		if (residency.ticket == load.ticket)
+		{
+			residency.state = ClusterState::LOADED;
+			_completed.push_back(std::move(load));
+		}
+		_loaded.notify_all();
+	}
+}
+
+unsigned int MeshStreamer::upload(std::vector<ClusterLoad>& loads, unsigned int limit)
+{
+	const GeometryAttributes& attributes = _file->getAttributes();
+	unsigned int stride = attributes.getStride();
+	unsigned int numUploaded = 0;
+	std::exception_ptr error;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (ClusterLoad& load : loads)
+	{
+		// Clusters released since they were loaded are discarded
+		ClusterResidency& residency = _clusters[load.cluster];
+		if (residency.ticket != load.ticket || residency.state != ClusterState::LOADED)
+		{
+			continue;
+		}
+
+		if (load.error)
+		{
+			release(load.cluster);
+			error = error ? error : load.error;
+			continue;
+		}
+
+		if (numUploaded == limit)
+		{
+			_staged.push_back(std::move(load));
+			continue;
+		}
+
+		// Loaded clusters only change state on this thread, so the mutex is not needed during the upload
+		lock.unlock();
+		const ClusterInfo& info = _file->getCluster(load.cluster);
+		Slot& slot = _slots[residency.slot];
+		if (!slot.buffer)
+		{
+			// Slots are sized for the largest cluster, so that any cluster can reuse them later
+			unsigned int numValues = _file->getMaxClusterVertices() * stride;
+			load.vertexData.resize(numValues, 0.f);
+			load.indices.resize(_file->getMaxClusterIndices(), 0);
+			slot.buffer.reset(new Buffer(attributes, load.vertexData.data(), numValues, load.indices.data(),
+				(unsigned int) load.indices.size()));
+		}
+		else
+		{
+			slot.buffer->updateVertices(load.vertexData.data(), 0, info.numVertices);
+			slot.buffer->updateIndices(load.indices.data(), 0, info.numIndices);
+		}
+
+		lock.lock();
+		residency.state = ClusterState::RESIDENT;
+		_numResident++;
+		numUploaded++;
+	}
+
+	lock.unlock();
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+	return numUploaded;
+}
+
+void MeshStreamer::release(unsigned int cluster)
+{
+	ClusterResidency& residency = _clusters[cluster];
+	if (residency.state == ClusterState::RESIDENT)
+	{
+		_numResident--;
+	}
+	if (residency.slot >= 0)
+	{
+		_slots[residency.slot].cluster = -1;
+		_freeSlots.push_back((unsigned int) residency.slot);
+	}
+
+	residency.slot = -1;
+	residency.state = ClusterState::UNLOADED;
+	residency.ticket++;
+}
@@ -4,18 +4,40 @@
 #include <graphics/core/input/InputController.h>
 #include <graphics/core/shaders/ShaderManager.h>
 #include <graphics/core/shaders/Shader.h>
+#include <graphics/core/shaders/ShaderFeatures.h>
 #include <graphics/core/Buffer.h>
+#include <graphics/core/GeometryArena.h>
+#include <graphics/core/GLCapabilities.h>
+#include <graphics/core/GeometryRegistry.h>
+#include <graphics/core/LightClusters.h>
+#include <graphics/core/LightIndex.h>
+#include <graphics/core/InstanceBuffer.h>
+#include <graphics/core/MeshStreamer.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/core/StaticBatch.h>
+#include <graphics/core/StaticBatcher.h>
 #include <graphics/scene/Scene.h>
 #include <graphics/cameras/Camera.h>
+#include <graphics/cameras/PerspectiveCamera.h>
 #include <graphics/lights/Light.h>
 #include <graphics/lights/AmbientLight.h>
+#include <graphics/lights/PointLight.h>
 #include <graphics/materials/Material.h>
+#include <graphics/materials/MaterialType.h>
 #include <graphics/textures/TextureLoader.h>
+#include <graphics/textures/TextureStreamer.h>
 #include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/objects/InstancedMesh.h>
+#include <graphics/objects/LODMesh.h>
+#include <graphics/objects/StreamedMesh.h>
+#include <math/Sphere.h>
+#include <math/Vector3.h>
 #include <common/Utils.h>
 #include <common/Assertions.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <limits>
 #include <sstream>
 
 int Renderer::_RENDERER_COUNT = 0;
@@ -26,6 +48,7 @@ Renderer::Renderer(WindowPtr window): _backgroundColor(Color::BLACK)
 	incrementRendererCount();
 	setWindow(window);
 	applyGlobalSettings();
+	prewarm();
 }
 
 Renderer::~Renderer()
@@ -72,6 +95,9 @@ void Renderer::setWindow(WindowPtr window)
 		throw std::runtime_error("Failed to initialize GLAD for window");
 	}
 
+	// Capabilities queried from another context may not hold for this one
+	GLCapabilities::reset();
+
 	GLint value;
 	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &value);
 
@@ -102,9 +128,31 @@ void Renderer::setBackgroundColor(const Color& color)
 	_backgroundColor = color;
 }
 
+float Renderer::getLODBias() const
+{
+	return _lodBias;
+}
+
+void Renderer::setLODBias(float bias)
+{
+	_lodBias = bias;
+}
+
+LightingMode Renderer::getLightingMode() const
+{
+	return _lightingMode;
+}
+
+void Renderer::setLightingMode(LightingMode mode)
+{
+	_lightingMode = mode;
+	prewarm();
+}
+
 void Renderer::destroy(bool destroyWindow)
 {
 	decrementRendererCount();
+	_lightClusters.reset();
 
 	if (destroyWindow && _window)
 	{
@@ -124,8 +172,25 @@ void Renderer::render(const ScenePtr scene, const CameraPtr camera)
 	_timeOfLastFrame = time;
 	_window->getInputController()->pollForKeyHolds(deltaTime);
 
-	// Traverse scene and draw to buffer
+	// Upload the textures loaded in the background since the last frame
+	TextureLoader::update();
+
+	// Traverse scene, stream the texture levels it requested, and draw to buffer
 	RenderState state = traverseScene(scene, camera);
+	TextureStreamer::update();
+
+	// Bin the point lights into the clusters of the camera, unless every item has its own lights
+	bool perObject = state.lighting.mode == LightingMode::PER_OBJECT;
+	if (!perObject || !state.instancedItems.empty() || !state.batchItems.empty() || !state.streamedItems.empty())
+	{
+		if (!_lightClusters)
+		{
+			_lightClusters = std::unique_ptr<LightClusters>(new LightClusters());
+		}
+		_lightClusters->build(state.lighting.points, camera);
+		_lightClusters->upload();
+		state.lighting.clusters = _lightClusters.get();
+	}
 	draw(state);
 
 	// Swap buffers to display scene
@@ -137,21 +202,97 @@ RenderState Renderer::traverseScene(const ScenePtr scene, const CameraPtr camera
 {
 	RenderState state;
 	state.camera = camera;
+	state.frustum = Frustum::fromMatrix(camera->getProjectionMatrix().multiply(camera->getViewMatrix()));
+	PerspectiveCameraPtr perspective = std::dynamic_pointer_cast<PerspectiveCamera>(camera);
+	state.fov = perspective ? perspective->getFOV() : 0.f;
+	state.lodBias = _lodBias;
+	state.time = _timeOfLastFrame;
+
+	int width, height;
+	glfwGetWindowSize(_window->_glfwWindow, &width, &height);
+	state.viewportWidth = (float) width;
+	state.viewportHeight = (float) height;
+	state.lighting.mode = _lightingMode;
 	traverseScene(scene, nullptr, state);
+
+	// Select the most influential lights of every item, once all lights have been found
+	if (state.lighting.mode == LightingMode::PER_OBJECT)
+	{
+		if (!_lightIndex)
+		{
+			_lightIndex = std::unique_ptr<LightIndex>(new LightIndex());
+		}
+		_lightIndex->build(state.lighting.points);
+
+		std::vector<unsigned int> selection;
+		for (RenderItem& item : state.items)
+		{
+			Sphere bounds = item.geometry->getBoundingSphere();
+			bounds = bounds.isEmpty() ? Sphere(item.modelTransform.transformPosition(Vector3()), 0.f) :
+				bounds.transform(item.modelTransform);
+			_lightIndex->select(bounds, ShaderFeatures::MAX_LIGHTS, selection);
+			for (unsigned int light : selection)
+			{
+				item.lights.push_back(state.lighting.points[light]);
+			}
+		}
+	}
 	return state;
 }
 
-void Renderer::traverseScene(const EntityPtr entity, const EntityPtr parent, RenderState& state)
+void Renderer::traverseScene(const EntityPtr entity, const EntityPtr parent, RenderState& state, bool batched)
 {
 
 	switch (entity->entityType)
 	{
 		case EntityType::GROUP:
 		{
+			EntityGroupPtr group = cast<EntityGroup>(entity);
+			if (group && group->isStatic() && !batched)
+			{
+				// Merge the meshes of static groups, rebuilding the batch whenever a mesh within the group changes
+				StaticBatchPtr batch = group->getStaticBatch();
+				if (!batch || batch->isStale())
+				{
+					batch = StaticBatcher::build(group, batch ? batch->getChunkSize() : StaticBatcher::DEFAULT_CHUNK_SIZE);
+				}
+
+				Matrix4 parentModel = parent ? parent->getWorldMatrix() : Matrix4::IDENTITY;
+				Matrix4 modelTransform = parentModel.multiply(entity->getWorldMatrix());
+
+				Matrix3 parentNormal = parent ? parent->getNormalMatrix() : Matrix3::IDENTITY;
+				Matrix3 normalTransform = parentNormal.multiply(entity->getNormalMatrix());
+
+				batch->cull(state.frustum, modelTransform);
+				const std::vector<StaticBatchBucket>& buckets = batch->getBuckets();
+				for (unsigned int i = 0; i < buckets.size(); i++)
+				{
+					if (buckets[i].visibleCounts.empty())
+					{
+						continue;
+					}
+
+					// Batched meshes may lie anywhere within their chunks, so their texture is requested at full
+					// resolution
+					TextureStreamer::request(buckets[i].material->texture, std::numeric_limits<float>::max());
+
+					BatchRenderItem renderItem;
+					renderItem.batch = batch;
+					renderItem.bucket = i;
+					renderItem.material = buckets[i].material;
+					renderItem.modelTransform = modelTransform;
+					renderItem.normalTransform = normalTransform;
+
+					state.batchItems.push_back(renderItem);
+				}
+
+				batched = true;
+			}
+
 			// Recursively handle each child
 			for (const EntityPtr child : entity->_children)
 			{
-				traverseScene(child, entity, state);
+				traverseScene(child, entity, state, batched);
 			}
 			break;
 		}
@@ -167,7 +308,7 @@ void Renderer::traverseScene(const EntityPtr entity, const EntityPtr parent, Ren
 				}
 				case LightType::POINT:
 				{
-					state.lighting.positional = light;
+					state.lighting.points.push_back(cast<PointLight>(light));
 					break;
 				}
 				default:
@@ -180,6 +321,11 @@ void Renderer::traverseScene(const EntityPtr entity, const EntityPtr parent, Ren
 		}
 		case EntityType::MESH:
 		{
+			if (batched)
+			{
+				break;
+			}
+
 			Matrix4 parentModel = parent ? parent->getWorldMatrix() : Matrix4::IDENTITY;
 			Matrix4 modelTransform = parentModel.multiply(entity->getWorldMatrix());
 
@@ -188,12 +334,99 @@ void Renderer::traverseScene(const EntityPtr entity, const EntityPtr parent, Ren
 
 			RenderItem renderItem;
 			renderItem.mesh = cast<Mesh>(entity);
+			renderItem.geometry = renderItem.mesh->geometry;
 			renderItem.modelTransform = modelTransform;
 			renderItem.normalTransform = normalTransform;
 
+			// Request the texture levels matching the screen coverage of the mesh, at full resolution without a
+			// perspective projection
+			LODMeshPtr lodMesh = std::dynamic_pointer_cast<LODMesh>(renderItem.mesh);
+			TexturePtr texture = renderItem.mesh->material->texture;
+			float coverage = std::numeric_limits<float>::max();
+			if (state.fov > 0.f && (lodMesh || texture))
+			{
+				coverage = LODMesh::computeScreenCoverage(renderItem.mesh->geometry->getBoundingSphere(),
+					modelTransform, state.camera->getPosition(), state.fov, state.lodBias);
+			}
+			TextureStreamer::request(texture, coverage * state.viewportHeight);
+
+			// Select the level of detail from the screen coverage of the finest level
+			if (lodMesh && state.fov > 0.f)
+			{
+				unsigned int level = lodMesh->update(coverage, state.time);
+				renderItem.geometry = lodMesh->getLevel(level);
+
+				// While cross-fading, the level fading out is drawn over the complementary pixels
+				if (lodMesh->getFadingLevel() != level)
+				{
+					renderItem.fade = lodMesh->getFadeProgress(state.time);
+
+					RenderItem fadingItem = renderItem;
+					fadingItem.geometry = lodMesh->getLevel(lodMesh->getFadingLevel());
+					fadingItem.fade = 1.f - renderItem.fade;
+					fadingItem.fadeOut = true;
+					state.items.push_back(fadingItem);
+				}
+			}
+
 			state.items.push_back(renderItem);
 			break;
 		}
+		case EntityType::INSTANCED_MESH:
+		{
+			Matrix4 parentModel = parent ? parent->getWorldMatrix() : Matrix4::IDENTITY;
+			Matrix4 modelTransform = parentModel.multiply(entity->getWorldMatrix());
+
+			Matrix3 parentNormal = parent ? parent->getNormalMatrix() : Matrix3::IDENTITY;
+			Matrix3 normalTransform = parentNormal.multiply(entity->getNormalMatrix());
+
+			InstancedMeshPtr mesh = cast<InstancedMesh>(entity);
+			unsigned int numVisible = mesh->cull(state.frustum, modelTransform);
+			if (numVisible == 0)
+			{
+				break;
+			}
+
+			// Instances may lie anywhere, so their texture is requested at full resolution
+			TextureStreamer::request(mesh->material->texture, std::numeric_limits<float>::max());
+
+			InstancedRenderItem renderItem;
+			renderItem.mesh = mesh;
+			renderItem.modelTransform = modelTransform;
+			renderItem.normalTransform = normalTransform;
+			renderItem.numVisible = numVisible;
+
+			state.instancedItems.push_back(renderItem);
+			break;
+		}
+		case EntityType::STREAMED_MESH:
+		{
+			Matrix4 parentModel = parent ? parent->getWorldMatrix() : Matrix4::IDENTITY;
+			Matrix4 modelTransform = parentModel.multiply(entity->getWorldMatrix());
+
+			Matrix3 parentNormal = parent ? parent->getNormalMatrix() : Matrix3::IDENTITY;
+			Matrix3 normalTransform = parentNormal.multiply(entity->getNormalMatrix());
+
+			// Clusters are ranked by screen coverage, so residency only changes under a perspective projection
+			StreamedMeshPtr mesh = cast<StreamedMesh>(entity);
+			MeshStreamerPtr streamer = mesh->getStreamer();
+			if (state.fov > 0.f)
+			{
+				streamer->update(state.camera->getPosition(), state.fov, modelTransform, state.lodBias);
+			}
+			if (streamer->cull(state.frustum, modelTransform) == 0)
+			{
+				break;
+			}
+
+			StreamedRenderItem renderItem;
+			renderItem.mesh = mesh;
+			renderItem.modelTransform = modelTransform;
+			renderItem.normalTransform = normalTransform;
+
+			state.streamedItems.push_back(renderItem);
+			break;
+		}
 		default:
 		{
 			// Do nothing
@@ -208,15 +441,88 @@ void Renderer::draw(const RenderState& state)
 		MeshPtr mesh = item.mesh;
 
 		// Load shader data
-		ShaderPtr shader = ShaderManager::getShader(mesh->material->materialType);
+		unsigned int features = ShaderFeatures::compute(*mesh->material, item.geometry->getAttributes(), false);
+		if (state.lighting.mode == LightingMode::PER_OBJECT)
+		{
+			features |= ShaderFeatures::LIGHT_LIST;
+		}
+		ShaderPtr shader = ShaderManager::getReadyShader(mesh->material->materialType, features);
 		shader->activate();
 		shader->setState(state);
 		shader->setItem(item);
 
+		// Draw buffer
+		Buffer* buffer = item.geometry->getBuffer();
+		buffer->bind();
+		glDrawElementsBaseVertex(GL_TRIANGLES, buffer->size, buffer->getIndexType(), buffer->getIndexPointer(),
+			buffer->getBaseVertex());
+		buffer->fence();
+	}
+
+	for (const InstancedRenderItem& item : state.instancedItems)
+	{
+		InstancedMeshPtr mesh = item.mesh;
+
+		// Load shader data
+		unsigned int features = ShaderFeatures::compute(*mesh->material, mesh->geometry->getAttributes(), true);
+		ShaderPtr shader = ShaderManager::getReadyShader(mesh->material->materialType, features);
+		shader->activate();
+		shader->setState(state);
+		shader->setInstancedItem(item);
+
+		// Upload modified instances. If some instances were culled, stream the visible ones separately.
+		InstanceBuffer* instances = mesh->getBuffer();
+		bool streamed = item.numVisible < mesh->getCount();
+		if (streamed)
+		{
+			instances->stream(mesh->getInstances(), mesh->getVisibleInstances().data(), item.numVisible);
+		}
+
 		// Draw buffer
 		Buffer* buffer = mesh->geometry->getBuffer();
 		buffer->bind();
-		glDrawElements(GL_TRIANGLES, buffer->size, GL_UNSIGNED_INT, 0);
+		instances->attach(streamed);
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, buffer->size, buffer->getIndexType(), buffer->getIndexPointer(),
+			item.numVisible, buffer->getBaseVertex());
+		instances->detach();
+		buffer->fence();
+	}
+
+	for (const BatchRenderItem& item : state.batchItems)
+	{
+		const StaticBatchBucket& bucket = item.batch->getBuckets()[item.bucket];
+
+		// Load shader data
+		unsigned int features = ShaderFeatures::compute(*item.material, bucket.attributes, false);
+		ShaderPtr shader = ShaderManager::getReadyShader(item.material->materialType, features);
+		shader->activate();
+		shader->setState(state);
+		shader->setBatchItem(item);
+
+		// Draw all visible chunks of the bucket with a single call
+		bucket.buffer->bind();
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, bucket.visibleCounts.data(), bucket.buffer->getIndexType(),
+			bucket.visibleOffsets.data(), (GLsizei) bucket.visibleCounts.size(),
+			bucket.visibleBaseVertices.data());
+	}
+
+	for (const StreamedRenderItem& item : state.streamedItems)
+	{
+		MeshStreamerPtr streamer = item.mesh->getStreamer();
+
+		// Load shader data
+		unsigned int features = ShaderFeatures::compute(*item.mesh->material, streamer->getFile().getAttributes(),
+			false);
+		ShaderPtr shader = ShaderManager::getReadyShader(item.mesh->material->materialType, features);
+		shader->activate();
+		shader->setState(state);
+		shader->setStreamedItem(item);
+
+		// Draw all visible resident clusters with a single call
+		const std::vector<int>& counts = streamer->getVisibleCounts();
+		streamer->bind();
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), streamer->getIndexType(),
+			streamer->getVisibleOffsets().data(), (GLsizei) counts.size(), streamer->getVisibleBaseVertices().data());
 	}
 }
 
@@ -232,7 +538,11 @@ void Renderer::decrementRendererCount()
 	if (--_RENDERER_COUNT == 0)
 	{
 		TextureLoader::reset();
+		TextureStreamer::reset();
 		ShaderManager::reset();
+		GeometryArena::reset();
+		GeometryRegistry::reset();
+		GLCapabilities::reset();
 	}
 }
 
@@ -244,4 +554,21 @@ void Renderer::applyGlobalSettings()
 
 	// Enable depth test
 	glEnable(GL_DEPTH_TEST);
+}
+
+void Renderer::prewarm() const
+{
+	std::vector<unsigned int> variants;
+	for (unsigned int features = 0; features < ShaderFeatures::NUM_VARIANTS; features++)
+	{
+		bool lightList = (features & ShaderFeatures::LIGHT_LIST) != 0;
+		if (!ShaderFeatures::isValid(features) || (lightList && (_lightingMode != LightingMode::PER_OBJECT ||
+			(features & ShaderFeatures::INSTANCED))))
+		{
+			continue;
+		}
+		variants.push_back(features);
+	}
+
+	ShaderManager::prewarm(MaterialType::BASIC, variants);
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include <graphics/core/StaticBatch.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/core/Entity.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/materials/Material.h>
+#include <math/Frustum.h>
+#include <math/Matrix4.h>
+
+StaticBatch::StaticBatch(float chunkSize) : _chunkSize(chunkSize)
+{
+
+}
+
+StaticBatch::~StaticBatch()
+{
+	for (StaticBatchBucket& bucket : _buckets)
+	{
+		delete bucket.buffer;
+		bucket.buffer = nullptr;
+	}
+}
+
+const StaticBatchStats& StaticBatch::getStats() const
+{
+	return _stats;
+}
+
+float StaticBatch::getChunkSize() const
+{
+	return _chunkSize;
+}
+
+const std::vector<StaticBatchBucket>& StaticBatch::getBuckets() const
+{
+	return _buckets;
+}
+
+bool StaticBatch::isStale() const
+{
+	if (_group && _group->getChildren() != _roots)
+	{
+		return true;
+	}
+
+	for (const StaticBatchMember& member : _members)
+	{
+		if (member.entity->getVersion() != member.version)
+		{
+			return true;
+		}
+
+		if (!member.mesh)
+		{
+			continue;
+		}
+
+		Geometry* geometry = member.mesh->geometry.get();
+		if (geometry != member.geometry || member.mesh->material.get() != member.material)
+		{
+			return true;
+		}
+
+		if (geometry && geometry->getVersion() != member.geometryVersion)
+		{
+			return true;
+		}
+
+		// Texture coordinate transformations are baked, and merged materials must still look the same
+		Material* material = member.material;
+		if (member.bucketMaterial && (material->uvOffset != member.uvOffset || material->uvScale != member.uvScale ||
+			(material != member.bucketMaterial && !member.bucketMaterial->canBatchWith(*material))))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+unsigned int StaticBatch::cull(const Frustum& frustum, const Matrix4& modelTransform)
+{
+	unsigned int numVisible = 0;
+	for (StaticBatchBucket& bucket : _buckets)
+	{
+		bucket.visibleCounts.clear();
+		bucket.visibleOffsets.clear();
+		bucket.visibleBaseVertices.clear();
+
+		// Chunk ranges are relative to the start of the bucket's buffer within the shared geometry buffers
+		unsigned int indexOffset = bucket.buffer->getIndexOffset();
+		int baseVertex = bucket.buffer->getBaseVertex();
+		unsigned int indexSize = bucket.buffer->getIndexSize();
+
+		for (const StaticBatchChunk& chunk : bucket.chunks)
+		{
+			if (!frustum.intersectsSphere(chunk.bounds.transform(modelTransform)))
+			{
+				continue;
+			}
+
+			bucket.visibleCounts.push_back(chunk.numIndices);
+			bucket.visibleOffsets.push_back((const void*)((unsigned long long)(indexOffset + chunk.indexOffset) * indexSize));
+			bucket.visibleBaseVertices.push_back(baseVertex + chunk.baseVertex);
+			numVisible++;
+		}
+	}
+
+	return numVisible;
+}
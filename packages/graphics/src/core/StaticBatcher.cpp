@@ -0,0 +1,321 @@
+#include <graphics/core/StaticBatcher.h>
+#include <graphics/core/StaticBatch.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/materials/Material.h>
+#include <math/Matrix3.h>
+#include <math/Matrix4.h>
+#include <math/Vector2.h>
+#include <math/Vector3.h>
+#include <common/Assertions.h>
+#include <common/Utils.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace
+{
+	/**
+	 * A mesh gathered for batching, along with its transformation relative to the batched group
+	 */
+	struct BatchSource {
+		MeshPtr mesh;
+		Matrix4 transform;
+		Matrix3 normalTransform;
+		Vector3 center;
+
+		/**
+		 * Index of the state recorded for the mesh
+		 */
+		unsigned int member;
+	};
+
+	/**
+	 * Identifies the bucket a mesh belongs to: the first material its material can be batched with, followed by the
+	 * normals, colors, and uvs attribute flags and their storage formats
+	 */
+	typedef std::tuple<Material*, bool, bool, bool, AttributeFormat, AttributeFormat, AttributeFormat> BucketKey;
+
+	/**
+	 * Identifies the cubic cell of a chunk
+	 */
+	typedef std::tuple<int, int, int> CellKey;
+
+	/**
+	 * Recursively gathers all meshes below an entity, recording the state of every entity visited
+	 */
+	void gather(const EntityPtr entity, const Matrix4& parentTransform, std::vector<StaticBatchMember>& members,
+		std::vector<BatchSource>& sources)
+	{
+		for (const EntityPtr& child : entity->getChildren())
+		{
+			Matrix4 transform = parentTransform.multiply(child->getWorldMatrix());
+
+			StaticBatchMember member;
+			member.entity = child;
+			member.version = child->getVersion();
+
+			if (child->entityType == EntityType::MESH)
+			{
+				MeshPtr mesh = cast<Mesh>(child);
+				member.mesh = mesh;
+				member.geometry = mesh->geometry.get();
+				member.geometryVersion = mesh->geometry ? mesh->geometry->getVersion() : 0;
+				member.material = mesh->material.get();
+
+				Geometry* geometry = member.geometry;
+				if (geometry && member.material && geometry->getNumVertices() > 0 && geometry->getIndices())
+				{
+					// Normals are transformed by the inverse transpose to account for non-uniform scaling
+					Matrix4 inverse;
+					Matrix4 normalTransform = Matrix4::IDENTITY;
+					if (Matrix4(transform).inverse(&inverse))
+					{
+						normalTransform = inverse.transpose();
+					}
+
+					BatchSource source;
+					source.mesh = mesh;
+					source.transform = transform;
+					source.normalTransform = Matrix3(normalTransform);
+					source.center = geometry->getBoundingSphere().transform(transform).center;
+					source.member = (unsigned int) members.size();
+					sources.push_back(source);
+				}
+			}
+
+			members.push_back(member);
+			gather(child, transform, members, sources);
+		}
+	}
+
+	/**
+	 * Computes the bounding sphere of a set of vertex positions
+	 */
+	Sphere computeBounds(const float* vertexData, unsigned int numVertices, unsigned int stride)
+	{
+		if (numVertices == 0)
+		{
+			return Sphere();
+		}
+
+		Vector3 min(vertexData[0], vertexData[1], vertexData[2]);
+		Vector3 max = min;
+		for (unsigned int i = 0; i < numVertices; i++)
+		{
+			const float* p = vertexData + i * stride;
+			min = Vector3(std::min(min.x, p[0]), std::min(min.y, p[1]), std::min(min.z, p[2]));
+			max = Vector3(std::max(max.x, p[0]), std::max(max.y, p[1]), std::max(max.z, p[2]));
+		}
+
+		Vector3 center((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+		float radiusSq = 0.f;
+		for (unsigned int i = 0; i < numVertices; i++)
+		{
+			const float* p = vertexData + i * stride;
+			Vector3 d(p[0] - center.x, p[1] - center.y, p[2] - center.z);
+			radiusSq = std::max(radiusSq, d.dot(d));
+		}
+
+		return Sphere(center, std::sqrt(radiusSq));
+	}
+}
+
+const float StaticBatcher::DEFAULT_CHUNK_SIZE = 32.f;
+
+StaticBatchPtr StaticBatcher::build(EntityGroupPtr group, float chunkSize)
+{
+	assertNotNull(group.get(), "Cannot batch a null group");
+	assertTrue(group->isStatic(), "Only static groups can be batched");
+	assertGreaterThan(chunkSize, 0.f, "Chunk size must be greater than zero");
+
+	auto start = std::chrono::steady_clock::now();
+	StaticBatchPtr batch = std::shared_ptr<StaticBatch>(new StaticBatch(chunkSize));
+	batch->_group = group.get();
+	batch->_roots = group->getChildren();
+
+	// Gather meshes, with transformations relative to the group
+	std::vector<BatchSource> sources;
+	gather(group, Matrix4::IDENTITY, batch->_members, sources);
+
+	// Sort meshes into buckets, preserving the order in which each bucket is first encountered, and then into cells.
+	// Meshes whose materials differ only in their texture coordinate transformations, such as regions of the same
+	// texture atlas, share a bucket.
+	std::map<BucketKey, unsigned int> bucketIndices;
+	std::vector<std::map<CellKey, std::vector<const BatchSource*>>> cells;
+	std::vector<Material*> materials;
+	for (const BatchSource& source : sources)
+	{
+		Material* material = source.mesh->material.get();
+		auto match = std::find_if(materials.begin(), materials.end(), [material](const Material* other)
+		{
+			return other == material || other->canBatchWith(*material);
+		});
+		if (match == materials.end())
+		{
+			match = materials.insert(materials.end(), material);
+		}
+
+		StaticBatchMember& member = batch->_members[source.member];
+		member.bucketMaterial = *match;
+		member.uvOffset = material->uvOffset;
+		member.uvScale = material->uvScale;
+
+		GeometryAttributes attribs = source.mesh->geometry->getAttributes();
+		BucketKey bucketKey(*match, attribs.normals, attribs.colors, attribs.uvs,
+			attribs.normals ? attribs.normalFormat : AttributeFormat::FLOAT,
+			attribs.colors ? attribs.colorFormat : AttributeFormat::FLOAT,
+			attribs.uvs ? attribs.uvFormat : AttributeFormat::FLOAT);
+
+		auto it = bucketIndices.find(bucketKey);
+		if (it == bucketIndices.end())
+		{
+			it = bucketIndices.emplace(bucketKey, (unsigned int) cells.size()).first;
+			cells.emplace_back();
+
+			StaticBatchBucket bucket;
+			bucket.material = source.mesh->material;
+			batch->_buckets.push_back(bucket);
+		}
+
+		CellKey cellKey(
+			(int) std::floor(source.center.x / chunkSize),
+			(int) std::floor(source.center.y / chunkSize),
+			(int) std::floor(source.center.z / chunkSize)
+		);
+		cells[it->second][cellKey].push_back(&source);
+	}
+
+	// Merge the meshes of each bucket into a single buffer
+	StaticBatchStats& stats = batch->_stats;
+	for (unsigned int b = 0; b < batch->_buckets.size(); b++)
+	{
+		StaticBatchBucket& bucket = batch->_buckets[b];
+		GeometryAttributes attribs = cells[b].begin()->second.front()->mesh->geometry->getAttributes();
+		unsigned int stride = attribs.getStride();
+
+		std::vector<float> vData;
+		std::vector<unsigned int> indices;
+		unsigned int numVertices = 0;
+
+		for (const auto& cell : cells[b])
+		{
+			StaticBatchChunk chunk;
+			chunk.indexOffset = (unsigned int) indices.size();
+			chunk.baseVertex = (int) numVertices;
+			unsigned int chunkVertices = 0;
+
+			for (const BatchSource* source : cell.second)
+			{
+				const Geometry* geometry = source->mesh->geometry.get();
+				const float* interleaved = geometry->getInterleavedVertices();
+				const Vector3* vertices = geometry->getVertices();
+				const Vector3* normals = geometry->getNormals();
+				const Color* colors = geometry->getColors();
+				const Vector2* uvs = geometry->getTextureCoords();
+				const Vector2& uvOffset = source->mesh->material->uvOffset;
+				const Vector2& uvScale = source->mesh->material->uvScale;
+
+				// Interleave pre-transformed vertex data
+				unsigned int n = geometry->getNumVertices();
+				for (unsigned int i = 0; i < n; i++)
+				{
+					if (interleaved)
+					{
+						// Data is already interleaved in the same layout. Only positions and normals need transforming.
+						const float* v = interleaved + i * stride;
+						Vector3 p = source->transform.transformPosition(Vector3(v[0], v[1], v[2]));
+						vData.push_back(p.x);
+						vData.push_back(p.y);
+						vData.push_back(p.z);
+						unsigned int k = 3;
+
+						if (attribs.normals)
+						{
+							Vector3 normal = source->normalTransform.multiply(Vector3(v[3], v[4], v[5])).normalize();
+							vData.push_back(normal.x);
+							vData.push_back(normal.y);
+							vData.push_back(normal.z);
+							k += 3;
+						}
+
+						vData.insert(vData.end(), v + k, v + stride);
+						if (attribs.uvs)
+						{
+							// Texture coordinates are the last attribute
+							float* uv = &vData[vData.size() - 2];
+							uv[0] = uv[0] * uvScale.x + uvOffset.x;
+							uv[1] = uv[1] * uvScale.y + uvOffset.y;
+						}
+						continue;
+					}
+
+					Vector3 p = source->transform.transformPosition(vertices[i]);
+					vData.push_back(p.x);
+					vData.push_back(p.y);
+					vData.push_back(p.z);
+
+					if (attribs.normals)
+					{
+						Vector3 normal = source->normalTransform.multiply(normals[i]).normalize();
+						vData.push_back(normal.x);
+						vData.push_back(normal.y);
+						vData.push_back(normal.z);
+					}
+
+					if (attribs.colors)
+					{
+						Color c = colors[i];
+						vData.push_back(c.red());
+						vData.push_back(c.green());
+						vData.push_back(c.blue());
+						vData.push_back(c.alpha());
+					}
+
+					if (attribs.uvs)
+					{
+						Vector2 uv = uvs[i];
+						vData.push_back(uv.x * uvScale.x + uvOffset.x);
+						vData.push_back(uv.y * uvScale.y + uvOffset.y);
+					}
+				}
+
+				// Indices are relative to the start of the chunk, and offset by its base vertex when drawn
+				const unsigned int* meshIndices = geometry->getIndices();
+				for (unsigned int i = 0; i < geometry->size(); i++)
+				{
+					indices.push_back(meshIndices[i] + chunkVertices);
+				}
+
+				chunkVertices += n;
+				stats.numMeshes++;
+			}
+
+			chunk.numIndices = (unsigned int) indices.size() - chunk.indexOffset;
+			chunk.bounds = computeBounds(vData.data() + numVertices * stride, chunkVertices, stride);
+			bucket.chunks.push_back(chunk);
+			numVertices += chunkVertices;
+		}
+
+		bucket.attributes = attribs;
+		bucket.buffer = new Buffer(attribs, vData.data(), (unsigned int) vData.size(), indices.data(),
+			(unsigned int) indices.size());
+
+		stats.numChunks += (unsigned int) bucket.chunks.size();
+		stats.numVertices += numVertices;
+		stats.numIndices += (unsigned int) indices.size();
+		stats.numBytes += (unsigned long long) numVertices * attribs.getVertexSize() +
+			indices.size() * bucket.buffer->getIndexSize();
+	}
+
+	stats.numBuckets = (unsigned int) batch->_buckets.size();
+	stats.buildTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	group->setStaticBatch(batch);
+	return batch;
+}
@@ -1,18 +1,20 @@
 #include <graphics/core/shaders/BasicShader.h>
+#include <graphics/core/shaders/ShaderFeatures.h>
 #include <graphics/materials/BasicMaterial.h>
 #include <graphics/textures/Texture.h>
+#include <graphics/textures/TextureArray.h>
 #include <common/exceptions/IllegalArgumentException.h>
 #include <common/Utils.h>
 #include <glad/glad.h>
 
-BasicShader::BasicShader() : Shader("BasicShader", BASIC_VERTEX, BASIC_FRAGMENT)
+BasicShader::BasicShader(unsigned int features) : Shader("BasicShader", BASIC_VERTEX, BASIC_FRAGMENT, features)
 {
 
 }
 
-BasicShaderPtr BasicShader::create()
+BasicShaderPtr BasicShader::create(unsigned int features)
 {
-	return std::shared_ptr<BasicShader>(new BasicShader());
+	return std::shared_ptr<BasicShader>(new BasicShader(features));
 }
 
 void BasicShader::setMaterial(const MaterialPtr material)
@@ -21,15 +23,27 @@ void BasicShader::setMaterial(const MaterialPtr material)
 
 	BasicMaterialPtr mat = cast<BasicMaterial>(material);
 
-	// Texture
-	if (mat->texture)
+	// Texture, sampled from the first texture unit
+	if (_features & ShaderFeatures::TEXTURE)
 	{
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, mat->texture->id());
-		glUniform1i(getUniformLocation("uMaterial.texture"), GL_TEXTURE0);
-		glUniform1i(getUniformLocation("uMaterial.hasTexture"), 1);
+		glUniform1i(getUniformLocation("uMaterial.texture"), 0);
+		if (mat->texture)
+		{
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, mat->texture->id());
+		}
 	}
 
-	// Vertex color usage
-	glUniform1i(getUniformLocation("uMaterial.hasVertexColor"), mat->useVertexColors ? 1 : 0);
+	// Texture array, sampled from the second texture unit since samplers of different types cannot share a unit
+	if (_features & ShaderFeatures::TEXTURE_ARRAY)
+	{
+		glUniform1i(getUniformLocation("uMaterial.textureArray"), 1);
+		glUniform1f(getUniformLocation("uMaterial.textureLayer"), (float) mat->textureLayer);
+		if (mat->textureArray)
+		{
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, mat->textureArray->id());
+			glActiveTexture(GL_TEXTURE0);
+		}
+	}
 }
\ No newline at end of file
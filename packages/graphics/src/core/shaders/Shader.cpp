@@ -1,21 +1,48 @@
 #include <graphics/core/shaders/Shader.h>
+#include <graphics/core/shaders/ShaderCache.h>
+#include <graphics/core/shaders/ShaderFeatures.h>
 #include <graphics/cameras/Camera.h>
 #include <graphics/lights/Light.h>
 #include <graphics/lights/AmbientLight.h>
+#include <graphics/lights/PointLight.h>
 #include <graphics/materials/Material.h>
 #include <graphics/objects/Mesh.h>
+#include <graphics/objects/InstancedMesh.h>
+#include <graphics/objects/StreamedMesh.h>
 #include <graphics/core/RenderState.h>
+#include <graphics/core/LightClusters.h>
+#include <graphics/core/GLCapabilities.h>
 #include <math/Matrix4.h>
 #include <common/exceptions/IllegalArgumentException.h>
 #include <common/exceptions/InstantiationException.h>
 #include <common/Utils.h>
 #include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 
-Shader::Shader(const char* prgmName, const char* vertexShader, const char* fragmentShader)
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+const unsigned int Shader::LIGHT_UNIT = 2;
+
+Shader::Shader(const char* prgmName, const char* vertexShader, const char* fragmentShader, unsigned int features)
+	: _features(features), _name(prgmName), _vertexId(0), _fragmentId(0), _key(0),
+	_start(std::chrono::steady_clock::now()), _parallel(false), _ready(false)
 {
-	unsigned int vId = compileSource(prgmName, GL_VERTEX_SHADER, vertexShader);
-	unsigned int fId = compileSource(prgmName, GL_FRAGMENT_SHADER, fragmentShader);
+	// Inject the defines selecting the variant
+	std::string vertexSource = ShaderFeatures::inject(vertexShader, features);
+	std::string fragmentSource = ShaderFeatures::inject(fragmentShader, features);
+
+	// Load the program from its cached binary if possible
+	_key = ShaderCache::computeKey(vertexSource.c_str(), fragmentSource.c_str());
+	_id = ShaderCache::load(_key);
+	if (_id != 0)
+	{
+		_ready = true;
+		return;
+	}
 
 	// Create program
 	_id = glCreateProgram();
@@ -26,30 +53,28 @@ Shader::Shader(const char* prgmName, const char* vertexShader, const char* fragm
 		throw InstantiationException(oss.str());
 	}
 
-	// Attach shaders and link
-	glAttachShader(_id, vId);
-	glAttachShader(_id, fId);
-	glLinkProgram(_id);
-
-	// Detach shaders
-	glDeleteShader(vId);
-	glDeleteShader(fId);
-
-	// Check for errors
-	int success;
-	char infoLog[512];
-	glGetProgramiv(_id, GL_LINK_STATUS, &success);
-	if (!success)
+	try
 	{
-		glGetProgramInfoLog(_id, 512, NULL, infoLog);
+		_vertexId = compileSource(GL_VERTEX_SHADER, vertexSource.c_str());
+		_fragmentId = compileSource(GL_FRAGMENT_SHADER, fragmentSource.c_str());
+	}
+	catch (const InstantiationException&)
+	{
+		glDeleteShader(_vertexId);
 		glDeleteProgram(_id);
+		throw;
+	}
 
-		_id = 0;
-
-		std::ostringstream oss;
-		oss << "Linking failed for shader program " << prgmName << ": " << infoLog;
-		throw InstantiationException(oss.str());
+	// Attach shaders and link, keeping the binary retrievable for the shader cache. Statuses are only checked once
+	// the program is needed, so that the driver can compile it in the background.
+	if (ShaderCache::isSupported())
+	{
+		glProgramParameteri(_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	}
+	glAttachShader(_id, _vertexId);
+	glAttachShader(_id, _fragmentId);
+	glLinkProgram(_id);
+	_parallel = isParallelSupported();
 }
 
 Shader::~Shader()
@@ -62,11 +87,13 @@ Shader::~Shader()
 		glUseProgram(0);
 	}
 
+	glDeleteShader(_vertexId);
+	glDeleteShader(_fragmentId);
 	glDeleteProgram(_id);
 	_id = 0;
 }
 
-unsigned int Shader::compileSource(const char* prgmName, int type, const char* source)
+unsigned int Shader::compileSource(int type, const char* source)
 {
 	unsigned int id = glCreateShader(type);
 	if (id == 0)
@@ -79,22 +106,107 @@ unsigned int Shader::compileSource(const char* prgmName, int type, const char* s
 
 	// Compile
 	glCompileShader(id);
+	return id;
+}
 
-	// Check for errors
+void Shader::checkSource(unsigned int id, int type) const
+{
 	int success;
 	char infoLog[512];
 	glGetShaderiv(id, GL_COMPILE_STATUS, &success);
 	if (!success)
 	{
 		glGetShaderInfoLog(id, 512, NULL, infoLog);
-		glDeleteShader(id);
 
 		std::ostringstream oss;
-		oss << "Shader " << type << " compilation failed for " << prgmName << ": " << infoLog;
+		oss << "Shader " << type << " compilation failed for " << _name << ": " << infoLog;
 		throw InstantiationException(oss.str());
 	}
+}
 
-	return id;
+void Shader::finish()
+{
+	try
+	{
+		checkSource(_vertexId, GL_VERTEX_SHADER);
+		checkSource(_fragmentId, GL_FRAGMENT_SHADER);
+
+		// Check for errors
+		int success;
+		char infoLog[512];
+		glGetProgramiv(_id, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			glGetProgramInfoLog(_id, 512, NULL, infoLog);
+
+			std::ostringstream oss;
+			oss << "Linking failed for shader program " << _name << ": " << infoLog;
+			throw InstantiationException(oss.str());
+		}
+	}
+	catch (const InstantiationException&)
+	{
+		glDeleteShader(_vertexId);
+		glDeleteShader(_fragmentId);
+		glDeleteProgram(_id);
+		_vertexId = 0;
+		_fragmentId = 0;
+		_id = 0;
+		throw;
+	}
+
+	// Detach shaders
+	glDeleteShader(_vertexId);
+	glDeleteShader(_fragmentId);
+	_vertexId = 0;
+	_fragmentId = 0;
+	_ready = true;
+
+	float compileTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _start).count();
+	ShaderCache::save(_key, _id, compileTime);
+}
+
+bool Shader::isReady()
+{
+	if (_ready)
+	{
+		return true;
+	}
+	if (_id == 0)
+	{
+		std::ostringstream oss;
+		oss << "Shader program " << _name << " failed to compile or link";
+		throw InstantiationException(oss.str());
+	}
+
+	if (_parallel)
+	{
+		GLint complete = GL_FALSE;
+		glGetProgramiv(_id, GL_COMPLETION_STATUS_KHR, &complete);
+		if (!complete)
+		{
+			return false;
+		}
+	}
+
+	finish();
+	return true;
+}
+
+void Shader::wait()
+{
+	if (!_ready)
+	{
+		// Without parallel compilation the first status query blocks until the driver is done
+		_parallel = false;
+		isReady();
+	}
+}
+
+bool Shader::isParallelSupported()
+{
+	return GLCapabilities::hasExtension("GL_KHR_parallel_shader_compile") ||
+		GLCapabilities::hasExtension("GL_ARB_parallel_shader_compile");
 }
 
 void Shader::activate() const
@@ -102,6 +214,11 @@ void Shader::activate() const
 	glUseProgram(_id);
 }
 
+unsigned int Shader::getFeatures() const
+{
+	return _features;
+}
+
 int Shader::getUniformLocation(const char* variableName) const
 {
 	int loc = glGetUniformLocation(_id, variableName);
@@ -119,7 +236,12 @@ void Shader::setState(const RenderState& state)
 {
 	setCamera(state.camera);
 	setAmbientLighting(state.lighting.ambient);
-	setPositionalLight(state.lighting.positional);
+
+	// Variants with a light list receive their lights per item instead
+	if (!(_features & ShaderFeatures::LIGHT_LIST))
+	{
+		setLightClusters(state.lighting.clusters, state.viewportWidth, state.viewportHeight);
+	}
 }
 
 void Shader::setItem(const RenderItem& item)
@@ -127,6 +249,42 @@ void Shader::setItem(const RenderItem& item)
 	setModelMatrix(item.modelTransform);
 	setNormalMatrix(item.normalTransform);
 	setMaterial(item.mesh->material);
+	glUniform1f(getUniformLocation("uFade"), item.fade);
+	glUniform1i(getUniformLocation("uFadeOut"), item.fadeOut ? 1 : 0);
+	if (_features & ShaderFeatures::LIGHT_LIST)
+	{
+		setLightList(item.lights);
+	}
+}
+
+void Shader::setInstancedItem(const InstancedRenderItem& item)
+{
+	setModelMatrix(item.modelTransform);
+	setNormalMatrix(item.normalTransform);
+	setMaterial(item.mesh->material);
+	glUniform1f(getUniformLocation("uFade"), 1.f);
+}
+
+void Shader::setBatchItem(const BatchRenderItem& item)
+{
+	setModelMatrix(item.modelTransform);
+	setNormalMatrix(item.normalTransform);
+	setMaterial(item.material);
+
+	// Texture coordinate transformations are baked into the vertices of static batches
+	if (_features & (ShaderFeatures::TEXTURE | ShaderFeatures::TEXTURE_ARRAY))
+	{
+		glUniform4f(getUniformLocation("uMaterial.uvTransform"), 0.f, 0.f, 1.f, 1.f);
+	}
+	glUniform1f(getUniformLocation("uFade"), 1.f);
+}
+
+void Shader::setStreamedItem(const StreamedRenderItem& item)
+{
+	setModelMatrix(item.modelTransform);
+	setNormalMatrix(item.normalTransform);
+	setMaterial(item.mesh->material);
+	glUniform1f(getUniformLocation("uFade"), 1.f);
 }
 
 void Shader::setModelMatrix(const Matrix4& matrix)
@@ -156,22 +314,61 @@ void Shader::setAmbientLighting(const AmbientLightPtr light)
 	glUniform1f(getUniformLocation("uAmbient.intensity"), intensity);
 }
 
-void Shader::setPositionalLight(const LightPtr light)
+void Shader::setLightClusters(const LightClusters* clusters, float width, float height)
 {
-	Vector3 pos;
-	Color color = Color::WHITE;
-	float intensity = 1.f;
+	// Samplers of different types cannot share a unit, so the units are assigned even without clusters
+	glUniform1i(getUniformLocation("uClusters.lightData"), LIGHT_UNIT);
+	glUniform1i(getUniformLocation("uClusters.clusters"), LIGHT_UNIT + 1);
+	glUniform1i(getUniformLocation("uClusters.indices"), LIGHT_UNIT + 2);
 
-	if (light)
+	// Without clusters, fragments skip point lights entirely
+	if (!clusters)
 	{
-		pos = light->getPosition();
-		color = light->color;
-		intensity = clamp(light->intensity, 0.f, 1.f);
+		glUniform3i(getUniformLocation("uClusters.dimensions"), 0, 0, 0);
+		return;
+	}
+
+	clusters->bind(LIGHT_UNIT);
+
+	const unsigned int* dimensions = clusters->getDimensions();
+	const float* depthTransform = clusters->getDepthTransform();
+	glUniform3i(getUniformLocation("uClusters.dimensions"), dimensions[0], dimensions[1], dimensions[2]);
+	glUniform2f(getUniformLocation("uClusters.depthTransform"), depthTransform[0], depthTransform[1]);
+	glUniform2f(getUniformLocation("uClusters.viewport"), std::max(width, 1.f), std::max(height, 1.f));
+}
+
+void Shader::setLightList(const std::vector<PointLightPtr>& lights)
+{
+	// Pack position and range, then color and intensity, of every light
+	unsigned int numLights = std::min((unsigned int) lights.size(), ShaderFeatures::MAX_LIGHTS);
+	std::vector<float> data(numLights * 8 + 1);
+	for (unsigned int i = 0; i < numLights; i++)
+	{
+		Vector3 pos = lights[i]->getPosition();
+		float* light = &data[i * 8];
+		light[0] = pos.x;
+		light[1] = pos.y;
+		light[2] = pos.z;
+		light[3] = std::max(lights[i]->range, 0.f);
+		light[4] = lights[i]->color.red();
+		light[5] = lights[i]->color.green();
+		light[6] = lights[i]->color.blue();
+		light[7] = clamp(lights[i]->intensity, 0.f, 1.f);
 	}
+	data.back() = (float) numLights;
 
-	glUniform3f(getUniformLocation("uLight.position"), pos.x, pos.y, pos.z);
-	glUniform3f(getUniformLocation("uLight.color"), color.red(), color.green(), color.blue());
-	glUniform1f(getUniformLocation("uLight.intensity"), intensity);
+	// Consecutive items are often lit by the same lights, in which case the uniforms already hold them
+	if (data == _lightList)
+	{
+		return;
+	}
+
+	_lightList.swap(data);
+	glUniform1i(getUniformLocation("uNumLights"), numLights);
+	if (numLights > 0)
+	{
+		glUniform4fv(getUniformLocation("uLights"), numLights * 2, _lightList.data());
+	}
 }
 
 void Shader::setCamera(const CameraPtr camera)
@@ -198,13 +395,24 @@ void Shader::setProjectionMatrix(const Matrix4& matrix)
 
 void Shader::setMaterial(const MaterialPtr material)
 {
-	int loc = getUniformLocation("uMaterial.color");
-	Color color = material->color;
-	glUniform4f(loc, color.red(), color.green(), color.blue(), color.alpha());
+	// Variants using vertex colors ignore the color of the material
+	int loc;
+	if (!(_features & ShaderFeatures::VERTEX_COLORS))
+	{
+		loc = getUniformLocation("uMaterial.color");
+		Color color = material->color;
+		glUniform4f(loc, color.red(), color.green(), color.blue(), color.alpha());
+	}
 
 	loc = getUniformLocation("uMaterial.reflectivity");
 	glUniform1f(loc, clamp(material->reflectivity, 0.f, 1.f));
 
 	loc = getUniformLocation("uMaterial.shine");
 	glUniform1f(loc, clamp(material->shine, 0.f, 1.f));
+
+	if (_features & (ShaderFeatures::TEXTURE | ShaderFeatures::TEXTURE_ARRAY))
+	{
+		loc = getUniformLocation("uMaterial.uvTransform");
+		glUniform4f(loc, material->uvOffset.x, material->uvOffset.y, material->uvScale.x, material->uvScale.y);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include <graphics/core/shaders/ShaderCache.h>
+#include <graphics/core/GLCapabilities.h>
+#include <common/Hash.h>
+#include <common/MappedFile.h>
+#include <common/exceptions/InstantiationException.h>
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+const std::string ShaderCache::EXTENSION = ".tfprogram";
+const unsigned int ShaderCache::VERSION = 1;
+
+std::unique_ptr<ShaderCache> ShaderCache::_INSTANCE = nullptr;
+
+namespace
+{
+	/**
+	 * The characters "TFPG" read as a little endian integer
+	 */
+	const uint32_t MAGIC = 0x47504654;
+
+	/**
+	 * Written in the byte order of the host, so that files from hosts with another byte order can be detected
+	 */
+	const uint32_t ENDIAN_TAG = 0x01020304;
+
+	/**
+	 * Header at the start of every file
+	 */
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t endianTag;
+		uint32_t headerSize;
+
+		/**
+		 * Driver specific format of the binary, as returned by glGetProgramBinary
+		 */
+		uint32_t binaryFormat;
+		uint32_t reserved0;
+
+		/**
+		 * Key of the program
+		 */
+		uint64_t key;
+
+		/**
+		 * Size of the binary following the header, in bytes
+		 */
+		uint64_t binarySize;
+
+		/**
+		 * Checksum of the binary
+		 */
+		uint64_t checksum;
+		uint8_t reserved[16];
+	};
+
+	static_assert(sizeof(FileHeader) == 64, "Shader file header must be 64 bytes");
+
+	/**
+	 * @return The checksum of a string, or 0 if it is null
+	 */
+	uint64_t hashString(const char* value)
+	{
+		return value ? checksum(value, std::strlen(value)) : 0;
+	}
+
+	/**
+	 * @return Milliseconds elapsed since the given time
+	 */
+	float getElapsed(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+ShaderCache::ShaderCache()
+{
+	std::error_code error;
+	std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+	if (!error)
+	{
+		_directory = (directory / "TitanForge" / "shaders").string();
+	}
+}
+
+ShaderCache::~ShaderCache()
+{
+
+}
+
+ShaderCache* ShaderCache::getInstance()
+{
+	if (!_INSTANCE)
+	{
+		_INSTANCE = std::unique_ptr<ShaderCache>(new ShaderCache());
+	}
+
+	return _INSTANCE.get();
+}
+
+bool ShaderCache::isSupported()
+{
+	if (!GLCapabilities::hasVersion(4, 1) && !GLCapabilities::hasExtension("GL_ARB_get_program_binary"))
+	{
+		return false;
+	}
+
+	// Drivers may expose the entry points without supporting any binary format
+	GLint numFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+	return numFormats > 0;
+}
+
+unsigned long long ShaderCache::computeKey(const char* vertexShader, const char* fragmentShader)
+{
+	uint64_t words[] = {
+		hashString(vertexShader),
+		hashString(fragmentShader),
+		hashString((const char*) glGetString(GL_VENDOR)),
+		hashString((const char*) glGetString(GL_RENDERER)),
+		hashString((const char*) glGetString(GL_VERSION)),
+		VERSION
+	};
+	return checksum(words, sizeof(words));
+}
+
+unsigned int ShaderCache::load(unsigned long long key)
+{
+	auto start = std::chrono::steady_clock::now();
+	ShaderCache* cache = getInstance();
+	if (cache->_directory.empty() || !isSupported())
+	{
+		return 0;
+	}
+
+	std::string path = cache->getPath(key);
+	std::unique_ptr<MappedFile> file;
+	try
+	{
+		file.reset(new MappedFile(path));
+	}
+	catch (const InstantiationException&)
+	{
+		return 0;
+	}
+
+	FileHeader header;
+	if (file->size() < sizeof(FileHeader))
+	{
+		return 0;
+	}
+	std::memcpy(&header, file->data(), sizeof(header));
+	const char* binary = file->data() + sizeof(FileHeader);
+	if (header.magic != MAGIC || header.version != VERSION || header.endianTag != ENDIAN_TAG ||
+		header.headerSize != sizeof(FileHeader) || header.key != key ||
+		file->size() != sizeof(FileHeader) + header.binarySize ||
+		checksum(binary, header.binarySize) != header.checksum)
+	{
+		return 0;
+	}
+
+	unsigned int program = glCreateProgram();
+	if (program == 0)
+	{
+		return 0;
+	}
+
+	// Drivers reject binaries they can no longer load, for instance after being updated
+	glProgramBinary(program, header.binaryFormat, binary, (GLsizei) header.binarySize);
+	GLint success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glDeleteProgram(program);
+		cache->_stats.numRejected++;
+		return 0;
+	}
+
+	cache->_stats.numHits++;
+	cache->_stats.loadTime += getElapsed(start);
+	return program;
+}
+
+void ShaderCache::save(unsigned long long key, unsigned int program, float compileTime)
+{
+	ShaderCache* cache = getInstance();
+	cache->_stats.numMisses++;
+	cache->_stats.compileTime += compileTime;
+	if (cache->_directory.empty() || !isSupported())
+	{
+		return;
+	}
+
+	GLint binarySize = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+	if (binarySize <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary(binarySize);
+	GLenum binaryFormat = 0;
+	GLsizei length = 0;
+	glGetProgramBinary(program, binarySize, &length, &binaryFormat, binary.data());
+	if (length <= 0)
+	{
+		return;
+	}
+
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.endianTag = ENDIAN_TAG;
+	header.headerSize = sizeof(FileHeader);
+	header.binaryFormat = binaryFormat;
+	header.key = key;
+	header.binarySize = length;
+	header.checksum = checksum(binary.data(), length);
+
+	// Write to a temporary file first, so that other processes never load a partially written binary
+	std::string path = cache->getPath(key);
+	std::string temporaryPath = path + ".tmp";
+	std::error_code error;
+	std::filesystem::create_directories(cache->_directory, error);
+	{
+		std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(binary.data(), length);
+		if (!out)
+		{
+			out.close();
+			std::filesystem::remove(temporaryPath, error);
+			return;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+	}
+}
+
+std::string ShaderCache::getDirectory()
+{
+	return getInstance()->_directory;
+}
+
+void ShaderCache::setDirectory(const std::string& directory)
+{
+	getInstance()->_directory = directory;
+}
+
+ShaderCacheStats ShaderCache::getStats()
+{
+	return _INSTANCE ? _INSTANCE->_stats : ShaderCacheStats();
+}
+
+void ShaderCache::reset()
+{
+	if (_INSTANCE)
+	{
+		_INSTANCE.reset();
+	}
+}
+
+std::string ShaderCache::getPath(unsigned long long key) const
+{
+	std::ostringstream oss;
+	oss << std::hex << std::setw(16) << std::setfill('0') << key;
+	return (std::filesystem::path(_directory) / (oss.str() + EXTENSION)).string();
+}
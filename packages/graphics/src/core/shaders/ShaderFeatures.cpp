@@ -0,0 +1,93 @@
+#include <graphics/core/shaders/ShaderFeatures.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <string>
+
+const unsigned int ShaderFeatures::TEXTURE = 1;
+const unsigned int ShaderFeatures::TEXTURE_ARRAY = 2;
+const unsigned int ShaderFeatures::VERTEX_COLORS = 4;
+const unsigned int ShaderFeatures::INSTANCED = 8;
+const unsigned int ShaderFeatures::LIGHT_LIST = 16;
+const unsigned int ShaderFeatures::NUM_VARIANTS = 32;
+const unsigned int ShaderFeatures::MAX_LIGHTS = 8;
+
+unsigned int ShaderFeatures::compute(const Material& material, const GeometryAttributes& attributes, bool instanced)
+{
+	unsigned int features = 0;
+	if (material.textureArray && attributes.uvs)
+	{
+		features |= TEXTURE_ARRAY;
+	}
+	else if (material.texture && attributes.uvs)
+	{
+		features |= TEXTURE;
+	}
+	if (material.materialType == MaterialType::BASIC && attributes.colors &&
+		static_cast<const BasicMaterial&>(material).useVertexColors)
+	{
+		features |= VERTEX_COLORS;
+	}
+	if (instanced)
+	{
+		features |= INSTANCED;
+	}
+
+	return features;
+}
+
+bool ShaderFeatures::isValid(unsigned int features)
+{
+	return features < NUM_VARIANTS && (features & (TEXTURE | TEXTURE_ARRAY)) != (TEXTURE | TEXTURE_ARRAY);
+}
+
+std::string ShaderFeatures::getDefines(unsigned int features)
+{
+	std::string defines;
+	if (features & TEXTURE)
+	{
+		defines += "#define HAS_TEXTURE\n";
+	}
+	if (features & TEXTURE_ARRAY)
+	{
+		defines += "#define HAS_TEXTURE_ARRAY\n";
+	}
+	if (features & VERTEX_COLORS)
+	{
+		defines += "#define HAS_VERTEX_COLORS\n";
+	}
+	if (features & INSTANCED)
+	{
+		defines += "#define INSTANCED\n";
+	}
+	if (features & LIGHT_LIST)
+	{
+		defines += "#define HAS_LIGHT_LIST\n#define MAX_LIGHTS " + std::to_string(MAX_LIGHTS) + "\n";
+	}
+
+	return defines;
+}
+
+std::string ShaderFeatures::inject(const char* source, unsigned int features)
+{
+	std::string variant(source);
+
+	// The #version directive must come first, so the defines follow the line holding it
+	size_t position = 0;
+	size_t version = variant.find("#version");
+	if (version != std::string::npos)
+	{
+		position = variant.find('\n', version);
+		if (position == std::string::npos)
+		{
+			variant += '\n';
+			position = variant.size();
+		}
+		else
+		{
+			position++;
+		}
+	}
+
+	variant.insert(position, getDefines(features));
+	return variant;
+}
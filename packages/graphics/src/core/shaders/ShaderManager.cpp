@@ -1,6 +1,8 @@
 #include <graphics/core/shaders/ShaderManager.h>
+#include <graphics/core/shaders/Shader.h>
 #include <graphics/materials/MaterialType.h>
 #include <graphics/core/shaders/BasicShader.h>
+#include <graphics/core/shaders/ShaderFeatures.h>
 #include <common/Assertions.h>
 #include <glad/glad.h>
 
@@ -8,7 +10,7 @@ std::unique_ptr<ShaderManager> ShaderManager::_INSTANCE = nullptr;
 
 ShaderManager::ShaderManager()
 {
-	_shaders.emplace(MaterialType::BASIC, BasicShader::create());
+
 }
 
 ShaderManager::~ShaderManager()
@@ -27,12 +29,97 @@ ShaderManager* ShaderManager::getInstance()
 	return _INSTANCE.get();
 }
 
-ShaderPtr ShaderManager::getShader(MaterialType matType)
+ShaderPtr ShaderManager::getShader(MaterialType matType, unsigned int features)
+{
+	ShaderPtr shader = submit(matType, features);
+	shader->wait();
+	return shader;
+}
+
+ShaderPtr ShaderManager::getReadyShader(MaterialType matType, unsigned int features)
+{
+	ShaderPtr shader = submit(matType, features);
+	if (shader->isReady())
+	{
+		return shader;
+	}
+
+	return getShader(matType, features & (ShaderFeatures::INSTANCED | ShaderFeatures::LIGHT_LIST));
+}
+
+ShaderPtr ShaderManager::submit(MaterialType matType, unsigned int features)
 {
+	assertTrue(ShaderFeatures::isValid(features), "Unknown or incompatible shader features");
 	ShaderManager* mgr = getInstance();
 
-	assertKeyInMap(mgr->_shaders, matType, "Could not find shader for material");
-	return mgr->_shaders[matType];
+	unsigned int key = getKey(matType, features);
+	if (key >= mgr->_shaders.size())
+	{
+		mgr->_shaders.resize((key / ShaderFeatures::NUM_VARIANTS + 1) * ShaderFeatures::NUM_VARIANTS);
+	}
+
+	ShaderPtr& shader = mgr->_shaders[key];
+	if (!shader)
+	{
+		switch (matType)
+		{
+			case MaterialType::BASIC:
+			{
+				shader = BasicShader::create(features);
+				break;
+			}
+			default:
+			{
+				// Do nothing
+			}
+		}
+	}
+
+	assertNotNull(shader.get(), "Could not find shader for material");
+	return shader;
+}
+
+void ShaderManager::prewarm(MaterialType matType, const std::vector<unsigned int>& variants)
+{
+	for (unsigned int features : variants)
+	{
+		submit(matType, features);
+	}
+}
+
+unsigned int ShaderManager::getKey(MaterialType matType, unsigned int features)
+{
+	return static_cast<unsigned int>(matType) * ShaderFeatures::NUM_VARIANTS + features;
+}
+
+unsigned int ShaderManager::getNumShaders()
+{
+	ShaderManager* mgr = getInstance();
+	unsigned int numShaders = 0;
+	for (const ShaderPtr& shader : mgr->_shaders)
+	{
+		if (shader)
+		{
+			numShaders++;
+		}
+	}
+
+	return numShaders;
+}
+
+unsigned int ShaderManager::getNumPending()
+{
+	ShaderManager* mgr = getInstance();
+	unsigned int numPending = 0;
+	for (const ShaderPtr& shader : mgr->_shaders)
+	{
+		if (shader && !shader->isReady())
+		{
+			numPending++;
+		}
+	}
+
+	return numPending;
 }
 
 void ShaderManager::reset()
@@ -41,4 +128,4 @@ void ShaderManager::reset()
 	{
 		_INSTANCE.reset();
 	}
-}
\ No newline at end of file
+}
@@ -30,6 +30,9 @@ BoxGeometry::BoxGeometry(float length, float height, float depth)
 	createFace(&vIdx, &iIdx, 0, hx, 2, hz, 1, -hy);			// right
 	createFace(&vIdx, &iIdx, 1, hy, 0, -hx, 2, hz);			// top
 	createFace(&vIdx, &iIdx, 1, -hy, 0, -hx, 2, -hz);		// bottom
+
+	// Boxes of the same dimensions are identical, so they share a single GPU buffer
+	_bufferSharing = true;
 }
 
 BoxGeometryPtr BoxGeometry::create(float length, float height, float depth)
@@ -0,0 +1,507 @@
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryKernels.h>
+#include <math/Vector3.h>
+#include <common/Assertions.h>
+#include <common/Hash.h>
+#include <common/MappedFile.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+const std::string ClusterFile::EXTENSION = ".tfclusters";
+const unsigned int ClusterFile::VERSION = 1;
+const size_t ClusterFile::ALIGNMENT = 64;
+const unsigned int ClusterFile::DEFAULT_MAX_TRIANGLES = 4096;
+
+namespace
+{
+	/**
+	 * The characters "TFCL" read as a little endian integer
+	 */
+	const uint32_t MAGIC = 0x4C434654;
+
+	/**
+	 * Written in the byte order of the host, so that files from hosts with another byte order can be detected
+	 */
+	const uint32_t ENDIAN_TAG = 0x01020304;
+
+	const uint32_t HAS_NORMALS = 1;
+	const uint32_t HAS_COLORS = 2;
+	const uint32_t HAS_UVS = 4;
+
+	/**
+	 * Header at the start of every file
+	 */
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t endianTag;
+		uint32_t headerSize;
+		uint32_t numClusters;
+		uint32_t entrySize;
+		uint32_t attributes;
+		uint8_t normalFormat;
+		uint8_t colorFormat;
+		uint8_t uvFormat;
+		uint8_t reserved0;
+		uint32_t maxVertices;
+		uint32_t maxIndices;
+
+		/**
+		 * Offset of the cluster table, which follows the data of every cluster
+		 */
+		uint64_t tableOffset;
+		uint64_t fileSize;
+
+		/**
+		 * Checksum of the cluster table
+		 */
+		uint64_t tableChecksum;
+	};
+
+	/**
+	 * Entry of the cluster table
+	 */
+	struct ClusterEntry {
+		uint64_t offset;
+
+		/**
+		 * Checksum of the vertex data and indices of the cluster, including the padding between them
+		 */
+		uint64_t checksum;
+		uint32_t numVertices;
+		uint32_t numIndices;
+		float bounds[4];
+		float boxMin[3];
+		float boxMax[3];
+	};
+
+	static_assert(sizeof(FileHeader) == 64, "Cluster file header must be 64 bytes");
+	static_assert(sizeof(ClusterEntry) == 64, "Cluster file entries must be 64 bytes");
+
+	uint64_t align(uint64_t offset)
+	{
+		return (offset + ClusterFile::ALIGNMENT - 1) & ~(uint64_t)(ClusterFile::ALIGNMENT - 1);
+	}
+
+	bool isValidFormat(uint8_t format)
+	{
+		return format <= static_cast<uint8_t>(AttributeFormat::INT_2_10_10_10_REV);
+	}
+
+	/**
+	 * Writes zeros until the stream reaches the given offset
+	 */
+	void pad(std::ofstream& out, uint64_t from, uint64_t to)
+	{
+		static const char ZEROS[64] = {};
+		for (uint64_t remaining = to - from; remaining > 0; )
+		{
+			uint64_t n = std::min<uint64_t>(remaining, sizeof(ZEROS));
+			out.write(ZEROS, n);
+			remaining -= n;
+		}
+	}
+
+	/**
+	 * A range of triangles still to be partitioned
+	 */
+	struct TriangleRange {
+		unsigned int begin;
+		unsigned int end;
+	};
+}
+
+ClusterFile::ClusterFile(const std::string& path, bool verify) : _file(new MappedFile(path, AccessPattern::RANDOM)),
+	_path(path), _verify(verify)
+{
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(_file->data());
+	size_t size = _file->size();
+
+	FileHeader header;
+	if (size < sizeof(FileHeader))
+	{
+		throw InstantiationException("Not a cluster file: " + path);
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.magic != MAGIC)
+	{
+		throw InstantiationException("Not a cluster file: " + path);
+	}
+	if (header.endianTag != ENDIAN_TAG)
+	{
+		throw InstantiationException("Cluster file was written on a host with another byte order: " + path);
+	}
+	if (header.version != VERSION)
+	{
+		throw InstantiationException("Unsupported cluster file version " + std::to_string(header.version) + ": " +
+			path);
+	}
+	if (header.headerSize != sizeof(FileHeader) || header.entrySize != sizeof(ClusterEntry) ||
+		header.fileSize != size || header.tableOffset > size ||
+		(size - header.tableOffset) / sizeof(ClusterEntry) < header.numClusters)
+	{
+		throw InstantiationException("Truncated cluster file: " + path);
+	}
+	if (!isValidFormat(header.normalFormat) || !isValidFormat(header.colorFormat) || !isValidFormat(header.uvFormat))
+	{
+		throw InstantiationException("Cluster file holds unknown attribute formats: " + path);
+	}
+
+	// Only the table is verified up front, as verifying every cluster would page in the whole file
+	const unsigned char* table = data + header.tableOffset;
+	size_t tableSize = (size_t) header.numClusters * sizeof(ClusterEntry);
+	if (checksum(table, tableSize) != header.tableChecksum)
+	{
+		throw InstantiationException("Cluster file table is corrupt: " + path);
+	}
+
+	_attributes.normals = (header.attributes & HAS_NORMALS) != 0;
+	_attributes.colors = (header.attributes & HAS_COLORS) != 0;
+	_attributes.uvs = (header.attributes & HAS_UVS) != 0;
+	_attributes.normalFormat = static_cast<AttributeFormat>(header.normalFormat);
+	_attributes.colorFormat = static_cast<AttributeFormat>(header.colorFormat);
+	_attributes.uvFormat = static_cast<AttributeFormat>(header.uvFormat);
+	_maxVertices = header.maxVertices;
+	_maxIndices = header.maxIndices;
+
+	size_t vertexSize = _attributes.getStride() * sizeof(float);
+	_clusters.resize(header.numClusters);
+	_offsets.resize(header.numClusters);
+	_checksums.resize(header.numClusters);
+	for (unsigned int i = 0; i < header.numClusters; i++)
+	{
+		ClusterEntry entry;
+		std::memcpy(&entry, table + (size_t) i * sizeof(ClusterEntry), sizeof(entry));
+
+		uint64_t indexOffset = align(entry.offset + (uint64_t) entry.numVertices * vertexSize);
+		if (entry.offset % ALIGNMENT != 0 || entry.offset > header.tableOffset ||
+			indexOffset + (uint64_t) entry.numIndices * sizeof(unsigned int) > header.tableOffset ||
+			entry.numVertices > _maxVertices || entry.numIndices > _maxIndices)
+		{
+			throw InstantiationException("Cluster file blocks lie outside of the file: " + path);
+		}
+
+		ClusterInfo& cluster = _clusters[i];
+		cluster.numVertices = entry.numVertices;
+		cluster.numIndices = entry.numIndices;
+		cluster.bounds = Sphere(Vector3(entry.bounds[0], entry.bounds[1], entry.bounds[2]), entry.bounds[3]);
+		cluster.box = Box(Vector3(entry.boxMin[0], entry.boxMin[1], entry.boxMin[2]),
+			Vector3(entry.boxMax[0], entry.boxMax[1], entry.boxMax[2]));
+		_offsets[i] = entry.offset;
+		_checksums[i] = entry.checksum;
+
+		if (i == 0)
+		{
+			_bounds = cluster.box;
+			continue;
+		}
+		_bounds.min = Vector3(std::min(_bounds.min.x, cluster.box.min.x), std::min(_bounds.min.y, cluster.box.min.y),
+			std::min(_bounds.min.z, cluster.box.min.z));
+		_bounds.max = Vector3(std::max(_bounds.max.x, cluster.box.max.x), std::max(_bounds.max.y, cluster.box.max.y),
+			std::max(_bounds.max.z, cluster.box.max.z));
+	}
+}
+
+ClusterFile::~ClusterFile()
+{
+
+}
+
+const GeometryAttributes& ClusterFile::getAttributes() const
+{
+	return _attributes;
+}
+
+unsigned int ClusterFile::getNumClusters() const
+{
+	return (unsigned int) _clusters.size();
+}
+
+const ClusterInfo& ClusterFile::getCluster(unsigned int index) const
+{
+	if (index >= _clusters.size())
+	{
+		throw OutOfBoundsException("Cluster index out of range");
+	}
+
+	return _clusters[index];
+}
+
+unsigned int ClusterFile::getMaxClusterVertices() const
+{
+	return _maxVertices;
+}
+
+unsigned int ClusterFile::getMaxClusterIndices() const
+{
+	return _maxIndices;
+}
+
+const Box& ClusterFile::getBounds() const
+{
+	return _bounds;
+}
+
+void ClusterFile::readCluster(unsigned int index, std::vector<float>& vertexData,
+	std::vector<unsigned int>& indices) const
+{
+	const ClusterInfo& cluster = getCluster(index);
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(_file->data()) + _offsets[index];
+
+	size_t numValues = (size_t) cluster.numVertices * _attributes.getStride();
+	size_t indexStart = align(numValues * sizeof(float));
+	if (_verify && checksum(data, indexStart + cluster.numIndices * sizeof(unsigned int)) !=
+		_checksums[index])
+	{
+		throw InstantiationException("Cluster " + std::to_string(index) + " is corrupt: " + _path);
+	}
+
+	// Blocks are aligned, so they can be read in place
+	const float* vertices = reinterpret_cast<const float*>(data);
+	const unsigned int* clusterIndices = reinterpret_cast<const unsigned int*>(data + indexStart);
+	if (_verify)
+	{
+		for (unsigned int i = 0; i < cluster.numIndices; i++)
+		{
+			if (clusterIndices[i] >= cluster.numVertices)
+			{
+				throw InstantiationException("Cluster " + std::to_string(index) + " references a missing vertex: " +
+					_path);
+			}
+		}
+	}
+
+	vertexData.assign(vertices, vertices + numValues);
+	indices.assign(clusterIndices, clusterIndices + cluster.numIndices);
+}
+
+void ClusterFile::write(const std::string& path, const GeometryAttributes& attributes, unsigned int numClusters,
+	const ClusterGenerator& generator)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		throw InstantiationException("Failed to write cluster file " + path);
+	}
+
+	// The header is rewritten once the table has been written
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	unsigned int stride = attributes.getStride();
+	std::vector<ClusterEntry> entries(numClusters);
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	std::vector<unsigned char> block;
+	uint64_t offset = align(sizeof(FileHeader));
+	pad(out, sizeof(FileHeader), offset);
+
+	for (unsigned int i = 0; i < numClusters; i++)
+	{
+		vertexData.clear();
+		indices.clear();
+		generator(i, vertexData, indices);
+
+		assertTrue(!indices.empty() && indices.size() % 3 == 0, "Clusters must hold whole triangles");
+		assertTrue(!vertexData.empty() && vertexData.size() % stride == 0, "Clusters must hold whole vertices");
+		unsigned int numVertices = (unsigned int) (vertexData.size() / stride);
+		for (unsigned int index : indices)
+		{
+			if (index >= numVertices)
+			{
+				throw OutOfBoundsException("Cluster index references a vertex outside of the cluster");
+			}
+		}
+
+		// Vertex data and indices are written as a single block, covered by a single checksum
+		size_t vertexBytes = vertexData.size() * sizeof(float);
+		size_t indexStart = align(vertexBytes);
+		block.assign(indexStart + indices.size() * sizeof(unsigned int), 0);
+		std::memcpy(block.data(), vertexData.data(), vertexBytes);
+		std::memcpy(block.data() + indexStart, indices.data(), indices.size() * sizeof(unsigned int));
+
+		Box box = GeometryKernels::computeBounds(vertexData.data(), numVertices, stride);
+		Sphere bounds = GeometryKernels::computeBoundingSphere(vertexData.data(), numVertices, stride, box);
+
+		ClusterEntry& entry = entries[i];
+		entry.offset = offset;
+		entry.checksum = checksum(block.data(), block.size());
+		entry.numVertices = numVertices;
+		entry.numIndices = (uint32_t) indices.size();
+		entry.bounds[0] = bounds.center.x;
+		entry.bounds[1] = bounds.center.y;
+		entry.bounds[2] = bounds.center.z;
+		entry.bounds[3] = bounds.radius;
+		entry.boxMin[0] = box.min.x;
+		entry.boxMin[1] = box.min.y;
+		entry.boxMin[2] = box.min.z;
+		entry.boxMax[0] = box.max.x;
+		entry.boxMax[1] = box.max.y;
+		entry.boxMax[2] = box.max.z;
+
+		header.maxVertices = std::max(header.maxVertices, entry.numVertices);
+		header.maxIndices = std::max(header.maxIndices, entry.numIndices);
+
+		out.write(reinterpret_cast<const char*>(block.data()), block.size());
+		pad(out, offset + block.size(), align(offset + block.size()));
+		offset = align(offset + block.size());
+	}
+
+	size_t tableSize = entries.size() * sizeof(ClusterEntry);
+	out.write(reinterpret_cast<const char*>(entries.data()), tableSize);
+
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.endianTag = ENDIAN_TAG;
+	header.headerSize = sizeof(FileHeader);
+	header.numClusters = numClusters;
+	header.entrySize = sizeof(ClusterEntry);
+	header.attributes = (attributes.normals ? HAS_NORMALS : 0) | (attributes.colors ? HAS_COLORS : 0) |
+		(attributes.uvs ? HAS_UVS : 0);
+	header.normalFormat = static_cast<uint8_t>(attributes.normalFormat);
+	header.colorFormat = static_cast<uint8_t>(attributes.colorFormat);
+	header.uvFormat = static_cast<uint8_t>(attributes.uvFormat);
+	header.tableOffset = offset;
+	header.fileSize = offset + tableSize;
+	header.tableChecksum = checksum(entries.data(), tableSize);
+
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.close();
+	if (!out)
+	{
+		throw InstantiationException("Failed to write cluster file " + path);
+	}
+}
+
+void ClusterFile::write(const std::string& path, const GeometryPtr& geometry, unsigned int maxTriangles)
+{
+	assertNotNull(geometry.get(), "Geometry cannot be null");
+	assertTrue(geometry->_vertices != nullptr || !geometry->_interleaved.empty(),
+		"Geometry must contain vertex positions to write");
+	assertTrue(geometry->size() >= 3, "Geometry must contain triangles to write");
+	assertTrue(maxTriangles > 0, "Clusters must hold at least one triangle");
+
+	GeometryAttributes attributes = geometry->getAttributes();
+	unsigned int stride = attributes.getStride();
+	unsigned int numVertices = geometry->getNumVertices();
+	const float* vertexData = geometry->getInterleavedVertices();
+	std::vector<float> storage;
+	if (!vertexData)
+	{
+		storage.resize((size_t) numVertices * stride);
+		geometry->interleave(0, numVertices, storage.data());
+		vertexData = storage.data();
+	}
+
+	const unsigned int* indices = geometry->getIndices();
+	unsigned int numTriangles = geometry->size() / 3;
+	std::vector<float> centroids((size_t) numTriangles * 3);
+	for (unsigned int t = 0; t < numTriangles; t++)
+	{
+		for (unsigned int corner = 0; corner < 3; corner++)
+		{
+			unsigned int index = indices[t * 3 + corner];
+			if (index >= numVertices)
+			{
+				throw OutOfBoundsException("Geometry index references a missing vertex");
+			}
+			for (unsigned int axis = 0; axis < 3; axis++)
+			{
+				centroids[t * 3 + axis] += vertexData[(size_t) index * stride + axis] / 3.f;
+			}
+		}
+	}
+
+	// Split triangle ranges at the median centroid along their longest axis, depth first, so that consecutive
+	// clusters lie close together
+	std::vector<unsigned int> triangles(numTriangles);
+	for (unsigned int t = 0; t < numTriangles; t++)
+	{
+		triangles[t] = t;
+	}
+
+	std::vector<TriangleRange> clusters;
+	std::vector<TriangleRange> stack = { { 0, numTriangles } };
+	while (!stack.empty())
+	{
+		TriangleRange range = stack.back();
+		stack.pop_back();
+		if (range.end - range.begin <= maxTriangles)
+		{
+			// Restore the original order of the triangles, which is typically optimized for the vertex cache
+			std::sort(triangles.begin() + range.begin, triangles.begin() + range.end);
+			clusters.push_back(range);
+			continue;
+		}
+
+		float min[3] = { centroids[triangles[range.begin] * 3], centroids[triangles[range.begin] * 3 + 1],
+			centroids[triangles[range.begin] * 3 + 2] };
+		float max[3] = { min[0], min[1], min[2] };
+		for (unsigned int i = range.begin; i < range.end; i++)
+		{
+			for (unsigned int axis = 0; axis < 3; axis++)
+			{
+				min[axis] = std::min(min[axis], centroids[triangles[i] * 3 + axis]);
+				max[axis] = std::max(max[axis], centroids[triangles[i] * 3 + axis]);
+			}
+		}
+		unsigned int axis = 0;
+		for (unsigned int a = 1; a < 3; a++)
+		{
+			if (max[a] - min[a] > max[axis] - min[axis])
+			{
+				axis = a;
+			}
+		}
+
+		unsigned int middle = range.begin + (range.end - range.begin) / 2;
+		std::nth_element(triangles.begin() + range.begin, triangles.begin() + middle, triangles.begin() + range.end,
+			[&](unsigned int a, unsigned int b)
+			{
+				float ca = centroids[a * 3 + axis];
+				float cb = centroids[b * 3 + axis];
+				return ca < cb || (ca == cb && a < b);
+			});
+
+		stack.push_back({ middle, range.end });
+		stack.push_back({ range.begin, middle });
+	}
+
+	// Each cluster holds the vertices its triangles reference, in the order they are first used
+	std::vector<unsigned int> remap(numVertices, ~0u);
+	std::vector<unsigned int> used;
+	write(path, attributes, (unsigned int) clusters.size(),
+		[&](unsigned int index, std::vector<float>& clusterVertices, std::vector<unsigned int>& clusterIndices)
+		{
+			const TriangleRange& range = clusters[index];
+			for (unsigned int i = range.begin; i < range.end; i++)
+			{
+				for (unsigned int corner = 0; corner < 3; corner++)
+				{
+					unsigned int vertex = indices[triangles[i] * 3 + corner];
+					if (remap[vertex] == ~0u)
+					{
+						remap[vertex] = (unsigned int) used.size();
+						used.push_back(vertex);
+						clusterVertices.insert(clusterVertices.end(), vertexData + (size_t) vertex * stride,
+							vertexData + (size_t) (vertex + 1) * stride);
+					}
+					clusterIndices.push_back(remap[vertex]);
+				}
+			}
+
+			for (unsigned int vertex : used)
+			{
+				remap[vertex] = ~0u;
+			}
+			used.clear();
+		});
+}
@@ -1,13 +1,45 @@
 #include <graphics/geometry/Geometry.h>
 #include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/geometry/GeometryKernels.h>
 #include <graphics/core/Color.h>
 #include <graphics/core/Buffer.h>
+#include <graphics/core/GeometryRegistry.h>
 #include <math/Vector2.h>
 #include <math/Vector3.h>
 #include <common/Assertions.h>
 #include <common/Utils.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
 #include <numeric>
 #include <cstring>
+#include <cmath>
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vertex positions must be tightly packed");
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Texture coordinates must be tightly packed");
+
+namespace
+{
+	/**
+	 * Copies an attribute array into a new array, moving each value to its remapped position
+	 */
+	template <typename T>
+	T* remapArray(const T* values, unsigned int numValues, const unsigned int* remap, unsigned int numRemapped)
+	{
+		if (values == nullptr)
+		{
+			return nullptr;
+		}
+
+		// Write in reverse, so that the first of several values moved to the same position is kept
+		T* remapped = new T[numRemapped];
+		for (unsigned int i = numValues; i-- > 0;)
+		{
+			remapped[remap[i]] = values[i];
+		}
+
+		return remapped;
+	}
+}
 
 Geometry::Geometry()
 {
@@ -16,7 +48,7 @@ Geometry::Geometry()
 
 Geometry::~Geometry()
 {
-	delete _buffer;
+	_buffer.reset();
 	delete[] _vertices;
 	delete[] _indices;
 	delete[] _normals;
@@ -28,7 +60,6 @@ Geometry::~Geometry()
 	_normals = nullptr;
 	_colors = nullptr;
 	_uvs = nullptr;
-	_buffer = nullptr;
 
 	_numVertices = 0;
 	_numIndices = 0;
@@ -45,6 +76,9 @@ GeometryPtr Geometry::create()
 void Geometry::setVertices(const float* vertices, unsigned int numVertices)
 {
 	assertNotNull(vertices, "Vertices cannot be null when applied to a geometry");
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
 
 	delete[] _vertices;
 	_vertices = new Vector3[numVertices];
@@ -55,6 +89,8 @@ void Geometry::setVertices(const float* vertices, unsigned int numVertices)
 		int idx = i * 3;
 		_vertices[i] = Vector3(vertices[idx], vertices[idx + 1], vertices[idx + 2]);
 	}
+	_boundingSphereNeedsUpdate = true;
+	_boundsNeedUpdate = true;
 
 	// If indices have not been set yet, initialize them to match the number of vertices.
 	// They can always be updated later by the caller.
@@ -64,17 +100,145 @@ void Geometry::setVertices(const float* vertices, unsigned int numVertices)
 		_numIndices = numVertices;
 		std::iota(_indices, _indices + numVertices, 0);
 	}
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
+}
+
+void Geometry::setInterleavedVertices(const GeometryAttributes& layout, std::vector<float> vertexData,
+	bool retainAttributes)
+{
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	unsigned int stride = layout.getStride();
+	assertTrue(vertexData.size() % stride == 0, "Interleaved vertex data must contain a whole number of vertices");
+
+	// Replace all existing attributes
+	delete[] _vertices;
+	delete[] _normals;
+	delete[] _colors;
+	delete[] _uvs;
+	_vertices = nullptr;
+	_normals = nullptr;
+	_colors = nullptr;
+	_uvs = nullptr;
+	_numNormals = 0;
+	_numColors = 0;
+	_numUVs = 0;
+
+	_interleaved = std::move(vertexData);
+	_layout = layout;
+
+	// Adopt the storage formats of the attributes present in the layout
+	if (layout.normals)
+	{
+		_normalFormat = layout.normalFormat;
+	}
+	if (layout.colors)
+	{
+		_colorFormat = layout.colorFormat;
+	}
+	if (layout.uvs)
+	{
+		_uvFormat = layout.uvFormat;
+	}
+
+	_numVertices = (unsigned int) _interleaved.size() / stride;
+	_boundingSphereNeedsUpdate = true;
+	_boundsNeedUpdate = true;
+
+	if (retainAttributes)
+	{
+		unpackInterleaved();
+	}
+
+	if (_indices == nullptr)
+	{
+		_indices = new unsigned int[_numVertices];
+		_numIndices = _numVertices;
+		std::iota(_indices, _indices + _numVertices, 0);
+	}
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 void Geometry::setIndices(const unsigned int* indices, unsigned int numIndices)
 {	
 	assertNotNull(indices, "Indices cannot be null when applied to a geometry");
 
+	// Buffers are allocated with a fixed number of indices, so only same-sized updates can be written in place
+	if (numIndices == _numIndices)
+	{
+		_indicesDirty = true;
+	}
+	else
+	{
+		_bufferNeedsRebuild = true;
+	}
+
 	delete[] _indices;
 	_indices = new unsigned int[numIndices];
 	_numIndices = numIndices;
 
 	std::memcpy(_indices, indices, numIndices * sizeof(unsigned int));
+
+	_version++;
+}
+
+void Geometry::remapVertices(const unsigned int* remap, unsigned int numVertices)
+{
+	assertNotNull(remap, "Vertex remapping cannot be null");
+	for (unsigned int i = 0; i < _numVertices; i++)
+	{
+		if (remap[i] >= numVertices)
+		{
+			throw OutOfBoundsException("Vertex is remapped outside of the geometry");
+		}
+	}
+
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+
+	if (!_interleaved.empty())
+	{
+		unsigned int stride = _layout.getStride();
+		std::vector<float> remapped((size_t) numVertices * stride, 0.f);
+		for (unsigned int i = _numVertices; i-- > 0;)
+		{
+			std::memcpy(&remapped[(size_t) remap[i] * stride], &_interleaved[(size_t) i * stride], stride * sizeof(float));
+		}
+		_interleaved = std::move(remapped);
+	}
+
+	Vector3* vertices = remapArray(_vertices, _numVertices, remap, numVertices);
+	Vector3* normals = remapArray(_normals, std::min(_numNormals, _numVertices), remap, numVertices);
+	Color* colors = remapArray(_colors, std::min(_numColors, _numVertices), remap, numVertices);
+	Vector2* uvs = remapArray(_uvs, std::min(_numUVs, _numVertices), remap, numVertices);
+
+	delete[] _vertices;
+	delete[] _normals;
+	delete[] _colors;
+	delete[] _uvs;
+	_vertices = vertices;
+	_normals = normals;
+	_colors = colors;
+	_uvs = uvs;
+	_numNormals = _normals ? numVertices : 0;
+	_numColors = _colors ? numVertices : 0;
+	_numUVs = _uvs ? numVertices : 0;
+	_numVertices = numVertices;
+
+	for (unsigned int i = 0; i < _numIndices; i++)
+	{
+		_indices[i] = remap[_indices[i]];
+	}
+	_indicesDirty = true;
+	_boundingSphereNeedsUpdate = true;
+	_boundsNeedUpdate = true;
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 unsigned int Geometry::size() const
@@ -82,11 +246,54 @@ unsigned int Geometry::size() const
 	return _numIndices;
 }
 
+unsigned int Geometry::getNumVertices() const
+{
+	return _numVertices;
+}
+
+const Vector3* Geometry::getVertices() const
+{
+	return _vertices;
+}
+
+const float* Geometry::getInterleavedVertices() const
+{
+	return _interleaved.empty() ? nullptr : _interleaved.data();
+}
+
+const unsigned int* Geometry::getIndices() const
+{
+	return _indices;
+}
+
+const Vector3* Geometry::getNormals() const
+{
+	return _normals;
+}
+
+const Color* Geometry::getColors() const
+{
+	return _colors;
+}
+
+const Vector2* Geometry::getTextureCoords() const
+{
+	return _uvs;
+}
+
+unsigned int Geometry::getVersion() const
+{
+	return _version;
+}
+
 void Geometry::setNormals(const float* normals, unsigned int numNormals)
 {
 	assertNotNull(normals, "Normals cannot be null when applied to a geometry");
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
 
-	delete _normals;
+	delete[] _normals;
 	_normals = new Vector3[numNormals];
 	_numNormals = numNormals;
 
@@ -95,18 +302,31 @@ void Geometry::setNormals(const float* normals, unsigned int numNormals)
 		int idx = i * 3;
 		_normals[i] = Vector3(normals[idx], normals[idx + 1], normals[idx + 2]);
 	}
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 void Geometry::removeNormals()
 {
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
+
 	delete[] _normals;
 	_normals = nullptr;
 	_numNormals = 0;
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 void Geometry::setColors(const float* colors, unsigned int numColors)
 {
 	assertNotNull(colors, "Colors cannot be null when applied to a geometry");
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
 
 	delete[] _colors;
 	_colors = new Color[numColors];
@@ -117,18 +337,31 @@ void Geometry::setColors(const float* colors, unsigned int numColors)
 		int idx = i * 4;
 		_colors[i] = Color(colors[idx], colors[idx + 1], colors[idx + 2], colors[idx + 3]);
 	}
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 void Geometry::removeColors()
 {
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
+
 	delete[] _colors;
 	_colors = nullptr;
 	_numColors = 0;
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 void Geometry::setTextureCoords(const float* uvs, unsigned int numUVs)
 {
 	assertNotNull(uvs, "Texture coordinates cannot be null when applied to a geometry");
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
 
 	delete[] _uvs;
 	_uvs = new Vector2[numUVs];
@@ -143,48 +376,614 @@ void Geometry::setTextureCoords(const float* uvs, unsigned int numUVs)
 
 		_uvs[i] = Vector2(uvs[idx], uvs[idx + 1]);
 	}
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
 }
 
 void Geometry::removeTextureCoords()
 {
+	GeometryAttributes previousAttributes = getAttributes();
+	unsigned int previousNumVertices = _numVertices;
+	releaseInterleaved();
+
 	delete[] _uvs;
 	_uvs = nullptr;
 	_numUVs = 0;
+
+	onVerticesReplaced(previousAttributes, previousNumVertices);
+	_version++;
+}
+
+void Geometry::updateVertices(unsigned int first, const float* vertices, unsigned int count)
+{
+	assertNotNull(vertices, "Vertices cannot be null when applied to a geometry");
+	assertRange(first, count);
+
+	if (_vertices)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			_vertices[first + i] = Vector3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+		}
+	}
+	writeInterleaved(first, count, 0, 3, vertices);
+
+	_boundingSphereNeedsUpdate = true;
+	_boundsNeedUpdate = true;
+	markVerticesDirty(first, count);
+	_version++;
+}
+
+void Geometry::updateNormals(unsigned int first, const float* normals, unsigned int count)
+{
+	assertNotNull(normals, "Normals cannot be null when applied to a geometry");
+	assertTrue(getAttributes().normals, "Geometry does not contain vertex normals");
+	assertRange(first, count);
+
+	if (_normals)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			_normals[first + i] = Vector3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
+		}
+	}
+	writeInterleaved(first, count, 3, 3, normals);
+
+	markVerticesDirty(first, count);
+	_version++;
+}
+
+void Geometry::updateColors(unsigned int first, const float* colors, unsigned int count)
+{
+	assertNotNull(colors, "Colors cannot be null when applied to a geometry");
+	GeometryAttributes attribs = getAttributes();
+	assertTrue(attribs.colors, "Geometry does not contain vertex colors");
+	assertRange(first, count);
+
+	if (_colors)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const float* c = colors + i * 4;
+			_colors[first + i] = Color(c[0], c[1], c[2], c[3]);
+		}
+	}
+	writeInterleaved(first, count, attribs.normals ? 6 : 3, 4, colors);
+
+	markVerticesDirty(first, count);
+	_version++;
+}
+
+void Geometry::updateTextureCoords(unsigned int first, const float* uvs, unsigned int count)
+{
+	assertNotNull(uvs, "Texture coordinates cannot be null when applied to a geometry");
+	GeometryAttributes attribs = getAttributes();
+	assertTrue(attribs.uvs, "Geometry does not contain texture coordinates");
+	assertRange(first, count);
+
+	if (_uvs)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			_uvs[first + i] = Vector2(uvs[i * 2], uvs[i * 2 + 1]);
+		}
+	}
+	writeInterleaved(first, count, 3 + (attribs.normals ? 3 : 0) + (attribs.colors ? 4 : 0), 2, uvs);
+
+	markVerticesDirty(first, count);
+	_version++;
+}
+
+void Geometry::updateInterleavedVertices(unsigned int first, const float* vertexData, unsigned int count)
+{
+	assertNotNull(vertexData, "Vertex data cannot be null when applied to a geometry");
+	assertFalse(_interleaved.empty(), "Geometry does not contain interleaved vertex data");
+	assertRange(first, count);
+
+	unsigned int stride = _layout.getStride();
+	std::memcpy(&_interleaved[first * stride], vertexData, count * stride * sizeof(float));
+
+	// Keep any retained attributes in sync
+	if (_vertices || _normals || _colors || _uvs)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const float* v = vertexData + i * stride;
+			if (_vertices)
+			{
+				_vertices[first + i] = Vector3(v[0], v[1], v[2]);
+			}
+			v += 3;
+
+			if (_layout.normals)
+			{
+				if (_normals)
+				{
+					_normals[first + i] = Vector3(v[0], v[1], v[2]);
+				}
+				v += 3;
+			}
+
+			if (_layout.colors)
+			{
+				if (_colors)
+				{
+					_colors[first + i] = Color(v[0], v[1], v[2], v[3]);
+				}
+				v += 4;
+			}
+
+			if (_layout.uvs && _uvs)
+			{
+				_uvs[first + i] = Vector2(v[0], v[1]);
+			}
+		}
+	}
+
+	_boundingSphereNeedsUpdate = true;
+	_boundsNeedUpdate = true;
+	markVerticesDirty(first, count);
+	_version++;
+}
+
+bool Geometry::isBufferSharing() const
+{
+	return _bufferSharing;
+}
+
+void Geometry::setBufferSharing(bool sharing)
+{
+	if (sharing != _bufferSharing)
+	{
+		_bufferSharing = sharing;
+		_bufferNeedsRebuild = true;
+	}
+}
+
+bool Geometry::isBufferShared() const
+{
+	return _bufferShared;
+}
+
+BufferUsage Geometry::getUsage() const
+{
+	return _usage;
+}
+
+void Geometry::setUsage(BufferUsage usage)
+{
+	if (usage != _usage)
+	{
+		_usage = usage;
+		_bufferNeedsRebuild = true;
+	}
+}
+
+AttributeFormat Geometry::getNormalFormat() const
+{
+	return _normalFormat;
+}
+
+void Geometry::setNormalFormat(AttributeFormat format)
+{
+	assertTrue(format != AttributeFormat::UNSIGNED_BYTE, "Normals cannot be stored as unsigned bytes");
+	if (format != _normalFormat)
+	{
+		_normalFormat = format;
+		_bufferNeedsRebuild = true;
+	}
+}
+
+AttributeFormat Geometry::getColorFormat() const
+{
+	return _colorFormat;
+}
+
+void Geometry::setColorFormat(AttributeFormat format)
+{
+	assertTrue(format != AttributeFormat::INT_2_10_10_10_REV, "Colors cannot be stored as packed 10-bit integers");
+	if (format != _colorFormat)
+	{
+		_colorFormat = format;
+		_bufferNeedsRebuild = true;
+	}
+}
+
+AttributeFormat Geometry::getTextureCoordFormat() const
+{
+	return _uvFormat;
+}
+
+void Geometry::setTextureCoordFormat(AttributeFormat format)
+{
+	assertTrue(format == AttributeFormat::FLOAT || format == AttributeFormat::HALF_FLOAT,
+		"Texture coordinates can only be stored as floats or half floats");
+	if (format != _uvFormat)
+	{
+		_uvFormat = format;
+		_bufferNeedsRebuild = true;
+	}
 }
 
 const GeometryAttributes Geometry::getAttributes() const
 {
-	return {
-		_normals != nullptr,
-		_colors != nullptr,
-		_uvs != nullptr
-	};
+	GeometryAttributes attributes;
+	if (!_interleaved.empty())
+	{
+		attributes = _layout;
+	}
+	else
+	{
+		attributes.normals = _normals != nullptr;
+		attributes.colors = _colors != nullptr;
+		attributes.uvs = _uvs != nullptr;
+	}
+
+	attributes.normalFormat = _normalFormat;
+	attributes.colorFormat = _colorFormat;
+	attributes.uvFormat = _uvFormat;
+	return attributes;
+}
+
+const Sphere& Geometry::getBoundingSphere()
+{
+	if (_boundingSphereNeedsUpdate)
+	{
+		unsigned int stride;
+		const float* positions = getAttributeData(reinterpret_cast<const float*>(_vertices), 3, 0, stride);
+		_boundingSphere = GeometryKernels::computeBoundingSphere(positions, _numVertices, stride, getBounds());
+		_boundingSphereNeedsUpdate = false;
+	}
+
+	return _boundingSphere;
+}
+
+const Box& Geometry::getBounds()
+{
+	if (_boundsNeedUpdate)
+	{
+		unsigned int stride;
+		const float* positions = getAttributeData(reinterpret_cast<const float*>(_vertices), 3, 0, stride);
+		_bounds = GeometryKernels::computeBounds(positions, _numVertices, stride);
+		_boundsNeedUpdate = false;
+	}
+
+	return _bounds;
+}
+
+void Geometry::computeVertexNormals(NormalWeighting weighting)
+{
+	assertTrue(_numVertices > 0, "Geometry must contain vertex positions to compute normals");
+	GeometryAttributes attributes = getAttributes();
+	if (attributes.normals && _normalsVersion == _version && _normalWeighting == weighting)
+	{
+		return;
+	}
+
+	unsigned int stride;
+	const float* positions = getAttributeData(reinterpret_cast<const float*>(_vertices), 3, 0, stride);
+	std::vector<float> normals((size_t) _numVertices * 3);
+	GeometryKernels::computeVertexNormals(positions, _numVertices, stride, _indices, _numIndices, weighting,
+		normals.data());
+
+	if (_interleaved.empty())
+	{
+		setNormals(normals.data(), _numVertices);
+	}
+	else if (attributes.normals)
+	{
+		updateNormals(0, normals.data(), _numVertices);
+	}
+	else
+	{
+		// Insert the normals after the position of every vertex, so that the data remains interleaved
+		GeometryAttributes layout = _layout;
+		layout.normals = true;
+		layout.normalFormat = _normalFormat;
+		unsigned int previousStride = _layout.getStride();
+		unsigned int newStride = layout.getStride();
+		std::vector<float> vertexData((size_t) _numVertices * newStride);
+		for (unsigned int i = 0; i < _numVertices; i++)
+		{
+			const float* src = &_interleaved[(size_t) i * previousStride];
+			float* dst = &vertexData[(size_t) i * newStride];
+			std::memcpy(dst, src, 3 * sizeof(float));
+			std::memcpy(dst + 3, &normals[(size_t) i * 3], 3 * sizeof(float));
+			std::memcpy(dst + 6, src + 3, (previousStride - 3) * sizeof(float));
+		}
+		setInterleavedVertices(layout, std::move(vertexData), _vertices != nullptr);
+	}
+
+	_normalsVersion = _version;
+	_normalWeighting = weighting;
+}
+
+const float* Geometry::getTangents()
+{
+	GeometryAttributes attributes = getAttributes();
+	assertTrue(attributes.normals && attributes.uvs,
+		"Geometry must contain vertex normals and texture coordinates to compute tangents");
+	if (!_tangents.empty() && _tangentsVersion == _version)
+	{
+		return _tangents.data();
+	}
+
+	assertTrue(!_interleaved.empty() || (_numNormals == _numVertices && _numUVs == _numVertices),
+		"Number of vertex normals and texture coordinates must match the number of vertices");
+
+	unsigned int positionStride;
+	unsigned int normalStride;
+	unsigned int uvStride;
+	const float* positions = getAttributeData(reinterpret_cast<const float*>(_vertices), 3, 0, positionStride);
+	const float* normals = getAttributeData(reinterpret_cast<const float*>(_normals), 3, 3, normalStride);
+	const float* uvs = getAttributeData(reinterpret_cast<const float*>(_uvs), 2, attributes.colors ? 10 : 6, uvStride);
+
+	_tangents.resize((size_t) _numVertices * 4);
+	GeometryKernels::computeTangents(positions, positionStride, normals, normalStride, uvs, uvStride, _numVertices,
+		_indices, _numIndices, _tangents.data());
+	_tangentsVersion = _version;
+	return _tangents.data();
 }
 
 Buffer* Geometry::getBuffer()
 {
-	if (_buffer == nullptr)
+	// Shared buffers are never modified in place, as other geometries may still reference their content
+	bool modified = _dirtyEnd > _dirtyBegin || _indicesDirty;
+	if (_buffer == nullptr || _bufferNeedsRebuild || (_bufferShared && modified))
 	{
 		createBuffer();
+		return _buffer.get();
+	}
+
+	// Upload only the data modified since the last upload
+	if (_dirtyEnd > _dirtyBegin)
+	{
+		uploadVertices();
 	}
 
-	return _buffer;
+	if (_indicesDirty)
+	{
+		_buffer->updateIndices(_indices, 0, _numIndices);
+		_indicesDirty = false;
+	}
+
+	return _buffer.get();
+}
+
+Vector3 Geometry::getPosition(unsigned int index) const
+{
+	if (_vertices)
+	{
+		return _vertices[index];
+	}
+
+	const float* p = &_interleaved[index * _layout.getStride()];
+	return Vector3(p[0], p[1], p[2]);
+}
+
+const float* Geometry::getAttributeData(const float* values, unsigned int numComponents, unsigned int offset,
+	unsigned int& stride) const
+{
+	if (values != nullptr || _interleaved.empty())
+	{
+		stride = numComponents;
+		return values;
+	}
+
+	stride = _layout.getStride();
+	return _interleaved.data() + offset;
+}
+
+void Geometry::unpackInterleaved()
+{
+	if (_interleaved.empty())
+	{
+		return;
+	}
+
+	unsigned int stride = _layout.getStride();
+	bool unpackVertices = _vertices == nullptr;
+	bool unpackNormals = _layout.normals && _normals == nullptr;
+	bool unpackColors = _layout.colors && _colors == nullptr;
+	bool unpackUVs = _layout.uvs && _uvs == nullptr;
+
+	if (unpackVertices)
+	{
+		_vertices = new Vector3[_numVertices];
+	}
+
+	if (unpackNormals)
+	{
+		_normals = new Vector3[_numVertices];
+		_numNormals = _numVertices;
+	}
+
+	if (unpackColors)
+	{
+		_colors = new Color[_numVertices];
+		_numColors = _numVertices;
+	}
+
+	if (unpackUVs)
+	{
+		_uvs = new Vector2[_numVertices];
+		_numUVs = _numVertices;
+	}
+
+	for (unsigned int i = 0; i < _numVertices; i++)
+	{
+		const float* v = &_interleaved[i * stride];
+		if (unpackVertices)
+		{
+			_vertices[i] = Vector3(v[0], v[1], v[2]);
+		}
+		v += 3;
+
+		if (_layout.normals)
+		{
+			if (unpackNormals)
+			{
+				_normals[i] = Vector3(v[0], v[1], v[2]);
+			}
+			v += 3;
+		}
+
+		if (_layout.colors)
+		{
+			if (unpackColors)
+			{
+				_colors[i] = Color(v[0], v[1], v[2], v[3]);
+			}
+			v += 4;
+		}
+
+		if (_layout.uvs && unpackUVs)
+		{
+			_uvs[i] = Vector2(v[0], v[1]);
+		}
+	}
+}
+
+void Geometry::releaseInterleaved()
+{
+	if (_interleaved.empty())
+	{
+		return;
+	}
+
+	unpackInterleaved();
+	_interleaved.clear();
+	_interleaved.shrink_to_fit();
+}
+
+void Geometry::assertRange(unsigned int first, unsigned int count) const
+{
+	if (first + count > _numVertices)
+	{
+		throw OutOfBoundsException("Vertex range lies outside of the geometry");
+	}
+}
+
+void Geometry::writeInterleaved(unsigned int first, unsigned int count, unsigned int offset, unsigned int numComponents,
+	const float* values)
+{
+	if (_interleaved.empty())
+	{
+		return;
+	}
+
+	unsigned int stride = _layout.getStride();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		std::memcpy(&_interleaved[(first + i) * stride + offset], values + i * numComponents,
+			numComponents * sizeof(float));
+	}
+}
+
+void Geometry::markVerticesDirty(unsigned int first, unsigned int count)
+{
+	if (_dirtyEnd <= _dirtyBegin)
+	{
+		_dirtyBegin = first;
+		_dirtyEnd = first + count;
+		return;
+	}
+
+	_dirtyBegin = std::min(_dirtyBegin, first);
+	_dirtyEnd = std::max(_dirtyEnd, first + count);
+}
+
+void Geometry::onVerticesReplaced(const GeometryAttributes& previousAttributes, unsigned int previousNumVertices)
+{
+	// Buffers are allocated with a fixed layout and size, so anything else requires a new buffer
+	if (getAttributes() != previousAttributes || _numVertices != previousNumVertices)
+	{
+		_bufferNeedsRebuild = true;
+		return;
+	}
+
+	markVerticesDirty(0, _numVertices);
+}
+
+void Geometry::uploadVertices()
+{
+	// Stream buffers are always rewritten in full
+	unsigned int first = _dirtyBegin;
+	unsigned int count = _dirtyEnd - _dirtyBegin;
+	if (_usage == BufferUsage::STREAM)
+	{
+		first = 0;
+		count = _numVertices;
+	}
+
+	_dirtyBegin = 0;
+	_dirtyEnd = 0;
+
+	if (!_interleaved.empty())
+	{
+		_buffer->updateVertices(&_interleaved[first * _layout.getStride()], first, count);
+		return;
+	}
+
+	std::vector<float> vData(count * getAttributes().getStride());
+	interleave(first, count, vData.data());
+	_buffer->updateVertices(vData.data(), first, count);
 }
 
 void Geometry::createBuffer()
 {
+	_bufferNeedsRebuild = false;
+	_indicesDirty = false;
+	_dirtyBegin = 0;
+	_dirtyEnd = 0;
+
+	if (!_interleaved.empty())
+	{
+		// Upload the interleaved data directly
+		assertNotNull(_indices, "Geometry must contain vertex indices to render");
+		setBuffer(getAttributes(), _interleaved.data(), (unsigned int) _interleaved.size());
+		return;
+	}
+
 	GeometryAttributes attribs = getAttributes();
-	assertNotNull(_vertices, "Geometry must contain vertex positions to render");
 	assertNotNull(_indices, "Geometry must contain vertex indices to render");
+
+	unsigned int vSize = _numVertices * attribs.getStride();
+	float* vData = new float[vSize];
+	interleave(0, _numVertices, vData);
+
+	setBuffer(attribs, vData, vSize);
+
+	delete[] vData;
+}
+
+void Geometry::setBuffer(const GeometryAttributes& attribs, const float* vData, unsigned int vSize)
+{
+	// Release the previous buffer first, so that its memory can be reused
+	_buffer.reset();
+
+	_bufferShared = _bufferSharing && _usage == BufferUsage::STATIC;
+	if (_bufferShared)
+	{
+		_buffer = GeometryRegistry::acquire(attribs, vData, vSize, _indices, _numIndices);
+	}
+	else
+	{
+		_buffer = std::shared_ptr<Buffer>(new Buffer(attribs, vData, vSize, _indices, _numIndices, _usage));
+	}
+}
+
+void Geometry::interleave(unsigned int first, unsigned int count, float* vData) const
+{
+	GeometryAttributes attribs = getAttributes();
+	assertNotNull(_vertices, "Geometry must contain vertex positions to render");
 	assertTrue(!attribs.normals || _numNormals == _numVertices, "Number of vertex normals must match the number of vertices");
 	assertTrue(!attribs.colors || _numColors == _numVertices, "Number of colors must match the number of vertices");
 	assertTrue(!attribs.uvs || _numUVs == _numVertices, "Number of texture coordinates must match the number of vertices");
 
-	// Interleave vertex data
-	unsigned int vSize = _numVertices * attribs.getStride();
-	float* vData = new float[vSize];
 	unsigned int idx = 0;
-	for (int i = 0; i < _numVertices; i++)
+	for (unsigned int i = first; i < first + count; i++)
 	{
 		Vector3 p = _vertices[i];
 		vData[idx++] = p.x;
@@ -215,9 +1014,4 @@ void Geometry::createBuffer()
 			vData[idx++] = uv.y;
 		}
 	}
-
-	delete _buffer;
-	_buffer = new Buffer(attribs, vData, vSize, _indices, _numIndices);
-
-	delete[] vData;
 }
\ No newline at end of file
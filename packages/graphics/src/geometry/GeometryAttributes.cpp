@@ -22,11 +22,75 @@ int GeometryAttributes::getStride() const
 	return stride;
 }
 
+int GeometryAttributes::getVertexSize() const
+{
+	int size = 3 * sizeof(float);
+
+	if (normals)
+	{
+		switch (normalFormat)
+		{
+			case AttributeFormat::HALF_FLOAT:
+			{
+				size += 8;
+				break;
+			}
+			case AttributeFormat::INT_2_10_10_10_REV:
+			{
+				size += 4;
+				break;
+			}
+			default:
+			{
+				size += 3 * sizeof(float);
+			}
+		}
+	}
+
+	if (colors)
+	{
+		switch (colorFormat)
+		{
+			case AttributeFormat::HALF_FLOAT:
+			{
+				size += 8;
+				break;
+			}
+			case AttributeFormat::UNSIGNED_BYTE:
+			{
+				size += 4;
+				break;
+			}
+			default:
+			{
+				size += 4 * sizeof(float);
+			}
+		}
+	}
+
+	if (uvs)
+	{
+		size += uvFormat == AttributeFormat::HALF_FLOAT ? 4 : 2 * sizeof(float);
+	}
+
+	return size;
+}
+
+bool GeometryAttributes::isFloatOnly() const
+{
+	return (!normals || normalFormat == AttributeFormat::FLOAT)
+		&& (!colors || colorFormat == AttributeFormat::FLOAT)
+		&& (!uvs || uvFormat == AttributeFormat::FLOAT);
+}
+
 bool GeometryAttributes::operator==(const GeometryAttributes& other) const
 {
 	return normals == other.normals
 		&& colors == other.colors
-		&& uvs == other.uvs;
+		&& uvs == other.uvs
+		&& (!normals || normalFormat == other.normalFormat)
+		&& (!colors || colorFormat == other.colorFormat)
+		&& (!uvs || uvFormat == other.uvFormat);
 }
 
 bool GeometryAttributes::operator!=(const GeometryAttributes& other) const
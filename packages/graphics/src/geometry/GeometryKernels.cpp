@@ -0,0 +1,769 @@
+#include <graphics/geometry/GeometryKernels.h>
+#include <math/Vector3.h>
+#include <common/Constants.h>
+#include <common/Parallel.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEOMETRY_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+
+const unsigned int GeometryKernels::PARALLEL_THRESHOLD = 1 << 16;
+
+namespace
+{
+	/**
+	 * Lengths below this value are treated as zero
+	 */
+	const float EPSILON = 1.0e-20f;
+
+#ifdef GEOMETRY_KERNELS_SSE
+
+	/**
+	 * Four floats processed together in an SSE register
+	 */
+	struct Float4 {
+		__m128 v;
+	};
+
+	inline Float4 splat(float s)
+	{
+		return { _mm_set1_ps(s) };
+	}
+
+	/**
+	 * Loads four consecutive floats
+	 */
+	inline Float4 load(const float* p)
+	{
+		return { _mm_loadu_ps(p) };
+	}
+
+	/**
+	 * Loads three consecutive floats, setting the fourth component to 0. Never reads past the third float.
+	 */
+	inline Float4 load3(const float* p)
+	{
+		return { _mm_setr_ps(p[0], p[1], p[2], 0.f) };
+	}
+
+	inline void store(const Float4& a, float* p)
+	{
+		_mm_storeu_ps(p, a.v);
+	}
+
+	inline Float4 operator+(const Float4& a, const Float4& b)
+	{
+		return { _mm_add_ps(a.v, b.v) };
+	}
+
+	inline Float4 operator-(const Float4& a, const Float4& b)
+	{
+		return { _mm_sub_ps(a.v, b.v) };
+	}
+
+	inline Float4 operator*(const Float4& a, const Float4& b)
+	{
+		return { _mm_mul_ps(a.v, b.v) };
+	}
+
+	inline Float4 operator/(const Float4& a, const Float4& b)
+	{
+		return { _mm_div_ps(a.v, b.v) };
+	}
+
+	inline Float4 min(const Float4& a, const Float4& b)
+	{
+		return { _mm_min_ps(a.v, b.v) };
+	}
+
+	inline Float4 max(const Float4& a, const Float4& b)
+	{
+		return { _mm_max_ps(a.v, b.v) };
+	}
+
+	inline Float4 sqrt(const Float4& a)
+	{
+		return { _mm_sqrt_ps(a.v) };
+	}
+
+	/**
+	 * @return A mask selecting the components where a is less than b
+	 */
+	inline Float4 lessThan(const Float4& a, const Float4& b)
+	{
+		return { _mm_cmplt_ps(a.v, b.v) };
+	}
+
+	/**
+	 * @return The components of a where the mask is set, and of b elsewhere
+	 */
+	inline Float4 select(const Float4& mask, const Float4& a, const Float4& b)
+	{
+		return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+	}
+
+	/**
+	 * Transposes four rows of four components, turning four vertices into their x, y, z and w components
+	 */
+	inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+	{
+		_MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+	}
+
+#else
+
+	/**
+	 * Four floats processed together, for targets without SSE
+	 */
+	struct Float4 {
+		float v[4];
+	};
+
+	template <typename Function>
+	inline Float4 apply(const Float4& a, const Float4& b, const Function& func)
+	{
+		return { { func(a.v[0], b.v[0]), func(a.v[1], b.v[1]), func(a.v[2], b.v[2]), func(a.v[3], b.v[3]) } };
+	}
+
+	inline Float4 splat(float s)
+	{
+		return { { s, s, s, s } };
+	}
+
+	inline Float4 load(const float* p)
+	{
+		return { { p[0], p[1], p[2], p[3] } };
+	}
+
+	inline Float4 load3(const float* p)
+	{
+		return { { p[0], p[1], p[2], 0.f } };
+	}
+
+	inline void store(const Float4& a, float* p)
+	{
+		std::memcpy(p, a.v, sizeof(a.v));
+	}
+
+	inline Float4 operator+(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x + y; });
+	}
+
+	inline Float4 operator-(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x - y; });
+	}
+
+	inline Float4 operator*(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x * y; });
+	}
+
+	inline Float4 operator/(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x / y; });
+	}
+
+	inline Float4 min(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x < y ? x : y; });
+	}
+
+	inline Float4 max(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x > y ? x : y; });
+	}
+
+	inline Float4 sqrt(const Float4& a)
+	{
+		return apply(a, a, [](float x, float) { return std::sqrt(x); });
+	}
+
+	/**
+	 * @return A mask selecting the components where a is less than b
+	 */
+	inline Float4 lessThan(const Float4& a, const Float4& b)
+	{
+		return apply(a, b, [](float x, float y) { return x < y ? 1.f : 0.f; });
+	}
+
+	/**
+	 * @return The components of a where the mask is set, and of b elsewhere
+	 */
+	inline Float4 select(const Float4& mask, const Float4& a, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			result.v[i] = mask.v[i] != 0.f ? a.v[i] : b.v[i];
+		}
+		return result;
+	}
+
+	/**
+	 * Transposes four rows of four components, turning four vertices into their x, y, z and w components
+	 */
+	inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+	{
+		Float4 rows[4] = { a, b, c, d };
+		for (int i = 0; i < 4; i++)
+		{
+			a.v[i] = rows[i].v[0];
+			b.v[i] = rows[i].v[1];
+			c.v[i] = rows[i].v[2];
+			d.v[i] = rows[i].v[3];
+		}
+	}
+
+#endif
+
+	/**
+	 * @return The component of a vector at the given position
+	 */
+	inline float lane(const Float4& a, int i)
+	{
+		float values[4];
+		store(a, values);
+		return values[i];
+	}
+
+	inline Float4 dot(const Float4& ax, const Float4& ay, const Float4& az, const Float4& bx, const Float4& by,
+		const Float4& bz)
+	{
+		return ax * bx + ay * by + az * bz;
+	}
+
+	/**
+	 * Approximates the arc cosine of values in the range -1 to 1, with an error below 7e-5 radians (Abramowitz and
+	 * Stegun 4.4.45)
+	 */
+	inline Float4 acosApprox(const Float4& x)
+	{
+		Float4 ax = max(x, splat(0.f) - x);
+		Float4 poly = ((splat(-0.0187293f) * ax + splat(0.0742610f)) * ax - splat(0.2121144f)) * ax + splat(1.5707288f);
+		Float4 r = sqrt(splat(1.f) - ax) * poly;
+		return select(lessThan(x, splat(0.f)), splat(PI) - r, r);
+	}
+
+	inline float acosApprox(float x)
+	{
+		float ax = std::fabs(x);
+		float r = std::sqrt(1.f - ax) * (((-0.0187293f * ax + 0.0742610f) * ax - 0.2121144f) * ax + 1.5707288f);
+		return x < 0.f ? PI - r : r;
+	}
+
+	/**
+	 * Loads the position or normal of a vertex. Vectors are loaded as four floats, unless that would read past the
+	 * end of the array.
+	 */
+	inline Float4 loadVector(const float* values, unsigned int index, unsigned int numVertices, unsigned int stride)
+	{
+		const float* p = values + (size_t) index * stride;
+		return stride > 3 || index + 1 < numVertices ? load(p) : load3(p);
+	}
+
+	/**
+	 * @return The number of tasks a kernel over the given number of elements is split into
+	 */
+	unsigned int getNumTasks(unsigned int numElements)
+	{
+		return std::max(1u, (numElements + GeometryKernels::PARALLEL_THRESHOLD - 1) / GeometryKernels::PARALLEL_THRESHOLD);
+	}
+
+	/**
+	 * Splits the vertices into contiguous ranges processed by separate threads. Every range scans all triangles but
+	 * only accumulates into its own vertices, so that no two threads write to the same vertex, and every vertex sums
+	 * its triangles in the same order regardless of the number of threads.
+	 * @param <Function> Callable taking the first vertex of a range and the vertex following its last one
+	 */
+	template <typename Function>
+	void forEachVertexRange(unsigned int numVertices, const Function& func)
+	{
+		unsigned int numRanges = numVertices > GeometryKernels::PARALLEL_THRESHOLD ? getHardwareConcurrency() : 1;
+		parallelFor(numRanges, 0, [&](unsigned int range)
+		{
+			unsigned int first = (unsigned int) ((unsigned long long) numVertices * range / numRanges);
+			unsigned int end = (unsigned int) ((unsigned long long) numVertices * (range + 1) / numRanges);
+			func(first, end);
+		});
+	}
+
+	/**
+	 * @return True if a triangle references a vertex of the given range
+	 * @throws OutOfBoundsException If the triangle references a vertex outside of the geometry
+	 */
+	inline bool touchesRange(const unsigned int* triangle, unsigned int first, unsigned int end, unsigned int numVertices)
+	{
+		if (triangle[0] >= numVertices || triangle[1] >= numVertices || triangle[2] >= numVertices)
+		{
+			throw OutOfBoundsException("Index references a vertex outside of the geometry");
+		}
+
+		unsigned int count = end - first;
+		return triangle[0] - first < count || triangle[1] - first < count || triangle[2] - first < count;
+	}
+
+	/**
+	 * Three floats, constructed inline in the innermost loops
+	 */
+	struct Float3 {
+		float x;
+		float y;
+		float z;
+	};
+
+	inline Float3 readVector(const float* values, unsigned int index, unsigned int stride)
+	{
+		const float* v = values + (size_t) index * stride;
+		return { v[0], v[1], v[2] };
+	}
+
+	inline Float3 subtract(const Float3& a, const Float3& b)
+	{
+		return { a.x - b.x, a.y - b.y, a.z - b.z };
+	}
+
+	inline Float3 multiply(const Float3& a, float s)
+	{
+		return { a.x * s, a.y * s, a.z * s };
+	}
+
+	inline float dot(const Float3& a, const Float3& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	/**
+	 * Projects a vector onto the plane of a unit normal
+	 */
+	inline Float3 projectOntoPlane(const Float3& v, const Float3& n)
+	{
+		return subtract(v, multiply(n, dot(n, v)));
+	}
+
+	/**
+	 * Computes the normals and corner weights of up to four triangles at once, and adds them to the normals of the
+	 * corners that lie within a range of vertices
+	 */
+	void accumulateNormals(const float* positions, unsigned int numVertices, unsigned int stride,
+		const unsigned int* indices, const unsigned int* triangles, unsigned int numTriangles, bool angleWeighted,
+		unsigned int first, unsigned int end, float* normals)
+	{
+		// Missing triangles repeat the last one, and are never written
+		Float4 corners[3][4];
+		for (unsigned int k = 0; k < 4; k++)
+		{
+			const unsigned int* triangle = indices + (size_t) triangles[std::min(k, numTriangles - 1)] * 3;
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				corners[c][k] = loadVector(positions, triangle[c], numVertices, stride);
+			}
+		}
+		for (unsigned int c = 0; c < 3; c++)
+		{
+			transpose(corners[c][0], corners[c][1], corners[c][2], corners[c][3]);
+		}
+
+		Float4 e1x = corners[1][0] - corners[0][0];
+		Float4 e1y = corners[1][1] - corners[0][1];
+		Float4 e1z = corners[1][2] - corners[0][2];
+		Float4 e2x = corners[2][0] - corners[0][0];
+		Float4 e2y = corners[2][1] - corners[0][1];
+		Float4 e2z = corners[2][2] - corners[0][2];
+
+		// The cross product of two edges has a length of twice the area of the triangle
+		Float4 nx = e1y * e2z - e1z * e2y;
+		Float4 ny = e1z * e2x - e1x * e2z;
+		Float4 nz = e1x * e2y - e1y * e2x;
+		Float4 w0 = splat(1.f);
+		Float4 w1 = w0;
+		Float4 w2 = w0;
+
+		if (angleWeighted)
+		{
+			Float4 inverseLength = splat(1.f) / max(sqrt(dot(nx, ny, nz, nx, ny, nz)), splat(EPSILON));
+			nx = nx * inverseLength;
+			ny = ny * inverseLength;
+			nz = nz * inverseLength;
+
+			Float4 e3x = corners[2][0] - corners[1][0];
+			Float4 e3y = corners[2][1] - corners[1][1];
+			Float4 e3z = corners[2][2] - corners[1][2];
+			Float4 l1 = dot(e1x, e1y, e1z, e1x, e1y, e1z);
+			Float4 l2 = dot(e2x, e2y, e2z, e2x, e2y, e2z);
+			Float4 l3 = dot(e3x, e3y, e3z, e3x, e3y, e3z);
+
+			Float4 cos0 = dot(e1x, e1y, e1z, e2x, e2y, e2z) / sqrt(max(l1 * l2, splat(EPSILON)));
+			Float4 cos1 = (splat(0.f) - dot(e1x, e1y, e1z, e3x, e3y, e3z)) / sqrt(max(l1 * l3, splat(EPSILON)));
+			w0 = acosApprox(max(min(cos0, splat(1.f)), splat(-1.f)));
+			w1 = acosApprox(max(min(cos1, splat(1.f)), splat(-1.f)));
+			w2 = max(splat(PI) - w0 - w1, splat(0.f));
+		}
+
+		Float4 padding = splat(0.f);
+		transpose(nx, ny, nz, padding);
+		Float4 weightPadding = splat(0.f);
+		transpose(w0, w1, w2, weightPadding);
+
+		Float4 faceNormals[4] = { nx, ny, nz, padding };
+		Float4 faceWeights[4] = { w0, w1, w2, weightPadding };
+		for (unsigned int k = 0; k < numTriangles; k++)
+		{
+			float normal[4];
+			float weights[4];
+			store(faceNormals[k], normal);
+			store(faceWeights[k], weights);
+
+			const unsigned int* triangle = indices + (size_t) triangles[k] * 3;
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int v = triangle[c];
+				if (v >= first && v < end)
+				{
+					float* sum = normals + (size_t) v * 3;
+					sum[0] += normal[0] * weights[c];
+					sum[1] += normal[1] * weights[c];
+					sum[2] += normal[2] * weights[c];
+				}
+			}
+		}
+	}
+
+	/**
+	 * Computes the texture space u direction of up to four triangles at once, and adds it to the tangents of the
+	 * corners that lie within a range of vertices. Each corner adds the direction projected onto the tangent plane of
+	 * its normal, weighted by the corner angle within that plane, and adds the orientation of the triangle in texture
+	 * space weighted by the same angle to the fourth component.
+	 */
+	void accumulateTangents(const float* positions, unsigned int positionStride, const float* normals,
+		unsigned int normalStride, const float* uvs, unsigned int uvStride, unsigned int numVertices,
+		const unsigned int* indices, const unsigned int* triangles, unsigned int numTriangles, unsigned int first,
+		unsigned int end, float* tangents)
+	{
+		// Missing triangles repeat the last one, and are never written
+		Float4 p[3][4];
+		Float4 n[3][4];
+		float uv[3][2][4];
+		for (unsigned int k = 0; k < 4; k++)
+		{
+			const unsigned int* triangle = indices + (size_t) triangles[std::min(k, numTriangles - 1)] * 3;
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				p[c][k] = loadVector(positions, triangle[c], numVertices, positionStride);
+				n[c][k] = loadVector(normals, triangle[c], numVertices, normalStride);
+				const float* texCoord = uvs + (size_t) triangle[c] * uvStride;
+				uv[c][0][k] = texCoord[0];
+				uv[c][1][k] = texCoord[1];
+			}
+		}
+		for (unsigned int c = 0; c < 3; c++)
+		{
+			transpose(p[c][0], p[c][1], p[c][2], p[c][3]);
+			transpose(n[c][0], n[c][1], n[c][2], n[c][3]);
+		}
+
+		Float4 zero = splat(0.f);
+		Float4 epsilon = splat(EPSILON);
+		Float4 du1 = load(uv[1][0]) - load(uv[0][0]);
+		Float4 dv1 = load(uv[1][1]) - load(uv[0][1]);
+		Float4 du2 = load(uv[2][0]) - load(uv[0][0]);
+		Float4 dv2 = load(uv[2][1]) - load(uv[0][1]);
+		Float4 signedArea = du1 * dv2 - dv1 * du2;
+		Float4 orientation = select(lessThan(signedArea, zero), splat(-1.f), splat(1.f));
+		Float4 hasTextureSpace = lessThan(epsilon, max(signedArea, zero - signedArea));
+
+		Float4 s[3];
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			Float4 e1 = p[1][i] - p[0][i];
+			Float4 e2 = p[2][i] - p[0][i];
+			s[i] = (e1 * dv2 - e2 * dv1) * orientation;
+		}
+
+		Float4 directions[3][4];
+		for (unsigned int c = 0; c < 3; c++)
+		{
+			const Float4* normal = n[c];
+			Float4 toNext[3];
+			Float4 toPrevious[3];
+			Float4 direction[3];
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				toNext[i] = p[(c + 1) % 3][i] - p[c][i];
+				toPrevious[i] = p[(c + 2) % 3][i] - p[c][i];
+			}
+
+			// Project onto the tangent plane of the vertex normal
+			Float4 nextOffset = dot(normal[0], normal[1], normal[2], toNext[0], toNext[1], toNext[2]);
+			Float4 previousOffset = dot(normal[0], normal[1], normal[2], toPrevious[0], toPrevious[1], toPrevious[2]);
+			Float4 directionOffset = dot(normal[0], normal[1], normal[2], s[0], s[1], s[2]);
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				toNext[i] = toNext[i] - normal[i] * nextOffset;
+				toPrevious[i] = toPrevious[i] - normal[i] * previousOffset;
+				direction[i] = s[i] - normal[i] * directionOffset;
+			}
+
+			Float4 edgeLengthSq = dot(toNext[0], toNext[1], toNext[2], toNext[0], toNext[1], toNext[2]) *
+				dot(toPrevious[0], toPrevious[1], toPrevious[2], toPrevious[0], toPrevious[1], toPrevious[2]);
+			Float4 directionLengthSq = dot(direction[0], direction[1], direction[2], direction[0], direction[1],
+				direction[2]);
+			Float4 cosAngle = dot(toNext[0], toNext[1], toNext[2], toPrevious[0], toPrevious[1], toPrevious[2]) /
+				sqrt(max(edgeLengthSq, epsilon));
+			Float4 angle = acosApprox(max(min(cosAngle, splat(1.f)), splat(-1.f)));
+
+			// Corners without a texture space, or whose edges or direction vanish in the tangent plane, add nothing
+			angle = select(hasTextureSpace, angle, zero);
+			angle = select(lessThan(epsilon, edgeLengthSq), angle, zero);
+			angle = select(lessThan(epsilon, directionLengthSq), angle, zero);
+
+			Float4 scale = angle / sqrt(max(directionLengthSq, epsilon));
+			directions[c][0] = direction[0] * scale;
+			directions[c][1] = direction[1] * scale;
+			directions[c][2] = direction[2] * scale;
+			directions[c][3] = orientation * angle;
+			transpose(directions[c][0], directions[c][1], directions[c][2], directions[c][3]);
+		}
+
+		for (unsigned int k = 0; k < numTriangles; k++)
+		{
+			const unsigned int* triangle = indices + (size_t) triangles[k] * 3;
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int v = triangle[c];
+				if (v >= first && v < end)
+				{
+					float* tangent = tangents + (size_t) v * 4;
+					store(load(tangent) + directions[c][k], tangent);
+				}
+			}
+		}
+	}
+}
+
+Box GeometryKernels::computeBounds(const float* positions, unsigned int numVertices, unsigned int stride)
+{
+	if (numVertices == 0)
+	{
+		return Box();
+	}
+
+	unsigned int numTasks = getNumTasks(numVertices);
+	std::vector<Float4> mins(numTasks);
+	std::vector<Float4> maxs(numTasks);
+	parallelFor(numTasks, 0, [&](unsigned int task)
+	{
+		unsigned int first = task * PARALLEL_THRESHOLD;
+		unsigned int end = std::min(numVertices, first + PARALLEL_THRESHOLD);
+
+		// Two pairs of accumulators hide the latency of the comparisons
+		Float4 lo0 = loadVector(positions, first, numVertices, stride);
+		Float4 hi0 = lo0;
+		Float4 lo1 = lo0;
+		Float4 hi1 = lo0;
+		unsigned int i = first + 1;
+		for (; i + 1 < end; i += 2)
+		{
+			Float4 a = loadVector(positions, i, numVertices, stride);
+			Float4 b = loadVector(positions, i + 1, numVertices, stride);
+			lo0 = min(lo0, a);
+			hi0 = max(hi0, a);
+			lo1 = min(lo1, b);
+			hi1 = max(hi1, b);
+		}
+		if (i < end)
+		{
+			Float4 a = loadVector(positions, i, numVertices, stride);
+			lo0 = min(lo0, a);
+			hi0 = max(hi0, a);
+		}
+
+		mins[task] = min(lo0, lo1);
+		maxs[task] = max(hi0, hi1);
+	});
+
+	Float4 lo = mins[0];
+	Float4 hi = maxs[0];
+	for (unsigned int i = 1; i < numTasks; i++)
+	{
+		lo = min(lo, mins[i]);
+		hi = max(hi, maxs[i]);
+	}
+
+	return Box(Vector3(lane(lo, 0), lane(lo, 1), lane(lo, 2)), Vector3(lane(hi, 0), lane(hi, 1), lane(hi, 2)));
+}
+
+Sphere GeometryKernels::computeBoundingSphere(const float* positions, unsigned int numVertices, unsigned int stride,
+	const Box& bounds)
+{
+	if (numVertices == 0 || bounds.isEmpty())
+	{
+		return Sphere();
+	}
+
+	Vector3 center = bounds.getCenter();
+	unsigned int numTasks = getNumTasks(numVertices);
+	std::vector<float> maxDistances(numTasks);
+	parallelFor(numTasks, 0, [&](unsigned int task)
+	{
+		unsigned int first = task * PARALLEL_THRESHOLD;
+		unsigned int end = std::min(numVertices, first + PARALLEL_THRESHOLD);
+		Float4 cx = splat(center.x);
+		Float4 cy = splat(center.y);
+		Float4 cz = splat(center.z);
+
+		// Transpose groups of four vertices, so that each component holds the distance to one vertex
+		Float4 maxDistSq = splat(0.f);
+		unsigned int i = first;
+		for (; i + 4 <= end; i += 4)
+		{
+			Float4 x = loadVector(positions, i, numVertices, stride);
+			Float4 y = loadVector(positions, i + 1, numVertices, stride);
+			Float4 z = loadVector(positions, i + 2, numVertices, stride);
+			Float4 w = loadVector(positions, i + 3, numVertices, stride);
+			transpose(x, y, z, w);
+
+			Float4 dx = x - cx;
+			Float4 dy = y - cy;
+			Float4 dz = z - cz;
+			maxDistSq = max(maxDistSq, dot(dx, dy, dz, dx, dy, dz));
+		}
+
+		float result = std::max(std::max(lane(maxDistSq, 0), lane(maxDistSq, 1)),
+			std::max(lane(maxDistSq, 2), lane(maxDistSq, 3)));
+		for (; i < end; i++)
+		{
+			Float3 d = subtract(readVector(positions, i, stride), { center.x, center.y, center.z });
+			result = std::max(result, dot(d, d));
+		}
+
+		maxDistances[task] = result;
+	});
+
+	float maxDistSq = *std::max_element(maxDistances.begin(), maxDistances.end());
+	return Sphere(center, std::sqrt(maxDistSq));
+}
+
+void GeometryKernels::computeVertexNormals(const float* positions, unsigned int numVertices, unsigned int stride,
+	const unsigned int* indices, unsigned int numIndices, NormalWeighting weighting, float* normals)
+{
+	unsigned int numTriangles = numIndices / 3;
+	bool angleWeighted = weighting == NormalWeighting::ANGLE;
+
+	// Accumulate the weighted triangle normals at each vertex, computing four triangles at a time
+	forEachVertexRange(numVertices, [&](unsigned int first, unsigned int end)
+	{
+		std::fill(normals + (size_t) first * 3, normals + (size_t) end * 3, 0.f);
+
+		unsigned int batch[4];
+		unsigned int batchSize = 0;
+		for (unsigned int t = 0; t < numTriangles; t++)
+		{
+			if (touchesRange(indices + (size_t) t * 3, first, end, numVertices))
+			{
+				batch[batchSize++] = t;
+				if (batchSize == 4)
+				{
+					accumulateNormals(positions, numVertices, stride, indices, batch, 4, angleWeighted, first, end,
+						normals);
+					batchSize = 0;
+				}
+			}
+		}
+
+		if (batchSize > 0)
+		{
+			accumulateNormals(positions, numVertices, stride, indices, batch, batchSize, angleWeighted, first, end,
+				normals);
+		}
+	});
+
+	// Normalize in place. Zero sums stay zero.
+	unsigned int numTasks = getNumTasks(numVertices);
+	parallelFor(numTasks, 0, [&](unsigned int task)
+	{
+		unsigned int first = task * PARALLEL_THRESHOLD;
+		unsigned int end = std::min(numVertices, first + PARALLEL_THRESHOLD);
+		for (unsigned int v = first; v < end; v++)
+		{
+			float* n = normals + (size_t) v * 3;
+			float lengthSq = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+			float inverseLength = lengthSq > EPSILON ? 1.f / std::sqrt(lengthSq) : 0.f;
+			n[0] *= inverseLength;
+			n[1] *= inverseLength;
+			n[2] *= inverseLength;
+		}
+	});
+}
+
+void GeometryKernels::computeTangents(const float* positions, unsigned int positionStride, const float* normals,
+	unsigned int normalStride, const float* uvs, unsigned int uvStride, unsigned int numVertices,
+	const unsigned int* indices, unsigned int numIndices, float* tangents)
+{
+	unsigned int numTriangles = numIndices / 3;
+
+	// Accumulate the texture space u direction of each triangle at its vertices, projected onto the tangent plane of
+	// the vertex and weighted by the corner angle within that plane. The fourth component sums the orientation of the
+	// triangles in texture space, which determines the handedness of the bitangent.
+	forEachVertexRange(numVertices, [&](unsigned int first, unsigned int end)
+	{
+		std::fill(tangents + (size_t) first * 4, tangents + (size_t) end * 4, 0.f);
+
+		unsigned int batch[4];
+		unsigned int batchSize = 0;
+		for (unsigned int t = 0; t < numTriangles; t++)
+		{
+			if (touchesRange(indices + (size_t) t * 3, first, end, numVertices))
+			{
+				batch[batchSize++] = t;
+				if (batchSize == 4)
+				{
+					accumulateTangents(positions, positionStride, normals, normalStride, uvs, uvStride, numVertices,
+						indices, batch, 4, first, end, tangents);
+					batchSize = 0;
+				}
+			}
+		}
+
+		if (batchSize > 0)
+		{
+			accumulateTangents(positions, positionStride, normals, normalStride, uvs, uvStride, numVertices, indices,
+				batch, batchSize, first, end, tangents);
+		}
+	});
+
+	// Orthogonalize against the normal, and determine the handedness of the bitangent
+	unsigned int numTasks = getNumTasks(numVertices);
+	parallelFor(numTasks, 0, [&](unsigned int task)
+	{
+		unsigned int first = task * PARALLEL_THRESHOLD;
+		unsigned int end = std::min(numVertices, first + PARALLEL_THRESHOLD);
+		for (unsigned int v = first; v < end; v++)
+		{
+			float* tangent = tangents + (size_t) v * 4;
+			Float3 n = readVector(normals, v, normalStride);
+			Float3 t = projectOntoPlane({ tangent[0], tangent[1], tangent[2] }, n);
+			float lengthSq = dot(t, t);
+			if (lengthSq <= EPSILON)
+			{
+				// Any direction perpendicular to the normal is valid
+				Float3 axis = std::fabs(n.x) < 0.9f ? Float3{ 1.f, 0.f, 0.f } : Float3{ 0.f, 1.f, 0.f };
+				t = projectOntoPlane(axis, n);
+				lengthSq = dot(t, t);
+			}
+
+			t = multiply(t, 1.f / std::sqrt(lengthSq));
+			tangent[0] = t.x;
+			tangent[1] = t.y;
+			tangent[2] = t.z;
+			tangent[3] = tangent[3] < 0.f ? -1.f : 1.f;
+		}
+	});
+}
@@ -0,0 +1,625 @@
+#include <graphics/geometry/GeometryOptimizer.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/core/Color.h>
+#include <math/Vector2.h>
+#include <math/Vector3.h>
+#include <common/Assertions.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <unordered_map>
+
+const unsigned int GeometryOptimizer::DEFAULT_CACHE_SIZE = 16;
+const float GeometryOptimizer::DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+const float GeometryOptimizer::DEFAULT_WELD_TOLERANCE = 1e-6f;
+
+namespace
+{
+	/**
+	 * Ensures the indices form whole triangles referencing valid vertices
+	 */
+	void validateTriangles(const unsigned int* indices, unsigned int numIndices, unsigned int numVertices)
+	{
+		assertTrue(numIndices % 3 == 0, "Indices must form whole triangles");
+		for (unsigned int i = 0; i < numIndices; i++)
+		{
+			if (indices[i] >= numVertices)
+			{
+				throw OutOfBoundsException("Index references a vertex outside of the geometry");
+			}
+		}
+	}
+
+	/**
+	 * Simulates a FIFO post-transform vertex cache. A vertex is cached if fewer than cacheSize misses have occurred
+	 * since it was last transformed.
+	 */
+	class VertexCache
+	{
+	public:
+
+		VertexCache(unsigned int numVertices, unsigned int cacheSize) : _cacheSize(cacheSize),
+			_time(cacheSize + 1), _timestamps(numVertices, 0)
+		{
+
+		}
+
+		/**
+		 * Looks up a vertex, transforming it on a miss. Returns true if the vertex missed the cache.
+		 */
+		bool access(unsigned int vertex)
+		{
+			if (_time - _timestamps[vertex] > _cacheSize)
+			{
+				_timestamps[vertex] = _time++;
+				return true;
+			}
+
+			return false;
+		}
+
+		/**
+		 * Looks up the three vertices of a triangle, returning the number of misses
+		 */
+		unsigned int accessTriangle(const unsigned int* triangle)
+		{
+			return (access(triangle[0]) ? 1 : 0) + (access(triangle[1]) ? 1 : 0) + (access(triangle[2]) ? 1 : 0);
+		}
+
+		/**
+		 * Evicts all vertices
+		 */
+		void clear()
+		{
+			_time += _cacheSize + 1;
+		}
+
+	private:
+
+		unsigned int _cacheSize;
+		unsigned int _time;
+		std::vector<unsigned int> _timestamps;
+	};
+
+	/**
+	 * Counts the cache misses of a triangle list
+	 */
+	unsigned int countMisses(const unsigned int* indices, unsigned int numIndices, unsigned int numVertices,
+		unsigned int cacheSize)
+	{
+		VertexCache cache(numVertices, cacheSize);
+		unsigned int misses = 0;
+		for (unsigned int i = 0; i + 2 < numIndices; i += 3)
+		{
+			misses += cache.accessTriangle(indices + i);
+		}
+
+		return misses;
+	}
+
+	/**
+	 * Returns the interleaved vertex data of a geometry, interleaving its per-attribute arrays into the given
+	 * storage if it holds no interleaved data
+	 */
+	const float* getVertexData(const GeometryPtr& geometry, std::vector<float>& storage)
+	{
+		const float* interleaved = geometry->getInterleavedVertices();
+		if (interleaved)
+		{
+			return interleaved;
+		}
+
+		const Vector3* vertices = geometry->getVertices();
+		assertNotNull(vertices, "Geometry must contain vertex positions to optimize");
+
+		const Vector3* normals = geometry->getNormals();
+		const Color* colors = geometry->getColors();
+		const Vector2* uvs = geometry->getTextureCoords();
+		unsigned int numVertices = geometry->getNumVertices();
+		unsigned int stride = geometry->getAttributes().getStride();
+
+		storage.resize((size_t) numVertices * stride);
+		for (unsigned int i = 0; i < numVertices; i++)
+		{
+			float* v = &storage[(size_t) i * stride];
+			*v++ = vertices[i].x;
+			*v++ = vertices[i].y;
+			*v++ = vertices[i].z;
+
+			if (normals)
+			{
+				*v++ = normals[i].x;
+				*v++ = normals[i].y;
+				*v++ = normals[i].z;
+			}
+
+			if (colors)
+			{
+				*v++ = colors[i].red();
+				*v++ = colors[i].green();
+				*v++ = colors[i].blue();
+				*v++ = colors[i].alpha();
+			}
+
+			if (uvs)
+			{
+				*v++ = uvs[i].x;
+				*v++ = uvs[i].y;
+			}
+		}
+
+		return storage.data();
+	}
+
+	/**
+	 * Combines the coordinates of a spatial hash cell into a single key
+	 */
+	unsigned long long getCellKey(long long x, long long y, long long z)
+	{
+		unsigned long long key = (unsigned long long) x * 73856093ull;
+		key ^= (unsigned long long) y * 19349663ull;
+		key ^= (unsigned long long) z * 83492791ull;
+		return key;
+	}
+
+	/**
+	 * Computes twice the area-weighted normal and the centroid of a triangle
+	 */
+	void getTriangleGeometry(const unsigned int* triangle, const float* positions, unsigned int stride, float* normal,
+		float* centroid)
+	{
+		const float* a = positions + (size_t) triangle[0] * stride;
+		const float* b = positions + (size_t) triangle[1] * stride;
+		const float* c = positions + (size_t) triangle[2] * stride;
+
+		Vector3 ab(b[0] - a[0], b[1] - a[1], b[2] - a[2]);
+		Vector3 ac(c[0] - a[0], c[1] - a[1], c[2] - a[2]);
+		Vector3 n = ab.cross(ac);
+		normal[0] = n.x;
+		normal[1] = n.y;
+		normal[2] = n.z;
+
+		for (int i = 0; i < 3; i++)
+		{
+			centroid[i] = (a[i] + b[i] + c[i]) / 3.f;
+		}
+	}
+}
+
+GeometryOptimizerStats GeometryOptimizer::optimize(const GeometryPtr& geometry, unsigned int cacheSize,
+	float overdrawThreshold)
+{
+	assertNotNull(geometry.get(), "Geometry cannot be null");
+	const unsigned int* indices = geometry->getIndices();
+	unsigned int numIndices = geometry->size();
+	unsigned int numVertices = geometry->getNumVertices();
+	assertTrue(indices != nullptr && numIndices > 0, "Geometry must contain vertex indices to optimize");
+
+	std::vector<float> storage;
+	const float* vertexData = getVertexData(geometry, storage);
+	unsigned int stride = geometry->getAttributes().getStride();
+
+	GeometryOptimizerStats stats;
+	stats.acmrBefore = getACMR(indices, numIndices, numVertices, cacheSize);
+	stats.atvrBefore = getATVR(indices, numIndices, numVertices, cacheSize);
+
+	std::vector<unsigned int> ordered = optimizeVertexCache(indices, numIndices, numVertices, cacheSize);
+	ordered = optimizeOverdraw(ordered.data(), numIndices, vertexData, numVertices, stride, cacheSize,
+		overdrawThreshold, &stats.numClusters);
+	std::vector<unsigned int> remap = optimizeVertexFetch(ordered.data(), numIndices, numVertices);
+
+	geometry->setIndices(ordered.data(), numIndices);
+	geometry->remapVertices(remap.data(), numVertices);
+
+	stats.acmrAfter = getACMR(geometry->getIndices(), numIndices, numVertices, cacheSize);
+	stats.atvrAfter = getATVR(geometry->getIndices(), numIndices, numVertices, cacheSize);
+	return stats;
+}
+
+unsigned int GeometryOptimizer::weld(const GeometryPtr& geometry, float tolerance)
+{
+	assertNotNull(geometry.get(), "Geometry cannot be null");
+	unsigned int numVertices = geometry->getNumVertices();
+	if (numVertices == 0)
+	{
+		return 0;
+	}
+
+	std::vector<float> storage;
+	const float* vertexData = getVertexData(geometry, storage);
+	unsigned int stride = geometry->getAttributes().getStride();
+
+	unsigned int numUnique = 0;
+	std::vector<unsigned int> remap = generateWeldRemap(vertexData, numVertices, stride, tolerance, &numUnique);
+	if (numUnique < numVertices)
+	{
+		geometry->remapVertices(remap.data(), numUnique);
+	}
+
+	return numVertices - numUnique;
+}
+
+std::vector<unsigned int> GeometryOptimizer::generateWeldRemap(const float* vertexData, unsigned int numVertices,
+	unsigned int stride, float tolerance, unsigned int* numUnique)
+{
+	assertTrue(tolerance >= 0.f, "Weld tolerance cannot be negative");
+
+	// Cells are at least as large as the tolerance, so matching vertices always lie in neighboring cells
+	float cellSize = tolerance > 0.f ? tolerance : 1.f;
+	int reach = tolerance > 0.f ? 1 : 0;
+
+	std::unordered_map<unsigned long long, std::vector<unsigned int>> cells;
+	std::vector<unsigned int> remap(numVertices);
+	unsigned int next = 0;
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		const float* v = vertexData + (size_t) i * stride;
+		long long cx = (long long) std::floor(v[0] / cellSize);
+		long long cy = (long long) std::floor(v[1] / cellSize);
+		long long cz = (long long) std::floor(v[2] / cellSize);
+
+		// Compare against the first vertex of every group in the neighboring cells
+		bool found = false;
+		for (int dx = -reach; dx <= reach && !found; dx++)
+		{
+			for (int dy = -reach; dy <= reach && !found; dy++)
+			{
+				for (int dz = -reach; dz <= reach && !found; dz++)
+				{
+					auto it = cells.find(getCellKey(cx + dx, cy + dy, cz + dz));
+					if (it == cells.end())
+					{
+						continue;
+					}
+
+					for (unsigned int candidate : it->second)
+					{
+						const float* c = vertexData + (size_t) candidate * stride;
+						unsigned int k = 0;
+						while (k < stride && std::abs(v[k] - c[k]) <= tolerance)
+						{
+							k++;
+						}
+
+						if (k == stride)
+						{
+							remap[i] = remap[candidate];
+							found = true;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		if (!found)
+		{
+			remap[i] = next++;
+			cells[getCellKey(cx, cy, cz)].push_back(i);
+		}
+	}
+
+	if (numUnique)
+	{
+		*numUnique = next;
+	}
+
+	return remap;
+}
+
+std::vector<unsigned int> GeometryOptimizer::optimizeVertexCache(const unsigned int* indices, unsigned int numIndices,
+	unsigned int numVertices, unsigned int cacheSize)
+{
+	validateTriangles(indices, numIndices, numVertices);
+	unsigned int numTriangles = numIndices / 3;
+
+	// Build the triangles adjacent to each vertex. Live counts track the adjacent triangles not yet emitted.
+	std::vector<unsigned int> liveCounts(numVertices, 0);
+	for (unsigned int i = 0; i < numIndices; i++)
+	{
+		liveCounts[indices[i]]++;
+	}
+
+	std::vector<unsigned int> offsets(numVertices + 1, 0);
+	for (unsigned int v = 0; v < numVertices; v++)
+	{
+		offsets[v + 1] = offsets[v] + liveCounts[v];
+	}
+
+	std::vector<unsigned int> adjacency(numIndices);
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (unsigned int i = 0; i < numIndices; i++)
+	{
+		adjacency[fill[indices[i]]++] = i / 3;
+	}
+
+	std::vector<unsigned int> timestamps(numVertices, 0);
+	std::vector<bool> emitted(numTriangles, false);
+	std::vector<unsigned int> deadEnd;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> result;
+	deadEnd.reserve(numIndices);
+	result.reserve(numIndices);
+
+	unsigned int time = cacheSize + 1;
+	unsigned int cursor = 0;
+	int fan = numVertices > 0 ? 0 : -1;
+	while (fan >= 0)
+	{
+		// Emit every remaining triangle around the fanning vertex
+		candidates.clear();
+		for (unsigned int k = offsets[fan]; k < offsets[fan + 1]; k++)
+		{
+			unsigned int triangle = adjacency[k];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+
+			for (unsigned int j = 0; j < 3; j++)
+			{
+				unsigned int v = indices[triangle * 3 + j];
+				result.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				liveCounts[v]--;
+
+				if (time - timestamps[v] > cacheSize)
+				{
+					timestamps[v] = time++;
+				}
+			}
+
+			emitted[triangle] = true;
+		}
+
+		// Prefer the candidate that has been in the cache the longest, provided it will still be cached once all of
+		// its remaining triangles are emitted
+		fan = -1;
+		int bestPriority = -1;
+		for (unsigned int v : candidates)
+		{
+			if (liveCounts[v] == 0)
+			{
+				continue;
+			}
+
+			int priority = 0;
+			if (time - timestamps[v] + 2 * liveCounts[v] <= cacheSize)
+			{
+				priority = (int)(time - timestamps[v]);
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fan = (int) v;
+			}
+		}
+
+		// Otherwise, fall back to the most recently referenced vertex with remaining triangles, then to the next
+		// vertex in input order
+		while (fan < 0 && !deadEnd.empty())
+		{
+			unsigned int v = deadEnd.back();
+			deadEnd.pop_back();
+			if (liveCounts[v] > 0)
+			{
+				fan = (int) v;
+			}
+		}
+
+		while (fan < 0 && cursor < numVertices)
+		{
+			if (liveCounts[cursor] > 0)
+			{
+				fan = (int) cursor;
+			}
+			cursor++;
+		}
+	}
+
+	return result;
+}
+
+std::vector<unsigned int> GeometryOptimizer::optimizeOverdraw(const unsigned int* indices, unsigned int numIndices,
+	const float* positions, unsigned int numVertices, unsigned int stride, unsigned int cacheSize, float threshold,
+	unsigned int* numClusters)
+{
+	validateTriangles(indices, numIndices, numVertices);
+	unsigned int numTriangles = numIndices / 3;
+	if (numTriangles == 0)
+	{
+		if (numClusters)
+		{
+			*numClusters = 0;
+		}
+		return std::vector<unsigned int>();
+	}
+
+	// Hard boundaries fall on triangles that miss the cache for all of their vertices, so splitting there costs
+	// nothing
+	std::vector<unsigned int> hardBoundaries;
+	VertexCache cache(numVertices, cacheSize);
+	for (unsigned int t = 0; t < numTriangles; t++)
+	{
+		if (cache.accessTriangle(indices + t * 3) == 3)
+		{
+			hardBoundaries.push_back(t);
+		}
+	}
+	hardBoundaries.push_back(numTriangles);
+
+	// Soft boundaries split hard clusters further, whenever the cache miss ratio of the cluster so far is within
+	// the threshold of the ratio of the whole hard cluster
+	std::vector<unsigned int> clusters;
+	for (unsigned int h = 0; h + 1 < hardBoundaries.size(); h++)
+	{
+		unsigned int start = hardBoundaries[h];
+		unsigned int end = hardBoundaries[h + 1];
+
+		cache.clear();
+		unsigned int misses = 0;
+		for (unsigned int t = start; t < end; t++)
+		{
+			misses += cache.accessTriangle(indices + t * 3);
+		}
+		float limit = threshold * misses / (float)(end - start);
+
+		cache.clear();
+		clusters.push_back(start);
+		unsigned int clusterStart = start;
+		unsigned int clusterMisses = 0;
+		for (unsigned int t = start; t + 1 < end; t++)
+		{
+			clusterMisses += cache.accessTriangle(indices + t * 3);
+			if (clusterMisses <= limit * (t + 1 - clusterStart))
+			{
+				clusters.push_back(t + 1);
+				clusterStart = t + 1;
+				clusterMisses = 0;
+				cache.clear();
+			}
+		}
+	}
+
+	unsigned int count = (unsigned int) clusters.size();
+	clusters.push_back(numTriangles);
+
+	// Compute the area-weighted centroid of the mesh, along with the centroid and facing of each cluster
+	std::vector<float> clusterData(count * 7, 0.f);
+	float meshCentroid[3] = { 0.f, 0.f, 0.f };
+	float meshArea = 0.f;
+	for (unsigned int c = 0; c < count; c++)
+	{
+		float* data = &clusterData[c * 7];
+		for (unsigned int t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			float normal[3], centroid[3];
+			getTriangleGeometry(indices + t * 3, positions, stride, normal, centroid);
+			float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+			for (int i = 0; i < 3; i++)
+			{
+				data[i] += centroid[i] * area;
+				data[i + 3] += normal[i];
+				meshCentroid[i] += centroid[i] * area;
+			}
+			data[6] += area;
+			meshArea += area;
+		}
+	}
+
+	std::vector<float> keys(count, 0.f);
+	if (meshArea > 0.f)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			meshCentroid[i] /= meshArea;
+		}
+
+		for (unsigned int c = 0; c < count; c++)
+		{
+			const float* data = &clusterData[c * 7];
+			if (data[6] <= 0.f)
+			{
+				continue;
+			}
+
+			Vector3 offset(data[0] / data[6] - meshCentroid[0], data[1] / data[6] - meshCentroid[1],
+				data[2] / data[6] - meshCentroid[2]);
+			Vector3 facing = Vector3(data[3], data[4], data[5]).normalize();
+			keys[c] = offset.dot(facing);
+		}
+	}
+
+	// Draw the most outward facing clusters first, as they are the most likely to occlude the rest of the mesh
+	std::vector<unsigned int> order(count);
+	for (unsigned int c = 0; c < count; c++)
+	{
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](unsigned int a, unsigned int b) {
+		return keys[a] > keys[b];
+	});
+
+	std::vector<unsigned int> result;
+	result.reserve(numIndices);
+	for (unsigned int c : order)
+	{
+		result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+	}
+
+	if (numClusters)
+	{
+		*numClusters = count;
+	}
+
+	return result;
+}
+
+std::vector<unsigned int> GeometryOptimizer::optimizeVertexFetch(const unsigned int* indices, unsigned int numIndices,
+	unsigned int numVertices)
+{
+	std::vector<unsigned int> remap(numVertices, UINT_MAX);
+	unsigned int next = 0;
+	for (unsigned int i = 0; i < numIndices; i++)
+	{
+		unsigned int v = indices[i];
+		if (v >= numVertices)
+		{
+			throw OutOfBoundsException("Index references a vertex outside of the geometry");
+		}
+
+		if (remap[v] == UINT_MAX)
+		{
+			remap[v] = next++;
+		}
+	}
+
+	for (unsigned int v = 0; v < numVertices; v++)
+	{
+		if (remap[v] == UINT_MAX)
+		{
+			remap[v] = next++;
+		}
+	}
+
+	return remap;
+}
+
+float GeometryOptimizer::getACMR(const unsigned int* indices, unsigned int numIndices, unsigned int numVertices,
+	unsigned int cacheSize)
+{
+	unsigned int numTriangles = numIndices / 3;
+	if (numTriangles == 0)
+	{
+		return 0.f;
+	}
+
+	return countMisses(indices, numIndices, numVertices, cacheSize) / (float) numTriangles;
+}
+
+float GeometryOptimizer::getATVR(const unsigned int* indices, unsigned int numIndices, unsigned int numVertices,
+	unsigned int cacheSize)
+{
+	std::vector<bool> referenced(numVertices, false);
+	unsigned int numReferenced = 0;
+	for (unsigned int i = 0; i < numIndices; i++)
+	{
+		if (!referenced[indices[i]])
+		{
+			referenced[indices[i]] = true;
+			numReferenced++;
+		}
+	}
+
+	if (numReferenced == 0)
+	{
+		return 0.f;
+	}
+
+	return countMisses(indices, numIndices, numVertices, cacheSize) / (float) numReferenced;
+}
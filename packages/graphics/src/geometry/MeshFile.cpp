@@ -0,0 +1,249 @@
+#include <graphics/geometry/MeshFile.h>
+#include <graphics/geometry/Geometry.h>
+#include <math/Sphere.h>
+#include <math/Vector3.h>
+#include <common/Assertions.h>
+#include <common/Hash.h>
+#include <common/MappedFile.h>
+#include <common/Parallel.h>
+#include <common/exceptions/InstantiationException.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+const std::string MeshFile::EXTENSION = ".tfmesh";
+const unsigned int MeshFile::VERSION = 1;
+const size_t MeshFile::ALIGNMENT = 64;
+
+namespace
+{
+	/**
+	 * The characters "TFMH" read as a little endian integer
+	 */
+	const uint32_t MAGIC = 0x484D4654;
+
+	/**
+	 * Written in the byte order of the host, so that files from hosts with another byte order can be detected
+	 */
+	const uint32_t ENDIAN_TAG = 0x01020304;
+
+	const uint32_t HAS_NORMALS = 1;
+	const uint32_t HAS_COLORS = 2;
+	const uint32_t HAS_UVS = 4;
+
+	/**
+	 * Header at the start of every file
+	 */
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t endianTag;
+		uint32_t headerSize;
+		uint32_t numGeometries;
+		uint32_t entrySize;
+		uint64_t fileSize;
+
+		/**
+		 * Checksum of everything following the header
+		 */
+		uint64_t checksum;
+		uint8_t reserved[24];
+	};
+
+	/**
+	 * Entry of the geometry table, which directly follows the header
+	 */
+	struct GeometryEntry {
+		uint32_t attributes;
+		uint8_t normalFormat;
+		uint8_t colorFormat;
+		uint8_t uvFormat;
+		uint8_t reserved0;
+		uint32_t numVertices;
+		uint32_t numIndices;
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		float bounds[4];
+		uint8_t reserved[16];
+	};
+
+	static_assert(sizeof(FileHeader) == 64, "Mesh file header must be 64 bytes");
+	static_assert(sizeof(GeometryEntry) == 64, "Mesh file geometry entries must be 64 bytes");
+
+	size_t align(size_t offset)
+	{
+		return (offset + MeshFile::ALIGNMENT - 1) & ~(MeshFile::ALIGNMENT - 1);
+	}
+
+	bool isValidFormat(uint8_t format)
+	{
+		return format <= static_cast<uint8_t>(AttributeFormat::INT_2_10_10_10_REV);
+	}
+}
+
+void MeshFile::write(const std::string& path, const std::vector<GeometryPtr>& geometries)
+{
+	size_t numGeometries = geometries.size();
+	std::vector<GeometryEntry> entries(numGeometries);
+	std::vector<std::vector<float>> storage(numGeometries);
+	std::vector<const float*> vertexData(numGeometries);
+	size_t offset = align(sizeof(FileHeader) + numGeometries * sizeof(GeometryEntry));
+
+	for (size_t i = 0; i < numGeometries; i++)
+	{
+		const GeometryPtr& geometry = geometries[i];
+		assertNotNull(geometry.get(), "Geometry cannot be null");
+		assertTrue(geometry->_vertices != nullptr || !geometry->_interleaved.empty(),
+			"Geometry must contain vertex positions to write");
+
+		GeometryAttributes attributes = geometry->getAttributes();
+		unsigned int numVertices = geometry->getNumVertices();
+		vertexData[i] = geometry->getInterleavedVertices();
+		if (!vertexData[i])
+		{
+			storage[i].resize((size_t) numVertices * attributes.getStride());
+			geometry->interleave(0, numVertices, storage[i].data());
+			vertexData[i] = storage[i].data();
+		}
+
+		GeometryEntry& entry = entries[i];
+		std::memset(&entry, 0, sizeof(entry));
+		entry.attributes = (attributes.normals ? HAS_NORMALS : 0) | (attributes.colors ? HAS_COLORS : 0) |
+			(attributes.uvs ? HAS_UVS : 0);
+		entry.normalFormat = static_cast<uint8_t>(attributes.normalFormat);
+		entry.colorFormat = static_cast<uint8_t>(attributes.colorFormat);
+		entry.uvFormat = static_cast<uint8_t>(attributes.uvFormat);
+		entry.numVertices = numVertices;
+		entry.numIndices = geometry->size();
+
+		const Sphere& bounds = geometry->getBoundingSphere();
+		entry.bounds[0] = bounds.center.x;
+		entry.bounds[1] = bounds.center.y;
+		entry.bounds[2] = bounds.center.z;
+		entry.bounds[3] = bounds.radius;
+
+		entry.vertexOffset = offset;
+		offset = align(offset + (size_t) numVertices * attributes.getStride() * sizeof(float));
+		entry.indexOffset = offset;
+		offset = align(offset + (size_t) entry.numIndices * sizeof(unsigned int));
+	}
+
+	std::vector<unsigned char> file(offset, 0);
+	for (size_t i = 0; i < numGeometries; i++)
+	{
+		const GeometryEntry& entry = entries[i];
+		std::memcpy(file.data() + sizeof(FileHeader) + i * sizeof(GeometryEntry), &entry, sizeof(GeometryEntry));
+		std::memcpy(file.data() + entry.indexOffset, geometries[i]->getIndices(),
+			(size_t) entry.numIndices * sizeof(unsigned int));
+		std::memcpy(file.data() + entry.vertexOffset, vertexData[i],
+			(size_t) entry.numVertices * geometries[i]->getAttributes().getStride() * sizeof(float));
+	}
+
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.endianTag = ENDIAN_TAG;
+	header.headerSize = sizeof(FileHeader);
+	header.numGeometries = (uint32_t) numGeometries;
+	header.entrySize = sizeof(GeometryEntry);
+	header.fileSize = offset;
+	header.checksum = checksum(file.data() + sizeof(FileHeader), offset - sizeof(FileHeader));
+	std::memcpy(file.data(), &header, sizeof(header));
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(file.data()), file.size());
+	if (!out)
+	{
+		throw InstantiationException("Failed to write mesh file " + path);
+	}
+}
+
+std::vector<GeometryPtr> MeshFile::read(const std::string& path, bool verify)
+{
+	MappedFile file(path);
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+	size_t size = file.size();
+
+	FileHeader header;
+	if (size < sizeof(FileHeader))
+	{
+		throw InstantiationException("Not a mesh file: " + path);
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.magic != MAGIC)
+	{
+		throw InstantiationException("Not a mesh file: " + path);
+	}
+	if (header.endianTag != ENDIAN_TAG)
+	{
+		throw InstantiationException("Mesh file was written on a host with another byte order: " + path);
+	}
+	if (header.version != VERSION)
+	{
+		throw InstantiationException("Unsupported mesh file version " + std::to_string(header.version) + ": " + path);
+	}
+	if (header.headerSize != sizeof(FileHeader) || header.entrySize != sizeof(GeometryEntry) ||
+		header.fileSize != size || (size - sizeof(FileHeader)) / sizeof(GeometryEntry) < header.numGeometries)
+	{
+		throw InstantiationException("Truncated mesh file: " + path);
+	}
+	if (verify && checksum(data + sizeof(FileHeader), size - sizeof(FileHeader)) != header.checksum)
+	{
+		throw InstantiationException("Mesh file is corrupt: " + path);
+	}
+
+	std::vector<GeometryEntry> entries(header.numGeometries);
+	std::memcpy(entries.data(), data + sizeof(FileHeader), entries.size() * sizeof(GeometryEntry));
+
+	std::vector<GeometryPtr> geometries(entries.size());
+	parallelFor((unsigned int) entries.size(), 0, [&](unsigned int i)
+	{
+		const GeometryEntry& entry = entries[i];
+		if (!isValidFormat(entry.normalFormat) || !isValidFormat(entry.colorFormat) || !isValidFormat(entry.uvFormat))
+		{
+			throw InstantiationException("Mesh file holds unknown attribute formats: " + path);
+		}
+
+		GeometryAttributes layout;
+		layout.normals = (entry.attributes & HAS_NORMALS) != 0;
+		layout.colors = (entry.attributes & HAS_COLORS) != 0;
+		layout.uvs = (entry.attributes & HAS_UVS) != 0;
+		layout.normalFormat = static_cast<AttributeFormat>(entry.normalFormat);
+		layout.colorFormat = static_cast<AttributeFormat>(entry.colorFormat);
+		layout.uvFormat = static_cast<AttributeFormat>(entry.uvFormat);
+
+		size_t numValues = (size_t) entry.numVertices * layout.getStride();
+		size_t indexBytes = (size_t) entry.numIndices * sizeof(unsigned int);
+		if (entry.vertexOffset % ALIGNMENT != 0 || entry.indexOffset % ALIGNMENT != 0 ||
+			entry.vertexOffset > size || numValues * sizeof(float) > size - entry.vertexOffset ||
+			entry.indexOffset > size || indexBytes > size - entry.indexOffset)
+		{
+			throw InstantiationException("Mesh file blocks lie outside of the file: " + path);
+		}
+
+		// Blocks are aligned, so they can be read in place
+		const float* vertices = reinterpret_cast<const float*>(data + entry.vertexOffset);
+		const unsigned int* indices = reinterpret_cast<const unsigned int*>(data + entry.indexOffset);
+		if (verify)
+		{
+			for (unsigned int j = 0; j < entry.numIndices; j++)
+			{
+				if (indices[j] >= entry.numVertices)
+				{
+					throw InstantiationException("Mesh file index references a missing vertex: " + path);
+				}
+			}
+		}
+
+		GeometryPtr geometry = Geometry::create();
+		geometry->setIndices(indices, entry.numIndices);
+		geometry->setInterleavedVertices(layout, std::vector<float>(vertices, vertices + numValues));
+		geometry->_boundingSphere = Sphere(Vector3(entry.bounds[0], entry.bounds[1], entry.bounds[2]), entry.bounds[3]);
+		geometry->_boundingSphereNeedsUpdate = false;
+		geometries[i] = geometry;
+	});
+
+	return geometries;
+}
@@ -0,0 +1,806 @@
+#include <graphics/geometry/MeshSimplifier.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryOptimizer.h>
+#include <common/Assertions.h>
+#include <common/Parallel.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+const float MeshSimplifier::DEFAULT_TARGET_ERROR = 0.01f;
+const unsigned int MeshSimplifier::DEFAULT_NUM_LEVELS = 4;
+const float MeshSimplifier::DEFAULT_LEVEL_RATIO = 0.5f;
+const float MeshSimplifier::DEFAULT_MAX_LOD_ERROR = 0.05f;
+
+namespace
+{
+	const unsigned int NONE = UINT_MAX;
+
+	/**
+	 * Weight of the planes keeping border edges in place, relative to the planes of the triangles
+	 */
+	const double BORDER_WEIGHT = 10.0;
+
+	/**
+	 * Weight of the planes keeping seam edges in place, relative to the planes of the triangles
+	 */
+	const double SEAM_WEIGHT = 1.0;
+
+	/**
+	 * How a vertex may move. Manifold vertices may collapse along any edge, border vertices only along the border,
+	 * and seam vertices only along the seam, together with their copy on the other side of the seam. Locked
+	 * vertices never move.
+	 */
+	enum class VertexKind { MANIFOLD, BORDER, SEAM, LOCKED };
+
+	/**
+	 * Sum of squared distances to a set of weighted planes
+	 */
+	struct Quadric {
+		double a2 = 0.0, b2 = 0.0, c2 = 0.0;
+		double ab = 0.0, ac = 0.0, bc = 0.0;
+		double ad = 0.0, bd = 0.0, cd = 0.0;
+		double d2 = 0.0;
+		double weight = 0.0;
+
+		void addPlane(double a, double b, double c, double d, double w)
+		{
+			a2 += a * a * w;
+			b2 += b * b * w;
+			c2 += c * c * w;
+			ab += a * b * w;
+			ac += a * c * w;
+			bc += b * c * w;
+			ad += a * d * w;
+			bd += b * d * w;
+			cd += c * d * w;
+			d2 += d * d * w;
+			weight += w;
+		}
+
+		void add(const Quadric& other)
+		{
+			a2 += other.a2;
+			b2 += other.b2;
+			c2 += other.c2;
+			ab += other.ab;
+			ac += other.ac;
+			bc += other.bc;
+			ad += other.ad;
+			bd += other.bd;
+			cd += other.cd;
+			d2 += other.d2;
+			weight += other.weight;
+		}
+
+		/**
+		 * Returns the weighted mean squared distance of a point to the planes
+		 */
+		double evaluate(const double* p) const
+		{
+			double x = p[0], y = p[1], z = p[2];
+			double error = a2 * x * x + b2 * y * y + c2 * z * z + 2.0 * (ab * x * y + ac * x * z + bc * y * z) +
+				2.0 * (ad * x + bd * y + cd * z) + d2;
+			return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+		}
+	};
+
+	/**
+	 * A candidate collapse of a vertex onto a neighbor
+	 */
+	struct Collapse {
+		unsigned int vertex;
+		unsigned int target;
+		double error;
+	};
+
+	void cross(const double* a, const double* b, double* result)
+	{
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	double dot(const double* a, const double* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	/**
+	 * Computes twice the area-weighted normal of a triangle
+	 */
+	void getNormal(const double* a, const double* b, const double* c, double* normal)
+	{
+		double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		double ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		cross(ab, ac, normal);
+	}
+
+	/**
+	 * Lists of vertices or triangles adjacent to each vertex, stored back to back
+	 */
+	struct Adjacency {
+		std::vector<unsigned int> offsets;
+		std::vector<unsigned int> data;
+
+		const unsigned int* begin(unsigned int vertex) const
+		{
+			return data.data() + offsets[vertex];
+		}
+
+		const unsigned int* end(unsigned int vertex) const
+		{
+			return data.data() + offsets[vertex + 1];
+		}
+	};
+
+	/**
+	 * Holds the state of simplifying a single triangle list
+	 */
+	class Simplifier
+	{
+	public:
+
+		Simplifier(const unsigned int* indices, unsigned int numIndices, const float* positions,
+			unsigned int numVertices, unsigned int stride) : _indices(indices, indices + numIndices),
+			_numVertices(numVertices), _points((size_t) numVertices * 3), _positions(numVertices),
+			_wedges(numVertices), _kinds(numVertices), _openNext(numVertices), _openPrevious(numVertices),
+			_quadrics(numVertices)
+		{
+			loadPoints(positions, stride);
+			buildPositions();
+		}
+
+		/**
+		 * Collapses edges until the triangle list holds no more than the target number of indices, or no collapse
+		 * stays within the error limit. Returns the largest error of any collapse performed.
+		 */
+		double run(unsigned int targetIndexCount, double errorLimit)
+		{
+			double resultError = 0.0;
+			bool first = true;
+			while (_indices.size() > targetIndexCount)
+			{
+				buildAdjacency();
+				classifyVertices();
+				if (first)
+				{
+					buildQuadrics();
+					first = false;
+				}
+
+				std::vector<Collapse> collapses = rankCollapses(errorLimit);
+				unsigned int goal = (unsigned int) ((_indices.size() - targetIndexCount + 2) / 3);
+				if (collapses.empty() || !performCollapses(collapses, goal, resultError))
+				{
+					break;
+				}
+			}
+
+			return resultError;
+		}
+
+		std::vector<unsigned int>& getIndices()
+		{
+			return _indices;
+		}
+
+	private:
+
+		std::vector<unsigned int> _indices;
+		unsigned int _numVertices;
+
+		/**
+		 * Vertex positions, scaled so that the largest extent of the mesh is 1
+		 */
+		std::vector<double> _points;
+
+		/**
+		 * The first vertex holding the same position as each vertex
+		 */
+		std::vector<unsigned int> _positions;
+
+		/**
+		 * The next vertex holding the same position as each vertex, forming a cycle
+		 */
+		std::vector<unsigned int> _wedges;
+
+		std::vector<VertexKind> _kinds;
+
+		/**
+		 * Neighbors along the single open outgoing and incoming edge of each vertex, if it has exactly one of each
+		 */
+		std::vector<unsigned int> _openNext;
+		std::vector<unsigned int> _openPrevious;
+
+		/**
+		 * Quadrics of each position, stored at its first vertex
+		 */
+		std::vector<Quadric> _quadrics;
+
+		Adjacency _edges;
+		Adjacency _triangles;
+
+		void loadPoints(const float* positions, unsigned int stride)
+		{
+			double min[3] = { INFINITY, INFINITY, INFINITY };
+			double max[3] = { -INFINITY, -INFINITY, -INFINITY };
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				const float* p = positions + (size_t) v * stride;
+				for (int i = 0; i < 3; i++)
+				{
+					min[i] = std::min(min[i], (double) p[i]);
+					max[i] = std::max(max[i], (double) p[i]);
+				}
+			}
+
+			double extent = 0.0;
+			for (int i = 0; i < 3; i++)
+			{
+				extent = std::max(extent, max[i] - min[i]);
+			}
+			double scale = extent > 0.0 ? 1.0 / extent : 1.0;
+
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				const float* p = positions + (size_t) v * stride;
+				for (int i = 0; i < 3; i++)
+				{
+					_points[(size_t) v * 3 + i] = (p[i] - min[i]) * scale;
+				}
+			}
+		}
+
+		const double* getPoint(unsigned int vertex) const
+		{
+			return _points.data() + (size_t) vertex * 3;
+		}
+
+		/**
+		 * Groups vertices holding exactly the same position, by sorting them
+		 */
+		void buildPositions()
+		{
+			std::vector<unsigned int> order(_numVertices);
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				order[v] = v;
+			}
+
+			std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b)
+			{
+				const double* p = getPoint(a);
+				const double* q = getPoint(b);
+				for (int i = 0; i < 3; i++)
+				{
+					if (p[i] != q[i])
+					{
+						return p[i] < q[i];
+					}
+				}
+				return a < b;
+			});
+
+			for (unsigned int i = 0; i < _numVertices;)
+			{
+				unsigned int j = i + 1;
+				const double* p = getPoint(order[i]);
+				while (j < _numVertices && std::memcmp(p, getPoint(order[j]), 3 * sizeof(double)) == 0)
+				{
+					j++;
+				}
+
+				for (unsigned int k = i; k < j; k++)
+				{
+					_positions[order[k]] = order[i];
+					_wedges[order[k]] = order[k + 1 < j ? k + 1 : i];
+				}
+				i = j;
+			}
+		}
+
+		/**
+		 * Builds the outgoing edges and the triangles of every vertex
+		 */
+		void buildAdjacency()
+		{
+			unsigned int numIndices = (unsigned int) _indices.size();
+			_edges.offsets.assign(_numVertices + 1, 0);
+			for (unsigned int i = 0; i < numIndices; i++)
+			{
+				_edges.offsets[_indices[i] + 1]++;
+			}
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				_edges.offsets[v + 1] += _edges.offsets[v];
+			}
+			_triangles.offsets = _edges.offsets;
+			_edges.data.resize(numIndices);
+			_triangles.data.resize(numIndices);
+
+			std::vector<unsigned int> fill(_edges.offsets.begin(), _edges.offsets.end() - 1);
+			for (unsigned int i = 0; i < numIndices; i++)
+			{
+				unsigned int v = _indices[i];
+				unsigned int next = _indices[i % 3 == 2 ? i - 2 : i + 1];
+				_edges.data[fill[v]] = next;
+				_triangles.data[fill[v]] = i / 3;
+				fill[v]++;
+			}
+		}
+
+		bool hasEdge(unsigned int a, unsigned int b) const
+		{
+			return std::find(_edges.begin(a), _edges.end(a), b) != _edges.end(a);
+		}
+
+		/**
+		 * Returns true if any copy of vertex a has an edge to any copy of vertex b
+		 */
+		bool hasPositionEdge(unsigned int a, unsigned int b) const
+		{
+			unsigned int target = _positions[b];
+			unsigned int wedge = a;
+			do
+			{
+				for (const unsigned int* it = _edges.begin(wedge); it != _edges.end(wedge); it++)
+				{
+					if (_positions[*it] == target)
+					{
+						return true;
+					}
+				}
+				wedge = _wedges[wedge];
+			} while (wedge != a);
+
+			return false;
+		}
+
+		void classifyVertices()
+		{
+			std::vector<unsigned int> openOutCount(_numVertices, 0);
+			std::vector<unsigned int> openInCount(_numVertices, 0);
+			std::fill(_openNext.begin(), _openNext.end(), NONE);
+			std::fill(_openPrevious.begin(), _openPrevious.end(), NONE);
+
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				for (const unsigned int* it = _edges.begin(v); it != _edges.end(v); it++)
+				{
+					if (!hasEdge(*it, v))
+					{
+						openOutCount[v]++;
+						openInCount[*it]++;
+						_openNext[v] = *it;
+						_openPrevious[*it] = v;
+					}
+				}
+			}
+
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				bool simple = openOutCount[v] == 1 && openInCount[v] == 1;
+				unsigned int wedge = _wedges[v];
+				if (wedge == v)
+				{
+					if (openOutCount[v] == 0 && openInCount[v] == 0)
+					{
+						_kinds[v] = VertexKind::MANIFOLD;
+					}
+					else if (simple && !hasPositionEdge(_openNext[v], v) && !hasPositionEdge(v, _openPrevious[v]))
+					{
+						_kinds[v] = VertexKind::BORDER;
+					}
+					else
+					{
+						// Ends of seams, and vertices where several borders meet
+						_kinds[v] = VertexKind::LOCKED;
+					}
+				}
+				else if (_wedges[wedge] == v && simple && openOutCount[wedge] == 1 && openInCount[wedge] == 1 &&
+					hasPositionEdge(_openNext[v], v) && hasPositionEdge(v, _openPrevious[v]))
+				{
+					_kinds[v] = VertexKind::SEAM;
+				}
+				else
+				{
+					_kinds[v] = VertexKind::LOCKED;
+				}
+			}
+		}
+
+		/**
+		 * Accumulates the planes of every triangle, and planes perpendicular to every border and seam edge, into
+		 * the quadrics of their positions
+		 */
+		void buildQuadrics()
+		{
+			for (size_t i = 0; i < _indices.size(); i += 3)
+			{
+				const unsigned int* triangle = &_indices[i];
+				double normal[3];
+				getNormal(getPoint(triangle[0]), getPoint(triangle[1]), getPoint(triangle[2]), normal);
+				double length = std::sqrt(dot(normal, normal));
+				if (length == 0.0)
+				{
+					continue;
+				}
+
+				double n[3] = { normal[0] / length, normal[1] / length, normal[2] / length };
+				double d = -dot(n, getPoint(triangle[0]));
+				for (int c = 0; c < 3; c++)
+				{
+					_quadrics[_positions[triangle[c]]].addPlane(n[0], n[1], n[2], d, length * 0.5);
+				}
+
+				for (int c = 0; c < 3; c++)
+				{
+					unsigned int a = triangle[c];
+					unsigned int b = triangle[(c + 1) % 3];
+					if (hasEdge(b, a))
+					{
+						continue;
+					}
+
+					const double* p = getPoint(a);
+					const double* q = getPoint(b);
+					double edge[3] = { q[0] - p[0], q[1] - p[1], q[2] - p[2] };
+					double perpendicular[3];
+					cross(edge, n, perpendicular);
+					double perpendicularLength = std::sqrt(dot(perpendicular, perpendicular));
+					if (perpendicularLength == 0.0)
+					{
+						continue;
+					}
+
+					for (int k = 0; k < 3; k++)
+					{
+						perpendicular[k] /= perpendicularLength;
+					}
+					double weight = dot(edge, edge) * (hasPositionEdge(b, a) ? SEAM_WEIGHT : BORDER_WEIGHT);
+					double offset = -dot(perpendicular, p);
+					_quadrics[_positions[a]].addPlane(perpendicular[0], perpendicular[1], perpendicular[2], offset,
+						weight);
+					_quadrics[_positions[b]].addPlane(perpendicular[0], perpendicular[1], perpendicular[2], offset,
+						weight);
+				}
+			}
+		}
+
+		bool canCollapse(unsigned int vertex, unsigned int target) const
+		{
+			if (_positions[vertex] == _positions[target])
+			{
+				return false;
+			}
+
+			switch (_kinds[vertex])
+			{
+			case VertexKind::MANIFOLD:
+				return true;
+			case VertexKind::BORDER:
+			case VertexKind::SEAM:
+				return target == _openNext[vertex] || target == _openPrevious[vertex];
+			default:
+				return false;
+			}
+		}
+
+		/**
+		 * Returns the copy of the target onto which the copy of a seam vertex on the other side of the seam
+		 * collapses, or NONE if the seam does not continue to the target on both sides
+		 */
+		unsigned int getSeamTarget(unsigned int vertex, unsigned int target) const
+		{
+			unsigned int wedge = _wedges[vertex];
+			unsigned int wedgeTarget = target == _openNext[vertex] ? _openPrevious[wedge] : _openNext[wedge];
+			return wedgeTarget != NONE && _positions[wedgeTarget] == _positions[target] ? wedgeTarget : NONE;
+		}
+
+		/**
+		 * Collects the allowed collapses of every edge within the error limit, cheapest first
+		 */
+		std::vector<Collapse> rankCollapses(double errorLimit) const
+		{
+			std::vector<Collapse> collapses;
+			for (size_t i = 0; i < _indices.size(); i++)
+			{
+				unsigned int a = _indices[i];
+				unsigned int b = _indices[i % 3 == 2 ? i - 2 : i + 1];
+
+				// Edges shared by two triangles are considered once
+				if (a > b && hasEdge(b, a))
+				{
+					continue;
+				}
+
+				bool forward = canCollapse(a, b);
+				bool backward = canCollapse(b, a);
+				double forwardError = forward ? _quadrics[_positions[a]].evaluate(getPoint(b)) : INFINITY;
+				double backwardError = backward ? _quadrics[_positions[b]].evaluate(getPoint(a)) : INFINITY;
+				if (!forward && !backward)
+				{
+					continue;
+				}
+
+				Collapse collapse = forwardError <= backwardError ? Collapse{ a, b, forwardError } :
+					Collapse{ b, a, backwardError };
+				if (collapse.error <= errorLimit)
+				{
+					collapses.push_back(collapse);
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b)
+			{
+				if (a.error != b.error)
+				{
+					return a.error < b.error;
+				}
+				return a.vertex != b.vertex ? a.vertex < b.vertex : a.target < b.target;
+			});
+			return collapses;
+		}
+
+		/**
+		 * Returns true if moving a vertex onto the position of the target would turn any of its triangles that
+		 * remain by more than about 75 degrees
+		 */
+		bool flipsTriangles(unsigned int vertex, unsigned int target) const
+		{
+			unsigned int targetPosition = _positions[target];
+			const double* moved = getPoint(target);
+			for (const unsigned int* it = _triangles.begin(vertex); it != _triangles.end(vertex); it++)
+			{
+				const unsigned int* triangle = &_indices[(size_t) *it * 3];
+				const double* corners[3];
+				bool collapses = false;
+				for (int c = 0; c < 3; c++)
+				{
+					collapses = collapses || _positions[triangle[c]] == targetPosition;
+					corners[c] = getPoint(triangle[c]);
+				}
+				if (collapses)
+				{
+					continue;
+				}
+
+				double before[3];
+				getNormal(corners[0], corners[1], corners[2], before);
+				for (int c = 0; c < 3; c++)
+				{
+					if (triangle[c] == vertex)
+					{
+						corners[c] = moved;
+					}
+				}
+
+				double after[3];
+				getNormal(corners[0], corners[1], corners[2], after);
+				if (dot(before, after) < 0.25 * std::sqrt(dot(before, before) * dot(after, after)))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * Performs collapses in order until enough triangles are removed. Each position takes part in at most one
+		 * collapse per pass. Returns false if no collapse could be performed.
+		 */
+		bool performCollapses(const std::vector<Collapse>& collapses, unsigned int goal, double& resultError)
+		{
+			std::vector<unsigned int> remap(_numVertices);
+			for (unsigned int v = 0; v < _numVertices; v++)
+			{
+				remap[v] = v;
+			}
+
+			std::vector<bool> locked(_numVertices, false);
+			unsigned int removed = 0;
+			unsigned int numCollapses = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				unsigned int vertex = collapse.vertex;
+				unsigned int target = collapse.target;
+				if (locked[_positions[vertex]] || locked[_positions[target]])
+				{
+					continue;
+				}
+
+				unsigned int wedge = vertex;
+				unsigned int wedgeTarget = target;
+				if (_kinds[vertex] == VertexKind::SEAM)
+				{
+					wedge = _wedges[vertex];
+					wedgeTarget = getSeamTarget(vertex, target);
+					if (wedgeTarget == NONE)
+					{
+						continue;
+					}
+				}
+
+				if (flipsTriangles(vertex, target) || (wedge != vertex && flipsTriangles(wedge, wedgeTarget)))
+				{
+					continue;
+				}
+
+				remap[vertex] = target;
+				remap[wedge] = wedgeTarget;
+				_quadrics[_positions[target]].add(_quadrics[_positions[vertex]]);
+				locked[_positions[vertex]] = true;
+				locked[_positions[target]] = true;
+				resultError = std::max(resultError, collapse.error);
+				numCollapses++;
+
+				// Interior collapses remove two triangles, while collapses along a border remove one
+				removed += _kinds[vertex] == VertexKind::BORDER ? 1 : 2;
+				if (removed >= goal)
+				{
+					break;
+				}
+			}
+
+			if (numCollapses == 0)
+			{
+				return false;
+			}
+
+			// Remap the triangles, dropping those that collapsed to a line or point
+			size_t numIndices = 0;
+			for (size_t i = 0; i < _indices.size(); i += 3)
+			{
+				unsigned int a = remap[_indices[i]];
+				unsigned int b = remap[_indices[i + 1]];
+				unsigned int c = remap[_indices[i + 2]];
+				if (_positions[a] != _positions[b] && _positions[b] != _positions[c] && _positions[a] != _positions[c])
+				{
+					_indices[numIndices++] = a;
+					_indices[numIndices++] = b;
+					_indices[numIndices++] = c;
+				}
+			}
+			_indices.resize(numIndices);
+			return true;
+		}
+	};
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(const unsigned int* indices, unsigned int numIndices,
+	const float* positions, unsigned int numVertices, unsigned int stride, unsigned int targetIndexCount,
+	float targetError, float* resultError)
+{
+	assertTrue(numIndices % 3 == 0, "Indices must form whole triangles");
+	assertTrue(targetError >= 0.f, "Target error cannot be negative");
+	for (unsigned int i = 0; i < numIndices; i++)
+	{
+		if (indices[i] >= numVertices)
+		{
+			throw OutOfBoundsException("Index references a vertex outside of the geometry");
+		}
+	}
+
+	Simplifier simplifier(indices, numIndices, positions, numVertices, stride);
+	double error = simplifier.run(targetIndexCount, (double) targetError * targetError);
+	if (resultError)
+	{
+		*resultError = (float) std::sqrt(error);
+	}
+
+	return std::move(simplifier.getIndices());
+}
+
+GeometryPtr MeshSimplifier::simplify(const GeometryPtr& geometry, unsigned int targetIndexCount, float targetError,
+	float* resultError)
+{
+	assertNotNull(geometry.get(), "Geometry cannot be null");
+	unsigned int numVertices = geometry->getNumVertices();
+	unsigned int stride;
+	const float* positions = geometry->getAttributeData(reinterpret_cast<const float*>(geometry->_vertices), 3, 0,
+		stride);
+	assertTrue(positions != nullptr, "Geometry must contain vertex positions to simplify");
+	assertTrue(geometry->getIndices() != nullptr && geometry->size() > 0,
+		"Geometry must contain vertex indices to simplify");
+
+	std::vector<unsigned int> indices = simplify(geometry->getIndices(), geometry->size(), positions, numVertices,
+		stride, targetIndexCount, targetError, resultError);
+
+	// Keep only the referenced vertices, in the order they are first used
+	std::vector<unsigned int> remap(numVertices, NONE);
+	unsigned int numUsed = 0;
+	for (unsigned int& index : indices)
+	{
+		if (remap[index] == NONE)
+		{
+			remap[index] = numUsed++;
+		}
+		index = remap[index];
+	}
+
+	GeometryAttributes layout = geometry->getAttributes();
+	unsigned int vertexStride = layout.getStride();
+	const float* interleaved = geometry->getInterleavedVertices();
+	std::vector<float> vertexData((size_t) numUsed * vertexStride);
+	for (unsigned int v = 0; v < numVertices; v++)
+	{
+		if (remap[v] == NONE)
+		{
+			continue;
+		}
+
+		float* destination = vertexData.data() + (size_t) remap[v] * vertexStride;
+		if (interleaved)
+		{
+			std::memcpy(destination, interleaved + (size_t) v * vertexStride, vertexStride * sizeof(float));
+		}
+		else
+		{
+			geometry->interleave(v, 1, destination);
+		}
+	}
+
+	GeometryPtr simplified = Geometry::create();
+	simplified->setIndices(indices.data(), (unsigned int) indices.size());
+	simplified->setInterleavedVertices(layout, std::move(vertexData), geometry->_vertices != nullptr);
+	simplified->setUsage(geometry->getUsage());
+	simplified->setBufferSharing(geometry->isBufferSharing());
+	return simplified;
+}
+
+std::vector<GeometryPtr> MeshSimplifier::generateLODs(const GeometryPtr& geometry, unsigned int numLevels,
+	float ratio, float maxError, std::vector<float>* errors)
+{
+	assertNotNull(geometry.get(), "Geometry cannot be null");
+	assertTrue(ratio > 0.f && ratio < 1.f, "Level of detail ratio must be between 0 and 1");
+
+	std::vector<GeometryPtr> levels = { geometry };
+	std::vector<float> levelErrors = { 0.f };
+	while (levels.size() < numLevels)
+	{
+		const GeometryPtr& previous = levels.back();
+		unsigned int target = (unsigned int) (previous->size() / 3 * ratio) * 3;
+		float error = 0.f;
+		GeometryPtr level = simplify(previous, target, std::max(maxError - levelErrors.back(), 0.f), &error);
+
+		// Stop once a level removes less than half of the requested triangles, as it would cost memory without
+		// saving much rendering time
+		if (level->size() == 0 || level->size() > previous->size() * (1.f + ratio) * 0.5f)
+		{
+			break;
+		}
+
+		GeometryOptimizer::optimize(level);
+		levels.push_back(level);
+		levelErrors.push_back(levelErrors.back() + error);
+	}
+
+	if (errors)
+	{
+		*errors = std::move(levelErrors);
+	}
+
+	return levels;
+}
+
+std::vector<std::vector<GeometryPtr>> MeshSimplifier::generateLODs(const std::vector<GeometryPtr>& geometries,
+	unsigned int numLevels, float ratio, float maxError, std::vector<std::vector<float>>* errors)
+{
+	std::vector<std::vector<GeometryPtr>> chains(geometries.size());
+	std::vector<std::vector<float>> chainErrors(geometries.size());
+	parallelFor((unsigned int) geometries.size(), 0, [&](unsigned int i)
+	{
+		chains[i] = generateLODs(geometries[i], numLevels, ratio, maxError, &chainErrors[i]);
+	});
+
+	if (errors)
+	{
+		*errors = std::move(chainErrors);
+	}
+
+	return chains;
+}
@@ -0,0 +1,301 @@
+#include <graphics/geometry/VertexPacker.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <common/Assertions.h>
+#include <common/Utils.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	/**
+	 * Converts a float in the range 0 to 1 to an unsigned, normalized byte
+	 */
+	unsigned char toUnsignedByte(float value)
+	{
+		return (unsigned char) std::lround(clamp(value, 0.f, 1.f) * 255.f);
+	}
+
+	/**
+	 * Converts a float in the range -1 to 1 to a signed, normalized 10-bit integer
+	 */
+	unsigned int toSigned10(float value)
+	{
+		int v = (int) std::lround(clamp(value, -1.f, 1.f) * 511.f);
+		return (unsigned int) v & 0x3ff;
+	}
+
+	/**
+	 * Converts a signed, normalized 10-bit integer to a float in the range -1 to 1
+	 */
+	float fromSigned10(unsigned int bits)
+	{
+		int v = (int)(bits & 0x3ff);
+		if (v & 0x200)
+		{
+			v -= 0x400;
+		}
+
+		return std::max(v / 511.f, -1.f);
+	}
+
+	/**
+	 * Writes a sequence of floats in the given storage format, returning the number of bytes written
+	 */
+	unsigned int write(AttributeFormat format, const float* values, unsigned int count, unsigned char* dst)
+	{
+		switch (format)
+		{
+			case AttributeFormat::FLOAT:
+			{
+				std::memcpy(dst, values, count * sizeof(float));
+				return count * sizeof(float);
+			}
+			case AttributeFormat::HALF_FLOAT:
+			{
+				unsigned short halves[4] = { 0, 0, 0, 0 };
+				for (unsigned int i = 0; i < count; i++)
+				{
+					halves[i] = VertexPacker::toHalf(values[i]);
+				}
+
+				// Pad to a multiple of 4 bytes
+				unsigned int size = ((count + 1) / 2) * 4;
+				std::memcpy(dst, halves, size);
+				return size;
+			}
+			case AttributeFormat::UNSIGNED_BYTE:
+			{
+				assertTrue(count == 4, "Unsigned byte storage is only supported for colors");
+				for (unsigned int i = 0; i < count; i++)
+				{
+					dst[i] = toUnsignedByte(values[i]);
+				}
+				return 4;
+			}
+			case AttributeFormat::INT_2_10_10_10_REV:
+			{
+				assertTrue(count == 3, "Packed 10-bit storage is only supported for normals");
+				unsigned int packed = VertexPacker::packNormal(values[0], values[1], values[2]);
+				std::memcpy(dst, &packed, sizeof(packed));
+				return 4;
+			}
+			default:
+			{
+				assertTrue(false, "Unknown attribute format");
+				return 0;
+			}
+		}
+	}
+
+	/**
+	 * Reads a sequence of floats in the given storage format, returning the number of bytes read
+	 */
+	unsigned int read(AttributeFormat format, const unsigned char* src, unsigned int count, float* values)
+	{
+		switch (format)
+		{
+			case AttributeFormat::FLOAT:
+			{
+				std::memcpy(values, src, count * sizeof(float));
+				return count * sizeof(float);
+			}
+			case AttributeFormat::HALF_FLOAT:
+			{
+				unsigned short halves[4];
+				unsigned int size = ((count + 1) / 2) * 4;
+				std::memcpy(halves, src, size);
+				for (unsigned int i = 0; i < count; i++)
+				{
+					values[i] = VertexPacker::fromHalf(halves[i]);
+				}
+				return size;
+			}
+			case AttributeFormat::UNSIGNED_BYTE:
+			{
+				assertTrue(count == 4, "Unsigned byte storage is only supported for colors");
+				for (unsigned int i = 0; i < count; i++)
+				{
+					values[i] = src[i] / 255.f;
+				}
+				return 4;
+			}
+			case AttributeFormat::INT_2_10_10_10_REV:
+			{
+				assertTrue(count == 3, "Packed 10-bit storage is only supported for normals");
+				unsigned int packed;
+				std::memcpy(&packed, src, sizeof(packed));
+				VertexPacker::unpackNormal(packed, values);
+				return 4;
+			}
+			default:
+			{
+				assertTrue(false, "Unknown attribute format");
+				return 0;
+			}
+		}
+	}
+}
+
+void VertexPacker::pack(const GeometryAttributes& attributes, const float* vertexData, unsigned int numVertices,
+	void* dst)
+{
+	unsigned int stride = attributes.getStride();
+	if (attributes.isFloatOnly())
+	{
+		std::memcpy(dst, vertexData, (size_t) numVertices * stride * sizeof(float));
+		return;
+	}
+
+	unsigned char* out = static_cast<unsigned char*>(dst);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		const float* v = vertexData + (size_t) i * stride;
+		out += write(AttributeFormat::FLOAT, v, 3, out);
+		v += 3;
+
+		if (attributes.normals)
+		{
+			out += write(attributes.normalFormat, v, 3, out);
+			v += 3;
+		}
+
+		if (attributes.colors)
+		{
+			out += write(attributes.colorFormat, v, 4, out);
+			v += 4;
+		}
+
+		if (attributes.uvs)
+		{
+			out += write(attributes.uvFormat, v, 2, out);
+		}
+	}
+}
+
+void VertexPacker::unpack(const GeometryAttributes& attributes, const void* src, unsigned int numVertices,
+	float* vertexData)
+{
+	unsigned int stride = attributes.getStride();
+	if (attributes.isFloatOnly())
+	{
+		std::memcpy(vertexData, src, (size_t) numVertices * stride * sizeof(float));
+		return;
+	}
+
+	const unsigned char* in = static_cast<const unsigned char*>(src);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		float* v = vertexData + (size_t) i * stride;
+		in += read(AttributeFormat::FLOAT, in, 3, v);
+		v += 3;
+
+		if (attributes.normals)
+		{
+			in += read(attributes.normalFormat, in, 3, v);
+			v += 3;
+		}
+
+		if (attributes.colors)
+		{
+			in += read(attributes.colorFormat, in, 4, v);
+			v += 4;
+		}
+
+		if (attributes.uvs)
+		{
+			in += read(attributes.uvFormat, in, 2, v);
+		}
+	}
+}
+
+unsigned short VertexPacker::toHalf(float value)
+{
+	unsigned int bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	unsigned int sign = (bits >> 16) & 0x8000;
+	unsigned int rawExponent = (bits >> 23) & 0xff;
+	unsigned int mantissa = bits & 0x7fffff;
+
+	// Infinity and NaN
+	if (rawExponent == 0xff)
+	{
+		return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+	}
+
+	int exponent = (int) rawExponent - 127 + 15;
+	if (exponent >= 0x1f)
+	{
+		// Too large, so round to infinity
+		return (unsigned short)(sign | 0x7c00);
+	}
+
+	if (exponent <= 0)
+	{
+		// Too small for a normal half, so produce a subnormal (or zero)
+		if (exponent < -10)
+		{
+			return (unsigned short) sign;
+		}
+
+		mantissa |= 0x800000;
+		unsigned int shift = 14 - exponent;
+		unsigned int half = mantissa >> shift;
+		unsigned int remainder = mantissa & ((1u << shift) - 1);
+		unsigned int halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1)))
+		{
+			half++;
+		}
+		return (unsigned short)(sign | half);
+	}
+
+	// Round to nearest, ties to even. A carry out of the mantissa correctly increments the exponent.
+	unsigned int half = sign | ((unsigned int) exponent << 10) | (mantissa >> 13);
+	unsigned int remainder = mantissa & 0x1fff;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		half++;
+	}
+	return (unsigned short) half;
+}
+
+float VertexPacker::fromHalf(unsigned short bits)
+{
+	unsigned int sign = (unsigned int)(bits & 0x8000) << 16;
+	unsigned int exponent = (bits >> 10) & 0x1f;
+	unsigned int mantissa = bits & 0x3ff;
+
+	unsigned int result;
+	if (exponent == 0)
+	{
+		// Zero or subnormal
+		float value = mantissa / 16777216.f;
+		return sign ? -value : value;
+	}
+	else if (exponent == 0x1f)
+	{
+		result = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else
+	{
+		result = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float value;
+	std::memcpy(&value, &result, sizeof(value));
+	return value;
+}
+
+unsigned int VertexPacker::packNormal(float x, float y, float z)
+{
+	return toSigned10(x) | (toSigned10(y) << 10) | (toSigned10(z) << 20);
+}
+
+void VertexPacker::unpackNormal(unsigned int packed, float* normal)
+{
+	normal[0] = fromSigned10(packed);
+	normal[1] = fromSigned10(packed >> 10);
+	normal[2] = fromSigned10(packed >> 20);
+}
@@ -10,4 +10,10 @@ BasicMaterial::BasicMaterial()
 	: Material(MaterialType::BASIC)
 {
 
+}
+
+bool BasicMaterial::canBatchWith(const Material& other) const
+{
+	return Material::canBatchWith(other) &&
+		useVertexColors == static_cast<const BasicMaterial&>(other).useVertexColors;
 }
\ No newline at end of file
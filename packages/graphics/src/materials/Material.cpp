@@ -4,4 +4,11 @@
 Material::Material(MaterialType type) : materialType(type)
 {
 
+}
+
+bool Material::canBatchWith(const Material& other) const
+{
+	return materialType == other.materialType && color == other.color && reflectivity == other.reflectivity &&
+		shine == other.shine && texture == other.texture && textureArray == other.textureArray &&
+		textureLayer == other.textureLayer;
 }
\ No newline at end of file
@@ -0,0 +1,1237 @@
+#include <graphics/objects/GltfImporter.h>
+#include <graphics/objects/ObjImporter.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryOptimizer.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <common/MappedFile.h>
+#include <common/Parallel.h>
+#include <common/exceptions/InstantiationException.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const uint32_t GLB_MAGIC = 0x46546C67;
+	const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+	const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+	const size_t GLB_HEADER_SIZE = 12;
+	const size_t GLB_CHUNK_HEADER_SIZE = 8;
+
+	const int COMPONENT_BYTE = 5120;
+	const int COMPONENT_UNSIGNED_BYTE = 5121;
+	const int COMPONENT_SHORT = 5122;
+	const int COMPONENT_UNSIGNED_SHORT = 5123;
+	const int COMPONENT_UNSIGNED_INT = 5125;
+	const int COMPONENT_FLOAT = 5126;
+
+	const int MODE_TRIANGLES = 4;
+
+	/**
+	 * Maximum nesting depth of JSON values
+	 */
+	const int MAX_JSON_DEPTH = 256;
+
+	/**
+	 * A parsed JSON value
+	 */
+	struct JsonValue {
+		enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+		Type type = Type::NUL;
+		bool boolean = false;
+		double number = 0.0;
+		std::string string;
+		std::vector<JsonValue> elements;
+		std::vector<std::pair<std::string, JsonValue>> members;
+
+		/**
+		 * @return The member with the given key, or null if this is not an object or has no such member
+		 */
+		const JsonValue* get(const char* key) const
+		{
+			for (const auto& member : members)
+			{
+				if (member.first == key)
+				{
+					return &member.second;
+				}
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @return The numeric member with the given key, or the default value if it does not exist
+		 */
+		double getNumber(const char* key, double def) const
+		{
+			const JsonValue* value = get(key);
+			return value && value->type == Type::NUMBER ? value->number : def;
+		}
+
+		/**
+		 * @return The value as an index into an array, or SIZE_MAX if it is not a non-negative number
+		 */
+		size_t toIndex() const
+		{
+			return type == Type::NUMBER && number >= 0.0 && number < 1e15 ? (size_t) number : SIZE_MAX;
+		}
+
+		/**
+		 * @return The index member with the given key, or SIZE_MAX if it does not exist
+		 */
+		size_t getIndex(const char* key) const
+		{
+			const JsonValue* value = get(key);
+			return value ? value->toIndex() : SIZE_MAX;
+		}
+
+		/**
+		 * @return The elements of the array member with the given key, or null if it does not exist
+		 */
+		const std::vector<JsonValue>* getArray(const char* key) const
+		{
+			const JsonValue* value = get(key);
+			return value && value->type == Type::ARRAY ? &value->elements : nullptr;
+		}
+
+		/**
+		 * @return The string member with the given key, or an empty string if it does not exist
+		 */
+		std::string getString(const char* key) const
+		{
+			const JsonValue* value = get(key);
+			return value && value->type == Type::STRING ? value->string : std::string();
+		}
+	};
+
+	/**
+	 * Recursive descent parser for the JSON part of a glTF file
+	 */
+	class JsonParser
+	{
+	public:
+
+		JsonParser(const char* str, const char* end) : _str(str), _end(end)
+		{
+
+		}
+
+		JsonValue parse()
+		{
+			JsonValue value;
+			parseValue(value, 0);
+			skipSpaces();
+			if (_str != _end)
+			{
+				fail();
+			}
+			return value;
+		}
+
+	private:
+
+		const char* _str;
+		const char* _end;
+
+		[[noreturn]] void fail()
+		{
+			throw InstantiationException("Malformed glTF JSON data");
+		}
+
+		void skipSpaces()
+		{
+			while (_str < _end && (*_str == ' ' || *_str == '\t' || *_str == '\n' || *_str == '\r'))
+			{
+				_str++;
+			}
+		}
+
+		void expect(const char* literal)
+		{
+			size_t length = std::strlen(literal);
+			if ((size_t) (_end - _str) < length || std::memcmp(_str, literal, length) != 0)
+			{
+				fail();
+			}
+			_str += length;
+		}
+
+		void parseValue(JsonValue& value, int depth)
+		{
+			skipSpaces();
+			if (_str == _end || depth > MAX_JSON_DEPTH)
+			{
+				fail();
+			}
+
+			switch (*_str)
+			{
+				case '{':
+				{
+					value.type = JsonValue::Type::OBJECT;
+					_str++;
+					skipSpaces();
+					if (_str < _end && *_str == '}')
+					{
+						_str++;
+						return;
+					}
+
+					while (true)
+					{
+						skipSpaces();
+						std::pair<std::string, JsonValue> member;
+						parseString(member.first);
+						skipSpaces();
+						expect(":");
+						parseValue(member.second, depth + 1);
+						value.members.push_back(std::move(member));
+
+						skipSpaces();
+						if (_str < _end && *_str == ',')
+						{
+							_str++;
+							continue;
+						}
+						expect("}");
+						return;
+					}
+				}
+				case '[':
+				{
+					value.type = JsonValue::Type::ARRAY;
+					_str++;
+					skipSpaces();
+					if (_str < _end && *_str == ']')
+					{
+						_str++;
+						return;
+					}
+
+					while (true)
+					{
+						value.elements.emplace_back();
+						parseValue(value.elements.back(), depth + 1);
+
+						skipSpaces();
+						if (_str < _end && *_str == ',')
+						{
+							_str++;
+							continue;
+						}
+						expect("]");
+						return;
+					}
+				}
+				case '"':
+				{
+					value.type = JsonValue::Type::STRING;
+					parseString(value.string);
+					return;
+				}
+				case 't':
+				{
+					expect("true");
+					value.type = JsonValue::Type::BOOLEAN;
+					value.boolean = true;
+					return;
+				}
+				case 'f':
+				{
+					expect("false");
+					value.type = JsonValue::Type::BOOLEAN;
+					return;
+				}
+				case 'n':
+				{
+					expect("null");
+					return;
+				}
+				default:
+				{
+					value.type = JsonValue::Type::NUMBER;
+					parseNumber(value.number);
+				}
+			}
+		}
+
+		void parseNumber(double& number)
+		{
+			// Integers such as byte offsets are parsed exactly, other numbers only need float precision
+			const char* start = _str;
+			bool negative = _str < _end && *_str == '-';
+			const char* digits = negative ? _str + 1 : _str;
+			const char* str = digits;
+			double integer = 0.0;
+			while (str < _end && *str >= '0' && *str <= '9')
+			{
+				integer = integer * 10.0 + (*str - '0');
+				str++;
+			}
+
+			if (str == digits)
+			{
+				fail();
+			}
+
+			if (str == _end || (*str != '.' && *str != 'e' && *str != 'E'))
+			{
+				number = negative ? -integer : integer;
+				_str = str;
+				return;
+			}
+
+			float value;
+			_str = ObjImporter::parseFloat(start, _end, value);
+			if (!_str)
+			{
+				fail();
+			}
+			number = value;
+		}
+
+		unsigned int parseHex()
+		{
+			unsigned int code = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				if (_str == _end)
+				{
+					fail();
+				}
+
+				char c = *_str++;
+				code <<= 4;
+				if (c >= '0' && c <= '9')
+				{
+					code |= c - '0';
+				}
+				else if (c >= 'a' && c <= 'f')
+				{
+					code |= c - 'a' + 10;
+				}
+				else if (c >= 'A' && c <= 'F')
+				{
+					code |= c - 'A' + 10;
+				}
+				else
+				{
+					fail();
+				}
+			}
+			return code;
+		}
+
+		void appendUtf8(std::string& str, unsigned int code)
+		{
+			if (code < 0x80)
+			{
+				str += (char) code;
+			}
+			else if (code < 0x800)
+			{
+				str += (char) (0xC0 | (code >> 6));
+				str += (char) (0x80 | (code & 0x3F));
+			}
+			else if (code < 0x10000)
+			{
+				str += (char) (0xE0 | (code >> 12));
+				str += (char) (0x80 | ((code >> 6) & 0x3F));
+				str += (char) (0x80 | (code & 0x3F));
+			}
+			else
+			{
+				str += (char) (0xF0 | (code >> 18));
+				str += (char) (0x80 | ((code >> 12) & 0x3F));
+				str += (char) (0x80 | ((code >> 6) & 0x3F));
+				str += (char) (0x80 | (code & 0x3F));
+			}
+		}
+
+		void parseString(std::string& str)
+		{
+			expect("\"");
+			while (true)
+			{
+				const char* start = _str;
+				while (_str < _end && *_str != '"' && *_str != '\\')
+				{
+					_str++;
+				}
+				str.append(start, _str);
+
+				if (_str == _end)
+				{
+					fail();
+				}
+				if (*_str++ == '"')
+				{
+					return;
+				}
+				if (_str == _end)
+				{
+					fail();
+				}
+
+				char escaped = *_str++;
+				switch (escaped)
+				{
+					case 'b':
+					{
+						str += '\b';
+						break;
+					}
+					case 'f':
+					{
+						str += '\f';
+						break;
+					}
+					case 'n':
+					{
+						str += '\n';
+						break;
+					}
+					case 'r':
+					{
+						str += '\r';
+						break;
+					}
+					case 't':
+					{
+						str += '\t';
+						break;
+					}
+					case 'u':
+					{
+						unsigned int code = parseHex();
+						if (code >= 0xD800 && code < 0xDC00 && _end - _str >= 6 && _str[0] == '\\' && _str[1] == 'u')
+						{
+							_str += 2;
+							unsigned int low = parseHex();
+							code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+						}
+						appendUtf8(str, code);
+						break;
+					}
+					default:
+					{
+						str += escaped;
+					}
+				}
+			}
+		}
+	};
+
+	/**
+	 * Reads a little endian 32-bit unsigned integer
+	 */
+	uint32_t readUint32(const unsigned char* data)
+	{
+		return (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16) | ((uint32_t) data[3] << 24);
+	}
+
+	/**
+	 * Decodes base64 encoded data
+	 */
+	std::vector<unsigned char> decodeBase64(const char* str, const char* end)
+	{
+		std::vector<unsigned char> decoded;
+		decoded.reserve((end - str) / 4 * 3);
+
+		unsigned int bits = 0;
+		int numBits = 0;
+		for (; str < end && *str != '='; str++)
+		{
+			char c = *str;
+			unsigned int value;
+			if (c >= 'A' && c <= 'Z')
+			{
+				value = c - 'A';
+			}
+			else if (c >= 'a' && c <= 'z')
+			{
+				value = c - 'a' + 26;
+			}
+			else if (c >= '0' && c <= '9')
+			{
+				value = c - '0' + 52;
+			}
+			else if (c == '+' || c == '-')
+			{
+				value = 62;
+			}
+			else if (c == '/' || c == '_')
+			{
+				value = 63;
+			}
+			else
+			{
+				throw InstantiationException("Malformed base64 data in glTF buffer");
+			}
+
+			bits = (bits << 6) | value;
+			numBits += 6;
+			if (numBits >= 8)
+			{
+				numBits -= 8;
+				decoded.push_back((unsigned char) ((bits >> numBits) & 0xFF));
+			}
+		}
+
+		return decoded;
+	}
+
+	/**
+	 * Decodes percent-encoded characters of a URI
+	 */
+	std::string decodeUri(const std::string& uri)
+	{
+		std::string decoded;
+		for (size_t i = 0; i < uri.size(); i++)
+		{
+			if (uri[i] == '%' && i + 2 < uri.size())
+			{
+				decoded += (char) std::stoi(uri.substr(i + 1, 2), nullptr, 16);
+				i += 2;
+			}
+			else
+			{
+				decoded += uri[i];
+			}
+		}
+		return decoded;
+	}
+
+	/**
+	 * A view of a glTF buffer
+	 */
+	struct BufferView {
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+		size_t stride = 0;
+	};
+
+	/**
+	 * A typed view of the elements of a buffer view
+	 */
+	struct Accessor {
+
+		/**
+		 * Start of the first element. Is null for accessors without a buffer view, whose elements are all zero.
+		 */
+		const unsigned char* data = nullptr;
+		size_t stride = 0;
+		unsigned int count = 0;
+		unsigned int numComponents = 0;
+		int componentType = COMPONENT_FLOAT;
+		bool normalized = false;
+	};
+
+	/**
+	 * A triangle primitive of a glTF mesh
+	 */
+	struct Primitive {
+		GeometryPtr geometry;
+		int material = -1;
+	};
+
+	/**
+	 * Contents of a glTF file, and the storage of its buffers
+	 */
+	struct GltfData {
+		JsonValue root;
+		std::vector<std::unique_ptr<MappedFile>> files;
+		std::vector<std::vector<unsigned char>> decodedBuffers;
+		std::vector<std::pair<const unsigned char*, size_t>> buffers;
+		std::vector<BufferView> bufferViews;
+		std::vector<Accessor> accessors;
+	};
+
+	unsigned int getComponentSize(int componentType)
+	{
+		switch (componentType)
+		{
+			case COMPONENT_BYTE:
+			case COMPONENT_UNSIGNED_BYTE:
+				return 1;
+			case COMPONENT_SHORT:
+			case COMPONENT_UNSIGNED_SHORT:
+				return 2;
+			case COMPONENT_UNSIGNED_INT:
+			case COMPONENT_FLOAT:
+				return 4;
+			default:
+				throw InstantiationException("Unsupported glTF accessor component type");
+		}
+	}
+
+	unsigned int getNumComponents(const std::string& type)
+	{
+		static const std::map<std::string, unsigned int> NUM_COMPONENTS = {
+			{ "SCALAR", 1 }, { "VEC2", 2 }, { "VEC3", 3 }, { "VEC4", 4 }, { "MAT2", 4 }, { "MAT3", 9 }, { "MAT4", 16 }
+		};
+
+		auto it = NUM_COMPONENTS.find(type);
+		if (it == NUM_COMPONENTS.end())
+		{
+			throw InstantiationException("Unsupported glTF accessor type " + type);
+		}
+		return it->second;
+	}
+
+	/**
+	 * Reads a component of an accessor as a float, mapping normalized integers to [0, 1] or [-1, 1]
+	 */
+	float readComponent(const unsigned char* data, int componentType, bool normalized)
+	{
+		switch (componentType)
+		{
+			case COMPONENT_BYTE:
+			{
+				int8_t value;
+				std::memcpy(&value, data, 1);
+				return normalized ? std::max(value / 127.f, -1.f) : value;
+			}
+			case COMPONENT_UNSIGNED_BYTE:
+			{
+				return normalized ? data[0] / 255.f : data[0];
+			}
+			case COMPONENT_SHORT:
+			{
+				int16_t value;
+				std::memcpy(&value, data, 2);
+				return normalized ? std::max(value / 32767.f, -1.f) : value;
+			}
+			case COMPONENT_UNSIGNED_SHORT:
+			{
+				uint16_t value;
+				std::memcpy(&value, data, 2);
+				return normalized ? value / 65535.f : value;
+			}
+			case COMPONENT_UNSIGNED_INT:
+			{
+				uint32_t value;
+				std::memcpy(&value, data, 4);
+				return (float) value;
+			}
+			default:
+			{
+				float value;
+				std::memcpy(&value, data, 4);
+				return value;
+			}
+		}
+	}
+
+	/**
+	 * Reads the buffers, buffer views, and accessors of a glTF file
+	 */
+	void readBuffers(GltfData& gltf, const std::filesystem::path& directory, const unsigned char* binaryChunk,
+		size_t binaryChunkSize)
+	{
+		if (const std::vector<JsonValue>* buffers = gltf.root.getArray("buffers"))
+		{
+			for (size_t i = 0; i < buffers->size(); i++)
+			{
+				const JsonValue& buffer = (*buffers)[i];
+				size_t byteLength = (size_t) buffer.getNumber("byteLength", 0);
+				std::string uri = buffer.getString("uri");
+
+				const unsigned char* data = nullptr;
+				size_t size = 0;
+				if (uri.empty())
+				{
+					// The first buffer of a binary file may refer to its binary chunk
+					if (i != 0 || binaryChunk == nullptr)
+					{
+						throw InstantiationException("glTF buffer has no data");
+					}
+					data = binaryChunk;
+					size = binaryChunkSize;
+				}
+				else if (uri.compare(0, 5, "data:") == 0)
+				{
+					size_t separator = uri.find(";base64,");
+					if (separator == std::string::npos)
+					{
+						throw InstantiationException("glTF buffer data URIs must be base64 encoded");
+					}
+
+					const char* encoded = uri.c_str() + separator + 8;
+					gltf.decodedBuffers.push_back(decodeBase64(encoded, uri.c_str() + uri.size()));
+					data = gltf.decodedBuffers.back().data();
+					size = gltf.decodedBuffers.back().size();
+				}
+				else
+				{
+					std::filesystem::path path = directory / std::filesystem::u8path(decodeUri(uri));
+					gltf.files.push_back(std::unique_ptr<MappedFile>(new MappedFile(path.string())));
+					data = reinterpret_cast<const unsigned char*>(gltf.files.back()->data());
+					size = gltf.files.back()->size();
+				}
+
+				if (size < byteLength)
+				{
+					throw InstantiationException("glTF buffer is shorter than its byte length");
+				}
+				gltf.buffers.push_back({ data, byteLength });
+			}
+		}
+
+		if (const std::vector<JsonValue>* bufferViews = gltf.root.getArray("bufferViews"))
+		{
+			for (const JsonValue& bufferView : *bufferViews)
+			{
+				size_t buffer = bufferView.getIndex("buffer");
+				size_t offset = (size_t) bufferView.getNumber("byteOffset", 0);
+				size_t length = (size_t) bufferView.getNumber("byteLength", 0);
+				if (buffer >= gltf.buffers.size() || offset + length > gltf.buffers[buffer].second)
+				{
+					throw InstantiationException("glTF buffer view lies outside of its buffer");
+				}
+
+				BufferView view;
+				view.data = gltf.buffers[buffer].first + offset;
+				view.size = length;
+				view.stride = (size_t) bufferView.getNumber("byteStride", 0);
+				gltf.bufferViews.push_back(view);
+			}
+		}
+
+		if (const std::vector<JsonValue>* accessors = gltf.root.getArray("accessors"))
+		{
+			for (const JsonValue& accessor : *accessors)
+			{
+				if (accessor.get("sparse"))
+				{
+					throw InstantiationException("Sparse glTF accessors are not supported");
+				}
+
+				Accessor result;
+				result.count = (unsigned int) accessor.getNumber("count", 0);
+				result.componentType = (int) accessor.getNumber("componentType", COMPONENT_FLOAT);
+				result.numComponents = getNumComponents(accessor.getString("type"));
+				const JsonValue* normalized = accessor.get("normalized");
+				result.normalized = normalized && normalized->boolean;
+
+				size_t elementSize = (size_t) getComponentSize(result.componentType) * result.numComponents;
+				size_t bufferView = accessor.getIndex("bufferView");
+				if (accessor.get("bufferView"))
+				{
+					if (bufferView >= gltf.bufferViews.size())
+					{
+						throw InstantiationException("glTF accessor references a missing buffer view");
+					}
+
+					const BufferView& view = gltf.bufferViews[bufferView];
+					size_t offset = (size_t) accessor.getNumber("byteOffset", 0);
+					result.stride = view.stride > 0 ? view.stride : elementSize;
+					if (result.count > 0 && offset + result.stride * (result.count - 1) + elementSize > view.size)
+					{
+						throw InstantiationException("glTF accessor lies outside of its buffer view");
+					}
+					result.data = view.data + offset;
+				}
+				gltf.accessors.push_back(result);
+			}
+		}
+	}
+
+	/**
+	 * @return The accessor referenced by an attribute or index member, or null if the member does not exist
+	 */
+	const Accessor* getAccessor(const GltfData& gltf, const JsonValue& object, const char* key)
+	{
+		const JsonValue* index = object.get(key);
+		if (!index)
+		{
+			return nullptr;
+		}
+
+		if (index->toIndex() >= gltf.accessors.size())
+		{
+			throw InstantiationException("glTF primitive references a missing accessor");
+		}
+		return &gltf.accessors[index->toIndex()];
+	}
+
+	/**
+	 * Reads the elements of an accessor into interleaved vertex data
+	 * @param numComponents The number of components to write per element. Missing components are left untouched.
+	 */
+	void readAttribute(const Accessor& accessor, unsigned int numComponents, float* dst, unsigned int dstStride)
+	{
+		if (!accessor.data)
+		{
+			return;
+		}
+
+		unsigned int numRead = std::min(numComponents, accessor.numComponents);
+		const unsigned char* src = accessor.data;
+		if (accessor.componentType == COMPONENT_FLOAT)
+		{
+			for (unsigned int i = 0; i < accessor.count; i++, src += accessor.stride, dst += dstStride)
+			{
+				std::memcpy(dst, src, numRead * sizeof(float));
+			}
+			return;
+		}
+
+		unsigned int componentSize = getComponentSize(accessor.componentType);
+		for (unsigned int i = 0; i < accessor.count; i++, src += accessor.stride, dst += dstStride)
+		{
+			for (unsigned int c = 0; c < numRead; c++)
+			{
+				dst[c] = readComponent(src + c * componentSize, accessor.componentType, accessor.normalized);
+			}
+		}
+	}
+
+	/**
+	 * Builds the geometry of a triangle primitive
+	 */
+	GeometryPtr buildGeometry(const GltfData& gltf, const JsonValue& primitive, const MeshLoaderOptions& options)
+	{
+		const JsonValue* attributes = primitive.get("attributes");
+		const Accessor* positions = attributes ? getAccessor(gltf, *attributes, "POSITION") : nullptr;
+		if (!positions)
+		{
+			throw InstantiationException("glTF primitive has no vertex positions");
+		}
+
+		const Accessor* normals = getAccessor(gltf, *attributes, "NORMAL");
+		const Accessor* colors = getAccessor(gltf, *attributes, "COLOR_0");
+		const Accessor* uvs = getAccessor(gltf, *attributes, "TEXCOORD_0");
+		unsigned int numVertices = positions->count;
+		for (const Accessor* accessor : { normals, colors, uvs })
+		{
+			if (accessor && accessor->count != numVertices)
+			{
+				throw InstantiationException("glTF primitive attributes differ in length");
+			}
+		}
+
+		GeometryAttributes layout;
+		layout.normals = normals != nullptr;
+		layout.colors = colors != nullptr;
+		layout.uvs = uvs != nullptr;
+		if (options.compactFormats)
+		{
+			layout.normalFormat = AttributeFormat::INT_2_10_10_10_REV;
+			layout.colorFormat = AttributeFormat::UNSIGNED_BYTE;
+			layout.uvFormat = AttributeFormat::HALF_FLOAT;
+		}
+
+		unsigned int stride = layout.getStride();
+		std::vector<float> vertexData((size_t) numVertices * stride, 0.f);
+		unsigned int offset = 0;
+
+		readAttribute(*positions, 3, vertexData.data(), stride);
+		offset += 3;
+		if (normals)
+		{
+			readAttribute(*normals, 3, vertexData.data() + offset, stride);
+			offset += 3;
+		}
+		if (colors)
+		{
+			// Colors without an alpha channel are opaque
+			for (unsigned int i = 0; i < numVertices; i++)
+			{
+				vertexData[(size_t) i * stride + offset + 3] = 1.f;
+			}
+			readAttribute(*colors, 4, vertexData.data() + offset, stride);
+			offset += 4;
+		}
+		if (uvs)
+		{
+			readAttribute(*uvs, 2, vertexData.data() + offset, stride);
+		}
+
+		std::vector<unsigned int> indices;
+		if (const Accessor* indexAccessor = getAccessor(gltf, primitive, "indices"))
+		{
+			indices.resize(indexAccessor->count);
+			const unsigned char* src = indexAccessor->data;
+			unsigned int componentSize = getComponentSize(indexAccessor->componentType);
+			for (unsigned int i = 0; i < indexAccessor->count && src; i++, src += indexAccessor->stride)
+			{
+				uint32_t index = 0;
+				std::memcpy(&index, src, componentSize);
+				if (index >= numVertices)
+				{
+					throw InstantiationException("glTF primitive index references a missing vertex");
+				}
+				indices[i] = index;
+			}
+		}
+		else
+		{
+			indices.resize(numVertices);
+			std::iota(indices.begin(), indices.end(), 0);
+		}
+
+		if (indices.size() % 3 != 0)
+		{
+			throw InstantiationException("glTF triangle primitive does not hold whole triangles");
+		}
+
+		GeometryPtr geometry = Geometry::create();
+		geometry->setIndices(indices.data(), (unsigned int) indices.size());
+		geometry->setInterleavedVertices(layout, std::move(vertexData));
+
+		if (options.optimize && !indices.empty())
+		{
+			GeometryOptimizer::optimize(geometry);
+		}
+
+		return geometry;
+	}
+
+	/**
+	 * Applies the transformation of a node to an entity
+	 */
+	void applyTransform(const JsonValue& node, const EntityPtr& entity)
+	{
+		const std::vector<JsonValue>* matrix = node.getArray("matrix");
+		if (matrix && matrix->size() == 16)
+		{
+			// Column-major matrix, decomposed into translation, rotation, and scaling
+			float m[16];
+			for (int i = 0; i < 16; i++)
+			{
+				m[i] = (float) (*matrix)[i].number;
+			}
+
+			float scale[3];
+			for (int column = 0; column < 3; column++)
+			{
+				const float* axis = m + column * 4;
+				scale[column] = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			}
+
+			float determinant = m[0] * (m[5] * m[10] - m[9] * m[6]) - m[4] * (m[1] * m[10] - m[9] * m[2]) +
+				m[8] * (m[1] * m[6] - m[5] * m[2]);
+			if (determinant < 0.f)
+			{
+				scale[0] = -scale[0];
+			}
+
+			auto rotation = [&m, &scale](int row, int column)
+			{
+				return scale[column] != 0.f ? m[column * 4 + row] / scale[column] : 0.f;
+			};
+
+			entity->setPosition(m[12], m[13], m[14]);
+			entity->setRotation(rotation(0, 0), rotation(0, 1), rotation(0, 2), rotation(1, 0), rotation(1, 1),
+				rotation(1, 2), rotation(2, 0), rotation(2, 1), rotation(2, 2));
+			entity->setScaling(scale[0], scale[1], scale[2]);
+			return;
+		}
+
+		const std::vector<JsonValue>* translation = node.getArray("translation");
+		if (translation && translation->size() == 3)
+		{
+			entity->setPosition((float) (*translation)[0].number, (float) (*translation)[1].number,
+				(float) (*translation)[2].number);
+		}
+
+		const std::vector<JsonValue>* rotation = node.getArray("rotation");
+		if (rotation && rotation->size() == 4)
+		{
+			float x = (float) (*rotation)[0].number;
+			float y = (float) (*rotation)[1].number;
+			float z = (float) (*rotation)[2].number;
+			float w = (float) (*rotation)[3].number;
+			entity->setRotation(
+				1.f - 2.f * (y * y + z * z), 2.f * (x * y - z * w), 2.f * (x * z + y * w),
+				2.f * (x * y + z * w), 1.f - 2.f * (x * x + z * z), 2.f * (y * z - x * w),
+				2.f * (x * z - y * w), 2.f * (y * z + x * w), 1.f - 2.f * (x * x + y * y));
+		}
+
+		const std::vector<JsonValue>* scale = node.getArray("scale");
+		if (scale && scale->size() == 3)
+		{
+			entity->setScaling((float) (*scale)[0].number, (float) (*scale)[1].number, (float) (*scale)[2].number);
+		}
+	}
+
+	/**
+	 * Builds the entities of the node hierarchy
+	 */
+	class SceneBuilder
+	{
+	public:
+
+		SceneBuilder(const GltfData& gltf, const std::vector<std::vector<Primitive>>& meshes) :
+			_gltf(gltf), _meshes(meshes)
+		{
+			_nodes = gltf.root.getArray("nodes");
+			_materials = gltf.root.getArray("materials");
+		}
+
+		EntityPtr buildNode(size_t index, size_t depth)
+		{
+			if (!_nodes || index >= _nodes->size())
+			{
+				throw InstantiationException("glTF scene references a missing node");
+			}
+
+			// Node hierarchies are trees, so no path can be longer than the number of nodes
+			if (depth > _nodes->size())
+			{
+				throw InstantiationException("glTF node hierarchy contains a cycle");
+			}
+
+			const JsonValue& node = (*_nodes)[index];
+			EntityPtr entity;
+			if (const JsonValue* mesh = node.get("mesh"))
+			{
+				if (mesh->toIndex() >= _meshes.size())
+				{
+					throw InstantiationException("glTF node references a missing mesh");
+				}
+
+				// Meshes with a single primitive map to a single entity
+				const std::vector<Primitive>& primitives = _meshes[mesh->toIndex()];
+				if (primitives.size() == 1)
+				{
+					entity = createMesh(primitives[0]);
+				}
+				else
+				{
+					entity = EntityGroup::create();
+					for (const Primitive& primitive : primitives)
+					{
+						entity->add(createMesh(primitive));
+					}
+				}
+			}
+			else
+			{
+				entity = EntityGroup::create();
+			}
+
+			applyTransform(node, entity);
+
+			if (const std::vector<JsonValue>* children = node.getArray("children"))
+			{
+				for (const JsonValue& child : *children)
+				{
+					entity->add(buildNode(child.toIndex(), depth + 1));
+				}
+			}
+
+			return entity;
+		}
+
+	private:
+
+		const GltfData& _gltf;
+		const std::vector<std::vector<Primitive>>& _meshes;
+		const std::vector<JsonValue>* _nodes;
+		const std::vector<JsonValue>* _materials;
+
+		/**
+		 * Materials created for each pair of material index and vertex color usage
+		 */
+		std::map<std::pair<int, bool>, MaterialPtr> _createdMaterials;
+
+		MeshPtr createMesh(const Primitive& primitive)
+		{
+			bool useVertexColors = primitive.geometry->getAttributes().colors;
+			MaterialPtr& material = _createdMaterials[{ primitive.material, useVertexColors }];
+			if (!material)
+			{
+				BasicMaterialPtr basicMaterial = BasicMaterial::create();
+				basicMaterial->useVertexColors = useVertexColors;
+				if (_materials && primitive.material >= 0 && (size_t) primitive.material < _materials->size())
+				{
+					const JsonValue* pbr = (*_materials)[primitive.material].get("pbrMetallicRoughness");
+					const std::vector<JsonValue>* factor = pbr ? pbr->getArray("baseColorFactor") : nullptr;
+					if (factor && factor->size() == 4)
+					{
+						basicMaterial->color = Color((float) (*factor)[0].number, (float) (*factor)[1].number,
+							(float) (*factor)[2].number, (float) (*factor)[3].number);
+					}
+				}
+				material = basicMaterial;
+			}
+
+			return Mesh::create(primitive.geometry, material);
+		}
+	};
+}
+
+EntityGroupPtr GltfImporter::load(const std::string& path, const MeshLoaderOptions& options)
+{
+	MappedFile file(path);
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+	size_t size = file.size();
+
+	GltfData gltf;
+	const unsigned char* binaryChunk = nullptr;
+	size_t binaryChunkSize = 0;
+
+	if (size >= GLB_HEADER_SIZE && readUint32(data) == GLB_MAGIC)
+	{
+		// Binary container: a header followed by a JSON chunk and an optional binary chunk
+		if (readUint32(data + 4) != 2 || readUint32(data + 8) > size)
+		{
+			throw InstantiationException("Unsupported or truncated glTF binary file " + path);
+		}
+
+		size_t length = readUint32(data + 8);
+		size_t offset = GLB_HEADER_SIZE;
+		bool hasJson = false;
+		while (offset + GLB_CHUNK_HEADER_SIZE <= length)
+		{
+			size_t chunkSize = readUint32(data + offset);
+			uint32_t chunkType = readUint32(data + offset + 4);
+			const unsigned char* chunk = data + offset + GLB_CHUNK_HEADER_SIZE;
+			if (chunkSize > length - offset - GLB_CHUNK_HEADER_SIZE)
+			{
+				throw InstantiationException("Truncated glTF binary chunk in " + path);
+			}
+
+			if (chunkType == GLB_CHUNK_JSON && !hasJson)
+			{
+				const char* json = reinterpret_cast<const char*>(chunk);
+				gltf.root = JsonParser(json, json + chunkSize).parse();
+				hasJson = true;
+			}
+			else if (chunkType == GLB_CHUNK_BIN && binaryChunk == nullptr)
+			{
+				binaryChunk = chunk;
+				binaryChunkSize = chunkSize;
+			}
+
+			// Chunks are padded to 4-byte boundaries
+			offset += GLB_CHUNK_HEADER_SIZE + ((chunkSize + 3) & ~(size_t) 3);
+		}
+
+		if (!hasJson)
+		{
+			throw InstantiationException("glTF binary file has no JSON chunk: " + path);
+		}
+	}
+	else
+	{
+		const char* json = file.data();
+		gltf.root = JsonParser(json, json + size).parse();
+	}
+
+	const JsonValue* asset = gltf.root.get("asset");
+	if (!asset || asset->getString("version").compare(0, 1, "2") != 0)
+	{
+		throw InstantiationException("Only glTF 2.0 files are supported: " + path);
+	}
+
+	readBuffers(gltf, std::filesystem::u8path(path).parent_path(), binaryChunk, binaryChunkSize);
+
+	// Build the geometry of every triangle primitive in parallel
+	std::vector<std::vector<Primitive>> meshes;
+	std::vector<std::pair<const JsonValue*, Primitive*>> tasks;
+	if (const std::vector<JsonValue>* meshArray = gltf.root.getArray("meshes"))
+	{
+		meshes.resize(meshArray->size());
+		for (size_t i = 0; i < meshArray->size(); i++)
+		{
+			const std::vector<JsonValue>* primitives = (*meshArray)[i].getArray("primitives");
+			if (!primitives)
+			{
+				continue;
+			}
+
+			// Points and lines are not supported by the renderer, and are skipped
+			for (const JsonValue& primitive : *primitives)
+			{
+				if ((int) primitive.getNumber("mode", MODE_TRIANGLES) == MODE_TRIANGLES)
+				{
+					Primitive result;
+					result.material = (int) primitive.getNumber("material", -1);
+					meshes[i].push_back(result);
+				}
+			}
+
+			size_t next = 0;
+			for (const JsonValue& primitive : *primitives)
+			{
+				if ((int) primitive.getNumber("mode", MODE_TRIANGLES) == MODE_TRIANGLES)
+				{
+					tasks.push_back({ &primitive, &meshes[i][next++] });
+				}
+			}
+		}
+	}
+
+	parallelFor((unsigned int) tasks.size(), options.numThreads, [&](unsigned int i)
+	{
+		tasks[i].second->geometry = buildGeometry(gltf, *tasks[i].first, options);
+	});
+
+	// Rebuild the node hierarchy of the default scene, or of every root node if the file has no scenes
+	std::vector<size_t> roots;
+	const std::vector<JsonValue>* scenes = gltf.root.getArray("scenes");
+	const std::vector<JsonValue>* nodes = gltf.root.getArray("nodes");
+	if (scenes && !scenes->empty())
+	{
+		size_t scene = gltf.root.get("scene") ? gltf.root.getIndex("scene") : 0;
+		if (scene >= scenes->size())
+		{
+			throw InstantiationException("glTF file references a missing scene: " + path);
+		}
+
+		if (const std::vector<JsonValue>* sceneNodes = (*scenes)[scene].getArray("nodes"))
+		{
+			for (const JsonValue& node : *sceneNodes)
+			{
+				roots.push_back(node.toIndex());
+			}
+		}
+	}
+	else if (nodes)
+	{
+		std::vector<bool> isChild(nodes->size(), false);
+		for (const JsonValue& node : *nodes)
+		{
+			if (const std::vector<JsonValue>* children = node.getArray("children"))
+			{
+				for (const JsonValue& child : *children)
+				{
+					if (child.toIndex() < nodes->size())
+					{
+						isChild[child.toIndex()] = true;
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < nodes->size(); i++)
+		{
+			if (!isChild[i])
+			{
+				roots.push_back(i);
+			}
+		}
+	}
+
+	SceneBuilder builder(gltf, meshes);
+	EntityGroupPtr group = EntityGroup::create();
+	for (size_t root : roots)
+	{
+		group->add(builder.buildNode(root, 0));
+	}
+
+	return group;
+}
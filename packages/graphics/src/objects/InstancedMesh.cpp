@@ -0,0 +1,226 @@
+#include <graphics/objects/InstancedMesh.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/core/InstanceBuffer.h>
+#include <math/Frustum.h>
+#include <math/Sphere.h>
+#include <common/Utils.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	/**
+	 * @return A color channel in the range 0 to 1, quantized to a byte
+	 */
+	unsigned char toUnsignedByte(float value)
+	{
+		return (unsigned char) std::lround(clamp(value, 0.f, 1.f) * 255.f);
+	}
+}
+
+InstancedMesh::InstancedMesh(GeometryPtr geometry, MaterialPtr material, unsigned int count)
+	: Entity(EntityType::INSTANCED_MESH), geometry(geometry), material(material)
+{
+	InstanceData identity = {
+		{
+			1.f, 0.f, 0.f, 0.f,
+			0.f, 1.f, 0.f, 0.f,
+			0.f, 0.f, 1.f, 0.f
+		},
+		{ 255, 255, 255, 255 },
+		0.f
+	};
+	_instances.assign(count, identity);
+	_visible.reserve(count);
+}
+
+InstancedMesh::~InstancedMesh()
+{
+	delete _buffer;
+	_buffer = nullptr;
+}
+
+InstancedMeshPtr InstancedMesh::create(GeometryPtr geometry, MaterialPtr material, unsigned int count)
+{
+	return std::shared_ptr<InstancedMesh>(new InstancedMesh(geometry, material, count));
+}
+
+unsigned int InstancedMesh::getCount() const
+{
+	return _instances.size();
+}
+
+const InstanceData* InstancedMesh::getInstances() const
+{
+	return _instances.data();
+}
+
+Matrix4 InstancedMesh::getTransform(unsigned int index) const
+{
+	assertIndex(index);
+
+	const float* t = _instances[index].transform;
+	return Matrix4(
+		t[0], t[1], t[2], t[3],
+		t[4], t[5], t[6], t[7],
+		t[8], t[9], t[10], t[11],
+		0.f, 0.f, 0.f, 1.f
+	);
+}
+
+void InstancedMesh::setTransform(unsigned int index, const Matrix4& transform)
+{
+	assertIndex(index);
+
+	std::memcpy(_instances[index].transform, transform.getValues(), 12 * sizeof(float));
+	markDirty(index, 1);
+}
+
+Color InstancedMesh::getColor(unsigned int index) const
+{
+	assertIndex(index);
+
+	const unsigned char* c = _instances[index].color;
+	return Color(c[0] / 255.f, c[1] / 255.f, c[2] / 255.f, c[3] / 255.f);
+}
+
+void InstancedMesh::setColor(unsigned int index, const Color& color)
+{
+	assertIndex(index);
+
+	unsigned char* c = _instances[index].color;
+	c[0] = toUnsignedByte(color.red());
+	c[1] = toUnsignedByte(color.green());
+	c[2] = toUnsignedByte(color.blue());
+	c[3] = toUnsignedByte(color.alpha());
+	markDirty(index, 1);
+}
+
+unsigned int InstancedMesh::getLayer(unsigned int index) const
+{
+	assertIndex(index);
+
+	return (unsigned int) _instances[index].layer;
+}
+
+void InstancedMesh::setLayer(unsigned int index, unsigned int layer)
+{
+	assertIndex(index);
+
+	_instances[index].layer = (float) layer;
+	markDirty(index, 1);
+}
+
+void InstancedMesh::setInstances(unsigned int first, const InstanceData* data, unsigned int count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	assertIndex(first + count - 1);
+
+	std::memcpy(&_instances[first], data, count * sizeof(InstanceData));
+	markDirty(first, count);
+}
+
+unsigned int InstancedMesh::cull(const Frustum& frustum, const Matrix4& modelTransform)
+{
+	_visible.clear();
+
+	unsigned int count = _instances.size();
+	if (!frustumCulled)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			_visible.push_back(i);
+		}
+		return count;
+	}
+
+	const Sphere& bounds = geometry->getBoundingSphere();
+	if (bounds.isEmpty())
+	{
+		return 0;
+	}
+
+	const float* m = modelTransform.getValues();
+	float modelScale = Sphere::getMaxScale(modelTransform);
+	float cx = bounds.center.x;
+	float cy = bounds.center.y;
+	float cz = bounds.center.z;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const float* t = _instances[i].transform;
+
+		// Sphere center, in mesh space
+		float x = t[0] * cx + t[1] * cy + t[2] * cz + t[3];
+		float y = t[4] * cx + t[5] * cy + t[6] * cz + t[7];
+		float z = t[8] * cx + t[9] * cy + t[10] * cz + t[11];
+
+		// Sphere center, in world space
+		float wx = m[0] * x + m[1] * y + m[2] * z + m[3];
+		float wy = m[4] * x + m[5] * y + m[6] * z + m[7];
+		float wz = m[8] * x + m[9] * y + m[10] * z + m[11];
+
+		// Largest axis scale of the instance
+		float sx = t[0] * t[0] + t[4] * t[4] + t[8] * t[8];
+		float sy = t[1] * t[1] + t[5] * t[5] + t[9] * t[9];
+		float sz = t[2] * t[2] + t[6] * t[6] + t[10] * t[10];
+		float radius = bounds.radius * modelScale * sqrt(std::max(sx, std::max(sy, sz)));
+
+		if (frustum.intersectsSphere(wx, wy, wz, radius))
+		{
+			_visible.push_back(i);
+		}
+	}
+
+	return _visible.size();
+}
+
+const std::vector<unsigned int>& InstancedMesh::getVisibleInstances() const
+{
+	return _visible;
+}
+
+InstanceBuffer* InstancedMesh::getBuffer()
+{
+	if (_buffer == nullptr)
+	{
+		_buffer = new InstanceBuffer(_instances.data(), _instances.size());
+		_dirtyBegin = 0;
+		_dirtyEnd = 0;
+	}
+	else if (_dirtyEnd > _dirtyBegin)
+	{
+		_buffer->update(_instances.data(), _dirtyBegin, _dirtyEnd - _dirtyBegin);
+		_dirtyBegin = 0;
+		_dirtyEnd = 0;
+	}
+
+	return _buffer;
+}
+
+void InstancedMesh::markDirty(unsigned int first, unsigned int count)
+{
+	if (_dirtyEnd == _dirtyBegin)
+	{
+		_dirtyBegin = first;
+		_dirtyEnd = first + count;
+		return;
+	}
+
+	_dirtyBegin = std::min(_dirtyBegin, first);
+	_dirtyEnd = std::max(_dirtyEnd, first + count);
+}
+
+void InstancedMesh::assertIndex(unsigned int index) const
+{
+	if (index >= _instances.size())
+	{
+		throw OutOfBoundsException("Instance index is out of range");
+	}
+}
@@ -0,0 +1,130 @@
+#include <graphics/objects/LODMesh.h>
+#include <math/Matrix4.h>
+#include <math/Sphere.h>
+#include <math/Vector3.h>
+#include <common/Assertions.h>
+#include <common/Utils.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const float LODMesh::DEFAULT_HYSTERESIS = 0.1f;
+const float LODMesh::DEFAULT_FADE_DURATION = 0.25f;
+
+LODMesh::LODMesh(const std::vector<GeometryPtr>& levels, const std::vector<float>& thresholds, MaterialPtr material)
+	: Mesh(levels[0], material), _levels(levels), _thresholds(thresholds)
+{
+
+}
+
+LODMeshPtr LODMesh::create(const std::vector<GeometryPtr>& levels, const std::vector<float>& thresholds,
+	MaterialPtr material)
+{
+	assertTrue(!levels.empty(), "Mesh must have at least one level of detail");
+	assertTrue(thresholds.size() + 1 == levels.size(), "Mesh must have one threshold fewer than levels of detail");
+	for (const GeometryPtr& level : levels)
+	{
+		assertNotNull(level.get(), "Level of detail geometry cannot be null");
+	}
+	for (size_t i = 1; i < thresholds.size(); i++)
+	{
+		assertTrue(thresholds[i] < thresholds[i - 1], "Level of detail thresholds must be strictly decreasing");
+	}
+
+	return std::shared_ptr<LODMesh>(new LODMesh(levels, thresholds, material));
+}
+
+unsigned int LODMesh::getNumLevels() const
+{
+	return (unsigned int) _levels.size();
+}
+
+GeometryPtr LODMesh::getLevel(unsigned int index) const
+{
+	if (index >= _levels.size())
+	{
+		throw OutOfBoundsException("Level of detail index out of range");
+	}
+
+	return index == 0 ? geometry : _levels[index];
+}
+
+float LODMesh::getThreshold(unsigned int index) const
+{
+	if (index >= _thresholds.size())
+	{
+		throw OutOfBoundsException("Level of detail threshold index out of range");
+	}
+
+	return _thresholds[index];
+}
+
+unsigned int LODMesh::getCurrentLevel() const
+{
+	return _currentLevel;
+}
+
+unsigned int LODMesh::getFadingLevel() const
+{
+	return _fadingLevel;
+}
+
+float LODMesh::getFadeProgress(float time) const
+{
+	if (_fadingLevel == _currentLevel || fadeDuration <= 0.f)
+	{
+		return 1.f;
+	}
+
+	return clamp((time - _fadeStart) / fadeDuration, 0.f, 1.f);
+}
+
+unsigned int LODMesh::update(float coverage, float time)
+{
+	// Only switch once the coverage passes a threshold by the hysteresis margin
+	unsigned int level = _currentLevel;
+	while (level < _thresholds.size() && coverage < _thresholds[level] * (1.f - hysteresis))
+	{
+		level++;
+	}
+	while (level > 0 && coverage > _thresholds[level - 1] * (1.f + hysteresis))
+	{
+		level--;
+	}
+
+	if (level != _currentLevel)
+	{
+		// The first level selected is shown at once
+		_fadingLevel = crossFade && fadeDuration > 0.f && _updated ? _currentLevel : level;
+		_fadeStart = time;
+		_currentLevel = level;
+	}
+	else if (_fadingLevel != _currentLevel && time - _fadeStart >= fadeDuration)
+	{
+		_fadingLevel = _currentLevel;
+	}
+
+	_updated = true;
+	return _currentLevel;
+}
+
+float LODMesh::computeScreenCoverage(const Sphere& bounds, const Matrix4& modelTransform,
+	const Vector3& cameraPosition, float fov, float bias)
+{
+	if (bounds.isEmpty())
+	{
+		return 0.f;
+	}
+
+	Sphere world = bounds.transform(modelTransform);
+	float distance = world.center.minus(cameraPosition).getMagnitude();
+	if (distance <= world.radius)
+	{
+		return std::numeric_limits<float>::max();
+	}
+
+	// The projected radius relative to half of the viewport height equals the diameter relative to its full height
+	float halfHeight = std::tan(deg2Rad(fov * 0.5f));
+	return world.radius / (distance * halfHeight) * std::exp2(-bias);
+}
@@ -0,0 +1,52 @@
+#include <graphics/objects/MeshLoader.h>
+#include <graphics/objects/GltfImporter.h>
+#include <graphics/objects/ObjImporter.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/MeshFile.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <common/Utils.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <algorithm>
+#include <cctype>
+
+EntityGroupPtr MeshLoader::load(const std::string& path, const MeshLoaderOptions& options)
+{
+	std::string lowerPath = path;
+	std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), [](unsigned char c)
+	{
+		return (char) std::tolower(c);
+	});
+
+	std::string fullPath = resolvePath(path);
+	if (checkSuffix(lowerPath, ".obj"))
+	{
+		return ObjImporter::load(fullPath, options);
+	}
+	if (checkSuffix(lowerPath, ".gltf") || checkSuffix(lowerPath, ".glb"))
+	{
+		return GltfImporter::load(fullPath, options);
+	}
+
+	if (checkSuffix(lowerPath, MeshFile::EXTENSION))
+	{
+		// Mesh files hold geometry only, so every mesh is given a basic material
+		BasicMaterialPtr materials[2];
+		EntityGroupPtr group = EntityGroup::create();
+		for (const GeometryPtr& geometry : MeshFile::read(fullPath))
+		{
+			bool useVertexColors = geometry->getAttributes().colors;
+			BasicMaterialPtr& material = materials[useVertexColors ? 1 : 0];
+			if (!material)
+			{
+				material = BasicMaterial::create();
+				material->useVertexColors = useVertexColors;
+			}
+			group->add(Mesh::create(geometry, material));
+		}
+		return group;
+	}
+
+	throw IllegalArgumentException("Unsupported mesh file format: " + path);
+}
@@ -0,0 +1,775 @@
+#include <graphics/objects/ObjImporter.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryOptimizer.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <common/MappedFile.h>
+#include <common/Parallel.h>
+#include <common/exceptions/InstantiationException.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+const size_t ObjImporter::DEFAULT_CHUNK_SIZE = 1 << 20;
+
+namespace
+{
+	/**
+	 * Marks a face corner without texture coordinates or a normal
+	 */
+	const int MISSING = std::numeric_limits<int>::min();
+
+	/**
+	 * Marks the end of a list of vertices
+	 */
+	const unsigned int NONE = std::numeric_limits<unsigned int>::max();
+
+	/**
+	 * Powers of ten that are exactly representable as doubles
+	 */
+	const double POWERS_OF_TEN[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/**
+	 * Flags marking which indices of a face corner are relative to the end of their attribute list
+	 */
+	const unsigned int RELATIVE_POSITION = 1;
+	const unsigned int RELATIVE_UV = 2;
+	const unsigned int RELATIVE_NORMAL = 4;
+
+	/**
+	 * References of a face corner to a position, texture coordinates, and a normal, counted from 0
+	 */
+	struct Corner {
+		int v;
+		int vt;
+		int vn;
+	};
+
+	/**
+	 * Data parsed from a chunk of the file. Chunks start and end at line boundaries.
+	 */
+	struct Chunk {
+		const char* begin = nullptr;
+		const char* end = nullptr;
+		std::vector<float> positions;
+		std::vector<float> colors;
+		std::vector<float> normals;
+		std::vector<float> uvs;
+
+		/**
+		 * Corners of the triangulated faces, 3 per triangle
+		 */
+		std::vector<Corner> corners;
+
+		/**
+		 * Corners holding negative indices, which are counted back from the end of the attribute lists of this chunk
+		 * until the sizes of the preceding chunks are known. Each entry holds the corner index shifted left by 3, and
+		 * the relative flags in the lowest 3 bits.
+		 */
+		std::vector<unsigned int> relativeCorners;
+
+		/**
+		 * Triangles at which a new object, group, or material section starts
+		 */
+		std::vector<unsigned int> sections;
+	};
+
+	/**
+	 * Checks whether the host stores integers with the least significant byte first
+	 */
+	bool isLittleEndian()
+	{
+		const uint16_t value = 1;
+		unsigned char firstByte;
+		std::memcpy(&firstByte, &value, 1);
+		return firstByte == 1;
+	}
+
+	const bool LITTLE_ENDIAN_HOST = isLittleEndian();
+
+	/**
+	 * Checks whether all 8 bytes of a block loaded in little endian order are ASCII digits
+	 */
+	bool isEightDigits(uint64_t block)
+	{
+		return ((block & 0xF0F0F0F0F0F0F0F0ull) |
+			(((block + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+	}
+
+	/**
+	 * Converts 8 ASCII digits loaded in little endian order to their value, combining pairs of digits, then pairs of
+	 * pairs, with three multiplications
+	 */
+	uint32_t parseEightDigits(uint64_t block)
+	{
+		const uint64_t mask = 0x000000FF000000FFull;
+		const uint64_t multiplier1 = 100 + (1000000ull << 32);
+		const uint64_t multiplier2 = 1 + (10000ull << 32);
+		block -= 0x3030303030303030ull;
+		block = (block * 10) + (block >> 8);
+		block = (((block & mask) * multiplier1) + (((block >> 16) & mask) * multiplier2)) >> 32;
+		return (uint32_t) block;
+	}
+
+	bool isDigit(char c)
+	{
+		return (unsigned int) (c - '0') <= 9;
+	}
+
+	bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	bool isLineEnd(const char* str, const char* end)
+	{
+		return str == end || *str == '\n' || *str == '#';
+	}
+
+	const char* skipSpaces(const char* str, const char* end)
+	{
+		while (str < end && isSpace(*str))
+		{
+			str++;
+		}
+		return str;
+	}
+
+	/**
+	 * @return Pointer to the start of the next line, or the end of the data
+	 */
+	const char* skipLine(const char* str, const char* end)
+	{
+		const void* newline = std::memchr(str, '\n', end - str);
+		return newline ? static_cast<const char*>(newline) + 1 : end;
+	}
+
+	/**
+	 * Appends a run of digits to a mantissa. Digits that no longer fit into the mantissa are dropped and counted.
+	 */
+	const char* parseDigits(const char* str, const char* end, uint64_t& mantissa, int& numKept, int& numDropped)
+	{
+		while (true)
+		{
+			if (LITTLE_ENDIAN_HOST && end - str >= 8 && mantissa < 100000000000ull)
+			{
+				uint64_t block;
+				std::memcpy(&block, str, 8);
+				if (isEightDigits(block))
+				{
+					mantissa = mantissa * 100000000ull + parseEightDigits(block);
+					numKept += 8;
+					str += 8;
+					continue;
+				}
+			}
+
+			if (str == end || !isDigit(*str))
+			{
+				return str;
+			}
+
+			if (mantissa < 1000000000000000000ull)
+			{
+				mantissa = mantissa * 10 + (*str - '0');
+				numKept++;
+			}
+			else
+			{
+				numDropped++;
+			}
+			str++;
+		}
+	}
+
+	/**
+	 * Parses a signed integer, returning null if none starts at the given position or it does not fit into an int
+	 */
+	const char* parseIndex(const char* str, const char* end, int& value)
+	{
+		bool negative = false;
+		if (str < end && (*str == '-' || *str == '+'))
+		{
+			negative = *str == '-';
+			str++;
+		}
+
+		const char* start = str;
+		long long result = 0;
+		while (str < end && isDigit(*str))
+		{
+			result = result * 10 + (*str - '0');
+			if (result > std::numeric_limits<int>::max())
+			{
+				return nullptr;
+			}
+			str++;
+		}
+
+		if (str == start)
+		{
+			return nullptr;
+		}
+
+		value = negative ? -(int) result : (int) result;
+		return str;
+	}
+
+	/**
+	 * Throws an exception quoting the start of a malformed line
+	 */
+	[[noreturn]] void throwMalformed(const char* line, const char* end)
+	{
+		const char* lineEnd = line;
+		while (lineEnd < end && lineEnd - line < 64 && *lineEnd != '\n' && *lineEnd != '\r')
+		{
+			lineEnd++;
+		}
+		throw InstantiationException("Malformed OBJ line: " + std::string(line, lineEnd));
+	}
+
+	/**
+	 * Parses a number of whitespace separated floats, returning null if any is missing
+	 */
+	const char* parseFloats(const char* str, const char* end, float* values, unsigned int count)
+	{
+		for (unsigned int i = 0; i < count && str; i++)
+		{
+			str = ObjImporter::parseFloat(skipSpaces(str, end), end, values[i]);
+		}
+		return str;
+	}
+
+	/**
+	 * Converts a face index into an index counted from 0. Positive indices count from the start of the file, and
+	 * negative indices count back from the end of the attribute list of the chunk.
+	 * @return True if the index is relative
+	 */
+	bool resolveIndex(int index, size_t count, int& resolved)
+	{
+		if (index > 0)
+		{
+			resolved = index - 1;
+			return false;
+		}
+
+		resolved = (int) count + index;
+		return true;
+	}
+
+	/**
+	 * Parses a face line into triangles
+	 */
+	const char* parseFace(Chunk& chunk, const char* line, const char* str, std::vector<Corner>& polygon,
+		std::vector<unsigned int>& polygonFlags)
+	{
+		polygon.clear();
+		polygonFlags.clear();
+
+		while (true)
+		{
+			str = skipSpaces(str, chunk.end);
+			if (isLineEnd(str, chunk.end))
+			{
+				break;
+			}
+
+			Corner corner = { MISSING, MISSING, MISSING };
+			unsigned int flags = 0;
+			int index = 0;
+
+			str = parseIndex(str, chunk.end, index);
+			if (!str || index == 0)
+			{
+				throwMalformed(line, chunk.end);
+			}
+			flags |= resolveIndex(index, chunk.positions.size() / 3, corner.v) ? RELATIVE_POSITION : 0;
+
+			if (str < chunk.end && *str == '/')
+			{
+				str++;
+				if (str < chunk.end && *str != '/')
+				{
+					str = parseIndex(str, chunk.end, index);
+					if (!str || index == 0)
+					{
+						throwMalformed(line, chunk.end);
+					}
+					flags |= resolveIndex(index, chunk.uvs.size() / 2, corner.vt) ? RELATIVE_UV : 0;
+				}
+
+				if (str < chunk.end && *str == '/')
+				{
+					str = parseIndex(str + 1, chunk.end, index);
+					if (!str || index == 0)
+					{
+						throwMalformed(line, chunk.end);
+					}
+					flags |= resolveIndex(index, chunk.normals.size() / 3, corner.vn) ? RELATIVE_NORMAL : 0;
+				}
+			}
+
+			if (str < chunk.end && !isSpace(*str) && !isLineEnd(str, chunk.end))
+			{
+				throwMalformed(line, chunk.end);
+			}
+
+			polygon.push_back(corner);
+			polygonFlags.push_back(flags);
+		}
+
+		if (polygon.size() < 3)
+		{
+			throwMalformed(line, chunk.end);
+		}
+
+		// Triangulate as a fan around the first corner
+		for (size_t i = 2; i < polygon.size(); i++)
+		{
+			size_t triangle[] = { 0, i - 1, i };
+			for (size_t j : triangle)
+			{
+				if (polygonFlags[j] != 0)
+				{
+					chunk.relativeCorners.push_back(((unsigned int) chunk.corners.size() << 3) | polygonFlags[j]);
+				}
+				chunk.corners.push_back(polygon[j]);
+			}
+		}
+
+		return str;
+	}
+
+	/**
+	 * Parses all lines of a chunk
+	 */
+	void parseChunk(Chunk& chunk)
+	{
+		std::vector<Corner> polygon;
+		std::vector<unsigned int> polygonFlags;
+		const char* end = chunk.end;
+		const char* str = chunk.begin;
+
+		while (str < end)
+		{
+			const char* line = skipSpaces(str, end);
+			str = line;
+			if (end - line < 2)
+			{
+				break;
+			}
+
+			char type = line[0];
+			if (type == 'v' && isSpace(line[1]))
+			{
+				float values[3];
+				str = parseFloats(line + 2, end, values, 3);
+				if (!str)
+				{
+					throwMalformed(line, end);
+				}
+				chunk.positions.insert(chunk.positions.end(), values, values + 3);
+
+				// Some exporters append a vertex color to the position
+				str = skipSpaces(str, end);
+				if (!isLineEnd(str, end))
+				{
+					str = parseFloats(str, end, values, 3);
+					if (!str)
+					{
+						throwMalformed(line, end);
+					}
+					chunk.colors.resize(chunk.positions.size() - 3, 1.f);
+					chunk.colors.insert(chunk.colors.end(), values, values + 3);
+				}
+			}
+			else if (type == 'v' && line[1] == 'n' && end - line > 2 && isSpace(line[2]))
+			{
+				float values[3];
+				str = parseFloats(line + 3, end, values, 3);
+				if (!str)
+				{
+					throwMalformed(line, end);
+				}
+				chunk.normals.insert(chunk.normals.end(), values, values + 3);
+			}
+			else if (type == 'v' && line[1] == 't' && end - line > 2 && isSpace(line[2]))
+			{
+				float values[2] = { 0.f, 0.f };
+				str = parseFloats(line + 3, end, values, 1);
+				if (!str)
+				{
+					throwMalformed(line, end);
+				}
+
+				// The second texture coordinate is optional
+				str = skipSpaces(str, end);
+				if (!isLineEnd(str, end) && !(str = ObjImporter::parseFloat(str, end, values[1])))
+				{
+					throwMalformed(line, end);
+				}
+				chunk.uvs.insert(chunk.uvs.end(), values, values + 2);
+			}
+			else if (type == 'f' && isSpace(line[1]))
+			{
+				str = parseFace(chunk, line, line + 2, polygon, polygonFlags);
+			}
+			else if (((type == 'o' || type == 'g') && isSpace(line[1])) ||
+				(end - line > 6 && std::memcmp(line, "usemtl", 6) == 0 && isSpace(line[6])))
+			{
+				chunk.sections.push_back((unsigned int) chunk.corners.size() / 3);
+			}
+
+			str = skipLine(str, end);
+		}
+
+		if (!chunk.colors.empty())
+		{
+			chunk.colors.resize(chunk.positions.size(), 1.f);
+		}
+	}
+
+	/**
+	 * Attribute lists of the whole file, and the triangles of every chunk
+	 */
+	struct ObjData {
+		std::vector<float> positions;
+		std::vector<float> colors;
+		std::vector<float> normals;
+		std::vector<float> uvs;
+		std::vector<Chunk> chunks;
+
+		/**
+		 * The index of the first triangle of every chunk, followed by the total number of triangles
+		 */
+		std::vector<unsigned int> triangleOffsets;
+	};
+
+	/**
+	 * Builds the geometry of a range of triangles, sharing vertices whose corners reference the same attributes
+	 */
+	GeometryPtr buildGeometry(const ObjData& data, unsigned int firstTriangle, unsigned int lastTriangle,
+		const MeshLoaderOptions& options)
+	{
+		unsigned int numPositions = (unsigned int) (data.positions.size() / 3);
+		unsigned int numNormals = (unsigned int) (data.normals.size() / 3);
+		unsigned int numUVs = (unsigned int) (data.uvs.size() / 2);
+		unsigned int numIndices = (lastTriangle - firstTriangle) * 3;
+
+		// Vertices sharing a position are chained into a list, headed by an entry per position. Small sections of
+		// large files look up the heads in a hash map rather than allocating an entry for every position.
+		bool dense = numIndices >= numPositions / 8;
+		std::vector<unsigned int> denseHeads;
+		std::unordered_map<int, unsigned int> sparseHeads;
+		if (dense)
+		{
+			denseHeads.assign(numPositions, NONE);
+		}
+		else
+		{
+			sparseHeads.reserve(numIndices);
+		}
+
+		std::vector<Corner> vertices;
+		std::vector<unsigned int> next;
+		std::vector<unsigned int> indices(numIndices);
+		bool hasNormals = false;
+		bool hasUVs = false;
+
+		size_t chunk = std::upper_bound(data.triangleOffsets.begin(), data.triangleOffsets.end(), firstTriangle) -
+			data.triangleOffsets.begin() - 1;
+		size_t corner = (size_t) (firstTriangle - data.triangleOffsets[chunk]) * 3;
+
+		for (unsigned int i = 0; i < numIndices; i++)
+		{
+			while (corner == data.chunks[chunk].corners.size())
+			{
+				chunk++;
+				corner = 0;
+			}
+
+			const Corner& reference = data.chunks[chunk].corners[corner++];
+			if (reference.v < 0 || reference.v >= (int) numPositions)
+			{
+				throw InstantiationException("OBJ face references a missing vertex position");
+			}
+			if (reference.vt != MISSING && (reference.vt < 0 || reference.vt >= (int) numUVs))
+			{
+				throw InstantiationException("OBJ face references missing texture coordinates");
+			}
+			if (reference.vn != MISSING && (reference.vn < 0 || reference.vn >= (int) numNormals))
+			{
+				throw InstantiationException("OBJ face references a missing normal");
+			}
+			hasNormals = hasNormals || reference.vn != MISSING;
+			hasUVs = hasUVs || reference.vt != MISSING;
+
+			unsigned int& head = dense ? denseHeads[reference.v] : sparseHeads.emplace(reference.v, NONE).first->second;
+			unsigned int vertex = head;
+			while (vertex != NONE && (vertices[vertex].vt != reference.vt || vertices[vertex].vn != reference.vn))
+			{
+				vertex = next[vertex];
+			}
+
+			if (vertex == NONE)
+			{
+				vertex = (unsigned int) vertices.size();
+				vertices.push_back(reference);
+				next.push_back(head);
+				head = vertex;
+			}
+
+			indices[i] = vertex;
+		}
+
+		GeometryAttributes layout;
+		layout.normals = hasNormals;
+		layout.colors = !data.colors.empty();
+		layout.uvs = hasUVs;
+		if (options.compactFormats)
+		{
+			layout.normalFormat = AttributeFormat::INT_2_10_10_10_REV;
+			layout.colorFormat = AttributeFormat::UNSIGNED_BYTE;
+			layout.uvFormat = AttributeFormat::HALF_FLOAT;
+		}
+
+		// Corners without texture coordinates or a normal in a section that otherwise has them are zero-filled
+		std::vector<float> vertexData(vertices.size() * layout.getStride(), 0.f);
+		float* dst = vertexData.data();
+		for (const Corner& vertex : vertices)
+		{
+			std::memcpy(dst, &data.positions[(size_t) vertex.v * 3], 3 * sizeof(float));
+			dst += 3;
+
+			if (layout.normals)
+			{
+				if (vertex.vn != MISSING)
+				{
+					std::memcpy(dst, &data.normals[(size_t) vertex.vn * 3], 3 * sizeof(float));
+				}
+				dst += 3;
+			}
+
+			if (layout.colors)
+			{
+				std::memcpy(dst, &data.colors[(size_t) vertex.v * 3], 3 * sizeof(float));
+				dst[3] = 1.f;
+				dst += 4;
+			}
+
+			if (layout.uvs)
+			{
+				if (vertex.vt != MISSING)
+				{
+					std::memcpy(dst, &data.uvs[(size_t) vertex.vt * 2], 2 * sizeof(float));
+				}
+				dst += 2;
+			}
+		}
+
+		GeometryPtr geometry = Geometry::create();
+		geometry->setIndices(indices.data(), numIndices);
+		geometry->setInterleavedVertices(layout, std::move(vertexData));
+
+		if (options.optimize)
+		{
+			GeometryOptimizer::optimize(geometry);
+		}
+
+		return geometry;
+	}
+}
+
+EntityGroupPtr ObjImporter::load(const std::string& path, const MeshLoaderOptions& options)
+{
+	MappedFile file(path);
+	return parse(file.data(), file.size(), options);
+}
+
+EntityGroupPtr ObjImporter::parse(const char* data, size_t size, const MeshLoaderOptions& options, size_t chunkSize)
+{
+	ObjData obj;
+	chunkSize = std::max<size_t>(chunkSize, 1);
+
+	// Split the data into chunks of whole lines
+	const char* end = data + size;
+	for (const char* begin = data; begin < end;)
+	{
+		Chunk chunk;
+		chunk.begin = begin;
+		chunk.end = (size_t) (end - begin) > chunkSize ? skipLine(begin + chunkSize, end) : end;
+		begin = chunk.end;
+		obj.chunks.push_back(std::move(chunk));
+	}
+
+	parallelFor((unsigned int) obj.chunks.size(), options.numThreads, [&obj](unsigned int i)
+	{
+		parseChunk(obj.chunks[i]);
+	});
+
+	// Offsets of each chunk into the attribute lists of the whole file
+	size_t numChunks = obj.chunks.size();
+	std::vector<size_t> positionOffsets(numChunks + 1, 0);
+	std::vector<size_t> normalOffsets(numChunks + 1, 0);
+	std::vector<size_t> uvOffsets(numChunks + 1, 0);
+	obj.triangleOffsets.assign(numChunks + 1, 0);
+	bool hasColors = false;
+
+	for (size_t i = 0; i < numChunks; i++)
+	{
+		const Chunk& chunk = obj.chunks[i];
+		positionOffsets[i + 1] = positionOffsets[i] + chunk.positions.size();
+		normalOffsets[i + 1] = normalOffsets[i] + chunk.normals.size();
+		uvOffsets[i + 1] = uvOffsets[i] + chunk.uvs.size();
+		obj.triangleOffsets[i + 1] = obj.triangleOffsets[i] + (unsigned int) (chunk.corners.size() / 3);
+		hasColors = hasColors || !chunk.colors.empty();
+	}
+
+	if (positionOffsets[numChunks] / 3 > (size_t) std::numeric_limits<int>::max())
+	{
+		throw InstantiationException("OBJ data holds too many vertices");
+	}
+
+	// Gather the attribute lists, and resolve indices relative to the end of each chunk
+	obj.positions.resize(positionOffsets[numChunks]);
+	obj.normals.resize(normalOffsets[numChunks]);
+	obj.uvs.resize(uvOffsets[numChunks]);
+	if (hasColors)
+	{
+		obj.colors.resize(positionOffsets[numChunks], 1.f);
+	}
+
+	parallelFor((unsigned int) numChunks, options.numThreads, [&](unsigned int i)
+	{
+		Chunk& chunk = obj.chunks[i];
+		std::copy(chunk.positions.begin(), chunk.positions.end(), obj.positions.begin() + positionOffsets[i]);
+		std::copy(chunk.normals.begin(), chunk.normals.end(), obj.normals.begin() + normalOffsets[i]);
+		std::copy(chunk.uvs.begin(), chunk.uvs.end(), obj.uvs.begin() + uvOffsets[i]);
+		std::copy(chunk.colors.begin(), chunk.colors.end(), obj.colors.begin() + positionOffsets[i]);
+
+		int positionOffset = (int) (positionOffsets[i] / 3);
+		int normalOffset = (int) (normalOffsets[i] / 3);
+		int uvOffset = (int) (uvOffsets[i] / 2);
+		for (unsigned int entry : chunk.relativeCorners)
+		{
+			Corner& corner = chunk.corners[entry >> 3];
+			corner.v += (entry & RELATIVE_POSITION) ? positionOffset : 0;
+			corner.vt += (entry & RELATIVE_UV) ? uvOffset : 0;
+			corner.vn += (entry & RELATIVE_NORMAL) ? normalOffset : 0;
+		}
+
+		std::vector<float>().swap(chunk.positions);
+		std::vector<float>().swap(chunk.normals);
+		std::vector<float>().swap(chunk.uvs);
+		std::vector<float>().swap(chunk.colors);
+	});
+
+	// Every object, group, or material section becomes its own geometry
+	std::vector<unsigned int> sections = { 0 };
+	for (size_t i = 0; i < numChunks; i++)
+	{
+		for (unsigned int triangle : obj.chunks[i].sections)
+		{
+			sections.push_back(obj.triangleOffsets[i] + triangle);
+		}
+	}
+	sections.push_back(obj.triangleOffsets[numChunks]);
+	sections.erase(std::unique(sections.begin(), sections.end()), sections.end());
+
+	std::vector<GeometryPtr> geometries(sections.size() - 1);
+	parallelFor((unsigned int) geometries.size(), options.numThreads, [&](unsigned int i)
+	{
+		geometries[i] = buildGeometry(obj, sections[i], sections[i + 1], options);
+	});
+
+	BasicMaterialPtr material = BasicMaterial::create();
+	material->useVertexColors = hasColors;
+
+	EntityGroupPtr group = EntityGroup::create();
+	for (const GeometryPtr& geometry : geometries)
+	{
+		group->add(Mesh::create(geometry, material));
+	}
+
+	return group;
+}
+
+const char* ObjImporter::parseFloat(const char* str, const char* end, float& value)
+{
+	bool negative = false;
+	if (str < end && (*str == '-' || *str == '+'))
+	{
+		negative = *str == '-';
+		str++;
+	}
+
+	uint64_t mantissa = 0;
+	int numKept = 0;
+	int numDropped = 0;
+
+	const char* integer = str;
+	str = parseDigits(str, end, mantissa, numKept, numDropped);
+	bool hasDigits = str != integer;
+
+	// Digits dropped from the integer part scale the mantissa up, while kept fraction digits scale it down
+	int exponent = numDropped;
+	if (str < end && *str == '.')
+	{
+		const char* fraction = ++str;
+		int numFractionKept = 0;
+		str = parseDigits(str, end, mantissa, numFractionKept, numDropped);
+		exponent -= numFractionKept;
+		hasDigits = hasDigits || str != fraction;
+	}
+
+	if (!hasDigits)
+	{
+		return nullptr;
+	}
+
+	if (str < end && (*str == 'e' || *str == 'E'))
+	{
+		const char* digits = str + 1;
+		bool negativeExponent = false;
+		if (digits < end && (*digits == '-' || *digits == '+'))
+		{
+			negativeExponent = *digits == '-';
+			digits++;
+		}
+
+		if (digits < end && isDigit(*digits))
+		{
+			int explicitExponent = 0;
+			for (; digits < end && isDigit(*digits); digits++)
+			{
+				explicitExponent = std::min(explicitExponent * 10 + (*digits - '0'), 100000);
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			str = digits;
+		}
+	}
+
+	double result = (double) mantissa;
+	if (mantissa != 0 && exponent != 0)
+	{
+		if (exponent < 0)
+		{
+			result = exponent >= -22 ? result / POWERS_OF_TEN[-exponent] : result * std::pow(10.0, exponent);
+		}
+		else
+		{
+			result = exponent <= 22 ? result * POWERS_OF_TEN[exponent] : result * std::pow(10.0, exponent);
+		}
+	}
+
+	value = (float) (negative ? -result : result);
+	return str;
+}
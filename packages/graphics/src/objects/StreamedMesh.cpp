@@ -0,0 +1,20 @@
+#include <graphics/objects/StreamedMesh.h>
+#include <graphics/core/MeshStreamer.h>
+#include <common/Assertions.h>
+
+StreamedMesh::StreamedMesh(MeshStreamerPtr streamer, MaterialPtr material)
+	: Entity(EntityType::STREAMED_MESH), material(material), _streamer(streamer)
+{
+
+}
+
+StreamedMeshPtr StreamedMesh::create(MeshStreamerPtr streamer, MaterialPtr material)
+{
+	assertNotNull(streamer.get(), "Mesh streamer cannot be null");
+	return std::shared_ptr<StreamedMesh>(new StreamedMesh(streamer, material));
+}
+
+MeshStreamerPtr StreamedMesh::getStreamer() const
+{
+	return _streamer;
+}
@@ -0,0 +1,614 @@
+#include <graphics/textures/CompressedImage.h>
+#include <graphics/core/GLCapabilities.h>
+#include <common/Assertions.h>
+#include <common/MappedFile.h>
+#include <common/Utils.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+namespace
+{
+	/**
+	 * Identifier at the start of every KTX2 file
+	 */
+	const unsigned char KTX2_IDENTIFIER[] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	/**
+	 * Size of the KTX2 header and index preceding the level index, in bytes
+	 */
+	const size_t KTX2_HEADER_SIZE = 80;
+
+	/**
+	 * Size of every entry of the KTX2 level index, in bytes
+	 */
+	const size_t KTX2_LEVEL_SIZE = 24;
+
+	/**
+	 * The characters "DDS " read as a little endian integer
+	 */
+	const uint32_t DDS_MAGIC = 0x20534444;
+
+	/**
+	 * Size of the magic number and header preceding the data of a DDS file, in bytes
+	 */
+	const size_t DDS_HEADER_SIZE = 128;
+
+	/**
+	 * Size of the extended header of DDS files using DXGI formats, in bytes
+	 */
+	const size_t DDS_DX10_HEADER_SIZE = 20;
+
+	const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	const uint32_t DDPF_FOURCC = 0x4;
+	const uint32_t DDSCAPS2_CUBEMAP = 0x200;
+	const uint32_t DDSCAPS2_VOLUME = 0x200000;
+	const uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+	const uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+	/**
+	 * @return A little endian integer read from a byte array
+	 */
+	template <typename T>
+	T read(const char* data, size_t offset)
+	{
+		T value;
+		std::memcpy(&value, data + offset, sizeof(T));
+		return value;
+	}
+
+	/**
+	 * @return The four characters of a DDS format code read as a little endian integer
+	 */
+	constexpr uint32_t fourCC(const char (&code)[5])
+	{
+		return (uint32_t) code[0] | ((uint32_t) code[1] << 8) | ((uint32_t) code[2] << 16) |
+			((uint32_t) code[3] << 24);
+	}
+
+	/**
+	 * Throws an instantiation exception for an invalid or unsupported file
+	 */
+	[[noreturn]] void fail(const std::string& path, const std::string& reason)
+	{
+		throw InstantiationException("Failed to load compressed image " + path + ": " + reason);
+	}
+
+	/**
+	 * Expands a 5:6:5 color to 8 bits per channel
+	 */
+	void expandColor(uint16_t color, unsigned char* rgba)
+	{
+		unsigned int r = (color >> 11) & 31;
+		unsigned int g = (color >> 5) & 63;
+		unsigned int b = color & 31;
+		rgba[0] = (unsigned char) ((r << 3) | (r >> 2));
+		rgba[1] = (unsigned char) ((g << 2) | (g >> 4));
+		rgba[2] = (unsigned char) ((b << 3) | (b >> 2));
+		rgba[3] = 255;
+	}
+
+	/**
+	 * Decodes the colors of a BC1 block, or of the color half of a BC2 or BC3 block
+	 * @param block Compressed block of 8 bytes
+	 * @param pixels Receives 16 pixels, row by row
+	 * @param fourColors Boolean flag that, when true, always interpolates four colors, as BC2 and BC3 do
+	 * @param alpha Boolean flag that, when true, makes the fourth color of three color blocks transparent
+	 */
+	void decodeColorBlock(const unsigned char* block, unsigned char* pixels, bool fourColors, bool alpha)
+	{
+		uint16_t color0 = (uint16_t) (block[0] | (block[1] << 8));
+		uint16_t color1 = (uint16_t) (block[2] | (block[3] << 8));
+		unsigned char palette[4][4];
+		expandColor(color0, palette[0]);
+		expandColor(color1, palette[1]);
+		for (unsigned int c = 0; c < 3; c++)
+		{
+			if (fourColors || color0 > color1)
+			{
+				palette[2][c] = (unsigned char) ((2 * palette[0][c] + palette[1][c]) / 3);
+				palette[3][c] = (unsigned char) ((palette[0][c] + 2 * palette[1][c]) / 3);
+			}
+			else
+			{
+				palette[2][c] = (unsigned char) ((palette[0][c] + palette[1][c]) / 2);
+				palette[3][c] = 0;
+			}
+		}
+		palette[2][3] = 255;
+		palette[3][3] = !fourColors && color0 <= color1 && alpha ? 0 : 255;
+
+		uint32_t indices = read<uint32_t>((const char*) block, 4);
+		for (unsigned int i = 0; i < 16; i++)
+		{
+			std::memcpy(pixels + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+		}
+	}
+
+	/**
+	 * Decodes a BC4 block, or the alpha half of a BC3 block, into a single channel
+	 * @param block Compressed block of 8 bytes
+	 * @param pixels Receives 16 values, 4 bytes apart
+	 */
+	void decodeChannelBlock(const unsigned char* block, unsigned char* pixels)
+	{
+		unsigned int values[8] = { block[0], block[1] };
+		if (values[0] > values[1])
+		{
+			for (unsigned int i = 1; i < 7; i++)
+			{
+				values[i + 1] = ((7 - i) * values[0] + i * values[1]) / 7;
+			}
+		}
+		else
+		{
+			for (unsigned int i = 1; i < 5; i++)
+			{
+				values[i + 1] = ((5 - i) * values[0] + i * values[1]) / 5;
+			}
+			values[6] = 0;
+			values[7] = 255;
+		}
+
+		uint64_t indices = 0;
+		for (unsigned int i = 0; i < 6; i++)
+		{
+			indices |= (uint64_t) block[2 + i] << (i * 8);
+		}
+		for (unsigned int i = 0; i < 16; i++)
+		{
+			pixels[i * 4] = (unsigned char) values[(indices >> (i * 3)) & 7];
+		}
+	}
+
+	/**
+	 * Decodes a single block of 4x4 pixels
+	 * @param format Compression format, which is one of BC1 to BC5
+	 * @param block Compressed block
+	 * @param pixels Receives 16 pixels, row by row
+	 */
+	void decodeBlock(CompressedFormat format, const unsigned char* block, unsigned char* pixels)
+	{
+		switch (format)
+		{
+		case CompressedFormat::BC1_RGB:
+		case CompressedFormat::BC1_RGBA:
+			decodeColorBlock(block, pixels, false, format == CompressedFormat::BC1_RGBA);
+			break;
+		case CompressedFormat::BC2:
+			decodeColorBlock(block + 8, pixels, true, false);
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				pixels[i * 4 + 3] = (unsigned char) (((block[i / 2] >> ((i % 2) * 4)) & 15) * 17);
+			}
+			break;
+		case CompressedFormat::BC3:
+			decodeColorBlock(block + 8, pixels, true, false);
+			decodeChannelBlock(block, pixels + 3);
+			break;
+		case CompressedFormat::BC4:
+		case CompressedFormat::BC5:
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				pixels[i * 4 + 1] = 0;
+				pixels[i * 4 + 2] = 0;
+				pixels[i * 4 + 3] = 255;
+			}
+			decodeChannelBlock(block, pixels);
+			if (format == CompressedFormat::BC5)
+			{
+				decodeChannelBlock(block + 8, pixels + 1);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+CompressedImage::CompressedImage(const std::string& path) : _file(new MappedFile(path))
+{
+	if (checkSuffix(path, ".ktx2"))
+	{
+		readKTX2(path);
+	}
+	else if (checkSuffix(path, ".dds"))
+	{
+		readDDS(path);
+	}
+	else
+	{
+		fail(path, "unknown container");
+	}
+}
+
+CompressedImage::~CompressedImage()
+{
+
+}
+
+bool CompressedImage::isCompressedPath(const std::string& path)
+{
+	return checkSuffix(path, ".ktx2") || checkSuffix(path, ".dds");
+}
+
+unsigned int CompressedImage::getBlockSize(CompressedFormat format)
+{
+	switch (format)
+	{
+	case CompressedFormat::BC1_RGB:
+	case CompressedFormat::BC1_RGBA:
+	case CompressedFormat::BC4:
+	case CompressedFormat::ETC2_RGB:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+unsigned int CompressedImage::getGLFormat(CompressedFormat format)
+{
+	switch (format)
+	{
+	case CompressedFormat::BC1_RGB:
+		return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case CompressedFormat::BC1_RGBA:
+		return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	case CompressedFormat::BC2:
+		return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+	case CompressedFormat::BC3:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case CompressedFormat::BC4:
+		return GL_COMPRESSED_RED_RGTC1;
+	case CompressedFormat::BC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	case CompressedFormat::BC7:
+		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	case CompressedFormat::ETC2_RGB:
+		return GL_COMPRESSED_RGB8_ETC2;
+	default:
+		return GL_COMPRESSED_RGBA8_ETC2_EAC;
+	}
+}
+
+bool CompressedImage::isSupported(CompressedFormat format)
+{
+	switch (format)
+	{
+	case CompressedFormat::BC1_RGB:
+	case CompressedFormat::BC1_RGBA:
+	case CompressedFormat::BC2:
+	case CompressedFormat::BC3:
+		return GLCapabilities::hasExtension("GL_EXT_texture_compression_s3tc");
+	case CompressedFormat::BC4:
+	case CompressedFormat::BC5:
+		return GLCapabilities::hasVersion(3, 0) || GLCapabilities::hasExtension("GL_ARB_texture_compression_rgtc");
+	case CompressedFormat::BC7:
+		return GLCapabilities::hasVersion(4, 2) || GLCapabilities::hasExtension("GL_ARB_texture_compression_bptc");
+	default:
+		return GLCapabilities::hasVersion(4, 3) || GLCapabilities::hasExtension("GL_ARB_ES3_compatibility");
+	}
+}
+
+bool CompressedImage::isDecodable(CompressedFormat format)
+{
+	return format != CompressedFormat::BC7 && format != CompressedFormat::ETC2_RGB &&
+		format != CompressedFormat::ETC2_RGBA;
+}
+
+CompressedFormat CompressedImage::getFormat() const
+{
+	return _format;
+}
+
+unsigned int CompressedImage::getWidth() const
+{
+	return _levels[0].width;
+}
+
+unsigned int CompressedImage::getHeight() const
+{
+	return _levels[0].height;
+}
+
+unsigned int CompressedImage::getNumLevels() const
+{
+	return (unsigned int) _levels.size();
+}
+
+const CompressedLevel& CompressedImage::getLevel(unsigned int level) const
+{
+	if (level >= _levels.size())
+	{
+		throw OutOfBoundsException("Level index out of range");
+	}
+
+	return _levels[level];
+}
+
+const unsigned char* CompressedImage::getLevelData(unsigned int level) const
+{
+	return (const unsigned char*) _file->data() + getLevel(level).offset;
+}
+
+size_t CompressedImage::getDataSize() const
+{
+	size_t size = 0;
+	for (const CompressedLevel& level : _levels)
+	{
+		size += level.size;
+	}
+	return size;
+}
+
+void CompressedImage::decode(unsigned int level, std::vector<unsigned char>& pixels) const
+{
+	const CompressedLevel& info = getLevel(level);
+	assertTrue(isDecodable(_format), "Compressed image format cannot be decoded on the CPU");
+
+	const unsigned char* blocks = getLevelData(level);
+	unsigned int blockSize = getBlockSize(_format);
+	unsigned int blocksWide = (info.width + 3) / 4;
+	unsigned int blocksHigh = (info.height + 3) / 4;
+	pixels.resize((size_t) info.width * info.height * 4);
+
+	unsigned char block[16 * 4];
+	for (unsigned int by = 0; by < blocksHigh; by++)
+	{
+		for (unsigned int bx = 0; bx < blocksWide; bx++)
+		{
+			decodeBlock(_format, blocks + ((size_t) by * blocksWide + bx) * blockSize, block);
+
+			// Blocks on the right and bottom edges may extend past the image
+			unsigned int width = std::min(4u, info.width - bx * 4);
+			unsigned int height = std::min(4u, info.height - by * 4);
+			for (unsigned int y = 0; y < height; y++)
+			{
+				std::memcpy(pixels.data() + (((size_t) by * 4 + y) * info.width + bx * 4) * 4, block + y * 16,
+					width * 4);
+			}
+		}
+	}
+}
+
+void CompressedImage::readKTX2(const std::string& path)
+{
+	const char* data = _file->data();
+	size_t size = _file->size();
+	if (size < KTX2_HEADER_SIZE || std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+	{
+		fail(path, "not a KTX2 file");
+	}
+
+	uint32_t vkFormat = read<uint32_t>(data, 12);
+	uint32_t width = read<uint32_t>(data, 20);
+	uint32_t height = read<uint32_t>(data, 24);
+	uint32_t depth = read<uint32_t>(data, 28);
+	uint32_t numLayers = read<uint32_t>(data, 32);
+	uint32_t numFaces = read<uint32_t>(data, 36);
+	uint32_t numLevels = std::max(read<uint32_t>(data, 40), 1u);
+	uint32_t supercompression = read<uint32_t>(data, 44);
+	if (height == 0 || depth > 1 || numLayers > 1 || numFaces != 1)
+	{
+		fail(path, "only two-dimensional images are supported");
+	}
+	if (supercompression != 0)
+	{
+		fail(path, "supercompressed images are not supported");
+	}
+
+	// Vulkan formats, accepting only their linear variants
+	switch (vkFormat)
+	{
+	case 131:
+		_format = CompressedFormat::BC1_RGB;
+		break;
+	case 133:
+		_format = CompressedFormat::BC1_RGBA;
+		break;
+	case 135:
+		_format = CompressedFormat::BC2;
+		break;
+	case 137:
+		_format = CompressedFormat::BC3;
+		break;
+	case 139:
+		_format = CompressedFormat::BC4;
+		break;
+	case 141:
+		_format = CompressedFormat::BC5;
+		break;
+	case 145:
+		_format = CompressedFormat::BC7;
+		break;
+	case 147:
+		_format = CompressedFormat::ETC2_RGB;
+		break;
+	case 151:
+		_format = CompressedFormat::ETC2_RGBA;
+		break;
+	default:
+		fail(path, "unsupported format " + std::to_string(vkFormat));
+	}
+
+	if (numLevels > 32 || size < KTX2_HEADER_SIZE + numLevels * KTX2_LEVEL_SIZE)
+	{
+		fail(path, "truncated level index");
+	}
+
+	std::vector<size_t> offsets;
+	for (uint32_t i = 0; i < numLevels; i++)
+	{
+		uint64_t offset = read<uint64_t>(data, KTX2_HEADER_SIZE + i * KTX2_LEVEL_SIZE);
+		offsets.push_back(offset > size ? size : (size_t) offset);
+	}
+	addLevels(width, height, offsets, path);
+
+	for (uint32_t i = 0; i < numLevels; i++)
+	{
+		if (read<uint64_t>(data, KTX2_HEADER_SIZE + i * KTX2_LEVEL_SIZE + 8) != _levels[i].size)
+		{
+			fail(path, "level " + std::to_string(i) + " has an unexpected size");
+		}
+	}
+}
+
+void CompressedImage::readDDS(const std::string& path)
+{
+	const char* data = _file->data();
+	size_t size = _file->size();
+	if (size < DDS_HEADER_SIZE || read<uint32_t>(data, 0) != DDS_MAGIC || read<uint32_t>(data, 4) != 124)
+	{
+		fail(path, "not a DDS file");
+	}
+
+	uint32_t flags = read<uint32_t>(data, 8);
+	uint32_t height = read<uint32_t>(data, 12);
+	uint32_t width = read<uint32_t>(data, 16);
+	uint32_t numLevels = (flags & DDSD_MIPMAPCOUNT) ? std::max(read<uint32_t>(data, 28), 1u) : 1;
+	uint32_t pixelFlags = read<uint32_t>(data, 80);
+	uint32_t code = read<uint32_t>(data, 84);
+	uint32_t caps2 = read<uint32_t>(data, 112);
+	if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+	{
+		fail(path, "only two-dimensional images are supported");
+	}
+	if (!(pixelFlags & DDPF_FOURCC))
+	{
+		fail(path, "uncompressed images are not supported");
+	}
+
+	size_t dataOffset = DDS_HEADER_SIZE;
+	if (code == fourCC("DX10"))
+	{
+		if (size < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE)
+		{
+			fail(path, "truncated header");
+		}
+
+		uint32_t dxgiFormat = read<uint32_t>(data, 128);
+		uint32_t dimension = read<uint32_t>(data, 132);
+		uint32_t miscFlags = read<uint32_t>(data, 136);
+		uint32_t arraySize = read<uint32_t>(data, 140);
+		if (dimension != DDS_DIMENSION_TEXTURE2D || (miscFlags & DDS_RESOURCE_MISC_TEXTURECUBE) || arraySize > 1)
+		{
+			fail(path, "only two-dimensional images are supported");
+		}
+
+		// DXGI formats, accepting only their linear variants
+		switch (dxgiFormat)
+		{
+		case 71:
+			_format = CompressedFormat::BC1_RGBA;
+			break;
+		case 74:
+			_format = CompressedFormat::BC2;
+			break;
+		case 77:
+			_format = CompressedFormat::BC3;
+			break;
+		case 80:
+			_format = CompressedFormat::BC4;
+			break;
+		case 83:
+			_format = CompressedFormat::BC5;
+			break;
+		case 98:
+			_format = CompressedFormat::BC7;
+			break;
+		default:
+			fail(path, "unsupported format " + std::to_string(dxgiFormat));
+		}
+		dataOffset += DDS_DX10_HEADER_SIZE;
+	}
+	else if (code == fourCC("DXT1"))
+	{
+		_format = CompressedFormat::BC1_RGBA;
+	}
+	else if (code == fourCC("DXT2") || code == fourCC("DXT3"))
+	{
+		_format = CompressedFormat::BC2;
+	}
+	else if (code == fourCC("DXT4") || code == fourCC("DXT5"))
+	{
+		_format = CompressedFormat::BC3;
+	}
+	else if (code == fourCC("ATI1") || code == fourCC("BC4U"))
+	{
+		_format = CompressedFormat::BC4;
+	}
+	else if (code == fourCC("ATI2") || code == fourCC("BC5U"))
+	{
+		_format = CompressedFormat::BC5;
+	}
+	else
+	{
+		fail(path, "unsupported format");
+	}
+
+	if (numLevels > 32)
+	{
+		fail(path, "too many levels");
+	}
+
+	// Levels are stored one after the other, largest first
+	std::vector<size_t> offsets;
+	size_t offset = dataOffset;
+	unsigned int blockSize = getBlockSize(_format);
+	for (uint32_t i = 0; i < numLevels; i++)
+	{
+		offsets.push_back(std::min(offset, size));
+		size_t blocksWide = (std::max(width >> i, 1u) + 3) / 4;
+		size_t blocksHigh = (std::max(height >> i, 1u) + 3) / 4;
+		offset += blocksWide * blocksHigh * blockSize;
+	}
+	addLevels(width, height, offsets, path);
+}
+
+void CompressedImage::addLevels(unsigned int width, unsigned int height, const std::vector<size_t>& offsets,
+	const std::string& path)
+{
+	if (width == 0 || height == 0)
+	{
+		fail(path, "empty image");
+	}
+
+	unsigned int blockSize = getBlockSize(_format);
+	for (unsigned int i = 0; i < offsets.size(); i++)
+	{
+		if ((width >> i) == 0 && (height >> i) == 0)
+		{
+			fail(path, "too many levels");
+		}
+
+		CompressedLevel level;
+		level.width = std::max(width >> i, 1u);
+		level.height = std::max(height >> i, 1u);
+		level.offset = offsets[i];
+		level.size = (size_t) ((level.width + 3) / 4) * ((level.height + 3) / 4) * blockSize;
+		if (level.offset > _file->size() || level.size > _file->size() - level.offset)
+		{
+			fail(path, "level " + std::to_string(i) + " lies outside of the file");
+		}
+		_levels.push_back(level);
+	}
+}
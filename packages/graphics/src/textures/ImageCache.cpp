@@ -0,0 +1,299 @@
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/ImageLoader.h>
+#include <graphics/textures/MipGenerator.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Hash.h>
+#include <common/MappedFile.h>
+#include <common/Utils.h>
+#include <common/exceptions/InstantiationException.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+const std::string ImageCache::EXTENSION = ".tfimage";
+const unsigned int ImageCache::VERSION = 1;
+
+std::unique_ptr<ImageCache> ImageCache::_INSTANCE = nullptr;
+std::mutex ImageCache::_MUTEX;
+
+namespace
+{
+	/**
+	 * The characters "TFIM" read as a little endian integer
+	 */
+	const uint32_t MAGIC = 0x4D494654;
+
+	/**
+	 * Written in the byte order of the host, so that files from hosts with another byte order can be detected
+	 */
+	const uint32_t ENDIAN_TAG = 0x01020304;
+
+	const uint32_t FLIPPED = 1;
+	const uint32_t PREMULTIPLIED = 2;
+	const uint32_t SRGB = 4;
+
+	/**
+	 * Header at the start of every file
+	 */
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t endianTag;
+		uint32_t headerSize;
+		uint32_t width;
+		uint32_t height;
+		uint32_t channels;
+		uint32_t flags;
+
+		/**
+		 * Hash of the contents of the image and the options it was loaded with
+		 */
+		uint64_t key;
+
+		/**
+		 * Size of every level combined, in bytes
+		 */
+		uint64_t dataSize;
+		uint8_t reserved[16];
+	};
+
+	static_assert(sizeof(FileHeader) == 64, "Image file header must be 64 bytes");
+
+	/**
+	 * @return The flags describing the options an image is loaded with
+	 */
+	uint32_t getFlags(const ImageOptions& options)
+	{
+		return (options.flip ? FLIPPED : 0) | (options.premultiply ? PREMULTIPLIED : 0) | (options.srgb ? SRGB : 0);
+	}
+
+	/**
+	 * @return Milliseconds elapsed since the given time
+	 */
+	float getElapsed(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+ImageCache::ImageCache()
+{
+	std::error_code error;
+	std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+	if (!error)
+	{
+		_directory = (directory / "TitanForge" / "images").string();
+	}
+}
+
+ImageCache::~ImageCache()
+{
+
+}
+
+ImageCache* ImageCache::getInstance()
+{
+	if (!_INSTANCE)
+	{
+		_INSTANCE = std::unique_ptr<ImageCache>(new ImageCache());
+	}
+
+	return _INSTANCE.get();
+}
+
+std::unique_ptr<MipmappedImage> ImageCache::load(const std::string& path, const ImageOptions& options)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::unique_ptr<MappedFile> source;
+	try
+	{
+		source.reset(new MappedFile(resolvePath(path)));
+	}
+	catch (const InstantiationException&)
+	{
+		throw InstantiationException("Failed to load image: " + path);
+	}
+
+	// Key the image by its contents and the options affecting the cached pixels
+	uint64_t words[] = { checksum(source->data(), source->size()), getFlags(options), VERSION };
+	uint64_t key = checksum(words, sizeof(words));
+
+	std::string cachePath;
+	std::string temporaryPath;
+	{
+		std::lock_guard<std::mutex> lock(_MUTEX);
+		ImageCache* cache = getInstance();
+		if (!cache->_directory.empty())
+		{
+			std::ostringstream oss;
+			oss << std::hex << std::setw(16) << std::setfill('0') << key;
+			std::filesystem::path directory(cache->_directory);
+			cachePath = (directory / (oss.str() + EXTENSION)).string();
+			temporaryPath = cachePath + "." + std::to_string(cache->_numWrites++) + ".tmp";
+		}
+	}
+
+	if (!cachePath.empty())
+	{
+		std::unique_ptr<MipmappedImage> image = read(cachePath, key);
+		if (image)
+		{
+			std::lock_guard<std::mutex> lock(_MUTEX);
+			ImageCache* cache = getInstance();
+			cache->_stats.numHits++;
+			cache->_stats.loadTime += getElapsed(start);
+			return image;
+		}
+	}
+
+	// Decode the image, keeping an alpha channel only if the image has one. The flip is applied here, since the
+	// image loader's flip setting is shared by every thread. Overriding it for this thread keeps images flipped
+	// elsewhere from being flipped twice.
+	stbi_set_flip_vertically_on_load_thread(0);
+	const stbi_uc* data = reinterpret_cast<const stbi_uc*>(source->data());
+	int size = (int) source->size();
+	int width, height, channels;
+	stbi_uc* pixels = nullptr;
+	if (data && stbi_info_from_memory(data, size, &width, &height, &channels))
+	{
+		channels = channels == 2 || channels == 4 ? 4 : 3;
+		int fileChannels;
+		pixels = stbi_load_from_memory(data, size, &width, &height, &fileChannels, channels);
+	}
+	if (!pixels)
+	{
+		throw InstantiationException("Failed to load image: " + path);
+	}
+	source.reset();
+
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(width, height, channels);
+	std::vector<unsigned char> chain(levels.back().offset + levels.back().size);
+	size_t rowSize = (size_t) width * channels;
+	for (int y = 0; y < height; y++)
+	{
+		int sourceRow = options.flip ? height - 1 - y : y;
+		std::memcpy(chain.data() + y * rowSize, pixels + sourceRow * rowSize, rowSize);
+	}
+	stbi_image_free(pixels);
+
+	MipGenerator::generate(chain.data(), width, height, channels, options.srgb, options.premultiply);
+	std::unique_ptr<MipmappedImage> image(new MipmappedImage(width, height, channels, std::move(chain),
+		options.premultiply && channels == 4));
+	if (!cachePath.empty())
+	{
+		write(cachePath, temporaryPath, key, *image);
+	}
+
+	std::lock_guard<std::mutex> lock(_MUTEX);
+	ImageCache* cache = getInstance();
+	cache->_stats.numMisses++;
+	cache->_stats.decodeTime += getElapsed(start);
+	return image;
+}
+
+std::string ImageCache::getDirectory()
+{
+	std::lock_guard<std::mutex> lock(_MUTEX);
+	return getInstance()->_directory;
+}
+
+void ImageCache::setDirectory(const std::string& directory)
+{
+	std::lock_guard<std::mutex> lock(_MUTEX);
+	getInstance()->_directory = directory;
+}
+
+ImageCacheStats ImageCache::getStats()
+{
+	std::lock_guard<std::mutex> lock(_MUTEX);
+	return _INSTANCE ? _INSTANCE->_stats : ImageCacheStats();
+}
+
+void ImageCache::reset()
+{
+	std::lock_guard<std::mutex> lock(_MUTEX);
+	if (_INSTANCE)
+	{
+		_INSTANCE.reset();
+	}
+}
+
+std::unique_ptr<MipmappedImage> ImageCache::read(const std::string& path, unsigned long long key)
+{
+	std::unique_ptr<MappedFile> file;
+	try
+	{
+		file.reset(new MappedFile(path));
+	}
+	catch (const InstantiationException&)
+	{
+		return nullptr;
+	}
+
+	if (file->size() < sizeof(FileHeader))
+	{
+		return nullptr;
+	}
+
+	FileHeader header;
+	std::memcpy(&header, file->data(), sizeof(header));
+	if (header.magic != MAGIC || header.version != VERSION || header.endianTag != ENDIAN_TAG ||
+		header.headerSize != sizeof(FileHeader) || header.key != key || header.width == 0 || header.height == 0 ||
+		(header.channels != 3 && header.channels != 4))
+	{
+		return nullptr;
+	}
+
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(header.width, header.height, header.channels);
+	uint64_t dataSize = levels.back().offset + levels.back().size;
+	if (header.dataSize != dataSize || file->size() != sizeof(FileHeader) + dataSize)
+	{
+		return nullptr;
+	}
+
+	bool premultiplied = (header.flags & PREMULTIPLIED) != 0 && header.channels == 4;
+	return std::unique_ptr<MipmappedImage>(new MipmappedImage(header.width, header.height, header.channels,
+		premultiplied, std::move(file), sizeof(FileHeader)));
+}
+
+void ImageCache::write(const std::string& path, const std::string& temporaryPath, unsigned long long key,
+	const MipmappedImage& image)
+{
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.endianTag = ENDIAN_TAG;
+	header.headerSize = sizeof(FileHeader);
+	header.width = image.getWidth();
+	header.height = image.getHeight();
+	header.channels = image.getChannels();
+	header.flags = image.isPremultiplied() ? PREMULTIPLIED : 0;
+	header.key = key;
+	header.dataSize = image.getDataSize();
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+	{
+		std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(image.getData()), image.getDataSize());
+		if (!out)
+		{
+			out.close();
+			std::filesystem::remove(temporaryPath, error);
+			return;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+	}
+}
@@ -0,0 +1,246 @@
+#include <graphics/textures/MipGenerator.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Assertions.h>
+#include <common/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE
+#include <emmintrin.h>
+#endif
+
+const unsigned int MipGenerator::PARALLEL_THRESHOLD = 1 << 16;
+
+namespace
+{
+	/**
+	 * The number of rows of a level filtered by a single task
+	 */
+	const unsigned int BAND_ROWS = 16;
+
+	/**
+	 * Conversions between 8-bit sRGB encoded values and 16-bit linear values
+	 */
+	struct ConversionTables {
+		uint16_t toLinear[256];
+
+		/**
+		 * The nearest sRGB encoded value of every linear value
+		 */
+		uint8_t fromLinear[65536];
+
+		ConversionTables()
+		{
+			for (unsigned int i = 0; i < 256; i++)
+			{
+				double value = i / 255.0;
+				value = value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+				toLinear[i] = (uint16_t) std::lround(value * 65535.0);
+			}
+
+			// Linear values switch to the next encoded value halfway between the linear values of both
+			unsigned int encoded = 0;
+			for (unsigned int i = 0; i < 65536; i++)
+			{
+				while (encoded < 255 && 2 * i >= (unsigned int) toLinear[encoded] + toLinear[encoded + 1])
+				{
+					encoded++;
+				}
+				fromLinear[i] = (uint8_t) encoded;
+			}
+		}
+	};
+
+	const ConversionTables& getTables()
+	{
+		static const ConversionTables tables;
+		return tables;
+	}
+
+	/**
+	 * How each channel of a pixel is converted
+	 */
+	struct ChannelLayout {
+		unsigned int channels;
+
+		/**
+		 * Flags that, when true, indicate that a channel is sRGB encoded
+		 */
+		bool srgb[4];
+
+		/**
+		 * Index of the alpha channel, or -1 if there is none
+		 */
+		int alpha;
+
+		uint16_t decode(unsigned int channel, unsigned char value) const
+		{
+			return srgb[channel] ? getTables().toLinear[value] : (uint16_t) (value * 257);
+		}
+
+		unsigned char encode(unsigned int channel, unsigned int value) const
+		{
+			return srgb[channel] ? getTables().fromLinear[value] : (unsigned char) ((value * 255 + 32767) / 65535);
+		}
+	};
+
+	/**
+	 * Sums two rows of linear values
+	 */
+	void sumRows(const uint16_t* row0, const uint16_t* row1, size_t count, uint32_t* sums)
+	{
+		size_t i = 0;
+#ifdef MIP_GENERATOR_SSE
+		__m128i zero = _mm_setzero_si128();
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+			__m128i low = _mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpacklo_epi16(b, zero));
+			__m128i high = _mm_add_epi32(_mm_unpackhi_epi16(a, zero), _mm_unpackhi_epi16(b, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), low);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i + 4), high);
+		}
+#endif
+		for (; i < count; i++)
+		{
+			sums[i] = (uint32_t) row0[i] + row1[i];
+		}
+	}
+
+	/**
+	 * Averages horizontal pairs of pixels of a row of vertical sums, dropping the last column of odd widths
+	 */
+	void halveRow(const uint32_t* sums, unsigned int width, unsigned int targetWidth, unsigned int channels,
+		uint16_t* target)
+	{
+		for (unsigned int x = 0; x < targetWidth; x++)
+		{
+			const uint32_t* a = sums + (size_t) std::min(2 * x, width - 1) * channels;
+			const uint32_t* b = sums + (size_t) std::min(2 * x + 1, width - 1) * channels;
+#ifdef MIP_GENERATOR_SSE
+			if (channels == 4)
+			{
+				__m128i sum = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+				sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(2)), 2);
+
+				// SSE2 only packs with signed saturation, so averages are biased into the signed range and back
+				__m128i packed = _mm_packs_epi32(_mm_sub_epi32(sum, _mm_set1_epi32(32768)), _mm_setzero_si128());
+				packed = _mm_add_epi16(packed, _mm_set1_epi16(-32768));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(target + (size_t) x * 4), packed);
+				continue;
+			}
+#endif
+			for (unsigned int c = 0; c < channels; c++)
+			{
+				target[(size_t) x * channels + c] = (uint16_t) ((a[c] + b[c] + 2) >> 2);
+			}
+		}
+	}
+
+	/**
+	 * Encodes a row of linear values
+	 */
+	void encodeRow(const uint16_t* values, size_t count, const ChannelLayout& layout, unsigned char* pixels)
+	{
+		for (size_t i = 0; i < count; i += layout.channels)
+		{
+			for (unsigned int c = 0; c < layout.channels; c++)
+			{
+				pixels[i + c] = layout.encode(c, values[i + c]);
+			}
+		}
+	}
+}
+
+void MipGenerator::generate(unsigned char* pixels, unsigned int width, unsigned int height, unsigned int channels,
+	bool srgb, bool premultiply, unsigned int numThreads)
+{
+	assertTrue(width > 0 && height > 0, "Cannot generate the mip chain of an empty image");
+	assertTrue(channels >= 1 && channels <= 4, "Images must have between 1 and 4 channels");
+
+	ChannelLayout layout;
+	layout.channels = channels;
+	layout.alpha = channels == 2 || channels == 4 ? (int) channels - 1 : -1;
+	for (unsigned int c = 0; c < 4; c++)
+	{
+		layout.srgb[c] = srgb && (int) c != layout.alpha;
+	}
+	premultiply = premultiply && layout.alpha >= 0;
+
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(width, height, channels);
+	auto getNumThreads = [numThreads](const MipLevel& level)
+	{
+		return (unsigned long long) level.width * level.height > PARALLEL_THRESHOLD ? numThreads : 1;
+	};
+
+	// Convert the largest level to linear values, premultiplying them if requested
+	std::vector<uint16_t> source(levels[0].size);
+	parallelFor((height + BAND_ROWS - 1) / BAND_ROWS, getNumThreads(levels[0]), [&](unsigned int band)
+	{
+		size_t rowSize = (size_t) width * channels;
+		size_t start = (size_t) band * BAND_ROWS * rowSize;
+		size_t end = std::min((size_t) (band + 1) * BAND_ROWS, (size_t) height) * rowSize;
+		for (size_t i = start; i < end; i += channels)
+		{
+			for (unsigned int c = 0; c < channels; c++)
+			{
+				source[i + c] = layout.decode(c, pixels[i + c]);
+			}
+
+			if (premultiply)
+			{
+				uint32_t alpha = source[i + layout.alpha];
+				for (int c = 0; c < layout.alpha; c++)
+				{
+					source[i + c] = (uint16_t) ((source[i + c] * alpha + 32767) / 65535);
+				}
+			}
+		}
+
+		if (premultiply)
+		{
+			encodeRow(source.data() + start, end - start, layout, pixels + start);
+		}
+	});
+
+	// Filter every level from the previous one
+	std::vector<uint16_t> target;
+	for (size_t l = 1; l < levels.size(); l++)
+	{
+		const MipLevel& previous = levels[l - 1];
+		const MipLevel& level = levels[l];
+		target.resize(level.size);
+		parallelFor((level.height + BAND_ROWS - 1) / BAND_ROWS, getNumThreads(level), [&](unsigned int band)
+		{
+			size_t sourceRowSize = (size_t) previous.width * channels;
+			size_t rowSize = (size_t) level.width * channels;
+			std::vector<uint32_t> sums(sourceRowSize);
+			unsigned int end = std::min((band + 1) * BAND_ROWS, level.height);
+			for (unsigned int y = band * BAND_ROWS; y < end; y++)
+			{
+				const uint16_t* row0 = source.data() + std::min(2 * y, previous.height - 1) * sourceRowSize;
+				const uint16_t* row1 = source.data() + std::min(2 * y + 1, previous.height - 1) * sourceRowSize;
+				uint16_t* targetRow = target.data() + y * rowSize;
+				sumRows(row0, row1, sourceRowSize, sums.data());
+				halveRow(sums.data(), previous.width, level.width, channels, targetRow);
+				encodeRow(targetRow, rowSize, layout, pixels + level.offset + y * rowSize);
+			}
+		});
+		source.swap(target);
+	}
+}
+
+unsigned int MipGenerator::toLinear(unsigned char value)
+{
+	return getTables().toLinear[value];
+}
+
+unsigned char MipGenerator::fromLinear(unsigned int value)
+{
+	return getTables().fromLinear[std::min(value, 65535u)];
+}
@@ -0,0 +1,102 @@
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Assertions.h>
+#include <common/MappedFile.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+
+MipmappedImage::MipmappedImage(unsigned int width, unsigned int height, unsigned int channels,
+	std::vector<unsigned char> pixels, bool premultiplied)
+	: _width(width), _height(height), _channels(channels), _premultiplied(premultiplied), _pixels(std::move(pixels))
+{
+	assertTrue(width > 0 && height > 0 && channels > 0, "Mipmapped images must not be empty");
+	_levels = computeLevels(width, height, channels);
+	assertTrue(_pixels.size() == _levels.back().offset + _levels.back().size,
+		"Mipmapped image pixels must hold the full mip chain");
+	_data = _pixels.data();
+}
+
+MipmappedImage::MipmappedImage(unsigned int width, unsigned int height, unsigned int channels, bool premultiplied,
+	std::unique_ptr<MappedFile> file, size_t offset)
+	: _width(width), _height(height), _channels(channels), _premultiplied(premultiplied), _file(std::move(file))
+{
+	_levels = computeLevels(width, height, channels);
+	_data = reinterpret_cast<const unsigned char*>(_file->data()) + offset;
+}
+
+MipmappedImage::~MipmappedImage()
+{
+
+}
+
+std::vector<MipLevel> MipmappedImage::computeLevels(unsigned int width, unsigned int height, unsigned int channels)
+{
+	std::vector<MipLevel> levels;
+	size_t offset = 0;
+	while (true)
+	{
+		MipLevel level;
+		level.width = width;
+		level.height = height;
+		level.offset = offset;
+		level.size = (size_t) width * height * channels;
+		levels.push_back(level);
+		offset += level.size;
+
+		if (width == 1 && height == 1)
+		{
+			return levels;
+		}
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+}
+
+unsigned int MipmappedImage::getWidth() const
+{
+	return _width;
+}
+
+unsigned int MipmappedImage::getHeight() const
+{
+	return _height;
+}
+
+unsigned int MipmappedImage::getChannels() const
+{
+	return _channels;
+}
+
+bool MipmappedImage::isPremultiplied() const
+{
+	return _premultiplied;
+}
+
+unsigned int MipmappedImage::getNumLevels() const
+{
+	return (unsigned int) _levels.size();
+}
+
+const MipLevel& MipmappedImage::getLevel(unsigned int index) const
+{
+	if (index >= _levels.size())
+	{
+		throw OutOfBoundsException("Level index out of range");
+	}
+
+	return _levels[index];
+}
+
+const unsigned char* MipmappedImage::getLevelData(unsigned int index) const
+{
+	return _data + getLevel(index).offset;
+}
+
+const unsigned char* MipmappedImage::getData() const
+{
+	return _data;
+}
+
+size_t MipmappedImage::getDataSize() const
+{
+	return _levels.back().offset + _levels.back().size;
+}
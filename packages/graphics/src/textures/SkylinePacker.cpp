@@ -0,0 +1,132 @@
+#include <graphics/textures/SkylinePacker.h>
+#include <common/Assertions.h>
+#include <algorithm>
+#include <limits>
+
+SkylinePacker::SkylinePacker(unsigned int width, unsigned int height) : _width(width), _height(height)
+{
+	assertTrue(width > 0 && height > 0, "Packed area must not be empty");
+	clear();
+}
+
+bool SkylinePacker::pack(unsigned int width, unsigned int height, unsigned int& x, unsigned int& y)
+{
+	assertTrue(width > 0 && height > 0, "Packed rectangles must not be empty");
+
+	// Find the position whose top edge is lowest, preferring the narrowest segment to limit wasted space
+	unsigned int bestIndex = 0;
+	unsigned int bestTop = std::numeric_limits<unsigned int>::max();
+	unsigned int bestWidth = std::numeric_limits<unsigned int>::max();
+	unsigned int bestY = 0;
+	for (unsigned int i = 0; i < _skyline.size(); i++)
+	{
+		unsigned int top;
+		if (fit(i, width, height, top) && (top + height < bestTop ||
+			(top + height == bestTop && _skyline[i].width < bestWidth)))
+		{
+			bestIndex = i;
+			bestTop = top + height;
+			bestWidth = _skyline[i].width;
+			bestY = top;
+		}
+	}
+
+	if (bestTop == std::numeric_limits<unsigned int>::max())
+	{
+		return false;
+	}
+
+	x = _skyline[bestIndex].x;
+	y = bestY;
+
+	// Raise the skyline over the rectangle, shortening or removing the segments it covers
+	Segment segment = { x, bestTop, width };
+	_skyline.insert(_skyline.begin() + bestIndex, segment);
+	unsigned int right = x + width;
+	for (unsigned int i = bestIndex + 1; i < _skyline.size();)
+	{
+		Segment& next = _skyline[i];
+		if (next.x >= right)
+		{
+			break;
+		}
+
+		unsigned int shrink = std::min(right - next.x, next.width);
+		next.x += shrink;
+		next.width -= shrink;
+		if (next.width == 0)
+		{
+			_skyline.erase(_skyline.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	// Merge neighbouring segments of equal height
+	for (unsigned int i = 1; i < _skyline.size();)
+	{
+		if (_skyline[i - 1].y == _skyline[i].y)
+		{
+			_skyline[i - 1].width += _skyline[i].width;
+			_skyline.erase(_skyline.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	_usedArea += (unsigned long long) width * height;
+	return true;
+}
+
+void SkylinePacker::clear()
+{
+	_skyline.assign(1, { 0, 0, _width });
+	_usedArea = 0;
+}
+
+unsigned int SkylinePacker::getWidth() const
+{
+	return _width;
+}
+
+unsigned int SkylinePacker::getHeight() const
+{
+	return _height;
+}
+
+unsigned long long SkylinePacker::getUsedArea() const
+{
+	return _usedArea;
+}
+
+float SkylinePacker::getOccupancy() const
+{
+	return (float) ((double) _usedArea / ((double) _width * _height));
+}
+
+bool SkylinePacker::fit(unsigned int index, unsigned int width, unsigned int height, unsigned int& y) const
+{
+	unsigned int x = _skyline[index].x;
+	if (width > _width - x)
+	{
+		return false;
+	}
+
+	// Rest the rectangle on the highest segment it spans
+	y = 0;
+	unsigned int remaining = width;
+	for (unsigned int i = index; remaining > 0; i++)
+	{
+		y = std::max(y, _skyline[i].y);
+		if (height > _height - y)
+		{
+			return false;
+		}
+		remaining -= std::min(remaining, _skyline[i].width);
+	}
+	return true;
+}
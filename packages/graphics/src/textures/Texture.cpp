@@ -1,26 +1,45 @@
 #include <graphics/textures/Texture.h>
-#include <graphics/textures/ImageLoader.h>
+#include <graphics/textures/CompressedImage.h>
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Assertions.h>
 #include <common/exceptions/InstantiationException.h>
 #include <common/Utils.h>
 #include <glad/glad.h>
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 Texture::Texture(const std::string& path, bool flip)
 {
 	// Resolve image path
 	std::string fullPath = resolvePath(path);
 
-	// Load image
-	int width, height, channels;
-	stbi_set_flip_vertically_on_load(flip);
-	unsigned char* data = stbi_load(fullPath.c_str(), &width, &height, &channels, 0);
-	if (!data)
+	if (CompressedImage::isCompressedPath(path))
+	{
+		assertTrue(!flip, "Compressed images cannot be flipped");
+		uploadCompressed(CompressedImage(fullPath));
+		return;
+	}
+
+	// Load image along with its mip chain, decoding it only if it is not cached
+	ImageOptions options;
+	options.flip = flip;
+	std::unique_ptr<MipmappedImage> image;
+	try
+	{
+		image = ImageCache::load(path, options);
+	}
+	catch (const InstantiationException&)
 	{
 		std::ostringstream oss;
 		oss << "Failed to load texture image: " << path;
 		throw InstantiationException(oss.str());
 	}
 
+	_width = image->getWidth();
+	_height = image->getHeight();
+
 	// Create texture
 	glGenTextures(1, &_id);
 	glBindTexture(GL_TEXTURE_2D, _id);
@@ -30,18 +49,87 @@ Texture::Texture(const std::string& path, bool flip)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->getNumLevels() - 1);
+
+	// Load image data, every level of which is tightly packed
+	unsigned int glRgb = image->getChannels() == 4 ? GL_RGBA : GL_RGB;
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned int i = 0; i < image->getNumLevels(); i++)
+	{
+		const MipLevel& level = image->getLevel(i);
+		glTexImage2D(GL_TEXTURE_2D, i, glRgb, level.width, level.height, 0, glRgb, GL_UNSIGNED_BYTE,
+			image->getLevelData(i));
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	_memorySize = image->getDataSize();
+}
+
+Texture::Texture(unsigned int placeholderId) : _id(placeholderId), _status(TextureStatus::LOADING)
+{
+
+}
+
+Texture::Texture(unsigned int id, unsigned int width, unsigned int height, unsigned long long memorySize)
+	: _id(id), _width(width), _height(height), _memorySize(memorySize)
+{
+
+}
+
+void Texture::uploadCompressed(const CompressedImage& image)
+{
+	CompressedFormat format = image.getFormat();
+	bool supported = CompressedImage::isSupported(format);
+	if (!supported && !CompressedImage::isDecodable(format))
+	{
+		throw InstantiationException("Compressed image format is not supported by the GL context");
+	}
+
+	_width = image.getWidth();
+	_height = image.getHeight();
+
+	// Create texture, sampling only the levels present in the image
+	glGenTextures(1, &_id);
+	glBindTexture(GL_TEXTURE_2D, _id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.getNumLevels() - 1);
 
-	// Load image data
-	unsigned int glRgb = checkSuffix(path, ".png") ? GL_RGBA : GL_RGB;
-	glTexImage2D(GL_TEXTURE_2D, 0, glRgb, width, height, 0, glRgb, GL_UNSIGNED_BYTE, data);
-	glGenerateMipmap(GL_TEXTURE_2D);
+	if (supported)
+	{
+		unsigned int glFormat = CompressedImage::getGLFormat(format);
+		for (unsigned int i = 0; i < image.getNumLevels(); i++)
+		{
+			const CompressedLevel& level = image.getLevel(i);
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, glFormat, level.width, level.height, 0, (int) level.size,
+				image.getLevelData(i));
+		}
+		_compressed = true;
+		_memorySize = image.getDataSize();
+		return;
+	}
 
-	// Free the image data
-	stbi_image_free(data);
+	// Fall back to decoding every level on the CPU
+	std::vector<unsigned char> pixels;
+	for (unsigned int i = 0; i < image.getNumLevels(); i++)
+	{
+		const CompressedLevel& level = image.getLevel(i);
+		image.decode(i, pixels);
+		glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+			pixels.data());
+		_memorySize += pixels.size();
+	}
 }
 
 Texture::~Texture()
 {
+	// The placeholder is shared, and owned by the texture loader
+	if (_status != TextureStatus::READY)
+	{
+		return;
+	}
+
 	GLint boundId;
 	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundId);
 	if (boundId == _id)
@@ -62,4 +150,49 @@ TexturePtr Texture::create(const std::string& path, bool flip)
 unsigned int Texture::id() const
 {
 	return _id;
+}
+
+TextureStatus Texture::getStatus() const
+{
+	return _status;
+}
+
+const std::string& Texture::getError() const
+{
+	return _error;
+}
+
+unsigned int Texture::getWidth() const
+{
+	return _width;
+}
+
+unsigned int Texture::getHeight() const
+{
+	return _height;
+}
+
+bool Texture::isCompressed() const
+{
+	return _compressed;
+}
+
+unsigned long long Texture::getMemorySize() const
+{
+	return _memorySize;
+}
+
+unsigned long long Texture::computeMemorySize(unsigned int width, unsigned int height, unsigned int pixelSize)
+{
+	unsigned long long size = 0;
+	while (true)
+	{
+		size += (unsigned long long) width * height * pixelSize;
+		if (width == 1 && height == 1)
+		{
+			return size;
+		}
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <graphics/textures/TextureArray.h>
+#include <graphics/textures/Texture.h>
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/ImageOptions.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Assertions.h>
+#include <common/Utils.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <glad/glad.h>
+
+TextureArray::TextureArray(const std::vector<std::string>& paths, bool flip)
+{
+	assertTrue(!paths.empty(), "Texture arrays must hold at least one image");
+
+	ImageOptions options;
+	options.flip = flip;
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned int layer = 0; layer < paths.size(); layer++)
+	{
+		// Decode the image and generate its mip chain, unless the image cache already holds them
+		std::unique_ptr<MipmappedImage> image;
+		try
+		{
+			image = ImageCache::load(paths[layer], options);
+		}
+		catch (const InstantiationException&)
+		{
+			destroy();
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			throw InstantiationException("Failed to load texture array image: " + paths[layer]);
+		}
+
+		if (layer == 0)
+		{
+			_width = image->getWidth();
+			_height = image->getHeight();
+			_numLayers = (unsigned int) paths.size();
+
+			// Create texture array, storing every layer as RGBA so that they share a format
+			glGenTextures(1, &_id);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, _id);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, image->getNumLevels() - 1);
+			for (unsigned int i = 0; i < image->getNumLevels(); i++)
+			{
+				const MipLevel& level = image->getLevel(i);
+				glTexImage3D(GL_TEXTURE_2D_ARRAY, i, GL_RGBA, level.width, level.height, _numLayers, 0, GL_RGBA,
+					GL_UNSIGNED_BYTE, nullptr);
+			}
+		}
+		else if (image->getWidth() != _width || image->getHeight() != _height)
+		{
+			destroy();
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			throw IllegalArgumentException("Texture array images must all be the same size: " + paths[layer]);
+		}
+
+		// Upload the mip chain built on the CPU. Images without alpha are expanded to RGBA by the driver.
+		unsigned int format = image->getChannels() == 4 ? GL_RGBA : GL_RGB;
+		for (unsigned int i = 0; i < image->getNumLevels(); i++)
+		{
+			const MipLevel& level = image->getLevel(i);
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, i, 0, 0, layer, level.width, level.height, 1, format,
+				GL_UNSIGNED_BYTE, image->getLevelData(i));
+		}
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+TextureArray::~TextureArray()
+{
+	destroy();
+}
+
+TextureArrayPtr TextureArray::create(const std::vector<std::string>& paths, bool flip)
+{
+	return std::shared_ptr<TextureArray>(new TextureArray(paths, flip));
+}
+
+unsigned int TextureArray::id() const
+{
+	return _id;
+}
+
+unsigned int TextureArray::getWidth() const
+{
+	return _width;
+}
+
+unsigned int TextureArray::getHeight() const
+{
+	return _height;
+}
+
+unsigned int TextureArray::getNumLayers() const
+{
+	return _numLayers;
+}
+
+unsigned long long TextureArray::getMemorySize() const
+{
+	return Texture::computeMemorySize(_width, _height, 4) * _numLayers;
+}
+
+void TextureArray::destroy()
+{
+	if (_id == 0)
+	{
+		return;
+	}
+
+	GLint boundId;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &boundId);
+	if (boundId == (GLint) _id)
+	{
+		// Texture array is currently bound. Make sure to unbind it first.
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	}
+
+	glDeleteTextures(1, &_id);
+	_id = 0;
+}
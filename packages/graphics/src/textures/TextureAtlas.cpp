@@ -0,0 +1,180 @@
+#include <graphics/textures/TextureAtlas.h>
+#include <graphics/textures/Texture.h>
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/ImageOptions.h>
+#include <graphics/textures/MipGenerator.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <graphics/materials/Material.h>
+#include <common/Assertions.h>
+#include <common/Utils.h>
+#include <common/exceptions/IllegalStateException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+const unsigned int TextureAtlas::DEFAULT_PADDING = 2;
+
+TextureAtlas::TextureAtlas(unsigned int width, unsigned int height, unsigned int padding)
+	: _packer(width, height), _padding(padding), _levels(MipmappedImage::computeLevels(width, height, 4)),
+	_mipsGenerated(true)
+{
+	_pixels.resize(_levels.back().offset + _levels.back().size);
+
+	// Allocate every level, sampling only the largest one until the mip chain is generated
+	unsigned int id;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	for (unsigned int i = 0; i < _levels.size(); i++)
+	{
+		glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, _levels[i].width, _levels[i].height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+			nullptr);
+	}
+	_texture = TexturePtr(new Texture(id, width, height, Texture::computeMemorySize(width, height, 4)));
+}
+
+TextureAtlasPtr TextureAtlas::create(unsigned int width, unsigned int height, unsigned int padding)
+{
+	assertTrue(width > 0 && height > 0, "Texture atlas must not be empty");
+	return std::shared_ptr<TextureAtlas>(new TextureAtlas(width, height, padding));
+}
+
+AtlasRegion TextureAtlas::add(const std::string& path, bool flip)
+{
+	auto existing = _indices.find({ path, flip });
+	if (existing != _indices.end())
+	{
+		return _regions[existing->second];
+	}
+
+	// Load image, without generating its mip chain again if the image cache already holds it
+	ImageOptions options;
+	options.flip = flip;
+	std::unique_ptr<MipmappedImage> image;
+	try
+	{
+		image = ImageCache::load(path, options);
+	}
+	catch (const InstantiationException&)
+	{
+		throw InstantiationException("Failed to load texture atlas image: " + path);
+	}
+	int width = image->getWidth();
+	int height = image->getHeight();
+	unsigned int channels = image->getChannels();
+	const unsigned char* data = image->getLevelData(0);
+
+	// Place the image along with its border
+	unsigned int paddedWidth = width + 2 * _padding;
+	unsigned int paddedHeight = height + 2 * _padding;
+	unsigned int x, y;
+	if (paddedWidth > _packer.getWidth() || paddedHeight > _packer.getHeight() ||
+		!_packer.pack(paddedWidth, paddedHeight, x, y))
+	{
+		throw IllegalStateException("Texture atlas is too full to hold image: " + path);
+	}
+
+	// Copy the image into the largest level of the atlas, extending its edge pixels into its border and expanding
+	// images without alpha to RGBA
+	unsigned int atlasWidth = _packer.getWidth();
+	for (unsigned int row = 0; row < paddedHeight; row++)
+	{
+		int sourceRow = std::clamp((int) row - (int) _padding, 0, height - 1);
+		for (unsigned int column = 0; column < paddedWidth; column++)
+		{
+			int sourceColumn = std::clamp((int) column - (int) _padding, 0, width - 1);
+			unsigned char* pixel = &_pixels[((size_t) (y + row) * atlasWidth + x + column) * 4];
+			std::memcpy(pixel, data + ((size_t) sourceRow * width + sourceColumn) * channels, channels);
+			if (channels == 3)
+			{
+				pixel[3] = 255;
+			}
+		}
+	}
+
+	// Upload the largest level only. The rest of the mip chain is filtered once every image has been added.
+	glBindTexture(GL_TEXTURE_2D, _texture->id());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, atlasWidth);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+		&_pixels[((size_t) y * atlasWidth + x) * 4]);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	if (_mipsGenerated)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		_mipsGenerated = false;
+	}
+
+	AtlasRegion region;
+	region.x = x + _padding;
+	region.y = y + _padding;
+	region.width = width;
+	region.height = height;
+	region.uvOffset = Vector2(region.x / (float) _packer.getWidth(), region.y / (float) _packer.getHeight());
+	region.uvScale = Vector2(width / (float) _packer.getWidth(), height / (float) _packer.getHeight());
+
+	_indices[{ path, flip }] = (unsigned int) _regions.size();
+	_regions.push_back(region);
+	return _regions.back();
+}
+
+void TextureAtlas::generateMips()
+{
+	if (_mipsGenerated)
+	{
+		return;
+	}
+
+	// Atlas images are loaded sRGB encoded and without premultiplied alpha
+	ImageOptions options;
+	MipGenerator::generate(_pixels.data(), _packer.getWidth(), _packer.getHeight(), 4, options.srgb,
+		options.premultiply);
+
+	glBindTexture(GL_TEXTURE_2D, _texture->id());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned int i = 1; i < _levels.size(); i++)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, _levels[i].width, _levels[i].height, GL_RGBA, GL_UNSIGNED_BYTE,
+			&_pixels[_levels[i].offset]);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (int) _levels.size() - 1);
+	_mipsGenerated = true;
+}
+
+bool TextureAtlas::isMipsGenerated() const
+{
+	return _mipsGenerated;
+}
+
+void TextureAtlas::apply(MaterialPtr material, const AtlasRegion& region) const
+{
+	assertNotNull(material.get(), "Cannot apply a texture atlas to a null material");
+
+	material->texture = _texture;
+	material->uvOffset = region.uvOffset;
+	material->uvScale = region.uvScale;
+}
+
+TexturePtr TextureAtlas::getTexture() const
+{
+	return _texture;
+}
+
+const SkylinePacker& TextureAtlas::getPacker() const
+{
+	return _packer;
+}
+
+const std::vector<AtlasRegion>& TextureAtlas::getRegions() const
+{
+	return _regions;
+}
@@ -1,16 +1,82 @@
 #include <graphics/textures/TextureLoader.h>
 #include <graphics/textures/Texture.h>
+#include <graphics/textures/CompressedImage.h>
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Parallel.h>
+#include <common/Utils.h>
+#include <common/exceptions/InstantiationException.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	/**
+	 * @return The GL format of pixels with the given number of channels
+	 */
+	unsigned int getFormat(unsigned int channels)
+	{
+		return channels == 4 ? GL_RGBA : GL_RGB;
+	}
+}
+
+const unsigned int TextureLoader::DEFAULT_UPLOAD_BUDGET = 8 << 20;
+const unsigned long long TextureLoader::DEFAULT_MEMORY_BUDGET = 512ull << 20;
+const unsigned int TextureLoader::NUM_PIXEL_BUFFERS = 3;
 
 std::unique_ptr<TextureLoader> TextureLoader::_INSTANCE = nullptr;
 
-TextureLoader::TextureLoader()
+bool TextureLoader::TextureKey::operator==(const TextureKey& key) const
+{
+	return path == key.path && flip == key.flip;
+}
+
+std::size_t TextureLoader::TextureKey::Hash::operator()(const TextureKey& key) const noexcept
+{
+	return std::hash<std::string>{}(key.path) ^ (std::size_t) key.flip;
+}
+
+TextureLoader::TextureLoader() : _memoryBudget(DEFAULT_MEMORY_BUDGET), _uploadBudget(DEFAULT_UPLOAD_BUDGET)
 {
 
 }
 
 TextureLoader::~TextureLoader()
 {
-	_textures.clear();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_requested.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+
+	// Delete the textures whose upload started, but never finished
+	for (PendingTexture& pending : _uploads)
+	{
+		if (pending.id != 0)
+		{
+			glDeleteTextures(1, &pending.id);
+		}
+	}
+
+	if (!_pixelBuffers.empty())
+	{
+		glDeleteBuffers((int) _pixelBuffers.size(), _pixelBuffers.data());
+	}
+
+	if (_placeholderId != 0)
+	{
+		glDeleteTextures(1, &_placeholderId);
+	}
+
+	_index.clear();
+	_entries.clear();
 }
 
 TextureLoader* TextureLoader::getInstance()
@@ -26,22 +92,429 @@ TextureLoader* TextureLoader::getInstance()
 TexturePtr TextureLoader::load(const std::string& path, bool flip)
 {
 	TextureLoader* loader = getInstance();
+	TextureKey key = { path, flip };
+	TexturePtr texture = loader->find(key);
+	if (texture)
+	{
+		return texture;
+	}
+
+	texture = Texture::create(path, flip);
+	loader->insert(key, texture);
+	return texture;
+}
+
+TexturePtr TextureLoader::loadAsync(const std::string& path, bool flip)
+{
+	TextureLoader* loader = getInstance();
+	TextureKey key = { path, flip };
+	TexturePtr existing = loader->find(key);
+	if (existing)
+	{
+		return existing;
+	}
+
+	// Create the placeholder, a single opaque white pixel
+	if (loader->_placeholderId == 0)
+	{
+		const unsigned char white[] = { 255, 255, 255, 255 };
+		glGenTextures(1, &loader->_placeholderId);
+		glBindTexture(GL_TEXTURE_2D, loader->_placeholderId);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+	}
 
-	auto existing = loader->_textures.find(path);
-	if (existing != loader->_textures.end())
+	if (loader->_workers.empty())
 	{
-		return existing->second;
+		unsigned int numThreads = getHardwareConcurrency();
+		for (unsigned int i = 0; i < numThreads; i++)
+		{
+			loader->_workers.emplace_back(&TextureLoader::work, loader);
+		}
 	}
 
-	TexturePtr texture = Texture::create(path, flip);
-	loader->_textures[path] = texture;
+	TexturePtr texture(new Texture(loader->_placeholderId));
+	loader->insert(key, texture);
+
+	PendingTexture pending;
+	pending.texture = texture;
+	pending.path = path;
+	pending.flip = flip;
+	{
+		std::lock_guard<std::mutex> lock(loader->_mutex);
+		loader->_requests.push_back(std::move(pending));
+	}
+	loader->_requested.notify_one();
 	return texture;
 }
 
+void TextureLoader::update()
+{
+	TextureLoader* loader = getInstance();
+	loader->collectDecoded();
+	loader->upload(loader->_uploadBudget);
+}
+
+void TextureLoader::flush()
+{
+	TextureLoader* loader = getInstance();
+	{
+		std::unique_lock<std::mutex> lock(loader->_mutex);
+		loader->_finished.wait(lock, [loader]() { return loader->_requests.empty() && loader->_numDecoding == 0; });
+	}
+
+	loader->collectDecoded();
+	loader->upload(std::numeric_limits<unsigned long long>::max());
+}
+
+unsigned int TextureLoader::getNumPending()
+{
+	TextureLoader* loader = getInstance();
+	std::lock_guard<std::mutex> lock(loader->_mutex);
+	return (unsigned int) (loader->_requests.size() + loader->_numDecoding + loader->_decoded.size() +
+		loader->_uploads.size());
+}
+
+unsigned int TextureLoader::getUploadBudget()
+{
+	return getInstance()->_uploadBudget;
+}
+
+void TextureLoader::setUploadBudget(unsigned int budget)
+{
+	getInstance()->_uploadBudget = budget;
+}
+
+unsigned long long TextureLoader::getMemoryBudget()
+{
+	return getInstance()->_memoryBudget;
+}
+
+void TextureLoader::setMemoryBudget(unsigned long long budget)
+{
+	TextureLoader* loader = getInstance();
+	loader->_memoryBudget = budget;
+	loader->evict();
+}
+
+TextureLoaderStats TextureLoader::getStats()
+{
+	TextureLoaderStats stats;
+	if (!_INSTANCE)
+	{
+		return stats;
+	}
+
+	stats.numTextures = (unsigned int) _INSTANCE->_entries.size();
+	stats.numHits = _INSTANCE->_numHits;
+	stats.numMisses = _INSTANCE->_numMisses;
+	stats.numEvictions = _INSTANCE->_numEvictions;
+	stats.bytesResident = _INSTANCE->_bytesResident;
+
+	unsigned long long numLoads = stats.numHits + stats.numMisses;
+	if (numLoads > 0)
+	{
+		stats.hitRate = (float) ((double) stats.numHits / numLoads);
+		stats.missRate = (float) ((double) stats.numMisses / numLoads);
+	}
+
+	return stats;
+}
+
 void TextureLoader::reset()
 {
 	if (_INSTANCE)
 	{
 		_INSTANCE.reset();
 	}
-}
\ No newline at end of file
+}
+
+TexturePtr TextureLoader::find(const TextureKey& key)
+{
+	auto existing = _index.find(key);
+	if (existing == _index.end())
+	{
+		_numMisses++;
+		return nullptr;
+	}
+
+	_numHits++;
+	_entries.splice(_entries.begin(), _entries, existing->second);
+	return existing->second->texture;
+}
+
+void TextureLoader::insert(const TextureKey& key, const TexturePtr& texture)
+{
+	CacheEntry entry;
+	entry.key = key;
+	entry.texture = texture;
+	entry.memorySize = texture->getMemorySize();
+	_entries.push_front(std::move(entry));
+	_index[key] = _entries.begin();
+	_bytesResident += _entries.front().memorySize;
+	evict();
+}
+
+void TextureLoader::account(const PendingTexture& pending)
+{
+	// The texture may have been evicted, or replaced after a reset of the loader
+	auto existing = _index.find({ pending.path, pending.flip });
+	if (existing == _index.end() || existing->second->texture != pending.texture)
+	{
+		return;
+	}
+
+	CacheEntry& entry = *existing->second;
+	_bytesResident -= entry.memorySize;
+	entry.memorySize = entry.texture->getMemorySize();
+	_bytesResident += entry.memorySize;
+}
+
+void TextureLoader::evict()
+{
+	auto entry = _entries.end();
+	while (_bytesResident > _memoryBudget && entry != _entries.begin())
+	{
+		--entry;
+
+		// Textures referenced outside the cache, including those still loading, must remain cached
+		if (entry->texture.use_count() > 1)
+		{
+			continue;
+		}
+
+		_bytesResident -= entry->memorySize;
+		_numEvictions++;
+		_index.erase(entry->key);
+		entry = _entries.erase(entry);
+	}
+}
+
+void TextureLoader::work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_requested.wait(lock, [this]() { return _stopping || !_requests.empty(); });
+		if (_stopping)
+		{
+			return;
+		}
+
+		PendingTexture pending = std::move(_requests.front());
+		_requests.pop_front();
+		_numDecoding++;
+		lock.unlock();
+
+		if (CompressedImage::isCompressedPath(pending.path))
+		{
+			// Compressed images cannot be flipped, and fail to load instead
+			try
+			{
+				if (pending.flip)
+				{
+					pending.error = "Compressed images cannot be flipped";
+				}
+				else
+				{
+					pending.compressed.reset(new CompressedImage(resolvePath(pending.path)));
+				}
+			}
+			catch (const InstantiationException& e)
+			{
+				pending.error = e.what();
+			}
+		}
+		else
+		{
+			// Decode the image and generate its mip chain, unless the image cache already holds them
+			try
+			{
+				ImageOptions options;
+				options.flip = pending.flip;
+				pending.image = ImageCache::load(pending.path, options);
+			}
+			catch (const InstantiationException& e)
+			{
+				pending.error = e.what();
+			}
+		}
+
+		lock.lock();
+		_numDecoding--;
+		_decoded.push_back(std::move(pending));
+		_finished.notify_all();
+	}
+}
+
+void TextureLoader::collectDecoded()
+{
+	std::vector<PendingTexture> decoded;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		decoded = std::move(_decoded);
+		_decoded.clear();
+	}
+
+	for (PendingTexture& pending : decoded)
+	{
+		if (pending.image || pending.compressed)
+		{
+			_uploads.push_back(std::move(pending));
+		}
+		else
+		{
+			pending.texture->_status = TextureStatus::FAILED;
+			pending.texture->_error = pending.error;
+		}
+	}
+}
+
+void TextureLoader::upload(unsigned long long budget)
+{
+	if (_uploads.empty())
+	{
+		return;
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	bool uploaded = false;
+	while (!_uploads.empty())
+	{
+		PendingTexture& pending = _uploads.front();
+		if (pending.compressed)
+		{
+			// Compressed images are small enough to be uploaded whole
+			unsigned long long size = pending.compressed->getDataSize();
+			if (uploaded && size > budget)
+			{
+				break;
+			}
+
+			Texture& texture = *pending.texture;
+			try
+			{
+				texture.uploadCompressed(*pending.compressed);
+				texture._status = TextureStatus::READY;
+			}
+			catch (const InstantiationException& e)
+			{
+				texture._status = TextureStatus::FAILED;
+				texture._error = e.what();
+			}
+			account(pending);
+			budget -= std::min(budget, size);
+			uploaded = true;
+			_uploads.pop_front();
+			continue;
+		}
+
+		// Every level of the mip chain is streamed row by row, the same way as the largest level
+		const MipmappedImage& image = *pending.image;
+		const MipLevel& level = image.getLevel(pending.nextLevel);
+		unsigned long long rowSize = (unsigned long long) level.width * image.getChannels();
+		unsigned int numRows = (unsigned int) std::min<unsigned long long>(budget / rowSize,
+			level.height - pending.nextRow);
+		if (numRows == 0)
+		{
+			// Every update makes progress, however small its budget
+			if (uploaded)
+			{
+				break;
+			}
+			numRows = 1;
+		}
+
+		uploadRows(pending, numRows);
+		budget -= std::min(budget, numRows * rowSize);
+		uploaded = true;
+
+		if (pending.nextLevel == image.getNumLevels())
+		{
+			Texture& texture = *pending.texture;
+			texture._id = pending.id;
+			texture._width = image.getWidth();
+			texture._height = image.getHeight();
+			texture._memorySize = image.getDataSize();
+			texture._status = TextureStatus::READY;
+			account(pending);
+			_uploads.pop_front();
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	evict();
+}
+
+void TextureLoader::uploadRows(PendingTexture& pending, unsigned int numRows)
+{
+	const MipmappedImage& image = *pending.image;
+	unsigned int format = getFormat(image.getChannels());
+	if (pending.id == 0)
+	{
+		// Allocate the texture, using the same options as textures loaded synchronously
+		glGenTextures(1, &pending.id);
+		glBindTexture(GL_TEXTURE_2D, pending.id);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.getNumLevels() - 1);
+		for (unsigned int i = 0; i < image.getNumLevels(); i++)
+		{
+			const MipLevel& level = image.getLevel(i);
+			glTexImage2D(GL_TEXTURE_2D, i, format, level.width, level.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+		}
+	}
+	else
+	{
+		glBindTexture(GL_TEXTURE_2D, pending.id);
+	}
+
+	if (_pixelBuffers.empty())
+	{
+		_pixelBuffers.resize(NUM_PIXEL_BUFFERS);
+		glGenBuffers(NUM_PIXEL_BUFFERS, _pixelBuffers.data());
+	}
+
+	// Stage the rows in the next pixel buffer of the ring. Orphaning its storage lets the driver keep reading the
+	// previous contents while they are overwritten.
+	const MipLevel& level = image.getLevel(pending.nextLevel);
+	size_t rowSize = (size_t) level.width * image.getChannels();
+	size_t size = rowSize * numRows;
+	const unsigned char* rows = image.getLevelData(pending.nextLevel) + rowSize * pending.nextRow;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[_nextPixelBuffer]);
+	_nextPixelBuffer = (_nextPixelBuffer + 1) % NUM_PIXEL_BUFFERS;
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+	bool staged = false;
+	if (mapped)
+	{
+		std::memcpy(mapped, rows, size);
+		staged = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+	}
+
+	if (staged)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, pending.nextLevel, 0, pending.nextRow, level.width, numRows, format,
+			GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	else
+	{
+		// Fall back to uploading straight from the decoded pixels
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexSubImage2D(GL_TEXTURE_2D, pending.nextLevel, 0, pending.nextRow, level.width, numRows, format,
+			GL_UNSIGNED_BYTE, rows);
+	}
+
+	pending.nextRow += numRows;
+	if (pending.nextRow == level.height)
+	{
+		pending.nextLevel++;
+		pending.nextRow = 0;
+	}
+}
@@ -0,0 +1,420 @@
+#include <graphics/textures/TextureStreamer.h>
+#include <graphics/textures/Texture.h>
+#include <graphics/textures/CompressedImage.h>
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/Assertions.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	/**
+	 * @return The GL format of pixels with the given number of channels
+	 */
+	unsigned int getFormat(unsigned int channels)
+	{
+		return channels == 4 ? GL_RGBA : GL_RGB;
+	}
+
+	/**
+	 * @return The width or height of a level of a mip chain
+	 */
+	unsigned int getLevelSize(unsigned int size, unsigned int level)
+	{
+		return std::max(size >> level, 1u);
+	}
+}
+
+const unsigned int TextureStreamer::TAIL_SIZE = 64;
+const unsigned long long TextureStreamer::DEFAULT_MEMORY_BUDGET = 256ull << 20;
+const unsigned int TextureStreamer::DEFAULT_UPLOAD_BUDGET = 4 << 20;
+
+std::unique_ptr<TextureStreamer> TextureStreamer::_INSTANCE = nullptr;
+
+TextureStreamer::TextureStreamer() : _memoryBudget(DEFAULT_MEMORY_BUDGET), _uploadBudget(DEFAULT_UPLOAD_BUDGET)
+{
+
+}
+
+TextureStreamer::~TextureStreamer()
+{
+
+}
+
+TextureStreamer* TextureStreamer::getInstance()
+{
+	if (!_INSTANCE)
+	{
+		_INSTANCE = std::unique_ptr<TextureStreamer>(new TextureStreamer());
+	}
+
+	return _INSTANCE.get();
+}
+
+TexturePtr TextureStreamer::load(const std::string& path, bool flip)
+{
+	TextureStreamer* streamer = getInstance();
+	for (const StreamedTexture& streamed : streamer->_textures)
+	{
+		TexturePtr existing = streamed.texture.lock();
+		if (existing && streamed.path == path && streamed.flip == flip)
+		{
+			return existing;
+		}
+	}
+
+	// Compressed images hold their own mip chain
+	if (CompressedImage::isCompressedPath(path))
+	{
+		return Texture::create(path, flip);
+	}
+
+	// Load the image along with its mip chain, then find the tail
+	ImageOptions options;
+	options.flip = flip;
+	StreamedTexture streamed;
+	streamed.path = path;
+	streamed.flip = flip;
+	streamed.image = ImageCache::load(path, options);
+
+	const MipmappedImage& image = *streamed.image;
+	unsigned int width = image.getWidth();
+	unsigned int height = image.getHeight();
+	unsigned int numLevels = image.getNumLevels();
+	while (streamed.tailLevel + 1 < numLevels && std::max(getLevelSize(width, streamed.tailLevel),
+		getLevelSize(height, streamed.tailLevel)) > TAIL_SIZE)
+	{
+		streamed.tailLevel++;
+	}
+
+	// Create the texture, sampling only the levels of the tail
+	unsigned int id;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, streamed.tailLevel);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+
+	unsigned int format = getFormat(image.getChannels());
+	unsigned long long memorySize = 0;
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned int level = streamed.tailLevel; level < numLevels; level++)
+	{
+		const MipLevel& mipLevel = image.getLevel(level);
+		glTexImage2D(GL_TEXTURE_2D, level, format, mipLevel.width, mipLevel.height, 0, format, GL_UNSIGNED_BYTE,
+			image.getLevelData(level));
+		memorySize += mipLevel.size;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	TexturePtr texture(new Texture(id, width, height, memorySize));
+	streamed.texture = texture;
+	streamed.residentLevel = streamed.tailLevel;
+	streamed.requestedLevel = streamed.tailLevel;
+	streamer->_bytesResident += memorySize;
+	streamer->_indices[texture.get()] = (unsigned int) streamer->_textures.size();
+	streamer->_textures.push_back(std::move(streamed));
+	return texture;
+}
+
+void TextureStreamer::request(const TexturePtr& texture, float screenSize)
+{
+	if (!texture || !_INSTANCE)
+	{
+		return;
+	}
+
+	// Entries of destroyed textures may share the address of a new texture until they are pruned
+	auto index = _INSTANCE->_indices.find(texture.get());
+	if (index != _INSTANCE->_indices.end() && !_INSTANCE->_textures[index->second].texture.expired())
+	{
+		StreamedTexture& streamed = _INSTANCE->_textures[index->second];
+		streamed.screenSize = std::max(streamed.screenSize, screenSize);
+	}
+}
+
+void TextureStreamer::update()
+{
+	if (!_INSTANCE)
+	{
+		return;
+	}
+
+	TextureStreamer* streamer = _INSTANCE.get();
+	streamer->prune();
+
+	std::vector<TexturePtr> textures(streamer->_textures.size());
+	std::vector<unsigned int> refining;
+	for (unsigned int i = 0; i < streamer->_textures.size(); i++)
+	{
+		StreamedTexture& streamed = streamer->_textures[i];
+		textures[i] = streamed.texture.lock();
+		streamed.requestedLevel = streamed.screenSize > 0.f ? std::min(computeLevel(textures[i]->getWidth(),
+			textures[i]->getHeight(), streamed.screenSize), streamed.tailLevel) : streamed.tailLevel;
+		if (streamed.residentLevel > streamed.requestedLevel)
+		{
+			refining.push_back(i);
+		}
+	}
+
+	// Drop levels while over budget, starting with levels finer than requested, then the least requested textures
+	while (streamer->_bytesResident > streamer->_memoryBudget)
+	{
+		int victim = -1;
+		for (unsigned int i = 0; i < streamer->_textures.size(); i++)
+		{
+			const StreamedTexture& streamed = streamer->_textures[i];
+			if (streamed.residentLevel >= streamed.tailLevel)
+			{
+				continue;
+			}
+
+			if (victim < 0)
+			{
+				victim = i;
+				continue;
+			}
+
+			const StreamedTexture& other = streamer->_textures[victim];
+			bool excess = streamed.residentLevel < streamed.requestedLevel;
+			bool otherExcess = other.residentLevel < other.requestedLevel;
+			if (excess != otherExcess ? excess : streamed.screenSize < other.screenSize)
+			{
+				victim = i;
+			}
+		}
+
+		if (victim < 0)
+		{
+			break;
+		}
+		streamer->drop(streamer->_textures[victim], *textures[victim]);
+	}
+
+	// Refine the textures largest on screen first, one level at a time
+	std::sort(refining.begin(), refining.end(), [streamer](unsigned int a, unsigned int b)
+	{
+		return streamer->_textures[a].screenSize > streamer->_textures[b].screenSize;
+	});
+
+	unsigned long long uploaded = 0;
+	for (unsigned int i : refining)
+	{
+		StreamedTexture& streamed = streamer->_textures[i];
+		while (streamed.residentLevel > streamed.requestedLevel)
+		{
+			unsigned long long size = streamed.image->getLevel(streamed.residentLevel - 1).size;
+			if (uploaded > 0 && uploaded + size > streamer->_uploadBudget)
+			{
+				break;
+			}
+			if (!streamer->makeRoom(size, i))
+			{
+				break;
+			}
+
+			streamer->refine(streamed, *textures[i]);
+			uploaded += size;
+		}
+
+		if (uploaded >= streamer->_uploadBudget)
+		{
+			break;
+		}
+	}
+
+	for (StreamedTexture& streamed : streamer->_textures)
+	{
+		streamed.screenSize = 0.f;
+	}
+}
+
+bool TextureStreamer::isStreamed(const TexturePtr& texture)
+{
+	if (!texture || !_INSTANCE)
+	{
+		return false;
+	}
+
+	auto index = _INSTANCE->_indices.find(texture.get());
+	return index != _INSTANCE->_indices.end() && !_INSTANCE->_textures[index->second].texture.expired();
+}
+
+unsigned int TextureStreamer::getResidentLevel(const TexturePtr& texture)
+{
+	assertTrue(isStreamed(texture), "Texture is not streamed");
+	return _INSTANCE->_textures[_INSTANCE->_indices[texture.get()]].residentLevel;
+}
+
+unsigned int TextureStreamer::computeLevel(unsigned int width, unsigned int height, float screenSize)
+{
+	unsigned int size = std::max(width, height);
+	unsigned int coarsest = 0;
+	while (getLevelSize(size, coarsest) > 1)
+	{
+		coarsest++;
+	}
+
+	// Also handles infinite sizes, and sizes that are not a number
+	if (!(screenSize < size))
+	{
+		return 0;
+	}
+	if (screenSize <= 1.f)
+	{
+		return coarsest;
+	}
+
+	return std::min((unsigned int) std::floor(std::log2(size / screenSize)), coarsest);
+}
+
+unsigned long long TextureStreamer::getMemoryBudget()
+{
+	return getInstance()->_memoryBudget;
+}
+
+void TextureStreamer::setMemoryBudget(unsigned long long budget)
+{
+	getInstance()->_memoryBudget = budget;
+}
+
+unsigned int TextureStreamer::getUploadBudget()
+{
+	return getInstance()->_uploadBudget;
+}
+
+void TextureStreamer::setUploadBudget(unsigned int budget)
+{
+	getInstance()->_uploadBudget = budget;
+}
+
+TextureStreamerStats TextureStreamer::getStats()
+{
+	TextureStreamerStats stats;
+	if (!_INSTANCE)
+	{
+		return stats;
+	}
+
+	_INSTANCE->prune();
+	for (const StreamedTexture& streamed : _INSTANCE->_textures)
+	{
+		stats.numTextures++;
+		if (streamed.residentLevel > streamed.requestedLevel)
+		{
+			stats.numRefining++;
+		}
+	}
+	stats.bytesResident = _INSTANCE->_bytesResident;
+	stats.numUploads = _INSTANCE->_numUploads;
+	stats.numDrops = _INSTANCE->_numDrops;
+	return stats;
+}
+
+void TextureStreamer::reset()
+{
+	if (_INSTANCE)
+	{
+		_INSTANCE.reset();
+	}
+}
+
+void TextureStreamer::prune()
+{
+	// The GL textures of expired textures were deleted along with them
+	auto expired = std::remove_if(_textures.begin(), _textures.end(), [this](const StreamedTexture& streamed)
+	{
+		if (!streamed.texture.expired())
+		{
+			return false;
+		}
+
+		for (unsigned int level = streamed.residentLevel; level < streamed.image->getNumLevels(); level++)
+		{
+			_bytesResident -= streamed.image->getLevel(level).size;
+		}
+		return true;
+	});
+
+	if (expired == _textures.end())
+	{
+		return;
+	}
+
+	_textures.erase(expired, _textures.end());
+	_indices.clear();
+	for (unsigned int i = 0; i < _textures.size(); i++)
+	{
+		_indices[_textures[i].texture.lock().get()] = i;
+	}
+}
+
+void TextureStreamer::drop(StreamedTexture& streamed, Texture& texture)
+{
+	unsigned int level = streamed.residentLevel;
+	unsigned int format = getFormat(streamed.image->getChannels());
+	glBindTexture(GL_TEXTURE_2D, texture._id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+
+	// Respecifying the level without any pixels releases its memory
+	glTexImage2D(GL_TEXTURE_2D, level, format, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
+	unsigned long long size = streamed.image->getLevel(level).size;
+	texture._memorySize -= size;
+	_bytesResident -= size;
+	streamed.residentLevel++;
+	_numDrops++;
+}
+
+void TextureStreamer::refine(StreamedTexture& streamed, Texture& texture)
+{
+	unsigned int level = streamed.residentLevel - 1;
+	const MipLevel& mipLevel = streamed.image->getLevel(level);
+	unsigned int format = getFormat(streamed.image->getChannels());
+	glBindTexture(GL_TEXTURE_2D, texture._id);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, level, format, mipLevel.width, mipLevel.height, 0, format, GL_UNSIGNED_BYTE,
+		streamed.image->getLevelData(level));
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// Only sample the new level once it has been uploaded
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+
+	unsigned long long size = mipLevel.size;
+	texture._memorySize += size;
+	_bytesResident += size;
+	streamed.residentLevel = level;
+	_numUploads++;
+}
+
+bool TextureStreamer::makeRoom(unsigned long long size, unsigned int exclude)
+{
+	while (_bytesResident + size > _memoryBudget)
+	{
+		int victim = -1;
+		for (unsigned int i = 0; i < _textures.size(); i++)
+		{
+			const StreamedTexture& streamed = _textures[i];
+			if (i != exclude && streamed.residentLevel < streamed.requestedLevel &&
+				(victim < 0 || streamed.screenSize < _textures[victim].screenSize))
+			{
+				victim = i;
+			}
+		}
+
+		if (victim < 0)
+		{
+			return false;
+		}
+
+		TexturePtr texture = _textures[victim].texture.lock();
+		drop(_textures[victim], *texture);
+	}
+
+	return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <graphics/geometry/pointers/GeometryPtr.h>
+#include <string>
+#include <vector>
+
+/**
+ * The number of values of every vertex of the grids built by createGrid, holding a position followed by texture
+ * coordinates
+ */
+const unsigned int GRID_STRIDE = 5;
+
+/**
+ * Builds a path to a file in the temporary directory
+ * @param name Name of the file
+ * @return Path to the file
+ */
+std::string getTempPath(const std::string& name);
+
+/**
+ * Computes the height of the wave displacing the grids built by createGrid
+ * @param x X coordinate, between 0 and 1
+ * @param y Y coordinate, between 0 and 1
+ * @param amplitude Amplitude of the wave
+ * @return The z coordinate of the grid at the given point
+ */
+float getGridHeight(float x, float y, float amplitude);
+
+/**
+ * Builds a grid of (size + 1)^2 vertices over the unit square, displaced along z into a wave, holding positions
+ * followed by texture coordinates matching the xy position. When split, the columns right of the middle form a
+ * second texture chart, whose vertices are separate from the first and whose u coordinates are offset by 10.
+ * @param size The number of quads along each side of the grid
+ * @param amplitude Amplitude of the wave. The grid is flat when 0.
+ * @param split True if the grid should be split into two texture charts
+ * @param vertexData Output interleaved vertex data, GRID_STRIDE values per vertex
+ * @param indices Output triangle list, two counterclockwise triangles per quad
+ */
+void createGrid(unsigned int size, float amplitude, bool split, std::vector<float>& vertexData,
+	std::vector<unsigned int>& indices);
+
+/**
+ * Builds a geometry holding a grid, as described by createGrid
+ * @param size The number of quads along each side of the grid
+ * @param amplitude Amplitude of the wave. The grid is flat when 0.
+ * @return Geometry holding positions and texture coordinates
+ */
+GeometryPtr createGridGeometry(unsigned int size, float amplitude);
@@ -0,0 +1,59 @@
+#include <graphics_test/TestHelpers.h>
+#include <graphics/geometry/Geometry.h>
+#include <cmath>
+#include <filesystem>
+
+std::string getTempPath(const std::string& name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+float getGridHeight(float x, float y, float amplitude)
+{
+	return amplitude * std::sin(x * 6.f) * std::cos(y * 5.f);
+}
+
+void createGrid(unsigned int size, float amplitude, bool split, std::vector<float>& vertexData,
+	std::vector<unsigned int>& indices)
+{
+	vertexData.clear();
+	indices.clear();
+	unsigned int middle = size / 2;
+	unsigned int columns = split ? size + 2 : size + 1;
+	for (unsigned int y = 0; y <= size; y++)
+	{
+		for (unsigned int column = 0; column < columns; column++)
+		{
+			bool second = split && column > middle;
+			unsigned int x = second ? column - 1 : column;
+			float px = x / (float) size;
+			float py = y / (float) size;
+			vertexData.insert(vertexData.end(), { px, py, getGridHeight(px, py, amplitude),
+				px + (second ? 10.f : 0.f), py });
+		}
+	}
+
+	for (unsigned int y = 0; y < size; y++)
+	{
+		for (unsigned int x = 0; x < size; x++)
+		{
+			unsigned int column = split && x >= middle ? x + 1 : x;
+			unsigned int i = y * columns + column;
+			indices.insert(indices.end(), { i, i + 1, i + columns + 1, i, i + columns + 1, i + columns });
+		}
+	}
+}
+
+GeometryPtr createGridGeometry(unsigned int size, float amplitude)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(size, amplitude, false, vertexData, indices);
+
+	GeometryAttributes layout;
+	layout.uvs = true;
+	GeometryPtr geometry = Geometry::create();
+	geometry->setInterleavedVertices(layout, vertexData);
+	geometry->setIndices(indices.data(), (unsigned int) indices.size());
+	return geometry;
+}
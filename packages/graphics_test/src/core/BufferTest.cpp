@@ -1,6 +1,9 @@
 #include <boost/test/unit_test.hpp>
 #include <graphics/core/Buffer.h>
 #include <graphics/geometry/GeometryAttributes.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <vector>
 
 /**
  * Tests the ability to create and bind a buffer using only vertex positions
@@ -72,4 +75,73 @@ BOOST_AUTO_TEST_CASE(Buffer_withTextureCoords)
 
 	Buffer buffer(attrib, vertices, 15, indices, 3);
 	BOOST_REQUIRE_NO_THROW(buffer.bind());
-}
\ No newline at end of file
+}
+
+/**
+ * Tests the ability to overwrite ranges of a dynamic buffer in place
+ */
+BOOST_AUTO_TEST_CASE(Buffer_update)
+{
+	float vertices[] = {
+		-1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 0.f, 0.f
+	};
+	unsigned int indices[] = { 0, 1, 2 };
+	GeometryAttributes attrib;
+
+	Buffer buffer(attrib, vertices, 9, indices, 3, BufferUsage::DYNAMIC);
+	BOOST_TEST((buffer.getUsage() == BufferUsage::DYNAMIC));
+	BOOST_TEST(buffer.getNumVertices() == 3);
+
+	int baseVertex = buffer.getBaseVertex();
+	BOOST_REQUIRE_NO_THROW(buffer.updateVertices(vertices + 3, 1, 2));
+	BOOST_REQUIRE_NO_THROW(buffer.updateIndices(indices, 0, 3));
+	BOOST_TEST(buffer.getBaseVertex() == baseVertex);
+
+	BOOST_CHECK_THROW(buffer.updateVertices(vertices, 2, 2), OutOfBoundsException);
+	BOOST_CHECK_THROW(buffer.updateIndices(indices, 1, 3), OutOfBoundsException);
+}
+
+/**
+ * Tests that stream buffers rotate through their regions on every update
+ */
+BOOST_AUTO_TEST_CASE(Buffer_stream)
+{
+	float vertices[] = {
+		-1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 0.f, 0.f
+	};
+	unsigned int indices[] = { 0, 1, 2 };
+	GeometryAttributes attrib;
+
+	Buffer buffer(attrib, vertices, 9, indices, 3, BufferUsage::STREAM);
+	int baseVertex = buffer.getBaseVertex();
+	for (unsigned int i = 1; i <= Buffer::NUM_STREAM_REGIONS; i++)
+	{
+		BOOST_REQUIRE_NO_THROW(buffer.updateVertices(vertices, 0, 3));
+		BOOST_REQUIRE_NO_THROW(buffer.fence());
+		unsigned int region = i % Buffer::NUM_STREAM_REGIONS;
+		BOOST_TEST(buffer.getBaseVertex() == baseVertex + (int)(region * 3));
+	}
+
+	BOOST_CHECK_THROW(buffer.updateVertices(vertices, 1, 2), IllegalArgumentException);
+}
+/**
+ * Tests that small buffers store their indices as 16-bit values
+ */
+BOOST_AUTO_TEST_CASE(Buffer_indexType)
+{
+	std::vector<float> vertices((Buffer::MAX_SHORT_INDEX_VERTICES + 1) * 3, 0.f);
+	unsigned int indices[] = { 0, 1, Buffer::MAX_SHORT_INDEX_VERTICES };
+	GeometryAttributes attrib;
+
+	Buffer small(attrib, vertices.data(), 9, indices, 2);
+	BOOST_TEST(small.getIndexSize() == 2);
+	BOOST_TEST((unsigned long long) small.getIndexPointer() == small.getIndexOffset() * 2ull);
+
+	Buffer large(attrib, vertices.data(), (unsigned int) vertices.size(), indices, 3);
+	BOOST_TEST(large.getIndexSize() == 4);
+	BOOST_TEST(large.getIndexType() != small.getIndexType());
+}
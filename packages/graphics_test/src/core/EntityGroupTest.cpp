@@ -9,4 +9,21 @@ BOOST_AUTO_TEST_CASE(EntityGroup_basics)
 {
 	EntityGroupPtr group = EntityGroup::create();
 	BOOST_TEST(group->entityType == EntityType::GROUP);
+}
+
+/**
+ * Tests the ability to mark a group as static
+ */
+BOOST_AUTO_TEST_CASE(EntityGroup_static)
+{
+	EntityGroupPtr group = EntityGroup::create();
+	BOOST_TEST(!group->isStatic());
+	BOOST_TEST(group->getStaticBatch() == nullptr);
+
+	group->setStatic(true);
+	BOOST_TEST(group->isStatic());
+
+	group->setStatic(false);
+	BOOST_TEST(!group->isStatic());
+	BOOST_TEST(group->getStaticBatch() == nullptr);
 }
\ No newline at end of file
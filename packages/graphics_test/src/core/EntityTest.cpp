@@ -168,4 +168,30 @@ BOOST_AUTO_TEST_CASE(Entity_children)
 	BOOST_TEST(child->getParent() == &parent2);
 	BOOST_TEST(parent1.getNumberOfChildren() == 0);
 	BOOST_TEST(parent2.getNumberOfChildren() == 1);
+}
+
+/**
+ * Tests that the version of an entity is incremented whenever its transformation or children change
+ */
+BOOST_AUTO_TEST_CASE(Entity_version)
+{
+	TestEntity entity;
+	unsigned int version = entity.getVersion();
+
+	entity.setPosition(1.f, 2.f, 3.f);
+	BOOST_TEST(entity.getVersion() > version);
+	version = entity.getVersion();
+
+	entity.setScaling(2.f);
+	BOOST_TEST(entity.getVersion() > version);
+	version = entity.getVersion();
+
+	EntityPtr child = std::make_shared<TestEntity>();
+	entity.add(child);
+	BOOST_TEST(entity.getVersion() > version);
+	BOOST_TEST(entity.getChildren().size() == 1);
+	version = entity.getVersion();
+
+	entity.remove(child);
+	BOOST_TEST(entity.getVersion() > version);
 }
\ No newline at end of file
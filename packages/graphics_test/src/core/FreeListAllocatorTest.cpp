@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/FreeListAllocator.h>
+#include <common/exceptions/IllegalArgumentException.h>
+
+/**
+ * Tests the ability to allocate blocks until the address range is exhausted
+ */
+BOOST_AUTO_TEST_CASE(FreeListAllocator_allocate)
+{
+	FreeListAllocator allocator(100);
+	BOOST_TEST(allocator.getCapacity() == 100);
+	BOOST_TEST(allocator.getUsed() == 0);
+	BOOST_TEST(allocator.getLargestFreeBlock() == 100);
+
+	BOOST_TEST(allocator.allocate(40) == 0);
+	BOOST_TEST(allocator.allocate(40) == 40);
+	BOOST_TEST(allocator.getUsed() == 80);
+	BOOST_TEST(allocator.allocate(30) == FreeListAllocator::INVALID_OFFSET);
+	BOOST_TEST(allocator.allocate(0) == FreeListAllocator::INVALID_OFFSET);
+	BOOST_TEST(allocator.allocate(20) == 80);
+	BOOST_TEST(allocator.getNumFreeBlocks() == 0);
+}
+
+/**
+ * Tests that freed blocks are coalesced with their neighbors, and reused using best-fit allocation
+ */
+BOOST_AUTO_TEST_CASE(FreeListAllocator_free)
+{
+	FreeListAllocator allocator(100);
+	unsigned int a = allocator.allocate(10);
+	unsigned int b = allocator.allocate(30);
+	unsigned int c = allocator.allocate(10);
+	unsigned int d = allocator.allocate(50);
+
+	allocator.free(a, 10);
+	allocator.free(c, 10);
+	BOOST_TEST(allocator.getNumFreeBlocks() == 2);
+	BOOST_TEST(allocator.getUsed() == 80);
+
+	// Freeing the block between two free blocks merges all three
+	allocator.free(b, 30);
+	BOOST_TEST(allocator.getNumFreeBlocks() == 1);
+	BOOST_TEST(allocator.getLargestFreeBlock() == 50);
+
+	// Best fit prefers the exact-sized block over the front of a larger one
+	allocator.free(d, 50);
+	allocator.reset();
+	allocator.allocate(20);
+	unsigned int e = allocator.allocate(5);
+	allocator.allocate(20);
+	allocator.free(e, 5);
+	BOOST_TEST(allocator.allocate(5) == e);
+
+	BOOST_CHECK_THROW(allocator.free(95, 10), IllegalArgumentException);
+	BOOST_CHECK_THROW(allocator.free(50, 5), IllegalArgumentException);
+}
+
+/**
+ * Tests the ability to extend the address range of an allocator
+ */
+BOOST_AUTO_TEST_CASE(FreeListAllocator_grow)
+{
+	FreeListAllocator allocator(10);
+	allocator.allocate(6);
+	BOOST_TEST(allocator.allocate(8) == FreeListAllocator::INVALID_OFFSET);
+
+	allocator.grow(20);
+	BOOST_TEST(allocator.getCapacity() == 20);
+	BOOST_TEST(allocator.getUsed() == 6);
+	BOOST_TEST(allocator.getNumFreeBlocks() == 1);
+	BOOST_TEST(allocator.allocate(14) == 6);
+
+	BOOST_CHECK_THROW(allocator.grow(5), IllegalArgumentException);
+}
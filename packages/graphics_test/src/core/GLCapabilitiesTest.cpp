@@ -0,0 +1,27 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/GLCapabilities.h>
+
+/**
+ * Tests that versions are compared against the version of the current context
+ */
+BOOST_AUTO_TEST_CASE(GLCapabilities_hasVersion)
+{
+	GLCapabilities::reset();
+	BOOST_TEST(GLCapabilities::hasVersion(3, 3));
+	BOOST_TEST(GLCapabilities::hasVersion(1, 0));
+	BOOST_TEST(!GLCapabilities::hasVersion(99, 0));
+}
+
+/**
+ * Tests that only extensions exposed by the current context are found, including after a reset
+ */
+BOOST_AUTO_TEST_CASE(GLCapabilities_hasExtension)
+{
+	GLCapabilities::reset();
+	BOOST_TEST(!GLCapabilities::hasExtension("GL_TF_not_an_extension"));
+	BOOST_TEST(!GLCapabilities::hasExtension(""));
+
+	bool parallel = GLCapabilities::hasExtension("GL_KHR_parallel_shader_compile");
+	GLCapabilities::reset();
+	BOOST_TEST(GLCapabilities::hasExtension("GL_KHR_parallel_shader_compile") == parallel);
+}
@@ -0,0 +1,93 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/GeometryArena.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <memory>
+#include <vector>
+
+/**
+ * Tests that buffers sharing a vertex layout are sub-allocated from the same pool
+ */
+BOOST_AUTO_TEST_CASE(GeometryArena_allocate)
+{
+	float vertices[] = {
+		-1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 0.f, 0.f
+	};
+	unsigned int indices[] = { 0, 1, 2 };
+	GeometryAttributes attrib;
+
+	GeometryArenaStats before = GeometryArena::getStats();
+	{
+		Buffer buffer1(attrib, vertices, 9, indices, 3);
+		Buffer buffer2(attrib, vertices, 9, indices, 3);
+		BOOST_TEST(buffer2.getBaseVertex() != buffer1.getBaseVertex());
+		BOOST_TEST(buffer2.getIndexOffset() != buffer1.getIndexOffset());
+
+		GeometryArenaStats stats = GeometryArena::getStats();
+		BOOST_TEST(stats.numAllocations == before.numAllocations + 2);
+		BOOST_TEST(stats.vertexBytesUsed == before.vertexBytesUsed + 2 * 9 * sizeof(float));
+		BOOST_TEST(stats.indexBytesUsed == before.indexBytesUsed + 2 * 3 * sizeof(unsigned short));
+	}
+
+	GeometryArenaStats after = GeometryArena::getStats();
+	BOOST_TEST(after.numAllocations == before.numAllocations);
+	BOOST_TEST(after.vertexBytesUsed == before.vertexBytesUsed);
+}
+
+/**
+ * Tests that pools grow to hold allocations larger than their capacity
+ */
+BOOST_AUTO_TEST_CASE(GeometryArena_grow)
+{
+	GeometryAttributes attrib;
+	attrib.colors = true;
+	attrib.uvs = true;
+
+	unsigned int numVertices = GeometryArena::DEFAULT_VERTEX_CAPACITY + 1;
+	std::vector<float> vertices(numVertices * attrib.getStride(), 0.f);
+	std::vector<unsigned int> indices(numVertices, 0);
+
+	Buffer buffer(attrib, vertices.data(), (unsigned int) vertices.size(), indices.data(), numVertices);
+	GeometryArenaStats stats = GeometryArena::getStats();
+	BOOST_TEST(stats.vertexBytes >= vertices.size() * sizeof(float));
+}
+
+/**
+ * Tests that defragmentation packs live allocations together
+ */
+BOOST_AUTO_TEST_CASE(GeometryArena_defragment)
+{
+	float vertices[] = {
+		-1.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+		0.f, 1.f, 0.f, 0.f, 0.f, 1.f,
+		1.f, 0.f, 0.f, 0.f, 0.f, 1.f
+	};
+	unsigned int indices[] = { 0, 1, 2 };
+	GeometryAttributes attrib;
+	attrib.normals = true;
+
+	std::vector<std::unique_ptr<Buffer>> buffers;
+	for (int i = 0; i < 6; i++)
+	{
+		buffers.emplace_back(new Buffer(attrib, vertices, 18, indices, 3));
+	}
+
+	// Free every other buffer, leaving holes between the live ones
+	for (int i = 0; i < 6; i += 2)
+	{
+		buffers[i].reset();
+	}
+	BOOST_TEST(GeometryArena::getStats().numFreeBlocks > 2);
+
+	GeometryArena::defragment();
+	GeometryArenaStats stats = GeometryArena::getStats();
+	BOOST_TEST(stats.numFreeBlocks <= 2 * stats.numPools);
+
+	for (int i = 1; i < 6; i += 2)
+	{
+		BOOST_TEST(buffers[i]->getBaseVertex() < 9);
+		BOOST_TEST(buffers[i]->getIndexOffset() < 9);
+	}
+}
@@ -0,0 +1,92 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/GeometryRegistry.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <memory>
+
+namespace
+{
+	float VERTICES[] = {
+		-1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 0.f, 0.f
+	};
+	unsigned int INDICES[] = { 0, 1, 2 };
+}
+
+/**
+ * Tests that identical content is held by a single buffer
+ */
+BOOST_AUTO_TEST_CASE(GeometryRegistry_acquire)
+{
+	GeometryRegistry::reset();
+	GeometryAttributes attrib;
+
+	std::shared_ptr<Buffer> buffer1 = GeometryRegistry::acquire(attrib, VERTICES, 9, INDICES, 3);
+	std::shared_ptr<Buffer> buffer2 = GeometryRegistry::acquire(attrib, VERTICES, 9, INDICES, 3);
+	BOOST_TEST(buffer1 == buffer2);
+
+	unsigned int reversed[] = { 2, 1, 0 };
+	std::shared_ptr<Buffer> buffer3 = GeometryRegistry::acquire(attrib, VERTICES, 9, reversed, 3);
+	BOOST_TEST(buffer3 != buffer1);
+
+	GeometryRegistryStats stats = GeometryRegistry::getStats();
+	BOOST_TEST(stats.numBuffers == 2);
+	BOOST_TEST(stats.numReferences == 3);
+	BOOST_TEST(stats.bytesUsed == 2 * (9 * sizeof(float) + 3 * buffer1->getIndexSize()));
+	BOOST_TEST(stats.bytesSaved == 9 * sizeof(float) + 3 * buffer1->getIndexSize());
+
+	// Buffers are released once no longer referenced
+	buffer1.reset();
+	buffer2.reset();
+	BOOST_TEST(GeometryRegistry::getStats().numBuffers == 1);
+}
+
+/**
+ * Tests that the hash depends on every part of the content
+ */
+BOOST_AUTO_TEST_CASE(GeometryRegistry_hash)
+{
+	GeometryAttributes attrib;
+	unsigned long long hash = GeometryRegistry::hash(attrib, VERTICES, 9, INDICES, 3);
+	BOOST_TEST(hash == GeometryRegistry::hash(attrib, VERTICES, 9, INDICES, 3));
+	BOOST_TEST(hash != GeometryRegistry::hash(attrib, VERTICES, 6, INDICES, 3));
+	BOOST_TEST(hash != GeometryRegistry::hash(attrib, VERTICES, 9, INDICES, 2));
+
+	GeometryAttributes normals = { true, false, false };
+	BOOST_TEST(hash != GeometryRegistry::hash(normals, VERTICES, 9, INDICES, 3));
+
+	// Formats of absent attributes do not affect the buffer
+	GeometryAttributes halfNormals;
+	halfNormals.normalFormat = AttributeFormat::HALF_FLOAT;
+	BOOST_TEST(hash == GeometryRegistry::hash(halfNormals, VERTICES, 9, INDICES, 3));
+}
+
+/**
+ * Tests that geometries sharing a buffer acquire a new one when modified
+ */
+BOOST_AUTO_TEST_CASE(GeometryRegistry_copyOnWrite)
+{
+	GeometryPtr geometry1 = Geometry::create();
+	GeometryPtr geometry2 = Geometry::create();
+	geometry1->setVertices(VERTICES, 3);
+	geometry2->setVertices(VERTICES, 3);
+	geometry1->setBufferSharing(true);
+	geometry2->setBufferSharing(true);
+
+	Buffer* shared = geometry1->getBuffer();
+	BOOST_TEST(geometry2->getBuffer() == shared);
+	BOOST_TEST(geometry1->isBufferShared());
+
+	// Modifying one geometry leaves the other untouched
+	float moved[] = { 0.f, 2.f, 0.f };
+	geometry2->updateVertices(1, moved, 1);
+	BOOST_TEST(geometry2->getBuffer() != shared);
+	BOOST_TEST(geometry1->getBuffer() == shared);
+
+	// Only static geometry is shared
+	geometry1->setUsage(BufferUsage::DYNAMIC);
+	geometry1->getBuffer();
+	BOOST_TEST(!geometry1->isBufferShared());
+}
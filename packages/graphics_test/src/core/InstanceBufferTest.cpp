@@ -0,0 +1,33 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/InstanceBuffer.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/objects/InstanceData.h>
+#include <graphics/geometry/GeometryAttributes.h>
+
+/**
+ * Tests the ability to create, update, and attach an instance buffer
+ */
+BOOST_AUTO_TEST_CASE(InstanceBuffer_basics)
+{
+	float vertices[] = {
+		-1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 0.f, 0.f
+	};
+	unsigned int indices[] = { 0, 1, 2 };
+	Buffer buffer(GeometryAttributes(), vertices, 9, indices, 3);
+
+	InstanceData instances[3] = {};
+	InstanceBuffer instanceBuffer(instances, 3);
+	BOOST_TEST(instanceBuffer.capacity == 3);
+
+	instances[1].color[0] = 255;
+	BOOST_REQUIRE_NO_THROW(instanceBuffer.update(instances, 1, 1));
+
+	unsigned int visible[] = { 2, 0 };
+	BOOST_REQUIRE_NO_THROW(instanceBuffer.stream(instances, visible, 2));
+
+	buffer.bind();
+	BOOST_REQUIRE_NO_THROW(instanceBuffer.attach(true));
+	BOOST_REQUIRE_NO_THROW(instanceBuffer.detach());
+}
@@ -0,0 +1,118 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/LightClusters.h>
+#include <graphics/cameras/PerspectiveCamera.h>
+#include <graphics/lights/PointLight.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <algorithm>
+
+namespace
+{
+	/**
+	 * @return A point light at a position, with a range
+	 */
+	PointLightPtr createLight(float x, float y, float z, float range)
+	{
+		PointLightPtr light = PointLight::create();
+		light->setPosition(x, y, z);
+		light->range = range;
+		return light;
+	}
+
+	/**
+	 * @return True if a cluster references a light. Returns false otherwise.
+	 */
+	bool hasLight(const LightClusters& clusters, unsigned int x, unsigned int y, unsigned int z, unsigned int light)
+	{
+		std::vector<unsigned int> lights = clusters.getLights(x, y, z);
+		return std::find(lights.begin(), lights.end(), light) != lights.end();
+	}
+}
+
+/**
+ * Tests that lights are only binned into the clusters their range overlaps
+ */
+BOOST_AUTO_TEST_CASE(LightClusters_build)
+{
+	// Depth 10 with a range of 1 overlaps the slices 15 and 16, and the center tiles of the screen
+	CameraPtr camera = PerspectiveCamera::create(60.f, 16.f / 9.f, 0.1f, 100.f);
+	LightClusters clusters;
+	clusters.build({ createLight(0.f, 0.f, -10.f, 1.f) }, camera);
+
+	const unsigned int* dimensions = clusters.getDimensions();
+	BOOST_TEST(dimensions[0] == LightClusters::GRID_X);
+	BOOST_TEST(dimensions[1] == LightClusters::GRID_Y);
+	BOOST_TEST(dimensions[2] == LightClusters::GRID_Z);
+
+	BOOST_TEST(hasLight(clusters, 7, 4, 16, 0));
+	BOOST_TEST(hasLight(clusters, 8, 4, 15, 0));
+	BOOST_TEST(!hasLight(clusters, 0, 0, 16, 0));
+	BOOST_TEST(!hasLight(clusters, 7, 4, 0, 0));
+	BOOST_TEST(!hasLight(clusters, 7, 4, LightClusters::GRID_Z - 1, 0));
+
+	const LightClustersStats& stats = clusters.getStats();
+	BOOST_TEST(stats.numLights == 1u);
+	BOOST_TEST(stats.numCulled == 0u);
+	BOOST_TEST(stats.maxLightsPerCluster == 1u);
+	BOOST_TEST(stats.numReferences > 1u);
+}
+
+/**
+ * Tests that lights outside of the view frustum are not binned, while lights without a range reach every cluster
+ */
+BOOST_AUTO_TEST_CASE(LightClusters_buildCulled)
+{
+	CameraPtr camera = PerspectiveCamera::create(60.f, 16.f / 9.f, 0.1f, 100.f);
+	LightClusters clusters;
+	clusters.build({ createLight(0.f, 0.f, 10.f, 1.f), createLight(50.f, 0.f, -10.f, 1.f),
+		createLight(0.f, 0.f, 10.f, 0.f) }, camera);
+
+	BOOST_TEST(clusters.getStats().numCulled == 1u);
+	BOOST_TEST(clusters.getStats().numReferences ==
+		LightClusters::GRID_X * LightClusters::GRID_Y * LightClusters::GRID_Z);
+	BOOST_TEST(clusters.getLights(0, 0, 0) == std::vector<unsigned int>({ 2 }));
+	BOOST_TEST(clusters.getLights(7, 4, 16) == std::vector<unsigned int>({ 2 }));
+}
+
+/**
+ * Tests that binning many lights in parallel references every light in ascending order
+ */
+BOOST_AUTO_TEST_CASE(LightClusters_buildParallel)
+{
+	CameraPtr camera = PerspectiveCamera::create(60.f, 16.f / 9.f, 0.1f, 100.f);
+	std::vector<PointLightPtr> lights;
+	for (unsigned int i = 0; i < LightClusters::PARALLEL_THRESHOLD * 2; i++)
+	{
+		lights.push_back(createLight(0.f, 0.f, -10.f, 1.f));
+	}
+
+	LightClusters clusters;
+	clusters.build(lights, camera);
+	std::vector<unsigned int> found = clusters.getLights(7, 4, 16);
+	BOOST_TEST(found.size() == lights.size());
+	BOOST_TEST(std::is_sorted(found.begin(), found.end()));
+	BOOST_TEST(clusters.getStats().maxLightsPerCluster == lights.size());
+}
+
+/**
+ * Tests that cameras without a perspective projection use a single cluster holding every light
+ */
+BOOST_AUTO_TEST_CASE(LightClusters_buildWithoutPerspective)
+{
+	LightClusters clusters;
+	clusters.build({ createLight(0.f, 0.f, -10.f, 1.f), createLight(0.f, 0.f, 10.f, 1.f) }, nullptr);
+
+	const unsigned int* dimensions = clusters.getDimensions();
+	BOOST_TEST(dimensions[0] * dimensions[1] * dimensions[2] == 1u);
+	BOOST_TEST(clusters.getLights(0, 0, 0) == std::vector<unsigned int>({ 0, 1 }));
+}
+
+/**
+ * Tests that clusters outside of the grid are rejected
+ */
+BOOST_AUTO_TEST_CASE(LightClusters_getLightsOutOfBounds)
+{
+	LightClusters clusters;
+	clusters.build({}, PerspectiveCamera::create(60.f, 16.f / 9.f, 0.1f, 100.f));
+	BOOST_CHECK_THROW(clusters.getLights(LightClusters::GRID_X, 0, 0), OutOfBoundsException);
+	BOOST_CHECK_THROW(clusters.getLights(0, 0, LightClusters::GRID_Z), OutOfBoundsException);
+}
@@ -0,0 +1,100 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/LightIndex.h>
+#include <graphics/lights/PointLight.h>
+#include <math/Sphere.h>
+#include <math/Vector3.h>
+
+namespace
+{
+	/**
+	 * @return A point light at a position, with a range and intensity
+	 */
+	PointLightPtr createLight(float x, float y, float z, float range, float intensity = 1.f)
+	{
+		PointLightPtr light = PointLight::create();
+		light->setPosition(x, y, z);
+		light->range = range;
+		light->intensity = intensity;
+		return light;
+	}
+}
+
+/**
+ * Tests that influence falls off towards the range of a light, measured from the closest point of the bounds
+ */
+BOOST_AUTO_TEST_CASE(LightIndex_computeInfluence)
+{
+	PointLightPtr light = createLight(0.f, 0.f, 0.f, 10.f, 0.5f);
+	BOOST_TEST(LightIndex::computeInfluence(*light, Sphere(Vector3(0.f, 0.f, 0.f), 1.f)) == 0.5f);
+	BOOST_TEST(LightIndex::computeInfluence(*light, Sphere(Vector3(12.f, 0.f, 0.f), 3.f)) == 0.5f * 0.3439f * 0.3439f,
+		boost::test_tools::tolerance(1e-5f));
+	BOOST_TEST(LightIndex::computeInfluence(*light, Sphere(Vector3(20.f, 0.f, 0.f), 1.f)) == 0.f);
+
+	// Lights without a range never fall off
+	light->range = 0.f;
+	BOOST_TEST(LightIndex::computeInfluence(*light, Sphere(Vector3(1000.f, 0.f, 0.f), 1.f)) == 0.5f);
+}
+
+/**
+ * Tests that selections keep the most influential lights reaching the bounds, in order of decreasing influence
+ */
+BOOST_AUTO_TEST_CASE(LightIndex_select)
+{
+	LightIndex index;
+	index.build({ createLight(5.f, 0.f, 0.f, 10.f), createLight(1.f, 0.f, 0.f, 10.f),
+		createLight(100.f, 0.f, 0.f, 10.f), createLight(0.f, 0.f, 0.f, 0.f, 0.25f) });
+
+	std::vector<unsigned int> selection;
+	index.select(Sphere(Vector3(0.f, 0.f, 0.f), 0.5f), 8, selection);
+	BOOST_TEST(selection == std::vector<unsigned int>({ 1, 0, 3 }));
+
+	index.select(Sphere(Vector3(0.f, 0.f, 0.f), 0.5f), 2, selection);
+	BOOST_TEST(selection == std::vector<unsigned int>({ 1, 0 }));
+
+	index.select(Sphere(Vector3(100.f, 0.f, 0.f), 0.5f), 8, selection);
+	BOOST_TEST(selection == std::vector<unsigned int>({ 2, 3 }));
+
+	const LightIndexStats& stats = index.getStats();
+	BOOST_TEST(stats.numLights == 4u);
+	BOOST_TEST(stats.numGlobal == 1u);
+	BOOST_TEST(stats.numQueries == 3u);
+}
+
+/**
+ * Tests that selections only rank the lights near the bounds
+ */
+BOOST_AUTO_TEST_CASE(LightIndex_selectNearby)
+{
+	std::vector<PointLightPtr> lights;
+	for (unsigned int i = 0; i < 1000; i++)
+	{
+		lights.push_back(createLight(i * 10.f, 0.f, 0.f, 2.f));
+	}
+
+	LightIndex index(4.f);
+	index.build(lights);
+	BOOST_TEST(index.getCellSize() == 4.f);
+
+	std::vector<unsigned int> selection;
+	index.select(Sphere(Vector3(500.f, 0.f, 0.f), 1.f), 8, selection);
+	BOOST_TEST(selection == std::vector<unsigned int>({ 50 }));
+	BOOST_TEST(index.getStats().numCandidates < 4u);
+
+	// Bounds covering every light visit the non-empty cells rather than every cell they overlap
+	index.select(Sphere(Vector3(5000.f, 0.f, 0.f), 6000.f), 8, selection);
+	BOOST_TEST(selection.size() == 8u);
+}
+
+/**
+ * Tests that lights spanning many cells are candidates for every selection
+ */
+BOOST_AUTO_TEST_CASE(LightIndex_buildLargeLights)
+{
+	LightIndex index(1.f);
+	index.build({ createLight(0.f, 0.f, 0.f, 100.f), createLight(0.f, 0.f, 0.f, 0.4f) });
+	BOOST_TEST(index.getStats().numGlobal == 1u);
+
+	std::vector<unsigned int> selection;
+	index.select(Sphere(Vector3(50.f, 50.f, 0.f), 1.f), 8, selection);
+	BOOST_TEST(selection == std::vector<unsigned int>({ 0 }));
+}
@@ -0,0 +1,195 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/core/MeshStreamer.h>
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/cameras/PerspectiveCamera.h>
+#include <math/Frustum.h>
+#include <math/Vector3.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <set>
+#include <thread>
+
+namespace
+{
+	const unsigned int NUM_TILES = 32;
+	const unsigned int TILE_QUADS = 16;
+	const float TILE_SIZE = 10.f;
+	const float FOV = 60.f;
+
+	/**
+	 * Writes a rolling terrain of NUM_TILES x NUM_TILES clusters to a cluster file, one tile at a time, so that the
+	 * terrain as a whole is never held in memory
+	 */
+	std::string writeTerrain()
+	{
+		std::string path = getTempPath("MeshStreamerTest" + ClusterFile::EXTENSION);
+		ClusterFile::write(path, GeometryAttributes(), NUM_TILES * NUM_TILES, [](unsigned int index,
+			std::vector<float>& vertexData, std::vector<unsigned int>& indices)
+		{
+			float originX = (index % NUM_TILES) * TILE_SIZE;
+			float originZ = (index / NUM_TILES) * TILE_SIZE;
+			for (unsigned int z = 0; z <= TILE_QUADS; z++)
+			{
+				for (unsigned int x = 0; x <= TILE_QUADS; x++)
+				{
+					float px = originX + x * TILE_SIZE / TILE_QUADS;
+					float pz = originZ + z * TILE_SIZE / TILE_QUADS;
+					vertexData.insert(vertexData.end(), { px, std::sin(px * 0.1f) * std::cos(pz * 0.1f), pz });
+				}
+			}
+
+			for (unsigned int z = 0; z < TILE_QUADS; z++)
+			{
+				for (unsigned int x = 0; x < TILE_QUADS; x++)
+				{
+					unsigned int i = z * (TILE_QUADS + 1) + x;
+					indices.insert(indices.end(), { i, i + TILE_QUADS + 2, i + 1, i, i + TILE_QUADS + 1,
+						i + TILE_QUADS + 2 });
+				}
+			}
+		});
+		return path;
+	}
+}
+
+/**
+ * Tests the construction of a mesh streamer
+ */
+BOOST_AUTO_TEST_CASE(MeshStreamer_create)
+{
+	std::string path = writeTerrain();
+	MeshStreamerPtr streamer = MeshStreamer::create(path, 1 << 20, 2);
+	BOOST_TEST(streamer->getFile().getNumClusters() == NUM_TILES * NUM_TILES);
+	BOOST_TEST(streamer->getBudget() == 1u << 20);
+
+	// Slots hold the largest cluster, stored with 16-bit indices
+	unsigned int numVertices = (TILE_QUADS + 1) * (TILE_QUADS + 1);
+	unsigned int numIndices = TILE_QUADS * TILE_QUADS * 6;
+	BOOST_TEST(streamer->getSlotSize() == numVertices * 12u + numIndices * 2u);
+	BOOST_TEST(streamer->getNumSlots() == (1u << 20) / streamer->getSlotSize());
+	BOOST_TEST(streamer->getNumResident() == 0u);
+	BOOST_TEST(streamer->getNumPending() == 0u);
+	BOOST_TEST(streamer->getUsedBytes() == 0u);
+	BOOST_TEST(!streamer->isResident(0));
+	BOOST_CHECK_THROW(streamer->isResident(NUM_TILES * NUM_TILES), OutOfBoundsException);
+
+	BOOST_CHECK_THROW(MeshStreamer::create(path, streamer->getSlotSize() - 1), IllegalArgumentException);
+	BOOST_CHECK_THROW(MeshStreamer::create(getTempPath("MeshStreamerMissing" + ClusterFile::EXTENSION), 1 << 20),
+		InstantiationException);
+	BOOST_CHECK_THROW(streamer->update(Vector3(), 0.f), IllegalArgumentException);
+}
+
+/**
+ * Tests that residency follows a camera moving across a mesh many times larger than the memory budget, without
+ * ever exceeding the budget
+ */
+BOOST_AUTO_TEST_CASE(MeshStreamer_cameraPath)
+{
+	std::string path = writeTerrain();
+	unsigned long long slotSize = MeshStreamer::create(path, 1 << 20, 1)->getSlotSize();
+	unsigned long long budget = slotSize * 48 + slotSize / 2;
+	MeshStreamerPtr streamer = MeshStreamer::create(path, budget, 2);
+	BOOST_TEST(streamer->getNumSlots() == 48u);
+	BOOST_TEST(slotSize * NUM_TILES * NUM_TILES > 16 * budget);
+
+	std::set<unsigned int> loaded;
+	unsigned int numSteps = 40;
+	float extent = NUM_TILES * TILE_SIZE;
+	for (unsigned int step = 0; step <= numSteps; step++)
+	{
+		// Move diagonally across the terrain, a few meters above it
+		float t = step / (float) numSteps;
+		Vector3 camera(5.f + t * (extent - 10.f), 5.f, 5.f + t * (extent - 10.f) * 0.7f);
+		streamer->update(camera, FOV);
+		BOOST_TEST(streamer->getUsedBytes() <= budget);
+		BOOST_TEST(streamer->getNumResident() + streamer->getNumPending() <= streamer->getNumSlots());
+
+		streamer->flush();
+		BOOST_TEST(streamer->getUsedBytes() <= budget);
+		BOOST_TEST(streamer->getNumPending() == 0u);
+		BOOST_TEST(streamer->getNumResident() == streamer->getNumSlots());
+
+		// The tile below the camera and its neighbours are resident, and are the most important clusters
+		int tileX = (int) (camera.x / TILE_SIZE);
+		int tileZ = (int) (camera.z / TILE_SIZE);
+		for (int z = std::max(tileZ - 1, 0); z <= std::min(tileZ + 1, (int) NUM_TILES - 1); z++)
+		{
+			for (int x = std::max(tileX - 1, 0); x <= std::min(tileX + 1, (int) NUM_TILES - 1); x++)
+			{
+				BOOST_TEST(streamer->isResident(z * NUM_TILES + x));
+			}
+		}
+
+		// Every resident cluster covers at least as much of the screen as any cluster left out
+		float minResident = 1e30f;
+		float maxMissing = 0.f;
+		for (unsigned int i = 0; i < NUM_TILES * NUM_TILES; i++)
+		{
+			if (streamer->isResident(i))
+			{
+				minResident = std::min(minResident, streamer->getCoverage(i));
+				loaded.insert(i);
+			}
+			else
+			{
+				maxMissing = std::max(maxMissing, streamer->getCoverage(i));
+			}
+		}
+		BOOST_TEST(minResident >= maxMissing);
+	}
+
+	// Clusters were paged in and out along the way
+	BOOST_TEST(loaded.size() > 4 * streamer->getNumSlots());
+
+	// Clusters too small on screen are evicted
+	streamer->minCoverage = 1.f;
+	streamer->update(Vector3(extent / 2.f, 5.f, extent / 2.f), FOV);
+	BOOST_TEST(streamer->getNumResident() <= 9u);
+}
+
+/**
+ * Tests streaming while the camera keeps moving, without waiting for loads to finish
+ */
+BOOST_AUTO_TEST_CASE(MeshStreamer_asynchronous)
+{
+	std::string path = writeTerrain();
+	MeshStreamerPtr streamer = MeshStreamer::create(path, 1 << 20, 0);
+	streamer->maxUploads = 4;
+
+	unsigned int maxResident = 0;
+	float extent = NUM_TILES * TILE_SIZE;
+	for (unsigned int frame = 0; frame < 200; frame++)
+	{
+		unsigned int numResident = streamer->getNumResident();
+		float t = frame / 200.f;
+		streamer->update(Vector3(extent * t, 20.f, extent * (1.f - t)), FOV);
+		BOOST_TEST(streamer->getUsedBytes() <= streamer->getBudget());
+		BOOST_TEST(streamer->getNumResident() <= numResident + streamer->maxUploads);
+		maxResident = std::max(maxResident, streamer->getNumResident());
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+	}
+	BOOST_TEST(maxResident > 0u);
+
+	// Culling collects the resident clusters within the view of the camera
+	streamer->flush();
+	PerspectiveCameraPtr camera = PerspectiveCamera::create(FOV, 1.f, 0.1f, 1000.f);
+	camera->lookAt(Vector3(0.f, 20.f, extent), Vector3(extent / 2.f, 0.f, extent / 2.f), Vector3(0.f, 1.f, 0.f));
+	Frustum frustum = Frustum::fromMatrix(camera->getProjectionMatrix().multiply(camera->getViewMatrix()));
+	unsigned int numVisible = streamer->cull(frustum, Matrix4::IDENTITY);
+	BOOST_TEST(numVisible > 0u);
+	BOOST_TEST(numVisible <= streamer->getNumResident());
+	BOOST_TEST(streamer->getVisibleCounts().size() == numVisible);
+	BOOST_TEST(streamer->getVisibleOffsets().size() == numVisible);
+	BOOST_TEST(streamer->getVisibleBaseVertices().size() == numVisible);
+	BOOST_TEST(streamer->getVisibleCounts()[0] == (int) (TILE_QUADS * TILE_QUADS * 6));
+
+	camera->lookAt(Vector3(0.f, 20.f, extent), Vector3(-extent, 0.f, 2.f * extent), Vector3(0.f, 1.f, 0.f));
+	frustum = Frustum::fromMatrix(camera->getProjectionMatrix().multiply(camera->getViewMatrix()));
+	BOOST_TEST(streamer->cull(frustum, Matrix4::IDENTITY) == 0u);
+}
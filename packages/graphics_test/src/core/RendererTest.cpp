@@ -7,9 +7,18 @@
 #include <graphics/geometry/BoxGeometry.h>
 #include <graphics/materials/BasicMaterial.h>
 #include <graphics/objects/Mesh.h>
+#include <graphics/lights/PointLight.h>
+#include <graphics/objects/InstancedMesh.h>
+#include <graphics/objects/LODMesh.h>
+#include <graphics/objects/StreamedMesh.h>
+#include <graphics/core/MeshStreamer.h>
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/core/StaticBatch.h>
 #include <common/PrintHelpers.h>
 #include <thread>
 #include <chrono>
+#include <filesystem>
 
 /**
  * Tests the ability to get the current renderer time
@@ -86,4 +95,147 @@ BOOST_AUTO_TEST_CASE(Renderer_render)
 	// Render
 	RendererPtr renderer = GlobalTestFixture::RENDERER;
 	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
-}
\ No newline at end of file
+}
+
+/**
+ * Tests the ability to render many point lights, both clustered and selected per object
+ */
+BOOST_AUTO_TEST_CASE(Renderer_renderLights)
+{
+	ScenePtr scene = Scene::create();
+	CameraPtr camera = PerspectiveCamera::create(30.f, 800.f / 600.f, 0.1f, 100.f);
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		MeshPtr mesh = Mesh::create(BoxGeometry::create(1.f, 1.f, 1.f), BasicMaterial::create());
+		mesh->setPosition(i * 2.f - 10.f, 0.f, -20.f);
+		scene->add(mesh);
+	}
+	for (unsigned int i = 0; i < 1000; i++)
+	{
+		PointLightPtr light = PointLight::create();
+		light->setPosition((i % 40) - 20.f, (i / 40) * 0.5f - 6.f, -18.f);
+		light->range = 3.f;
+		scene->add(light);
+	}
+
+	RendererPtr renderer = GlobalTestFixture::RENDERER;
+	BOOST_TEST((renderer->getLightingMode() == LightingMode::CLUSTERED));
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+
+	renderer->setLightingMode(LightingMode::PER_OBJECT);
+	BOOST_TEST((renderer->getLightingMode() == LightingMode::PER_OBJECT));
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	renderer->setLightingMode(LightingMode::CLUSTERED);
+}
+
+/**
+ * Tests the ability to render an instanced mesh, with some instances outside of the camera view
+ */
+BOOST_AUTO_TEST_CASE(Renderer_renderInstanced)
+{
+	ScenePtr scene = Scene::create();
+	CameraPtr camera = PerspectiveCamera::create(30.f, 800.f / 600.f, 0.1f, 100.f);
+
+	InstancedMeshPtr mesh = InstancedMesh::create(BoxGeometry::create(1.f, 1.f, 1.f), BasicMaterial::create(), 100);
+	for (unsigned int i = 0; i < mesh->getCount(); i++)
+	{
+		mesh->setTransform(i, Matrix4::fromTranslation(Vector3(i * 2.f - 100.f, 0.f, -20.f)));
+	}
+	scene->add(mesh);
+
+	RendererPtr renderer = GlobalTestFixture::RENDERER;
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+
+	// Partial update
+	mesh->setColor(50, Color::RED);
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+}
+
+/**
+ * Tests the ability to render a static group as a batch
+ */
+BOOST_AUTO_TEST_CASE(Renderer_renderStatic)
+{
+	ScenePtr scene = Scene::create();
+	CameraPtr camera = PerspectiveCamera::create(30.f, 800.f / 600.f, 0.1f, 100.f);
+
+	EntityGroupPtr group = EntityGroup::create();
+	group->setStatic(true);
+	GeometryPtr geometry = BoxGeometry::create(1.f, 1.f, 1.f);
+	MaterialPtr material = BasicMaterial::create();
+	for (int i = 0; i < 20; i++)
+	{
+		MeshPtr mesh = Mesh::create(geometry, material);
+		mesh->setPosition(i * 2.f - 20.f, 0.f, -20.f);
+		group->add(mesh);
+	}
+	scene->add(group);
+
+	RendererPtr renderer = GlobalTestFixture::RENDERER;
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	StaticBatchPtr batch = group->getStaticBatch();
+	BOOST_REQUIRE(batch != nullptr);
+	BOOST_TEST(batch->getStats().numMeshes == 20);
+
+	// Batch is reused while the group is unchanged, and rebuilt once it changes
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	BOOST_TEST(group->getStaticBatch() == batch);
+
+	group->add(Mesh::create(geometry, material));
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	BOOST_TEST(group->getStaticBatch() != batch);
+	BOOST_TEST(group->getStaticBatch()->getStats().numMeshes == 21);
+}
+/**
+ * Tests the ability to render meshes with several levels of detail, selected by distance and bias
+ */
+BOOST_AUTO_TEST_CASE(Renderer_renderLOD)
+{
+	ScenePtr scene = Scene::create();
+	CameraPtr camera = PerspectiveCamera::create(30.f, 800.f / 600.f, 0.1f, 100.f);
+
+	std::vector<GeometryPtr> levels = { BoxGeometry::create(1.f, 1.f, 1.f), BoxGeometry::create(1.f, 1.f, 1.f) };
+	LODMeshPtr nearMesh = LODMesh::create(levels, { 0.1f }, BasicMaterial::create());
+	nearMesh->setPosition(0.f, 0.f, -3.f);
+	LODMeshPtr farMesh = LODMesh::create(levels, { 0.1f }, BasicMaterial::create());
+	farMesh->setPosition(0.f, 0.f, -80.f);
+	farMesh->crossFade = true;
+	scene->add(nearMesh);
+	scene->add(farMesh);
+
+	RendererPtr renderer = GlobalTestFixture::RENDERER;
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	BOOST_TEST(nearMesh->getCurrentLevel() == 0u);
+	BOOST_TEST(farMesh->getCurrentLevel() == 1u);
+
+	// A large bias selects coarser levels, cross-fading where enabled
+	renderer->setLODBias(4.f);
+	BOOST_TEST(renderer->getLODBias() == 4.f);
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	BOOST_TEST(nearMesh->getCurrentLevel() == 1u);
+	renderer->setLODBias(0.f);
+}
+
+/**
+ * Tests rendering a streamed mesh, whose clusters become visible once they are resident
+ */
+BOOST_AUTO_TEST_CASE(Renderer_renderStreamed)
+{
+	ScenePtr scene = Scene::create();
+	CameraPtr camera = PerspectiveCamera::create(30.f, 800.f / 600.f, 0.1f, 100.f);
+
+	std::string path = (std::filesystem::temp_directory_path() / ("RendererTest" + ClusterFile::EXTENSION)).string();
+	ClusterFile::write(path, BoxGeometry::create(1.f, 1.f, 1.f), 4);
+	MeshStreamerPtr streamer = MeshStreamer::create(path, 1 << 16, 1);
+	StreamedMeshPtr mesh = StreamedMesh::create(streamer, BasicMaterial::create());
+	mesh->setPosition(0.f, 0.f, -3.f);
+	scene->add(mesh);
+
+	RendererPtr renderer = GlobalTestFixture::RENDERER;
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	streamer->flush();
+	BOOST_TEST(streamer->getNumResident() == streamer->getFile().getNumClusters());
+	BOOST_REQUIRE_NO_THROW((renderer->render(scene, camera)));
+	BOOST_TEST(streamer->getVisibleCounts().size() > 0u);
+}
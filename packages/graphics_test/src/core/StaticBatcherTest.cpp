@@ -0,0 +1,169 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/StaticBatcher.h>
+#include <graphics/core/StaticBatch.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/core/Buffer.h>
+#include <graphics/geometry/BoxGeometry.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <graphics/objects/Mesh.h>
+#include <math/Frustum.h>
+#include <math/Matrix4.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/PrintHelpers.h>
+
+/**
+ * Tests the ability to merge the meshes of a static group into buckets and chunks
+ */
+BOOST_AUTO_TEST_CASE(StaticBatcher_build)
+{
+	EntityGroupPtr group = EntityGroup::create();
+	BOOST_CHECK_THROW(StaticBatcher::build(group), IllegalArgumentException);
+	group->setStatic(true);
+
+	GeometryPtr geometry = BoxGeometry::create(1.f, 1.f, 1.f);
+	MaterialPtr material1 = BasicMaterial::create();
+	MaterialPtr material2 = BasicMaterial::create();
+	material2->color = Color::RED;
+
+	// Two meshes in the same cell, one far away, and one with a different material
+	MeshPtr mesh1 = Mesh::create(geometry, material1);
+	MeshPtr mesh2 = Mesh::create(geometry, material1);
+	mesh2->setPosition(2.f, 0.f, 0.f);
+	MeshPtr mesh3 = Mesh::create(geometry, material1);
+	mesh3->setPosition(100.f, 0.f, 0.f);
+	MeshPtr mesh4 = Mesh::create(geometry, material2);
+	group->add(mesh1);
+	group->add(mesh2);
+	group->add(mesh3);
+	group->add(mesh4);
+
+	StaticBatchPtr batch = StaticBatcher::build(group, 10.f);
+	BOOST_TEST(group->getStaticBatch() == batch);
+	BOOST_TEST(batch->getChunkSize() == 10.f);
+	BOOST_TEST(!batch->isStale());
+
+	const StaticBatchStats& stats = batch->getStats();
+	BOOST_TEST(stats.numMeshes == 4);
+	BOOST_TEST(stats.numBuckets == 2);
+	BOOST_TEST(stats.numChunks == 3);
+	BOOST_TEST(stats.numVertices == 4 * geometry->getNumVertices());
+	BOOST_TEST(stats.numIndices == 4 * geometry->size());
+	BOOST_TEST(stats.buildTime >= 0.f);
+
+	const std::vector<StaticBatchBucket>& buckets = batch->getBuckets();
+	BOOST_TEST(buckets[0].material == material1);
+	BOOST_TEST(buckets[0].chunks.size() == 2);
+	BOOST_TEST(buckets[0].buffer->size == 3 * geometry->size());
+	BOOST_TEST(buckets[1].material == material2);
+
+	const StaticBatchChunk& chunk = buckets[0].chunks[0];
+	BOOST_TEST(chunk.numIndices == 2 * geometry->size());
+	BOOST_TEST(chunk.bounds.containsPoint(Vector3(2.5f, 0.5f, 0.5f)));
+	BOOST_TEST(!chunk.bounds.containsPoint(Vector3(100.f, 0.f, 0.f)));
+}
+
+/**
+ * Tests the ability to cull the chunks of a static batch
+ */
+BOOST_AUTO_TEST_CASE(StaticBatcher_cull)
+{
+	EntityGroupPtr group = EntityGroup::create();
+	group->setStatic(true);
+
+	GeometryPtr geometry = BoxGeometry::create(1.f, 1.f, 1.f);
+	MaterialPtr material = BasicMaterial::create();
+	MeshPtr near = Mesh::create(geometry, material);
+	MeshPtr far = Mesh::create(geometry, material);
+	far->setPosition(100.f, 0.f, 0.f);
+	group->add(near);
+	group->add(far);
+
+	StaticBatchPtr batch = StaticBatcher::build(group, 10.f);
+	BOOST_TEST(batch->cull(Frustum(), Matrix4::IDENTITY) == 2);
+
+	Frustum frustum = Frustum::fromMatrix(Matrix4::fromScaling(0.2f, 0.2f, 0.2f));
+	BOOST_TEST(batch->cull(frustum, Matrix4::IDENTITY) == 1);
+	BOOST_TEST(batch->getBuckets()[0].visibleCounts.size() == 1);
+	BOOST_TEST(batch->getBuckets()[0].visibleBaseVertices[0] == 0);
+
+	// Moving the group moves its chunks
+	BOOST_TEST(batch->cull(frustum, Matrix4::fromTranslation(Vector3(-100.f, 0.f, 0.f))) == 1);
+	BOOST_TEST(batch->getBuckets()[0].visibleBaseVertices[0] == (int) geometry->getNumVertices());
+}
+
+/**
+ * Tests the detection of changes that make a static batch out-of-date
+ */
+BOOST_AUTO_TEST_CASE(StaticBatcher_isStale)
+{
+	EntityGroupPtr group = EntityGroup::create();
+	group->setStatic(true);
+
+	GeometryPtr geometry = BoxGeometry::create(1.f, 1.f, 1.f);
+	MeshPtr mesh = Mesh::create(geometry, BasicMaterial::create());
+	EntityGroupPtr inner = EntityGroup::create();
+	inner->add(mesh);
+	group->add(inner);
+
+	StaticBatchPtr batch = StaticBatcher::build(group);
+	BOOST_TEST(!batch->isStale());
+
+	// Moving the group itself does not require a rebuild
+	group->setPosition(1.f, 0.f, 0.f);
+	BOOST_TEST(!batch->isStale());
+
+	mesh->setPosition(1.f, 0.f, 0.f);
+	BOOST_TEST(batch->isStale());
+
+	batch = StaticBatcher::build(group);
+	mesh->material = BasicMaterial::create();
+	BOOST_TEST(batch->isStale());
+
+	batch = StaticBatcher::build(group);
+	float vertices[] = { 0.f, 0.f, 0.f };
+	geometry->setVertices(vertices, 1);
+	BOOST_TEST(batch->isStale());
+
+	batch = StaticBatcher::build(group);
+	group->remove(inner);
+	BOOST_TEST(batch->isStale());
+}
+
+
+/**
+ * Tests that meshes whose materials differ only in the region of a texture atlas they sample share a bucket
+ */
+BOOST_AUTO_TEST_CASE(StaticBatcher_atlas)
+{
+	EntityGroupPtr group = EntityGroup::create();
+	group->setStatic(true);
+
+	GeometryPtr geometry = BoxGeometry::create(1.f, 1.f, 1.f);
+	MaterialPtr material1 = BasicMaterial::create();
+	MaterialPtr material2 = BasicMaterial::create();
+	material2->uvOffset = Vector2(0.5f, 0.f);
+	material2->uvScale = Vector2(0.5f, 0.5f);
+	MeshPtr mesh1 = Mesh::create(geometry, material1);
+	MeshPtr mesh2 = Mesh::create(geometry, material2);
+	mesh2->setPosition(2.f, 0.f, 0.f);
+	group->add(mesh1);
+	group->add(mesh2);
+
+	StaticBatchPtr batch = StaticBatcher::build(group, 10.f);
+	BOOST_TEST(batch->getStats().numBuckets == 1u);
+	BOOST_TEST(batch->getBuckets()[0].material == material1);
+	BOOST_TEST(batch->getBuckets()[0].buffer->size == 2 * geometry->size());
+	BOOST_TEST(!batch->isStale());
+
+	// Texture coordinate transformations are baked, so changing them requires a rebuild
+	material2->uvOffset = Vector2(0.f, 0.5f);
+	BOOST_TEST(batch->isStale());
+
+	// As does a merged material no longer looking the same
+	batch = StaticBatcher::build(group, 10.f);
+	material2->color = Color::RED;
+	BOOST_TEST(batch->isStale());
+
+	batch = StaticBatcher::build(group, 10.f);
+	BOOST_TEST(batch->getStats().numBuckets == 2u);
+}
\ No newline at end of file
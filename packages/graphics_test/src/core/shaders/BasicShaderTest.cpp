@@ -1,7 +1,9 @@
 #include <boost/test/unit_test.hpp>
 #include <graphics/core/shaders/ShaderManager.h>
 #include <graphics/core/shaders/BasicShader.h>
+#include <graphics/core/shaders/ShaderFeatures.h>
 #include <graphics/core/RenderState.h>
+#include <graphics/core/LightClusters.h>
 #include <graphics/materials/MaterialType.h>
 #include <graphics/materials/BasicMaterial.h>
 #include <graphics/textures/TextureLoader.h>
@@ -20,8 +22,15 @@ BOOST_AUTO_TEST_CASE(BasicShader_setState)
 {
 	RenderState state;
 	state.lighting.ambient = AmbientLight::create();
-	state.lighting.positional = PointLight::create();
+	state.lighting.points.push_back(PointLight::create());
 	state.camera = PerspectiveCamera::create(60.f, 800.f / 600.f, 0.1f, 100.f);
+	state.viewportWidth = 800.f;
+	state.viewportHeight = 600.f;
+
+	LightClusters clusters;
+	clusters.build(state.lighting.points, state.camera);
+	clusters.upload();
+	state.lighting.clusters = &clusters;
 
 	ShaderPtr shader = ShaderManager::getShader(MaterialType::BASIC);
 	BOOST_REQUIRE_NO_THROW(shader->setState(state));
@@ -72,6 +81,8 @@ BOOST_AUTO_TEST_CASE(BasicShader_setTextureMaterial)
 	item.modelTransform = Matrix4::IDENTITY;
 	item.normalTransform = Matrix3::IDENTITY;
 
-	ShaderPtr shader = ShaderManager::getShader(MaterialType::BASIC);
+	ShaderPtr shader = ShaderManager::getShader(MaterialType::BASIC,
+		ShaderFeatures::compute(*mat, geom->getAttributes(), false));
+	BOOST_TEST(shader->getFeatures() == ShaderFeatures::TEXTURE);
 	BOOST_REQUIRE_NO_THROW(shader->setItem(item));
 }
\ No newline at end of file
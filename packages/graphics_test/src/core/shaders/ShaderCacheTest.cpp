@@ -0,0 +1,124 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/shaders/ShaderCache.h>
+#include <graphics/core/shaders/ShaderManager.h>
+#include <graphics/core/shaders/BasicShader.h>
+#include <graphics/materials/MaterialType.h>
+#include <common/PrintHelpers.h>
+#include <filesystem>
+
+namespace
+{
+	/**
+	 * @return Absolute path to an empty directory holding the cache files of a test
+	 */
+	std::string createDirectory(const std::string& name)
+	{
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+		std::filesystem::remove_all(directory);
+		return directory.string();
+	}
+}
+
+/**
+ * Tests that keys depend on the program sources
+ */
+BOOST_AUTO_TEST_CASE(ShaderCache_computeKey)
+{
+	unsigned long long key = ShaderCache::computeKey(BASIC_VERTEX, BASIC_FRAGMENT);
+	BOOST_TEST(ShaderCache::computeKey(BASIC_VERTEX, BASIC_FRAGMENT) == key);
+	BOOST_TEST(ShaderCache::computeKey(BASIC_FRAGMENT, BASIC_VERTEX) != key);
+	BOOST_TEST(ShaderCache::computeKey(BASIC_VERTEX, "#define TEXTURED\n") != key);
+}
+
+/**
+ * Tests that programs are compiled and cached on first use, and loaded from their binary afterwards
+ */
+BOOST_AUTO_TEST_CASE(ShaderCache_load)
+{
+	ShaderManager::reset();
+	ShaderCache::reset();
+	std::string directory = createDirectory("ShaderCacheTest_load");
+	ShaderCache::setDirectory(directory);
+	BOOST_TEST(ShaderCache::getDirectory() == directory);
+
+	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC) != nullptr);
+	ShaderCacheStats stats = ShaderCache::getStats();
+	BOOST_TEST(stats.numHits == 0u);
+	BOOST_TEST(stats.numMisses == 1u);
+	BOOST_TEST(stats.compileTime > 0.f);
+
+	ShaderManager::reset();
+	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC) != nullptr);
+	stats = ShaderCache::getStats();
+	if (ShaderCache::isSupported())
+	{
+		BOOST_TEST(std::filesystem::exists(directory));
+		BOOST_TEST(stats.numHits == 1u);
+		BOOST_TEST(stats.numMisses == 1u);
+		BOOST_TEST(stats.numRejected == 0u);
+	}
+	else
+	{
+		BOOST_TEST(!std::filesystem::exists(directory));
+		BOOST_TEST(stats.numHits == 0u);
+		BOOST_TEST(stats.numMisses == 2u);
+	}
+
+	ShaderManager::reset();
+	ShaderCache::reset();
+	std::filesystem::remove_all(directory);
+}
+
+/**
+ * Tests that corrupt binaries are compiled from source again
+ */
+BOOST_AUTO_TEST_CASE(ShaderCache_corrupt)
+{
+	ShaderManager::reset();
+	ShaderCache::reset();
+	std::string directory = createDirectory("ShaderCacheTest_corrupt");
+	ShaderCache::setDirectory(directory);
+	ShaderManager::getShader(MaterialType::BASIC);
+	if (!ShaderCache::isSupported())
+	{
+		ShaderManager::reset();
+		ShaderCache::reset();
+		return;
+	}
+
+	// Truncate the binary
+	std::filesystem::path path = std::filesystem::directory_iterator(directory)->path();
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+	ShaderManager::reset();
+	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC) != nullptr);
+	BOOST_TEST(ShaderCache::getStats().numMisses == 2u);
+
+	ShaderManager::reset();
+	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC) != nullptr);
+	BOOST_TEST(ShaderCache::getStats().numHits == 1u);
+
+	ShaderManager::reset();
+	ShaderCache::reset();
+	std::filesystem::remove_all(directory);
+}
+
+/**
+ * Tests that programs are always compiled once caching is disabled
+ */
+BOOST_AUTO_TEST_CASE(ShaderCache_disabled)
+{
+	ShaderManager::reset();
+	ShaderCache::reset();
+	ShaderCache::setDirectory("");
+	ShaderManager::getShader(MaterialType::BASIC);
+	ShaderManager::reset();
+	ShaderManager::getShader(MaterialType::BASIC);
+
+	ShaderCacheStats stats = ShaderCache::getStats();
+	BOOST_TEST(stats.numHits == 0u);
+	BOOST_TEST(stats.numMisses == 2u);
+
+	ShaderManager::reset();
+	ShaderCache::reset();
+}
@@ -0,0 +1,116 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/core/shaders/ShaderFeatures.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <graphics/textures/TextureArray.h>
+#include <graphics/textures/TextureLoader.h>
+#include <string>
+
+/**
+ * Tests that vertex colors are only used if both the material and the geometry hold them
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_computeVertexColors)
+{
+	BasicMaterialPtr mat = BasicMaterial::create();
+	GeometryAttributes attributes;
+	BOOST_TEST(ShaderFeatures::compute(*mat, attributes, false) == 0u);
+
+	attributes.colors = true;
+	BOOST_TEST(ShaderFeatures::compute(*mat, attributes, false) == 0u);
+
+	mat->useVertexColors = true;
+	BOOST_TEST(ShaderFeatures::compute(*mat, attributes, false) == ShaderFeatures::VERTEX_COLORS);
+
+	attributes.colors = false;
+	BOOST_TEST(ShaderFeatures::compute(*mat, attributes, false) == 0u);
+}
+
+/**
+ * Tests that textures are only sampled if the geometry holds texture coordinates
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_computeTexture)
+{
+	BasicMaterialPtr mat = BasicMaterial::create();
+	mat->texture = TextureLoader::load("assets/container.jpg");
+	GeometryAttributes attributes;
+	BOOST_TEST(ShaderFeatures::compute(*mat, attributes, false) == 0u);
+
+	attributes.uvs = true;
+	BOOST_TEST(ShaderFeatures::compute(*mat, attributes, false) == ShaderFeatures::TEXTURE);
+}
+
+/**
+ * Tests that texture arrays are sampled instead of textures, since both cannot be combined
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_computeTextureArray)
+{
+	BasicMaterialPtr mat = BasicMaterial::create();
+	mat->texture = TextureLoader::load("assets/container.jpg");
+	mat->textureArray = TextureArray::create({ "assets/container.jpg" });
+	GeometryAttributes attributes;
+	attributes.uvs = true;
+
+	unsigned int features = ShaderFeatures::compute(*mat, attributes, false);
+	BOOST_TEST(features == ShaderFeatures::TEXTURE_ARRAY);
+	BOOST_TEST(ShaderFeatures::isValid(features));
+}
+
+/**
+ * Tests that instanced draws select the instanced variant
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_computeInstanced)
+{
+	BasicMaterialPtr mat = BasicMaterial::create();
+	mat->useVertexColors = true;
+	GeometryAttributes attributes;
+	attributes.colors = true;
+
+	unsigned int features = ShaderFeatures::compute(*mat, attributes, true);
+	BOOST_TEST(features == (ShaderFeatures::VERTEX_COLORS | ShaderFeatures::INSTANCED));
+	BOOST_TEST(features < ShaderFeatures::NUM_VARIANTS);
+}
+
+/**
+ * Tests that unknown bits and features excluding each other are not valid
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_isValid)
+{
+	BOOST_TEST(ShaderFeatures::isValid(0));
+	BOOST_TEST(ShaderFeatures::isValid(ShaderFeatures::TEXTURE | ShaderFeatures::VERTEX_COLORS |
+		ShaderFeatures::INSTANCED | ShaderFeatures::LIGHT_LIST));
+	BOOST_TEST(ShaderFeatures::isValid(ShaderFeatures::TEXTURE_ARRAY | ShaderFeatures::INSTANCED));
+	BOOST_TEST(!ShaderFeatures::isValid(ShaderFeatures::TEXTURE | ShaderFeatures::TEXTURE_ARRAY));
+	BOOST_TEST(!ShaderFeatures::isValid(ShaderFeatures::NUM_VARIANTS));
+}
+
+/**
+ * Tests that every feature defines its own macro
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_getDefines)
+{
+	BOOST_TEST(ShaderFeatures::getDefines(0) == "");
+	BOOST_TEST(ShaderFeatures::getDefines(ShaderFeatures::TEXTURE) == "#define HAS_TEXTURE\n");
+	BOOST_TEST(ShaderFeatures::getDefines(ShaderFeatures::TEXTURE_ARRAY | ShaderFeatures::INSTANCED) ==
+		"#define HAS_TEXTURE_ARRAY\n#define INSTANCED\n");
+	BOOST_TEST(ShaderFeatures::getDefines(ShaderFeatures::VERTEX_COLORS) == "#define HAS_VERTEX_COLORS\n");
+	BOOST_TEST(ShaderFeatures::getDefines(ShaderFeatures::LIGHT_LIST) ==
+		"#define HAS_LIGHT_LIST\n#define MAX_LIGHTS " + std::to_string(ShaderFeatures::MAX_LIGHTS) + "\n");
+}
+
+/**
+ * Tests that defines are injected right after the #version directive
+ */
+BOOST_AUTO_TEST_CASE(ShaderFeatures_inject)
+{
+	std::string source = ShaderFeatures::inject("#version 330 core\nvoid main() {}\n", ShaderFeatures::TEXTURE);
+	BOOST_TEST(source == "#version 330 core\n#define HAS_TEXTURE\nvoid main() {}\n");
+
+	source = ShaderFeatures::inject("#version 330 core", ShaderFeatures::INSTANCED);
+	BOOST_TEST(source == "#version 330 core\n#define INSTANCED\n");
+
+	source = ShaderFeatures::inject("void main() {}\n", ShaderFeatures::VERTEX_COLORS);
+	BOOST_TEST(source == "#define HAS_VERTEX_COLORS\nvoid main() {}\n");
+
+	source = ShaderFeatures::inject("#version 330 core\nvoid main() {}\n", 0);
+	BOOST_TEST(source == "#version 330 core\nvoid main() {}\n");
+}
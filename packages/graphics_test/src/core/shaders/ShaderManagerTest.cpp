@@ -1,6 +1,10 @@
 #include <boost/test/unit_test.hpp>
 #include <graphics/core/shaders/ShaderManager.h>
+#include <graphics/core/shaders/ShaderFeatures.h>
+#include <graphics/core/shaders/Shader.h>
 #include <graphics/materials/MaterialType.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <vector>
 
 /**
  * Tests that shaders can be obtained for each type of material type
@@ -9,3 +13,116 @@ BOOST_AUTO_TEST_CASE(ShaderManager_getShader)
 {
 	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC) != nullptr);
 }
+
+/**
+ * Tests that variants are compiled on first use, and reused afterwards
+ */
+BOOST_AUTO_TEST_CASE(ShaderManager_getShaderVariant)
+{
+	ShaderManager::reset();
+	ShaderPtr shader = ShaderManager::getShader(MaterialType::BASIC, ShaderFeatures::TEXTURE);
+	BOOST_TEST(shader->getFeatures() == ShaderFeatures::TEXTURE);
+	BOOST_TEST(ShaderManager::getNumShaders() == 1u);
+
+	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC, ShaderFeatures::TEXTURE) == shader);
+	BOOST_TEST(ShaderManager::getShader(MaterialType::BASIC) != shader);
+	BOOST_TEST(ShaderManager::getNumShaders() == 2u);
+	ShaderManager::reset();
+}
+
+namespace
+{
+	/**
+	 * @return Every valid combination of features
+	 */
+	std::vector<unsigned int> getValidVariants()
+	{
+		std::vector<unsigned int> variants;
+		for (unsigned int features = 0; features < ShaderFeatures::NUM_VARIANTS; features++)
+		{
+			if (ShaderFeatures::isValid(features))
+			{
+				variants.push_back(features);
+			}
+		}
+		return variants;
+	}
+}
+
+/**
+ * Tests that prewarming compiles the given variants of a material type, and rejects invalid ones
+ */
+BOOST_AUTO_TEST_CASE(ShaderManager_prewarm)
+{
+	ShaderManager::reset();
+	ShaderManager::prewarm(MaterialType::BASIC, { 0, ShaderFeatures::TEXTURE, ShaderFeatures::TEXTURE });
+	BOOST_TEST(ShaderManager::getNumShaders() == 2u);
+
+	std::vector<unsigned int> variants = getValidVariants();
+	ShaderManager::prewarm(MaterialType::BASIC, variants);
+	BOOST_TEST(ShaderManager::getNumShaders() == variants.size());
+
+	BOOST_CHECK_THROW(ShaderManager::prewarm(MaterialType::BASIC,
+		{ ShaderFeatures::TEXTURE | ShaderFeatures::TEXTURE_ARRAY }), IllegalArgumentException);
+	BOOST_TEST(ShaderManager::getNumShaders() == variants.size());
+	ShaderManager::reset();
+}
+
+/**
+ * Tests that variants still compiling are replaced by a ready fallback with the same instancing
+ */
+BOOST_AUTO_TEST_CASE(ShaderManager_getReadyShader)
+{
+	ShaderManager::reset();
+	ShaderManager::prewarm(MaterialType::BASIC, getValidVariants());
+
+	unsigned int features = ShaderFeatures::TEXTURE | ShaderFeatures::INSTANCED;
+	ShaderPtr shader = ShaderManager::getReadyShader(MaterialType::BASIC, features);
+	BOOST_TEST(shader->isReady());
+	BOOST_TEST((shader->getFeatures() == features || shader->getFeatures() == ShaderFeatures::INSTANCED));
+
+	ShaderPtr variant = ShaderManager::getShader(MaterialType::BASIC, features);
+	BOOST_TEST(variant->isReady());
+	BOOST_TEST(ShaderManager::getReadyShader(MaterialType::BASIC, features) == variant);
+	ShaderManager::reset();
+}
+
+/**
+ * Tests that waiting for every variant leaves none pending
+ */
+BOOST_AUTO_TEST_CASE(ShaderManager_getNumPending)
+{
+	ShaderManager::reset();
+	std::vector<unsigned int> variants = getValidVariants();
+	ShaderManager::prewarm(MaterialType::BASIC, variants);
+	BOOST_TEST(ShaderManager::getNumPending() <= variants.size());
+
+	for (unsigned int features : variants)
+	{
+		ShaderManager::getShader(MaterialType::BASIC, features);
+	}
+	BOOST_TEST(ShaderManager::getNumPending() == 0u);
+	ShaderManager::reset();
+}
+
+/**
+ * Tests that unknown and incompatible features are rejected
+ */
+BOOST_AUTO_TEST_CASE(ShaderManager_getShaderInvalid)
+{
+	BOOST_CHECK_THROW(ShaderManager::getShader(MaterialType::BASIC, ShaderFeatures::NUM_VARIANTS),
+		IllegalArgumentException);
+	BOOST_CHECK_THROW(ShaderManager::getShader(MaterialType::BASIC,
+		ShaderFeatures::TEXTURE | ShaderFeatures::TEXTURE_ARRAY), IllegalArgumentException);
+}
+
+/**
+ * Tests that every variant has a distinct key
+ */
+BOOST_AUTO_TEST_CASE(ShaderManager_getKey)
+{
+	BOOST_TEST(ShaderManager::getKey(MaterialType::BASIC, 0) != ShaderManager::getKey(MaterialType::BASIC,
+		ShaderFeatures::INSTANCED));
+	BOOST_TEST(ShaderManager::getKey(MaterialType::BASIC, ShaderFeatures::NUM_VARIANTS - 1) <
+		ShaderManager::getKey(static_cast<MaterialType>(1), 0));
+}
@@ -14,4 +14,18 @@ BOOST_AUTO_TEST_CASE(BoxGeometry_basics)
 	BOOST_TEST(attributes.normals);
 	BOOST_TEST(attributes.uvs);
 	BOOST_TEST(!attributes.colors);
-}
\ No newline at end of file
+}
+/**
+ * Tests that boxes of the same dimensions share a single GPU buffer
+ */
+BOOST_AUTO_TEST_CASE(BoxGeometry_sharedBuffer)
+{
+	BoxGeometryPtr box1 = BoxGeometry::create(1.f, 1.f, 1.f);
+	BoxGeometryPtr box2 = BoxGeometry::create(1.f, 1.f, 1.f);
+	BoxGeometryPtr box3 = BoxGeometry::create(1.f, 2.f, 1.f);
+	BOOST_TEST(box1->isBufferSharing());
+
+	BOOST_TEST(box1->getBuffer() == box2->getBuffer());
+	BOOST_TEST(box1->getBuffer() != box3->getBuffer());
+	BOOST_TEST(box1->isBufferShared());
+}
@@ -0,0 +1,185 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/geometry/Geometry.h>
+#include <math/Vector3.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/exceptions/NullPointerException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Flattens every triangle of a triangle list into the vertex data of its corners, in sorted order
+	 */
+	std::vector<std::array<float, GRID_STRIDE * 3>> getTriangles(const float* vertexData, const unsigned int* indices,
+		unsigned int numIndices)
+	{
+		std::vector<std::array<float, GRID_STRIDE * 3>> triangles(numIndices / 3);
+		for (unsigned int t = 0; t < numIndices / 3; t++)
+		{
+			for (unsigned int corner = 0; corner < 3; corner++)
+			{
+				const float* vertex = vertexData + indices[t * 3 + corner] * GRID_STRIDE;
+				std::copy_n(vertex, GRID_STRIDE, triangles[t].begin() + corner * GRID_STRIDE);
+			}
+		}
+		return triangles;
+	}
+
+	/**
+	 * Inverts a single byte of a file
+	 */
+	void corruptFile(const std::string& path, size_t offset)
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekg(offset);
+		char byte = (char) file.get();
+		file.seekp(offset);
+		file.put((char) ~byte);
+	}
+}
+
+/**
+ * Tests partitioning a geometry into clusters and reading them back
+ */
+BOOST_AUTO_TEST_CASE(ClusterFile_partition)
+{
+	GeometryPtr grid = createGridGeometry(64, 0.1f);
+	std::string path = getTempPath("ClusterFileTest" + ClusterFile::EXTENSION);
+	ClusterFile::write(path, grid, 500);
+
+	ClusterFile file(path);
+	BOOST_TEST((file.getAttributes() == grid->getAttributes()));
+	BOOST_TEST(file.getNumClusters() >= 17u);
+	BOOST_TEST(file.getMaxClusterIndices() <= 1500u);
+	BOOST_TEST(file.getBounds().min.x == 0.f);
+	BOOST_TEST(file.getBounds().max.y == 1.f);
+
+	// Every triangle ends up in exactly one cluster, within the bounds of the cluster
+	auto expected = getTriangles(grid->getInterleavedVertices(), grid->getIndices(), grid->size());
+	decltype(expected) actual;
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	unsigned int maxVertices = 0;
+	for (unsigned int i = 0; i < file.getNumClusters(); i++)
+	{
+		const ClusterInfo& cluster = file.getCluster(i);
+		file.readCluster(i, vertexData, indices);
+		BOOST_REQUIRE(vertexData.size() == cluster.numVertices * GRID_STRIDE);
+		BOOST_REQUIRE(indices.size() == cluster.numIndices);
+		BOOST_TEST(cluster.numIndices % 3 == 0u);
+		maxVertices = std::max(maxVertices, cluster.numVertices);
+
+		for (unsigned int v = 0; v < cluster.numVertices; v++)
+		{
+			const float* vertex = &vertexData[v * GRID_STRIDE];
+			Vector3 position(vertex[0], vertex[1], vertex[2]);
+			BOOST_TEST(cluster.box.containsPoint(position));
+			BOOST_TEST(position.minus(cluster.bounds.center).getMagnitude() <= cluster.bounds.radius * 1.0001f);
+		}
+
+		auto triangles = getTriangles(vertexData.data(), indices.data(), cluster.numIndices);
+		actual.insert(actual.end(), triangles.begin(), triangles.end());
+	}
+	BOOST_TEST(maxVertices == file.getMaxClusterVertices());
+
+	std::sort(expected.begin(), expected.end());
+	std::sort(actual.begin(), actual.end());
+	BOOST_TEST((actual == expected));
+
+	BOOST_CHECK_THROW(file.getCluster(file.getNumClusters()), OutOfBoundsException);
+	BOOST_CHECK_THROW(file.readCluster(file.getNumClusters(), vertexData, indices), OutOfBoundsException);
+}
+
+/**
+ * Tests writing a cluster file one generated cluster at a time
+ */
+BOOST_AUTO_TEST_CASE(ClusterFile_generate)
+{
+	GeometryAttributes layout;
+	std::string path = getTempPath("ClusterFileGenerated" + ClusterFile::EXTENSION);
+	ClusterFile::write(path, layout, 3, [](unsigned int index, std::vector<float>& vertexData,
+		std::vector<unsigned int>& indices)
+	{
+		float x = (float) index;
+		vertexData = { x, 0.f, 0.f, x + 1.f, 0.f, 0.f, x, 1.f, 0.f, x + 1.f, 1.f, 0.f };
+		indices = { 0, 1, 2 };
+		if (index == 1)
+		{
+			indices.insert(indices.end(), { 2, 1, 3 });
+		}
+	});
+
+	ClusterFile file(path);
+	BOOST_TEST(file.getNumClusters() == 3u);
+	BOOST_TEST(file.getMaxClusterVertices() == 4u);
+	BOOST_TEST(file.getMaxClusterIndices() == 6u);
+	BOOST_TEST(file.getBounds().min.x == 0.f);
+	BOOST_TEST(file.getBounds().max.x == 3.f);
+
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	file.readCluster(1, vertexData, indices);
+	BOOST_TEST(vertexData.size() == 12u);
+	BOOST_TEST(vertexData[0] == 1.f);
+	BOOST_TEST((indices == std::vector<unsigned int>({ 0, 1, 2, 2, 1, 3 })));
+	BOOST_TEST(file.getCluster(2).box.min.x == 2.f);
+	BOOST_TEST(file.getCluster(2).numIndices == 3u);
+
+	// Clusters must hold whole triangles indexing their own vertices
+	BOOST_CHECK_THROW(ClusterFile::write(path, layout, 1, [](unsigned int, std::vector<float>& vertexData,
+		std::vector<unsigned int>& indices)
+	{
+		vertexData = { 0.f, 0.f, 0.f };
+		indices = { 0, 0 };
+	}), IllegalArgumentException);
+	BOOST_CHECK_THROW(ClusterFile::write(path, layout, 1, [](unsigned int, std::vector<float>& vertexData,
+		std::vector<unsigned int>& indices)
+	{
+		vertexData = { 0.f, 0.f, 0.f };
+		indices = { 0, 0, 1 };
+	}), OutOfBoundsException);
+}
+
+/**
+ * Tests the rejection of invalid geometries and corrupt files
+ */
+BOOST_AUTO_TEST_CASE(ClusterFile_invalid)
+{
+	std::string path = getTempPath("ClusterFileInvalid" + ClusterFile::EXTENSION);
+	BOOST_CHECK_THROW(ClusterFile::write(path, GeometryPtr(nullptr)), NullPointerException);
+	BOOST_CHECK_THROW(ClusterFile::write(path, Geometry::create()), IllegalArgumentException);
+	BOOST_CHECK_THROW(ClusterFile::write(path, createGridGeometry(2, 0.1f), 0), IllegalArgumentException);
+	BOOST_CHECK_THROW(ClusterFile(getTempPath("ClusterFileMissing" + ClusterFile::EXTENSION)), InstantiationException);
+
+	// Corrupt clusters are only detected once they are read
+	ClusterFile::write(path, createGridGeometry(16, 0.1f), 64);
+	size_t size = std::filesystem::file_size(path);
+	corruptFile(path, ClusterFile::ALIGNMENT + 8);
+	{
+		ClusterFile file(path);
+		std::vector<float> vertexData;
+		std::vector<unsigned int> indices;
+		BOOST_CHECK_THROW(file.readCluster(0, vertexData, indices), InstantiationException);
+		BOOST_CHECK_NO_THROW(file.readCluster(1, vertexData, indices));
+
+		// Verification can be disabled
+		ClusterFile unverified(path, false);
+		BOOST_CHECK_NO_THROW(unverified.readCluster(0, vertexData, indices));
+	}
+
+	// A corrupt cluster table is detected when the file is opened
+	corruptFile(path, size - 8);
+	BOOST_CHECK_THROW(ClusterFile file(path), InstantiationException);
+
+	std::filesystem::resize_file(path, size - 64);
+	BOOST_CHECK_THROW(ClusterFile file(path), InstantiationException);
+}
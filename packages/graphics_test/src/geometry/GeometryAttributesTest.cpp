@@ -53,4 +53,31 @@ BOOST_AUTO_TEST_CASE(GeometryAttributes_stride)
 
 	a = { false, false, true };
 	BOOST_TEST(a.getStride() == 5);
-}
\ No newline at end of file
+}
+/**
+ * Tests the GPU size of vertices, given the storage format of each attribute
+ */
+BOOST_AUTO_TEST_CASE(GeometryAttributes_vertexSize)
+{
+	GeometryAttributes a = { true, true, true };
+	BOOST_TEST(a.getVertexSize() == 48);
+	BOOST_TEST(a.isFloatOnly());
+
+	a.normalFormat = AttributeFormat::INT_2_10_10_10_REV;
+	a.colorFormat = AttributeFormat::UNSIGNED_BYTE;
+	a.uvFormat = AttributeFormat::HALF_FLOAT;
+	BOOST_TEST(a.getVertexSize() == 24);
+	BOOST_TEST(!a.isFloatOnly());
+
+	a.normalFormat = AttributeFormat::HALF_FLOAT;
+	a.colorFormat = AttributeFormat::HALF_FLOAT;
+	BOOST_TEST(a.getVertexSize() == 32);
+
+	// Formats of absent attributes are ignored
+	GeometryAttributes b = { false, false, false };
+	GeometryAttributes c = b;
+	c.normalFormat = AttributeFormat::HALF_FLOAT;
+	BOOST_TEST(b == c);
+	BOOST_TEST(c.getVertexSize() == 12);
+	BOOST_TEST(c.isFloatOnly());
+}
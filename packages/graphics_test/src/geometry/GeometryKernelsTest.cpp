@@ -0,0 +1,231 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/geometry/GeometryKernels.h>
+#include <math/Vector3.h>
+#include <common/Utils.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Computes area weighted vertex normals one triangle at a time, for comparison
+	 */
+	std::vector<Vector3> computeReferenceNormals(const std::vector<float>& vertexData, unsigned int stride,
+		const std::vector<unsigned int>& indices)
+	{
+		std::vector<Vector3> normals(vertexData.size() / stride);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			Vector3 p[3];
+			for (int c = 0; c < 3; c++)
+			{
+				const float* v = &vertexData[indices[i + c] * stride];
+				p[c] = Vector3(v[0], v[1], v[2]);
+			}
+
+			Vector3 n = p[1].minus(p[0]).cross(p[2].minus(p[0]));
+			for (int c = 0; c < 3; c++)
+			{
+				Vector3& sum = normals[indices[i + c]];
+				sum = Vector3(sum.x + n.x, sum.y + n.y, sum.z + n.z);
+			}
+		}
+
+		for (Vector3& n : normals)
+		{
+			n = n.normalize();
+		}
+		return normals;
+	}
+}
+
+/**
+ * Tests computing bounding boxes and spheres of strided positions
+ */
+BOOST_AUTO_TEST_CASE(GeometryKernels_bounds)
+{
+	BOOST_TEST(GeometryKernels::computeBounds(nullptr, 0, 3).isEmpty());
+	BOOST_TEST(GeometryKernels::computeBoundingSphere(nullptr, 0, 3, Box()).isEmpty());
+
+	// An odd number of vertices, so that every remainder path is taken
+	float positions[] = {
+		1.f, 2.f, 3.f,
+		-4.f, 0.f, 1.f,
+		2.f, 5.f, -1.f,
+		0.f, 0.f, 0.f,
+		3.f, -2.f, 7.f
+	};
+	Box bounds = GeometryKernels::computeBounds(positions, 5, 3);
+	BOOST_TEST(bounds.min == Vector3(-4.f, -2.f, -1.f));
+	BOOST_TEST(bounds.max == Vector3(3.f, 5.f, 7.f));
+
+	Sphere sphere = GeometryKernels::computeBoundingSphere(positions, 5, 3, bounds);
+	BOOST_TEST(sphere.center == bounds.getCenter());
+	for (int i = 0; i < 5; i++)
+	{
+		BOOST_TEST(sphere.containsPoint(Vector3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2])));
+	}
+	Vector3 d = Vector3(3.f, -2.f, 7.f).minus(sphere.center);
+	BOOST_TEST(equals(sphere.radius, d.getMagnitude(), 1.0e-6));
+
+	// Interleaved data, where the bounds only consider the first three values of each vertex
+	float interleaved[] = {
+		1.f, 1.f, 1.f, 100.f,
+		-1.f, 2.f, 0.f, -100.f
+	};
+	bounds = GeometryKernels::computeBounds(interleaved, 2, 4);
+	BOOST_TEST(bounds.min == Vector3(-1.f, 1.f, 0.f));
+	BOOST_TEST(bounds.max == Vector3(1.f, 2.f, 1.f));
+}
+
+/**
+ * Tests the difference between area and angle weighted vertex normals
+ */
+BOOST_AUTO_TEST_CASE(GeometryKernels_normalWeighting)
+{
+	// A large triangle in the xy plane and a small triangle in the xz plane, meeting at a right angle at the origin
+	float positions[] = {
+		0.f, 0.f, 0.f,
+		10.f, 0.f, 0.f,
+		0.f, 10.f, 0.f,
+		0.f, 0.f, 1.f,
+		1.f, 0.f, 0.f,
+		5.f, 5.f, 5.f
+	};
+	unsigned int indices[] = { 0, 1, 2, 0, 3, 4 };
+	float normals[18];
+
+	GeometryKernels::computeVertexNormals(positions, 6, 3, indices, 6, NormalWeighting::ANGLE, normals);
+	BOOST_TEST(Vector3(normals[0], normals[1], normals[2]).equalTo(Vector3(0.f, sqrt(0.5f), sqrt(0.5f)), 1.0e-4));
+	BOOST_TEST(Vector3(normals[3], normals[4], normals[5]).equalTo(Vector3::ZHAT, 1.0e-6));
+	BOOST_TEST(Vector3(normals[9], normals[10], normals[11]).equalTo(Vector3::YHAT, 1.0e-6));
+
+	// Unreferenced vertices receive a zero normal
+	BOOST_TEST(Vector3(normals[15], normals[16], normals[17]).isZero());
+
+	GeometryKernels::computeVertexNormals(positions, 6, 3, indices, 6, NormalWeighting::AREA, normals);
+	Vector3 expected = Vector3(0.f, 1.f, 100.f).normalize();
+	BOOST_TEST(Vector3(normals[0], normals[1], normals[2]).equalTo(expected, 1.0e-6));
+
+	unsigned int outOfRange[] = { 0, 1, 6 };
+	BOOST_CHECK_THROW(GeometryKernels::computeVertexNormals(positions, 6, 3, outOfRange, 3, NormalWeighting::AREA,
+		normals), OutOfBoundsException);
+}
+
+/**
+ * Tests that vertex normals of large meshes, split across threads, match a straightforward computation
+ */
+BOOST_AUTO_TEST_CASE(GeometryKernels_largeMesh)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(400, 0.1f, false, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / 5;
+	BOOST_REQUIRE(numVertices > GeometryKernels::PARALLEL_THRESHOLD);
+
+	std::vector<float> normals(numVertices * 3);
+	GeometryKernels::computeVertexNormals(vertexData.data(), numVertices, 5, indices.data(),
+		(unsigned int) indices.size(), NormalWeighting::AREA, normals.data());
+
+	std::vector<Vector3> expected = computeReferenceNormals(vertexData, 5, indices);
+	float maxError = 0.f;
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		maxError = std::max(maxError, Vector3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2])
+			.minus(expected[i]).getMagnitude());
+	}
+	BOOST_TEST(maxError < 1.0e-5f);
+
+	Box bounds = GeometryKernels::computeBounds(vertexData.data(), numVertices, 5);
+	BOOST_TEST(bounds.min.x == 0.f);
+	BOOST_TEST(bounds.max.y == 1.f);
+}
+
+/**
+ * Tests tangents of flat and mirrored texture mappings
+ */
+BOOST_AUTO_TEST_CASE(GeometryKernels_tangents)
+{
+	// Two quads in the xy plane facing +z. The second has its texture mirrored horizontally.
+	float positions[] = {
+		0.f, 0.f, 0.f,
+		1.f, 0.f, 0.f,
+		1.f, 1.f, 0.f,
+		0.f, 1.f, 0.f,
+		0.f, 0.f, 0.f,
+		1.f, 0.f, 0.f,
+		1.f, 1.f, 0.f,
+		0.f, 1.f, 0.f
+	};
+	float normals[24];
+	for (int i = 0; i < 8; i++)
+	{
+		normals[i * 3] = 0.f;
+		normals[i * 3 + 1] = 0.f;
+		normals[i * 3 + 2] = 1.f;
+	}
+	float uvs[] = {
+		0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f,
+		1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f
+	};
+	unsigned int indices[] = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+
+	float tangents[32];
+	GeometryKernels::computeTangents(positions, 3, normals, 3, uvs, 2, 8, indices, 12, tangents);
+	for (int i = 0; i < 4; i++)
+	{
+		BOOST_TEST(Vector3(tangents[i * 4], tangents[i * 4 + 1], tangents[i * 4 + 2]).equalTo(Vector3::XHAT, 1.0e-6));
+		BOOST_TEST(tangents[i * 4 + 3] == 1.f);
+	}
+	for (int i = 4; i < 8; i++)
+	{
+		BOOST_TEST(Vector3(tangents[i * 4], tangents[i * 4 + 1], tangents[i * 4 + 2]).equalTo(Vector3::MINUS_XHAT,
+			1.0e-6));
+		BOOST_TEST(tangents[i * 4 + 3] == -1.f);
+	}
+
+	// Degenerate texture coordinates still produce a tangent perpendicular to the normal
+	float flatUVs[16] = {};
+	GeometryKernels::computeTangents(positions, 3, normals, 3, flatUVs, 2, 8, indices, 12, tangents);
+	Vector3 tangent(tangents[0], tangents[1], tangents[2]);
+	BOOST_TEST(equals(tangent.getMagnitude(), 1.f, 1.0e-6));
+	BOOST_TEST(equals(tangent.dot(Vector3::ZHAT), 0.f, 1.0e-6));
+}
+
+/**
+ * Measures the kernels on a mesh of a million vertices
+ */
+BOOST_AUTO_TEST_CASE(GeometryKernels_throughput)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(999, 0.1f, false, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / 5;
+	unsigned int numIndices = (unsigned int) indices.size();
+	std::vector<float> normals(numVertices * 3);
+	std::vector<float> tangents(numVertices * 4);
+
+	auto start = std::chrono::steady_clock::now();
+	Box bounds = GeometryKernels::computeBounds(vertexData.data(), numVertices, 5);
+	Sphere sphere = GeometryKernels::computeBoundingSphere(vertexData.data(), numVertices, 5, bounds);
+	auto boundsEnd = std::chrono::steady_clock::now();
+	GeometryKernels::computeVertexNormals(vertexData.data(), numVertices, 5, indices.data(), numIndices,
+		NormalWeighting::ANGLE, normals.data());
+	auto normalsEnd = std::chrono::steady_clock::now();
+	GeometryKernels::computeTangents(vertexData.data(), 5, normals.data(), 3, vertexData.data() + 3, 5, numVertices,
+		indices.data(), numIndices, tangents.data());
+	auto tangentsEnd = std::chrono::steady_clock::now();
+
+	BOOST_TEST(!sphere.isEmpty());
+	BOOST_TEST(normals[numVertices * 3 / 2 + 2] != 0.f);
+	double boundsTime = std::chrono::duration<double>(boundsEnd - start).count();
+	double normalsTime = std::chrono::duration<double>(normalsEnd - boundsEnd).count();
+	double tangentsTime = std::chrono::duration<double>(tangentsEnd - normalsEnd).count();
+	BOOST_TEST_MESSAGE(numVertices << " vertices: bounds " << boundsTime * 1000.0 << " ms, normals " <<
+		normalsTime * 1000.0 << " ms, tangents " << tangentsTime * 1000.0 << " ms");
+}
@@ -0,0 +1,255 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/geometry/GeometryOptimizer.h>
+#include <graphics/geometry/Geometry.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace
+{
+	const unsigned int GRID_SIZE = 24;
+
+	/**
+	 * Shuffles the triangles of a triangle list with a fixed seed, to defeat the vertex cache
+	 */
+	std::vector<unsigned int> shuffleTriangles(const std::vector<unsigned int>& indices)
+	{
+		std::vector<std::array<unsigned int, 3>> triangles;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+		}
+
+		unsigned int seed = 12345;
+		for (unsigned int i = (unsigned int) triangles.size() - 1; i > 0; i--)
+		{
+			seed = seed * 1103515245 + 12345;
+			std::swap(triangles[i], triangles[(seed >> 8) % (i + 1)]);
+		}
+
+		std::vector<unsigned int> shuffled;
+		for (const std::array<unsigned int, 3>& triangle : triangles)
+		{
+			shuffled.insert(shuffled.end(), triangle.begin(), triangle.end());
+		}
+
+		return shuffled;
+	}
+
+	/**
+	 * Builds a flat grid whose triangles are shuffled
+	 */
+	void createShuffledGrid(std::vector<float>& vertexData, std::vector<unsigned int>& indices)
+	{
+		createGrid(GRID_SIZE, 0.f, false, vertexData, indices);
+		indices = shuffleTriangles(indices);
+	}
+
+	/**
+	 * Returns the triangles of a list in a canonical form, for comparison regardless of order and winding start
+	 */
+	std::vector<std::array<unsigned int, 3>> getCanonicalTriangles(const std::vector<unsigned int>& indices)
+	{
+		std::vector<std::array<unsigned int, 3>> triangles;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			std::array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+/**
+ * Tests the cache metrics of known triangle orders
+ */
+BOOST_AUTO_TEST_CASE(GeometryOptimizer_metrics)
+{
+	unsigned int quad[] = { 0, 1, 2, 2, 1, 3 };
+	BOOST_TEST(GeometryOptimizer::getACMR(quad, 6, 4) == 2.f);
+	BOOST_TEST(GeometryOptimizer::getATVR(quad, 6, 4) == 1.f);
+
+	// A cache holding a single vertex only reuses the last vertex of the first triangle
+	BOOST_TEST(GeometryOptimizer::getACMR(quad, 6, 4, 1) == 2.5f);
+	BOOST_TEST(GeometryOptimizer::getATVR(quad, 6, 4, 1) == 1.25f);
+
+	BOOST_TEST(GeometryOptimizer::getACMR(quad, 0, 4) == 0.f);
+}
+
+/**
+ * Tests that vertex cache optimization keeps every triangle while reducing cache misses
+ */
+BOOST_AUTO_TEST_CASE(GeometryOptimizer_vertexCache)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createShuffledGrid(vertexData, indices);
+	unsigned int numVertices = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+	unsigned int numIndices = (unsigned int) indices.size();
+
+	std::vector<unsigned int> optimized = GeometryOptimizer::optimizeVertexCache(indices.data(), numIndices,
+		numVertices);
+	BOOST_TEST(optimized.size() == indices.size());
+	BOOST_TEST((getCanonicalTriangles(optimized) == getCanonicalTriangles(indices)));
+
+	float before = GeometryOptimizer::getACMR(indices.data(), numIndices, numVertices);
+	float after = GeometryOptimizer::getACMR(optimized.data(), numIndices, numVertices);
+	BOOST_TEST(before > 2.f);
+	BOOST_TEST(after < 0.8f);
+
+	// Output is deterministic
+	BOOST_TEST((GeometryOptimizer::optimizeVertexCache(indices.data(), numIndices, numVertices) == optimized));
+
+	unsigned int partial[] = { 0, 1 };
+	BOOST_CHECK_THROW(GeometryOptimizer::optimizeVertexCache(partial, 2, 2), IllegalArgumentException);
+	unsigned int invalid[] = { 0, 1, 5 };
+	BOOST_CHECK_THROW(GeometryOptimizer::optimizeVertexCache(invalid, 3, 3), OutOfBoundsException);
+}
+
+/**
+ * Tests that overdraw ordering keeps every triangle without losing much cache efficiency
+ */
+BOOST_AUTO_TEST_CASE(GeometryOptimizer_overdraw)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createShuffledGrid(vertexData, indices);
+	unsigned int numVertices = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+	unsigned int numIndices = (unsigned int) indices.size();
+
+	std::vector<unsigned int> cached = GeometryOptimizer::optimizeVertexCache(indices.data(), numIndices, numVertices);
+	unsigned int numClusters = 0;
+	std::vector<unsigned int> ordered = GeometryOptimizer::optimizeOverdraw(cached.data(), numIndices,
+		vertexData.data(), numVertices, GRID_STRIDE, GeometryOptimizer::DEFAULT_CACHE_SIZE,
+		GeometryOptimizer::DEFAULT_OVERDRAW_THRESHOLD, &numClusters);
+
+	BOOST_TEST(numClusters >= 1);
+	BOOST_TEST((getCanonicalTriangles(ordered) == getCanonicalTriangles(indices)));
+
+	float cachedACMR = GeometryOptimizer::getACMR(cached.data(), numIndices, numVertices);
+	float orderedACMR = GeometryOptimizer::getACMR(ordered.data(), numIndices, numVertices);
+	BOOST_TEST(orderedACMR < 1.5f * cachedACMR);
+}
+
+/**
+ * Tests remapping vertices into the order they are first used
+ */
+BOOST_AUTO_TEST_CASE(GeometryOptimizer_vertexFetch)
+{
+	unsigned int indices[] = { 3, 1, 4, 4, 1, 0 };
+	std::vector<unsigned int> remap = GeometryOptimizer::optimizeVertexFetch(indices, 6, 6);
+
+	std::vector<unsigned int> expected = { 3, 1, 4, 0, 2, 5 };
+	BOOST_TEST(remap == expected, boost::test_tools::per_element());
+}
+
+/**
+ * Tests merging vertices whose attributes match within a tolerance
+ */
+BOOST_AUTO_TEST_CASE(GeometryOptimizer_weld)
+{
+	// Two triangles of a quad, with the shared edge duplicated and slightly perturbed
+	float vertices[] = {
+		0.f, 0.f, 0.f,
+		1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 1e-7f, 0.f,
+		1.f, 1.f, 0.f,
+		0.f, 1.f, 0.f
+	};
+	unsigned int indices[] = { 0, 1, 2, 3, 4, 5 };
+
+	unsigned int numUnique = 0;
+	std::vector<unsigned int> remap = GeometryOptimizer::generateWeldRemap(vertices, 6, 3, 1e-6f, &numUnique);
+	std::vector<unsigned int> expected = { 0, 1, 2, 1, 3, 2 };
+	BOOST_TEST(numUnique == 4);
+	BOOST_TEST(remap == expected, boost::test_tools::per_element());
+
+	// Exact welding keeps the perturbed vertex
+	GeometryOptimizer::generateWeldRemap(vertices, 6, 3, 0.f, &numUnique);
+	BOOST_TEST(numUnique == 5);
+
+	BOOST_CHECK_THROW(GeometryOptimizer::generateWeldRemap(vertices, 6, 3, -1.f), IllegalArgumentException);
+
+	// Vertices with different attributes are kept apart
+	GeometryPtr geometry = Geometry::create();
+	float normals[] = {
+		0.f, 0.f, 1.f,
+		0.f, 0.f, 1.f,
+		0.f, 0.f, 1.f,
+		0.f, 0.f, 1.f,
+		0.f, 0.f, 1.f,
+		0.f, 0.f, -1.f
+	};
+	geometry->setVertices(vertices, 6);
+	geometry->setNormals(normals, 6);
+	geometry->setIndices(indices, 6);
+
+	BOOST_TEST(GeometryOptimizer::weld(geometry) == 1);
+	BOOST_TEST(geometry->getNumVertices() == 5);
+	BOOST_TEST(geometry->getIndices()[3] == 1);
+	BOOST_TEST(geometry->getIndices()[5] == 4);
+}
+
+/**
+ * Tests optimizing a geometry in place
+ */
+BOOST_AUTO_TEST_CASE(GeometryOptimizer_optimize)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createShuffledGrid(vertexData, indices);
+	unsigned int numVertices = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+
+	GeometryAttributes layout;
+	layout.uvs = true;
+	GeometryPtr geometry = Geometry::create();
+	geometry->setInterleavedVertices(layout, vertexData);
+	geometry->setIndices(indices.data(), (unsigned int) indices.size());
+
+	GeometryOptimizerStats stats = GeometryOptimizer::optimize(geometry);
+	BOOST_TEST(stats.acmrAfter < stats.acmrBefore);
+	BOOST_TEST(stats.atvrAfter < stats.atvrBefore);
+	BOOST_TEST(stats.atvrAfter >= 1.f);
+	BOOST_TEST(geometry->size() == indices.size());
+	BOOST_TEST(geometry->getNumVertices() == numVertices);
+
+	// Vertices are remapped into first-use order, so the first triangle references the first three vertices
+	BOOST_TEST(geometry->getIndices()[0] == 0);
+	BOOST_TEST(geometry->getIndices()[1] == 1);
+	BOOST_TEST(geometry->getIndices()[2] == 2);
+
+	// Every triangle still covers the same positions
+	BOOST_REQUIRE(geometry->getInterleavedVertices() != nullptr);
+	std::vector<std::array<float, 9>> before, after;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		std::array<float, 9> triangle;
+		for (int j = 0; j < 3; j++)
+		{
+			std::copy_n(&geometry->getInterleavedVertices()[geometry->getIndices()[i + j] * GRID_STRIDE], 3,
+				&triangle[j * 3]);
+		}
+		std::sort(triangle.begin(), triangle.end());
+		after.push_back(triangle);
+
+		for (int j = 0; j < 3; j++)
+		{
+			std::copy_n(&vertexData[indices[i + j] * GRID_STRIDE], 3, &triangle[j * 3]);
+		}
+		std::sort(triangle.begin(), triangle.end());
+		before.push_back(triangle);
+	}
+	std::sort(before.begin(), before.end());
+	std::sort(after.begin(), after.end());
+	BOOST_TEST((before == after));
+
+	BOOST_CHECK_THROW(GeometryOptimizer::optimize(Geometry::create()), IllegalArgumentException);
+}
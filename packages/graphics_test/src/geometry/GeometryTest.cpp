@@ -2,6 +2,14 @@
 #include <graphics/geometry/Geometry.h>
 #include <graphics/geometry/GeometryAttributes.h>
 #include <graphics/core/Buffer.h>
+#include <graphics/core/Color.h>
+#include <math/Vector2.h>
+#include <math/Vector3.h>
+#include <common/Utils.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <cmath>
 
 /**
  * Tests that a geometry is initially empty on construction
@@ -91,6 +99,333 @@ BOOST_AUTO_TEST_CASE(Geometry_uvs)
 	BOOST_TEST(!geom->getAttributes().uvs);
 }
 
+/**
+ * Tests that attributes are stored as floats unless compact formats are chosen
+ */
+BOOST_AUTO_TEST_CASE(Geometry_formats)
+{
+	GeometryPtr geom = Geometry::create();
+	GeometryAttributes attributes = geom->getAttributes();
+	BOOST_TEST((attributes.normalFormat == AttributeFormat::FLOAT));
+	BOOST_TEST((attributes.colorFormat == AttributeFormat::FLOAT));
+	BOOST_TEST((attributes.uvFormat == AttributeFormat::FLOAT));
+
+	geom->setNormalFormat(AttributeFormat::INT_2_10_10_10_REV);
+	geom->setColorFormat(AttributeFormat::UNSIGNED_BYTE);
+	geom->setTextureCoordFormat(AttributeFormat::HALF_FLOAT);
+	attributes = geom->getAttributes();
+	BOOST_TEST((attributes.normalFormat == AttributeFormat::INT_2_10_10_10_REV));
+	BOOST_TEST((attributes.colorFormat == AttributeFormat::UNSIGNED_BYTE));
+	BOOST_TEST((attributes.uvFormat == AttributeFormat::HALF_FLOAT));
+
+	BOOST_CHECK_THROW(geom->setNormalFormat(AttributeFormat::UNSIGNED_BYTE), IllegalArgumentException);
+	BOOST_CHECK_THROW(geom->setTextureCoordFormat(AttributeFormat::UNSIGNED_BYTE), IllegalArgumentException);
+}
+
+/**
+ * Tests the computation of a sphere bounding the vertices of a geometry
+ */
+BOOST_AUTO_TEST_CASE(Geometry_boundingSphere)
+{
+	GeometryPtr geom = Geometry::create();
+	BOOST_TEST(geom->getBoundingSphere().isEmpty());
+
+	float vertices[] = {
+		0.f, 0.f, 0.f,
+		2.f, 0.f, 0.f,
+		2.f, 2.f, 0.f
+	};
+	geom->setVertices(vertices, 3);
+
+	Sphere sphere = geom->getBoundingSphere();
+	BOOST_TEST(sphere.center.equalTo(Vector3(1.f, 1.f, 0.f), 1.0e-6));
+	BOOST_TEST(equals(sphere.radius, sqrt(2.f), 1.0e-6));
+
+	// Sphere is updated when vertices change
+	vertices[3] = 4.f;
+	geom->setVertices(vertices, 3);
+	BOOST_TEST(geom->getBoundingSphere().center.equalTo(Vector3(2.f, 1.f, 0.f), 1.0e-6));
+}
+
+/**
+ * Tests that the bounding box of a geometry is cached until its vertex positions change
+ */
+BOOST_AUTO_TEST_CASE(Geometry_bounds)
+{
+	GeometryPtr geom = Geometry::create();
+	BOOST_TEST(geom->getBounds().isEmpty());
+
+	float vertices[] = {
+		0.f, 0.f, 0.f,
+		2.f, 0.f, -1.f,
+		2.f, 2.f, 0.f
+	};
+	geom->setVertices(vertices, 3);
+	BOOST_TEST(geom->getBounds().min == Vector3(0.f, 0.f, -1.f));
+	BOOST_TEST(geom->getBounds().max == Vector3(2.f, 2.f, 0.f));
+
+	float moved[] = { 5.f, 1.f, 1.f };
+	geom->updateVertices(1, moved, 1);
+	BOOST_TEST(geom->getBounds().max == Vector3(5.f, 2.f, 1.f));
+	BOOST_TEST(geom->getBoundingSphere().center.equalTo(Vector3(2.5f, 1.f, 0.5f), 1.0e-6));
+}
+
+/**
+ * Tests computing smooth vertex normals for per-attribute and interleaved vertex data
+ */
+BOOST_AUTO_TEST_CASE(Geometry_computeVertexNormals)
+{
+	GeometryPtr geom = Geometry::create();
+	BOOST_CHECK_THROW(geom->computeVertexNormals(), IllegalArgumentException);
+
+	// Two triangles folded along the y axis, so that the shared edge receives the average of both normals
+	float vertices[] = {
+		0.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		-1.f, 0.f, 0.f,
+		0.f, 0.f, 1.f
+	};
+	unsigned int indices[] = { 0, 1, 2, 0, 1, 3 };
+	geom->setIndices(indices, 6);
+	geom->setVertices(vertices, 4);
+	geom->computeVertexNormals();
+	BOOST_REQUIRE(geom->getNormals() != nullptr);
+	BOOST_TEST(geom->getNormals()[2].equalTo(Vector3::ZHAT, 1.0e-6));
+	BOOST_TEST(geom->getNormals()[3].equalTo(Vector3::XHAT, 1.0e-6));
+	BOOST_TEST(geom->getNormals()[0].equalTo(Vector3(sqrt(0.5f), 0.f, sqrt(0.5f)), 1.0e-4));
+
+	// Unchanged geometry is not recomputed
+	unsigned int version = geom->getVersion();
+	geom->computeVertexNormals();
+	BOOST_TEST(geom->getVersion() == version);
+
+	// Normals are inserted into interleaved data, which stays interleaved
+	GeometryAttributes layout;
+	layout.uvs = true;
+	std::vector<float> vertexData = {
+		0.f, 0.f, 0.f, 0.f, 0.f,
+		1.f, 0.f, 0.f, 1.f, 0.f,
+		0.f, 1.f, 0.f, 0.f, 1.f
+	};
+	geom = Geometry::create();
+	geom->setInterleavedVertices(layout, vertexData);
+	geom->computeVertexNormals(NormalWeighting::AREA);
+	BOOST_REQUIRE(geom->getInterleavedVertices() != nullptr);
+	BOOST_TEST(geom->getAttributes().normals);
+	const float* data = geom->getInterleavedVertices();
+	BOOST_TEST(data[5] == 1.f);
+	BOOST_TEST(data[13] == 1.f);
+	BOOST_TEST(data[14] == 1.f);
+	BOOST_TEST(data[21] == 1.f);
+	BOOST_TEST(data[23] == 1.f);
+}
+
+/**
+ * Tests that tangents are cached until the vertex data changes
+ */
+BOOST_AUTO_TEST_CASE(Geometry_tangents)
+{
+	GeometryAttributes layout;
+	layout.normals = true;
+	layout.uvs = true;
+	std::vector<float> vertexData = {
+		0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+		1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 0.f,
+		0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f
+	};
+	GeometryPtr geom = Geometry::create();
+	BOOST_CHECK_THROW(geom->getTangents(), IllegalArgumentException);
+
+	geom->setInterleavedVertices(layout, vertexData);
+	const float* tangents = geom->getTangents();
+	BOOST_TEST(Vector3(tangents[0], tangents[1], tangents[2]).equalTo(Vector3::XHAT, 1.0e-6));
+	BOOST_TEST(tangents[3] == 1.f);
+	BOOST_TEST(geom->getTangents() == tangents);
+
+	// Rotating the texture a quarter turn rotates the tangents
+	float uvs[] = { 0.f, 0.f, 0.f, 1.f, 1.f, 0.f };
+	geom->setTextureCoords(uvs, 3);
+	tangents = geom->getTangents();
+	BOOST_TEST(Vector3(tangents[0], tangents[1], tangents[2]).equalTo(Vector3::YHAT, 1.0e-6));
+	BOOST_TEST(tangents[3] == -1.f);
+}
+
+/**
+ * Tests that the version of a geometry is incremented whenever its vertex data changes
+ */
+BOOST_AUTO_TEST_CASE(Geometry_version)
+{
+	GeometryPtr geom = Geometry::create();
+	unsigned int version = geom->getVersion();
+
+	float vertices[] = { 0.f, 0.f, 0.f };
+	geom->setVertices(vertices, 1);
+	BOOST_TEST(geom->getVersion() > version);
+	version = geom->getVersion();
+
+	float colors[] = { 1.f, 0.f, 0.f, 1.f };
+	geom->setColors(colors, 1);
+	BOOST_TEST(geom->getVersion() > version);
+	version = geom->getVersion();
+
+	geom->removeColors();
+	BOOST_TEST(geom->getVersion() > version);
+}
+
+/**
+ * Tests the ability to set all vertex attributes from pre-interleaved vertex data
+ */
+BOOST_AUTO_TEST_CASE(Geometry_interleaved)
+{
+	GeometryAttributes layout;
+	layout.normals = true;
+	std::vector<float> data = {
+		0.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+		2.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+		2.f, 2.f, 0.f, 0.f, 0.f, 1.f
+	};
+
+	GeometryPtr geom = Geometry::create();
+	geom->setInterleavedVertices(layout, std::move(data));
+	BOOST_TEST(geom->getNumVertices() == 3);
+	BOOST_TEST(geom->size() == 3);
+	BOOST_TEST((geom->getAttributes() == layout));
+	BOOST_TEST(geom->getInterleavedVertices() != nullptr);
+	BOOST_TEST(geom->getVertices() == nullptr);
+	BOOST_TEST(geom->getNormals() == nullptr);
+	BOOST_TEST(geom->getBoundingSphere().center.equalTo(Vector3(1.f, 1.f, 0.f), 1.0e-6));
+	BOOST_REQUIRE_NO_THROW(geom->getBuffer());
+
+	// Modifying an individual attribute unpacks the interleaved data first
+	float colors[] = {
+		1.f, 0.f, 0.f, 1.f,
+		0.f, 1.f, 0.f, 1.f,
+		0.f, 0.f, 1.f, 1.f
+	};
+	geom->setColors(colors, 3);
+	BOOST_TEST(geom->getInterleavedVertices() == nullptr);
+	BOOST_REQUIRE(geom->getVertices() != nullptr);
+	BOOST_REQUIRE(geom->getNormals() != nullptr);
+	BOOST_TEST(geom->getVertices()[1] == Vector3(2.f, 0.f, 0.f));
+	BOOST_TEST(geom->getNormals()[2] == Vector3(0.f, 0.f, 1.f));
+	BOOST_TEST(geom->getAttributes().colors);
+
+	// Attributes can optionally be retained alongside the interleaved data
+	GeometryAttributes uvLayout;
+	uvLayout.uvs = true;
+	geom->setInterleavedVertices(uvLayout, { 0.f, 0.f, 0.f, 0.5f, 1.f }, true);
+	BOOST_TEST(geom->getInterleavedVertices() != nullptr);
+	BOOST_TEST(geom->getNormals() == nullptr);
+	BOOST_TEST(geom->getColors() == nullptr);
+	BOOST_REQUIRE(geom->getTextureCoords() != nullptr);
+	BOOST_TEST(geom->getTextureCoords()[0].y == 1.f);
+
+	BOOST_CHECK_THROW(geom->setInterleavedVertices(layout, { 0.f, 0.f }), IllegalArgumentException);
+}
+
+/**
+ * Tests that modified vertex ranges are written into the existing GPU buffer, and that changes in size or layout
+ * recreate it
+ */
+BOOST_AUTO_TEST_CASE(Geometry_updates)
+{
+	float vertices[] = {
+		0.f, 0.f, 0.f,
+		1.f, 0.f, 0.f,
+		1.f, 1.f, 0.f
+	};
+	GeometryPtr geom = Geometry::create();
+	geom->setUsage(BufferUsage::DYNAMIC);
+	geom->setVertices(vertices, 3);
+	BOOST_TEST((geom->getUsage() == BufferUsage::DYNAMIC));
+
+	Buffer* buffer = geom->getBuffer();
+	BOOST_TEST((buffer->getUsage() == BufferUsage::DYNAMIC));
+
+	float moved[] = { 5.f, 5.f, 5.f };
+	geom->updateVertices(2, moved, 1);
+	BOOST_TEST(geom->getVertices()[2] == Vector3(5.f, 5.f, 5.f));
+	BOOST_TEST(geom->getBoundingSphere().radius > 1.f);
+	BOOST_TEST(geom->getBuffer() == buffer);
+
+	// Replacing with the same number of vertices keeps the buffer
+	geom->setVertices(vertices, 3);
+	BOOST_TEST(geom->getBuffer() == buffer);
+
+	// Adding an attribute changes the layout
+	float colors[] = {
+		1.f, 0.f, 0.f, 1.f,
+		0.f, 1.f, 0.f, 1.f,
+		0.f, 0.f, 1.f, 1.f
+	};
+	geom->setColors(colors, 3);
+	buffer = geom->getBuffer();
+	BOOST_TEST(buffer->getNumVertices() == 3);
+	geom->updateColors(0, colors + 4, 1);
+	BOOST_TEST(geom->getColors()[0].green() == 1.f);
+	BOOST_TEST(geom->getBuffer() == buffer);
+
+	BOOST_CHECK_THROW(geom->updateVertices(2, vertices, 2), OutOfBoundsException);
+	BOOST_CHECK_THROW(geom->updateNormals(0, vertices, 1), IllegalArgumentException);
+
+	// Interleaved data is updated in place as well
+	GeometryAttributes layout;
+	layout.normals = true;
+	geom->setUsage(BufferUsage::STREAM);
+	geom->setInterleavedVertices(layout, std::vector<float>(18, 0.f));
+	buffer = geom->getBuffer();
+	BOOST_TEST((buffer->getUsage() == BufferUsage::STREAM));
+
+	float normal[] = { 0.f, 1.f, 0.f };
+	geom->updateNormals(1, normal, 1);
+	BOOST_TEST(geom->getInterleavedVertices()[10] == 1.f);
+	BOOST_TEST(geom->getBuffer() == buffer);
+}
+
+/**
+ * Tests moving vertices to new positions, including merging several into one
+ */
+BOOST_AUTO_TEST_CASE(Geometry_remapVertices)
+{
+	GeometryPtr geom = Geometry::create();
+	float vertices[] = {
+		0.f, 0.f, 0.f,
+		1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		1.f, 0.f, 0.f
+	};
+	float colors[] = {
+		1.f, 0.f, 0.f, 1.f,
+		0.f, 1.f, 0.f, 1.f,
+		0.f, 0.f, 1.f, 1.f,
+		0.f, 1.f, 0.f, 1.f
+	};
+	unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+	geom->setVertices(vertices, 4);
+	geom->setColors(colors, 4);
+	geom->setIndices(indices, 6);
+	unsigned int version = geom->getVersion();
+
+	// Reverse the vertices, merging the duplicates at positions 1 and 3
+	unsigned int remap[] = { 2, 0, 1, 0 };
+	geom->remapVertices(remap, 3);
+	BOOST_TEST(geom->getNumVertices() == 3);
+	BOOST_TEST(geom->getVersion() > version);
+	BOOST_TEST(geom->getVertices()[0] == Vector3(1.f, 0.f, 0.f));
+	BOOST_TEST(geom->getVertices()[1] == Vector3(0.f, 1.f, 0.f));
+	BOOST_TEST(geom->getVertices()[2] == Vector3(0.f, 0.f, 0.f));
+	BOOST_TEST((geom->getColors()[2] == Color(1.f, 0.f, 0.f, 1.f)));
+
+	unsigned int expected[] = { 2, 0, 1, 1, 0, 2 };
+	for (int i = 0; i < 6; i++)
+	{
+		BOOST_TEST(geom->getIndices()[i] == expected[i]);
+	}
+
+	unsigned int invalid[] = { 0, 1, 3 };
+	BOOST_CHECK_THROW(geom->remapVertices(invalid, 3), OutOfBoundsException);
+}
+
 /**
  * Tests the ability to construct a GL buffer containing the data for a geometry
  */
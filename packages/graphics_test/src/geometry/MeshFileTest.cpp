@@ -0,0 +1,196 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/geometry/MeshFile.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/BoxGeometry.h>
+#include <graphics/objects/ObjImporter.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <math/Sphere.h>
+#include <common/MappedFile.h>
+#include <common/exceptions/NullPointerException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Reads the contents of a file
+	 */
+	std::vector<char> readFile(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	/**
+	 * Writes contents to a file
+	 */
+	void writeFile(const std::string& path, const std::vector<char>& contents)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(contents.data(), contents.size());
+	}
+}
+
+/**
+ * Tests writing geometries to a mesh file and reading them back
+ */
+BOOST_AUTO_TEST_CASE(MeshFile_roundTrip)
+{
+	// A geometry holding per-attribute arrays is interleaved on export
+	GeometryPtr box = BoxGeometry::create(1, 2, 3);
+
+	GeometryAttributes layout;
+	layout.colors = true;
+	layout.colorFormat = AttributeFormat::UNSIGNED_BYTE;
+	std::vector<float> vertexData = {
+		0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
+		1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f,
+		0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f
+	};
+	GeometryPtr triangle = Geometry::create();
+	triangle->setInterleavedVertices(layout, vertexData);
+
+	std::string path = getTempPath("MeshFileTest" + MeshFile::EXTENSION);
+	MeshFile::write(path, { box, triangle });
+	BOOST_TEST(std::filesystem::file_size(path) % MeshFile::ALIGNMENT == 0);
+
+	std::vector<GeometryPtr> geometries = MeshFile::read(path);
+	BOOST_REQUIRE(geometries.size() == 2);
+
+	GeometryPtr readBox = geometries[0];
+	BOOST_TEST((readBox->getAttributes() == box->getAttributes()));
+	BOOST_TEST(readBox->getNumVertices() == box->getNumVertices());
+	BOOST_REQUIRE(readBox->size() == box->size());
+	BOOST_TEST(std::memcmp(readBox->getIndices(), box->getIndices(), box->size() * sizeof(unsigned int)) == 0);
+	BOOST_TEST(readBox->getBoundingSphere().radius == box->getBoundingSphere().radius);
+
+	GeometryPtr readTriangle = geometries[1];
+	BOOST_TEST((readTriangle->getAttributes() == triangle->getAttributes()));
+	BOOST_TEST((readTriangle->getColorFormat() == AttributeFormat::UNSIGNED_BYTE));
+	std::vector<float> readData(readTriangle->getInterleavedVertices(), readTriangle->getInterleavedVertices() + 21);
+	BOOST_TEST(readData == vertexData, boost::test_tools::per_element());
+
+	std::filesystem::remove(path);
+	BOOST_CHECK_THROW(MeshFile::write(path, { nullptr }), NullPointerException);
+}
+
+/**
+ * Tests that blocks of the file are aligned, so they can be read in place
+ */
+BOOST_AUTO_TEST_CASE(MeshFile_alignment)
+{
+	std::string path = getTempPath("MeshFileTest" + MeshFile::EXTENSION);
+	MeshFile::write(path, { BoxGeometry::create(1, 1, 1) });
+
+	// The vertex block follows the header and one geometry entry, rounded up to the alignment
+	MappedFile file(path);
+	float firstValue;
+	std::memcpy(&firstValue, file.data() + MeshFile::ALIGNMENT * 2, sizeof(float));
+	BOOST_TEST(firstValue == BoxGeometry::create(1, 1, 1)->getVertices()[0].x);
+
+	std::filesystem::remove(path);
+}
+
+/**
+ * Tests that corrupt, truncated, and incompatible files are rejected
+ */
+BOOST_AUTO_TEST_CASE(MeshFile_validation)
+{
+	std::string path = getTempPath("MeshFileTest" + MeshFile::EXTENSION);
+	MeshFile::write(path, { BoxGeometry::create(1, 1, 1) });
+	std::vector<char> contents = readFile(path);
+
+	// Flipping a single bit of the vertex data fails the checksum, unless verification is skipped
+	std::vector<char> corrupt = contents;
+	corrupt[MeshFile::ALIGNMENT * 2 + 1] ^= 1;
+	writeFile(path, corrupt);
+	BOOST_CHECK_THROW(MeshFile::read(path), InstantiationException);
+	BOOST_TEST(MeshFile::read(path, false).size() == 1);
+
+	// Other versions
+	std::vector<char> version = contents;
+	version[4]++;
+	writeFile(path, version);
+	BOOST_CHECK_THROW(MeshFile::read(path), InstantiationException);
+
+	// Other byte orders
+	std::vector<char> swapped = contents;
+	std::swap(swapped[8], swapped[11]);
+	std::swap(swapped[9], swapped[10]);
+	writeFile(path, swapped);
+	BOOST_CHECK_THROW(MeshFile::read(path), InstantiationException);
+
+	// Truncated files
+	writeFile(path, std::vector<char>(contents.begin(), contents.end() - MeshFile::ALIGNMENT));
+	BOOST_CHECK_THROW(MeshFile::read(path), InstantiationException);
+	writeFile(path, std::vector<char>(contents.begin(), contents.begin() + 16));
+	BOOST_CHECK_THROW(MeshFile::read(path), InstantiationException);
+
+	std::filesystem::remove(path);
+	BOOST_CHECK_THROW(MeshFile::read(path), InstantiationException);
+}
+
+/**
+ * Measures the cold start of loading a mesh file against importing the OBJ file it was exported from
+ */
+BOOST_AUTO_TEST_CASE(MeshFile_coldStart)
+{
+	const unsigned int size = 300;
+	std::ostringstream obj;
+	for (unsigned int y = 0; y <= size; y++)
+	{
+		for (unsigned int x = 0; x <= size; x++)
+		{
+			obj << "v " << x * 0.01f << " " << y * 0.01f << " " << (x * y % 13) * 0.001f << "\n";
+			obj << "vt " << x / (float) size << " " << y / (float) size << "\n";
+		}
+	}
+	obj << "vn 0 0 1\n";
+	for (unsigned int y = 0; y < size; y++)
+	{
+		for (unsigned int x = 0; x < size; x++)
+		{
+			unsigned int v = y * (size + 1) + x + 1;
+			unsigned int w = v + size + 1;
+			obj << "f " << v << "/" << v << "/1 " << v + 1 << "/" << v + 1 << "/1 " << w + 1 << "/" << w + 1 << "/1 "
+				<< w << "/" << w << "/1\n";
+		}
+	}
+
+	std::string objPath = getTempPath("MeshFileColdStart.obj");
+	std::string meshPath = getTempPath("MeshFileColdStart" + MeshFile::EXTENSION);
+	{
+		std::ofstream out(objPath, std::ios::binary);
+		out << obj.str();
+	}
+
+	MeshLoaderOptions options;
+	options.optimize = true;
+	auto start = std::chrono::steady_clock::now();
+	EntityGroupPtr group = ObjImporter::load(objPath, options);
+	double importSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	GeometryPtr imported = std::static_pointer_cast<Mesh>(group->getChildren()[0])->geometry;
+	MeshFile::write(meshPath, { imported });
+
+	start = std::chrono::steady_clock::now();
+	std::vector<GeometryPtr> geometries = MeshFile::read(meshPath);
+	double readSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	BOOST_REQUIRE(geometries.size() == 1);
+	BOOST_TEST(geometries[0]->size() == imported->size());
+	BOOST_TEST(std::memcmp(geometries[0]->getIndices(), imported->getIndices(), imported->size() * sizeof(unsigned int)) == 0);
+	BOOST_TEST_MESSAGE("Optimized OBJ import: " << importSeconds * 1000.0 << " ms, mesh file: " << readSeconds * 1000.0 <<
+		" ms (" << importSeconds / readSeconds << "x faster)");
+
+	std::filesystem::remove(objPath);
+	std::filesystem::remove(meshPath);
+}
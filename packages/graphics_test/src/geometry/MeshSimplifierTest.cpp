@@ -0,0 +1,276 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/geometry/MeshSimplifier.h>
+#include <graphics/geometry/Geometry.h>
+#include <math/Vector2.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/NullPointerException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Finds the largest vertical distance between a height field and a triangle list approximating it
+	 */
+	float getMaxDeviation(const std::vector<float>& vertexData, const std::vector<unsigned int>& indices,
+		float amplitude)
+	{
+		float maxDeviation = 0.f;
+		for (size_t v = 0; v < vertexData.size(); v += GRID_STRIDE)
+		{
+			float x = vertexData[v];
+			float y = vertexData[v + 1];
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const float* a = &vertexData[indices[i] * GRID_STRIDE];
+				const float* b = &vertexData[indices[i + 1] * GRID_STRIDE];
+				const float* c = &vertexData[indices[i + 2] * GRID_STRIDE];
+				float area = (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+				float wa = ((b[0] - x) * (c[1] - y) - (c[0] - x) * (b[1] - y)) / area;
+				float wb = ((c[0] - x) * (a[1] - y) - (a[0] - x) * (c[1] - y)) / area;
+				float wc = 1.f - wa - wb;
+				if (wa >= -1.0e-5f && wb >= -1.0e-5f && wc >= -1.0e-5f)
+				{
+					float z = wa * a[2] + wb * b[2] + wc * c[2];
+					maxDeviation = std::max(maxDeviation, std::abs(z - getGridHeight(x, y, amplitude)));
+					break;
+				}
+			}
+		}
+
+		return maxDeviation;
+	}
+}
+
+/**
+ * Tests that flat regions and straight borders simplify without error, keeping the corners in place
+ */
+BOOST_AUTO_TEST_CASE(MeshSimplifier_flat)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(16, 0.f, false, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / GRID_STRIDE;
+
+	float error = 1.f;
+	std::vector<unsigned int> simplified = MeshSimplifier::simplify(indices.data(), (unsigned int) indices.size(),
+		vertexData.data(), numVertices, GRID_STRIDE, 0, 1.0e-4f, &error);
+	BOOST_TEST(simplified.size() <= 12u);
+	BOOST_TEST(error == 0.f);
+
+	std::set<std::pair<float, float>> corners;
+	for (unsigned int index : simplified)
+	{
+		const float* v = &vertexData[index * GRID_STRIDE];
+		if ((v[0] == 0.f || v[0] == 1.f) && (v[1] == 0.f || v[1] == 1.f))
+		{
+			corners.insert({ v[0], v[1] });
+		}
+	}
+	BOOST_TEST(corners.size() == 4u);
+	BOOST_TEST(getMaxDeviation(vertexData, simplified, 0.f) < 1.0e-6f);
+}
+
+/**
+ * Tests that simplification stops at the target index count or error, and that the result stays close to the
+ * original surface
+ */
+BOOST_AUTO_TEST_CASE(MeshSimplifier_targets)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(32, 0.1f, false, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / GRID_STRIDE;
+	unsigned int numIndices = (unsigned int) indices.size();
+
+	std::vector<unsigned int> simplified = MeshSimplifier::simplify(indices.data(), numIndices, vertexData.data(),
+		numVertices, GRID_STRIDE, numIndices / 4, 1.f);
+	BOOST_TEST(simplified.size() <= numIndices / 4);
+	BOOST_TEST(simplified.size() > numIndices / 8);
+
+	size_t previousSize = numIndices;
+	for (float targetError : { 0.001f, 0.01f, 0.05f })
+	{
+		float error = 0.f;
+		simplified = MeshSimplifier::simplify(indices.data(), numIndices, vertexData.data(), numVertices, GRID_STRIDE,
+			0, targetError, &error);
+		BOOST_TEST(error <= targetError);
+		BOOST_TEST(simplified.size() < previousSize);
+		BOOST_TEST(getMaxDeviation(vertexData, simplified, 0.1f) < targetError * 5.f);
+		previousSize = simplified.size();
+	}
+}
+
+/**
+ * Tests that triangles never mix vertices of different texture charts, and that both sides of a seam keep matching
+ * positions
+ */
+BOOST_AUTO_TEST_CASE(MeshSimplifier_seams)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(32, 0.1f, true, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / GRID_STRIDE;
+	unsigned int numIndices = (unsigned int) indices.size();
+
+	std::vector<unsigned int> simplified = MeshSimplifier::simplify(indices.data(), numIndices, vertexData.data(),
+		numVertices, GRID_STRIDE, numIndices / 8, 1.f);
+	BOOST_TEST(simplified.size() <= numIndices / 8);
+
+	std::set<float> firstSeam;
+	std::set<float> secondSeam;
+	for (size_t i = 0; i < simplified.size(); i += 3)
+	{
+		bool second = vertexData[simplified[i] * GRID_STRIDE + 3] >= 10.f;
+		for (int c = 0; c < 3; c++)
+		{
+			const float* v = &vertexData[simplified[i + c] * GRID_STRIDE];
+			BOOST_TEST((v[3] >= 10.f) == second);
+			if (v[0] == 0.5f)
+			{
+				(second ? secondSeam : firstSeam).insert(v[1]);
+			}
+		}
+	}
+
+	// The seam is simplified, but both of its sides keep the same vertices
+	BOOST_TEST(firstSeam.size() < 33u);
+	BOOST_TEST(firstSeam.size() >= 2u);
+	BOOST_TEST((firstSeam == secondSeam));
+}
+
+/**
+ * Tests simplifying a geometry into a compact copy
+ */
+BOOST_AUTO_TEST_CASE(MeshSimplifier_geometry)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(16, 0.1f, false, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / GRID_STRIDE;
+
+	std::vector<float> positions;
+	std::vector<float> uvs;
+	for (unsigned int v = 0; v < numVertices; v++)
+	{
+		auto vertex = vertexData.begin() + v * GRID_STRIDE;
+		positions.insert(positions.end(), vertex, vertex + 3);
+		uvs.insert(uvs.end(), vertex + 3, vertex + 5);
+	}
+
+	GeometryPtr geometry = Geometry::create();
+	geometry->setIndices(indices.data(), (unsigned int) indices.size());
+	geometry->setVertices(positions.data(), numVertices);
+	geometry->setTextureCoords(uvs.data(), numVertices);
+
+	GeometryPtr simplified = MeshSimplifier::simplify(geometry, geometry->size() / 4);
+	BOOST_TEST(simplified->size() <= geometry->size() / 4);
+	BOOST_TEST(simplified->getNumVertices() < numVertices);
+	BOOST_TEST((simplified->getAttributes() == geometry->getAttributes()));
+	BOOST_REQUIRE(simplified->getTextureCoords() != nullptr);
+
+	// Every vertex is referenced, and keeps its texture coordinates
+	std::vector<bool> used(simplified->getNumVertices(), false);
+	for (unsigned int i = 0; i < simplified->size(); i++)
+	{
+		used[simplified->getIndices()[i]] = true;
+	}
+	BOOST_TEST(std::count(used.begin(), used.end(), false) == 0);
+	for (unsigned int v = 0; v < simplified->getNumVertices(); v++)
+	{
+		const Vector3& p = simplified->getVertices()[v];
+		BOOST_TEST(simplified->getTextureCoords()[v] == Vector2(p.x, p.y));
+	}
+
+	BOOST_CHECK_THROW(MeshSimplifier::simplify(Geometry::create(), 0), IllegalArgumentException);
+	unsigned int outOfRange[] = { 0, 1, 1000 };
+	BOOST_CHECK_THROW(MeshSimplifier::simplify(outOfRange, 3, positions.data(), numVertices, 3, 0),
+		OutOfBoundsException);
+	BOOST_CHECK_THROW(MeshSimplifier::simplify(indices.data(), 4, positions.data(), numVertices, 3, 0),
+		IllegalArgumentException);
+}
+
+/**
+ * Tests generating chains of levels of detail, and that doing so across threads is deterministic
+ */
+BOOST_AUTO_TEST_CASE(MeshSimplifier_generateLODs)
+{
+	std::vector<GeometryPtr> geometries;
+	for (unsigned int size : { 24, 32, 40 })
+	{
+		std::vector<float> vertexData;
+		std::vector<unsigned int> indices;
+		createGrid(size, 0.1f, true, vertexData, indices);
+
+		GeometryAttributes layout;
+		layout.uvs = true;
+		GeometryPtr geometry = Geometry::create();
+		geometry->setIndices(indices.data(), (unsigned int) indices.size());
+		geometry->setInterleavedVertices(layout, vertexData);
+		geometries.push_back(geometry);
+	}
+
+	std::vector<float> errors;
+	std::vector<GeometryPtr> levels = MeshSimplifier::generateLODs(geometries[1], 4, 0.5f, 1.f, &errors);
+	BOOST_REQUIRE(levels.size() == 4u);
+	BOOST_REQUIRE(errors.size() == 4u);
+	BOOST_TEST(levels[0] == geometries[1]);
+	BOOST_TEST(errors[0] == 0.f);
+	for (size_t i = 1; i < levels.size(); i++)
+	{
+		BOOST_TEST(levels[i]->size() <= levels[i - 1]->size() / 2 + 2);
+		BOOST_TEST(levels[i]->size() > levels[i - 1]->size() / 4);
+		BOOST_TEST(errors[i] >= errors[i - 1]);
+	}
+
+	// A tight error limit ends the chain early
+	BOOST_TEST(MeshSimplifier::generateLODs(geometries[1], 8, 0.5f, 0.002f).size() < 8u);
+
+	std::vector<std::vector<GeometryPtr>> chains = MeshSimplifier::generateLODs(geometries, 4, 0.5f, 1.f);
+	BOOST_REQUIRE(chains.size() == geometries.size());
+	for (size_t g = 0; g < geometries.size(); g++)
+	{
+		std::vector<GeometryPtr> expected = MeshSimplifier::generateLODs(geometries[g], 4, 0.5f, 1.f);
+		BOOST_REQUIRE(chains[g].size() == expected.size());
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			BOOST_REQUIRE(chains[g][i]->size() == expected[i]->size());
+			BOOST_TEST(std::memcmp(chains[g][i]->getIndices(), expected[i]->getIndices(),
+				expected[i]->size() * sizeof(unsigned int)) == 0);
+		}
+	}
+
+	BOOST_CHECK_THROW(MeshSimplifier::generateLODs(geometries[0], 4, 1.f), IllegalArgumentException);
+	BOOST_CHECK_THROW(MeshSimplifier::generateLODs(std::vector<GeometryPtr>{ nullptr }), NullPointerException);
+}
+
+/**
+ * Measures the speed and quality of simplifying a mesh of a quarter million triangles
+ */
+BOOST_AUTO_TEST_CASE(MeshSimplifier_throughput)
+{
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indices;
+	createGrid(360, 0.1f, true, vertexData, indices);
+	unsigned int numVertices = (unsigned int) vertexData.size() / GRID_STRIDE;
+	unsigned int numIndices = (unsigned int) indices.size();
+
+	auto start = std::chrono::steady_clock::now();
+	float error = 0.f;
+	std::vector<unsigned int> simplified = MeshSimplifier::simplify(indices.data(), numIndices, vertexData.data(),
+		numVertices, GRID_STRIDE, numIndices / 10, 1.f, &error);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	BOOST_TEST(simplified.size() <= numIndices / 10);
+	BOOST_TEST(error < 0.01f);
+	double trianglesPerSecond = numIndices / 3 / seconds;
+	BOOST_TEST_MESSAGE(numIndices / 3 << " to " << simplified.size() / 3 << " triangles in " << seconds * 1000.0 <<
+		" ms (" << trianglesPerSecond / 1.0e6 << "M triangles/s), error " << error);
+}
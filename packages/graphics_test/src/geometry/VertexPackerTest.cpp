@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/geometry/VertexPacker.h>
+#include <graphics/geometry/GeometryAttributes.h>
+#include <common/PrintHelpers.h>
+#include <cmath>
+#include <vector>
+
+/**
+ * Tests conversion between floats and half floats
+ */
+BOOST_AUTO_TEST_CASE(VertexPacker_half)
+{
+	BOOST_TEST(VertexPacker::fromHalf(VertexPacker::toHalf(0.f)) == 0.f);
+	BOOST_TEST(VertexPacker::fromHalf(VertexPacker::toHalf(1.f)) == 1.f);
+	BOOST_TEST(VertexPacker::fromHalf(VertexPacker::toHalf(-2.5f)) == -2.5f);
+	BOOST_TEST(VertexPacker::toHalf(1.f) == 0x3c00);
+
+	// Values in the range 0 to 1 keep roughly three decimal digits
+	for (float value = 0.f; value <= 1.f; value += 0.01f)
+	{
+		BOOST_TEST(std::abs(VertexPacker::fromHalf(VertexPacker::toHalf(value)) - value) <= 0.0005f);
+	}
+
+	// Values beyond the half float range saturate to infinity
+	BOOST_TEST(std::isinf(VertexPacker::fromHalf(VertexPacker::toHalf(1e6f))));
+}
+
+/**
+ * Tests packing unit normals into signed 10-bit components
+ */
+BOOST_AUTO_TEST_CASE(VertexPacker_normal)
+{
+	float normal[3];
+	VertexPacker::unpackNormal(VertexPacker::packNormal(0.f, 0.f, -1.f), normal);
+	BOOST_TEST(normal[0] == 0.f);
+	BOOST_TEST(normal[1] == 0.f);
+	BOOST_TEST(normal[2] == -1.f);
+
+	float n[3] = { 0.267261f, -0.534522f, 0.801784f };
+	VertexPacker::unpackNormal(VertexPacker::packNormal(n[0], n[1], n[2]), normal);
+	for (int i = 0; i < 3; i++)
+	{
+		BOOST_TEST(std::abs(normal[i] - n[i]) <= 1.f / 511.f);
+	}
+}
+
+/**
+ * Tests that packed vertices unpack to within the precision of each storage format
+ */
+BOOST_AUTO_TEST_CASE(VertexPacker_roundTrip)
+{
+	GeometryAttributes attribs = { true, true, true };
+	attribs.normalFormat = AttributeFormat::INT_2_10_10_10_REV;
+	attribs.colorFormat = AttributeFormat::UNSIGNED_BYTE;
+	attribs.uvFormat = AttributeFormat::HALF_FLOAT;
+	BOOST_TEST(attribs.getVertexSize() == 24);
+
+	std::vector<float> vertices = {
+		1.5f, -2.f, 3.25f,   0.f, 1.f, 0.f,   0.2f, 0.4f, 0.6f, 1.f,   0.25f, 0.75f,
+		-4.f, 0.5f, 8.f,     0.6f, 0.f, -0.8f,   1.f, 0.f, 0.5f, 0.3f,   0.125f, 0.9f
+	};
+	std::vector<unsigned char> packed(2 * attribs.getVertexSize());
+	VertexPacker::pack(attribs, vertices.data(), 2, packed.data());
+
+	std::vector<float> unpacked(vertices.size());
+	VertexPacker::unpack(attribs, packed.data(), 2, unpacked.data());
+	for (unsigned int v = 0; v < 2; v++)
+	{
+		const float* expected = &vertices[v * 12];
+		const float* actual = &unpacked[v * 12];
+
+		// Positions are stored exactly
+		for (int i = 0; i < 3; i++)
+		{
+			BOOST_TEST(actual[i] == expected[i]);
+		}
+
+		for (int i = 3; i < 6; i++)
+		{
+			BOOST_TEST(std::abs(actual[i] - expected[i]) <= 1.f / 511.f);
+		}
+
+		for (int i = 6; i < 10; i++)
+		{
+			BOOST_TEST(std::abs(actual[i] - expected[i]) <= 0.5f / 255.f + 1e-6f);
+		}
+
+		for (int i = 10; i < 12; i++)
+		{
+			BOOST_TEST(std::abs(actual[i] - expected[i]) <= 0.0005f);
+		}
+	}
+}
+
+/**
+ * Tests that float-only vertices are copied unchanged
+ */
+BOOST_AUTO_TEST_CASE(VertexPacker_floatOnly)
+{
+	GeometryAttributes attribs = { true, false, false };
+	BOOST_TEST(attribs.isFloatOnly());
+
+	float vertices[] = { 1.f, 2.f, 3.f, 0.f, 0.f, 1.f };
+	float packed[6];
+	VertexPacker::pack(attribs, vertices, 1, packed);
+	for (int i = 0; i < 6; i++)
+	{
+		BOOST_TEST(packed[i] == vertices[i]);
+	}
+}
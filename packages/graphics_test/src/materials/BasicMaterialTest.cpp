@@ -12,4 +12,10 @@ BOOST_AUTO_TEST_CASE(BasicMaterial_properties)
 
 	material->useVertexColors = true;
 	BOOST_TEST(material->useVertexColors);
+
+	// Materials using vertex colors cannot be batched with materials that do not
+	BasicMaterialPtr other = BasicMaterial::create();
+	BOOST_TEST(!material->canBatchWith(*other));
+	other->useVertexColors = true;
+	BOOST_TEST(material->canBatchWith(*other));
 }
\ No newline at end of file
@@ -16,4 +16,28 @@ BOOST_AUTO_TEST_CASE(Material_properties)
 	TexturePtr texture = TextureLoader::load("assets/container.jpg");
 	material->texture = texture;
 	BOOST_TEST(material->texture == texture);
+}
+
+/**
+ * Tests that materials can be batched together if they differ only in their texture coordinate transformations
+ */
+BOOST_AUTO_TEST_CASE(Material_canBatchWith)
+{
+	MaterialPtr material1 = BasicMaterial::create();
+	MaterialPtr material2 = BasicMaterial::create();
+	BOOST_TEST(material1->uvOffset == Vector2(0.f, 0.f));
+	BOOST_TEST(material1->uvScale == Vector2(1.f, 1.f));
+	BOOST_TEST(material1->canBatchWith(*material2));
+
+	material2->uvOffset = Vector2(0.5f, 0.f);
+	material2->uvScale = Vector2(0.5f, 0.5f);
+	BOOST_TEST(material1->canBatchWith(*material2));
+
+	material2->textureLayer = 2;
+	BOOST_TEST(!material1->canBatchWith(*material2));
+	material2->textureLayer = 0;
+
+	material2->color = Color::RED;
+	BOOST_TEST(!material1->canBatchWith(*material2));
+	BOOST_TEST(!material2->canBatchWith(*material1));
 }
\ No newline at end of file
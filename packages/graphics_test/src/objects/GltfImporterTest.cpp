@@ -0,0 +1,207 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/objects/GltfImporter.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <math/Vector3.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Builds the binary buffer of a single triangle: three float positions followed by three 16-bit indices
+	 */
+	std::vector<unsigned char> createTriangleBuffer()
+	{
+		float positions[] = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+		uint16_t indices[] = { 0, 1, 2, 0 };
+		std::vector<unsigned char> buffer(sizeof(positions) + sizeof(indices));
+		std::memcpy(buffer.data(), positions, sizeof(positions));
+		std::memcpy(buffer.data() + sizeof(positions), indices, sizeof(indices));
+		return buffer;
+	}
+
+	/**
+	 * Encodes data as base64
+	 */
+	std::string encodeBase64(const std::vector<unsigned char>& data)
+	{
+		const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::string encoded;
+		for (size_t i = 0; i < data.size(); i += 3)
+		{
+			unsigned int bits = data[i] << 16;
+			bits |= i + 1 < data.size() ? data[i + 1] << 8 : 0;
+			bits |= i + 2 < data.size() ? data[i + 2] : 0;
+			encoded += alphabet[(bits >> 18) & 63];
+			encoded += alphabet[(bits >> 12) & 63];
+			encoded += i + 1 < data.size() ? alphabet[(bits >> 6) & 63] : '=';
+			encoded += i + 2 < data.size() ? alphabet[bits & 63] : '=';
+		}
+		return encoded;
+	}
+
+	/**
+	 * Builds the JSON of a scene holding a translated parent node with a scaled triangle mesh child
+	 */
+	std::string createJson(const std::string& bufferUri)
+	{
+		std::string uri = bufferUri.empty() ? "" : "\"uri\": \"" + bufferUri + "\", ";
+		return
+			"{\n"
+			"  \"asset\": { \"version\": \"2.0\" },\n"
+			"  \"scene\": 0,\n"
+			"  \"scenes\": [ { \"nodes\": [ 0 ] } ],\n"
+			"  \"nodes\": [\n"
+			"    { \"name\": \"parent \\u00e9\", \"translation\": [ 1, 2, 3 ], \"children\": [ 1 ] },\n"
+			"    { \"mesh\": 0, \"scale\": [ 2, 2, 2 ], \"rotation\": [ 0, 0, 0, 1 ] }\n"
+			"  ],\n"
+			"  \"meshes\": [ { \"primitives\": [ { \"attributes\": { \"POSITION\": 0 }, \"indices\": 1, "
+			"\"material\": 0 } ] } ],\n"
+			"  \"materials\": [ { \"pbrMetallicRoughness\": { \"baseColorFactor\": [ 1, 0.5, 0.25, 1 ] } } ],\n"
+			"  \"buffers\": [ { " + uri + "\"byteLength\": 44 } ],\n"
+			"  \"bufferViews\": [\n"
+			"    { \"buffer\": 0, \"byteOffset\": 0, \"byteLength\": 36 },\n"
+			"    { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 }\n"
+			"  ],\n"
+			"  \"accessors\": [\n"
+			"    { \"bufferView\": 0, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\", "
+			"\"min\": [ 0, 0, 0 ], \"max\": [ 1.0, 1.0, 0.0 ] },\n"
+			"    { \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }\n"
+			"  ]\n"
+			"}\n";
+	}
+
+	/**
+	 * Writes data to a file in the temporary directory, returning its path
+	 */
+	std::string writeFile(const std::string& name, const void* data, size_t size)
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+		std::ofstream out(path, std::ios::binary);
+		out.write(static_cast<const char*>(data), size);
+		return path.string();
+	}
+
+	std::string writeFile(const std::string& name, const std::string& contents)
+	{
+		return writeFile(name, contents.data(), contents.size());
+	}
+
+	/**
+	 * Checks the entities imported from the scene built by createJson
+	 */
+	void checkScene(const EntityGroupPtr& group)
+	{
+		BOOST_REQUIRE(group->getChildren().size() == 1);
+		EntityPtr parent = group->getChildren()[0];
+		BOOST_TEST(parent->getPosition().x == 1.f);
+		BOOST_TEST(parent->getPosition().z == 3.f);
+
+		BOOST_REQUIRE(parent->getChildren().size() == 1);
+		MeshPtr mesh = std::dynamic_pointer_cast<Mesh>(parent->getChildren()[0]);
+		BOOST_REQUIRE(mesh.get() != nullptr);
+		BOOST_TEST(mesh->getScaling().y == 2.f);
+
+		BOOST_TEST(mesh->geometry->size() == 3);
+		BOOST_TEST(mesh->geometry->getNumVertices() == 3);
+		BOOST_TEST(mesh->geometry->getInterleavedVertices()[3] == 1.f);
+		BOOST_TEST(mesh->material->color.green() == 0.5f);
+	}
+}
+
+/**
+ * Tests importing a glTF file with its buffer embedded as a data URI
+ */
+BOOST_AUTO_TEST_CASE(GltfImporter_dataUri)
+{
+	std::string uri = "data:application/octet-stream;base64," + encodeBase64(createTriangleBuffer());
+	std::string path = writeFile("GltfImporterTest.gltf", createJson(uri));
+
+	checkScene(GltfImporter::load(path, MeshLoaderOptions()));
+	std::filesystem::remove(path);
+}
+
+/**
+ * Tests importing a glTF file whose buffer is stored in a separate file
+ */
+BOOST_AUTO_TEST_CASE(GltfImporter_externalBuffer)
+{
+	std::vector<unsigned char> buffer = createTriangleBuffer();
+	std::string bufferPath = writeFile("GltfImporter Test.bin", buffer.data(), buffer.size());
+	std::string path = writeFile("GltfImporterTest.gltf", createJson("GltfImporter%20Test.bin"));
+
+	checkScene(GltfImporter::load(path, MeshLoaderOptions()));
+	std::filesystem::remove(path);
+	std::filesystem::remove(bufferPath);
+}
+
+/**
+ * Tests importing a binary glTF file
+ */
+BOOST_AUTO_TEST_CASE(GltfImporter_binary)
+{
+	std::string json = createJson("");
+	json.resize((json.size() + 3) & ~(size_t) 3, ' ');
+	std::vector<unsigned char> buffer = createTriangleBuffer();
+
+	auto append = [](std::vector<unsigned char>& data, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			data.push_back((unsigned char) (value >> (i * 8)));
+		}
+	};
+
+	std::vector<unsigned char> glb;
+	append(glb, 0x46546C67);
+	append(glb, 2);
+	append(glb, (uint32_t) (12 + 8 + json.size() + 8 + buffer.size()));
+	append(glb, (uint32_t) json.size());
+	append(glb, 0x4E4F534A);
+	glb.insert(glb.end(), json.begin(), json.end());
+	append(glb, (uint32_t) buffer.size());
+	append(glb, 0x004E4942);
+	glb.insert(glb.end(), buffer.begin(), buffer.end());
+
+	std::string path = writeFile("GltfImporterTest.glb", glb.data(), glb.size());
+	checkScene(GltfImporter::load(path, MeshLoaderOptions()));
+
+	// Truncated files are rejected
+	path = writeFile("GltfImporterTest.glb", glb.data(), glb.size() - 8);
+	BOOST_CHECK_THROW(GltfImporter::load(path, MeshLoaderOptions()), InstantiationException);
+	std::filesystem::remove(path);
+}
+
+/**
+ * Tests that malformed or unsupported files are rejected
+ */
+BOOST_AUTO_TEST_CASE(GltfImporter_malformed)
+{
+	std::string path = writeFile("GltfImporterTest.gltf", "{ \"asset\": { \"version\": \"2.0\" }, ");
+	BOOST_CHECK_THROW(GltfImporter::load(path, MeshLoaderOptions()), InstantiationException);
+
+	path = writeFile("GltfImporterTest.gltf", "{ \"asset\": { \"version\": \"1.0\" } }");
+	BOOST_CHECK_THROW(GltfImporter::load(path, MeshLoaderOptions()), InstantiationException);
+
+	// Buffers must hold the data referenced by their views
+	std::string json = createJson("data:application/octet-stream;base64,AAAA");
+	path = writeFile("GltfImporterTest.gltf", json);
+	BOOST_CHECK_THROW(GltfImporter::load(path, MeshLoaderOptions()), InstantiationException);
+
+	// A file without scenes imports every root node
+	path = writeFile("GltfImporterTest.gltf", "{ \"asset\": { \"version\": \"2.0\" }, \"nodes\": [ { \"children\": "
+		"[ 1 ] }, { }, { } ] }");
+	BOOST_TEST(GltfImporter::load(path, MeshLoaderOptions())->getChildren().size() == 2);
+
+	std::filesystem::remove(path);
+	BOOST_CHECK_THROW(GltfImporter::load(path, MeshLoaderOptions()), InstantiationException);
+}
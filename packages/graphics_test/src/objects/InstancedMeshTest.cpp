@@ -0,0 +1,102 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/objects/InstancedMesh.h>
+#include <graphics/core/InstanceBuffer.h>
+#include <graphics/geometry/BoxGeometry.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <math/Frustum.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/Constants.h>
+#include <common/PrintHelpers.h>
+
+/**
+ * Tests the basic construction of an instanced mesh
+ */
+BOOST_AUTO_TEST_CASE(InstancedMesh_basics)
+{
+	GeometryPtr geometry = BoxGeometry::create(1, 1, 1);
+	MaterialPtr material = BasicMaterial::create();
+	InstancedMeshPtr mesh = InstancedMesh::create(geometry, material, 10);
+
+	BOOST_TEST(mesh->entityType == EntityType::INSTANCED_MESH);
+	BOOST_TEST(mesh->geometry == geometry);
+	BOOST_TEST(mesh->material == material);
+	BOOST_TEST(mesh->getCount() == 10);
+	BOOST_TEST(mesh->getTransform(9).isIdentity());
+	BOOST_TEST(mesh->getColor(9) == Color::WHITE);
+}
+
+/**
+ * Tests the ability to set the transformation, color, and layer of individual instances
+ */
+BOOST_AUTO_TEST_CASE(InstancedMesh_setters)
+{
+	InstancedMeshPtr mesh = InstancedMesh::create(BoxGeometry::create(1, 1, 1), BasicMaterial::create(), 3);
+
+	Matrix4 transform = Matrix4::fromTranslation(Vector3(1.f, 2.f, 3.f));
+	mesh->setTransform(1, transform);
+	mesh->setColor(1, Color::RED);
+
+	BOOST_TEST(mesh->getTransform(1) == transform);
+	BOOST_TEST(mesh->getColor(1) == Color::RED);
+	BOOST_TEST(mesh->getColor(0) == Color::WHITE);
+	BOOST_TEST(mesh->getInstances()[1].color[0] == 255);
+	BOOST_TEST(mesh->getInstances()[1].color[1] == 0);
+
+	// Channels are quantized to bytes
+	mesh->setColor(2, Color(0.f, 0.25f, 0.5f, 1.f));
+	BOOST_TEST(mesh->getColor(2) == Color(0.f, 64 / 255.f, 128 / 255.f, 1.f));
+	BOOST_TEST(mesh->getTransform(0).isIdentity());
+	BOOST_TEST(mesh->getInstances()[1].transform[7] == 2.f);
+
+	BOOST_TEST(mesh->getLayer(1) == 0u);
+	mesh->setLayer(1, 5);
+	BOOST_TEST(mesh->getLayer(1) == 5u);
+	BOOST_TEST(mesh->getInstances()[1].layer == 5.f);
+
+	InstanceData data[2] = { mesh->getInstances()[1], mesh->getInstances()[1] };
+	mesh->setInstances(1, data, 2);
+	BOOST_TEST(mesh->getTransform(2) == transform);
+	BOOST_TEST(mesh->getLayer(2) == 5u);
+
+	BOOST_REQUIRE_THROW(mesh->setTransform(3, transform), OutOfBoundsException);
+	BOOST_REQUIRE_THROW(mesh->getColor(3), OutOfBoundsException);
+	BOOST_REQUIRE_THROW(mesh->setLayer(3, 1), OutOfBoundsException);
+	BOOST_REQUIRE_THROW(mesh->setInstances(2, data, 2), OutOfBoundsException);
+}
+
+/**
+ * Tests the ability to cull instances lying outside of a frustum
+ */
+BOOST_AUTO_TEST_CASE(InstancedMesh_cull)
+{
+	InstancedMeshPtr mesh = InstancedMesh::create(BoxGeometry::create(1, 1, 1), BasicMaterial::create(), 3);
+	mesh->setTransform(0, Matrix4::fromTranslation(Vector3(0.f, 0.f, -10.f)));
+	mesh->setTransform(1, Matrix4::fromTranslation(Vector3(0.f, 0.f, 10.f)));
+	mesh->setTransform(2, Matrix4::fromTranslation(Vector3(50.f, 0.f, -10.f)));
+
+	Frustum frustum = Frustum::fromMatrix(Matrix4::fromPerspective(PI / 2.f, 1.f, 1.f, 100.f));
+	BOOST_TEST(mesh->cull(frustum, Matrix4::IDENTITY) == 1);
+	BOOST_TEST(mesh->getVisibleInstances()[0] == 0);
+
+	// Transformation of the mesh itself is applied on top of instance transformations
+	BOOST_TEST(mesh->cull(frustum, Matrix4::fromTranslation(Vector3(-50.f, 0.f, 0.f))) == 1);
+	BOOST_TEST(mesh->getVisibleInstances()[0] == 2);
+
+	mesh->frustumCulled = false;
+	BOOST_TEST(mesh->cull(frustum, Matrix4::IDENTITY) == 3);
+}
+
+/**
+ * Tests the ability to create the GPU buffer of an instanced mesh, and to re-upload modified instances
+ */
+BOOST_AUTO_TEST_CASE(InstancedMesh_buffer)
+{
+	InstancedMeshPtr mesh = InstancedMesh::create(BoxGeometry::create(1, 1, 1), BasicMaterial::create(), 5);
+
+	InstanceBuffer* buffer = mesh->getBuffer();
+	BOOST_TEST(buffer != nullptr);
+	BOOST_TEST(buffer->capacity == 5);
+
+	mesh->setColor(3, Color::BLUE);
+	BOOST_TEST(mesh->getBuffer() == buffer);
+}
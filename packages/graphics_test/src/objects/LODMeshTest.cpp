@@ -0,0 +1,128 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/objects/LODMesh.h>
+#include <graphics/geometry/BoxGeometry.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <math/Matrix4.h>
+#include <math/Sphere.h>
+#include <math/Vector3.h>
+#include <common/Utils.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/NullPointerException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <limits>
+
+namespace
+{
+	LODMeshPtr createMesh()
+	{
+		std::vector<GeometryPtr> levels = { BoxGeometry::create(1, 1, 1), BoxGeometry::create(1, 1, 1),
+			BoxGeometry::create(1, 1, 1) };
+		return LODMesh::create(levels, { 0.5f, 0.25f }, BasicMaterial::create());
+	}
+}
+
+/**
+ * Tests the construction of a mesh with several levels of detail
+ */
+BOOST_AUTO_TEST_CASE(LODMesh_create)
+{
+	std::vector<GeometryPtr> levels = { BoxGeometry::create(2, 2, 2), BoxGeometry::create(1, 1, 1) };
+	MaterialPtr material = BasicMaterial::create();
+	LODMeshPtr mesh = LODMesh::create(levels, { 0.3f }, material);
+
+	BOOST_TEST(mesh->entityType == EntityType::MESH);
+	BOOST_TEST(mesh->geometry == levels[0]);
+	BOOST_TEST(mesh->material == material);
+	BOOST_TEST(mesh->getNumLevels() == 2u);
+	BOOST_TEST(mesh->getLevel(1) == levels[1]);
+	BOOST_TEST(mesh->getThreshold(0) == 0.3f);
+	BOOST_TEST(mesh->getCurrentLevel() == 0u);
+	BOOST_CHECK_THROW(mesh->getLevel(2), OutOfBoundsException);
+	BOOST_CHECK_THROW(mesh->getThreshold(1), OutOfBoundsException);
+
+	BOOST_CHECK_THROW(LODMesh::create({}, {}, material), IllegalArgumentException);
+	BOOST_CHECK_THROW(LODMesh::create(levels, {}, material), IllegalArgumentException);
+	BOOST_CHECK_THROW(LODMesh::create({ levels[0], levels[1], levels[1] }, { 0.2f, 0.3f }, material),
+		IllegalArgumentException);
+	BOOST_CHECK_THROW(LODMesh::create({ levels[0], nullptr }, { 0.3f }, material), NullPointerException);
+}
+
+/**
+ * Tests selecting levels by screen coverage, with hysteresis around the thresholds
+ */
+BOOST_AUTO_TEST_CASE(LODMesh_update)
+{
+	LODMeshPtr mesh = createMesh();
+	BOOST_TEST(mesh->update(1.f, 0.f) == 0u);
+
+	// Within the hysteresis margin of the first threshold, the level does not change
+	BOOST_TEST(mesh->update(0.46f, 0.f) == 0u);
+	BOOST_TEST(mesh->update(0.44f, 0.f) == 1u);
+	BOOST_TEST(mesh->update(0.54f, 0.f) == 1u);
+	BOOST_TEST(mesh->update(0.56f, 0.f) == 0u);
+
+	// Several levels can be skipped at once
+	BOOST_TEST(mesh->update(0.01f, 0.f) == 2u);
+	BOOST_TEST(mesh->update(std::numeric_limits<float>::max(), 0.f) == 0u);
+
+	mesh->hysteresis = 0.f;
+	BOOST_TEST(mesh->update(0.49f, 0.f) == 1u);
+	BOOST_TEST(mesh->getFadingLevel() == 1u);
+	BOOST_TEST(mesh->getFadeProgress(0.f) == 1.f);
+}
+
+/**
+ * Tests cross-fading between levels over time
+ */
+BOOST_AUTO_TEST_CASE(LODMesh_crossFade)
+{
+	LODMeshPtr mesh = createMesh();
+	mesh->crossFade = true;
+	mesh->fadeDuration = 1.f;
+
+	// The first level is selected without fading
+	BOOST_TEST(mesh->update(0.4f, 9.f) == 1u);
+	BOOST_TEST(mesh->getFadingLevel() == 1u);
+
+	BOOST_TEST(mesh->update(1.f, 10.f) == 0u);
+	BOOST_TEST(mesh->getFadingLevel() == 1u);
+	BOOST_TEST(mesh->update(1.f, 11.f) == 0u);
+	BOOST_TEST(mesh->getFadingLevel() == 0u);
+
+	BOOST_TEST(mesh->update(0.1f, 11.f) == 2u);
+	BOOST_TEST(mesh->getFadingLevel() == 0u);
+	BOOST_TEST(mesh->getFadeProgress(11.f) == 0.f);
+
+	BOOST_TEST(mesh->update(0.1f, 11.5f) == 2u);
+	BOOST_TEST(mesh->getFadingLevel() == 0u);
+	BOOST_TEST(mesh->getFadeProgress(11.5f) == 0.5f);
+
+	BOOST_TEST(mesh->update(0.1f, 12.f) == 2u);
+	BOOST_TEST(mesh->getFadingLevel() == 2u);
+	BOOST_TEST(mesh->getFadeProgress(12.f) == 1.f);
+}
+
+/**
+ * Tests computing the screen coverage of bounding spheres
+ */
+BOOST_AUTO_TEST_CASE(LODMesh_computeScreenCoverage)
+{
+	Sphere bounds(Vector3(0.f, 0.f, -10.f), 1.f);
+	Vector3 camera(0.f, 0.f, 0.f);
+
+	// With a 90 degree field of view, half of the viewport height spans the view distance
+	BOOST_TEST(equals(LODMesh::computeScreenCoverage(bounds, Matrix4::IDENTITY, camera, 90.f), 0.1f, 1.0e-6));
+	BOOST_TEST(equals(LODMesh::computeScreenCoverage(bounds, Matrix4::fromScaling(2.f), camera, 90.f),
+		0.1f, 1.0e-6));
+	BOOST_TEST(equals(LODMesh::computeScreenCoverage(bounds, Matrix4::fromTranslation(Vector3(0.f, 0.f, 5.f)), camera,
+		90.f), 0.2f, 1.0e-6));
+
+	// Narrower fields of view magnify, and each unit of bias halves the coverage
+	BOOST_TEST(LODMesh::computeScreenCoverage(bounds, Matrix4::IDENTITY, camera, 30.f) > 0.1f);
+	BOOST_TEST(equals(LODMesh::computeScreenCoverage(bounds, Matrix4::IDENTITY, camera, 90.f, 1.f), 0.05f, 1.0e-6));
+
+	BOOST_TEST(LODMesh::computeScreenCoverage(bounds, Matrix4::IDENTITY, Vector3(0.f, 0.f, -10.5f), 90.f) ==
+		std::numeric_limits<float>::max());
+	BOOST_TEST(LODMesh::computeScreenCoverage(Sphere(), Matrix4::IDENTITY, camera, 90.f) == 0.f);
+}
@@ -0,0 +1,47 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/objects/MeshLoader.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/geometry/BoxGeometry.h>
+#include <graphics/geometry/MeshFile.h>
+#include <common/Utils.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * Tests choosing the importer from the file extension
+ */
+BOOST_AUTO_TEST_CASE(MeshLoader_load)
+{
+	{
+		std::ofstream out(resolvePath("MeshLoaderTest.OBJ"), std::ios::binary);
+		out << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+	}
+
+	EntityGroupPtr group = MeshLoader::load("MeshLoaderTest.OBJ");
+	BOOST_REQUIRE(group->getChildren().size() == 1);
+	BOOST_TEST(std::static_pointer_cast<Mesh>(group->getChildren()[0])->geometry->size() == 3);
+	std::filesystem::remove(resolvePath("MeshLoaderTest.OBJ"));
+
+	BOOST_CHECK_THROW(MeshLoader::load("MeshLoaderTest.OBJ"), InstantiationException);
+	BOOST_CHECK_THROW(MeshLoader::load("MeshLoaderTest.fbx"), IllegalArgumentException);
+}
+
+/**
+ * Tests loading mesh cache files
+ */
+BOOST_AUTO_TEST_CASE(MeshLoader_meshFile)
+{
+	std::string path = "MeshLoaderTest" + MeshFile::EXTENSION;
+	MeshFile::write(resolvePath(path), { BoxGeometry::create(1, 1, 1), BoxGeometry::create(2, 2, 2) });
+
+	EntityGroupPtr group = MeshLoader::load(path);
+	BOOST_REQUIRE(group->getChildren().size() == 2);
+	MeshPtr mesh = std::static_pointer_cast<Mesh>(group->getChildren()[1]);
+	BOOST_TEST(mesh->geometry->size() == 36);
+	BOOST_TEST(mesh->geometry->getBoundingSphere().radius > 1.f);
+	std::filesystem::remove(resolvePath(path));
+}
@@ -0,0 +1,291 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/objects/ObjImporter.h>
+#include <graphics/objects/Mesh.h>
+#include <graphics/core/EntityGroup.h>
+#include <graphics/geometry/Geometry.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Parses a string with the given options
+	 */
+	EntityGroupPtr parse(const std::string& obj, size_t chunkSize = ObjImporter::DEFAULT_CHUNK_SIZE,
+		unsigned int numThreads = 1)
+	{
+		MeshLoaderOptions options;
+		options.numThreads = numThreads;
+		options.compactFormats = false;
+		return ObjImporter::parse(obj.data(), obj.size(), options, chunkSize);
+	}
+
+	/**
+	 * Returns the geometry of the mesh at the given child index
+	 */
+	GeometryPtr getGeometry(const EntityGroupPtr& group, size_t index)
+	{
+		return std::static_pointer_cast<Mesh>(group->getChildren()[index])->geometry;
+	}
+
+	/**
+	 * Builds an OBJ grid of quads split into several groups, with a mix of absolute and relative indices
+	 */
+	std::string createGrid(unsigned int size, unsigned int numGroups)
+	{
+		std::ostringstream obj;
+		for (unsigned int y = 0; y <= size; y++)
+		{
+			for (unsigned int x = 0; x <= size; x++)
+			{
+				obj << "v " << x << " " << y << " " << (x * y % 7) * 0.125f << "\n";
+				obj << "vt " << x / (float) size << " " << y / (float) size << "\n";
+			}
+		}
+		obj << "vn 0 0 1\n";
+
+		unsigned int row = size + 1;
+		for (unsigned int y = 0; y < size; y++)
+		{
+			if (y % (size / numGroups) == 0)
+			{
+				obj << "g group" << y << "\n";
+			}
+
+			for (unsigned int x = 0; x < size; x++)
+			{
+				unsigned int v = y * row + x + 1;
+				if (x % 2 == 0)
+				{
+					obj << "f " << v << "/" << v << "/1 " << v + 1 << "/" << v + 1 << "/1 " << v + row + 1 << "/"
+						<< v + row + 1 << "/1 " << v + row << "/" << v + row << "/1\n";
+				}
+				else
+				{
+					// Relative indices count back from the last vertex of the grid
+					int last = (int) (row * row) + 1;
+					obj << "f " << (int) v - last << "/" << (int) v - last << "/-1 " << (int) (v + 1) - last << "/"
+						<< (int) (v + 1) - last << "/-1 " << (int) (v + row + 1) - last << "/" << (int) (v + row + 1) - last
+						<< "/-1\n";
+				}
+			}
+		}
+
+		return obj.str();
+	}
+}
+
+/**
+ * Tests parsing floating point numbers
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_parseFloat)
+{
+	auto parseFloat = [](const std::string& str, float& value)
+	{
+		const char* end = ObjImporter::parseFloat(str.data(), str.data() + str.size(), value);
+		return end ? (int) (end - str.data()) : -1;
+	};
+
+	float value = 0.f;
+	BOOST_TEST(parseFloat("1", value) == 1);
+	BOOST_TEST(value == 1.f);
+	BOOST_TEST(parseFloat("-2.5 ", value) == 4);
+	BOOST_TEST(value == -2.5f);
+	BOOST_TEST(parseFloat("+0.125", value) == 6);
+	BOOST_TEST(value == 0.125f);
+	BOOST_TEST(parseFloat(".5", value) == 2);
+	BOOST_TEST(value == 0.5f);
+	BOOST_TEST(parseFloat("5.", value) == 2);
+	BOOST_TEST(value == 5.f);
+	BOOST_TEST(parseFloat("1e3", value) == 3);
+	BOOST_TEST(value == 1000.f);
+	BOOST_TEST(parseFloat("1.5E-2/", value) == 6);
+	BOOST_TEST(value == 0.015f);
+	BOOST_TEST(parseFloat("2e", value) == 1);
+	BOOST_TEST(value == 2.f);
+
+	// Long runs of digits are converted eight at a time
+	BOOST_TEST(parseFloat("3.14159265358979323846", value) == 22);
+	BOOST_TEST(value == 3.14159265358979323846f);
+	BOOST_TEST(parseFloat("12345678901234567890123", value) == 23);
+	BOOST_TEST(value == 12345678901234567890123.f);
+	BOOST_TEST(parseFloat("0.0000000000000000000001234", value) == 27);
+	BOOST_TEST(value == 1.234e-22f);
+	BOOST_TEST(parseFloat("-1.17549435e-38", value) == 15);
+	BOOST_TEST(value == -1.17549435e-38f);
+
+	BOOST_TEST(parseFloat("", value) == -1);
+	BOOST_TEST(parseFloat("-", value) == -1);
+	BOOST_TEST(parseFloat(".", value) == -1);
+	BOOST_TEST(parseFloat("x1", value) == -1);
+}
+
+/**
+ * Tests importing objects with texture coordinates, normals, polygons, and relative indices
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_parse)
+{
+	std::string obj =
+		"# Two objects\n"
+		"v 0 0 0\n"
+		"v 1 0 0\n"
+		"v 1 1 0\n"
+		"v 0 1 0\n"
+		"vt 0 0\n"
+		"vt 1 0\n"
+		"vt 1 1\n"
+		"vt 0 1\n"
+		"vn 0 0 1\n"
+		"o quad\n"
+		"f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+		"o triangle\r\n"
+		"f -4//1 -3//1 -2//1 # trailing comment\r\n";
+
+	EntityGroupPtr group = parse(obj);
+	BOOST_REQUIRE(group->getChildren().size() == 2);
+
+	// The quad is triangulated as a fan, sharing its vertices
+	GeometryPtr quad = getGeometry(group, 0);
+	GeometryAttributes attributes = quad->getAttributes();
+	BOOST_TEST(attributes.normals);
+	BOOST_TEST(attributes.uvs);
+	BOOST_TEST(!attributes.colors);
+	BOOST_TEST(quad->getNumVertices() == 4);
+	std::vector<unsigned int> indices(quad->getIndices(), quad->getIndices() + quad->size());
+	std::vector<unsigned int> expectedIndices = { 0, 1, 2, 0, 2, 3 };
+	BOOST_TEST(indices == expectedIndices, boost::test_tools::per_element());
+
+	std::vector<float> vertex(quad->getInterleavedVertices() + 16, quad->getInterleavedVertices() + 24);
+	std::vector<float> expectedVertex = { 1.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f };
+	BOOST_TEST(vertex == expectedVertex, boost::test_tools::per_element());
+
+	GeometryPtr triangle = getGeometry(group, 1);
+	BOOST_TEST(triangle->getAttributes().normals);
+	BOOST_TEST(!triangle->getAttributes().uvs);
+	BOOST_TEST(triangle->size() == 3);
+	BOOST_TEST(triangle->getInterleavedVertices()[0] == 0.f);
+	BOOST_TEST(triangle->getInterleavedVertices()[6] == 1.f);
+
+	// All meshes share a single material
+	MeshPtr first = std::static_pointer_cast<Mesh>(group->getChildren()[0]);
+	MeshPtr second = std::static_pointer_cast<Mesh>(group->getChildren()[1]);
+	BOOST_TEST(first->material == second->material);
+}
+
+/**
+ * Tests that compact formats are applied to imported geometry
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_compactFormats)
+{
+	std::string obj = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nvt 0 0\nf 1/1/1 2/1/1 3/1/1\n";
+	MeshLoaderOptions options;
+	EntityGroupPtr group = ObjImporter::parse(obj.data(), obj.size(), options);
+
+	GeometryAttributes attributes = getGeometry(group, 0)->getAttributes();
+	BOOST_TEST((attributes.normalFormat == AttributeFormat::INT_2_10_10_10_REV));
+	BOOST_TEST((attributes.uvFormat == AttributeFormat::HALF_FLOAT));
+	BOOST_TEST(attributes.getVertexSize() == 20);
+}
+
+/**
+ * Tests importing vertex colors appended to vertex positions
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_vertexColors)
+{
+	std::string obj = "v 0 0 0 1 0 0\nv 1 0 0\nv 0 1 0 0 0 1\nf 1 2 3\n";
+	EntityGroupPtr group = parse(obj);
+
+	MeshPtr mesh = std::static_pointer_cast<Mesh>(group->getChildren()[0]);
+	BOOST_TEST(std::static_pointer_cast<BasicMaterial>(mesh->material)->useVertexColors);
+	BOOST_TEST(mesh->geometry->getAttributes().colors);
+
+	// Vertices without a color are white
+	const float* data = mesh->geometry->getInterleavedVertices();
+	std::vector<float> colors(data + 3, data + 7);
+	std::vector<float> expectedColors = { 1.f, 0.f, 0.f, 1.f };
+	BOOST_TEST(colors == expectedColors, boost::test_tools::per_element());
+	colors.assign(data + 10, data + 14);
+	expectedColors = { 1.f, 1.f, 1.f, 1.f };
+	BOOST_TEST(colors == expectedColors, boost::test_tools::per_element());
+}
+
+/**
+ * Tests that parsing in parallel chunks produces the same output as parsing sequentially
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_chunks)
+{
+	std::string obj = createGrid(32, 4);
+	EntityGroupPtr sequential = parse(obj);
+	EntityGroupPtr parallel = parse(obj, 256, 4);
+
+	BOOST_REQUIRE(sequential->getChildren().size() == 4);
+	BOOST_REQUIRE(parallel->getChildren().size() == 4);
+	for (size_t i = 0; i < 4; i++)
+	{
+		GeometryPtr expected = getGeometry(sequential, i);
+		GeometryPtr actual = getGeometry(parallel, i);
+		BOOST_TEST(expected->size() == 8 * 32 * 3 / 2 * 3);
+		BOOST_REQUIRE(actual->size() == expected->size());
+		BOOST_REQUIRE(actual->getNumVertices() == expected->getNumVertices());
+		BOOST_TEST(std::memcmp(actual->getIndices(), expected->getIndices(), expected->size() * sizeof(unsigned int)) == 0);
+		BOOST_TEST(std::memcmp(actual->getInterleavedVertices(), expected->getInterleavedVertices(),
+			expected->getNumVertices() * expected->getAttributes().getStride() * sizeof(float)) == 0);
+	}
+}
+
+/**
+ * Tests that malformed data is rejected
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_malformed)
+{
+	BOOST_CHECK_THROW(parse("v 0 0 0\nv 1 0 0\nf 1 2\n"), InstantiationException);
+	BOOST_CHECK_THROW(parse("v 0 x 0\n"), InstantiationException);
+	BOOST_CHECK_THROW(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n"), InstantiationException);
+	BOOST_CHECK_THROW(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/1 2/1 3/1\n"), InstantiationException);
+	BOOST_CHECK_THROW(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf -4 -3 -2\n"), InstantiationException);
+	BOOST_CHECK_THROW(parse("v 0 0 0\nf 1 1 0\n"), InstantiationException);
+
+	// Empty data and unknown statements produce no meshes
+	BOOST_TEST(parse("").get() != nullptr);
+	BOOST_TEST(parse("mtllib scene.mtl\ns off\n").get()->getChildren().empty());
+}
+
+/**
+ * Measures the throughput of importing a large generated OBJ file
+ */
+BOOST_AUTO_TEST_CASE(ObjImporter_throughput)
+{
+	const unsigned int size = 400;
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "ObjImporterThroughput.obj";
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << createGrid(size, 1);
+	}
+	double megabytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+	for (unsigned int numThreads : { 1u, 0u })
+	{
+		MeshLoaderOptions options;
+		options.numThreads = numThreads;
+
+		auto start = std::chrono::steady_clock::now();
+		EntityGroupPtr group = ObjImporter::load(path.string(), options);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		BOOST_REQUIRE(group->getChildren().size() == 1);
+		unsigned int numTriangles = getGeometry(group, 0)->size() / 3;
+		BOOST_TEST(numTriangles == size * size * 3 / 2);
+		BOOST_TEST_MESSAGE("OBJ import with " << (numThreads == 0 ? "all" : "1") << " thread(s): " << megabytes /
+			seconds << " MB/s, " << numTriangles / seconds / 1e6 << " million triangles/s");
+	}
+
+	std::filesystem::remove(path);
+}
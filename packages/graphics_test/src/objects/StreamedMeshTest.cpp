@@ -0,0 +1,27 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/objects/StreamedMesh.h>
+#include <graphics/core/MeshStreamer.h>
+#include <graphics/geometry/ClusterFile.h>
+#include <graphics/geometry/BoxGeometry.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <common/exceptions/NullPointerException.h>
+#include <common/PrintHelpers.h>
+#include <filesystem>
+
+/**
+ * Tests the construction of a streamed mesh
+ */
+BOOST_AUTO_TEST_CASE(StreamedMesh_create)
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / ("StreamedMeshTest" + ClusterFile::EXTENSION);
+	ClusterFile::write(path.string(), BoxGeometry::create(1, 1, 1));
+
+	MeshStreamerPtr streamer = MeshStreamer::create(path.string(), 1 << 16, 1);
+	MaterialPtr material = BasicMaterial::create();
+	StreamedMeshPtr mesh = StreamedMesh::create(streamer, material);
+
+	BOOST_TEST(mesh->entityType == EntityType::STREAMED_MESH);
+	BOOST_TEST(mesh->getStreamer() == streamer);
+	BOOST_TEST(mesh->material == material);
+	BOOST_CHECK_THROW(StreamedMesh::create(nullptr, material), NullPointerException);
+}
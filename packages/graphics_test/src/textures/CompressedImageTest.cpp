@@ -0,0 +1,282 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics_test/TestHelpers.h>
+#include <graphics/textures/CompressedImage.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Appends a little endian integer to a byte array
+	 */
+	template <typename T>
+	void append(std::vector<unsigned char>& bytes, T value)
+	{
+		unsigned char buffer[sizeof(T)];
+		std::memcpy(buffer, &value, sizeof(T));
+		bytes.insert(bytes.end(), buffer, buffer + sizeof(T));
+	}
+
+	/**
+	 * Writes a byte array to a file
+	 */
+	void writeFile(const std::string& path, const std::vector<unsigned char>& bytes)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write((const char*) bytes.data(), bytes.size());
+	}
+
+	/**
+	 * Builds a DDS file holding the given blocks
+	 * @param code Format code, or "DX10" followed by the DXGI format
+	 */
+	std::vector<unsigned char> createDDS(const char* code, uint32_t width, uint32_t height, uint32_t numLevels,
+		const std::vector<unsigned char>& blocks, uint32_t dxgiFormat = 0, uint32_t caps2 = 0)
+	{
+		std::vector<unsigned char> bytes;
+		append<uint32_t>(bytes, 0x20534444);
+		append<uint32_t>(bytes, 124);
+		append<uint32_t>(bytes, 0x1007 | 0x20000);
+		append<uint32_t>(bytes, height);
+		append<uint32_t>(bytes, width);
+		append<uint32_t>(bytes, 0);
+		append<uint32_t>(bytes, 0);
+		append<uint32_t>(bytes, numLevels);
+		bytes.resize(76, 0);
+		append<uint32_t>(bytes, 32);
+		append<uint32_t>(bytes, 0x4);
+		bytes.insert(bytes.end(), code, code + 4);
+		bytes.resize(112, 0);
+		append<uint32_t>(bytes, caps2);
+		bytes.resize(128, 0);
+		if (std::strcmp(code, "DX10") == 0)
+		{
+			append<uint32_t>(bytes, dxgiFormat);
+			append<uint32_t>(bytes, 3);
+			append<uint32_t>(bytes, 0);
+			append<uint32_t>(bytes, 1);
+			append<uint32_t>(bytes, 0);
+		}
+		bytes.insert(bytes.end(), blocks.begin(), blocks.end());
+		return bytes;
+	}
+
+	/**
+	 * Builds a KTX2 file holding the given levels, largest first. Levels are stored smallest first, as the format
+	 * recommends.
+	 */
+	std::vector<unsigned char> createKTX2(uint32_t vkFormat, uint32_t width, uint32_t height,
+		const std::vector<std::vector<unsigned char>>& levels, uint32_t numFaces = 1)
+	{
+		const unsigned char identifier[] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		std::vector<unsigned char> bytes(identifier, identifier + sizeof(identifier));
+		for (uint32_t value : { vkFormat, 1u, width, height, 0u, 0u, numFaces, (uint32_t) levels.size(), 0u })
+		{
+			append<uint32_t>(bytes, value);
+		}
+		bytes.resize(80, 0);
+
+		uint64_t offset = 80 + levels.size() * 24;
+		std::vector<uint64_t> offsets(levels.size());
+		for (size_t i = levels.size(); i > 0; i--)
+		{
+			offsets[i - 1] = offset;
+			offset += levels[i - 1].size();
+		}
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			append<uint64_t>(bytes, offsets[i]);
+			append<uint64_t>(bytes, levels[i].size());
+			append<uint64_t>(bytes, levels[i].size());
+		}
+		for (size_t i = levels.size(); i > 0; i--)
+		{
+			bytes.insert(bytes.end(), levels[i - 1].begin(), levels[i - 1].end());
+		}
+		return bytes;
+	}
+
+	/**
+	 * @return A BC1 block interpolating between two 5:6:5 colors
+	 */
+	std::vector<unsigned char> createBC1Block(uint16_t color0, uint16_t color1, uint32_t indices)
+	{
+		std::vector<unsigned char> block;
+		append<uint16_t>(block, color0);
+		append<uint16_t>(block, color1);
+		append<uint32_t>(block, indices);
+		return block;
+	}
+
+	/**
+	 * @return The pixel at the given coordinates of decoded RGBA pixels
+	 */
+	std::vector<unsigned char> getPixel(const std::vector<unsigned char>& pixels, unsigned int width, unsigned int x,
+		unsigned int y)
+	{
+		auto pixel = pixels.begin() + (y * width + x) * 4;
+		return std::vector<unsigned char>(pixel, pixel + 4);
+	}
+}
+
+/**
+ * Tests reading a DDS file holding a BC1 mip chain, and decoding it on the CPU
+ */
+BOOST_AUTO_TEST_CASE(CompressedImage_dds)
+{
+	// Red and blue endpoints, with the pixels of the first row using each of the four colors in turn
+	std::vector<unsigned char> blocks;
+	for (unsigned int i = 0; i < 7; i++)
+	{
+		std::vector<unsigned char> block = createBC1Block(0xF800, 0x001F, i == 0 ? 0xE4 : 0);
+		blocks.insert(blocks.end(), block.begin(), block.end());
+	}
+
+	std::string path = getTempPath("CompressedImageTest.dds");
+	writeFile(path, createDDS("DXT1", 8, 8, 4, blocks));
+	BOOST_TEST(CompressedImage::isCompressedPath(path));
+	BOOST_TEST(!CompressedImage::isCompressedPath("image.png"));
+
+	CompressedImage image(path);
+	BOOST_TEST(image.getFormat() == CompressedFormat::BC1_RGBA);
+	BOOST_TEST(image.getWidth() == 8u);
+	BOOST_TEST(image.getHeight() == 8u);
+	BOOST_TEST(image.getNumLevels() == 4u);
+	BOOST_TEST(image.getLevel(1).width == 4u);
+	BOOST_TEST(image.getLevel(3).height == 1u);
+	BOOST_TEST(image.getLevel(0).size == 32u);
+	BOOST_TEST(image.getLevel(3).size == 8u);
+	BOOST_TEST(image.getDataSize() == 56u);
+	BOOST_TEST(image.getLevelData(1)[0] == blocks[32]);
+	BOOST_TEST(CompressedImage::getBlockSize(CompressedFormat::BC1_RGB) == 8u);
+	BOOST_TEST(CompressedImage::getBlockSize(CompressedFormat::BC3) == 16u);
+	BOOST_TEST(CompressedImage::isDecodable(CompressedFormat::BC5));
+	BOOST_TEST(!CompressedImage::isDecodable(CompressedFormat::BC7));
+
+	std::vector<unsigned char> pixels;
+	image.decode(0, pixels);
+	BOOST_REQUIRE(pixels.size() == 8u * 8u * 4u);
+	BOOST_TEST((getPixel(pixels, 8, 0, 0) == std::vector<unsigned char>({ 255, 0, 0, 255 })));
+	BOOST_TEST((getPixel(pixels, 8, 1, 0) == std::vector<unsigned char>({ 0, 0, 255, 255 })));
+	BOOST_TEST((getPixel(pixels, 8, 2, 0) == std::vector<unsigned char>({ 170, 0, 85, 255 })));
+	BOOST_TEST((getPixel(pixels, 8, 3, 0) == std::vector<unsigned char>({ 85, 0, 170, 255 })));
+	BOOST_TEST((getPixel(pixels, 8, 7, 7) == std::vector<unsigned char>({ 255, 0, 0, 255 })));
+
+	image.decode(3, pixels);
+	BOOST_TEST(pixels.size() == 4u);
+
+	BOOST_CHECK_THROW(image.getLevel(4), OutOfBoundsException);
+	BOOST_CHECK_THROW(image.decode(4, pixels), OutOfBoundsException);
+}
+
+/**
+ * Tests reading KTX2 files, and decoding the alpha and single channel formats along the edges of images whose size is
+ * not a multiple of the block size
+ */
+BOOST_AUTO_TEST_CASE(CompressedImage_ktx2)
+{
+	// Three colors and a transparent pixel, since the first endpoint is not greater than the second
+	std::vector<unsigned char> block = createBC1Block(0x001F, 0xF800, 0xC0);
+	std::vector<unsigned char> level0;
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		level0.insert(level0.end(), block.begin(), block.end());
+	}
+
+	std::string path = getTempPath("CompressedImageTest.ktx2");
+	writeFile(path, createKTX2(133, 6, 6, { level0, block, block }));
+	CompressedImage image(path);
+	BOOST_TEST(image.getFormat() == CompressedFormat::BC1_RGBA);
+	BOOST_TEST(image.getNumLevels() == 3u);
+	BOOST_TEST(image.getLevel(1).width == 3u);
+	BOOST_TEST(image.getLevelData(2)[0] == block[0]);
+
+	std::vector<unsigned char> pixels;
+	image.decode(0, pixels);
+	BOOST_REQUIRE(pixels.size() == 6u * 6u * 4u);
+	BOOST_TEST((getPixel(pixels, 6, 3, 0) == std::vector<unsigned char>({ 0, 0, 0, 0 })));
+	BOOST_TEST((getPixel(pixels, 6, 5, 5) == std::vector<unsigned char>({ 0, 0, 255, 255 })));
+
+	// The same block is opaque black without alpha
+	writeFile(path, createKTX2(131, 6, 6, { level0 }));
+	CompressedImage(path).decode(0, pixels);
+	BOOST_TEST((getPixel(pixels, 6, 3, 0) == std::vector<unsigned char>({ 0, 0, 0, 255 })));
+
+	// BC3 interpolates 8 alpha values between its endpoints, and BC4 decodes to red
+	std::vector<unsigned char> alphaBlock = { 200, 100, 0x08, 0, 0, 0, 0, 0 };
+	std::vector<unsigned char> bc3Block = alphaBlock;
+	std::vector<unsigned char> colorBlock = createBC1Block(0x07E0, 0x07E0, 0);
+	bc3Block.insert(bc3Block.end(), colorBlock.begin(), colorBlock.end());
+	writeFile(path, createKTX2(137, 4, 4, { bc3Block }));
+	CompressedImage(path).decode(0, pixels);
+	BOOST_TEST((getPixel(pixels, 4, 0, 0) == std::vector<unsigned char>({ 0, 255, 0, 200 })));
+	BOOST_TEST((getPixel(pixels, 4, 1, 0) == std::vector<unsigned char>({ 0, 255, 0, 100 })));
+
+	writeFile(path, createKTX2(139, 2, 2, { alphaBlock }));
+	CompressedImage singleChannel(path);
+	BOOST_TEST(singleChannel.getFormat() == CompressedFormat::BC4);
+	singleChannel.decode(0, pixels);
+	BOOST_TEST((pixels == std::vector<unsigned char>({ 200, 0, 0, 255, 100, 0, 0, 255, 200, 0, 0, 255, 200, 0, 0,
+		255 })));
+}
+
+/**
+ * Tests reading DDS files with the extended header, holding formats which can only be sampled by the GPU
+ */
+BOOST_AUTO_TEST_CASE(CompressedImage_dx10)
+{
+	std::string path = getTempPath("CompressedImageDX10.dds");
+	writeFile(path, createDDS("DX10", 4, 4, 1, std::vector<unsigned char>(16, 0), 98));
+	CompressedImage image(path);
+	BOOST_TEST(image.getFormat() == CompressedFormat::BC7);
+	BOOST_TEST(image.getNumLevels() == 1u);
+	BOOST_TEST(image.getDataSize() == 16u);
+
+	std::vector<unsigned char> pixels;
+	BOOST_CHECK_THROW(image.decode(0, pixels), IllegalArgumentException);
+}
+
+/**
+ * Tests the rejection of invalid and unsupported files
+ */
+BOOST_AUTO_TEST_CASE(CompressedImage_invalid)
+{
+	std::vector<unsigned char> blocks(32, 0);
+	std::string dds = getTempPath("CompressedImageInvalid.dds");
+	std::string ktx2 = getTempPath("CompressedImageInvalid.ktx2");
+	BOOST_CHECK_THROW(CompressedImage(getTempPath("CompressedImageMissing.dds")), InstantiationException);
+
+	// Unknown containers and formats
+	writeFile(getTempPath("CompressedImageInvalid.png"), blocks);
+	BOOST_CHECK_THROW(CompressedImage(getTempPath("CompressedImageInvalid.png")), InstantiationException);
+	writeFile(dds, blocks);
+	BOOST_CHECK_THROW(CompressedImage image(dds), InstantiationException);
+	writeFile(dds, createDDS("ABCD", 4, 4, 1, blocks));
+	BOOST_CHECK_THROW(CompressedImage image(dds), InstantiationException);
+	writeFile(dds, createDDS("DX10", 4, 4, 1, blocks, 28));
+	BOOST_CHECK_THROW(CompressedImage image(dds), InstantiationException);
+	writeFile(ktx2, createKTX2(37, 4, 4, { blocks }));
+	BOOST_CHECK_THROW(CompressedImage image(ktx2), InstantiationException);
+
+	// Cube maps
+	writeFile(dds, createDDS("DXT1", 4, 4, 1, blocks, 0, 0x200));
+	BOOST_CHECK_THROW(CompressedImage image(dds), InstantiationException);
+	writeFile(ktx2, createKTX2(131, 4, 4, { std::vector<unsigned char>(8, 0) }, 6));
+	BOOST_CHECK_THROW(CompressedImage image(ktx2), InstantiationException);
+
+	// Truncated levels, and levels of the wrong size
+	writeFile(dds, createDDS("DXT5", 8, 8, 1, blocks));
+	BOOST_CHECK_THROW(CompressedImage image(dds), InstantiationException);
+	writeFile(ktx2, createKTX2(131, 8, 8, { std::vector<unsigned char>(8, 0) }));
+	BOOST_CHECK_THROW(CompressedImage image(ktx2), InstantiationException);
+
+	// More levels than the mip chain holds
+	writeFile(dds, createDDS("DXT1", 1, 1, 2, blocks));
+	BOOST_CHECK_THROW(CompressedImage image(dds), InstantiationException);
+}
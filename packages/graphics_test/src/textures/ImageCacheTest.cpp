@@ -0,0 +1,157 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/ImageCache.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <graphics/textures/TextureAtlas.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	/**
+	 * @return Absolute path to an empty directory holding the cache files of a test
+	 */
+	std::string createDirectory(const std::string& name)
+	{
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+		std::filesystem::remove_all(directory);
+		return directory.string();
+	}
+
+	/**
+	 * @return The number of cache files in a directory
+	 */
+	unsigned int countFiles(const std::string& directory)
+	{
+		if (!std::filesystem::exists(directory))
+		{
+			return 0;
+		}
+
+		auto files = std::filesystem::directory_iterator(directory);
+		return (unsigned int) std::count_if(std::filesystem::begin(files), std::filesystem::end(files),
+			[](const std::filesystem::directory_entry& entry)
+			{
+				return entry.path().extension() == ImageCache::EXTENSION;
+			});
+	}
+}
+
+/**
+ * Tests that images are decoded and cached on the first load, and mapped from the cache afterwards
+ */
+BOOST_AUTO_TEST_CASE(ImageCache_load)
+{
+	ImageCache::reset();
+	std::string directory = createDirectory("ImageCacheTest_load");
+	ImageCache::setDirectory(directory);
+	BOOST_TEST(ImageCache::getDirectory() == directory);
+
+	std::unique_ptr<MipmappedImage> decoded = ImageCache::load("assets/container.jpg");
+	BOOST_TEST(decoded->getWidth() == 512u);
+	BOOST_TEST(decoded->getHeight() == 512u);
+	BOOST_TEST(decoded->getChannels() == 3u);
+	BOOST_TEST(decoded->getNumLevels() == 10u);
+	BOOST_TEST(!decoded->isPremultiplied());
+	BOOST_TEST(countFiles(directory) == 1u);
+
+	ImageCacheStats stats = ImageCache::getStats();
+	BOOST_TEST(stats.numHits == 0u);
+	BOOST_TEST(stats.numMisses == 1u);
+	BOOST_TEST(stats.decodeTime > 0.f);
+
+	std::unique_ptr<MipmappedImage> cached = ImageCache::load("assets/container.jpg");
+	BOOST_TEST(cached->getWidth() == 512u);
+	BOOST_TEST(cached->getHeight() == 512u);
+	BOOST_TEST(cached->getChannels() == 3u);
+	BOOST_TEST(cached->getDataSize() == decoded->getDataSize());
+	BOOST_TEST(std::equal(cached->getData(), cached->getData() + cached->getDataSize(), decoded->getData()));
+
+	stats = ImageCache::getStats();
+	BOOST_TEST(stats.numHits == 1u);
+	BOOST_TEST(stats.numMisses == 1u);
+	BOOST_TEST(stats.loadTime > 0.f);
+
+	// Other options produce other pixels, so they are cached separately
+	ImageOptions options;
+	options.flip = true;
+	ImageCache::load("assets/container.jpg", options);
+	BOOST_TEST(ImageCache::getStats().numMisses == 2u);
+	BOOST_TEST(countFiles(directory) == 2u);
+
+	BOOST_CHECK_THROW(ImageCache::load("assets/does-not-exist.jpg"), InstantiationException);
+
+	ImageCache::reset();
+	std::filesystem::remove_all(directory);
+}
+
+/**
+ * Tests that corrupt cache files are treated as misses and replaced
+ */
+BOOST_AUTO_TEST_CASE(ImageCache_corrupt)
+{
+	ImageCache::reset();
+	std::string directory = createDirectory("ImageCacheTest_corrupt");
+	ImageCache::setDirectory(directory);
+	std::unique_ptr<MipmappedImage> decoded = ImageCache::load("assets/container.jpg");
+
+	// Truncate the cache file
+	std::filesystem::path path = std::filesystem::directory_iterator(directory)->path();
+	std::filesystem::resize_file(path, 100);
+
+	std::unique_ptr<MipmappedImage> image = ImageCache::load("assets/container.jpg");
+	BOOST_TEST(image->getDataSize() == decoded->getDataSize());
+	BOOST_TEST(ImageCache::getStats().numMisses == 2u);
+
+	// Overwrite the header of the cache file
+	image.reset();
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.write("garbage", 7);
+	}
+	ImageCache::load("assets/container.jpg");
+	BOOST_TEST(ImageCache::getStats().numMisses == 3u);
+
+	ImageCache::load("assets/container.jpg");
+	BOOST_TEST(ImageCache::getStats().numHits == 1u);
+
+	ImageCache::reset();
+	std::filesystem::remove_all(directory);
+}
+
+/**
+ * Tests that no cache files are written once caching is disabled
+ */
+BOOST_AUTO_TEST_CASE(ImageCache_disabled)
+{
+	ImageCache::reset();
+	ImageCache::setDirectory("");
+	ImageCache::load("assets/container.jpg");
+	ImageCache::load("assets/container.jpg");
+
+	ImageCacheStats stats = ImageCache::getStats();
+	BOOST_TEST(stats.numHits == 0u);
+	BOOST_TEST(stats.numMisses == 2u);
+	ImageCache::reset();
+}
+
+/**
+ * Tests that images flipped by other loaders are not flipped again once decoded through the cache
+ */
+BOOST_AUTO_TEST_CASE(ImageCache_loadAfterFlip)
+{
+	ImageCache::reset();
+	ImageCache::setDirectory("");
+	std::unique_ptr<MipmappedImage> expected = ImageCache::load("assets/container.jpg");
+
+	TextureAtlasPtr atlas = TextureAtlas::create(1024, 1024);
+	atlas->add("assets/container.jpg", true);
+
+	std::unique_ptr<MipmappedImage> image = ImageCache::load("assets/container.jpg");
+	BOOST_REQUIRE(image->getDataSize() == expected->getDataSize());
+	BOOST_TEST(std::memcmp(image->getData(), expected->getData(), expected->getDataSize()) == 0);
+	ImageCache::reset();
+}
@@ -0,0 +1,150 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/MipGenerator.h>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/PrintHelpers.h>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @return Pixels of a full mip chain whose largest level is a checkerboard of black and white pixels
+	 */
+	std::vector<unsigned char> createCheckerboard(unsigned int width, unsigned int height, unsigned int channels)
+	{
+		std::vector<MipLevel> levels = MipmappedImage::computeLevels(width, height, channels);
+		std::vector<unsigned char> pixels(levels.back().offset + levels.back().size);
+		for (unsigned int y = 0; y < height; y++)
+		{
+			for (unsigned int x = 0; x < width; x++)
+			{
+				unsigned char value = (x + y) % 2 == 0 ? 255 : 0;
+				for (unsigned int c = 0; c < channels; c++)
+				{
+					pixels[((size_t) y * width + x) * channels + c] = value;
+				}
+			}
+		}
+		return pixels;
+	}
+}
+
+/**
+ * Tests the conversions between sRGB encoded and linear values
+ */
+BOOST_AUTO_TEST_CASE(MipGenerator_conversions)
+{
+	BOOST_TEST(MipGenerator::toLinear(0) == 0u);
+	BOOST_TEST(MipGenerator::toLinear(255) == 65535u);
+	BOOST_TEST(MipGenerator::toLinear(188) > 32000u);
+	BOOST_TEST(MipGenerator::toLinear(188) < 33500u);
+	for (unsigned int i = 0; i < 256; i++)
+	{
+		BOOST_TEST(MipGenerator::fromLinear(MipGenerator::toLinear(i)) == i);
+	}
+}
+
+/**
+ * Tests that uniform images keep their color at every level, including odd sizes
+ */
+BOOST_AUTO_TEST_CASE(MipGenerator_uniform)
+{
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(7, 5, 3);
+	std::vector<unsigned char> pixels(levels.back().offset + levels.back().size, 0);
+	for (size_t i = 0; i < levels[0].size; i += 3)
+	{
+		pixels[i] = 200;
+		pixels[i + 1] = 100;
+		pixels[i + 2] = 13;
+	}
+
+	MipGenerator::generate(pixels.data(), 7, 5, 3, true, false);
+	for (const MipLevel& level : levels)
+	{
+		for (size_t i = level.offset; i < level.offset + level.size; i += 3)
+		{
+			BOOST_TEST(pixels[i] == 200);
+			BOOST_TEST(pixels[i + 1] == 100);
+			BOOST_TEST(pixels[i + 2] == 13);
+		}
+	}
+}
+
+/**
+ * Tests that sRGB channels are averaged in linear space, while linear channels and alpha are averaged as they are
+ */
+BOOST_AUTO_TEST_CASE(MipGenerator_gammaCorrect)
+{
+	std::vector<unsigned char> srgb = createCheckerboard(4, 4, 4);
+	MipGenerator::generate(srgb.data(), 4, 4, 4, true, false);
+	const unsigned char* level = srgb.data() + 64;
+	BOOST_TEST(level[0] == 188);
+	BOOST_TEST(level[1] == 188);
+	BOOST_TEST(level[2] == 188);
+	BOOST_TEST(level[3] == 128);
+
+	std::vector<unsigned char> linear = createCheckerboard(4, 4, 4);
+	MipGenerator::generate(linear.data(), 4, 4, 4, false, false);
+	level = linear.data() + 64;
+	BOOST_TEST(level[0] == 128);
+	BOOST_TEST(level[3] == 128);
+
+	std::vector<unsigned char> rgb = createCheckerboard(4, 4, 3);
+	MipGenerator::generate(rgb.data(), 4, 4, 3, true, false);
+	BOOST_TEST(rgb[48] == 188);
+	BOOST_TEST(rgb[60] == 188);
+}
+
+/**
+ * Tests that color channels are premultiplied by alpha before being filtered
+ */
+BOOST_AUTO_TEST_CASE(MipGenerator_premultiply)
+{
+	// Opaque white pixels in the left column, transparent red pixels in the right column
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(2, 2, 4);
+	std::vector<unsigned char> pixels(levels.back().offset + levels.back().size);
+	for (unsigned int y = 0; y < 2; y++)
+	{
+		unsigned char* left = pixels.data() + y * 8;
+		left[0] = left[1] = left[2] = left[3] = 255;
+		unsigned char* right = left + 4;
+		right[0] = 255;
+		right[1] = right[2] = right[3] = 0;
+	}
+
+	std::vector<unsigned char> straight = pixels;
+	MipGenerator::generate(straight.data(), 2, 2, 4, false, false);
+	BOOST_TEST(straight[16] == 255);
+	BOOST_TEST(straight[17] == 128);
+	BOOST_TEST(straight[19] == 128);
+
+	MipGenerator::generate(pixels.data(), 2, 2, 4, false, true);
+	BOOST_TEST(pixels[4] == 0);
+	BOOST_TEST(pixels[16] == 128);
+	BOOST_TEST(pixels[17] == 128);
+	BOOST_TEST(pixels[18] == 128);
+	BOOST_TEST(pixels[19] == 128);
+}
+
+/**
+ * Tests that the results do not depend on the number of threads
+ */
+BOOST_AUTO_TEST_CASE(MipGenerator_threads)
+{
+	unsigned int width = 600;
+	unsigned int height = 300;
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(width, height, 4);
+	std::vector<unsigned char> pixels(levels.back().offset + levels.back().size);
+	for (size_t i = 0; i < levels[0].size; i++)
+	{
+		pixels[i] = (unsigned char) ((i * 2654435761u) >> 24);
+	}
+
+	std::vector<unsigned char> serial = pixels;
+	MipGenerator::generate(serial.data(), width, height, 4, true, true, 1);
+	MipGenerator::generate(pixels.data(), width, height, 4, true, true, 8);
+	BOOST_TEST(pixels == serial);
+
+	BOOST_CHECK_THROW(MipGenerator::generate(pixels.data(), 0, height, 4, true, false), IllegalArgumentException);
+	BOOST_CHECK_THROW(MipGenerator::generate(pixels.data(), width, height, 5, true, false), IllegalArgumentException);
+}
@@ -0,0 +1,34 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/MipmappedImage.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/OutOfBoundsException.h>
+#include <common/PrintHelpers.h>
+#include <vector>
+
+/**
+ * Tests the layout of mip chains
+ */
+BOOST_AUTO_TEST_CASE(MipmappedImage_computeLevels)
+{
+	std::vector<MipLevel> levels = MipmappedImage::computeLevels(4, 2, 4);
+	BOOST_TEST(levels.size() == 3u);
+	BOOST_TEST(levels[0].width == 4u);
+	BOOST_TEST(levels[0].height == 2u);
+	BOOST_TEST(levels[0].offset == 0u);
+	BOOST_TEST(levels[0].size == 32u);
+	BOOST_TEST(levels[1].width == 2u);
+	BOOST_TEST(levels[1].height == 1u);
+	BOOST_TEST(levels[1].offset == 32u);
+	BOOST_TEST(levels[1].size == 8u);
+	BOOST_TEST(levels[2].width == 1u);
+	BOOST_TEST(levels[2].height == 1u);
+	BOOST_TEST(levels[2].offset == 40u);
+	BOOST_TEST(levels[2].size == 4u);
+
+	MipmappedImage image(4, 2, 4, std::vector<unsigned char>(44));
+	BOOST_TEST(image.getNumLevels() == 3u);
+	BOOST_TEST(image.getDataSize() == 44u);
+	BOOST_TEST(image.getLevelData(2) == image.getData() + 40);
+	BOOST_CHECK_THROW(image.getLevel(3), OutOfBoundsException);
+	BOOST_CHECK_THROW(MipmappedImage(4, 2, 4, std::vector<unsigned char>(32)), IllegalArgumentException);
+}
@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/SkylinePacker.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/PrintHelpers.h>
+#include <vector>
+
+namespace
+{
+	/**
+	 * A rectangle placed by a packer
+	 */
+	struct Rectangle {
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+		unsigned int height;
+	};
+
+	/**
+	 * @return True if two rectangles overlap. Returns false otherwise.
+	 */
+	bool overlap(const Rectangle& a, const Rectangle& b)
+	{
+		return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+}
+
+/**
+ * Tests the placement of rectangles along the skyline
+ */
+BOOST_AUTO_TEST_CASE(SkylinePacker_pack)
+{
+	SkylinePacker packer(100, 50);
+	BOOST_TEST(packer.getWidth() == 100u);
+	BOOST_TEST(packer.getHeight() == 50u);
+	BOOST_TEST(packer.getOccupancy() == 0.f);
+
+	unsigned int x, y;
+	BOOST_TEST(packer.pack(60, 20, x, y));
+	BOOST_TEST(x == 0u);
+	BOOST_TEST(y == 0u);
+
+	// The next rectangle goes next to the first, where its top edge is lowest
+	BOOST_TEST(packer.pack(40, 30, x, y));
+	BOOST_TEST(x == 60u);
+	BOOST_TEST(y == 0u);
+
+	BOOST_TEST(packer.pack(50, 10, x, y));
+	BOOST_TEST(x == 0u);
+	BOOST_TEST(y == 20u);
+
+	// Narrow gaps left below the skyline are filled first
+	BOOST_TEST(packer.pack(10, 10, x, y));
+	BOOST_TEST(x == 50u);
+	BOOST_TEST(y == 20u);
+
+	// Rectangles spanning several segments rest on the highest of them
+	BOOST_TEST(packer.pack(70, 10, x, y));
+	BOOST_TEST(x == 0u);
+	BOOST_TEST(y == 30u);
+
+	BOOST_TEST(!packer.pack(101, 1, x, y));
+	BOOST_TEST(!packer.pack(40, 20, x, y));
+	BOOST_TEST(packer.getUsedArea() == 60u * 20u + 40u * 30u + 50u * 10u + 10u * 10u + 70u * 10u);
+	BOOST_TEST(packer.getOccupancy() == 3700.f / 5000.f);
+
+	packer.clear();
+	BOOST_TEST(packer.getUsedArea() == 0u);
+	BOOST_TEST(packer.pack(100, 50, x, y));
+	BOOST_TEST(!packer.pack(1, 1, x, y));
+
+	BOOST_CHECK_THROW(packer.pack(0, 1, x, y), IllegalArgumentException);
+	BOOST_CHECK_THROW(SkylinePacker(0, 1), IllegalArgumentException);
+}
+
+/**
+ * Tests that many rectangles of varied sizes are packed without overlapping, within the area, and densely
+ */
+BOOST_AUTO_TEST_CASE(SkylinePacker_dense)
+{
+	SkylinePacker packer(512, 512);
+	std::vector<Rectangle> placed;
+	for (unsigned int i = 0; i < 2000; i++)
+	{
+		Rectangle rectangle = { 0, 0, 8 + (i * 7) % 25, 8 + (i * 13) % 19 };
+		if (packer.pack(rectangle.width, rectangle.height, rectangle.x, rectangle.y))
+		{
+			BOOST_TEST(rectangle.x + rectangle.width <= 512u);
+			BOOST_TEST(rectangle.y + rectangle.height <= 512u);
+			placed.push_back(rectangle);
+		}
+	}
+
+	BOOST_TEST(placed.size() > 600u);
+	BOOST_TEST(packer.getOccupancy() > 0.75f);
+	for (unsigned int i = 0; i < placed.size(); i++)
+	{
+		for (unsigned int j = i + 1; j < placed.size(); j++)
+		{
+			BOOST_REQUIRE(!overlap(placed[i], placed[j]));
+		}
+	}
+}
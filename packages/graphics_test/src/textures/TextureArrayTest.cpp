@@ -0,0 +1,29 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/TextureArray.h>
+#include <graphics/textures/Texture.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+
+/**
+ * Tests the creation of a texture array holding a layer for every image
+ */
+BOOST_AUTO_TEST_CASE(TextureArray_create)
+{
+	TextureArrayPtr array = TextureArray::create({ "assets/container.jpg", "assets/container.jpg" });
+	BOOST_TEST(array != nullptr);
+	BOOST_TEST(array->id() > 0);
+	BOOST_TEST(array->getNumLayers() == 2u);
+	BOOST_TEST(array->getWidth() > 0u);
+	BOOST_TEST(array->getHeight() > 0u);
+	BOOST_TEST(array->getMemorySize() == Texture::computeMemorySize(array->getWidth(), array->getHeight(), 4) * 2);
+}
+
+/**
+ * Tests that texture arrays cannot be created without images, or from images that do not exist
+ */
+BOOST_AUTO_TEST_CASE(TextureArray_invalid)
+{
+	BOOST_REQUIRE_THROW(TextureArray::create({}), IllegalArgumentException);
+	BOOST_REQUIRE_THROW(TextureArray::create({ "assets/container.jpg", "does-not-exist" }), InstantiationException);
+}
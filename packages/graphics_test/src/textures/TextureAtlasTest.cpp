@@ -0,0 +1,72 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/TextureAtlas.h>
+#include <graphics/textures/Texture.h>
+#include <graphics/materials/BasicMaterial.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/IllegalStateException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/exceptions/NullPointerException.h>
+#include <common/PrintHelpers.h>
+
+/**
+ * Tests adding images to a texture atlas, and applying the regions they occupy to materials
+ */
+BOOST_AUTO_TEST_CASE(TextureAtlas_add)
+{
+	TextureAtlasPtr atlas = TextureAtlas::create(1024, 1024);
+	BOOST_TEST(atlas->getTexture() != nullptr);
+	BOOST_TEST(atlas->getTexture()->getWidth() == 1024u);
+	BOOST_TEST(atlas->getRegions().empty());
+	BOOST_TEST(atlas->isMipsGenerated());
+
+	// The image is placed within its padding
+	AtlasRegion region = atlas->add("assets/container.jpg");
+	BOOST_TEST(region.x == TextureAtlas::DEFAULT_PADDING);
+	BOOST_TEST(region.y == TextureAtlas::DEFAULT_PADDING);
+	BOOST_TEST(region.width > 0u);
+	BOOST_TEST(region.uvOffset.x == TextureAtlas::DEFAULT_PADDING / 1024.f);
+	BOOST_TEST(region.uvScale.x == region.width / 1024.f);
+	BOOST_TEST(region.uvScale.y == region.height / 1024.f);
+	BOOST_TEST(atlas->getRegions().size() == 1u);
+	BOOST_TEST(atlas->getPacker().getUsedArea() == (unsigned long long) (region.width + 4) * (region.height + 4));
+
+	// Adding the same image again reuses its region
+	AtlasRegion again = atlas->add("assets/container.jpg");
+	BOOST_TEST(again.x == region.x);
+	BOOST_TEST(again.y == region.y);
+	BOOST_TEST(atlas->getRegions().size() == 1u);
+
+	// Adding the same image flipped gives it a region of its own
+	AtlasRegion flipped = atlas->add("assets/container.jpg", true);
+	BOOST_TEST((flipped.x != region.x || flipped.y != region.y));
+	BOOST_TEST(atlas->getRegions().size() == 2u);
+	BOOST_TEST(atlas->add("assets/container.jpg", true).x == flipped.x);
+	BOOST_TEST(atlas->getRegions().size() == 2u);
+
+	// The mip chain is generated once the atlas is packed
+	BOOST_TEST(!atlas->isMipsGenerated());
+	atlas->generateMips();
+	BOOST_TEST(atlas->isMipsGenerated());
+	atlas->add("assets/container.jpg");
+	BOOST_TEST(atlas->isMipsGenerated());
+
+	MaterialPtr material = BasicMaterial::create();
+	atlas->apply(material, region);
+	BOOST_TEST(material->texture == atlas->getTexture());
+	BOOST_TEST(material->uvOffset == region.uvOffset);
+	BOOST_TEST(material->uvScale == region.uvScale);
+	BOOST_REQUIRE_THROW(atlas->apply(MaterialPtr(nullptr), region), NullPointerException);
+}
+
+/**
+ * Tests that images are rejected when they cannot be loaded, or the atlas cannot hold them
+ */
+BOOST_AUTO_TEST_CASE(TextureAtlas_invalid)
+{
+	BOOST_REQUIRE_THROW(TextureAtlas::create(0, 16), IllegalArgumentException);
+
+	TextureAtlasPtr atlas = TextureAtlas::create(16, 16);
+	BOOST_REQUIRE_THROW(atlas->add("does-not-exist"), InstantiationException);
+	BOOST_REQUIRE_THROW(atlas->add("assets/container.jpg"), IllegalStateException);
+	BOOST_TEST(atlas->getRegions().empty());
+}
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 #include <graphics/textures/TextureLoader.h>
 #include <graphics/textures/Texture.h>
+#include <common/PrintHelpers.h>
 
 /**
  * Tests the ability to load a texture, first from scratch, and then from the cache
@@ -12,4 +13,135 @@ BOOST_AUTO_TEST_CASE(TextureManager_load)
 
 	TexturePtr texture2 = TextureLoader::load("assets/container.jpg");
 	BOOST_TEST(texture2 == texture1);
-}
\ No newline at end of file
+}
+
+/**
+ * Tests that textures are cached by both their path and load options, counting cache hits and misses
+ */
+BOOST_AUTO_TEST_CASE(TextureManager_cacheKeys)
+{
+	TextureLoader::reset();
+	TexturePtr texture = TextureLoader::load("assets/container.jpg");
+	TexturePtr flipped = TextureLoader::load("assets/container.jpg", true);
+	BOOST_TEST(texture != flipped);
+	BOOST_TEST(TextureLoader::load("assets/container.jpg") == texture);
+	BOOST_TEST(TextureLoader::load("assets/container.jpg", true) == flipped);
+
+	TextureLoaderStats stats = TextureLoader::getStats();
+	BOOST_TEST(stats.numTextures == 2u);
+	BOOST_TEST(stats.numHits == 2u);
+	BOOST_TEST(stats.numMisses == 2u);
+	BOOST_TEST(stats.hitRate == 0.5f);
+	BOOST_TEST(stats.missRate == 0.5f);
+	BOOST_TEST(stats.numEvictions == 0u);
+	BOOST_TEST(stats.bytesResident == texture->getMemorySize() + flipped->getMemorySize());
+	TextureLoader::reset();
+}
+
+/**
+ * Tests that the least recently loaded textures are evicted once the cache exceeds its memory budget, but only once
+ * they are no longer referenced
+ */
+BOOST_AUTO_TEST_CASE(TextureManager_memoryBudget)
+{
+	TextureLoader::reset();
+	BOOST_TEST(TextureLoader::getMemoryBudget() == TextureLoader::DEFAULT_MEMORY_BUDGET);
+	TexturePtr texture = TextureLoader::load("assets/container.jpg");
+	unsigned long long size = texture->getMemorySize();
+	BOOST_TEST(size > 0u);
+	TextureLoader::setMemoryBudget(size);
+
+	// Textures in use are kept, even beyond the budget
+	TexturePtr flipped = TextureLoader::load("assets/container.jpg", true);
+	BOOST_TEST(TextureLoader::getStats().numTextures == 2u);
+	BOOST_TEST(TextureLoader::getStats().bytesResident == 2 * size);
+	BOOST_TEST(TextureLoader::getStats().numEvictions == 0u);
+
+	// Until the next load or change of budget evicts the least recently loaded unreferenced texture
+	TextureLoader::load("assets/container.jpg");
+	texture.reset();
+	flipped.reset();
+	TextureLoader::setMemoryBudget(size);
+	TextureLoaderStats stats = TextureLoader::getStats();
+	BOOST_TEST(stats.numTextures == 1u);
+	BOOST_TEST(stats.bytesResident == size);
+	BOOST_TEST(stats.numEvictions == 1u);
+
+	// The texture kept is found in the cache, while the evicted texture is created again
+	unsigned long long numMisses = stats.numMisses;
+	TextureLoader::load("assets/container.jpg");
+	BOOST_TEST(TextureLoader::getStats().numMisses == numMisses);
+	TextureLoader::load("assets/container.jpg", true);
+	BOOST_TEST(TextureLoader::getStats().numMisses == numMisses + 1);
+	BOOST_TEST(TextureLoader::getStats().numEvictions == 2u);
+
+	TextureLoader::setMemoryBudget(0);
+	BOOST_TEST(TextureLoader::getStats().numTextures == 0u);
+	BOOST_TEST(TextureLoader::getStats().bytesResident == 0u);
+	TextureLoader::reset();
+}
+
+/**
+ * Tests loading a texture in the background, which is bound to a placeholder until its image is uploaded
+ */
+BOOST_AUTO_TEST_CASE(TextureManager_loadAsync)
+{
+	TextureLoader::reset();
+	TexturePtr texture = TextureLoader::loadAsync("assets/container.jpg", true);
+	BOOST_TEST(texture->getStatus() == TextureStatus::LOADING);
+	BOOST_TEST(texture->getWidth() == 0u);
+	BOOST_TEST(texture->id() > 0u);
+	unsigned int placeholderId = texture->id();
+	BOOST_TEST(TextureLoader::loadAsync("assets/container.jpg", true) == texture);
+	BOOST_TEST(TextureLoader::load("assets/container.jpg", true) == texture);
+
+	TextureLoader::flush();
+	BOOST_TEST(TextureLoader::getNumPending() == 0u);
+	BOOST_TEST(texture->getStatus() == TextureStatus::READY);
+	BOOST_TEST(texture->getWidth() > 0u);
+	BOOST_TEST(texture->getHeight() > 0u);
+	BOOST_TEST(texture->id() != placeholderId);
+	BOOST_TEST(TextureLoader::getStats().bytesResident == texture->getMemorySize());
+	TextureLoader::reset();
+}
+
+/**
+ * Tests that images which cannot be loaded in the background leave the placeholder in place, without throwing
+ */
+BOOST_AUTO_TEST_CASE(TextureManager_loadAsyncFailure)
+{
+	TextureLoader::reset();
+	TexturePtr texture = TextureLoader::loadAsync("does-not-exist");
+	unsigned int placeholderId = texture->id();
+	BOOST_CHECK_NO_THROW(TextureLoader::flush());
+	BOOST_TEST(texture->getStatus() == TextureStatus::FAILED);
+	BOOST_TEST(texture->getError().find("does-not-exist") != std::string::npos);
+	BOOST_TEST(texture->id() == placeholderId);
+	BOOST_TEST(TextureLoader::getNumPending() == 0u);
+	TextureLoader::reset();
+}
+
+/**
+ * Tests that updates spread uploads over many frames, never uploading more than their budget beyond a single row, for
+ * every level of the mip chain
+ */
+BOOST_AUTO_TEST_CASE(TextureManager_uploadBudget)
+{
+	TextureLoader::reset();
+	BOOST_TEST(TextureLoader::getUploadBudget() == TextureLoader::DEFAULT_UPLOAD_BUDGET);
+	TextureLoader::setUploadBudget(1);
+	TexturePtr texture = TextureLoader::loadAsync("assets/container.jpg");
+	BOOST_TEST(TextureLoader::getNumPending() == 1u);
+
+	// Every update uploads a single row, once the image is decoded
+	unsigned int numUpdates = 0;
+	while (texture->getStatus() == TextureStatus::LOADING)
+	{
+		TextureLoader::update();
+		numUpdates++;
+	}
+	BOOST_TEST(texture->getStatus() == TextureStatus::READY);
+	BOOST_TEST(numUpdates >= texture->getHeight() + texture->getHeight() / 2);
+	BOOST_TEST(TextureLoader::getNumPending() == 0u);
+	TextureLoader::reset();
+}
@@ -0,0 +1,155 @@
+#include <boost/test/unit_test.hpp>
+#include <graphics/textures/TextureStreamer.h>
+#include <graphics/textures/Texture.h>
+#include <common/exceptions/IllegalArgumentException.h>
+#include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+#include <limits>
+
+namespace
+{
+	/**
+	 * Memory held by the levels of the 512x512 RGB test image no larger than the tail size
+	 */
+	const unsigned long long TAIL_MEMORY = Texture::computeMemorySize(64, 64, 3);
+
+	/**
+	 * Memory held by the full mip chain of the test image
+	 */
+	const unsigned long long FULL_MEMORY = Texture::computeMemorySize(512, 512, 3);
+}
+
+/**
+ * Tests the selection of the level needed to draw a texture at a given size on screen
+ */
+BOOST_AUTO_TEST_CASE(TextureStreamer_computeLevel)
+{
+	BOOST_TEST(TextureStreamer::computeLevel(512, 512, 512.f) == 0u);
+	BOOST_TEST(TextureStreamer::computeLevel(512, 512, 1e9f) == 0u);
+	BOOST_TEST(TextureStreamer::computeLevel(512, 512, std::numeric_limits<float>::infinity()) == 0u);
+	BOOST_TEST(TextureStreamer::computeLevel(512, 512, 256.f) == 1u);
+	BOOST_TEST(TextureStreamer::computeLevel(512, 512, 100.f) == 2u);
+	BOOST_TEST(TextureStreamer::computeLevel(512, 256, 64.f) == 3u);
+	BOOST_TEST(TextureStreamer::computeLevel(512, 512, 0.5f) == 9u);
+	BOOST_TEST(TextureStreamer::computeLevel(1, 1, 10.f) == 0u);
+}
+
+/**
+ * Tests that streamed textures are created with only the tail of their mip chain resident
+ */
+BOOST_AUTO_TEST_CASE(TextureStreamer_load)
+{
+	TextureStreamer::reset();
+	TexturePtr texture = TextureStreamer::load("assets/container.jpg");
+	BOOST_TEST(TextureStreamer::isStreamed(texture));
+	BOOST_TEST(texture->getWidth() == 512u);
+	BOOST_TEST(texture->getHeight() == 512u);
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 3u);
+	BOOST_TEST(texture->getMemorySize() == TAIL_MEMORY);
+
+	BOOST_TEST(TextureStreamer::load("assets/container.jpg") == texture);
+	TexturePtr flipped = TextureStreamer::load("assets/container.jpg", true);
+	BOOST_TEST(flipped != texture);
+
+	TextureStreamerStats stats = TextureStreamer::getStats();
+	BOOST_TEST(stats.numTextures == 2u);
+	BOOST_TEST(stats.bytesResident == 2 * TAIL_MEMORY);
+	BOOST_TEST(stats.numUploads == 0u);
+
+	TexturePtr whole = Texture::create("assets/container.jpg");
+	BOOST_TEST(!TextureStreamer::isStreamed(whole));
+	BOOST_TEST(!TextureStreamer::isStreamed(nullptr));
+	BOOST_REQUIRE_THROW(TextureStreamer::getResidentLevel(whole), IllegalArgumentException);
+	BOOST_REQUIRE_THROW(TextureStreamer::load("does-not-exist"), InstantiationException);
+	TextureStreamer::reset();
+}
+
+/**
+ * Tests that requested textures are refined one level at a time, without exceeding the upload budget
+ */
+BOOST_AUTO_TEST_CASE(TextureStreamer_refine)
+{
+	TextureStreamer::reset();
+	TexturePtr texture = TextureStreamer::load("assets/container.jpg");
+	TextureStreamer::request(texture, 100.f);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 2u);
+	BOOST_TEST(texture->getMemorySize() == TAIL_MEMORY + 128 * 128 * 3);
+	BOOST_TEST(TextureStreamer::getStats().numUploads == 1u);
+
+	// Unrequested textures keep their levels while within the memory budget
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 2u);
+	BOOST_TEST(TextureStreamer::getStats().numRefining == 0u);
+
+	TextureStreamer::request(texture, 100.f);
+	TextureStreamer::request(texture, 512.f);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 0u);
+	BOOST_TEST(texture->getMemorySize() == FULL_MEMORY);
+
+	// Every update uploads a single level when the upload budget is exceeded
+	TextureStreamer::setUploadBudget(1);
+	TexturePtr flipped = TextureStreamer::load("assets/container.jpg", true);
+	unsigned int numUpdates = 0;
+	while (TextureStreamer::getResidentLevel(flipped) > 0)
+	{
+		TextureStreamer::request(flipped, 512.f);
+		TextureStreamer::update();
+		numUpdates++;
+		BOOST_TEST(TextureStreamer::getResidentLevel(flipped) == 3u - numUpdates);
+	}
+	BOOST_TEST(numUpdates == 3u);
+	BOOST_TEST(TextureStreamer::getStats().bytesResident == 2 * FULL_MEMORY);
+	TextureStreamer::reset();
+}
+
+/**
+ * Tests that levels are dropped once the resident levels exceed the memory budget, starting with levels that were
+ * not requested
+ */
+BOOST_AUTO_TEST_CASE(TextureStreamer_memoryBudget)
+{
+	TextureStreamer::reset();
+	BOOST_TEST(TextureStreamer::getMemoryBudget() == TextureStreamer::DEFAULT_MEMORY_BUDGET);
+	TexturePtr texture = TextureStreamer::load("assets/container.jpg");
+	TexturePtr flipped = TextureStreamer::load("assets/container.jpg", true);
+	TextureStreamer::request(texture, 512.f);
+	TextureStreamer::request(flipped, 512.f);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getStats().bytesResident == 2 * FULL_MEMORY);
+
+	// The unrequested texture drops its levels until the budget is met
+	unsigned long long budget = FULL_MEMORY + TAIL_MEMORY;
+	TextureStreamer::setMemoryBudget(budget);
+	TextureStreamer::request(texture, 512.f);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 0u);
+	BOOST_TEST(TextureStreamer::getResidentLevel(flipped) == 3u);
+	BOOST_TEST(TextureStreamer::getStats().bytesResident == budget);
+	BOOST_TEST(TextureStreamer::getStats().numDrops == 3u);
+
+	// Refining a texture makes room by dropping levels no longer requested from others
+	TextureStreamer::request(flipped, 512.f);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 3u);
+	BOOST_TEST(TextureStreamer::getResidentLevel(flipped) == 0u);
+	BOOST_TEST(TextureStreamer::getStats().bytesResident == budget);
+
+	// Requested textures cannot make room by dropping each other's levels
+	TextureStreamer::request(texture, 512.f);
+	TextureStreamer::request(flipped, 512.f);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getResidentLevel(texture) == 3u);
+	BOOST_TEST(TextureStreamer::getStats().numRefining == 1u);
+
+	// Tails are never dropped
+	TextureStreamer::setMemoryBudget(0);
+	TextureStreamer::update();
+	BOOST_TEST(TextureStreamer::getStats().bytesResident == 2 * TAIL_MEMORY);
+
+	flipped.reset();
+	BOOST_TEST(TextureStreamer::getStats().numTextures == 1u);
+	BOOST_TEST(TextureStreamer::getStats().bytesResident == TAIL_MEMORY);
+	TextureStreamer::reset();
+}
@@ -1,6 +1,13 @@
 #include <boost/test/unit_test.hpp>
 #include <graphics/textures/Texture.h>
+#include <common/exceptions/IllegalArgumentException.h>
 #include <common/exceptions/InstantiationException.h>
+#include <common/PrintHelpers.h>
+#include <common/Utils.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
 
 /**
  * Tests the basic constructors and accessors of a texture
@@ -10,6 +17,11 @@ BOOST_AUTO_TEST_CASE(Texture_basics)
 	TexturePtr texture = Texture::create("assets/container.jpg");
 	BOOST_TEST(texture != nullptr);
 	BOOST_TEST(texture->id() > 0);
+	BOOST_TEST(texture->getStatus() == TextureStatus::READY);
+	BOOST_TEST(texture->getWidth() > 0u);
+	BOOST_TEST(texture->getHeight() > 0u);
+	BOOST_TEST(!texture->isCompressed());
+	BOOST_TEST(texture->getMemorySize() == Texture::computeMemorySize(texture->getWidth(), texture->getHeight(), 3));
 }
 
 /**
@@ -18,4 +30,45 @@ BOOST_AUTO_TEST_CASE(Texture_basics)
 BOOST_AUTO_TEST_CASE(Texture_nonExistentImage)
 {
 	BOOST_REQUIRE_THROW(Texture::create("does-not-exist"), InstantiationException);
+}
+
+/**
+ * Tests the memory held by textures along with their mip chains
+ */
+BOOST_AUTO_TEST_CASE(Texture_memorySize)
+{
+	BOOST_TEST(Texture::computeMemorySize(4, 2, 4) == 44u);
+	BOOST_TEST(Texture::computeMemorySize(1, 1, 3) == 3u);
+	BOOST_TEST(Texture::computeMemorySize(256, 256, 4) == 349524u);
+}
+
+/**
+ * Tests creating a texture from a compressed image holding a mip chain, which is decoded on the CPU where the GL
+ * context does not support its format
+ */
+BOOST_AUTO_TEST_CASE(Texture_compressed)
+{
+	// A DDS file holding 4 levels of black BC1 blocks, next to the executable
+	std::vector<uint32_t> header(32, 0);
+	header[0] = 0x20534444;
+	header[1] = 124;
+	header[2] = 0x1007 | 0x20000;
+	header[3] = 8;
+	header[4] = 8;
+	header[7] = 4;
+	header[19] = 32;
+	header[20] = 0x4;
+	std::memcpy(&header[21], "DXT1", 4);
+	{
+		std::ofstream file(resolvePath("TextureTest.dds"), std::ios::binary | std::ios::trunc);
+		file.write((const char*) header.data(), header.size() * sizeof(uint32_t));
+		file.write(std::vector<char>(56, 0).data(), 56);
+	}
+
+	TexturePtr texture = Texture::create("TextureTest.dds");
+	BOOST_TEST(texture->getWidth() == 8u);
+	BOOST_TEST(texture->getHeight() == 8u);
+	BOOST_TEST(texture->getMemorySize() == (texture->isCompressed() ? 56u : 340u));
+
+	BOOST_CHECK_THROW(Texture::create("TextureTest.dds", true), IllegalArgumentException);
 }
\ No newline at end of file
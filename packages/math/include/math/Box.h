@@ -0,0 +1,64 @@
+#pragma once
+#include <math/Vector3.h>
+
+class Matrix4;
+
+/**
+ * An axis-aligned box defined by its minimum and maximum corners, typically used as a bounding volume.
+ * @author Nathaniel Rex
+ */
+class Box
+{
+public:
+
+	/**
+	 * Corner with the smallest coordinates
+	 */
+	Vector3 min;
+
+	/**
+	 * Corner with the largest coordinates. A box whose maximum lies below its minimum along any axis is empty.
+	 */
+	Vector3 max;
+
+	/**
+	 * Constructs an empty box
+	 */
+	Box();
+
+	/**
+	 * Constructor
+	 * @param min Corner with the smallest coordinates
+	 * @param max Corner with the largest coordinates
+	 */
+	Box(const Vector3& min, const Vector3& max);
+
+	/**
+	 * @return True if this box is empty (its maximum lies below its minimum along any axis). Returns false otherwise.
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * @return The center point of this box
+	 */
+	Vector3 getCenter() const;
+
+	/**
+	 * @return Half of the size of this box along each axis
+	 */
+	Vector3 getExtents() const;
+
+	/**
+	 * Tests whether a point lies on or within this box
+	 * @param p Point to test
+	 * @return True if the point is contained by this box. Returns false otherwise.
+	 */
+	bool containsPoint(const Vector3& p) const;
+
+	/**
+	 * Computes the axis-aligned box that bounds this box after transforming it by the given matrix
+	 * @param m Transformation matrix
+	 * @return The transformed box. Empty boxes remain empty.
+	 */
+	Box transform(const Matrix4& m) const;
+};
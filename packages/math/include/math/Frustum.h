@@ -0,0 +1,81 @@
+#pragma once
+
+class Vector3;
+class Matrix4;
+class Sphere;
+class Box;
+
+/**
+ * A frustum, made up of six planes whose normals face inward. Typically used to determine whether or not objects
+ * are within the view volume of a camera.
+ * @author Nathaniel Rex
+ */
+class Frustum
+{
+public:
+
+	/**
+	 * The number of planes that make up a frustum
+	 */
+	static const int NUM_PLANES = 6;
+
+	/**
+	 * Constructs an unbounded frustum that contains every point in space
+	 */
+	Frustum();
+
+	/**
+	 * Constructs the frustum of a view-projection matrix. The resulting planes are expressed in the space that the
+	 * matrix transforms from (for a projection matrix multiplied by a view matrix, this is world space).
+	 * @param m View-projection matrix, transforming points to clip space
+	 * @return The frustum
+	 */
+	static Frustum fromMatrix(const Matrix4& m);
+
+	/**
+	 * @return The planes of this frustum, as an array of 6 consecutive (a, b, c, d) tuples satisfying
+	 * ax + by + cz + d >= 0 for points that lie on the inside of the plane. Plane normals are unit length.
+	 */
+	const float* getPlanes() const;
+
+	/**
+	 * Tests whether a point lies within this frustum
+	 * @param p Point to test
+	 * @return True if the point is contained by this frustum. Returns false otherwise.
+	 */
+	bool containsPoint(const Vector3& p) const;
+
+	/**
+	 * Tests whether a sphere intersects or is contained by this frustum. This test is conservative, and may report
+	 * an intersection for spheres that lie just outside of a corner of the frustum.
+	 * @param x X coordinate of the sphere center
+	 * @param y Y coordinate of the sphere center
+	 * @param z Z coordinate of the sphere center
+	 * @param radius Sphere radius
+	 * @return True if the sphere intersects this frustum. Returns false otherwise.
+	 */
+	bool intersectsSphere(float x, float y, float z, float radius) const;
+
+	/**
+	 * Tests whether a sphere intersects or is contained by this frustum. This test is conservative, and may report
+	 * an intersection for spheres that lie just outside of a corner of the frustum.
+	 * @param sphere Sphere to test. Empty spheres never intersect.
+	 * @return True if the sphere intersects this frustum. Returns false otherwise.
+	 */
+	bool intersectsSphere(const Sphere& sphere) const;
+
+	/**
+	 * Tests whether an axis-aligned box intersects or is contained by this frustum. This test is conservative, and
+	 * may report an intersection for boxes that lie just outside of a corner of the frustum.
+	 * @param box Box to test. Empty boxes never intersect.
+	 * @return True if the box intersects this frustum. Returns false otherwise.
+	 */
+	bool intersectsBox(const Box& box) const;
+
+private:
+
+	/**
+	 * Plane coefficients, stored as 6 consecutive (a, b, c, d) tuples
+	 */
+	float _planes[NUM_PLANES * 4];
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <math/Vector3.h>
+
+class Matrix4;
+
+/**
+ * A sphere defined by a center point and a radius, typically used as a bounding volume.
+ * @author Nathaniel Rex
+ */
+class Sphere
+{
+public:
+
+	/**
+	 * Center point
+	 */
+	Vector3 center;
+
+	/**
+	 * Radius. A negative radius denotes an empty sphere.
+	 */
+	float radius;
+
+	/**
+	 * Constructs an empty sphere, centered at the origin
+	 */
+	Sphere();
+
+	/**
+	 * Constructor
+	 * @param center Center point
+	 * @param radius Radius
+	 */
+	Sphere(const Vector3& center, float radius);
+
+	/**
+	 * @return True if this sphere is empty (has a negative radius). Returns false otherwise.
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * Tests whether a point lies on or within this sphere
+	 * @param p Point to test
+	 * @return True if the point is contained by this sphere. Returns false otherwise.
+	 */
+	bool containsPoint(const Vector3& p) const;
+
+	/**
+	 * Computes the sphere that results from transforming this sphere by the given matrix. Non-uniform scaling
+	 * is accounted for conservatively, by scaling the radius by the largest axis scale of the matrix.
+	 * @param m Transformation matrix
+	 * @return The transformed sphere
+	 */
+	Sphere transform(const Matrix4& m) const;
+
+	/**
+	 * Computes the largest scale factor that the given matrix applies along any of its axes
+	 * @param m Transformation matrix
+	 * @return The largest axis scale factor
+	 */
+	static float getMaxScale(const Matrix4& m);
+};
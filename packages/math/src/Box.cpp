@@ -0,0 +1,52 @@
+#include <math/Box.h>
+#include <math/Matrix4.h>
+#include <cmath>
+
+Box::Box() : min(0.f, 0.f, 0.f), max(-1.f, -1.f, -1.f)
+{
+
+}
+
+Box::Box(const Vector3& min, const Vector3& max) : min(min), max(max)
+{
+
+}
+
+bool Box::isEmpty() const
+{
+	return max.x < min.x || max.y < min.y || max.z < min.z;
+}
+
+Vector3 Box::getCenter() const
+{
+	return Vector3((min.x + max.x) / 2.f, (min.y + max.y) / 2.f, (min.z + max.z) / 2.f);
+}
+
+Vector3 Box::getExtents() const
+{
+	return Vector3((max.x - min.x) / 2.f, (max.y - min.y) / 2.f, (max.z - min.z) / 2.f);
+}
+
+bool Box::containsPoint(const Vector3& p) const
+{
+	return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+}
+
+Box Box::transform(const Matrix4& m) const
+{
+	if (isEmpty())
+	{
+		return *this;
+	}
+
+	// Transform the center, then project the extents onto each axis using the absolute values of the matrix (Arvo)
+	Vector3 center = m.transformPosition(getCenter());
+	Vector3 e = getExtents();
+	Vector3 extents(
+		std::fabs(m[0]) * e.x + std::fabs(m[1]) * e.y + std::fabs(m[2]) * e.z,
+		std::fabs(m[4]) * e.x + std::fabs(m[5]) * e.y + std::fabs(m[6]) * e.z,
+		std::fabs(m[8]) * e.x + std::fabs(m[9]) * e.y + std::fabs(m[10]) * e.z);
+
+	return Box(Vector3(center.x - extents.x, center.y - extents.y, center.z - extents.z),
+		Vector3(center.x + extents.x, center.y + extents.y, center.z + extents.z));
+}
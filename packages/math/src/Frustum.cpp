@@ -0,0 +1,107 @@
+#include <math/Frustum.h>
+#include <math/Vector3.h>
+#include <math/Matrix4.h>
+#include <math/Sphere.h>
+#include <math/Box.h>
+#include <cmath>
+
+Frustum::Frustum()
+{
+	for (int i = 0; i < NUM_PLANES; i++)
+	{
+		_planes[i * 4] = 0.f;
+		_planes[i * 4 + 1] = 0.f;
+		_planes[i * 4 + 2] = 0.f;
+		_planes[i * 4 + 3] = 1.f;
+	}
+}
+
+Frustum Frustum::fromMatrix(const Matrix4& m)
+{
+	// Each plane is a combination of the last row of the matrix with one of the first three rows
+	// (Gribb & Hartmann). Order: left, right, bottom, top, near, far.
+	Frustum f;
+	for (int i = 0; i < NUM_PLANES; i++)
+	{
+		int row = i / 2;
+		float sign = (i % 2 == 0) ? 1.f : -1.f;
+
+		float a = m[12] + sign * m[row * 4];
+		float b = m[13] + sign * m[row * 4 + 1];
+		float c = m[14] + sign * m[row * 4 + 2];
+		float d = m[15] + sign * m[row * 4 + 3];
+
+		float length = sqrt(a * a + b * b + c * c);
+		if (length > 0.f)
+		{
+			a /= length;
+			b /= length;
+			c /= length;
+			d /= length;
+		}
+
+		f._planes[i * 4] = a;
+		f._planes[i * 4 + 1] = b;
+		f._planes[i * 4 + 2] = c;
+		f._planes[i * 4 + 3] = d;
+	}
+
+	return f;
+}
+
+const float* Frustum::getPlanes() const
+{
+	return _planes;
+}
+
+bool Frustum::containsPoint(const Vector3& p) const
+{
+	return intersectsSphere(p.x, p.y, p.z, 0.f);
+}
+
+bool Frustum::intersectsSphere(float x, float y, float z, float radius) const
+{
+	for (int i = 0; i < NUM_PLANES; i++)
+	{
+		const float* p = &_planes[i * 4];
+		if (p[0] * x + p[1] * y + p[2] * z + p[3] < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Frustum::intersectsSphere(const Sphere& sphere) const
+{
+	if (sphere.isEmpty())
+	{
+		return false;
+	}
+
+	return intersectsSphere(sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius);
+}
+
+bool Frustum::intersectsBox(const Box& box) const
+{
+	if (box.isEmpty())
+	{
+		return false;
+	}
+
+	// The box lies outside of a plane if the corner furthest along the plane normal does
+	for (int i = 0; i < NUM_PLANES; i++)
+	{
+		const float* p = &_planes[i * 4];
+		float x = p[0] >= 0.f ? box.max.x : box.min.x;
+		float y = p[1] >= 0.f ? box.max.y : box.min.y;
+		float z = p[2] >= 0.f ? box.max.z : box.min.z;
+		if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,43 @@
+#include <math/Sphere.h>
+#include <math/Matrix4.h>
+#include <algorithm>
+#include <cmath>
+
+Sphere::Sphere() : center(0.f, 0.f, 0.f), radius(-1.f)
+{
+
+}
+
+Sphere::Sphere(const Vector3& center, float radius) : center(center), radius(radius)
+{
+
+}
+
+bool Sphere::isEmpty() const
+{
+	return radius < 0.f;
+}
+
+bool Sphere::containsPoint(const Vector3& p) const
+{
+	Vector3 d = p.minus(center);
+	return d.dot(d) <= radius * radius;
+}
+
+Sphere Sphere::transform(const Matrix4& m) const
+{
+	if (isEmpty())
+	{
+		return *this;
+	}
+
+	return Sphere(m.transformPosition(center), radius * getMaxScale(m));
+}
+
+float Sphere::getMaxScale(const Matrix4& m)
+{
+	float sx = m[0] * m[0] + m[4] * m[4] + m[8] * m[8];
+	float sy = m[1] * m[1] + m[5] * m[5] + m[9] * m[9];
+	float sz = m[2] * m[2] + m[6] * m[6] + m[10] * m[10];
+	return sqrt(std::max(sx, std::max(sy, sz)));
+}
@@ -0,0 +1,58 @@
+#include <boost/test/unit_test.hpp>
+#include <math/Box.h>
+#include <math/Matrix4.h>
+#include <math/Vector3.h>
+#include <common/Constants.h>
+#include <common/PrintHelpers.h>
+#include <common/Utils.h>
+#include <cmath>
+
+/**
+ * Tests the basic constructors and accessors of the class
+ */
+BOOST_AUTO_TEST_CASE(Box_basics)
+{
+	Box empty;
+	BOOST_TEST(empty.isEmpty());
+
+	Box box(Vector3(-1.f, 0.f, 2.f), Vector3(3.f, 2.f, 2.f));
+	BOOST_TEST(!box.isEmpty());
+	BOOST_TEST(box.getCenter() == Vector3(1.f, 1.f, 2.f));
+	BOOST_TEST(box.getExtents() == Vector3(2.f, 1.f, 0.f));
+}
+
+/**
+ * Tests the containsPoint() method
+ */
+BOOST_AUTO_TEST_CASE(Box_containsPoint)
+{
+	Box box(Vector3(0.f, 0.f, 0.f), Vector3(1.f, 2.f, 3.f));
+	BOOST_TEST(box.containsPoint(Vector3(0.5f, 1.f, 1.5f)));
+	BOOST_TEST(box.containsPoint(Vector3(1.f, 2.f, 3.f)));
+	BOOST_TEST(!box.containsPoint(Vector3(1.1f, 1.f, 1.f)));
+	BOOST_TEST(!box.containsPoint(Vector3(0.5f, -0.1f, 1.f)));
+	BOOST_TEST(!Box().containsPoint(Vector3(0.f, 0.f, 0.f)));
+}
+
+/**
+ * Tests the ability to transform a box using a matrix
+ */
+BOOST_AUTO_TEST_CASE(Box_transform)
+{
+	Box box(Vector3(-1.f, -1.f, -1.f), Vector3(1.f, 1.f, 1.f));
+
+	Matrix4 m = Matrix4::fromTranslation(Vector3(0.f, 5.f, 0.f));
+	m.multiply(Matrix4::fromScaling(1.f, 3.f, 2.f), &m);
+	Box result = box.transform(m);
+	BOOST_TEST(result.min.equalTo(Vector3(-1.f, 2.f, -2.f), 1.0e-6));
+	BOOST_TEST(result.max.equalTo(Vector3(1.f, 8.f, 2.f), 1.0e-6));
+
+	// Rotating by 45 degrees grows the box to enclose the rotated corners
+	result = box.transform(Matrix4::fromZRotation(PI / 4.f));
+	BOOST_TEST(equals(result.max.x, std::sqrt(2.f), 1.0e-5));
+	BOOST_TEST(equals(result.max.y, std::sqrt(2.f), 1.0e-5));
+	BOOST_TEST(equals(result.max.z, 1.f, 1.0e-5));
+
+	// Empty boxes remain empty
+	BOOST_TEST(Box().transform(m).isEmpty());
+}
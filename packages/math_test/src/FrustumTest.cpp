@@ -0,0 +1,71 @@
+#include <boost/test/unit_test.hpp>
+#include <math/Frustum.h>
+#include <math/Sphere.h>
+#include <math/Box.h>
+#include <math/Matrix4.h>
+#include <math/Vector3.h>
+#include <common/Constants.h>
+#include <common/PrintHelpers.h>
+#include <common/Utils.h>
+
+/**
+ * Tests that a default-constructed frustum contains everything
+ */
+BOOST_AUTO_TEST_CASE(Frustum_unbounded)
+{
+	Frustum frustum;
+	BOOST_TEST(frustum.containsPoint(Vector3(1.0e6f, -1.0e6f, 1.0e6f)));
+	BOOST_TEST(frustum.intersectsSphere(Sphere(Vector3(0.f, 0.f, 0.f), 1.f)));
+	BOOST_TEST(!frustum.intersectsSphere(Sphere()));
+}
+
+/**
+ * Tests the construction of a frustum from a perspective projection, looking down the negative z axis
+ */
+BOOST_AUTO_TEST_CASE(Frustum_fromPerspective)
+{
+	Matrix4 proj = Matrix4::fromPerspective(PI / 2.f, 1.f, 1.f, 100.f);
+	Frustum frustum = Frustum::fromMatrix(proj);
+
+	// Plane normals should be unit length
+	const float* planes = frustum.getPlanes();
+	for (int i = 0; i < Frustum::NUM_PLANES; i++)
+	{
+		Vector3 n(planes[i * 4], planes[i * 4 + 1], planes[i * 4 + 2]);
+		BOOST_TEST(equals(n.getMagnitude(), 1.f, 1.0e-5));
+	}
+
+	// Points
+	BOOST_TEST(frustum.containsPoint(Vector3(0.f, 0.f, -10.f)));
+	BOOST_TEST(frustum.containsPoint(Vector3(9.f, -9.f, -10.f)));
+	BOOST_TEST(!frustum.containsPoint(Vector3(11.f, 0.f, -10.f)));
+	BOOST_TEST(!frustum.containsPoint(Vector3(0.f, 0.f, 10.f)));
+	BOOST_TEST(!frustum.containsPoint(Vector3(0.f, 0.f, -0.5f)));
+	BOOST_TEST(!frustum.containsPoint(Vector3(0.f, 0.f, -101.f)));
+
+	// Spheres
+	BOOST_TEST(frustum.intersectsSphere(Sphere(Vector3(11.f, 0.f, -10.f), 2.f)));
+	BOOST_TEST(!frustum.intersectsSphere(Sphere(Vector3(20.f, 0.f, -10.f), 2.f)));
+	BOOST_TEST(frustum.intersectsSphere(Sphere(Vector3(0.f, 0.f, 0.f), 1.5f)));
+	BOOST_TEST(!frustum.intersectsSphere(Sphere(Vector3(0.f, 0.f, 5.f), 1.f)));
+
+	// Boxes
+	BOOST_TEST(frustum.intersectsBox(Box(Vector3(9.f, -1.f, -11.f), Vector3(13.f, 1.f, -9.f))));
+	BOOST_TEST(!frustum.intersectsBox(Box(Vector3(18.f, -1.f, -11.f), Vector3(22.f, 1.f, -9.f))));
+	BOOST_TEST(frustum.intersectsBox(Box(Vector3(-1.f, -1.f, -200.f), Vector3(1.f, 1.f, 200.f))));
+	BOOST_TEST(!frustum.intersectsBox(Box(Vector3(-1.f, -1.f, 4.f), Vector3(1.f, 1.f, 6.f))));
+	BOOST_TEST(!frustum.intersectsBox(Box()));
+}
+
+/**
+ * Tests that frustum planes follow the view transformation they are constructed from
+ */
+BOOST_AUTO_TEST_CASE(Frustum_fromViewProjection)
+{
+	Matrix4 proj = Matrix4::fromPerspective(PI / 2.f, 1.f, 1.f, 100.f);
+	Matrix4 view = Matrix4::fromTranslation(Vector3(-50.f, 0.f, 0.f));
+	Frustum frustum = Frustum::fromMatrix(proj.multiply(view));
+
+	BOOST_TEST(frustum.containsPoint(Vector3(50.f, 0.f, -10.f)));
+	BOOST_TEST(!frustum.containsPoint(Vector3(0.f, 0.f, -10.f)));
+}
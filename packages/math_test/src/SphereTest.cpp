@@ -0,0 +1,50 @@
+#include <boost/test/unit_test.hpp>
+#include <math/Sphere.h>
+#include <math/Matrix4.h>
+#include <math/Vector3.h>
+#include <common/PrintHelpers.h>
+#include <common/Utils.h>
+
+/**
+ * Tests the basic constructors and accessors of the class
+ */
+BOOST_AUTO_TEST_CASE(Sphere_basics)
+{
+	Sphere empty;
+	BOOST_TEST(empty.isEmpty());
+
+	Sphere sphere(Vector3(1.f, 2.f, 3.f), 2.f);
+	BOOST_TEST(!sphere.isEmpty());
+	BOOST_TEST(sphere.center == Vector3(1.f, 2.f, 3.f));
+	BOOST_TEST(sphere.radius == 2.f);
+}
+
+/**
+ * Tests the containsPoint() method
+ */
+BOOST_AUTO_TEST_CASE(Sphere_containsPoint)
+{
+	Sphere sphere(Vector3(1.f, 0.f, 0.f), 1.f);
+	BOOST_TEST(sphere.containsPoint(Vector3(1.f, 0.f, 0.f)));
+	BOOST_TEST(sphere.containsPoint(Vector3(2.f, 0.f, 0.f)));
+	BOOST_TEST(!sphere.containsPoint(Vector3(2.1f, 0.f, 0.f)));
+}
+
+/**
+ * Tests the ability to transform a sphere using a matrix
+ */
+BOOST_AUTO_TEST_CASE(Sphere_transform)
+{
+	Sphere sphere(Vector3(1.f, 0.f, 0.f), 1.f);
+
+	Matrix4 m = Matrix4::fromTranslation(Vector3(0.f, 5.f, 0.f));
+	m.multiply(Matrix4::fromScaling(1.f, 3.f, 2.f), &m);
+	BOOST_TEST(equals(Sphere::getMaxScale(m), 3.f, 1.0e-6));
+
+	Sphere result = sphere.transform(m);
+	BOOST_TEST(result.center.equalTo(Vector3(1.f, 5.f, 0.f), 1.0e-6));
+	BOOST_TEST(equals(result.radius, 3.f, 1.0e-6));
+
+	// Empty spheres remain empty
+	BOOST_TEST(Sphere().transform(m).isEmpty());
+}